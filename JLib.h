@@ -3,6 +3,13 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+// Build configuration of the modules provided as source, see JLibConfig.h.
+
+#if defined (JLIB_CONFIG_FILE)
+#include JLIB_CONFIG_FILE
+#endif
+#include "JLibConfig.h"
+
 /*******************************************************************************
  *
  *  Binary button, pressed or not pressed, debounce logic and patterns module.
@@ -426,6 +433,137 @@ void BIBUTTON_debounce_and_hold_handler(BIBUTTON_instance_t* instance);
 
 void BIBUTTON_pattern_handler(BIBUTTON_instance_t* instance);
 
+/*******************************************************************************
+ *
+ * BIBUTTON_matcher_node_t
+ *
+ * DESCRIPTION:
+ *  Single node of the compiled pattern trie. The trie is walked from the most
+ *  recent log entry (LSB) towards older entries, one log bit per node level.
+ *
+ * child
+ *  Node index for the next older log bit being a 0 (released) or 1 (pressed).
+ *  An index of 0 indicates that no child exists since the root node can never
+ *  be a child.
+ *
+ * pattern
+ *  The registered pattern which terminates at this node, else, NULL.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint16_t child[2];
+  BIBUTTON_pattern_instance_t* pattern;
+}
+BIBUTTON_matcher_node_t;
+
+/*******************************************************************************
+ *
+ * BIBUTTON_matcher_t
+ *
+ * DESCRIPTION:
+ *  Compiled decision structure for all of the patterns registered with a
+ *  binary button. Resolves every candidate pattern in a single walk of the
+ *  log, bounded by the longest registered pattern rather than the number of
+ *  registered patterns.
+ *
+ * node_buffer
+ *  User-provided buffer which holds the trie nodes.
+ *
+ * node_buffer_length
+ *  Length of the node buffer in number of nodes. In the worst case, a pattern
+ *  requires one node per bit of its length plus the shared root node.
+ *
+ * node_count
+ *  Number of nodes used by the compiled trie.
+ *
+ * max_length
+ *  Length of the longest compiled pattern, which bounds the trie walk.
+ *
+ * last_log, last_active_log_length
+ *  Copies of the button log state as of the last service call. The trie is
+ *  only walked when one of these changes, that is, when a new phase is logged.
+ *
+ * match_handler
+ *  Optional function called with the match handler context and the matched
+ *  pattern in place of the pattern callback. NULL by default, in which case
+ *  the pattern callback is called directly. Cleared by compiling, so it
+ *  must be set after BIBUTTON_matcher_compile.
+ *
+ * match_handler_context
+ *  Parameter to pass to the match handler.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  BIBUTTON_matcher_node_t* node_buffer;
+  uint16_t node_buffer_length;
+  uint16_t node_count;
+  uint8_t max_length;
+  uint8_t last_active_log_length;
+  BIBUTTON_log_t last_log;
+  void (*match_handler)(void*, BIBUTTON_pattern_instance_t*);
+  void* match_handler_context;
+}
+BIBUTTON_matcher_t;
+
+/*******************************************************************************
+ *
+ * BIBUTTON_matcher_compile
+ *
+ * DESCRIPTION:
+ *  Compiles the patterns currently registered with a binary button into a
+ *  trie. Must be called again after new patterns are registered. Patterns
+ *  with an identical length and value share a node, and the first of them
+ *  registered which is enabled is matched.
+ *
+ * PARAMETERS:
+ *  See BIBUTTON_matcher_t.
+ *
+ * RETURN:
+ *  True if all registered patterns were compiled, else, false if the node
+ *  buffer was too small.
+ *
+ ******************************************************************************/
+
+bool BIBUTTON_matcher_compile(BIBUTTON_instance_t* instance,
+                              BIBUTTON_matcher_t* matcher,
+                              BIBUTTON_matcher_node_t* node_buffer,
+                              uint16_t node_buffer_length);
+
+/*******************************************************************************
+ *
+ * BIBUTTON_matcher_pattern_handler
+ *
+ * DESCRIPTION:
+ *  Compiled equivalent of BIBUTTON_pattern_handler. Walks the trie along the
+ *  active log and keeps the deepest enabled pattern reached, which preserves
+ *  longest-match priority. On a match, clears the active log count and calls
+ *  the callback function with the callback parameter, or the match handler if
+ *  one is set.
+ *
+ ******************************************************************************/
+
+void BIBUTTON_matcher_pattern_handler(BIBUTTON_instance_t* instance,
+                                      BIBUTTON_matcher_t* matcher);
+
+/*******************************************************************************
+ *
+ * BIBUTTON_matcher_service
+ *
+ * DESCRIPTION:
+ *  Replacement for BIBUTTON_service when patterns have been compiled. Handles
+ *  debounce and hold logic as usual, but only resolves patterns when a new
+ *  phase has been logged. This function is meant to be called periodically
+ *  from the system tick interrupt.
+ *
+ ******************************************************************************/
+
+void BIBUTTON_matcher_service(BIBUTTON_instance_t* instance,
+                              BIBUTTON_matcher_t* matcher);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4456,390 +4594,509 @@ bool BUSMUTEX_request_mutex(BUSMUTEX_instance_t* instance, BUSMUTEX_bus_id_t bus
 
 bool BUSMUTEX_release_mutex(BUSMUTEX_instance_t* instance, BUSMUTEX_bus_id_t bus_id);
 
-#ifdef __cplusplus
-}
-#endif
-#endif // BUS_MUTEX_J_H
-
 /*******************************************************************************
  *
- *  Generic queue which supports any data type. The user provides the element
- *  size and a buffer. Requires proper initialization.
+ *  Atomic bus mutex. An alternative to BUSMUTEX_instance_t for modules which
+ *  are provided as source. Ownership of all busses is held in a single
+ *  bitmask which is claimed and cleared with atomic read-modify-write
+ *  operations (LDREX/STREX on ARMv7-M), so requesting and releasing an
+ *  uncontended bus never enters the critical section. On targets without
+ *  atomic instructions, such as ARMv6-M (Cortex-M0), the critical section is
+ *  used instead.
  *
- *  The option is available to make the queue thread-safe. This is done by
- *  not crossing variables which will be used in separate contexts. This comes
- *  at a cost of efficiency, and that the actual usable queue length will be
- *  (N-1). The application must also abide by the following rules:
- *    1. Wrapping is disabled.
- *    2. Only one context (thread or interrupt) enqueues.
- *    3. Only one context (thread or interrupt) dequeues.
+ *  Each claimed bus records the ID of its owner, so that a bus can only be
+ *  released by its owner. Instead of polling BUSMUTEX_is_available, a
+ *  contender can register a waiter. Waiters are granted the bus directly,
+ *  in order, when it is released, and are then signaled through a flag
+ *  and/or a callback.
+ *
+ *  Optionally, owner IDs index a table of clients which assigns each one a
+ *  priority and a maximum hold time budget. Waiters are then queued by
+ *  priority, and a long transaction sequence can check between transfers if
+ *  it has exceeded its budget while others wait, and yield the bus. Per-bus
+ *  statistics record hold times, wait times and contention.
  *
  ******************************************************************************/
 
-#ifndef QUEUE_J_H
-#define QUEUE_J_H
+/*
+ * Owner ID of an unclaimed bus. Owner IDs are user-assigned and must be
+ * non-zero.
+ */
 
-// Support C++ builds.
+#define BUSMUTEX_OWNER_ID_NONE            0U
 
-#ifdef __cplusplus
-extern "C" {
-#endif
+/*
+ * Hold time histogram. The first bin counts holds shorter than
+ * BUSMUTEX_HOLD_HISTOGRAM_FIRST_BIN_US, each following bin covers a range
+ * four times longer, and the last bin counts all longer holds.
+ */
+
+#define BUSMUTEX_HOLD_HISTOGRAM_BIN_COUNT 8U
+#define BUSMUTEX_HOLD_HISTOGRAM_FIRST_BIN_US 16U
 
 /*******************************************************************************
  *
- * QUEUE_flags_t
+ * BUSMUTEX_client_t
  *
  * DESCRIPTION:
- *  Module flags.
+ *  Arbitration settings and counters of an owner ID. Only to be allocated by
+ *  the user, see BUSMUTEX_atomic_configure_arbitration.
  *
- * wrapping_enabled
- *  The oldest entries of the queue will be overwritten with new enqueued
- *  entries if the queue is full. NOTE: Cannot be used in thread-safe mode.
+ * priority
+ *  Waiters with a higher priority are granted a bus first.
  *
- * thread_safe
- *  The queue will be thread-safe for two application contexts (i.e. Application
- *  and Interrupt, Application1 and Application2, etc...). NOTE: Cannot be used
- *  with wrapping.
+ * hold_budget_us
+ *  Maximum time a bus should be held at once, 0 if unlimited.
+ *
+ * hold_time_total_us
+ *  Time the client has held any bus, updated by the module.
+ *
+ * budget_overruns
+ *  Number of holds which exceeded the budget, updated by the module.
  *
  ******************************************************************************/
 
-typedef union
+typedef struct
 {
-  uint8_t all;
-  struct
-  {
-    uint8_t wrapping_enabled              : 1;
-    uint8_t thread_safe                   : 1;
-    uint8_t reserved2                     : 6;
-  };
+  uint8_t priority;
+  uint32_t hold_budget_us;
+  uint64_t hold_time_total_us;
+  uint32_t budget_overruns;
 }
-QUEUE_flags_t;
+BUSMUTEX_client_t;
 
 /*******************************************************************************
  *
- * QUEUE_instance_t
+ * BUSMUTEX_bus_stats_t
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
+ *  Statistics of a bus. Only to be allocated by the user, see
+ *  BUSMUTEX_atomic_configure_arbitration.
  *
- * flags
- *  Module flags.
+ * hold_ticket
+ *  Started when the bus is claimed.
  *
- * buffer
- *  Pointer to a user-provided buffer which will provide the physical memory
- *  for the queue. NOTE: Thread-safe queues require a buffer which can hold
- *  at least 2-elements.
+ * acquisitions
+ *  Number of times the bus was claimed.
  *
- * buffer_length
- *  Length, in bytes, of the user-provided buffer.
+ * contentions
+ *  Number of requests which found the bus claimed by another owner.
  *
- * element_size
- *  Size of a single queue element in bytes.
+ * budget_overruns
+ *  Number of holds which exceeded the budget of their owner.
  *
- * queue_length_in_elements
- *  Calculated number of slots the queue contains based upon the queue length
- *  and the element size.
+ * hold_time_max_us
+ *  Longest hold.
  *
- * element_counter
- *  Keeps track of the number of active queue entries. (Only used for quicker
- *  operations in non thread-safe mode.)
+ * hold_time_max_owner_id
+ *  Owner of the longest hold.
  *
- * head_index
- *  Keeps track of the head of the queue as an index/offset in number of
- *  elements from the start address of the user-provided buffer.
+ * hold_time_total_us
+ *  Time the bus has been held.
  *
- * tail_index
- *  Keeps track of the tail of the queue as an index/offset in number of
- *  elements from the start address of the user-provided buffer.
+ * waits
+ *  Number of waiters granted the bus.
+ *
+ * wait_time_max_us
+ *  Longest time a waiter was queued.
+ *
+ * wait_time_total_us
+ *  Time waiters were queued, in total.
+ *
+ * hold_histogram
+ *  Hold time histogram.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  QUEUE_flags_t flags;
-  void* buffer;
-  uint32_t buffer_length;
-  uint32_t element_size;
-  uint32_t queue_length_in_elements;
-  uint32_t element_counter;
-  uint32_t head_index;
-  uint32_t tail_index;
+  UTIMER_ticket_t hold_ticket;
+  uint32_t acquisitions;
+  uint32_t contentions;
+  uint32_t budget_overruns;
+  uint32_t hold_time_max_us;
+  uint8_t hold_time_max_owner_id;
+  uint64_t hold_time_total_us;
+  uint32_t waits;
+  uint32_t wait_time_max_us;
+  uint64_t wait_time_total_us;
+  uint32_t hold_histogram[BUSMUTEX_HOLD_HISTOGRAM_BIN_COUNT];
 }
-QUEUE_instance_t;
+BUSMUTEX_bus_stats_t;
 
 /*******************************************************************************
  *
- * QUEUE_initialize
+ * BUSMUTEX_grant_callback_t
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values. SPI method.
+ *  Function template for a user-provided function which is called when a
+ *  waiter has been granted a bus. Called from the context which released the
+ *  bus, which may be an interrupt.
  *
  * PARAMETERS:
- *  See QUEUE_instance_t.
+ *  context
+ *   The waiter callback context.
  *
- * NOTES:
- *  The length of the queue will be determined by dividing the buffer size by
- *  the element size. It is ideal for the element size to be an equal divisor
- *  of the buffer, however, it is not necessary.
+ *  bus_id
+ *   The granted bus.
  *
  ******************************************************************************/
 
-void QUEUE_initialize(QUEUE_instance_t* instance,
-                      void* buffer,
-                      uint32_t buffer_length,
-                      uint32_t element_size,
-                      bool wrapping_enabled,
-                      bool thread_safe);
+typedef void (*BUSMUTEX_grant_callback_t)(uint32_t context, BUSMUTEX_bus_id_t bus_id);
 
 /*******************************************************************************
  *
- * QUEUE_enqueue
+ * BUSMUTEX_waiter_t
  *
  * DESCRIPTION:
- *  Attempts to enqueue a single element.
+ *  Registration of a contender waiting for a bus. Only to be allocated by the
+ *  user, see BUSMUTEX_atomic_request_or_wait.
  *
- * PARAMETERS:
- *  element
- *   Pointer to the element to enqueue. A copy of the element will be stored on
- *   the queue.
+ * granted
+ *  Set true once the bus has been granted to the waiter.
  *
- * RETURN:
- *  True if space was available and the element was enqueued, else, false.
+ * callback
+ *  Called once the bus has been granted to the waiter. Can be NULL.
+ *
+ * callback_context
+ *  Value passed to the callback.
+ *
+ * owner_id
+ *  Owner ID the bus is granted to.
+ *
+ * bus_id
+ *  The bus waited for.
+ *
+ * priority
+ *  Priority of the owner ID, set by the module.
+ *
+ * wait_ticket
+ *  Started when the waiter is queued, if statistics are enabled.
+ *
+ * next_waiter
+ *  Next waiter for the same bus, managed by the module.
  *
  ******************************************************************************/
 
-bool QUEUE_enqueue(QUEUE_instance_t* instance, void* element);
+typedef struct
+{
+  volatile bool granted;
+  BUSMUTEX_grant_callback_t callback;
+  uint32_t callback_context;
+  uint8_t owner_id;
+  uint8_t bus_id;
+  uint8_t priority;
+  UTIMER_ticket_t wait_ticket;
+  void* next_waiter;
+}
+BUSMUTEX_waiter_t;
 
 /*******************************************************************************
  *
- * QUEUE_dequeue
+ * BUSMUTEX_atomic_instance_t
  *
  * DESCRIPTION:
- *  Attempts to dequeue a single element.
+ *  Instance data and function pointers.
  *
- * PARAMETERS:
- *  element
- *   Pointer to a location to store a copy of the dequeued element.
+ * flags
+ *  Module flags.
  *
- * RETURN:
- *  True if the queue was not empty and an element was dequeued, else, false.
+ * claimed_mask
+ *  Bit n is set while bus ID n is claimed.
+ *
+ * owner_id
+ *  Owner ID of each bus, BUSMUTEX_OWNER_ID_NONE if unclaimed.
+ *
+ * waiters
+ *  Queue of waiters of each bus, highest priority first.
+ *
+ * utimer
+ *  Timer used for hold and wait times, NULL if not configured.
+ *
+ * clients
+ *  Client table indexed by owner ID, NULL if not configured.
+ *
+ * client_count
+ *  Number of entries in the client table.
+ *
+ * bus_stats
+ *  Statistics indexed by bus ID, NULL if not configured.
+ *
+ * *_hal_*
+ *  User-provided functions. See the BUSMUTEX typedef comments. Can only be
+ *  NULL if the mutex is used from a single context.
  *
  ******************************************************************************/
 
-bool QUEUE_dequeue(QUEUE_instance_t* instance, void* element);
+typedef struct
+{
+  BUSMUTEX_flags_t flags;
+  volatile uint32_t claimed_mask;
+  volatile uint8_t owner_id[BUSMUTEX_BUS_ID_COUNT];
+  BUSMUTEX_waiter_t* volatile waiters[BUSMUTEX_BUS_ID_COUNT];
+  UTIMER_instance_t* utimer;
+  BUSMUTEX_client_t* clients;
+  uint16_t client_count;
+  BUSMUTEX_bus_stats_t* bus_stats;
+  BUSMUTEX_hal_enter_critical_t enter_critical;
+  BUSMUTEX_hal_exit_critical_t exit_critical;
+}
+BUSMUTEX_atomic_instance_t;
 
 /*******************************************************************************
  *
- * QUEUE_peek
+ * BUSMUTEX_atomic_initialize
  *
  * DESCRIPTION:
- *  Peeks at the next element in the queue, returning a copy of the element but
- *  not removing it from the queue.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
  *
  * PARAMETERS:
- *  element
- *   Pointer to the location to store a copy of the element.
- *
- * RETURN:
- *  True if the queue was not empty and a copy was made of the next element
- *  to be dequeued, else, false.
+ *  See BUSMUTEX_atomic_instance_t.
  *
  ******************************************************************************/
 
-bool QUEUE_peek(QUEUE_instance_t* instance, void* element);
+void BUSMUTEX_atomic_initialize(BUSMUTEX_atomic_instance_t* instance,
+                                BUSMUTEX_hal_enter_critical_t enter_critical,
+                                BUSMUTEX_hal_exit_critical_t exit_critical);
 
 /*******************************************************************************
  *
- * QUEUE_enqueue_buffer
+ * BUSMUTEX_atomic_configure_arbitration
  *
  * DESCRIPTION:
- *  element_buffer
- *   Pointer to a buffer of elements to enqueue. Copies of the element(s) will
- *   be stored on the queue.
+ *  Enables priorities, hold time budgets and statistics. To be called before
+ *  any bus is claimed.
  *
- *  element_count
- *   Number of elements to enqueue from the element_buffer.
+ * PARAMETERS:
+ *  utimer
+ *   Timer for hold and wait times. Can be NULL if bus_stats is NULL.
  *
- * RETURN:
- *  Actual number of elements enqueued which may be smaller than element_count
- *  if room was not available on the queue.
+ *  clients
+ *   Client table indexed by owner ID. Owner IDs outside the table have
+ *   priority 0 and no budget. Can be NULL.
+ *
+ *  client_count
+ *   Number of entries in the client table.
+ *
+ *  bus_stats
+ *   Array of BUSMUTEX_BUS_ID_COUNT statistics, cleared by this function.
+ *   Hold time budgets are only tracked when provided. Can be NULL.
+ *
+ * NOTES:
+ *  This function, BUSMUTEX_atomic_clear_stats and BUSMUTEX_atomic_should_yield
+ *  are only available with JLIB_CONFIG_BUSMUTEX_ARBITRATION.
  *
  ******************************************************************************/
 
-uint32_t QUEUE_enqueue_buffer(QUEUE_instance_t* instance,
-                              void* element_buffer,
-                              uint32_t element_count);
+void BUSMUTEX_atomic_configure_arbitration(BUSMUTEX_atomic_instance_t* instance,
+                                           UTIMER_instance_t* utimer,
+                                           BUSMUTEX_client_t* clients,
+                                           uint16_t client_count,
+                                           BUSMUTEX_bus_stats_t* bus_stats);
 
 /*******************************************************************************
  *
- * QUEUE_dequeue_buffer
+ * BUSMUTEX_atomic_clear_stats
  *
  * DESCRIPTION:
- *  element_buffer
- *   Pointer to the buffer location to store a copy of the dequeued elements.
- *
- *  element_count
- *   Number of elements to dequeue to the element_buffer.
- *
- * RETURN:
- *  Actual number of elements dequeued which may be smaller than element_count
- *  if the queue had less elements enqueued.
+ *  Clears the counters of all busses and clients, keeping the hold times of
+ *  busses currently claimed.
  *
  ******************************************************************************/
 
-uint32_t QUEUE_dequeue_buffer(QUEUE_instance_t* instance,
-                              void* element_buffer,
-                              uint32_t element_count);
+void BUSMUTEX_atomic_clear_stats(BUSMUTEX_atomic_instance_t* instance);
 
 /*******************************************************************************
  *
- * QUEUE_get_element_position
+ * BUSMUTEX_atomic_is_available
  *
  * DESCRIPTION:
- *  element
- *   Pointer to an element which will be compared against the elements in the
- *   queue.
- *
- *  position
- *   The position offset from the head of the queue of the first element which
- *   matches the compare element.
+ *  Determines if a bus ID is currently unclaimed.
  *
- * RETURN:
- *  True if the element was found in the queue, else, false.
+ * RETURN
+ *  True if the bus is available, else, false.
  *
  ******************************************************************************/
 
-bool QUEUE_get_element_position(QUEUE_instance_t* instance,
-                                void* element,
-                                uint32_t* position);
+bool BUSMUTEX_atomic_is_available(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_bus_id_t bus_id);
 
 /*******************************************************************************
  *
- * QUEUE_is_full
+ * BUSMUTEX_atomic_get_owner
  *
  * DESCRIPTION:
- *  Checks if the queue is full.
+ *  Gets the owner of a bus ID.
  *
- * RETURNS:
- *  True if the queue is full, else, false.
+ * RETURN
+ *  Owner ID, else, BUSMUTEX_OWNER_ID_NONE if the bus is unclaimed.
  *
  ******************************************************************************/
 
-bool QUEUE_is_full(QUEUE_instance_t* instance);
+uint8_t BUSMUTEX_atomic_get_owner(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_bus_id_t bus_id);
 
 /*******************************************************************************
  *
- * QUEUE_is_empty
+ * BUSMUTEX_atomic_request_mutex
  *
  * DESCRIPTION:
- *  Checks if the queue is empty.
+ *  Attempts to claim the mutex of a bus ID.
  *
- * RETURNS:
- *  True if the queue is empty, else, false.
+ * PARAMETERS:
+ *  bus_id
+ *   BUS ID mutex being requested. BUSMUTEX_BUS_ID_NULL always succeeds.
+ *
+ *  owner_id
+ *   Non-zero ID of the requester.
+ *
+ * RETURN
+ *  True if the bus ID mutex was claimed, else, false.
  *
  ******************************************************************************/
 
-bool QUEUE_is_empty(QUEUE_instance_t* instance);
+bool BUSMUTEX_atomic_request_mutex(BUSMUTEX_atomic_instance_t* instance,
+                                   BUSMUTEX_bus_id_t bus_id,
+                                   uint8_t owner_id);
 
 /*******************************************************************************
  *
- * QUEUE_get_count
+ * BUSMUTEX_atomic_request_or_wait
  *
  * DESCRIPTION:
- *  Gets the number of elements currently enqueued.
+ *  Attempts to claim the mutex of a bus ID and registers a waiter if it is
+ *  claimed by another owner. The waiter is granted the bus when it is
+ *  released, and stays registered until then or until cancelled.
  *
- * RETURNS:
- *  Number of elements enqueued.
+ * PARAMETERS:
+ *  bus_id
+ *   BUS ID mutex being requested.
  *
- ******************************************************************************/
-
-uint32_t QUEUE_get_count(QUEUE_instance_t* instance);
-
-/*******************************************************************************
+ *  owner_id
+ *   Non-zero ID of the requester.
  *
- * QUEUE_clear
+ *  waiter
+ *   User-provided waiter, with the callback members set as needed. Must not
+ *   be registered already.
  *
- * DESCRIPTION:
- *  In non thread-safe mode, zero-fills the queue buffer and sets the element
- *  counter and index offsets to 0. In thread-safe mode, dequeues all elements.
+ * RETURN
+ *  True if the bus ID mutex was claimed immediately, else, false, in which
+ *  case the waiter is signaled once the bus has been granted. The waiter may
+ *  already have been signaled when false is returned.
+ *
+ * NOTES:
+ *  Waiters of equal priority are granted the bus in the order queued.
  *
  ******************************************************************************/
 
-void QUEUE_clear(QUEUE_instance_t* instance);
-
-#ifdef __cplusplus
-}
-#endif
-#endif // QUEUE_J_H
+bool BUSMUTEX_atomic_request_or_wait(BUSMUTEX_atomic_instance_t* instance,
+                                     BUSMUTEX_bus_id_t bus_id,
+                                     uint8_t owner_id,
+                                     BUSMUTEX_waiter_t* waiter);
 
 /*******************************************************************************
  *
- *  Special queue for shared bus tasks built from the Queue and BusMutex
- *  modules. Each instance is only responsible for a single bus ID, hence, a
- *  bus queue should exist for every shared bus. Requires proper initialization
- *  and the dequeue routine to be called repeatedly.
+ * BUSMUTEX_atomic_cancel_wait
+ *
+ * DESCRIPTION:
+ *  Unregisters a waiter which has not been granted a bus yet.
+ *
+ * RETURN
+ *  True if the waiter was unregistered, else, false if it was not registered,
+ *  e.g. because the bus has been granted in the meantime.
  *
  ******************************************************************************/
 
-#ifndef BUS_QUEUE_J_H
-#define BUS_QUEUE_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
+bool BUSMUTEX_atomic_cancel_wait(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_waiter_t* waiter);
 
 /*******************************************************************************
  *
- * BUSQUEUE_task_callback_t
+ * BUSMUTEX_atomic_release_mutex
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called to perform
- *  a new task on the instance shared bus.
+ *  Releases the mutex of a bus ID. If waiters are registered, the bus is
+ *  granted to the first one instead, i.e. the one with the highest priority.
  *
  * PARAMETERS:
- *  context
- *   User-provided context.
+ *  bus_id
+ *   BUS ID mutex being released.
  *
- * RETURN:
- *  True if the task was started and can be removed from the queue, else,
- *  false.
+ *  owner_id
+ *   ID of the owner.
+ *
+ * RETURN
+ *  True if the bus ID mutex was released, else, false if it is not claimed
+ *  by the owner.
  *
  ******************************************************************************/
 
-typedef bool (*BUSQUEUE_task_callback_t)(uint32_t);
+bool BUSMUTEX_atomic_release_mutex(BUSMUTEX_atomic_instance_t* instance,
+                                   BUSMUTEX_bus_id_t bus_id,
+                                   uint8_t owner_id);
 
 /*******************************************************************************
  *
- * BUSQUEUE_element_t
+ * BUSMUTEX_atomic_should_yield
  *
  * DESCRIPTION:
- *  Data structure which is handled by the queue.
+ *  Determines if the owner of a bus has exceeded its hold time budget while
+ *  others are waiting for the bus. To be called between the transfers of a
+ *  long sequence, e.g. an EEPROM page commit or a full frame update, which
+ *  should then release the bus and request it again.
  *
- * context
- *  Value which will be passed into the user task callback function.
- *
- * task_callback
- *  User task function.
+ * RETURN
+ *  True if the bus should be released, else, false.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  uint32_t context;
-  BUSQUEUE_task_callback_t task_callback;
+bool BUSMUTEX_atomic_should_yield(BUSMUTEX_atomic_instance_t* instance,
+                                  BUSMUTEX_bus_id_t bus_id,
+                                  uint8_t owner_id);
+
+#ifdef __cplusplus
 }
-BUSQUEUE_element_t;
+#endif
+#endif // BUS_MUTEX_J_H
 
 /*******************************************************************************
  *
- * BUSQUEUE_flags_t
+ *  Generic queue which supports any data type. The user provides the element
+ *  size and a buffer. Requires proper initialization.
+ *
+ *  The option is available to make the queue thread-safe. This is done by
+ *  not crossing variables which will be used in separate contexts. This comes
+ *  at a cost of efficiency, and that the actual usable queue length will be
+ *  (N-1). The application must also abide by the following rules:
+ *    1. Wrapping is disabled.
+ *    2. Only one context (thread or interrupt) enqueues.
+ *    3. Only one context (thread or interrupt) dequeues.
+ *
+ ******************************************************************************/
+
+#ifndef QUEUE_J_H
+#define QUEUE_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ *
+ * QUEUE_flags_t
  *
  * DESCRIPTION:
  *  Module flags.
  *
+ * wrapping_enabled
+ *  The oldest entries of the queue will be overwritten with new enqueued
+ *  entries if the queue is full. NOTE: Cannot be used in thread-safe mode.
+ *
+ * thread_safe
+ *  The queue will be thread-safe for two application contexts (i.e. Application
+ *  and Interrupt, Application1 and Application2, etc...). NOTE: Cannot be used
+ *  with wrapping.
+ *
  ******************************************************************************/
 
 typedef union
@@ -4847,14 +5104,16 @@ typedef union
   uint8_t all;
   struct
   {
-    uint8_t reserved0                     : 8;
+    uint8_t wrapping_enabled              : 1;
+    uint8_t thread_safe                   : 1;
+    uint8_t reserved2                     : 6;
   };
 }
-BUSQUEUE_flags_t;
+QUEUE_flags_t;
 
 /*******************************************************************************
  *
- * BUSQUEUE_instance_t
+ * QUEUE_instance_t
  *
  * DESCRIPTION:
  *  Instance data and function pointers.
@@ -4862,546 +5121,478 @@ BUSQUEUE_flags_t;
  * flags
  *  Module flags.
  *
- * bus_mutex
- *  User-provided initialized instance of a BUSMUTEX.
+ * buffer
+ *  Pointer to a user-provided buffer which will provide the physical memory
+ *  for the queue. NOTE: Thread-safe queues require a buffer which can hold
+ *  at least 2-elements.
  *
- * bus_id
- *  The bus ID of the shared bus associated with this instance.
+ * buffer_length
+ *  Length, in bytes, of the user-provided buffer.
  *
- * queue
- *  Queue instance contained and controlled by BusQueue. The user provides
- *  the buffer which is used by the queue.
+ * element_size
+ *  Size of a single queue element in bytes.
+ *
+ * queue_length_in_elements
+ *  Calculated number of slots the queue contains based upon the queue length
+ *  and the element size.
+ *
+ * element_counter
+ *  Keeps track of the number of active queue entries. (Only used for quicker
+ *  operations in non thread-safe mode.)
+ *
+ * head_index
+ *  Keeps track of the head of the queue as an index/offset in number of
+ *  elements from the start address of the user-provided buffer.
+ *
+ * tail_index
+ *  Keeps track of the tail of the queue as an index/offset in number of
+ *  elements from the start address of the user-provided buffer.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  BUSQUEUE_flags_t flags;
-  BUSMUTEX_instance_t* bus_mutex;
-  BUSMUTEX_bus_id_t bus_id;
-  QUEUE_instance_t queue;
+  QUEUE_flags_t flags;
+  void* buffer;
+  uint32_t buffer_length;
+  uint32_t element_size;
+  uint32_t queue_length_in_elements;
+  uint32_t element_counter;
+  uint32_t head_index;
+  uint32_t tail_index;
 }
-BUSQUEUE_instance_t;
+QUEUE_instance_t;
 
 /*******************************************************************************
  *
- * BUSQUEUE_initialize
+ * QUEUE_initialize
  *
  * DESCRIPTION:
  *  Initializes a module instance, erasing all data structures and setting
- *  default values.
+ *  default values. SPI method.
  *
  * PARAMETERS:
- *  See BUSQUEUE_instance_t.
- *
- *  queue_buffer
- *   Pointer to user-provided buffer which will be used for the instance queue.
- *   The buffer size should be large enough to hold at least one or more
- *   BUSQUEUE_element_t.
+ *  See QUEUE_instance_t.
  *
- *  queue_buffer_length
- *   Length, in bytes, of the queue buffer.
+ * NOTES:
+ *  The length of the queue will be determined by dividing the buffer size by
+ *  the element size. It is ideal for the element size to be an equal divisor
+ *  of the buffer, however, it is not necessary.
  *
  ******************************************************************************/
 
-void BUSQUEUE_initialize(BUSQUEUE_instance_t* instance,
-                         BUSMUTEX_instance_t* bus_mutex,
-                         BUSMUTEX_bus_id_t bus_id,
-                         uint8_t* queue_buffer,
-                         uint32_t queue_buffer_length);
+void QUEUE_initialize(QUEUE_instance_t* instance,
+                      void* buffer,
+                      uint32_t buffer_length,
+                      uint32_t element_size,
+                      bool wrapping_enabled,
+                      bool thread_safe);
 
 /*******************************************************************************
  *
- * BUSQUEUE_enqueue
+ * QUEUE_enqueue
  *
  * DESCRIPTION:
- *  Attempts to enqueue an new element.
+ *  Attempts to enqueue a single element.
  *
  * PARAMETERS:
- *  task_callback
- *   Task function to call when the element is dequeued.
- *
- *  context
- *   Value which will be passed into the user task callback function.
- *
- *  discard_if_exists
- *   If true, checks if the element already exists on the bus queue. If so,
- *   the new task element is discarded.
+ *  element
+ *   Pointer to the element to enqueue. A copy of the element will be stored on
+ *   the queue.
  *
- * RETURN
+ * RETURN:
  *  True if space was available and the element was enqueued, else, false.
  *
  ******************************************************************************/
 
-bool BUSQUEUE_enqueue(BUSQUEUE_instance_t* instance,
-                      BUSQUEUE_task_callback_t task_callback,
-                      uint32_t context,
-                      bool discard_if_exists);
+bool QUEUE_enqueue(QUEUE_instance_t* instance, void* element);
 
 /*******************************************************************************
  *
- * BUSQUEUE_dequeue
+ * QUEUE_dequeue
  *
  * DESCRIPTION:
- *  Checks if the bus id, associated with the instance, is available. If so,
- *  peeks at the next element and calls its task function callback. If the
- *  callback returns true the element is dequeued.
+ *  Attempts to dequeue a single element.
  *
  * PARAMETERS:
- *  force_dequeue
- *   Will force the next element to dequeue even if the bus is busy and
- *   cannot start a new task. The dequeued task is simply deleted.
+ *  element
+ *   Pointer to a location to store a copy of the dequeued element.
  *
- * RETURN
- *  True if the element was dequeued, else, false.
+ * RETURN:
+ *  True if the queue was not empty and an element was dequeued, else, false.
  *
  ******************************************************************************/
 
-bool BUSQUEUE_dequeue(BUSQUEUE_instance_t* instance, bool force_dequeue);
-
-#ifdef __cplusplus
-}
-#endif
-#endif // BUS_MUTEX_J_H
+bool QUEUE_dequeue(QUEUE_instance_t* instance, void* element);
 
 /*******************************************************************************
  *
- *  Periodic task registrar and handler. Requires proper initialization and
- *  the service routine to be called periodically, ideally every 1-millisecond.
+ * QUEUE_peek
+ *
+ * DESCRIPTION:
+ *  Peeks at the next element in the queue, returning a copy of the element but
+ *  not removing it from the queue.
+ *
+ * PARAMETERS:
+ *  element
+ *   Pointer to the location to store a copy of the element.
+ *
+ * RETURN:
+ *  True if the queue was not empty and a copy was made of the next element
+ *  to be dequeued, else, false.
  *
  ******************************************************************************/
 
-#ifndef CHRONO_J_H
-#define CHRONO_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
+bool QUEUE_peek(QUEUE_instance_t* instance, void* element);
 
 /*******************************************************************************
  *
- * CHRONO_task_flags_t
+ * QUEUE_enqueue_buffer
  *
  * DESCRIPTION:
- *  Module registered task flags.
- *
- * enabled
- *  Enables or disables the registered Chrono task - the task function
- *  callback will not be called and the task counter will not be incremented.
+ *  element_buffer
+ *   Pointer to a buffer of elements to enqueue. Copies of the element(s) will
+ *   be stored on the queue.
  *
- * stop_next
- *  If set, the task enabled flag will be set false after the task is executed.
+ *  element_count
+ *   Number of elements to enqueue from the element_buffer.
  *
- * one_shot
- *  If set, the task will be removed from the task list after the task is
- *  executed.
+ * RETURN:
+ *  Actual number of elements enqueued which may be smaller than element_count
+ *  if room was not available on the queue.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t enabled                       : 1;
-    uint8_t stop_next                     : 1;
-    uint8_t one_shot                      : 1;
-    uint8_t reserved3                     : 5;
-  };
-}
-CHRONO_task_flags_t;
+uint32_t QUEUE_enqueue_buffer(QUEUE_instance_t* instance,
+                              void* element_buffer,
+                              uint32_t element_count);
 
 /*******************************************************************************
  *
- * CHRONO_task_t
+ * QUEUE_dequeue_buffer
  *
  * DESCRIPTION:
- *  Module registered task.
- *
- * flags
- *  Module task flags.
- *
- * task_function
- *  The task function callback which will be called at the task periodic
- *  interval.
- *
- * period_ticks
- *  Number of ticks which define a single periodic interval for the task.
+ *  element_buffer
+ *   Pointer to the buffer location to store a copy of the dequeued elements.
  *
- * tick_counter
- *  Incremented by the chrono instance. The task_function is called once
- *  this value equals period_ticks. Reset to 0 after task_function is called.
+ *  element_count
+ *   Number of elements to dequeue to the element_buffer.
  *
- * next_task
- *  Provides a linked-list data structure for flexible adding and removing
- *  a variable number of tasks to/from the Chrono instance list.
+ * RETURN:
+ *  Actual number of elements dequeued which may be smaller than element_count
+ *  if the queue had less elements enqueued.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  CHRONO_task_flags_t flags;
-  void (*task_function)(void);
-  uint32_t period_ticks;
-  uint32_t tick_counter;
-  void* next_task;
-}
-CHRONO_task_t;
+uint32_t QUEUE_dequeue_buffer(QUEUE_instance_t* instance,
+                              void* element_buffer,
+                              uint32_t element_count);
 
 /*******************************************************************************
  *
- * CHRONO_flags_t
+ * QUEUE_get_element_position
  *
  * DESCRIPTION:
- *  Module flags.
+ *  element
+ *   Pointer to an element which will be compared against the elements in the
+ *   queue.
  *
- * enabled
- *  Enables or disables the chrono instance.
+ *  position
+ *   The position offset from the head of the queue of the first element which
+ *   matches the compare element.
+ *
+ * RETURN:
+ *  True if the element was found in the queue, else, false.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t enabled                       : 1;
-    uint8_t reserved1                     : 7;
-  };
-}
-CHRONO_flags_t;
+bool QUEUE_get_element_position(QUEUE_instance_t* instance,
+                                void* element,
+                                uint32_t* position);
 
 /*******************************************************************************
  *
- * CHRONO_instance_t
+ * QUEUE_is_full
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
- *
- * flags
- *  Module flags.
- *
- * task_count
- *  Keeps track of the number of tasks in the linked list. Not really needed
- *  for operation purposes, rather, here for information an debug purposes.
+ *  Checks if the queue is full.
  *
- * task_list
- *  Linked list of registered tasks. The user is responsible for maintaining
- *  the task structure data - if the Chrono instance is in global space
- *  than so should the task data structures.
+ * RETURNS:
+ *  True if the queue is full, else, false.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  CHRONO_flags_t flags;
-  uint32_t task_count;
-  CHRONO_task_t* task_list;
-}
-CHRONO_instance_t;
+bool QUEUE_is_full(QUEUE_instance_t* instance);
 
 /*******************************************************************************
  *
- * CHRONO_initialize
+ * QUEUE_is_empty
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values. State machine method.
+ *  Checks if the queue is empty.
+ *
+ * RETURNS:
+ *  True if the queue is empty, else, false.
  *
  ******************************************************************************/
 
-void CHRONO_initialize(CHRONO_instance_t* instance);
+bool QUEUE_is_empty(QUEUE_instance_t* instance);
 
 /*******************************************************************************
  *
- * CHRONO_enable
+ * QUEUE_get_count
  *
  * DESCRIPTION:
- *  Enables a module instance.
+ *  Gets the number of elements currently enqueued.
+ *
+ * RETURNS:
+ *  Number of elements enqueued.
  *
  ******************************************************************************/
 
-void CHRONO_enable(CHRONO_instance_t* instance);
+uint32_t QUEUE_get_count(QUEUE_instance_t* instance);
 
 /*******************************************************************************
  *
- * CHRONO_disable
+ * QUEUE_clear
  *
  * DESCRIPTION:
- *  Disables a module instance.
+ *  In non thread-safe mode, zero-fills the queue buffer and sets the element
+ *  counter and index offsets to 0. In thread-safe mode, dequeues all elements.
  *
  ******************************************************************************/
 
-void CHRONO_disable(CHRONO_instance_t* instance);
+void QUEUE_clear(QUEUE_instance_t* instance);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // QUEUE_J_H
 
 /*******************************************************************************
  *
- * CHRONO_add_task
- *
- * DESCRIPTION:
- *  Adds a new task to the task list. Does not add the task if the task already
- *  exists. Clears the tick counter and places the task at the end of the
- *  list.
- *
- * PARMAETERS:
- *  task
- *   Pointer to a task structure in user memory space. The module will NOT copy
- *   the data structure.
- *
- * RETURN:
- *  True if the task was added, else, false (task is already on the list).
+ *  Special queue for shared bus tasks built from the Queue and BusMutex
+ *  modules. Each instance is only responsible for a single bus ID, hence, a
+ *  bus queue should exist for every shared bus. Requires proper initialization
+ *  and the dequeue routine to be called repeatedly.
  *
  ******************************************************************************/
 
-bool CHRONO_add_task(CHRONO_instance_t* instance, CHRONO_task_t* task);
+#ifndef BUS_QUEUE_J_H
+#define BUS_QUEUE_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /*******************************************************************************
  *
- * CHRONO_remove_task
+ * BUSQUEUE_task_callback_t
  *
  * DESCRIPTION:
- *  Removes a task, if it exists, from an instance task list.
+ *  Function template for a user-provided function which is called to perform
+ *  a new task on the instance shared bus.
  *
- * PARMAETERS:
- *  task
- *   Pointer to a task structure in user memory space.
+ * PARAMETERS:
+ *  context
+ *   User-provided context.
  *
  * RETURN:
- *  True if the task was removed, else, false (task was not on the list).
+ *  True if the task was started and can be removed from the queue, else,
+ *  false.
  *
  ******************************************************************************/
 
-bool CHRONO_remove_task(CHRONO_instance_t* instance, CHRONO_task_t* task);
+typedef bool (*BUSQUEUE_task_callback_t)(uint32_t);
 
 /*******************************************************************************
  *
- * CHRONO_service
+ * BUSQUEUE_element_t
  *
  * DESCRIPTION:
- *  Iterates through the task list, increments the counters of enabled tasks,
- *  calls the task functions, etc... Should be called periodically at a set
- *  interval which this module defines as a "tick." If called within interrupt
- *  context, the user should ensure that all tasks are non-blocking.
+ *  Data structure which is handled by the queue.
  *
- * PARAMETERS:
- *  ticks
- *   The number of ticks to increment all periodic chrono tasks. This should
- *   be 1 if the service handler is called periodically without delays. The
- *   value can be greater than 1 if the service function was not able to run
- *   during a set period and needs to catch up on its ticks.
+ * context
+ *  Value which will be passed into the user task callback function.
+ *
+ * task_callback
+ *  User task function.
  *
  ******************************************************************************/
 
-void CHRONO_service(CHRONO_instance_t* instance, uint32_t ticks);
-
-#ifdef __cplusplus
+typedef struct
+{
+  uint32_t context;
+  BUSQUEUE_task_callback_t task_callback;
 }
-#endif
-#endif // CHRONO_J_H
+BUSQUEUE_element_t;
 
 /*******************************************************************************
  *
- *  DMX 512 transmitting and receiving module. Supports both non-blocking
- *  state machine and DMA methods. Both methods require proper initialization
- *  and the service routine to be called repeatedly after a new task request
- *  until the task is completed.
- *
- *  The instance mode (receive/transmit) is uninitialized at initialization
- *  and must be set to either receive or transmit before starting a new task.
- *  The mode can be easily switched between receive and transmit.
- *
- ******************************************************************************/
-
-#ifndef DMX512_J_H
-#define DMX512_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*
- * The maximum number of data bytes which can be transmitted or received in the
- * data section of the protocol packet. DMX 512 does not require the maximum
- * number of data bytes to be transmitted.
- */
-
-#define DMX512_DATA_LENGTH_MAX            512U
-
-/*******************************************************************************
- *
- * DMX512_mode_t
+ * BUSQUEUE_flags_t
  *
  * DESCRIPTION:
- *  Enumerates the available tranmission modes.
+ *  Module flags.
  *
  ******************************************************************************/
 
-typedef enum
+typedef union
 {
-  DMX512_MODE_UNINITIALIZED               = 0,
-  DMX512_MODE_RECEIVE,
-  DMX512_MODE_TRANSMIT
+  uint8_t all;
+  struct
+  {
+    uint8_t reserved0                     : 8;
+  };
 }
-DMX512_mode_t;
+BUSQUEUE_flags_t;
 
 /*******************************************************************************
  *
- * DMX512_start_code_t
+ * BUSQUEUE_instance_t
  *
  * DESCRIPTION:
- *  Enumerates the standard start code values.
+ *  Instance data and function pointers.
+ *
+ * flags
+ *  Module flags.
+ *
+ * bus_mutex
+ *  User-provided initialized instance of a BUSMUTEX.
+ *
+ * bus_id
+ *  The bus ID of the shared bus associated with this instance.
+ *
+ * queue
+ *  Queue instance contained and controlled by BusQueue. The user provides
+ *  the buffer which is used by the queue.
  *
  ******************************************************************************/
 
-typedef enum
+typedef struct
 {
-  DMX512_START_CODE_STANDARD              = 0x00,
-  DMX512_START_CODE_TEXT                  = 0x17,
-  DMX512_START_CODE_SYSTEM_INFO           = 0xCF,
-  DMX512_START_CODE_RDM                   = 0xCC,
+  BUSQUEUE_flags_t flags;
+  BUSMUTEX_instance_t* bus_mutex;
+  BUSMUTEX_bus_id_t bus_id;
+  QUEUE_instance_t queue;
 }
-DMX512_start_code_t;
+BUSQUEUE_instance_t;
 
 /*******************************************************************************
  *
- * DMX512_transaction_data_t
+ * BUSQUEUE_initialize
  *
  * DESCRIPTION:
- *  The start code and data portion of the DMX 512 packet.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
  *
- * start_code
- *  The first valid byte of the transaction which indicates the type of DMX
- *  data being transmitted. The user can compare against this value, once the
- *  transaction completes, to determine what to do with the received DMX data.
+ * PARAMETERS:
+ *  See BUSQUEUE_instance_t.
  *
- * dmx
- *  The data portion of the DMX 512 transaction which immediately follows the
- *  start code.
+ *  queue_buffer
+ *   Pointer to user-provided buffer which will be used for the instance queue.
+ *   The buffer size should be large enough to hold at least one or more
+ *   BUSQUEUE_element_t.
+ *
+ *  queue_buffer_length
+ *   Length, in bytes, of the queue buffer.
  *
  ******************************************************************************/
 
-typedef struct __attribute__((packed, aligned(1)))
-{
-  uint8_t start_code;
-  uint8_t dmx[DMX512_DATA_LENGTH_MAX];
-}
-DMX512_transaction_data_t;
+void BUSQUEUE_initialize(BUSQUEUE_instance_t* instance,
+                         BUSMUTEX_instance_t* bus_mutex,
+                         BUSMUTEX_bus_id_t bus_id,
+                         uint8_t* queue_buffer,
+                         uint32_t queue_buffer_length);
 
 /*******************************************************************************
  *
- * DMX512_transaction_flags_t
+ * BUSQUEUE_enqueue
  *
  * DESCRIPTION:
- *  Module DMX 512 transaction flags which indicate status and errors. The
- *  user application can look at these flags when determining how to handle
- *  "completed" received DMX 512 packets.
- *
- * timeout
- *  The maximum allowable time since the beginning of a receive or transmit of
- *  a DMX packet has passed.
+ *  Attempts to enqueue an new element.
  *
- * dma_transfer
- *  An error occurred during the DMA transfer.
+ * PARAMETERS:
+ *  task_callback
+ *   Task function to call when the element is dequeued.
  *
- * uart_overflow
- *  The UART hardware receive buffer overflowed during the receive.
+ *  context
+ *   Value which will be passed into the user task callback function.
  *
- * uart_frame
- *  A UART frame error was detected during the receive.
+ *  discard_if_exists
+ *   If true, checks if the element already exists on the bus queue. If so,
+ *   the new task element is discarded.
  *
- * uart_break_missed
- *  The DMX break was not detected during the receive.
+ * RETURN
+ *  True if space was available and the element was enqueued, else, false.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint16_t all;
-  struct
-  {
-    uint16_t timeout                      : 1;
-    uint16_t dma_transfer_error           : 1;
-    uint16_t uart_overflow_error          : 1;
-    uint16_t uart_frame_error             : 1;
-    uint16_t uart_break_missed            : 1;
-    uint16_t reserved5                    : 11;
-  };
-}
-DMX512_transaction_flags_t;
+bool BUSQUEUE_enqueue(BUSQUEUE_instance_t* instance,
+                      BUSQUEUE_task_callback_t task_callback,
+                      uint32_t context,
+                      bool discard_if_exists);
 
 /*******************************************************************************
  *
- * DMX512_transaction_t
+ * BUSQUEUE_dequeue
  *
  * DESCRIPTION:
- *  Transaction data and additional meta for a single DMX 512 transaction.
- *
- * flags
- *  See DMX512_transaction_flags_t.
+ *  Checks if the bus id, associated with the instance, is available. If so,
+ *  peeks at the next element and calls its task function callback. If the
+ *  callback returns true the element is dequeued.
  *
- * data_length
- *  The number of bytes to write in a transmit. This includes both the start
- *  code and the DMX data.
+ * PARAMETERS:
+ *  force_dequeue
+ *   Will force the next element to dequeue even if the bus is busy and
+ *   cannot start a new task. The dequeued task is simply deleted.
  *
- * data
- *  See DMX512_transaction_data_t.
+ * RETURN
+ *  True if the element was dequeued, else, false.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  DMX512_transaction_flags_t flags;
-  uint16_t data_length;
-  DMX512_transaction_data_t data;
+bool BUSQUEUE_dequeue(BUSQUEUE_instance_t* instance, bool force_dequeue);
+
+#ifdef __cplusplus
 }
-DMX512_transaction_t;
+#endif
+#endif // BUS_MUTEX_J_H
 
 /*******************************************************************************
  *
- * DMX512_transaction_buffers_t
- *
- * DESCRIPTION:
- *  A three buffer system is used to support working versus stable data and DMX
- *  channel data versus other non-channel data (RDM, TEXT, etc...). At any time
- *  only one of the buffers is the "working" buffer. The other two are stable
- *  buffers, one for DMX and the other for all other types of data. This setup
- *  assumes that DMX channel data will be most prevelant, and that all other
- *  data types can share a single double buffer.
- *
- * transaction
- *  See DMX512_transaction_t
+ *  Periodic task registrar and handler. Requires proper initialization and
+ *  the service routine to be called periodically, ideally every 1-millisecond.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  DMX512_transaction_t transaction[3];
-}
-DMX512_transaction_buffers_t;
+#ifndef CHRONO_J_H
+#define CHRONO_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /*******************************************************************************
  *
- * DMX512_flags_t
+ * CHRONO_task_flags_t
  *
  * DESCRIPTION:
- *  Module flags.
- *
- * busy
- *  Set when the module is busy with a task and cleared when the task is
- *  completed.
+ *  Module registered task flags.
  *
- * mode
- *  The current mode of the instance, either receiver or transmitter.
+ * enabled
+ *  Enables or disables the registered Chrono task - the task function
+ *  callback will not be called and the task counter will not be incremented.
  *
- * dma
- *  Set true if module is initialized to use DMA.
+ * stop_next
+ *  If set, the task enabled flag will be set false after the task is executed.
  *
- * task_state
- *  State machine state.
+ * one_shot
+ *  If set, the task will be removed from the task list after the task is
+ *  executed.
  *
  ******************************************************************************/
 
@@ -5410,755 +5601,766 @@ typedef union
   uint8_t all;
   struct
   {
-    uint8_t busy                          : 1;
-    uint8_t mode                          : 2;
-    uint8_t dma                           : 1;
-    uint8_t task_state                    : 4;
+    uint8_t enabled                       : 1;
+    uint8_t stop_next                     : 1;
+    uint8_t one_shot                      : 1;
+    uint8_t reserved3                     : 5;
   };
 }
-DMX512_flags_t;
+CHRONO_task_flags_t;
 
 /*******************************************************************************
  *
- * DMX512_receive_complete_callback_t
+ * CHRONO_task_t
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called after a
- *  receive transaction is completed.
- *
- * PARAMETERS:
- *  transaction
- *   Completed transaction information and data
+ *  Module registered task.
  *
- * NOTES:
- *  Can be initialized as NULL - YES
+ * flags
+ *  Module task flags.
  *
- ******************************************************************************/
+ * task_function
+ *  The task function callback which will be called at the task periodic
+ *  interval.
+ *
+ * period_ticks
+ *  Number of ticks which define a single periodic interval for the task.
+ *
+ * tick_counter
+ *  Incremented by the chrono instance. The task_function is called once
+ *  this value equals period_ticks. Reset to 0 after task_function is called.
+ *
+ * next_task
+ *  Provides a linked-list data structure for flexible adding and removing
+ *  a variable number of tasks to/from the Chrono instance list.
+ *
+ ******************************************************************************/
 
-typedef void (*DMX512_receive_complete_callback_t)(DMX512_transaction_t*);
+typedef struct
+{
+  CHRONO_task_flags_t flags;
+  void (*task_function)(void);
+  uint32_t period_ticks;
+  uint32_t tick_counter;
+  void* next_task;
+}
+CHRONO_task_t;
 
 /*******************************************************************************
  *
- * DMX512_transmit_complete_callback_t
+ * CHRONO_flags_t
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called after a
- *  transmit transaction is completed.
- *
- * PARAMETERS:
- *  transaction
- *   Completed transaction information and data
+ *  Module flags.
  *
- * NOTES:
- *  Can be initialized as NULL - YES
+ * enabled
+ *  Enables or disables the chrono instance.
  *
  ******************************************************************************/
 
-typedef void (*DMX512_transmit_complete_callback_t)(DMX512_transaction_t*);
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t enabled                       : 1;
+    uint8_t reserved1                     : 7;
+  };
+}
+CHRONO_flags_t;
 
 /*******************************************************************************
  *
- * DMX512_pre_task_callback_t
+ * CHRONO_instance_t
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called when a new
- *  task is accepted and initialized but before the task actually begins. This
- *  allows the user to perform any last additional configurations before the
- *  actual logic of the task begins.
+ *  Instance data and function pointers.
  *
- *  Only called when the instance is in transmit mode. In receive mode, a new
- *  receive task is triggered by the UART fault interrupt.
+ * flags
+ *  Module flags.
  *
- * PARAMETERS:
- *  context
- *   User-provided context.
+ * task_count
+ *  Keeps track of the number of tasks in the linked list. Not really needed
+ *  for operation purposes, rather, here for information an debug purposes.
  *
- * NOTES:
- *  Can be initialized as NULL - YES
+ * task_list
+ *  Linked list of registered tasks. The user is responsible for maintaining
+ *  the task structure data - if the Chrono instance is in global space
+ *  than so should the task data structures.
  *
  ******************************************************************************/
 
-typedef void (*DMX512_pre_task_callback_t)(uint32_t);
+typedef struct
+{
+  CHRONO_flags_t flags;
+  uint32_t task_count;
+  CHRONO_task_t* task_list;
+}
+CHRONO_instance_t;
 
 /*******************************************************************************
  *
- * DMX512_post_task_callback_t
+ * CHRONO_initialize
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called after a
- *  task completes.
- *
- * PARAMETERS:
- *  context
- *   User-provided context.
- *
- * NOTES:
- *  Can be initialized as NULL - YES
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values. State machine method.
  *
  ******************************************************************************/
 
-typedef void (*DMX512_post_task_callback_t)(uint32_t);
+void CHRONO_initialize(CHRONO_instance_t* instance);
 
 /*******************************************************************************
  *
- * DMX512_hal_set_dmx_direction_gpio_t
+ * CHRONO_enable
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will handle DMX direction change. This can include changing a
- *  direction GPIO or reconfiguring the line to hook to the UART Tx or Rx.
+ *  Enables a module instance.
  *
- * PARAMETERS:
- *  mode
- *   Receive or transmit.
+ ******************************************************************************/
+
+void CHRONO_enable(CHRONO_instance_t* instance);
+
+/*******************************************************************************
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * CHRONO_disable
+ *
+ * DESCRIPTION:
+ *  Disables a module instance.
  *
  ******************************************************************************/
 
-typedef void (*DMX512_hal_set_dmx_direction_t)(DMX512_mode_t);
+void CHRONO_disable(CHRONO_instance_t* instance);
 
 /*******************************************************************************
  *
- * DMX512_hal_generate_tx_break_t
+ * CHRONO_add_task
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will cause the Tx line to force a break condition (bring the line
- *  low). The method to accomplish this will differ on each processor. One
- *  way is to temporarily configure the line as a GPIO output and drive it
- *  low.
- *
- *  This operation will only be allowed if the instance is in transmit mode.
+ *  Adds a new task to the task list. Does not add the task if the task already
+ *  exists. Clears the tick counter and places the task at the end of the
+ *  list.
  *
- * PARAMETERS:
- *  enable
- *   True to enable the Tx break (force line low), else, false to configure
- *   the line as UART Tx.
+ * PARMAETERS:
+ *  task
+ *   Pointer to a task structure in user memory space. The module will NOT copy
+ *   the data structure.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * RETURN:
+ *  True if the task was added, else, false (task is already on the list).
  *
  ******************************************************************************/
 
-typedef void (*DMX512_hal_generate_tx_break_t)(bool);
+bool CHRONO_add_task(CHRONO_instance_t* instance, CHRONO_task_t* task);
 
 /*******************************************************************************
  *
- * DMX512_hal_is_rx_ready_t
+ * CHRONO_remove_task
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will check if the hardware Rx buffer has data available.
+ *  Removes a task, if it exists, from an instance task list.
  *
- * RETURN:
- *  True if the hardware Rx buffer has data available, else, false.
+ * PARMAETERS:
+ *  task
+ *   Pointer to a task structure in user memory space.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * RETURN:
+ *  True if the task was removed, else, false (task was not on the list).
  *
  ******************************************************************************/
 
-typedef bool (*DMX512_hal_is_rx_ready_t)(void);
+bool CHRONO_remove_task(CHRONO_instance_t* instance, CHRONO_task_t* task);
 
 /*******************************************************************************
  *
- * DMX512_hal_is_tx_ready_t
+ * CHRONO_service
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will check if the hardware Tx buffer has room available.
+ *  Iterates through the task list, increments the counters of enabled tasks,
+ *  calls the task functions, etc... Should be called periodically at a set
+ *  interval which this module defines as a "tick." If called within interrupt
+ *  context, the user should ensure that all tasks are non-blocking.
  *
- * RETURN:
- *  True if the hardware Tx buffer has room available, else, false.
+ * PARAMETERS:
+ *  ticks
+ *   The number of ticks to increment all periodic chrono tasks. This should
+ *   be 1 if the service handler is called periodically without delays. The
+ *   value can be greater than 1 if the service function was not able to run
+ *   during a set period and needs to catch up on its ticks.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ ******************************************************************************/
+
+void CHRONO_service(CHRONO_instance_t* instance, uint32_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // CHRONO_J_H
+
+/*******************************************************************************
+ *
+ *  DMA channel engine. Transfers a chain of descriptors through a DMA channel
+ *  whose hardware is only able to move a limited number of bytes at once. The
+ *  chain is split into segments of at most the hardware maximum length, which
+ *  are started back to back from the transfer complete interrupt. Callbacks
+ *  report when half of the chain and the whole chain have been transferred,
+ *  and the chain can be repeated continuously for double buffering.
+ *
+ *  The HAL start function has the same signature as the configure_dma HAL of
+ *  the ILI9341, WS2812, DMX512 and SHIFTSIPO modules, so an existing platform
+ *  implementation is reused as is. In the other direction, those modules can
+ *  be given a channel instead of the platform function with
+ *  DMAENGINE_DEFINE_HAL_ADAPTER. Their bytes per transfer setting can then be
+ *  set to the full buffer length, so that the chunking and the per-chunk
+ *  interrupt work are done by the engine instead of the driver.
  *
  ******************************************************************************/
 
-typedef bool (*DMX512_hal_is_tx_ready_t)(void);
+#ifndef DMAENGINE_J_H
+#define DMAENGINE_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /*******************************************************************************
  *
- * DMX512_hal_is_tx_empty_t
+ * DMAENGINE_descriptor_t
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will check if the hardware Tx buffer is empty. This is used to check
- *  if a transmit task has completed.
+ *  Link of a descriptor chain. Only to be allocated by the user and not to be
+ *  modified while the chain is transferred.
  *
- * RETURN:
- *  True if the hardware Tx buffer is empty, else, false.
+ * data
+ *  DMA compatible buffer.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * length
+ *  Length of the buffer in bytes. Can be 0.
+ *
+ * next_descriptor
+ *  Next link, NULL at the end of the chain.
  *
  ******************************************************************************/
 
-typedef bool (*DMX512_hal_is_tx_empty_t)(void);
+typedef struct
+{
+  void* data;
+  uint32_t length;
+  void* next_descriptor;
+}
+DMAENGINE_descriptor_t;
 
 /*******************************************************************************
  *
- * DMX512_hal_read_rx_register_t
+ * DMAENGINE_flags_t
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will read the next available byte from the hardware Rx buffer.
+ *  Module flags.
  *
- * RETURN:
- *  The next read byte from the Rx hardware buffer.
+ * busy
+ *  Set while a chain is transferred.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * circular
+ *  Set if the chain is restarted once completed.
+ *
+ * half_signaled
+ *  Set once the half complete callback has been called for the current pass.
+ *
+ * error
+ *  Set if a segment failed to start or the transfer error handler was called.
  *
  ******************************************************************************/
 
-typedef uint8_t (*DMX512_hal_read_rx_register_t)(void);
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t busy                          : 1;
+    uint8_t circular                      : 1;
+    uint8_t half_signaled                 : 1;
+    uint8_t error                         : 1;
+    uint8_t reserved4                     : 4;
+  };
+}
+DMAENGINE_flags_t;
 
 /*******************************************************************************
  *
- * DMX512_hal_write_tx_register_t
+ * DMAENGINE_callback_t
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will write a byte into the hardware Tx buffer.
+ *  Function template for a user-provided function which is called from the
+ *  transfer complete interrupt context.
  *
  * PARAMETERS:
- *  value
- *   Byte to be written to the hardware Tx buffer.
- *
- * NOTES:
- *  Can be initialized as NULL - NO
+ *  context
+ *   The channel callback context.
  *
  ******************************************************************************/
 
-typedef void (*DMX512_hal_write_tx_register_t)(uint8_t);
+typedef void (*DMAENGINE_callback_t)(uint32_t context);
 
 /*******************************************************************************
  *
- * DMX512_hal_error_check_rx_overflow_t
+ * DMAENGINE_hal_start_t
  *
  * DESCRIPTION:
  *  Hardware abstraction layer function template for a user-provided function
- *  which will check if the buffer overflow error interrupt flag was triggered.
+ *  which will configure and start a DMA transfer.
+ *
+ * PARAMETERS:
+ *  src_addr
+ *   Starting memory address of the data to be transferred.
+ *
+ *  src_length
+ *   Number of bytes to transfer, at most the maximum segment length.
  *
  * RETURN:
- *  True if the flag is set, else, false.
+ *  True if the configuration was successful and started, else, false.
  *
  * NOTES:
  *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef bool (*DMX512_hal_error_check_rx_overflow_t)(void);
+typedef bool (*DMAENGINE_hal_start_t)(void*, uint32_t);
 
 /*******************************************************************************
  *
- * DMX512_hal_error_check_rx_break_t
+ * DMAENGINE_hal_stop_t
  *
  * DESCRIPTION:
  *  Hardware abstraction layer function template for a user-provided function
- *  which will check if the break error interrupt flag was triggered. This is not
- *  really an error in DMX context, but is expected, and needed, to operate
- *  correctly. We expect each new received packet to be preceeded with  a break
- *  which will trigger a break interrupt.
- *
- * RETURN:
- *  True if the flag is set, else, false.
+ *  which will disable the DMA.
  *
  * NOTES:
  *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef bool (*DMX512_hal_error_check_rx_break_t)(void);
+typedef void (*DMAENGINE_hal_stop_t)(void);
 
 /*******************************************************************************
  *
- * DMX512_hal_error_check_rx_frame_t
+ * DMAENGINE_channel_t
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will check if the frame error interrupt flag was triggered.
+ *  Instance data and function pointers.
  *
- * RETURN:
- *  True if the flag is set, else, false.
+ * flags
+ *  Module flags.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * max_segment_length
+ *  The maximum number of bytes the hardware transfers at once.
  *
- ******************************************************************************/
-
-typedef bool (*DMX512_hal_error_check_rx_frame_t)(void);
-
-/*******************************************************************************
+ * chain
+ *  First descriptor of the chain.
  *
- * DMX512_hal_clear_rx_error_flags_t
+ * descriptor
+ *  Descriptor currently transferred.
  *
- * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will clear Rx interrupt error flags. Depending on the processor, this
- *  could be interpreted as just clearing the fault interrupt itself. In the
- *  algorithm, this function and DMX512_hal_clear_rx_fault_interrupt are called
- *  one after another.
+ * descriptor_offset
+ *  Offset of the current segment into the current descriptor.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * segment_length
+ *  Length of the current segment.
  *
- ******************************************************************************/
-
-typedef void (*DMX512_hal_clear_rx_error_flags_t)(void);
-
-/*******************************************************************************
+ * chain_length
+ *  Total length of the chain in bytes.
  *
- * DMX512_hal_enable_rx_fault_interrupt_t
+ * transferred_length
+ *  Bytes transferred in the current pass.
  *
- * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will enable and disable the Rx fault interrupt(s).
+ * segment_count
+ *  Number of segments transferred since initialization.
  *
- * PARAMETERS:
- *  enable
- *   True to enable the fault interrupt(s), else, false to disable.
+ * single_descriptor
+ *  Descriptor used by DMAENGINE_transfer.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * callback_context
+ *  Value passed to the callbacks.
+ *
+ * half_complete_callback
+ *  Called once half of the chain has been transferred. Can be NULL.
+ *
+ * complete_callback
+ *  Called once the whole chain has been transferred. Can be NULL.
+ *
+ * error_callback
+ *  Called once the transfer was stopped by an error. Can be NULL.
+ *
+ * *_hal_*
+ *  User-provided functions. See the DMAENGINE typedef comments.
  *
  ******************************************************************************/
 
-typedef void (*DMX512_hal_enable_rx_fault_interrupt_t)(bool);
+typedef struct
+{
+  DMAENGINE_flags_t flags;
+  uint32_t max_segment_length;
+  DMAENGINE_descriptor_t* chain;
+  DMAENGINE_descriptor_t* descriptor;
+  uint32_t descriptor_offset;
+  uint32_t segment_length;
+  uint32_t chain_length;
+  uint32_t transferred_length;
+  uint32_t segment_count;
+  DMAENGINE_descriptor_t single_descriptor;
+  uint32_t callback_context;
+  DMAENGINE_callback_t half_complete_callback;
+  DMAENGINE_callback_t complete_callback;
+  DMAENGINE_callback_t error_callback;
+  DMAENGINE_hal_start_t start;
+  DMAENGINE_hal_stop_t stop;
+}
+DMAENGINE_channel_t;
 
 /*******************************************************************************
  *
- * DMX512_hal_clear_rx_fault_interrupt_t
+ * DMAENGINE_DEFINE_HAL_ADAPTER
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will clear the Rx fault interrupt(s). This must clear all interrupt
- *  flags were set in the fault enable function.
+ *  Defines <prefix>_configure_dma and <prefix>_disable_dma, matching the
+ *  configure_dma and disable_dma HAL templates of the ILI9341, WS2812, DMX512
+ *  and SHIFTSIPO modules, which transfer through a channel. The driver's DMA
+ *  complete handler is to be called from the channel complete callback.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * PARAMETERS:
+ *  prefix
+ *   Name prefix of the functions.
+ *
+ *  channel
+ *   Pointer to the DMAENGINE_channel_t.
  *
  ******************************************************************************/
 
-typedef void (*DMX512_hal_clear_rx_fault_interrupt_t)(void);
+#define DMAENGINE_DEFINE_HAL_ADAPTER(prefix, channel)                          \
+  static bool prefix##_configure_dma(void* src_addr, uint32_t src_length)      \
+  {                                                                            \
+    return DMAENGINE_transfer((channel), src_addr, src_length);                \
+  }                                                                            \
+                                                                               \
+  static void prefix##_disable_dma(void)                                       \
+  {                                                                            \
+    DMAENGINE_abort((channel));                                                \
+  }
 
 /*******************************************************************************
  *
- * DMX512_hal_clear_dma_transfer_complete_interrupt_t
+ * DMAENGINE_initialize
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will clear the DMA transfer complete interrupt (and other DMA complete
- *  related interrupts).
+ *  Initializes a channel, erasing all data structures and setting default
+ *  values.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * PARAMETERS:
+ *  See DMAENGINE_channel_t.
  *
  ******************************************************************************/
 
-typedef void (*DMX512_hal_clear_dma_transfer_complete_interrupt_t)(void);
+void DMAENGINE_initialize(DMAENGINE_channel_t* channel,
+                          uint32_t max_segment_length,
+                          DMAENGINE_hal_start_t start,
+                          DMAENGINE_hal_stop_t stop);
 
 /*******************************************************************************
  *
- * DMX512_hal_configure_dma_receive_t
+ * DMAENGINE_set_callbacks
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will configure the DMA to receive data from the UART Rx.
+ *  Sets the completion callbacks of a channel.
  *
  * PARAMETERS:
- *  dest_addr
- *   Address in memory where the data will be written to.
- *
- *  dest_length
- *   Length, in bytes, of the destination buffer.
- *
- * RETURN:
- *  True if the configuration was successful and started, else, false.
- *
- * NOTES:
- *  Can be initialized as NULL - NO
+ *  See DMAENGINE_channel_t.
  *
  ******************************************************************************/
 
-typedef bool (*DMX512_hal_configure_dma_receive_t)(void*, uint32_t);
+void DMAENGINE_set_callbacks(DMAENGINE_channel_t* channel,
+                             uint32_t callback_context,
+                             DMAENGINE_callback_t half_complete_callback,
+                             DMAENGINE_callback_t complete_callback,
+                             DMAENGINE_callback_t error_callback);
 
 /*******************************************************************************
  *
- * DMX512_hal_configure_dma_transmit_t
+ * DMAENGINE_submit
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will configure the DMA to transmit data to the UART Tx.
+ *  Starts the transfer of a descriptor chain.
  *
  * PARAMETERS:
- *  src_addr
- *   Address in memory where the data will be read from.
+ *  chain
+ *   First descriptor of the chain.
  *
- *  src_length
- *   Length, in bytes, of the source buffer.
+ *  circular
+ *   Restart the chain each time it is completed, until aborted.
  *
  * RETURN:
- *  True if the configuration was successful and started, else, false.
+ *  True if the transfer was started, else, false if the channel is busy, the
+ *  chain is empty, or the first segment failed to start.
  *
  * NOTES:
- *  Can be initialized as NULL - NO
+ *  A segment boundary is placed at half of the chain, so the half complete
+ *  callback is called exactly when the first half has been transferred.
  *
  ******************************************************************************/
 
-typedef bool (*DMX512_hal_configure_dma_transmit_t)(void*, uint32_t);
+bool DMAENGINE_submit(DMAENGINE_channel_t* channel, DMAENGINE_descriptor_t* chain, bool circular);
 
 /*******************************************************************************
  *
- * DMX512_hal_disable_dma_t
+ * DMAENGINE_transfer
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will stop/disable the DMA.
- *
- * NOTES:
- *  Can be initialized as NULL - NO
+ *  Starts the transfer of a single buffer. See DMAENGINE_submit.
  *
  ******************************************************************************/
 
-typedef void (*DMX512_hal_disable_dma_t)(void);
+bool DMAENGINE_transfer(DMAENGINE_channel_t* channel, void* data, uint32_t length);
 
 /*******************************************************************************
  *
- * DMX512_instance_t
+ * DMAENGINE_abort
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
- *
- * flags
- *  Module flags.
- *
- * utimer
- *  User-provided initialized instance of a UTIMER.
- *
- * utimer_ticket
- *  Data structure used with the UTIMER instance.
- *
- * transaction_buffers
- *  Pointer to a user provided buffer, of size DMX512_transaction_buffers_t,
- *  which is DMA compatible and will provide buffering for all transactions.
- *
- * stable_dmx
- *  Points to the last completed and stable DMX data transaction data structure.
- *
- * stable_other
- *  Points to the last completed and stable non-DMX data (RDM, TEXT, etc...)
- *  transaction data structure.
- *
- * stable
- *  Points to the last completed data transaction data structure, either the
- *  stable_dmx or stable_other.
- *
- * working
- *  Points to the data structure which is currently being modified or utilized
- *  for a transaction.
- *
- * break_us
- *  Time, in microseconds, that the line is held low for the "break" portion of
- *  the protocol. This value is defaulted at initialization, but can be modified
- *  by the user to suit their timing needs.
- *
- * mark_after_break_us
- *  Time, in microseconds, that the line is held high for the "MAB" portion of
- *  the protocol. This value is defaulted at initialization, but can be modified
- *  by the user to suit their timing needs.
- *
- * tx_post_timeout_us
- *  Time, in microseconds, that the alrogithm times out after completely sending
- *  the DMX data to the UART peripheral before starting the break condition.
- *  This is intended to provide sufficient time for the peripheral to completely
- *  finish transmitting the Tx data. This value is defaulted at initialization,
- *  but can be modified by the user to suit their timing needs.
- *
- * dmx_byte_counter
- *  Keeps track of the number of received/transmitted DMX bytes during
- *  non-DMA transfers.
- *
- * callback_context
- *  Context passed into the user pre/post task callbacks.
- *
- * service_handler
- *  Internal-use pointer to the active state machine service.
- *
- * *_task_*
- * *_hal_*
- *  User-provided functions. See typedef comments.
+ *  Stops the DMA and ends the transfer without calling any callback.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  volatile DMX512_flags_t flags;
-  UTIMER_instance_t* utimer;
-  volatile UTIMER_ticket_t utimer_ticket;
-  DMX512_transaction_buffers_t* transaction_buffers;
-  DMX512_transaction_t* stable_dmx;
-  DMX512_transaction_t* stable_other;
-  DMX512_transaction_t* stable;
-  DMX512_transaction_t* working;
-  uint16_t break_us;
-  uint16_t mark_after_break_us;
-  uint16_t tx_post_timeout_us;
-  uint16_t dmx_byte_counter;
-  uint32_t callback_context;
-  bool (*service_handler)(void*);
-  DMX512_receive_complete_callback_t receive_complete_callback;
-  DMX512_transmit_complete_callback_t transmit_complete_callback;
-  DMX512_pre_task_callback_t pre_task_callback;
-  DMX512_post_task_callback_t post_task_callback;
-  DMX512_hal_set_dmx_direction_t set_dmx_direction;
-  DMX512_hal_generate_tx_break_t generate_tx_break;
-  DMX512_hal_is_rx_ready_t is_rx_ready;
-  DMX512_hal_is_tx_ready_t is_tx_ready;
-  DMX512_hal_is_tx_empty_t is_tx_empty;
-  DMX512_hal_read_rx_register_t read_rx_register;
-  DMX512_hal_write_tx_register_t write_tx_register;
-  DMX512_hal_error_check_rx_overflow_t error_check_rx_overflow;
-  DMX512_hal_error_check_rx_break_t error_check_rx_break;
-  DMX512_hal_error_check_rx_frame_t error_check_rx_frame;
-  DMX512_hal_clear_rx_error_flags_t clear_rx_error_flags;
-  DMX512_hal_enable_rx_fault_interrupt_t enable_rx_fault_interrupt;
-  DMX512_hal_clear_rx_fault_interrupt_t clear_rx_fault_interrupt;
-  DMX512_hal_clear_dma_transfer_complete_interrupt_t clear_dma_transfer_complete_interrupt;
-  DMX512_hal_configure_dma_receive_t configure_dma_receive;
-  DMX512_hal_configure_dma_transmit_t configure_dma_transmit;
-  DMX512_hal_disable_dma_t disable_dma;
-}
-DMX512_instance_t;
+void DMAENGINE_abort(DMAENGINE_channel_t* channel);
 
 /*******************************************************************************
  *
- * DMX512_uart_fault_isr_handler
+ * DMAENGINE_is_busy
  *
  * DESCRIPTION:
- *  Handler for the UART fault interrupt (break, overflow, and frame). The
- *  user code must call this function from their UART fault ISR.
+ *  Determines if a channel is currently transferring a chain.
  *
- * IMPORTANT:
- *  The user MUST ensure that the UART fault (break, overflow, and frame
- *  errors) interrupt is enabled and that this handler is called from the ISR.
+ * RETURN:
+ *  True if the channel is busy, else, false.
  *
  ******************************************************************************/
 
-void DMX512_uart_fault_isr_handler(DMX512_instance_t* instance);
+bool DMAENGINE_is_busy(DMAENGINE_channel_t* channel);
 
 /*******************************************************************************
  *
- * DMX512_dma_transfer_complete_isr_handler
+ * DMAENGINE_transfer_complete_isr_handler
  *
  * DESCRIPTION:
  *  Handler for the DMA transfer complete interrupt. The user code must call
- *  this function from their DMA transfer complete ISR.
- *
- * IMPORTANT:
- *  If the DMA method is used, the user MUST ensure that the DMA transmission
- *  complete interrupt is enabled and that this handler is called from that
- *  ISR.
+ *  this function from their DMA transfer complete ISR. Starts the next
+ *  segment before calling the callbacks.
  *
  ******************************************************************************/
 
-void DMX512_dma_transfer_complete_isr_handler(DMX512_instance_t* instance);
+void DMAENGINE_transfer_complete_isr_handler(DMAENGINE_channel_t* channel);
 
 /*******************************************************************************
  *
- * DMX512_dma_transfer_error_isr_handler
+ * DMAENGINE_transfer_error_isr_handler
  *
  * DESCRIPTION:
  *  Handler for the DMA transfer error interrupt. The user code must call this
  *  function from their DMA transfer error ISR.
  *
- * IMPORTANT:
- *  If the DMA method is used, the user MUST ensure that the DMA transmission
- *  error interrupt is enabled and that this handler is called from that ISR.
- *
  ******************************************************************************/
 
-void DMX512_dma_transfer_error_isr_handler(DMX512_instance_t* instance);
+void DMAENGINE_transfer_error_isr_handler(DMAENGINE_channel_t* channel);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // DMAENGINE_J_H
 
 /*******************************************************************************
  *
- * DMX512_initialize
- *
- * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values. State machine method.
+ *  DMX 512 transmitting and receiving module. Supports both non-blocking
+ *  state machine and DMA methods. Both methods require proper initialization
+ *  and the service routine to be called repeatedly after a new task request
+ *  until the task is completed.
  *
- * PARAMETERS:
- *  See DMX512_instance_t.
+ *  The instance mode (receive/transmit) is uninitialized at initialization
+ *  and must be set to either receive or transmit before starting a new task.
+ *  The mode can be easily switched between receive and transmit.
  *
  ******************************************************************************/
 
-void DMX512_initialize(DMX512_instance_t* instance,
-                       UTIMER_instance_t* utimer,
-                       DMX512_transaction_buffers_t* transaction_buffers,
-                       DMX512_receive_complete_callback_t receive_complete_callback,
-                       DMX512_transmit_complete_callback_t transmit_complete_callback,
-                       DMX512_pre_task_callback_t pre_task_callback,
-                       DMX512_post_task_callback_t post_task_callback,
-                       DMX512_hal_set_dmx_direction_t set_dmx_direction,
-                       DMX512_hal_generate_tx_break_t generate_tx_break,
-                       DMX512_hal_is_rx_ready_t is_rx_ready,
-                       DMX512_hal_is_tx_ready_t is_tx_ready,
-                       DMX512_hal_is_tx_empty_t is_tx_empty,
-                       DMX512_hal_read_rx_register_t read_rx_register,
-                       DMX512_hal_write_tx_register_t write_tx_register,
-                       DMX512_hal_error_check_rx_overflow_t error_check_rx_overflow,
-                       DMX512_hal_error_check_rx_break_t error_check_rx_break,
-                       DMX512_hal_error_check_rx_frame_t error_check_rx_frame,
-                       DMX512_hal_clear_rx_error_flags_t clear_rx_error_flags,
-                       DMX512_hal_enable_rx_fault_interrupt_t enable_rx_fault_interrupt,
-                       DMX512_hal_clear_rx_fault_interrupt_t clear_rx_fault_interrupt);
+#ifndef DMX512_J_H
+#define DMX512_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The maximum number of data bytes which can be transmitted or received in the
+ * data section of the protocol packet. DMX 512 does not require the maximum
+ * number of data bytes to be transmitted.
+ */
+
+#define DMX512_DATA_LENGTH_MAX            512U
 
 /*******************************************************************************
  *
- * DMX512_initialize_dma
+ * DMX512_mode_t
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values. DMA method.
- *
- * PARAMETERS:
- *  See DMX512_instance_t.
+ *  Enumerates the available tranmission modes.
  *
  ******************************************************************************/
 
-void DMX512_initialize_dma(DMX512_instance_t* instance,
-                           UTIMER_instance_t* utimer,
-                           DMX512_transaction_buffers_t* transaction_buffers,
-                           DMX512_receive_complete_callback_t receive_complete_callback,
-                           DMX512_transmit_complete_callback_t transmit_complete_callback,
-                           DMX512_pre_task_callback_t pre_task_callback,
-                           DMX512_post_task_callback_t post_task_callback,
-                           DMX512_hal_set_dmx_direction_t set_dmx_direction,
-                           DMX512_hal_generate_tx_break_t generate_tx_break,
-                           DMX512_hal_is_rx_ready_t is_rx_ready,
-                           DMX512_hal_read_rx_register_t read_rx_register,
-                           DMX512_hal_error_check_rx_overflow_t error_check_rx_overflow,
-                           DMX512_hal_error_check_rx_break_t error_check_rx_break,
-                           DMX512_hal_error_check_rx_frame_t error_check_rx_frame,
-                           DMX512_hal_clear_rx_error_flags_t clear_rx_error_flags,
-                           DMX512_hal_enable_rx_fault_interrupt_t enable_rx_fault_interrupt,
-                           DMX512_hal_clear_rx_fault_interrupt_t clear_rx_fault_interrupt,
-                           DMX512_hal_clear_dma_transfer_complete_interrupt_t clear_dma_transfer_complete_interrupt,
-                           DMX512_hal_configure_dma_receive_t configure_dma_receive,
-                           DMX512_hal_configure_dma_transmit_t configure_dma_transmit,
-                           DMX512_hal_disable_dma_t disable_dma);
+typedef enum
+{
+  DMX512_MODE_UNINITIALIZED               = 0,
+  DMX512_MODE_RECEIVE,
+  DMX512_MODE_TRANSMIT
+}
+DMX512_mode_t;
 
 /*******************************************************************************
  *
- * DMX512_set_mode
+ * DMX512_start_code_t
  *
  * DESCRIPTION:
- *  Changes the DMX mode to receive or transmit. Any active task(s) will be
- *  aborted.
- *
- * PARAMETER:
- *  mode
- *   Receive or transmit mode.
+ *  Enumerates the standard start code values.
  *
  ******************************************************************************/
 
-void DMX512_set_mode(DMX512_instance_t* instance, DMX512_mode_t mode);
+typedef enum
+{
+  DMX512_START_CODE_STANDARD              = 0x00,
+  DMX512_START_CODE_TEXT                  = 0x17,
+  DMX512_START_CODE_SYSTEM_INFO           = 0xCF,
+  DMX512_START_CODE_RDM                   = 0xCC,
+}
+DMX512_start_code_t;
 
 /*******************************************************************************
  *
- * DMX512_begin_new_dmx_transmit
+ * DMX512_transaction_data_t
  *
  * DESCRIPTION:
- *  Attempts to begin a new DMX transmit task. The request will be accepted if
- *  the instance is in transmit mode and not currently busy with a task.
- *
- * PARAMETERS:
- *  start_code
- *   The first byte of the data portion of the transaction.
- *
- *  data
- *   The bytes following the start code (e.g. DMX values).
+ *  The start code and data portion of the DMX 512 packet.
  *
- *  data_length
- *   The length, in bytes, of the data array (DMX values only, not the
- *   start byte).
+ * start_code
+ *  The first valid byte of the transaction which indicates the type of DMX
+ *  data being transmitted. The user can compare against this value, once the
+ *  transaction completes, to determine what to do with the received DMX data.
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ * dmx
+ *  The data portion of the DMX 512 transaction which immediately follows the
+ *  start code.
  *
  ******************************************************************************/
 
-bool DMX512_begin_new_dmx_transmit(DMX512_instance_t* instance,
-                                   uint8_t start_code,
-                                   uint8_t* data,
-                                   uint16_t data_length);
+typedef struct __attribute__((packed, aligned(1)))
+{
+  uint8_t start_code;
+  uint8_t dmx[DMX512_DATA_LENGTH_MAX];
+}
+DMX512_transaction_data_t;
 
 /*******************************************************************************
  *
- * DMX512_service
+ * DMX512_transaction_flags_t
  *
  * DESCRIPTION:
- *  Services the task state machine. Must be called repeatedly until the task
- *  is completed.
+ *  Module DMX 512 transaction flags which indicate status and errors. The
+ *  user application can look at these flags when determining how to handle
+ *  "completed" received DMX 512 packets.
  *
- * RETURN:
- *  False if there is an ongoing task which has not completed, else, true.
+ * timeout
+ *  The maximum allowable time since the beginning of a receive or transmit of
+ *  a DMX packet has passed.
+ *
+ * dma_transfer
+ *  An error occurred during the DMA transfer.
+ *
+ * uart_overflow
+ *  The UART hardware receive buffer overflowed during the receive.
+ *
+ * uart_frame
+ *  A UART frame error was detected during the receive.
+ *
+ * uart_break_missed
+ *  The DMX break was not detected during the receive.
  *
  ******************************************************************************/
 
-bool DMX512_service(DMX512_instance_t* instance);
+typedef union
+{
+  uint16_t all;
+  struct
+  {
+    uint16_t timeout                      : 1;
+    uint16_t dma_transfer_error           : 1;
+    uint16_t uart_overflow_error          : 1;
+    uint16_t uart_frame_error             : 1;
+    uint16_t uart_break_missed            : 1;
+    uint16_t reserved5                    : 11;
+  };
+}
+DMX512_transaction_flags_t;
 
 /*******************************************************************************
  *
- * DMX512_is_busy
+ * DMX512_transaction_t
  *
  * DESCRIPTION:
- *  Determines if an instance is currently busy with a task.
+ *  Transaction data and additional meta for a single DMX 512 transaction.
  *
- * RETURN:
- *  True if the instance is busy with a task, else, false.
+ * flags
+ *  See DMX512_transaction_flags_t.
+ *
+ * data_length
+ *  The number of bytes to write in a transmit. This includes both the start
+ *  code and the DMX data.
+ *
+ * data
+ *  See DMX512_transaction_data_t.
  *
  ******************************************************************************/
 
-bool DMX512_is_busy(DMX512_instance_t* instance);
-
-#ifdef __cplusplus
+typedef struct
+{
+  DMX512_transaction_flags_t flags;
+  uint16_t data_length;
+  DMX512_transaction_data_t data;
 }
-#endif
-#endif // DMX512_J_H
+DMX512_transaction_t;
 
 /*******************************************************************************
  *
- *  EEPROM with generic HAL interface. Requires proper initialization and the
- *  service routine to be called repeatedly after a new task request until the
- *  task is completed.
+ * DMX512_transaction_buffers_t
  *
- *  While EEPROMs are built by several manufactures, most follow the same
- *  interface of a 2-4 byte address followed by a read or write operation. The
- *  maximum number of bytes that can be written per a single transaction is the
- *  size of the EEPROM page. Once written, the EEPROM needs time to commit the
- *  received data to NVM. A read operation does not have this same limitation
- *  and can span accross pages.
+ * DESCRIPTION:
+ *  A three buffer system is used to support working versus stable data and DMX
+ *  channel data versus other non-channel data (RDM, TEXT, etc...). At any time
+ *  only one of the buffers is the "working" buffer. The other two are stable
+ *  buffers, one for DMX and the other for all other types of data. This setup
+ *  assumes that DMX channel data will be most prevelant, and that all other
+ *  data types can share a single double buffer.
+ *
+ * transaction
+ *  See DMX512_transaction_t
  *
  ******************************************************************************/
 
-#ifndef EEPROM_J_H
-#define EEPROM_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
+typedef struct
+{
+  DMX512_transaction_t transaction[3];
+}
+DMX512_transaction_buffers_t;
 
 /*******************************************************************************
  *
- * EEPROM_flags_t
+ * DMX512_flags_t
  *
  * DESCRIPTION:
  *  Module flags.
@@ -6167,9 +6369,11 @@ extern "C" {
  *  Set when the module is busy with a task and cleared when the task is
  *  completed.
  *
- * erase_task
- *  Set if the current task is an erase task. Allows the erase task to utilize
- *  the write service handler with minor differences.
+ * mode
+ *  The current mode of the instance, either receiver or transmitter.
+ *
+ * dma
+ *  Set true if module is initialized to use DMA.
  *
  * task_state
  *  State machine state.
@@ -6182,1659 +6386,6966 @@ typedef union
   struct
   {
     uint8_t busy                          : 1;
-    uint8_t erase_task                    : 1;
-    uint8_t reserved2                     : 2;
-    uint8_t task_state                    : 3;
-    uint8_t reserved7                     : 1;
+    uint8_t mode                          : 2;
+    uint8_t dma                           : 1;
+    uint8_t task_state                    : 4;
   };
 }
-EEPROM_flags_t;
+DMX512_flags_t;
 
 /*******************************************************************************
  *
- * EEPROM_pre_task_callback_t
+ * DMX512_receive_complete_callback_t
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called when a new
- *  task is accepted and initialized but before the task actually begins. This
- *  allows the user to perform any last additional configurations before the
- *  actual logic of the task begins.
+ *  Function template for a user-provided function which is called after a
+ *  receive transaction is completed.
  *
  * PARAMETERS:
- *  context
- *   User-provided context.
+ *  transaction
+ *   Completed transaction information and data
  *
  * NOTES:
  *  Can be initialized as NULL - YES
  *
  ******************************************************************************/
 
-typedef void (*EEPROM_pre_task_callback_t)(uint32_t);
+typedef void (*DMX512_receive_complete_callback_t)(DMX512_transaction_t*);
 
 /*******************************************************************************
  *
- * EEPROM_post_task_callback_t
+ * DMX512_transmit_complete_callback_t
  *
  * DESCRIPTION:
  *  Function template for a user-provided function which is called after a
- *  task completes.
+ *  transmit transaction is completed.
  *
  * PARAMETERS:
- *  context
- *   User-provided context.
+ *  transaction
+ *   Completed transaction information and data
  *
  * NOTES:
  *  Can be initialized as NULL - YES
  *
  ******************************************************************************/
 
-typedef void (*EEPROM_post_task_callback_t)(uint32_t);
+typedef void (*DMX512_transmit_complete_callback_t)(DMX512_transaction_t*);
 
 /*******************************************************************************
  *
- * EEPROM_hal_driver_read_t
+ * DMX512_pre_task_callback_t
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will read the EEPROM.
+ *  Function template for a user-provided function which is called when a new
+ *  task is accepted and initialized but before the task actually begins. This
+ *  allows the user to perform any last additional configurations before the
+ *  actual logic of the task begins.
+ *
+ *  Only called when the instance is in transmit mode. In receive mode, a new
+ *  receive task is triggered by the UART fault interrupt.
  *
  * PARAMETERS:
- *  address
- *   Starting memory address.
+ *  context
+ *   User-provided context.
  *
- *  address_reg_length
- *   The length, in bytes, of the memory address or register.
+ * NOTES:
+ *  Can be initialized as NULL - YES
  *
- *  buffer
- *   Buffer which will hold the read data.
+ ******************************************************************************/
+
+typedef void (*DMX512_pre_task_callback_t)(uint32_t);
+
+/*******************************************************************************
  *
- *  length
- *   The length, in bytes, of data to read.
+ * DMX512_post_task_callback_t
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called after a
+ *  task completes.
+ *
+ * PARAMETERS:
+ *  context
+ *   User-provided context.
  *
  * NOTES:
- *  Can be initialized as NULL - NO
+ *  Can be initialized as NULL - YES
  *
  ******************************************************************************/
 
-typedef bool (*EEPROM_hal_driver_read_t)(uint32_t, uint8_t, uint8_t*, uint32_t);
+typedef void (*DMX512_post_task_callback_t)(uint32_t);
 
 /*******************************************************************************
  *
- * EEPROM_hal_driver_write_t
+ * DMX512_hal_set_dmx_direction_gpio_t
  *
  * DESCRIPTION:
  *  Hardware abstraction layer function template for a user-provided function
- *  which will write the EEPROM.
+ *  which will handle DMX direction change. This can include changing a
+ *  direction GPIO or reconfiguring the line to hook to the UART Tx or Rx.
  *
  * PARAMETERS:
- *  address
- *   Starting memory address.
+ *  mode
+ *   Receive or transmit.
  *
- *  address_reg_length
- *   The length, in bytes, of the memory address or register.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
- *  buffer
- *   Buffer which holds the data to be written.
+ ******************************************************************************/
+
+typedef void (*DMX512_hal_set_dmx_direction_t)(DMX512_mode_t);
+
+/*******************************************************************************
  *
- *  length
- *   The length, in bytes, of data to write.
+ * DMX512_hal_generate_tx_break_t
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will cause the Tx line to force a break condition (bring the line
+ *  low). The method to accomplish this will differ on each processor. One
+ *  way is to temporarily configure the line as a GPIO output and drive it
+ *  low.
+ *
+ *  This operation will only be allowed if the instance is in transmit mode.
+ *
+ * PARAMETERS:
+ *  enable
+ *   True to enable the Tx break (force line low), else, false to configure
+ *   the line as UART Tx.
  *
  * NOTES:
  *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef bool (*EEPROM_hal_driver_write_t)(uint32_t, uint8_t, uint8_t*, uint32_t);
+typedef void (*DMX512_hal_generate_tx_break_t)(bool);
 
 /*******************************************************************************
  *
- * EEPROM_hal_driver_service_t
+ * DMX512_hal_is_rx_ready_t
  *
  * DESCRIPTION:
  *  Hardware abstraction layer function template for a user-provided function
- *  which will service the driver.
+ *  which will check if the hardware Rx buffer has data available.
  *
  * RETURN:
- *  False if there is an ongoing task which has not completed, else, true.
+ *  True if the hardware Rx buffer has data available, else, false.
  *
  * NOTES:
  *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef bool (*EEPROM_hal_driver_service_t)(void);
+typedef bool (*DMX512_hal_is_rx_ready_t)(void);
 
 /*******************************************************************************
  *
- * EEPROM_hal_driver_timeout_t
+ * DMX512_hal_is_tx_ready_t
  *
  * DESCRIPTION:
  *  Hardware abstraction layer function template for a user-provided function
- *  which will determine if the driver has had a task timeout.
+ *  which will check if the hardware Tx buffer has room available.
  *
  * RETURN:
- *  True if a timeout has occurred, else, false.
+ *  True if the hardware Tx buffer has room available, else, false.
  *
  * NOTES:
  *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef bool (*EEPROM_hal_driver_timeout_t)(void);
+typedef bool (*DMX512_hal_is_tx_ready_t)(void);
 
 /*******************************************************************************
  *
- * EEPROM_instance_t
+ * DMX512_hal_is_tx_empty_t
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will check if the hardware Tx buffer is empty. This is used to check
+ *  if a transmit task has completed.
  *
- * flags
- *  Module flags.
+ * RETURN:
+ *  True if the hardware Tx buffer is empty, else, false.
  *
- * utimer
- *  User-provided initialized instance of a UTIMER.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
- * utimer_ticket
- *  Data structure used with the UTIMER instance.
+ ******************************************************************************/
+
+typedef bool (*DMX512_hal_is_tx_empty_t)(void);
+
+/*******************************************************************************
  *
- * bus_mutex
- *  User-provided initialized instance of a BUSMUTEX.
+ * DMX512_hal_read_rx_register_t
  *
- * bus_id
- *  The BUS ID associated with the BUSMUTEX instance.
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will read the next available byte from the hardware Rx buffer.
  *
- * address_reg_length
- *  The length, in bytes, of the EEPROM address/register.
+ * RETURN:
+ *  The next read byte from the Rx hardware buffer.
  *
- * page_length
- *  The length, in bytes, of a single EEPROM page.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
- * total_length
- *  The length, in bytes, of the entrie EEPROM.
+ ******************************************************************************/
+
+typedef uint8_t (*DMX512_hal_read_rx_register_t)(void);
+
+/*******************************************************************************
  *
- * buffer
- *  Pointer to the user buffer which contains the data to written or will
- *  contain the read data.
+ * DMX512_hal_write_tx_register_t
  *
- * rw_count
- *  The number of bytes to write to, or read from, the data buffer.
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will write a byte into the hardware Tx buffer.
  *
- * rw_counter
- *  Keeps track of the number of bytes that have been written to, or read from,
- *  the data buffer.
+ * PARAMETERS:
+ *  value
+ *   Byte to be written to the hardware Tx buffer.
  *
- * rw_address
- *  The starting address of the RW task.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
- * page_commit_timeout_us
- *  The time, in microseconds, which must be waited between page writes to give
- *  the EEPROM time to commit its volatile page buffer to NVM.
+ ******************************************************************************/
+
+typedef void (*DMX512_hal_write_tx_register_t)(uint8_t);
+
+/*******************************************************************************
  *
- * callback_context
- *  Context passed into the user pre/post operation callbacks.
+ * DMX512_hal_error_check_rx_overflow_t
  *
- * service_handler
- *  Function pointer to the service routine applicable to the initialized
- *  service mode.
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will check if the buffer overflow error interrupt flag was triggered.
  *
- * *_task_*
- *  User-provided functions. See typedef comments.
+ * RETURN:
+ *  True if the flag is set, else, false.
  *
- * *_hal_*
- *  User-provided functions. See typedef comments.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef struct
-{
-  EEPROM_flags_t flags;
-  UTIMER_instance_t* utimer;
-  UTIMER_ticket_t utimer_ticket;
-  BUSMUTEX_instance_t* bus_mutex;
-  BUSMUTEX_bus_id_t bus_id;
-  uint8_t address_reg_length;
-  uint16_t page_length;
-  uint32_t total_length;
-  uint8_t* buffer;
-  uint32_t rw_count;
-  uint32_t rw_counter;
-  uint32_t rw_address;
-  uint32_t page_commit_timeout_us;
-  uint32_t callback_context;
-  bool (*service_handler)(void* instance);
-  EEPROM_pre_task_callback_t pre_task_callback;
-  EEPROM_post_task_callback_t post_task_callback;
-  EEPROM_hal_driver_read_t driver_read;
-  EEPROM_hal_driver_write_t driver_write;
-  EEPROM_hal_driver_service_t driver_service;
-  EEPROM_hal_driver_timeout_t driver_timeout;
-}
-EEPROM_instance_t;
+typedef bool (*DMX512_hal_error_check_rx_overflow_t)(void);
 
 /*******************************************************************************
  *
- * EEPROM_initialize
+ * DMX512_hal_error_check_rx_break_t
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will check if the break error interrupt flag was triggered. This is not
+ *  really an error in DMX context, but is expected, and needed, to operate
+ *  correctly. We expect each new received packet to be preceeded with  a break
+ *  which will trigger a break interrupt.
  *
- * PARAMETERS:
- *  See EEPROM_instance_t.
+ * RETURN:
+ *  True if the flag is set, else, false.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-void EEPROM_initialize(EEPROM_instance_t* instance,
-                       UTIMER_instance_t* utimer,
-                       BUSMUTEX_instance_t* bus_mutex,
-                       BUSMUTEX_bus_id_t bus_id,
-                       uint8_t address_reg_length,
-                       uint16_t page_length,
-                       uint32_t total_length,
-                       uint32_t page_commit_timeout_us,
-                       EEPROM_pre_task_callback_t pre_task_callback,
-                       EEPROM_post_task_callback_t post_task_callback,
-                       EEPROM_hal_driver_read_t driver_read,
-                       EEPROM_hal_driver_write_t driver_write,
-                       EEPROM_hal_driver_service_t driver_service,
-                       EEPROM_hal_driver_timeout_t driver_timeout);
+typedef bool (*DMX512_hal_error_check_rx_break_t)(void);
 
 /*******************************************************************************
  *
- * EEPROM_purge
+ * DMX512_hal_error_check_rx_frame_t
  *
  * DESCRIPTION:
- *  Attempts to begin a new EEPROM erase task with the address range of the
- *  entire EEPROM.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will check if the frame error interrupt flag was triggered.
  *
  * RETURN:
- *  True if the task request was accepted, else, false.
+ *  True if the flag is set, else, false.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-bool EEPROM_purge(EEPROM_instance_t* instance);
+typedef bool (*DMX512_hal_error_check_rx_frame_t)(void);
 
 /*******************************************************************************
  *
- * EEPROM_erase
+ * DMX512_hal_clear_rx_error_flags_t
  *
  * DESCRIPTION:
- *  Attempts to begin a new EEPROM erase task.
- *
- * PARAMETERS:
- *  start_address
- *   The starting memory address.
- *
- *  length
- *   The length, in bytes, to erase.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will clear Rx interrupt error flags. Depending on the processor, this
+ *  could be interpreted as just clearing the fault interrupt itself. In the
+ *  algorithm, this function and DMX512_hal_clear_rx_fault_interrupt are called
+ *  one after another.
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-bool EEPROM_erase(EEPROM_instance_t* instance,
-                  uint32_t start_address,
-                  uint32_t length);
+typedef void (*DMX512_hal_clear_rx_error_flags_t)(void);
 
 /*******************************************************************************
  *
- * EEPROM_begin_new_write
+ * DMX512_hal_enable_rx_fault_interrupt_t
  *
  * DESCRIPTION:
- *  Attempts to begin a new EEPROM write task.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will enable and disable the Rx fault interrupt(s).
  *
  * PARAMETERS:
- *  start_address
- *   The starting EEPROM memory address where the data will be written.
- *
- *  buffer
- *   User buffer which contains the data to be written to the EEPROM.
- *
- *  length
- *   The length, in bytes, of the buffer (number of bytes to write).
+ *  enable
+ *   True to enable the fault interrupt(s), else, false to disable.
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-bool EEPROM_begin_new_write(EEPROM_instance_t* instance,
-                            uint32_t start_address,
-                            uint8_t* buffer,
-                            uint32_t length);
+typedef void (*DMX512_hal_enable_rx_fault_interrupt_t)(bool);
 
 /*******************************************************************************
  *
- * EEPROM_begin_new_read
+ * DMX512_hal_clear_rx_fault_interrupt_t
  *
  * DESCRIPTION:
- *  Attempts to begin a new EEPROM read task.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will clear the Rx fault interrupt(s). This must clear all interrupt
+ *  flags were set in the fault enable function.
  *
- * PARAMETERS:
- *  start_address
- *   The starting EEPROM memory address where the data will be read.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
- *  buffer
- *   User buffer which will hold the data read from the EEPROM.
+ ******************************************************************************/
+
+typedef void (*DMX512_hal_clear_rx_fault_interrupt_t)(void);
+
+/*******************************************************************************
  *
- *  length
- *   The length, in bytes, of the buffer (number of bytes to read).
+ * DMX512_hal_clear_dma_transfer_complete_interrupt_t
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will clear the DMA transfer complete interrupt (and other DMA complete
+ *  related interrupts).
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-bool EEPROM_begin_new_read(EEPROM_instance_t* instance,
-                           uint32_t start_address,
-                           uint8_t* buffer,
-                           uint32_t length);
+typedef void (*DMX512_hal_clear_dma_transfer_complete_interrupt_t)(void);
 
 /*******************************************************************************
  *
- * EEPROM_service
+ * DMX512_hal_configure_dma_receive_t
  *
  * DESCRIPTION:
- *  Services the task state machine. Must be called repeatedly until the task
- *  is completed.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will configure the DMA to receive data from the UART Rx.
+ *
+ * PARAMETERS:
+ *  dest_addr
+ *   Address in memory where the data will be written to.
+ *
+ *  dest_length
+ *   Length, in bytes, of the destination buffer.
  *
  * RETURN:
- *  False if there is an ongoing task which has not completed, else, true.
+ *  True if the configuration was successful and started, else, false.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-bool EEPROM_service(EEPROM_instance_t* instance);
+typedef bool (*DMX512_hal_configure_dma_receive_t)(void*, uint32_t);
 
 /*******************************************************************************
  *
- * EEPROM_is_busy
+ * DMX512_hal_configure_dma_transmit_t
  *
  * DESCRIPTION:
- *  Determines if an instance is currently busy with a task.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will configure the DMA to transmit data to the UART Tx.
+ *
+ * PARAMETERS:
+ *  src_addr
+ *   Address in memory where the data will be read from.
+ *
+ *  src_length
+ *   Length, in bytes, of the source buffer.
  *
  * RETURN:
- *  True if the instance is busy with a task, else, false.
+ *  True if the configuration was successful and started, else, false.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-bool EEPROM_is_busy(EEPROM_instance_t* instance);
-
-#ifdef __cplusplus
-}
-#endif
-#endif // EEPROM_J_H
+typedef bool (*DMX512_hal_configure_dma_transmit_t)(void*, uint32_t);
 
 /*******************************************************************************
  *
- *  Font structures for standard gfx font. Adafruit provides a tool which can
- *  convert between True-type to gfx here: https://rop.nl/truetype2gfx/
+ * DMX512_hal_disable_dma_t
+ *
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will stop/disable the DMA.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-#ifndef GFX2D_FONT_J_H
-#define GFX2D_FONT_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
+typedef void (*DMX512_hal_disable_dma_t)(void);
 
 /*******************************************************************************
  *
- * GFX2DFONT_glyph_t
+ * DMX512_instance_t
  *
  * DESCRIPTION:
- *  Provides meta information about a particular glyph/character which resides
- *  within the actual font bitmap.
+ *  Instance data and function pointers.
  *
- * bitmap_offset
- *  Offset into the bitmap where the glyph data begins.
+ * flags
+ *  Module flags.
  *
- * width
- *  Width of the glyph in pixels.
+ * utimer
+ *  User-provided initialized instance of a UTIMER.
  *
- * height
- *  Height of the glyph in pixels.
+ * utimer_ticket
+ *  Data structure used with the UTIMER instance.
  *
- * x_advance
- *  Distance to advance the cursor after each printed glyph. For mono-spaced
- *  fonts, this normally equals the width of the widest character.
+ * transaction_buffers
+ *  Pointer to a user provided buffer, of size DMX512_transaction_buffers_t,
+ *  which is DMA compatible and will provide buffering for all transactions.
  *
- * x_offset
- *  Distance, in pixels, from cursor position to upper-left corner. Not always
- *  zero because the glyph may be somewhat centered in its allowed space.
+ * stable_dmx
+ *  Points to the last completed and stable DMX data transaction data structure.
  *
- * y_offset
- *  Distance, in pixels, from cursor position to upper-left corner. The cursor
- *  is located in the bottom-left corner of the glyph space, so this value is
- *  almost always negative (positive for something like '_').
+ * stable_other
+ *  Points to the last completed and stable non-DMX data (RDM, TEXT, etc...)
+ *  transaction data structure.
  *
- ******************************************************************************/
-
-typedef struct
-{
-  uint16_t bitmap_offset;
-  uint8_t width;
-  uint8_t height;
-  uint8_t x_advance;
-  int8_t x_offset;
-  int8_t y_offset;
-}
-GFX2DFONT_glyph_t;
-
-/*******************************************************************************
+ * stable
+ *  Points to the last completed data transaction data structure, either the
+ *  stable_dmx or stable_other.
  *
- * GFX2DFONT_font_t
+ * working
+ *  Points to the data structure which is currently being modified or utilized
+ *  for a transaction.
  *
- * DESCRIPTION:
- *  An entire font module in which a bitmap contains all the glyph/characters,
- *  and meta information describes the glyph offsets in the bitmap.
+ * break_us
+ *  Time, in microseconds, that the line is held low for the "break" portion of
+ *  the protocol. This value is defaulted at initialization, but can be modified
+ *  by the user to suit their timing needs.
  *
- * bitmap
- *  Bitmap containing all font glyph/characters.
+ * mark_after_break_us
+ *  Time, in microseconds, that the line is held high for the "MAB" portion of
+ *  the protocol. This value is defaulted at initialization, but can be modified
+ *  by the user to suit their timing needs.
  *
- * glyph
- *  Array of glyph, one for each glyph/character, which provides meta
- *  information of the location in the bitmap.
+ * tx_post_timeout_us
+ *  Time, in microseconds, that the alrogithm times out after completely sending
+ *  the DMX data to the UART peripheral before starting the break condition.
+ *  This is intended to provide sufficient time for the peripheral to completely
+ *  finish transmitting the Tx data. This value is defaulted at initialization,
+ *  but can be modified by the user to suit their timing needs.
  *
- * first_ascii
- *  First ASCII character/glyph supported by the font.
+ * dmx_byte_counter
+ *  Keeps track of the number of received/transmitted DMX bytes during
+ *  non-DMA transfers.
  *
- * last_ascii
- *  Last ASCII character/glyph supported by the font.
+ * callback_context
+ *  Context passed into the user pre/post task callbacks.
  *
- * y_advance
- *  Distance to move cursor down for the next line of text.
+ * service_handler
+ *  Internal-use pointer to the active state machine service.
+ *
+ * *_task_*
+ * *_hal_*
+ *  User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  uint8_t* bitmap;
-  GFX2DFONT_glyph_t* glyph;
-  uint16_t first_ascii;
-  uint16_t last_ascii;
-  uint8_t y_advance;
-}
-GFX2DFONT_font_t;
-
-/*
- * Default font.
- */
-
-extern const GFX2DFONT_font_t GFX2DFONT_DEFAULT_FONT;
-
-#ifdef __cplusplus
-}
-#endif
-#endif // GFX2D_FONT_J_H
+  volatile DMX512_flags_t flags;
+  UTIMER_instance_t* utimer;
+  volatile UTIMER_ticket_t utimer_ticket;
+  DMX512_transaction_buffers_t* transaction_buffers;
+  DMX512_transaction_t* stable_dmx;
+  DMX512_transaction_t* stable_other;
+  DMX512_transaction_t* stable;
+  DMX512_transaction_t* working;
+  uint16_t break_us;
+  uint16_t mark_after_break_us;
+  uint16_t tx_post_timeout_us;
+  uint16_t dmx_byte_counter;
+  uint32_t callback_context;
+  bool (*service_handler)(void*);
+  DMX512_receive_complete_callback_t receive_complete_callback;
+  DMX512_transmit_complete_callback_t transmit_complete_callback;
+  DMX512_pre_task_callback_t pre_task_callback;
+  DMX512_post_task_callback_t post_task_callback;
+  DMX512_hal_set_dmx_direction_t set_dmx_direction;
+  DMX512_hal_generate_tx_break_t generate_tx_break;
+  DMX512_hal_is_rx_ready_t is_rx_ready;
+  DMX512_hal_is_tx_ready_t is_tx_ready;
+  DMX512_hal_is_tx_empty_t is_tx_empty;
+  DMX512_hal_read_rx_register_t read_rx_register;
+  DMX512_hal_write_tx_register_t write_tx_register;
+  DMX512_hal_error_check_rx_overflow_t error_check_rx_overflow;
+  DMX512_hal_error_check_rx_break_t error_check_rx_break;
+  DMX512_hal_error_check_rx_frame_t error_check_rx_frame;
+  DMX512_hal_clear_rx_error_flags_t clear_rx_error_flags;
+  DMX512_hal_enable_rx_fault_interrupt_t enable_rx_fault_interrupt;
+  DMX512_hal_clear_rx_fault_interrupt_t clear_rx_fault_interrupt;
+  DMX512_hal_clear_dma_transfer_complete_interrupt_t clear_dma_transfer_complete_interrupt;
+  DMX512_hal_configure_dma_receive_t configure_dma_receive;
+  DMX512_hal_configure_dma_transmit_t configure_dma_transmit;
+  DMX512_hal_disable_dma_t disable_dma;
+}
+DMX512_instance_t;
 
 /*******************************************************************************
  *
- *  Simple graphics library which can render basic shapes and images. Elements
- *  are rendered into a memory buffer. It is then up to external user code to
- *  send the buffer to the display.
- *
- *  With segmentation the target display can be rendered in parts. This is used
- *  when there is not enough memory to host an entire virtual display buffer.
- *  Since each segment requires a re-render of the display frame, it is ideal
- *  to have a large enough buffer which can hold the entire virtual display
- *  frame buffer.
+ * DMX512_uart_fault_isr_handler
  *
- *  This library supports all combinations of up to 32-bit RGB formats (e.g.
- *  3:3:2, 3:3:3, 4:4:4, 5:6:5, 6:6:6, 8:8:8, etc...) The RGB bit makeup of the
- *  pixel is irrelevant to the library logic. Instead, the user is required to
- *  provide a function which interprets a provided RBGA color into the desired
- *  pixel format.
+ * DESCRIPTION:
+ *  Handler for the UART fault interrupt (break, overflow, and frame). The
+ *  user code must call this function from their UART fault ISR.
  *
- *  While this library supports non-byte-aligned formats (i.e. when the sum of
- *  the RGBA bits is not divisible by 8), the algorithm throughput for these
- *  formats is considerably slower, on the order to 20x slower or more.
+ * IMPORTANT:
+ *  The user MUST ensure that the UART fault (break, overflow, and frame
+ *  errors) interrupt is enabled and that this handler is called from the ISR.
  *
  ******************************************************************************/
 
-#ifndef GFX2D_J_H
-#define GFX2D_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
+void DMX512_uart_fault_isr_handler(DMX512_instance_t* instance);
 
 /*******************************************************************************
  *
- * GFX2D_rgb_bitmap_t
+ * DMX512_dma_transfer_complete_isr_handler
  *
  * DESCRIPTION:
- *  Enumerates the various supported bitmap types for draw_rgb_bitmap.
+ *  Handler for the DMA transfer complete interrupt. The user code must call
+ *  this function from their DMA transfer complete ISR.
+ *
+ * IMPORTANT:
+ *  If the DMA method is used, the user MUST ensure that the DMA transmission
+ *  complete interrupt is enabled and that this handler is called from that
+ *  ISR.
  *
  ******************************************************************************/
 
-typedef enum
-{
-  GFX2D_RGB_BITMAP_332                    = 0,
-  GFX2D_RGB_BITMAP_565,
-  GFX2D_RGB_BITMAP_888
-}
-GFX2D_rgb_bitmap_t;
+void DMX512_dma_transfer_complete_isr_handler(DMX512_instance_t* instance);
 
 /*******************************************************************************
  *
- * GFX2D_circle_quadrant_t
+ * DMX512_dma_transfer_error_isr_handler
  *
  * DESCRIPTION:
- *  Used for determining which quadrants of a circle need to be drawn.
+ *  Handler for the DMA transfer error interrupt. The user code must call this
+ *  function from their DMA transfer error ISR.
+ *
+ * IMPORTANT:
+ *  If the DMA method is used, the user MUST ensure that the DMA transmission
+ *  error interrupt is enabled and that this handler is called from that ISR.
  *
  ******************************************************************************/
 
-typedef enum
-{
-  GFX2D_CIRCLE_QUADRANT_NONE              = 0, // 0b0000
-  GFX2D_CIRCLE_QUADRANT_TOP_LEFT          = 1, // 0b0001
-  GFX2D_CIRCLE_QUADRANT_TOP_RIGHT         = 2, // 0b0010
-  GFX2D_CIRCLE_QUADRANT_BOTTOM_LEFT       = 4, // 0b0100
-  GFX2D_CIRCLE_QUADRANT_BOTTOM_RIGHT      = 8, // 0b1000
-  GFX2D_CIRCLE_QUADRANT_ALL               = 15 // 0b1111
-}
-GFX2D_circle_quadrant_t;
+void DMX512_dma_transfer_error_isr_handler(DMX512_instance_t* instance);
 
 /*******************************************************************************
  *
- * GFX2D_rgba_t
+ * DMX512_initialize
  *
  * DESCRIPTION:
- *  Traditional 32-bit color, RGB with an Alpha channel. This type is used for
- *  user input and does not necessarily reflect the rendered color based on
- *  pixel color settings.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values. State machine method.
+ *
+ * PARAMETERS:
+ *  See DMX512_instance_t.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint32_t all;
-  struct
-  {
-    uint32_t r                            : 8;
-    uint32_t g                            : 8;
-    uint32_t b                            : 8;
-    uint32_t a                            : 8;
-  };
-}
-GFX2D_rgba_t;
+void DMX512_initialize(DMX512_instance_t* instance,
+                       UTIMER_instance_t* utimer,
+                       DMX512_transaction_buffers_t* transaction_buffers,
+                       DMX512_receive_complete_callback_t receive_complete_callback,
+                       DMX512_transmit_complete_callback_t transmit_complete_callback,
+                       DMX512_pre_task_callback_t pre_task_callback,
+                       DMX512_post_task_callback_t post_task_callback,
+                       DMX512_hal_set_dmx_direction_t set_dmx_direction,
+                       DMX512_hal_generate_tx_break_t generate_tx_break,
+                       DMX512_hal_is_rx_ready_t is_rx_ready,
+                       DMX512_hal_is_tx_ready_t is_tx_ready,
+                       DMX512_hal_is_tx_empty_t is_tx_empty,
+                       DMX512_hal_read_rx_register_t read_rx_register,
+                       DMX512_hal_write_tx_register_t write_tx_register,
+                       DMX512_hal_error_check_rx_overflow_t error_check_rx_overflow,
+                       DMX512_hal_error_check_rx_break_t error_check_rx_break,
+                       DMX512_hal_error_check_rx_frame_t error_check_rx_frame,
+                       DMX512_hal_clear_rx_error_flags_t clear_rx_error_flags,
+                       DMX512_hal_enable_rx_fault_interrupt_t enable_rx_fault_interrupt,
+                       DMX512_hal_clear_rx_fault_interrupt_t clear_rx_fault_interrupt);
 
 /*******************************************************************************
  *
- * GFX2D_font_t
+ * DMX512_initialize_dma
  *
  * DESCRIPTION:
- *  Collection of variables for text drawing.
- *
- * font
- *  Points to the font module to use.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values. DMA method.
  *
- * cursor_x
- *  The current x-start location of the next character to write.
+ * PARAMETERS:
+ *  See DMX512_instance_t.
  *
- * cursor_y
- *  The current y-start location of the next character to write.
+ ******************************************************************************/
+
+void DMX512_initialize_dma(DMX512_instance_t* instance,
+                           UTIMER_instance_t* utimer,
+                           DMX512_transaction_buffers_t* transaction_buffers,
+                           DMX512_receive_complete_callback_t receive_complete_callback,
+                           DMX512_transmit_complete_callback_t transmit_complete_callback,
+                           DMX512_pre_task_callback_t pre_task_callback,
+                           DMX512_post_task_callback_t post_task_callback,
+                           DMX512_hal_set_dmx_direction_t set_dmx_direction,
+                           DMX512_hal_generate_tx_break_t generate_tx_break,
+                           DMX512_hal_is_rx_ready_t is_rx_ready,
+                           DMX512_hal_read_rx_register_t read_rx_register,
+                           DMX512_hal_error_check_rx_overflow_t error_check_rx_overflow,
+                           DMX512_hal_error_check_rx_break_t error_check_rx_break,
+                           DMX512_hal_error_check_rx_frame_t error_check_rx_frame,
+                           DMX512_hal_clear_rx_error_flags_t clear_rx_error_flags,
+                           DMX512_hal_enable_rx_fault_interrupt_t enable_rx_fault_interrupt,
+                           DMX512_hal_clear_rx_fault_interrupt_t clear_rx_fault_interrupt,
+                           DMX512_hal_clear_dma_transfer_complete_interrupt_t clear_dma_transfer_complete_interrupt,
+                           DMX512_hal_configure_dma_receive_t configure_dma_receive,
+                           DMX512_hal_configure_dma_transmit_t configure_dma_transmit,
+                           DMX512_hal_disable_dma_t disable_dma);
+
+/*******************************************************************************
  *
- * color
- *  See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * DMX512_set_mode
  *
- * x_magnification
- *  Magnification of the text in the x-direction.
+ * DESCRIPTION:
+ *  Changes the DMX mode to receive or transmit. Any active task(s) will be
+ *  aborted.
  *
- * y_magnification
- *  Magnification of the text in the y-direction.
+ * PARAMETER:
+ *  mode
+ *   Receive or transmit mode.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  GFX2DFONT_font_t* font;
-  int16_t cursor_x;
-  int16_t cursor_y;
-  uint32_t color;
-  uint8_t x_magnification;
-  uint8_t y_magnification;
-}
-GFX2D_font_t;
+void DMX512_set_mode(DMX512_instance_t* instance, DMX512_mode_t mode);
 
 /*******************************************************************************
  *
- * GFX2D_flags_t
+ * DMX512_begin_new_dmx_transmit
  *
  * DESCRIPTION:
- *  Module flags.
+ *  Attempts to begin a new DMX transmit task. The request will be accepted if
+ *  the instance is in transmit mode and not currently busy with a task.
  *
- * byte_aligned
- *  Indicates whether bits_per_pixel is evenly divisible by 8, that is, it has
- *  byte alignment. This flag is set or cleared during initialization.
+ * PARAMETERS:
+ *  start_code
+ *   The first byte of the data portion of the transaction.
  *
- * invert
- *  Inverts the pixel location output to support a 180-degree screen rotation.
+ *  data
+ *   The bytes following the start code (e.g. DMX values).
  *
- * wrap_text
- *  Will cause text to wrap around to the next line automatically if the end
- *  of the screen is reached.
+ *  data_length
+ *   The length, in bytes, of the data array (DMX values only, not the
+ *   start byte).
+ *
+ * RETURN:
+ *  True if the task request was accepted, else, false.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t byte_aligned                  : 1;
-    uint8_t invert                        : 1;
-    uint8_t wrap_text                     : 1;
-    uint8_t reserved3                     : 5;
-  };
-}
-GFX2D_flags_t;
+bool DMX512_begin_new_dmx_transmit(DMX512_instance_t* instance,
+                                   uint8_t start_code,
+                                   uint8_t* data,
+                                   uint16_t data_length);
 
 /*******************************************************************************
  *
- * GFX2D_rgba_to_pixel_t
+ * DMX512_service
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called to convert
- *  a GFX2D_rgba_t into the desired pixel format. If the number of bits per
- *  pixel is less than 32, then the output pixels should only occupy the least
- *  significant bits.
+ *  Services the task state machine. Must be called repeatedly until the task
+ *  is completed.
  *
- *  The user should also include any byte-swapping as required to support big
- *  versus little endian formatting.
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true.
  *
- * PARAMETERS:
- *  rgba
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ ******************************************************************************/
+
+bool DMX512_service(DMX512_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * DMX512_is_busy
+ *
+ * DESCRIPTION:
+ *  Determines if an instance is currently busy with a task.
  *
  * RETURN:
- *  Formatted pixel color.
+ *  True if the instance is busy with a task, else, false.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ ******************************************************************************/
+
+bool DMX512_is_busy(DMX512_instance_t* instance);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // DMX512_J_H
+
+/*******************************************************************************
+ *
+ *  EEPROM with generic HAL interface. Requires proper initialization and the
+ *  service routine to be called repeatedly after a new task request until the
+ *  task is completed.
+ *
+ *  While EEPROMs are built by several manufactures, most follow the same
+ *  interface of a 2-4 byte address followed by a read or write operation. The
+ *  maximum number of bytes that can be written per a single transaction is the
+ *  size of the EEPROM page. Once written, the EEPROM needs time to commit the
+ *  received data to NVM. A read operation does not have this same limitation
+ *  and can span accross pages.
  *
  ******************************************************************************/
 
-typedef uint32_t (*GFX2D_rgba_to_pixel_t)(uint32_t);
+#ifndef EEPROM_J_H
+#define EEPROM_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /*******************************************************************************
  *
- * GFX2D_canvas_fill_handler_t
+ * EEPROM_flags_t
  *
  * DESCRIPTION:
- *  Function template for internal helper functions for GFX2D_fill_canvas. The
- *  canvas fill function is used to clear the screen and set a background color.
- *  Hence, having a direct call to an optimized handler can significantly improve
- *  performance.
+ *  Module flags.
+ *
+ * busy
+ *  Set when the module is busy with a task and cleared when the task is
+ *  completed.
+ *
+ * erase_task
+ *  Set if the current task is an erase task. Allows the erase task to utilize
+ *  the write service handler with minor differences.
+ *
+ * task_state
+ *  State machine state.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t busy                          : 1;
+    uint8_t erase_task                    : 1;
+    uint8_t reserved2                     : 2;
+    uint8_t task_state                    : 3;
+    uint8_t reserved7                     : 1;
+  };
+}
+EEPROM_flags_t;
+
+/*******************************************************************************
+ *
+ * EEPROM_pre_task_callback_t
+ *
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called when a new
+ *  task is accepted and initialized but before the task actually begins. This
+ *  allows the user to perform any last additional configurations before the
+ *  actual logic of the task begins.
  *
  * PARAMETERS:
- *  instance
- *   Pointer to GFX2D_instance_t.
+ *  context
+ *   User-provided context.
  *
- *  color
- *   Formatted pixel color.
+ * NOTES:
+ *  Can be initialized as NULL - YES
+ *
+ ******************************************************************************/
+
+typedef void (*EEPROM_pre_task_callback_t)(uint32_t);
+
+/*******************************************************************************
+ *
+ * EEPROM_post_task_callback_t
+ *
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called after a
+ *  task completes.
+ *
+ * PARAMETERS:
+ *  context
+ *   User-provided context.
  *
  * NOTES:
- *  For internal use only.
+ *  Can be initialized as NULL - YES
  *
  ******************************************************************************/
 
-typedef void (*GFX2D_canvas_fill_handler_t)(void*, uint32_t);
+typedef void (*EEPROM_post_task_callback_t)(uint32_t);
 
 /*******************************************************************************
  *
- * GFX2D_draw_hline_handler_t
+ * EEPROM_hal_driver_read_t
  *
  * DESCRIPTION:
- *  Function template for internal helper functions for GFX2D_draw_hline. The
- *  hline function is used for the various filled objects, such as triangle,
- *  rectangle, and circle. Hence, having a direct call to an optimized handler
- *  can significantly improve performance.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will read the EEPROM.
  *
  * PARAMETERS:
- *  instance
- *   Pointer to GFX2D_instance_t.
+ *  address
+ *   Starting memory address.
  *
- *  x
- *   X-Coords starting point of line.
+ *  address_reg_length
+ *   The length, in bytes, of the memory address or register.
  *
- *  y
- *   Y-Coords starting point of line.
+ *  buffer
+ *   Buffer which will hold the read data.
  *
  *  length
- *   Length of the line in pixels.
+ *   The length, in bytes, of data to read.
  *
- *  color
- *   Formatted pixel color.
+ * RETURN:
+ *  True if the task request was accepted, else, false.
  *
  * NOTES:
- *  For internal use only.
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef void (*GFX2D_draw_hline_handler_t)(void*,
-                                           int16_t,
-                                           int16_t,
-                                           int16_t,
-                                           uint32_t);
+typedef bool (*EEPROM_hal_driver_read_t)(uint32_t, uint8_t, uint8_t*, uint32_t);
 
 /*******************************************************************************
  *
- * GFX2D_draw_vline_handler_t
+ * EEPROM_hal_driver_write_t
  *
  * DESCRIPTION:
- *  Function template for internal helper functions for GFX2D_draw_vline.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will write the EEPROM.
  *
  * PARAMETERS:
- *  instance
- *   Pointer to GFX2D_instance_t.
+ *  address
+ *   Starting memory address.
  *
- *  x
- *   X-Coords starting point of line.
+ *  address_reg_length
+ *   The length, in bytes, of the memory address or register.
  *
- *  y
- *   Y-Coords starting point of line.
+ *  buffer
+ *   Buffer which holds the data to be written.
  *
  *  length
- *   Length of the line in pixels.
+ *   The length, in bytes, of data to write.
  *
- *  color
- *   Formatted pixel color.
+ * RETURN:
+ *  True if the task request was accepted, else, false.
  *
  * NOTES:
- *  For internal use only.
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef void (*GFX2D_draw_vline_handler_t)(void*,
-                                           int16_t,
-                                           int16_t,
-                                           int16_t,
-                                           uint32_t);
+typedef bool (*EEPROM_hal_driver_write_t)(uint32_t, uint8_t, uint8_t*, uint32_t);
 
 /*******************************************************************************
  *
- * GFX2D_draw_filled_rectangle_handler_t
+ * EEPROM_hal_driver_service_t
  *
  * DESCRIPTION:
- *  Function template for internal helper functions for GFX2D_draw_filled_-
- *  rectangle. The filled rectangle function is used for drawing panels and
- *  other large areas. Hence, having a direct call to an optimized handler can
- *  significantly improve performance.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will service the driver.
  *
- * PARAMETERS:
- *  instance
- *   Pointer to GFX2D_instance_t.
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true.
  *
- *  x
- *   X-Coords starting point of line.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
- *  y
- *   Y-Coords starting point of line.
+ ******************************************************************************/
+
+typedef bool (*EEPROM_hal_driver_service_t)(void);
+
+/*******************************************************************************
  *
- *  width
- *   Width of the rectangle in pixels.
+ * EEPROM_hal_driver_timeout_t
  *
- *  height
- *   Height of the rectangle in pixels.
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will determine if the driver has had a task timeout.
  *
- *  color
- *   Formatted pixel color.
+ * RETURN:
+ *  True if a timeout has occurred, else, false.
  *
  * NOTES:
- *  For internal use only.
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef void (*GFX2D_draw_filled_rectangle_handler_t)(void*,
-                                                      int16_t,
-                                                      int16_t,
-                                                      int16_t,
-                                                      int16_t,
-                                                      uint32_t);
+typedef bool (*EEPROM_hal_driver_timeout_t)(void);
 
 /*******************************************************************************
  *
- * GFX2D_instance_t
+ * EEPROM_instance_t
  *
  * DESCRIPTION:
  *  Instance data and function pointers.
  *
- * NOTE:
- *  The drawing canvas is a segmented portion of the target display frame. If
- *  resources allow, the canvas dimensions should be the same as the target for
- *  maximum efficiency. Otherwise, the canvas represents a portion of the target
- *  display frame defined by a x,y offset and width and height.
- *
  * flags
  *  Module flags.
  *
- * bits_per_pixel
- *  The number of bits which make up a single pixel, ranging from 1 to 32.
+ * utimer
+ *  User-provided initialized instance of a UTIMER.
  *
- * bytes_per_pixel
- *  The number of bytes which make up a single pixel. This value is only used
- *  for byte-aligned formats.
+ * utimer_ticket
+ *  Data structure used with the UTIMER instance.
  *
- * display_buffer
- *  Pointer to user-provided buffer which will hold the rendered graphics.
- *
- * display_buffer_length_bytes
- *  Total length, in bytes, of the display buffer.
- *
- * display_buffer_length_pixels
- *  Total length, in pixels, of the display buffer.
- *
- * display_target_width
- *  The width, in pixels, of the target display.
- *
- * display_target_height
- *  The height, in pixels, of the target display.
- *
- * canvas_x0
- *  The starting x-offset relative to the target display frame which is mapped
- *  to the canvas x-origin.
+ * bus_mutex
+ *  User-provided initialized instance of a BUSMUTEX.
  *
- * canvas_y0
- *  The starting y-offset relative to the target display frame which is mapped
- *  to the canvas y-origin.
+ * bus_id
+ *  The BUS ID associated with the BUSMUTEX instance.
  *
- * canvas_width
- *  Width, in pixels, of the drawing canvas.
+ * address_reg_length
+ *  The length, in bytes, of the EEPROM address/register.
  *
- * canvas_height
- *  Height, in pixels, of the drawing canvas.
+ * page_length
+ *  The length, in bytes, of a single EEPROM page.
  *
- * canvas_bits_per_row
- *  The number of bits which compose a single drawing canvas row.
+ * total_length
+ *  The length, in bytes, of the entrie EEPROM.
  *
- * canvas_bytes_per_row
- *  The number of bytes which compose a single drawing canvas row. This value
- *  is only used for byte-aligned formats.
+ * buffer
+ *  Pointer to the user buffer which contains the data to written or will
+ *  contain the read data.
  *
- * canvas_length_bytes
- *  Total length, in bytes, of the drawing canvas.
+ * rw_count
+ *  The number of bytes to write to, or read from, the data buffer.
  *
- * canvas_length_pixels
- *  Total length, in pixels, of the drawing canvas.
+ * rw_counter
+ *  Keeps track of the number of bytes that have been written to, or read from,
+ *  the data buffer.
  *
- * font
- *  Collection of text related variables.
+ * rw_address
+ *  The starting address of the RW task.
  *
- * rgba_to_pixel
- *  See GFX2D_rgba_to_pixel_t.
+ * page_commit_timeout_us
+ *  The time, in microseconds, which must be waited between page writes to give
+ *  the EEPROM time to commit its volatile page buffer to NVM.
  *
- * canvas_fill_handler
- *  See GFX2D_canvas_fill_handler_t.
+ * callback_context
+ *  Context passed into the user pre/post operation callbacks.
  *
- * draw_hline_handler
- *  See GFX2D_draw_hline_handler_t.
+ * service_handler
+ *  Function pointer to the service routine applicable to the initialized
+ *  service mode.
  *
- * draw_vline_handler
- *  See GFX2D_draw_vline_handler_t.
+ * *_task_*
+ *  User-provided functions. See typedef comments.
  *
- * draw_filled_rectangle_handler
- *  See GFX2D_draw_filled_rectangle_handler_t.
+ * *_hal_*
+ *  User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  GFX2D_flags_t flags;
-  uint8_t bits_per_pixel;
-  uint8_t bytes_per_pixel;
-  uint8_t* display_buffer;
-  uint32_t display_buffer_length_bytes;
-  uint32_t display_buffer_length_pixels;
-  int16_t display_target_width;
-  int16_t display_target_height;
-  int16_t canvas_x0;
-  int16_t canvas_y0;
-  int16_t canvas_width;
-  int16_t canvas_height;
-  uint32_t canvas_bits_per_row;
-  uint32_t canvas_bytes_per_row;
-  uint32_t canvas_length_bytes;
-  uint32_t canvas_length_pixels;
-  GFX2D_font_t font;
-  GFX2D_rgba_to_pixel_t rgba_to_pixel;
-  GFX2D_canvas_fill_handler_t canvas_fill_handler;
-  GFX2D_draw_hline_handler_t draw_hline_handler;
-  GFX2D_draw_vline_handler_t draw_vline_handler;
-  GFX2D_draw_filled_rectangle_handler_t draw_filled_rectangle_handler;
+  EEPROM_flags_t flags;
+  UTIMER_instance_t* utimer;
+  UTIMER_ticket_t utimer_ticket;
+  BUSMUTEX_instance_t* bus_mutex;
+  BUSMUTEX_bus_id_t bus_id;
+  uint8_t address_reg_length;
+  uint16_t page_length;
+  uint32_t total_length;
+  uint8_t* buffer;
+  uint32_t rw_count;
+  uint32_t rw_counter;
+  uint32_t rw_address;
+  uint32_t page_commit_timeout_us;
+  uint32_t callback_context;
+  bool (*service_handler)(void* instance);
+  EEPROM_pre_task_callback_t pre_task_callback;
+  EEPROM_post_task_callback_t post_task_callback;
+  EEPROM_hal_driver_read_t driver_read;
+  EEPROM_hal_driver_write_t driver_write;
+  EEPROM_hal_driver_service_t driver_service;
+  EEPROM_hal_driver_timeout_t driver_timeout;
 }
-GFX2D_instance_t;
+EEPROM_instance_t;
 
 /*******************************************************************************
  *
- * GFX2D_initialize
+ * EEPROM_initialize
  *
  * DESCRIPTION:
  *  Initializes a module instance, erasing all data structures and setting
- *  default values. The drawing canvas is defaulted to a single pixel. The user
- *  should call GFX2D_set_canvas_dimensions after initialization to set the draw
- *  dimensions.
+ *  default values.
  *
  * PARAMETERS:
- *  See GFX2D_instance_t.
+ *  See EEPROM_instance_t.
  *
  ******************************************************************************/
 
-void GFX2D_initialize(GFX2D_instance_t* instance,
-                      uint8_t* display_buffer,
-                      uint32_t display_buffer_length_bytes,
-                      int16_t display_target_width,
-                      int16_t display_target_height,
-                      uint8_t bits_per_pixel,
-                      GFX2D_rgba_to_pixel_t rgba_to_pixel);
+void EEPROM_initialize(EEPROM_instance_t* instance,
+                       UTIMER_instance_t* utimer,
+                       BUSMUTEX_instance_t* bus_mutex,
+                       BUSMUTEX_bus_id_t bus_id,
+                       uint8_t address_reg_length,
+                       uint16_t page_length,
+                       uint32_t total_length,
+                       uint32_t page_commit_timeout_us,
+                       EEPROM_pre_task_callback_t pre_task_callback,
+                       EEPROM_post_task_callback_t post_task_callback,
+                       EEPROM_hal_driver_read_t driver_read,
+                       EEPROM_hal_driver_write_t driver_write,
+                       EEPROM_hal_driver_service_t driver_service,
+                       EEPROM_hal_driver_timeout_t driver_timeout);
 
 /*******************************************************************************
  *
- * GFX2D_set_canvas_dimensions
+ * EEPROM_purge
  *
  * DESCRIPTION:
- *  Sets the drawing canvas origin and pixel width and height. If the user
- *  display buffer is large enough to accomodate an entire virtual display frame
- *  for the target display, it is ideal to only call this function once with an
- *  origin of 0,0 and a width and height equal to the target display.
- *
- * PARAMETERS:
- *  See GFX2D_instance_t.
+ *  Attempts to begin a new EEPROM erase task with the address range of the
+ *  entire EEPROM.
  *
  * RETURN:
- *  True if the canvas dimensions were set, else, false if the dimensions
- *  require more space than available in the display buffer. In this case, the
- *  width and height are set to 1.
- *
- * NOTE:
- *  Dimensions which overflow the target display width and height will be
- *  trimmed. The function will still return true.
+ *  True if the task request was accepted, else, false.
  *
  ******************************************************************************/
 
-bool GFX2D_set_canvas_dimensions(GFX2D_instance_t* instance,
-                                 int16_t canvas_x0,
-                                 int16_t canvas_y0,
-                                 int16_t canvas_width,
-                                 int16_t canvas_height);
+bool EEPROM_purge(EEPROM_instance_t* instance);
 
 /*******************************************************************************
  *
- * GFX2D_draw_pixel
+ * EEPROM_erase
  *
  * DESCRIPTION:
- *  Draws a single pixel.
+ *  Attempts to begin a new EEPROM erase task.
  *
  * PARAMETERS:
- *  x
- *   X-Coords of pixel.
- *
- *  y
- *   Y-Coords of pixel.
+ *  start_address
+ *   The starting memory address.
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *  length
+ *   The length, in bytes, to erase.
  *
  * RETURN:
- *  True if the pixel was drawn, else, false.
+ *  True if the task request was accepted, else, false.
  *
  ******************************************************************************/
 
-bool GFX2D_draw_pixel(GFX2D_instance_t* instance,
-                      int16_t x,
-                      int16_t y,
-                      uint32_t color);
+bool EEPROM_erase(EEPROM_instance_t* instance,
+                  uint32_t start_address,
+                  uint32_t length);
 
 /*******************************************************************************
  *
- * GFX2D_fill_canvas
+ * EEPROM_begin_new_write
  *
  * DESCRIPTION:
- *  Fills the canvas buffer with a specified color.
+ *  Attempts to begin a new EEPROM write task.
  *
  * PARAMETERS:
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *  start_address
+ *   The starting EEPROM memory address where the data will be written.
+ *
+ *  buffer
+ *   User buffer which contains the data to be written to the EEPROM.
+ *
+ *  length
+ *   The length, in bytes, of the buffer (number of bytes to write).
+ *
+ * RETURN:
+ *  True if the task request was accepted, else, false.
  *
  ******************************************************************************/
 
-void GFX2D_fill_canvas(GFX2D_instance_t* instance, uint32_t color);
+bool EEPROM_begin_new_write(EEPROM_instance_t* instance,
+                            uint32_t start_address,
+                            uint8_t* buffer,
+                            uint32_t length);
 
 /*******************************************************************************
  *
- * GFX2D_draw_hline
+ * EEPROM_begin_new_read
  *
  * DESCRIPTION:
- *  Draws a horizontal line.
+ *  Attempts to begin a new EEPROM read task.
  *
  * PARAMETERS:
- *  x
- *   X-Coords starting point of line.
+ *  start_address
+ *   The starting EEPROM memory address where the data will be read.
  *
- *  y
- *   Y-Coords starting point of line.
+ *  buffer
+ *   User buffer which will hold the data read from the EEPROM.
  *
  *  length
- *   Length of the line in pixels.
+ *   The length, in bytes, of the buffer (number of bytes to read).
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * RETURN:
+ *  True if the task request was accepted, else, false.
  *
  ******************************************************************************/
 
-void GFX2D_draw_hline(GFX2D_instance_t* instance,
-                      int16_t x,
-                      int16_t y,
-                      int16_t length,
-                      uint32_t color);
+bool EEPROM_begin_new_read(EEPROM_instance_t* instance,
+                           uint32_t start_address,
+                           uint8_t* buffer,
+                           uint32_t length);
 
 /*******************************************************************************
  *
- * GFX2D_draw_vline
+ * EEPROM_service
  *
  * DESCRIPTION:
- *  Draws a vertical line.
+ *  Services the task state machine. Must be called repeatedly until the task
+ *  is completed.
  *
- * PARAMETERS:
- *  x
- *   X-Coords starting point of line.
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true.
  *
- *  y
- *   Y-Coords starting point of line.
+ ******************************************************************************/
+
+bool EEPROM_service(EEPROM_instance_t* instance);
+
+/*******************************************************************************
  *
- *  length
- *   Length of the line in pixels.
+ * EEPROM_is_busy
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * DESCRIPTION:
+ *  Determines if an instance is currently busy with a task.
+ *
+ * RETURN:
+ *  True if the instance is busy with a task, else, false.
  *
  ******************************************************************************/
 
-void GFX2D_draw_vline(GFX2D_instance_t* instance,
-                      int16_t x,
-                      int16_t y,
-                      int16_t length,
-                      uint32_t color);
+bool EEPROM_is_busy(EEPROM_instance_t* instance);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EEPROM_J_H
 
 /*******************************************************************************
  *
- * GFX2D_draw_line
- *
- * DESCRIPTION:
- *  Draws a line.
+ *  Service efficiency counters for the polled module state machines. A
+ *  service routine called through SERVICESTATS_SERVICE, or run by an EXECUTOR
+ *  task with stats attached, is counted and timed, and its calls are sorted
+ *  into calls which advanced the state machine, calls which found it waiting
+ *  and idle calls.
  *
- * PARAMETERS:
- *  x0
- *   X-Coords starting point of line.
+ *  Progress is detected with an optional probe, which returns a value that
+ *  changes whenever the state machine advances, e.g. the element counters and
+ *  the task state of a SERSPI instance. Probes are provided for SERSPI,
+ *  SERUART and SERI2C. Without a probe, only the call completing a task counts
+ *  as progress.
  *
- *  y0
- *   Y-Coords starting point of line.
+ *  A driver with many waiting calls and short calls is a candidate for a
+ *  larger max_elements_per_iteration or a longer EXECUTOR busy period; one
+ *  with a long maximum call time is a candidate for a smaller one.
  *
- *  x1
- *   X-Coords ending point of line.
+ *  Typical use:
  *
- *  y1
- *   Y-Coords ending point of line.
+ *   SERVICESTATS_initialize(&spi_stats, spi_states, 4, read_cyccnt,
+ *                           SERVICESTATS_serspi_progress, SERVICESTATS_serspi_state);
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *   while (true)
+ *   {
+ *     SERVICESTATS_SERVICE(&spi_stats, SERSPI_service, &spi);
+ *   }
  *
  ******************************************************************************/
 
-void GFX2D_draw_line(GFX2D_instance_t* instance,
-                     int16_t x0,
-                     int16_t y0,
-                     int16_t x1,
-                     int16_t y1,
-                     uint32_t color);
+#ifndef SERVICESTATS_J_H
+#define SERVICESTATS_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Calls a service routine and records it. Evaluates to the value returned by
+ * the service routine.
+ */
+
+#define SERVICESTATS_SERVICE(stats, service, instance)                         \
+  (SERVICESTATS_begin((stats), (instance)),                                    \
+   SERVICESTATS_end((stats), (instance), service(instance)))
 
 /*******************************************************************************
  *
- * GFX2D_draw_triangle
+ * SERVICESTATS_service_t
  *
  * DESCRIPTION:
- *  Draws a triangle.
- *
- * PARAMETERS:
- *  x0
- *   X-Coords of first triangle point.
- *
- *  y0
- *   Y-Coords of first triangle point..
+ *  Function template for a service routine, see EXECUTOR_service_t.
  *
- *  x1
- *   X-Coords of second triangle point.
+ ******************************************************************************/
+
+typedef bool (*SERVICESTATS_service_t)(void* instance);
+
+/*******************************************************************************
  *
- *  y1
- *   Y-Coords of second triangle point.
+ * SERVICESTATS_probe_t
  *
- *  x2
- *   X-Coords of third triangle point.
+ * DESCRIPTION:
+ *  Function template for a probe which reads the progress or the state of a
+ *  module instance.
  *
- *  y2
- *   Y-Coords of third triangle point.
+ * PARAMETERS:
+ *  instance
+ *   The module instance passed to the service routine.
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * RETURN:
+ *  For a progress probe, a value which changes when the state machine
+ *  advances. For a state probe, the index of the current state.
  *
  ******************************************************************************/
 
-void GFX2D_draw_triangle(GFX2D_instance_t* instance,
-                         int16_t x0,
-                         int16_t y0,
-                         int16_t x1,
-                         int16_t y1,
-                         int16_t x2,
-                         int16_t y2,
-                         uint32_t color);
+typedef uint32_t (*SERVICESTATS_probe_t)(void* instance);
 
 /*******************************************************************************
  *
- * GFX2D_draw_filled_triangle
+ * SERVICESTATS_hal_get_timestamp_t
  *
  * DESCRIPTION:
- *  Draws a filled triangle.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will return the value of a free running 32 bit counter, e.g. the DWT
+ *  cycle counter.
  *
- * PARAMETERS:
- *  x0
- *   X-Coords of first triangle point.
+ * NOTES:
+ *  Can be initialized as NULL - YES, in which case only calls are counted.
  *
- *  y0
- *   Y-Coords of first triangle point.
+ *  A wait longer than the counter period is not measured correctly.
  *
- *  x1
- *   X-Coords of second triangle point.
+ ******************************************************************************/
+
+typedef uint32_t (*SERVICESTATS_hal_get_timestamp_t)(void);
+
+/*******************************************************************************
  *
- *  y1
- *   Y-Coords of second triangle point.
+ * SERVICESTATS_state_t
  *
- *  x2
- *   X-Coords of third triangle point.
+ * DESCRIPTION:
+ *  Counters of a state of the state machine.
  *
- *  y2
- *   Y-Coords of third triangle point.
+ * waiting_calls
+ *  Number of calls which found the state machine waiting in the state.
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * waiting_ticks
+ *  Time spent in these calls, in timestamp counter ticks.
+ *
+ * blocked_ticks
+ *  Time from the first of these calls until the state machine advanced, in
+ *  timestamp counter ticks, including the time spent outside of the service
+ *  routine.
  *
  ******************************************************************************/
 
-void GFX2D_draw_filled_triangle(GFX2D_instance_t* instance,
-                                int16_t x0,
-                                int16_t y0,
-                                int16_t x1,
-                                int16_t y1,
-                                int16_t x2,
-                                int16_t y2,
-                                uint32_t color);
+typedef struct
+{
+  uint32_t waiting_calls;
+  uint64_t waiting_ticks;
+  uint64_t blocked_ticks;
+}
+SERVICESTATS_state_t;
 
 /*******************************************************************************
  *
- * GFX2D_draw_circle_arc
+ * SERVICESTATS_instance_t
  *
  * DESCRIPTION:
- *  Mainly used as a helper function, but can be called independently. Draws
- *  the quadrant arcs of a circle depending on the input bit quadrant flag.
+ *  Counters of a module instance, and the data used to record them.
  *
- * PARAMETERS:
- *  x0
- *   X-Coords of center point of circle.
+ * calls
+ *  Number of service routine calls.
  *
- *  y0
- *   Y-Coords of center point of circle.
+ * progress_calls
+ *  Number of calls which advanced the state machine, or completed its task.
  *
- *  radius
- *   Radius of the circle.
+ * waiting_calls
+ *  Number of calls which returned false without advancing the state machine.
  *
- *  quadrant
- *   Bit flag(s) indicating which arc(s), or quadrant(s) of a circle, to draw.
+ * idle_calls
+ *  Number of calls without a task.
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * service_ticks
+ *  Time spent in the service routine, in timestamp counter ticks.
+ *
+ * service_ticks_max
+ *  Longest call, in timestamp counter ticks.
+ *
+ * states
+ *  User-provided array of per state counters, or NULL.
+ *
+ * state_count
+ *  Number of elements in states. States from state_count are counted in the
+ *  last element.
+ *
+ * *_probe
+ *  User-provided probes, or NULL. See SERVICESTATS_probe_t.
+ *
+ * get_timestamp
+ *  User-provided function. See SERVICESTATS_hal_get_timestamp_t.
+ *
+ * The other members are managed by the module.
  *
  ******************************************************************************/
 
-void GFX2D_draw_circle_arc(GFX2D_instance_t* instance,
-                           int16_t x0,
-                           int16_t y0,
-                           int16_t radius,
-                           GFX2D_circle_quadrant_t quadrant,
-                           uint32_t color);
+typedef struct
+{
+  uint32_t calls;
+  uint32_t progress_calls;
+  uint32_t waiting_calls;
+  uint32_t idle_calls;
+  uint64_t service_ticks;
+  uint32_t service_ticks_max;
+  SERVICESTATS_state_t* states;
+  uint8_t state_count;
+  bool idle;
+  bool blocked;
+  uint8_t blocked_state;
+  uint32_t blocked_timestamp;
+  uint32_t call_timestamp;
+  uint32_t call_progress;
+  SERVICESTATS_probe_t progress_probe;
+  SERVICESTATS_probe_t state_probe;
+  SERVICESTATS_hal_get_timestamp_t get_timestamp;
+}
+SERVICESTATS_instance_t;
 
 /*******************************************************************************
  *
- * GFX2D_draw_filled_circle_arc
+ * SERVICESTATS_initialize
  *
  * DESCRIPTION:
- *  Mainly used as a helper function, but can be called independently. Draws
- *  the quadrant arcs of a circle depending on the input bit quadrant flag.
+ *  Initializes the instance and clears the counters.
  *
  * PARAMETERS:
- *  x0
- *   X-Coords of center point of circle.
+ *  states
+ *   Array of per state counters, or NULL.
  *
- *  y0
- *   Y-Coords of center point of circle.
+ *  state_count
+ *   Number of elements in states.
  *
- *  radius
- *   Radius of the circle.
+ ******************************************************************************/
+
+void SERVICESTATS_initialize(SERVICESTATS_instance_t* stats,
+                             SERVICESTATS_state_t* states,
+                             uint8_t state_count,
+                             SERVICESTATS_hal_get_timestamp_t get_timestamp,
+                             SERVICESTATS_probe_t progress_probe,
+                             SERVICESTATS_probe_t state_probe);
+
+/*******************************************************************************
  *
- *  quadrant
- *   Bit flag(s) indicating which arc(s), or quadrant(s) of a circle, to draw.
+ * SERVICESTATS_clear
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * DESCRIPTION:
+ *  Clears the counters.
  *
  ******************************************************************************/
 
-void GFX2D_draw_filled_circle_arc(GFX2D_instance_t* instance,
-                                  int16_t x0,
-                                  int16_t y0,
-                                  int16_t radius,
-                                  GFX2D_circle_quadrant_t quadrant,
-                                  uint32_t color);
+void SERVICESTATS_clear(SERVICESTATS_instance_t* stats);
 
 /*******************************************************************************
  *
- * GFX2D_draw_circle
+ * SERVICESTATS_begin
  *
  * DESCRIPTION:
- *  Draws a circle.
+ *  Records the start of a service routine call. Normally used through
+ *  SERVICESTATS_SERVICE.
  *
- * PARAMETERS:
- *  x0
- *   X-Coords of center point.
+ ******************************************************************************/
+
+void SERVICESTATS_begin(SERVICESTATS_instance_t* stats, void* instance);
+
+/*******************************************************************************
  *
- *  y0
- *   Y-Coords of center point.
+ * SERVICESTATS_end
  *
- *  radius
- *   Radius of the circle.
+ * DESCRIPTION:
+ *  Records the end of a service routine call. Normally used through
+ *  SERVICESTATS_SERVICE.
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * PARAMETERS:
+ *  idle
+ *   The value returned by the service routine.
+ *
+ * RETURN:
+ *  idle
  *
  ******************************************************************************/
 
-void GFX2D_draw_circle(GFX2D_instance_t* instance,
-                       int16_t x0,
-                       int16_t y0,
-                       int16_t radius,
-                       uint32_t color);
+bool SERVICESTATS_end(SERVICESTATS_instance_t* stats, void* instance, bool idle);
 
 /*******************************************************************************
  *
- * GFX2D_draw_filled_circle
+ * SERVICESTATS_service
  *
  * DESCRIPTION:
- *  Draws a filled circle.
+ *  Calls a service routine through a function pointer and records it.
  *
- * PARAMETERS:
- *  x0
- *   X-Coords of center point.
+ * RETURN:
+ *  The value returned by the service routine.
  *
- *  y0
- *   Y-Coords of center point.
+ ******************************************************************************/
+
+bool SERVICESTATS_service(SERVICESTATS_instance_t* stats, SERVICESTATS_service_t service, void* instance);
+
+/*******************************************************************************
  *
- *  radius
- *   Radius of the circle.
+ * SERVICESTATS_ser*_progress, SERVICESTATS_ser*_state
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * DESCRIPTION:
+ *  Probes for SERSPI, SERUART and SERI2C instances. The state probes return
+ *  the task state of the instance, 4 states for SERSPI and 32 for SERI2C.
  *
  ******************************************************************************/
 
-void GFX2D_draw_filled_circle(GFX2D_instance_t* instance,
-                              int16_t x0,
-                              int16_t y0,
-                              int16_t radius,
-                              uint32_t color);
+uint32_t SERVICESTATS_serspi_progress(void* instance);
+uint32_t SERVICESTATS_serspi_state(void* instance);
+uint32_t SERVICESTATS_seruart_progress(void* instance);
+uint32_t SERVICESTATS_seri2c_progress(void* instance);
+uint32_t SERVICESTATS_seri2c_state(void* instance);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SERVICESTATS_J_H
 
 /*******************************************************************************
  *
- * GFX2D_draw_rectangle
- *
- * DESCRIPTION:
- *  Draws a rectangle.
+ *  Cooperative task executor. Runs the service routines of registered modules
+ *  only when they need a pass, instead of calling every service routine on
+ *  each main loop iteration, and lets the core sleep when nothing is ready.
  *
- * PARAMETERS:
- *  x
- *   X-Coords starting point of rectangle.
+ *  A task needs a pass when it has been notified, e.g. after a new task
+ *  request was given to its module or from an ISR, or when its deadline has
+ *  expired. Service routines follow the library convention of returning false
+ *  while a task is ongoing and true when idle. A busy module is run again
+ *  after its busy period, on the next pass if 0, and an idle module after its
+ *  idle period, or only when notified if 0.
  *
- *  y
- *   Y-Coords starting point of rectangle.
+ *  Typical main loop:
  *
- *  width
- *   Width of the rectangle in pixels.
+ *   while (true)
+ *   {
+ *     if (EXECUTOR_service(&executor))
+ *     {
+ *       EXECUTOR_sleep(&executor);
+ *     }
+ *   }
  *
- *  height
- *   Height of the rectangle in pixels.
+ ******************************************************************************/
+
+#ifndef EXECUTOR_J_H
+#define EXECUTOR_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Sleep time passed to the sleep HAL when no deadline is armed.
+ */
+
+#define EXECUTOR_SLEEP_FOREVER            UINT64_MAX
+
+/*******************************************************************************
+ *
+ * EXECUTOR_service_t
+ *
+ * DESCRIPTION:
+ *  Function template for a service routine.
+ *
+ * PARAMETERS:
+ *  instance
+ *   The module instance given at registration.
+ *
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true.
+ *
+ ******************************************************************************/
+
+typedef bool (*EXECUTOR_service_t)(void* instance);
+
+/*******************************************************************************
+ *
+ * EXECUTOR_DEFINE_SERVICE
+ *
+ * DESCRIPTION:
+ *  Defines a function matching EXECUTOR_service_t which calls a module
+ *  service routine, e.g.
+ *
+ *   EXECUTOR_DEFINE_SERVICE(eeprom_service, EEPROM_service, EEPROM_instance_t)
+ *
+ *  Service routines which return void are always considered idle, see
+ *  EXECUTOR_DEFINE_VOID_SERVICE.
+ *
+ ******************************************************************************/
+
+#define EXECUTOR_DEFINE_SERVICE(name, service, type)                           \
+  static bool name(void* instance)                                             \
+  {                                                                            \
+    return service((type*)instance);                                           \
+  }
+
+#define EXECUTOR_DEFINE_VOID_SERVICE(name, service, type)                      \
+  static bool name(void* instance)                                             \
+  {                                                                            \
+    service((type*)instance);                                                  \
+    return true;                                                               \
+  }
+
+/*******************************************************************************
+ *
+ * EXECUTOR_hal_enter_critical_t
+ *
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will disable interrupts, e.g. by setting PRIMASK.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - YES, if tasks are not notified from ISRs.
+ *
+ ******************************************************************************/
+
+typedef void (*EXECUTOR_hal_enter_critical_t)(void);
+
+/*******************************************************************************
+ *
+ * EXECUTOR_hal_exit_critical_t
+ *
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will re-enable interrupts.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - YES, if tasks are not notified from ISRs.
+ *
+ ******************************************************************************/
+
+typedef void (*EXECUTOR_hal_exit_critical_t)(void);
+
+/*******************************************************************************
+ *
+ * EXECUTOR_hal_sleep_t
+ *
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will put the core to sleep until an interrupt occurs or the sleep
+ *  time has passed, e.g. by arming a wake-up timer and executing WFI.
+ *
+ * PARAMETERS:
+ *  sleep_us
+ *   Maximum time to sleep, EXECUTOR_SLEEP_FOREVER if no deadline is armed.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - YES, in which case EXECUTOR_sleep returns
+ *  immediately.
+ *
+ *  Called from within the critical section, so that a notification from an
+ *  ISR can not be missed between the check for ready tasks and the sleep. The
+ *  interrupt must still wake the core, as it does with WFI and PRIMASK set.
+ *
+ ******************************************************************************/
+
+typedef void (*EXECUTOR_hal_sleep_t)(uint64_t);
+
+/*******************************************************************************
+ *
+ * EXECUTOR_task_flags_t
+ *
+ * DESCRIPTION:
+ *  Task flags.
+ *
+ * ready
+ *  Set if the task is to be run on the next pass.
+ *
+ * deadline_armed
+ *  Set if the task is to be run once its deadline ticket expires.
+ *
+ * busy
+ *  Set if the last pass of the service routine returned false.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t ready                         : 1;
+    uint8_t deadline_armed                : 1;
+    uint8_t busy                          : 1;
+    uint8_t reserved3                     : 5;
+  };
+}
+EXECUTOR_task_flags_t;
+
+/*******************************************************************************
+ *
+ * EXECUTOR_task_t
+ *
+ * DESCRIPTION:
+ *  A registered service routine. Only to be allocated by the user, see
+ *  EXECUTOR_register.
+ *
+ * flags
+ *  Task flags.
+ *
+ * notified
+ *  Set by EXECUTOR_notify, which may be called from an ISR.
+ *
+ * service
+ *  Service routine.
+ *
+ * instance
+ *  Module instance passed to the service routine.
+ *
+ * busy_period_us
+ *  Time after which a busy task is run again, 0 for the next pass.
+ *
+ * idle_period_us
+ *  Time after which an idle task is run again, 0 if only when notified.
+ *
+ * deadline_us
+ *  Time of the deadline ticket.
+ *
+ * deadline_ticket
+ *  Deadline ticket.
+ *
+ * run_count
+ *  Number of times the service routine has been run.
+ *
+ * stats
+ *  Service efficiency counters, or NULL. See EXECUTOR_set_stats.
+ *
+ * next_task
+ *  Next registered task, managed by the module.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  EXECUTOR_task_flags_t flags;
+  volatile bool notified;
+  EXECUTOR_service_t service;
+  void* instance;
+  uint32_t busy_period_us;
+  uint32_t idle_period_us;
+  uint64_t deadline_us;
+  UTIMER_ticket_t deadline_ticket;
+  uint32_t run_count;
+  SERVICESTATS_instance_t* stats;
+  void* next_task;
+}
+EXECUTOR_task_t;
+
+/*******************************************************************************
+ *
+ * EXECUTOR_instance_t
+ *
+ * DESCRIPTION:
+ *  Instance data and function pointers.
+ *
+ * notified
+ *  Set by EXECUTOR_notify when any task has been notified.
+ *
+ * utimer
+ *  Timer used for deadlines.
+ *
+ * tasks
+ *  First registered task.
+ *
+ * pass_count
+ *  Number of passes which ran at least one task.
+ *
+ * sleep_count
+ *  Number of times the sleep HAL was called.
+ *
+ * *_hal_*
+ *  User-provided functions. See the EXECUTOR typedef comments.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  volatile bool notified;
+  UTIMER_instance_t* utimer;
+  EXECUTOR_task_t* tasks;
+  uint32_t pass_count;
+  uint32_t sleep_count;
+  EXECUTOR_hal_enter_critical_t enter_critical;
+  EXECUTOR_hal_exit_critical_t exit_critical;
+  EXECUTOR_hal_sleep_t sleep;
+}
+EXECUTOR_instance_t;
+
+/*******************************************************************************
+ *
+ * EXECUTOR_initialize
+ *
+ * DESCRIPTION:
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
+ *
+ * PARAMETERS:
+ *  See EXECUTOR_instance_t.
+ *
+ ******************************************************************************/
+
+void EXECUTOR_initialize(EXECUTOR_instance_t* instance,
+                         UTIMER_instance_t* utimer,
+                         EXECUTOR_hal_enter_critical_t enter_critical,
+                         EXECUTOR_hal_exit_critical_t exit_critical,
+                         EXECUTOR_hal_sleep_t sleep);
+
+/*******************************************************************************
+ *
+ * EXECUTOR_register
+ *
+ * DESCRIPTION:
+ *  Registers a task, which is ready to run on the next pass.
+ *
+ * PARAMETERS:
+ *  See EXECUTOR_task_t.
+ *
+ ******************************************************************************/
+
+void EXECUTOR_register(EXECUTOR_instance_t* instance,
+                       EXECUTOR_task_t* task,
+                       EXECUTOR_service_t service,
+                       void* module_instance,
+                       uint32_t busy_period_us,
+                       uint32_t idle_period_us);
+
+/*******************************************************************************
+ *
+ * EXECUTOR_notify
+ *
+ * DESCRIPTION:
+ *  Marks a task ready to run on the next pass. To be called after giving its
+ *  module a new task request, or from an ISR whose event the module handles.
+ *
+ ******************************************************************************/
+
+void EXECUTOR_notify(EXECUTOR_instance_t* instance, EXECUTOR_task_t* task);
+
+/*******************************************************************************
+ *
+ * EXECUTOR_schedule
+ *
+ * DESCRIPTION:
+ *  Arms the deadline of a task, replacing an armed one. Not to be called from
+ *  an ISR.
+ *
+ * PARAMETERS:
+ *  delay_us
+ *   Time until the task is run.
+ *
+ ******************************************************************************/
+
+void EXECUTOR_schedule(EXECUTOR_instance_t* instance, EXECUTOR_task_t* task, uint64_t delay_us);
+
+/*******************************************************************************
+ *
+ * EXECUTOR_set_stats
+ *
+ * DESCRIPTION:
+ *  Attaches service efficiency counters to a registered task, so that its
+ *  service routine is run through SERVICESTATS_service.
+ *
+ * PARAMETERS:
+ *  stats
+ *   Initialized counters, or NULL to detach them.
+ *
+ * NOTES:
+ *  Only available with JLIB_CONFIG_SERVICESTATS.
+ *
+ ******************************************************************************/
+
+void EXECUTOR_set_stats(EXECUTOR_task_t* task, SERVICESTATS_instance_t* stats);
+
+/*******************************************************************************
+ *
+ * EXECUTOR_service
+ *
+ * DESCRIPTION:
+ *  Runs each task which is ready, notified or past its deadline once.
+ *
+ * RETURN:
+ *  True if no task is ready for another pass, i.e. the core may sleep, else,
+ *  false.
+ *
+ ******************************************************************************/
+
+bool EXECUTOR_service(EXECUTOR_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * EXECUTOR_sleep
+ *
+ * DESCRIPTION:
+ *  Sleeps until the earliest armed deadline or until an interrupt occurs,
+ *  unless a task has become ready in the meantime.
+ *
+ ******************************************************************************/
+
+void EXECUTOR_sleep(EXECUTOR_instance_t* instance);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EXECUTOR_J_H
+
+/*******************************************************************************
+ *
+ *  Font structures for standard gfx font. Adafruit provides a tool which can
+ *  convert between True-type to gfx here: https://rop.nl/truetype2gfx/
+ *
+ ******************************************************************************/
+
+#ifndef GFX2D_FONT_J_H
+#define GFX2D_FONT_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ *
+ * GFX2DFONT_glyph_t
+ *
+ * DESCRIPTION:
+ *  Provides meta information about a particular glyph/character which resides
+ *  within the actual font bitmap.
+ *
+ * bitmap_offset
+ *  Offset into the bitmap where the glyph data begins.
+ *
+ * width
+ *  Width of the glyph in pixels.
+ *
+ * height
+ *  Height of the glyph in pixels.
+ *
+ * x_advance
+ *  Distance to advance the cursor after each printed glyph. For mono-spaced
+ *  fonts, this normally equals the width of the widest character.
+ *
+ * x_offset
+ *  Distance, in pixels, from cursor position to upper-left corner. Not always
+ *  zero because the glyph may be somewhat centered in its allowed space.
+ *
+ * y_offset
+ *  Distance, in pixels, from cursor position to upper-left corner. The cursor
+ *  is located in the bottom-left corner of the glyph space, so this value is
+ *  almost always negative (positive for something like '_').
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint16_t bitmap_offset;
+  uint8_t width;
+  uint8_t height;
+  uint8_t x_advance;
+  int8_t x_offset;
+  int8_t y_offset;
+}
+GFX2DFONT_glyph_t;
+
+/*******************************************************************************
+ *
+ * GFX2DFONT_font_t
+ *
+ * DESCRIPTION:
+ *  An entire font module in which a bitmap contains all the glyph/characters,
+ *  and meta information describes the glyph offsets in the bitmap.
+ *
+ * bitmap
+ *  Bitmap containing all font glyph/characters.
+ *
+ * glyph
+ *  Array of glyph, one for each glyph/character, which provides meta
+ *  information of the location in the bitmap.
+ *
+ * first_ascii
+ *  First ASCII character/glyph supported by the font.
+ *
+ * last_ascii
+ *  Last ASCII character/glyph supported by the font.
+ *
+ * y_advance
+ *  Distance to move cursor down for the next line of text.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint8_t* bitmap;
+  GFX2DFONT_glyph_t* glyph;
+  uint16_t first_ascii;
+  uint16_t last_ascii;
+  uint8_t y_advance;
+}
+GFX2DFONT_font_t;
+
+/*
+ * Default font.
+ */
+
+extern const GFX2DFONT_font_t GFX2DFONT_DEFAULT_FONT;
+
+#ifdef __cplusplus
+}
+#endif
+#endif // GFX2D_FONT_J_H
+
+/*******************************************************************************
+ *
+ *  Simple graphics library which can render basic shapes and images. Elements
+ *  are rendered into a memory buffer. It is then up to external user code to
+ *  send the buffer to the display.
+ *
+ *  With segmentation the target display can be rendered in parts. This is used
+ *  when there is not enough memory to host an entire virtual display buffer.
+ *  Since each segment requires a re-render of the display frame, it is ideal
+ *  to have a large enough buffer which can hold the entire virtual display
+ *  frame buffer.
+ *
+ *  This library supports all combinations of up to 32-bit RGB formats (e.g.
+ *  3:3:2, 3:3:3, 4:4:4, 5:6:5, 6:6:6, 8:8:8, etc...) The RGB bit makeup of the
+ *  pixel is irrelevant to the library logic. Instead, the user is required to
+ *  provide a function which interprets a provided RBGA color into the desired
+ *  pixel format.
+ *
+ *  While this library supports non-byte-aligned formats (i.e. when the sum of
+ *  the RGBA bits is not divisible by 8), the algorithm throughput for these
+ *  formats is considerably slower, on the order to 20x slower or more.
+ *
+ ******************************************************************************/
+
+#ifndef GFX2D_J_H
+#define GFX2D_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ *
+ * GFX2D_rgb_bitmap_t
+ *
+ * DESCRIPTION:
+ *  Enumerates the various supported bitmap types for draw_rgb_bitmap.
+ *
+ ******************************************************************************/
+
+typedef enum
+{
+  GFX2D_RGB_BITMAP_332                    = 0,
+  GFX2D_RGB_BITMAP_565,
+  GFX2D_RGB_BITMAP_888
+}
+GFX2D_rgb_bitmap_t;
+
+/*******************************************************************************
+ *
+ * GFX2D_circle_quadrant_t
+ *
+ * DESCRIPTION:
+ *  Used for determining which quadrants of a circle need to be drawn.
+ *
+ ******************************************************************************/
+
+typedef enum
+{
+  GFX2D_CIRCLE_QUADRANT_NONE              = 0, // 0b0000
+  GFX2D_CIRCLE_QUADRANT_TOP_LEFT          = 1, // 0b0001
+  GFX2D_CIRCLE_QUADRANT_TOP_RIGHT         = 2, // 0b0010
+  GFX2D_CIRCLE_QUADRANT_BOTTOM_LEFT       = 4, // 0b0100
+  GFX2D_CIRCLE_QUADRANT_BOTTOM_RIGHT      = 8, // 0b1000
+  GFX2D_CIRCLE_QUADRANT_ALL               = 15 // 0b1111
+}
+GFX2D_circle_quadrant_t;
+
+/*******************************************************************************
+ *
+ * GFX2D_rgba_t
+ *
+ * DESCRIPTION:
+ *  Traditional 32-bit color, RGB with an Alpha channel. This type is used for
+ *  user input and does not necessarily reflect the rendered color based on
+ *  pixel color settings.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint32_t all;
+  struct
+  {
+    uint32_t r                            : 8;
+    uint32_t g                            : 8;
+    uint32_t b                            : 8;
+    uint32_t a                            : 8;
+  };
+}
+GFX2D_rgba_t;
+
+/*******************************************************************************
+ *
+ * GFX2D_font_t
+ *
+ * DESCRIPTION:
+ *  Collection of variables for text drawing.
+ *
+ * font
+ *  Points to the font module to use.
+ *
+ * cursor_x
+ *  The current x-start location of the next character to write.
+ *
+ * cursor_y
+ *  The current y-start location of the next character to write.
+ *
+ * color
+ *  See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ * x_magnification
+ *  Magnification of the text in the x-direction.
+ *
+ * y_magnification
+ *  Magnification of the text in the y-direction.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  GFX2DFONT_font_t* font;
+  int16_t cursor_x;
+  int16_t cursor_y;
+  uint32_t color;
+  uint8_t x_magnification;
+  uint8_t y_magnification;
+}
+GFX2D_font_t;
+
+/*******************************************************************************
+ *
+ * GFX2D_flags_t
+ *
+ * DESCRIPTION:
+ *  Module flags.
+ *
+ * byte_aligned
+ *  Indicates whether bits_per_pixel is evenly divisible by 8, that is, it has
+ *  byte alignment. This flag is set or cleared during initialization.
+ *
+ * invert
+ *  Inverts the pixel location output to support a 180-degree screen rotation.
+ *
+ * wrap_text
+ *  Will cause text to wrap around to the next line automatically if the end
+ *  of the screen is reached.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t byte_aligned                  : 1;
+    uint8_t invert                        : 1;
+    uint8_t wrap_text                     : 1;
+    uint8_t reserved3                     : 5;
+  };
+}
+GFX2D_flags_t;
+
+/*******************************************************************************
+ *
+ * GFX2D_rgba_to_pixel_t
+ *
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called to convert
+ *  a GFX2D_rgba_t into the desired pixel format. If the number of bits per
+ *  pixel is less than 32, then the output pixels should only occupy the least
+ *  significant bits.
+ *
+ *  The user should also include any byte-swapping as required to support big
+ *  versus little endian formatting.
+ *
+ * PARAMETERS:
+ *  rgba
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ * RETURN:
+ *  Formatted pixel color.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
+ *
+ ******************************************************************************/
+
+typedef uint32_t (*GFX2D_rgba_to_pixel_t)(uint32_t);
+
+/*******************************************************************************
+ *
+ * GFX2D_canvas_fill_handler_t
+ *
+ * DESCRIPTION:
+ *  Function template for internal helper functions for GFX2D_fill_canvas. The
+ *  canvas fill function is used to clear the screen and set a background color.
+ *  Hence, having a direct call to an optimized handler can significantly improve
+ *  performance.
+ *
+ * PARAMETERS:
+ *  instance
+ *   Pointer to GFX2D_instance_t.
+ *
+ *  color
+ *   Formatted pixel color.
+ *
+ * NOTES:
+ *  For internal use only.
+ *
+ ******************************************************************************/
+
+typedef void (*GFX2D_canvas_fill_handler_t)(void*, uint32_t);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_hline_handler_t
+ *
+ * DESCRIPTION:
+ *  Function template for internal helper functions for GFX2D_draw_hline. The
+ *  hline function is used for the various filled objects, such as triangle,
+ *  rectangle, and circle. Hence, having a direct call to an optimized handler
+ *  can significantly improve performance.
+ *
+ * PARAMETERS:
+ *  instance
+ *   Pointer to GFX2D_instance_t.
+ *
+ *  x
+ *   X-Coords starting point of line.
+ *
+ *  y
+ *   Y-Coords starting point of line.
+ *
+ *  length
+ *   Length of the line in pixels.
+ *
+ *  color
+ *   Formatted pixel color.
+ *
+ * NOTES:
+ *  For internal use only.
+ *
+ ******************************************************************************/
+
+typedef void (*GFX2D_draw_hline_handler_t)(void*,
+                                           int16_t,
+                                           int16_t,
+                                           int16_t,
+                                           uint32_t);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_vline_handler_t
+ *
+ * DESCRIPTION:
+ *  Function template for internal helper functions for GFX2D_draw_vline.
+ *
+ * PARAMETERS:
+ *  instance
+ *   Pointer to GFX2D_instance_t.
+ *
+ *  x
+ *   X-Coords starting point of line.
+ *
+ *  y
+ *   Y-Coords starting point of line.
+ *
+ *  length
+ *   Length of the line in pixels.
+ *
+ *  color
+ *   Formatted pixel color.
+ *
+ * NOTES:
+ *  For internal use only.
+ *
+ ******************************************************************************/
+
+typedef void (*GFX2D_draw_vline_handler_t)(void*,
+                                           int16_t,
+                                           int16_t,
+                                           int16_t,
+                                           uint32_t);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_filled_rectangle_handler_t
+ *
+ * DESCRIPTION:
+ *  Function template for internal helper functions for GFX2D_draw_filled_-
+ *  rectangle. The filled rectangle function is used for drawing panels and
+ *  other large areas. Hence, having a direct call to an optimized handler can
+ *  significantly improve performance.
+ *
+ * PARAMETERS:
+ *  instance
+ *   Pointer to GFX2D_instance_t.
+ *
+ *  x
+ *   X-Coords starting point of line.
+ *
+ *  y
+ *   Y-Coords starting point of line.
+ *
+ *  width
+ *   Width of the rectangle in pixels.
+ *
+ *  height
+ *   Height of the rectangle in pixels.
+ *
+ *  color
+ *   Formatted pixel color.
+ *
+ * NOTES:
+ *  For internal use only.
+ *
+ ******************************************************************************/
+
+typedef void (*GFX2D_draw_filled_rectangle_handler_t)(void*,
+                                                      int16_t,
+                                                      int16_t,
+                                                      int16_t,
+                                                      int16_t,
+                                                      uint32_t);
+
+/*******************************************************************************
+ *
+ * GFX2D_instance_t
+ *
+ * DESCRIPTION:
+ *  Instance data and function pointers.
+ *
+ * NOTE:
+ *  The drawing canvas is a segmented portion of the target display frame. If
+ *  resources allow, the canvas dimensions should be the same as the target for
+ *  maximum efficiency. Otherwise, the canvas represents a portion of the target
+ *  display frame defined by a x,y offset and width and height.
+ *
+ * flags
+ *  Module flags.
+ *
+ * bits_per_pixel
+ *  The number of bits which make up a single pixel, ranging from 1 to 32.
+ *
+ * bytes_per_pixel
+ *  The number of bytes which make up a single pixel. This value is only used
+ *  for byte-aligned formats.
+ *
+ * display_buffer
+ *  Pointer to user-provided buffer which will hold the rendered graphics.
+ *
+ * display_buffer_length_bytes
+ *  Total length, in bytes, of the display buffer.
+ *
+ * display_buffer_length_pixels
+ *  Total length, in pixels, of the display buffer.
+ *
+ * display_target_width
+ *  The width, in pixels, of the target display.
+ *
+ * display_target_height
+ *  The height, in pixels, of the target display.
+ *
+ * canvas_x0
+ *  The starting x-offset relative to the target display frame which is mapped
+ *  to the canvas x-origin.
+ *
+ * canvas_y0
+ *  The starting y-offset relative to the target display frame which is mapped
+ *  to the canvas y-origin.
+ *
+ * canvas_width
+ *  Width, in pixels, of the drawing canvas.
+ *
+ * canvas_height
+ *  Height, in pixels, of the drawing canvas.
+ *
+ * canvas_bits_per_row
+ *  The number of bits which compose a single drawing canvas row.
+ *
+ * canvas_bytes_per_row
+ *  The number of bytes which compose a single drawing canvas row. This value
+ *  is only used for byte-aligned formats.
+ *
+ * canvas_length_bytes
+ *  Total length, in bytes, of the drawing canvas.
+ *
+ * canvas_length_pixels
+ *  Total length, in pixels, of the drawing canvas.
+ *
+ * font
+ *  Collection of text related variables.
+ *
+ * rgba_to_pixel
+ *  See GFX2D_rgba_to_pixel_t.
+ *
+ * canvas_fill_handler
+ *  See GFX2D_canvas_fill_handler_t.
+ *
+ * draw_hline_handler
+ *  See GFX2D_draw_hline_handler_t.
+ *
+ * draw_vline_handler
+ *  See GFX2D_draw_vline_handler_t.
+ *
+ * draw_filled_rectangle_handler
+ *  See GFX2D_draw_filled_rectangle_handler_t.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  GFX2D_flags_t flags;
+  uint8_t bits_per_pixel;
+  uint8_t bytes_per_pixel;
+  uint8_t* display_buffer;
+  uint32_t display_buffer_length_bytes;
+  uint32_t display_buffer_length_pixels;
+  int16_t display_target_width;
+  int16_t display_target_height;
+  int16_t canvas_x0;
+  int16_t canvas_y0;
+  int16_t canvas_width;
+  int16_t canvas_height;
+  uint32_t canvas_bits_per_row;
+  uint32_t canvas_bytes_per_row;
+  uint32_t canvas_length_bytes;
+  uint32_t canvas_length_pixels;
+  GFX2D_font_t font;
+  GFX2D_rgba_to_pixel_t rgba_to_pixel;
+  GFX2D_canvas_fill_handler_t canvas_fill_handler;
+  GFX2D_draw_hline_handler_t draw_hline_handler;
+  GFX2D_draw_vline_handler_t draw_vline_handler;
+  GFX2D_draw_filled_rectangle_handler_t draw_filled_rectangle_handler;
+}
+GFX2D_instance_t;
+
+/*******************************************************************************
+ *
+ * GFX2D_initialize
+ *
+ * DESCRIPTION:
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values. The drawing canvas is defaulted to a single pixel. The user
+ *  should call GFX2D_set_canvas_dimensions after initialization to set the draw
+ *  dimensions.
+ *
+ * PARAMETERS:
+ *  See GFX2D_instance_t.
+ *
+ ******************************************************************************/
+
+void GFX2D_initialize(GFX2D_instance_t* instance,
+                      uint8_t* display_buffer,
+                      uint32_t display_buffer_length_bytes,
+                      int16_t display_target_width,
+                      int16_t display_target_height,
+                      uint8_t bits_per_pixel,
+                      GFX2D_rgba_to_pixel_t rgba_to_pixel);
+
+/*******************************************************************************
+ *
+ * GFX2D_set_canvas_dimensions
+ *
+ * DESCRIPTION:
+ *  Sets the drawing canvas origin and pixel width and height. If the user
+ *  display buffer is large enough to accomodate an entire virtual display frame
+ *  for the target display, it is ideal to only call this function once with an
+ *  origin of 0,0 and a width and height equal to the target display.
+ *
+ * PARAMETERS:
+ *  See GFX2D_instance_t.
+ *
+ * RETURN:
+ *  True if the canvas dimensions were set, else, false if the dimensions
+ *  require more space than available in the display buffer. In this case, the
+ *  width and height are set to 1.
+ *
+ * NOTE:
+ *  Dimensions which overflow the target display width and height will be
+ *  trimmed. The function will still return true.
+ *
+ ******************************************************************************/
+
+bool GFX2D_set_canvas_dimensions(GFX2D_instance_t* instance,
+                                 int16_t canvas_x0,
+                                 int16_t canvas_y0,
+                                 int16_t canvas_width,
+                                 int16_t canvas_height);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_pixel
+ *
+ * DESCRIPTION:
+ *  Draws a single pixel.
+ *
+ * PARAMETERS:
+ *  x
+ *   X-Coords of pixel.
+ *
+ *  y
+ *   Y-Coords of pixel.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ * RETURN:
+ *  True if the pixel was drawn, else, false.
+ *
+ ******************************************************************************/
+
+bool GFX2D_draw_pixel(GFX2D_instance_t* instance,
+                      int16_t x,
+                      int16_t y,
+                      uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_fill_canvas
+ *
+ * DESCRIPTION:
+ *  Fills the canvas buffer with a specified color.
+ *
+ * PARAMETERS:
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_fill_canvas(GFX2D_instance_t* instance, uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_hline
+ *
+ * DESCRIPTION:
+ *  Draws a horizontal line.
+ *
+ * PARAMETERS:
+ *  x
+ *   X-Coords starting point of line.
+ *
+ *  y
+ *   Y-Coords starting point of line.
+ *
+ *  length
+ *   Length of the line in pixels.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_hline(GFX2D_instance_t* instance,
+                      int16_t x,
+                      int16_t y,
+                      int16_t length,
+                      uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_vline
+ *
+ * DESCRIPTION:
+ *  Draws a vertical line.
+ *
+ * PARAMETERS:
+ *  x
+ *   X-Coords starting point of line.
+ *
+ *  y
+ *   Y-Coords starting point of line.
+ *
+ *  length
+ *   Length of the line in pixels.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_vline(GFX2D_instance_t* instance,
+                      int16_t x,
+                      int16_t y,
+                      int16_t length,
+                      uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_line
+ *
+ * DESCRIPTION:
+ *  Draws a line.
+ *
+ * PARAMETERS:
+ *  x0
+ *   X-Coords starting point of line.
+ *
+ *  y0
+ *   Y-Coords starting point of line.
+ *
+ *  x1
+ *   X-Coords ending point of line.
+ *
+ *  y1
+ *   Y-Coords ending point of line.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_line(GFX2D_instance_t* instance,
+                     int16_t x0,
+                     int16_t y0,
+                     int16_t x1,
+                     int16_t y1,
+                     uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_triangle
+ *
+ * DESCRIPTION:
+ *  Draws a triangle.
+ *
+ * PARAMETERS:
+ *  x0
+ *   X-Coords of first triangle point.
+ *
+ *  y0
+ *   Y-Coords of first triangle point..
+ *
+ *  x1
+ *   X-Coords of second triangle point.
+ *
+ *  y1
+ *   Y-Coords of second triangle point.
+ *
+ *  x2
+ *   X-Coords of third triangle point.
+ *
+ *  y2
+ *   Y-Coords of third triangle point.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_triangle(GFX2D_instance_t* instance,
+                         int16_t x0,
+                         int16_t y0,
+                         int16_t x1,
+                         int16_t y1,
+                         int16_t x2,
+                         int16_t y2,
+                         uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_filled_triangle
+ *
+ * DESCRIPTION:
+ *  Draws a filled triangle.
+ *
+ * PARAMETERS:
+ *  x0
+ *   X-Coords of first triangle point.
+ *
+ *  y0
+ *   Y-Coords of first triangle point.
+ *
+ *  x1
+ *   X-Coords of second triangle point.
+ *
+ *  y1
+ *   Y-Coords of second triangle point.
+ *
+ *  x2
+ *   X-Coords of third triangle point.
+ *
+ *  y2
+ *   Y-Coords of third triangle point.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_filled_triangle(GFX2D_instance_t* instance,
+                                int16_t x0,
+                                int16_t y0,
+                                int16_t x1,
+                                int16_t y1,
+                                int16_t x2,
+                                int16_t y2,
+                                uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_circle_arc
+ *
+ * DESCRIPTION:
+ *  Mainly used as a helper function, but can be called independently. Draws
+ *  the quadrant arcs of a circle depending on the input bit quadrant flag.
+ *
+ * PARAMETERS:
+ *  x0
+ *   X-Coords of center point of circle.
+ *
+ *  y0
+ *   Y-Coords of center point of circle.
+ *
+ *  radius
+ *   Radius of the circle.
+ *
+ *  quadrant
+ *   Bit flag(s) indicating which arc(s), or quadrant(s) of a circle, to draw.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_circle_arc(GFX2D_instance_t* instance,
+                           int16_t x0,
+                           int16_t y0,
+                           int16_t radius,
+                           GFX2D_circle_quadrant_t quadrant,
+                           uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_filled_circle_arc
+ *
+ * DESCRIPTION:
+ *  Mainly used as a helper function, but can be called independently. Draws
+ *  the quadrant arcs of a circle depending on the input bit quadrant flag.
+ *
+ * PARAMETERS:
+ *  x0
+ *   X-Coords of center point of circle.
+ *
+ *  y0
+ *   Y-Coords of center point of circle.
+ *
+ *  radius
+ *   Radius of the circle.
+ *
+ *  quadrant
+ *   Bit flag(s) indicating which arc(s), or quadrant(s) of a circle, to draw.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_filled_circle_arc(GFX2D_instance_t* instance,
+                                  int16_t x0,
+                                  int16_t y0,
+                                  int16_t radius,
+                                  GFX2D_circle_quadrant_t quadrant,
+                                  uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_circle
+ *
+ * DESCRIPTION:
+ *  Draws a circle.
+ *
+ * PARAMETERS:
+ *  x0
+ *   X-Coords of center point.
+ *
+ *  y0
+ *   Y-Coords of center point.
+ *
+ *  radius
+ *   Radius of the circle.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_circle(GFX2D_instance_t* instance,
+                       int16_t x0,
+                       int16_t y0,
+                       int16_t radius,
+                       uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_filled_circle
+ *
+ * DESCRIPTION:
+ *  Draws a filled circle.
+ *
+ * PARAMETERS:
+ *  x0
+ *   X-Coords of center point.
+ *
+ *  y0
+ *   Y-Coords of center point.
+ *
+ *  radius
+ *   Radius of the circle.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_filled_circle(GFX2D_instance_t* instance,
+                              int16_t x0,
+                              int16_t y0,
+                              int16_t radius,
+                              uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_rectangle
+ *
+ * DESCRIPTION:
+ *  Draws a rectangle.
+ *
+ * PARAMETERS:
+ *  x
+ *   X-Coords starting point of rectangle.
+ *
+ *  y
+ *   Y-Coords starting point of rectangle.
+ *
+ *  width
+ *   Width of the rectangle in pixels.
+ *
+ *  height
+ *   Height of the rectangle in pixels.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_rectangle(GFX2D_instance_t* instance,
+                          int16_t x,
+                          int16_t y,
+                          int16_t width,
+                          int16_t height,
+                          uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_filled_rectangle
+ *
+ * DESCRIPTION:
+ *  Draws a filled rectangle.
+ *
+ * PARAMETERS:
+ *  x
+ *   X-Coords starting point of rectangle.
+ *
+ *  y
+ *   Y-Coords starting point of rectangle.
+ *
+ *  width
+ *   Width of the rectangle in pixels.
+ *
+ *  height
+ *   Height of the rectangle in pixels.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_filled_rectangle(GFX2D_instance_t* instance,
+                                int16_t x,
+                                int16_t y,
+                                int16_t width,
+                                int16_t height,
+                                uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_rounded_rectangle
+ *
+ * DESCRIPTION:
+ *  Draws a rectangle with rounded edges.
+ *
+ * PARAMETERS:
+ *  x
+ *   X-Coords starting point of rectangle.
+ *
+ *  y
+ *   Y-Coords starting point of rectangle.
+ *
+ *  width
+ *   Width of the rectangle in pixels.
+ *
+ *  height
+ *   Height of the rectangle in pixels.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_rounded_rectangle(GFX2D_instance_t* instance,
+                                  int16_t x,
+                                  int16_t y,
+                                  int16_t width,
+                                  int16_t height,
+                                  int16_t radius,
+                                  uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_filled_rounded_rectangle
+ *
+ * DESCRIPTION:
+ *  Draws a filled rectangle with rounded edges.
+ *
+ * PARAMETERS:
+ *  x
+ *   X-Coords starting point of rectangle.
+ *
+ *  y
+ *   Y-Coords starting point of rectangle.
+ *
+ *  width
+ *   Width of the rectangle in pixels.
+ *
+ *  height
+ *   Height of the rectangle in pixels.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_filled_rounded_rectangle(GFX2D_instance_t* instance,
+                                         int16_t x,
+                                         int16_t y,
+                                         int16_t width,
+                                         int16_t height,
+                                         int16_t radius,
+                                         uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_binary_bitmap
+ *
+ * DESCRIPTION:
+ *  Draws a binary color bitmap at the specified x,y location. If the color and
+ *  background color are the same value, then the background color will not be
+ *  drawn and will instead act as a transparent pixel.
+ *
+ * PARAMETERS:
+ *  bitmap
+ *   Pointer to the binary bitmap.
+ *
+ *  x0, y0
+ *   Target display write origin.
+ *
+ *  bitmap_x0, bitmap_y0
+ *   Bitmap read origin.
+ *
+ *  bitmap_width_draw
+ *   The width, in pixels, of the bitmap portion to draw.
+ *
+ *  bitmap_height_draw
+ *   The height, in pixels, of the bitmap portion to draw.
+ *
+ *  bitmap_width_total
+ *   The width, in pixels, of the complete bitmap image.
+ *
+ *  bitmap_height_total
+ *   The height, in pixels, of the complete bitmap image.
+ *
+ *  color
+ *   Color set to a pixel when the corresponding bitmap bit is a 1.
+ *
+ *  background_color
+ *   Color set to a pixel when the corresponding bitmap bit is a 0. If the
+ *   background color is the same as color, then the pixel is not drawn in
+ *   the case of 0 (transparent).
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_binary_bitmap(GFX2D_instance_t* instance,
+                              const uint8_t* bitmap,
+                              int16_t x0,
+                              int16_t y0,
+                              uint16_t bitmap_x0,
+                              uint16_t bitmap_y0,
+                              uint16_t bitmap_width_draw,
+                              uint16_t bitmap_height_draw,
+                              uint16_t bitmap_width_total,
+                              uint16_t bitmap_height_total,
+                              uint32_t color,
+                              uint32_t background_color);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_rgb_bitmap
+ *
+ * DESCRIPTION:
+ *  Draws an RGB bitmap at the specified x,y location.
+ *
+ * PARAMETERS:
+ *  rgb_bitmap
+ *   Bitmap format (332, 565, 888).
+ *
+ *  alpha_mask
+ *   Bit-mask indicating which pixels should be transparent (0) and which
+ *   should be opaque (1). Each bit represents a pixel, so the length of the
+ *   bitmap array in bytes should be the cieling of the number of bitmap pixels
+ *   divided by 8. This parameter can be left NULL if not needed.
+ *
+ *  See GFX2D_draw_binary_bitmap.
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_rgb_bitmap(GFX2D_instance_t* instance,
+                           GFX2D_rgb_bitmap_t rgb_bitmap,
+                           const uint8_t* bitmap,
+                           const uint8_t* alpha_mask,
+                           int16_t x0,
+                           int16_t y0,
+                           uint16_t bitmap_x0,
+                           uint16_t bitmap_y0,
+                           uint16_t bitmap_width_draw,
+                           uint16_t bitmap_height_draw,
+                           uint16_t bitmap_width_total,
+                           uint16_t bitmap_height_total);
+
+/*******************************************************************************
+ *
+ * GFX2D_set_text_magnification
+ *
+ * DESCRIPTION:
+ *  Sets the x and y text magnifications.To keep the text in proper proportions,
+ *  the x and y values should be the same.
+ *
+ * PARAMETERS:
+ *  x_magnification
+ *   Text magnification in the x-direction.
+ *
+ *  y_magnification
+ *   Text magnification in the y-direction.
+ *
+ ******************************************************************************/
+
+void GFX2D_set_text_magnification(GFX2D_instance_t* instance,
+                                  uint8_t x_magnification,
+                                  uint8_t y_magnification);
+
+/*******************************************************************************
+ *
+ * GFX2D_set_font
+ *
+ * DESCRIPTION:
+ *  Sets the font.
+ *
+ * PARAMETERS:
+ *  font
+ *   Pointer to font structure.
+ *
+ ******************************************************************************/
+
+void GFX2D_set_font(GFX2D_instance_t* instance, GFX2DFONT_font_t* font);
+
+/*******************************************************************************
+ *
+ * GFX2D_set_font_color
+ *
+ * DESCRIPTION:
+ *  Sets the font color.
+ *
+ * PARAMETERS:
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2D_set_font_color(GFX2D_instance_t* instance, uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2D_set_inverted
+ *
+ * DESCRIPTION:
+ *  Enables or disables inverted rendering.
+ *
+ * PARAMETERS:
+ *  enable_inverted
+ *   True to enable inverted rendering, else, false to disable.
+ *
+ ******************************************************************************/
+
+void GFX2D_set_inverted(GFX2D_instance_t* instance, bool enable_inverted);
+
+/*******************************************************************************
+ *
+ * GFX2D_set_text_wrap
+ *
+ * DESCRIPTION:
+ *  Enables or disables text wrapping - text will automatically go to the next
+ *  line if the end of the row is reached.
+ *
+ * PARAMETERS:
+ *  enable_wrap
+ *   True to enable wrapping, else, false to disable.
+ *
+ ******************************************************************************/
+
+void GFX2D_set_text_wrap(GFX2D_instance_t* instance, bool enable_wrap);
+
+/*******************************************************************************
+ *
+ * GFX2D_draw_char
+ *
+ * DESCRIPTION:
+ *  Draws a single character from the font module.
+ *
+ * PARAMETERS:
+ *  c
+ *   ASCII character to draw. Characters/glyph not supported by the font
+ *   module will not be drawn.
+ *
+ ******************************************************************************/
+
+void GFX2D_draw_char(GFX2D_instance_t* instance, uint8_t c);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // GFX2D_J_H
+
+/*******************************************************************************
+ *
+ *  Sparse fonts for GFX2D, for large and Unicode character sets. Glyphs are
+ *  looked up by codepoint through a sorted table of codepoint ranges, so a
+ *  font only stores the glyphs it provides, and bitmap offsets are 32-bit, so
+ *  the bitmap is not limited to 64 KB. Text is drawn from UTF-8.
+ *
+ *  The glyph bitmaps and metrics are those of GFX2DFONT. Text is drawn with
+ *  the font settings of the GFX2D instance (cursor, color, magnification,
+ *  wrapping, and inversion), hence, GFX2D_set_font_color etc. apply, and text
+ *  drawn with GFX2D_draw_char and GFX2DUFONT_draw_char continues on the same
+ *  cursor.
+ *
+ *  Fonts are either binary, as GFX2DFONT, or anti-aliased with 2 or 4 bits of
+ *  alpha per pixel. Partially covered pixels of anti-aliased text are blended
+ *  with the background color, if set with GFX2DUFONT_set_background, without
+ *  reading the canvas. Otherwise, on RGB565 canvases, they are blended with
+ *  the canvas pixels, and on other canvases drawn if at least half covered.
+ *
+ *  Fonts are generated from TrueType fonts with tools/fontconvert.py, e.g.:
+ *
+ *   python3 tools/fontconvert.py DejaVuSans.ttf --size 16 --name SANS16
+ *           --ranges 0x20-0x7E,0x400-0x44F --output src/FontSans16
+ *
+ *  Typical use:
+ *
+ *   GFX2DUFONT_initialize(&text, &gfx, &GFX2DUFONT_SANS16);
+ *   gfx.font.cursor_x = 10;
+ *   gfx.font.cursor_y = 40;
+ *   GFX2DUFONT_draw_string(&text, "23.5 \xC2\xB0C");
+ *
+ ******************************************************************************/
+
+#ifndef GFX2DUFONT_J_H
+#define GFX2DUFONT_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_pixel_format_t
+ *
+ * DESCRIPTION:
+ *  Enumerates the canvas pixel formats which anti-aliased text is blended
+ *  with, as detected from the rgba_to_pixel function of the GFX2D instance.
+ *
+ ******************************************************************************/
+
+typedef enum
+{
+  GFX2DUFONT_PIXEL_FORMAT_OTHER           = 0,
+  GFX2DUFONT_PIXEL_FORMAT_RGB565,
+  GFX2DUFONT_PIXEL_FORMAT_RGB565_SWAPPED
+}
+GFX2DUFONT_pixel_format_t;
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_glyph_t
+ *
+ * DESCRIPTION:
+ *  Provides meta information about a glyph, see GFX2DFONT_glyph_t.
+ *
+ * bitmap_offset
+ *  Offset into the bitmap where the glyph data begins.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint32_t bitmap_offset;
+  uint8_t width;
+  uint8_t height;
+  uint8_t x_advance;
+  int8_t x_offset;
+  int8_t y_offset;
+}
+GFX2DUFONT_glyph_t;
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_range_t
+ *
+ * DESCRIPTION:
+ *  A run of consecutive codepoints provided by the font, whose glyphs are
+ *  consecutive in the glyph array.
+ *
+ * first_codepoint
+ *  First codepoint of the run.
+ *
+ * length
+ *  Number of codepoints in the run.
+ *
+ * first_glyph
+ *  Index, in the glyph array, of the glyph of the first codepoint.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint32_t first_codepoint;
+  uint16_t length;
+  uint16_t first_glyph;
+}
+GFX2DUFONT_range_t;
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_font_t
+ *
+ * DESCRIPTION:
+ *  An entire font module, see GFX2DFONT_font_t.
+ *
+ * bitmap
+ *  Bitmap containing all font glyph/characters.
+ *
+ * glyph
+ *  Array of glyph, one for each glyph/character.
+ *
+ * range
+ *  Array of the codepoint ranges, sorted by codepoint, which do not overlap.
+ *
+ * range_count
+ *  Number of codepoint ranges.
+ *
+ * y_advance
+ *  Distance to move cursor down for the next line of text.
+ *
+ * alpha_bits
+ *  0 for binary glyphs, as GFX2DFONT, else 2 or 4 for anti-aliased glyphs
+ *  with 2 or 4 bits of alpha per pixel. Anti-aliased glyphs are run-length
+ *  encoded, row after row. A glyph starts with its number of codes, in one
+ *  byte, or in two bytes, most significant first, with bit 15 set, if 128 or
+ *  more. Each code byte is a run of 0-15 transparent (bit 7 clear) or opaque
+ *  (bit 7 set) pixels, in bits 6-3, followed by 0-7 partially covered pixels,
+ *  in bits 2-0. The alpha of the partially covered pixels follows the codes,
+ *  packed most significant bits first. A glyph with no codes is followed by
+ *  the alpha of all its pixels.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  const uint8_t* bitmap;
+  const GFX2DUFONT_glyph_t* glyph;
+  const GFX2DUFONT_range_t* range;
+  uint16_t range_count;
+  uint8_t y_advance;
+  uint8_t alpha_bits;
+}
+GFX2DUFONT_font_t;
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_instance_t
+ *
+ * DESCRIPTION:
+ *  Text drawing state of a GFX2D instance with a sparse font.
+ *
+ * gfx
+ *  The GFX2D instance drawn into.
+ *
+ * font
+ *  See GFX2DUFONT_font_t.
+ *
+ * utf8_codepoint
+ *  Codepoint of the UTF-8 sequence being decoded.
+ *
+ * utf8_remaining
+ *  Number of continuation bytes missing from the UTF-8 sequence.
+ *
+ * utf8_length
+ *  Length of the UTF-8 sequence being decoded.
+ *
+ * cached_codepoint
+ *  Codepoint of the last glyph looked up.
+ *
+ * cached_glyph
+ *  Last glyph looked up, or NULL if the font does not provide it.
+ *
+ * cached_range
+ *  Index of the range of the last glyph found. Text mostly stays within a
+ *  script, whose codepoints share a range, so the range is tested before
+ *  searching.
+ *
+ * pixel_format
+ *  See GFX2DUFONT_pixel_format_t.
+ *
+ * background_known
+ *  Whether text is drawn over background_color.
+ *
+ * background_color
+ *  See GFX2DUFONT_set_background.
+ *
+ * palette_bits
+ *  Alpha bits of the palette, 0 if it is not computed.
+ *
+ * palette_color, palette_background
+ *  Font and background colors of the palette.
+ *
+ * palette_rgba
+ *  Colors of the alpha values, from the background color to the font color.
+ *
+ * palette_pixel
+ *  Colors of the alpha values, formatted for 16-bit canvases.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  GFX2D_instance_t* gfx;
+  const GFX2DUFONT_font_t* font;
+  uint32_t utf8_codepoint;
+  uint8_t utf8_remaining;
+  uint8_t utf8_length;
+  uint32_t cached_codepoint;
+  const GFX2DUFONT_glyph_t* cached_glyph;
+  uint16_t cached_range;
+  uint8_t pixel_format;
+  bool background_known;
+  uint32_t background_color;
+  uint8_t palette_bits;
+  uint32_t palette_color;
+  uint32_t palette_background;
+  uint32_t palette_rgba[16];
+  uint16_t palette_pixel[16];
+}
+GFX2DUFONT_instance_t;
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_initialize
+ *
+ * DESCRIPTION:
+ *  Initializes a text drawing instance.
+ *
+ * PARAMETERS:
+ *  instance
+ *   Pointer to GFX2DUFONT_instance_t.
+ *
+ *  gfx
+ *   Pointer to an initialized GFX2D_instance_t.
+ *
+ *  font
+ *   See GFX2DUFONT_font_t.
+ *
+ * NOTES:
+ *  The pixel format is detected from the rgba_to_pixel function of the GFX2D
+ *  instance, hence, GFX2D must be initialized first.
+ *
+ ******************************************************************************/
+
+void GFX2DUFONT_initialize(GFX2DUFONT_instance_t* instance,
+                           GFX2D_instance_t* gfx,
+                           const GFX2DUFONT_font_t* font);
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_set_font
+ *
+ * DESCRIPTION:
+ *  Sets the font.
+ *
+ * PARAMETERS:
+ *  font
+ *   See GFX2DUFONT_font_t.
+ *
+ ******************************************************************************/
+
+void GFX2DUFONT_set_font(GFX2DUFONT_instance_t* instance, const GFX2DUFONT_font_t* font);
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_set_background
+ *
+ * DESCRIPTION:
+ *  Sets the color which anti-aliased text is drawn over, e.g. the color of
+ *  the panel of a gauge. Partially covered pixels are then drawn with colors
+ *  blended from the font color and the background color, computed once per
+ *  color, rather than blending with the canvas pixels.
+ *
+ * PARAMETERS:
+ *  enable
+ *   True if the text is drawn over the background color, else, false to blend
+ *   with the canvas pixels.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ ******************************************************************************/
+
+void GFX2DUFONT_set_background(GFX2DUFONT_instance_t* instance, bool enable, uint32_t color);
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_find_glyph
+ *
+ * DESCRIPTION:
+ *  Looks up the glyph of a codepoint.
+ *
+ * PARAMETERS:
+ *  codepoint
+ *   Unicode codepoint.
+ *
+ * RETURN:
+ *  The glyph, or NULL if the font does not provide the codepoint.
+ *
+ ******************************************************************************/
+
+const GFX2DUFONT_glyph_t* GFX2DUFONT_find_glyph(GFX2DUFONT_instance_t* instance, uint32_t codepoint);
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_draw_codepoint
+ *
+ * DESCRIPTION:
+ *  Draws a single character at the cursor of the GFX2D instance and advances
+ *  the cursor, as GFX2D_draw_char.
+ *
+ * PARAMETERS:
+ *  codepoint
+ *   Unicode codepoint to draw. Characters/glyph not provided by the font will
+ *   not be drawn.
+ *
+ ******************************************************************************/
+
+void GFX2DUFONT_draw_codepoint(GFX2DUFONT_instance_t* instance, uint32_t codepoint);
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_draw_char
+ *
+ * DESCRIPTION:
+ *  Draws UTF-8 text a byte at a time. A character is drawn once the last byte
+ *  of its UTF-8 sequence is given.
+ *
+ * PARAMETERS:
+ *  c
+ *   Byte of UTF-8 text.
+ *
+ * NOTES:
+ *  Invalid UTF-8 sequences (overlong, surrogates, out of range, or truncated)
+ *  are not drawn.
+ *
+ ******************************************************************************/
+
+void GFX2DUFONT_draw_char(GFX2DUFONT_instance_t* instance, uint8_t c);
+
+/*******************************************************************************
+ *
+ * GFX2DUFONT_draw_string
+ *
+ * DESCRIPTION:
+ *  Draws null terminated UTF-8 text, see GFX2DUFONT_draw_char.
+ *
+ * PARAMETERS:
+ *  text
+ *   Null terminated UTF-8 text.
+ *
+ ******************************************************************************/
+
+void GFX2DUFONT_draw_string(GFX2DUFONT_instance_t* instance, const char* text);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // GFX2DUFONT_J_H
+
+/*******************************************************************************
+ *
+ *  Clipping for GFX2D. A stack of clip rectangles restricts drawing to a
+ *  region of the display, such as a scrolled list or a widget, and each draw
+ *  call is tested against the clip rectangle and the current canvas segment
+ *  before GFX2D is called. Calls outside of them are skipped, calls inside of
+ *  them are passed to GFX2D unchanged, and the others are trimmed: rectangles,
+ *  lines of rectangles, and bitmaps to the visible part, lines with Cohen-
+ *  Sutherland before stepping only the visible part, and filled shapes to
+ *  their visible rows and columns. Hence, a segment or widget only does the
+ *  work of the pixels it shows.
+ *
+ *  The drawing functions take the same parameters as the GFX2D functions of
+ *  the same name, and clip rectangles are in the same coordinates, so the
+ *  clipping follows the canvas segment and inversion of the GFX2D instance.
+ *
+ *  Typical use:
+ *
+ *   GFX2DCLIP_initialize(&clip, &gfx);
+ *   GFX2DCLIP_push(&clip, 0, 40, 240, 200);
+ *
+ *   for (uint8_t i = 0; i < item_count; i++)
+ *   {
+ *     GFX2DCLIP_draw_filled_rounded_rectangle(&clip, 4, y, 232, 36, 6, panel);
+ *     y += 40;
+ *   }
+ *
+ *   GFX2DCLIP_pop(&clip);
+ *
+ ******************************************************************************/
+
+#ifndef GFX2DCLIP_J_H
+#define GFX2DCLIP_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Maximum number of nested clip rectangles. Can be overridden in the project
+ * build properties.
+ */
+
+#ifndef GFX2DCLIP_STACK_DEPTH
+#define GFX2DCLIP_STACK_DEPTH             8U
+#endif
+
+/*******************************************************************************
+ *
+ * GFX2DCLIP_rectangle_t
+ *
+ * DESCRIPTION:
+ *  A rectangle, inclusive of all four edges.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  int16_t left;
+  int16_t top;
+  int16_t right;
+  int16_t bottom;
+}
+GFX2DCLIP_rectangle_t;
+
+/*******************************************************************************
+ *
+ * GFX2DCLIP_instance_t
+ *
+ * DESCRIPTION:
+ *  Instance data.
+ *
+ * gfx
+ *  Pointer to the GFX2D instance drawn into. Can be NULL to only track the
+ *  clip rectangles, as done while recording a GFX2DLIST.
+ *
+ * stack
+ *  Clip rectangles, each already intersected with those below it.
+ *
+ * depth
+ *  Number of clip rectangles on the stack.
+ *
+ * overflow
+ *  Number of pushes which did not fit on the stack, and are undone by the next
+ *  pops instead of a clip rectangle.
+ *
+ * bounds
+ *  Intersection of the top clip rectangle and the canvas, updated by each
+ *  call.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  GFX2D_instance_t* gfx;
+  GFX2DCLIP_rectangle_t stack[GFX2DCLIP_STACK_DEPTH];
+  uint8_t depth;
+  uint8_t overflow;
+  GFX2DCLIP_rectangle_t bounds;
+}
+GFX2DCLIP_instance_t;
+
+/*******************************************************************************
+ *
+ * GFX2DCLIP_initialize
+ *
+ * DESCRIPTION:
+ *  Initializes a module instance with an empty stack, clipping to the canvas
+ *  only.
+ *
+ * PARAMETERS:
+ *  See GFX2DCLIP_instance_t.
+ *
+ ******************************************************************************/
+
+void GFX2DCLIP_initialize(GFX2DCLIP_instance_t* clip, GFX2D_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * GFX2DCLIP_push
+ *
+ * DESCRIPTION:
+ *  Restricts drawing to the intersection of a rectangle and the current clip
+ *  rectangle, until the matching GFX2DCLIP_pop.
+ *
+ * PARAMETERS:
+ *  x, y, width, height
+ *   The rectangle, as for GFX2D_draw_filled_rectangle.
+ *
+ * RETURN:
+ *  True if the rectangle was pushed, else, false if the stack is full. In this
+ *  case, drawing stays restricted to the current clip rectangle.
+ *
+ ******************************************************************************/
+
+bool GFX2DCLIP_push(GFX2DCLIP_instance_t* clip,
+                    int16_t x,
+                    int16_t y,
+                    int16_t width,
+                    int16_t height);
+
+/*******************************************************************************
+ *
+ * GFX2DCLIP_pop
+ *
+ * DESCRIPTION:
+ *  Restores the clip rectangle of before the last GFX2DCLIP_push.
+ *
+ ******************************************************************************/
+
+void GFX2DCLIP_pop(GFX2DCLIP_instance_t* clip);
+
+/*******************************************************************************
+ *
+ * GFX2DCLIP_is_visible
+ *
+ * DESCRIPTION:
+ *  Tests whether any part of a box lies within the clip rectangle and canvas,
+ *  for skipping the drawing of whole widgets.
+ *
+ * PARAMETERS:
+ *  left, top, right, bottom
+ *   The box, inclusive of all four edges.
+ *
+ * RETURN:
+ *  True if the box is at least partially visible, else, false.
+ *
+ ******************************************************************************/
+
+bool GFX2DCLIP_is_visible(GFX2DCLIP_instance_t* clip,
+                          int16_t left,
+                          int16_t top,
+                          int16_t right,
+                          int16_t bottom);
+
+/*******************************************************************************
+ *
+ * GFX2DCLIP_fill_canvas
+ * GFX2DCLIP_draw_*
+ *
+ * DESCRIPTION:
+ *  Calls the GFX2D function of the same name, clipped to the clip rectangle.
+ *  GFX2DCLIP_fill_canvas fills the visible part of the clip rectangle.
+ *
+ * NOTES:
+ *  Lines, circles, triangles, and rounded rectangles which cross the clip
+ *  rectangle or canvas edge are drawn by this module, with the Bresenham and
+ *  midpoint algorithms of Adafruit GFX, so that only their visible part is
+ *  stepped. Text advances the cursor as GFX2D_draw_char, including wrapping.
+ *
+ ******************************************************************************/
+
+void GFX2DCLIP_fill_canvas(GFX2DCLIP_instance_t* clip, uint32_t color);
+
+void GFX2DCLIP_draw_pixel(GFX2DCLIP_instance_t* clip,
+                          int16_t x,
+                          int16_t y,
+                          uint32_t color);
+
+void GFX2DCLIP_draw_hline(GFX2DCLIP_instance_t* clip,
+                          int16_t x,
+                          int16_t y,
+                          int16_t length,
+                          uint32_t color);
+
+void GFX2DCLIP_draw_vline(GFX2DCLIP_instance_t* clip,
+                          int16_t x,
+                          int16_t y,
+                          int16_t length,
+                          uint32_t color);
+
+void GFX2DCLIP_draw_line(GFX2DCLIP_instance_t* clip,
+                         int16_t x0,
+                         int16_t y0,
+                         int16_t x1,
+                         int16_t y1,
+                         uint32_t color);
+
+void GFX2DCLIP_draw_triangle(GFX2DCLIP_instance_t* clip,
+                             int16_t x0,
+                             int16_t y0,
+                             int16_t x1,
+                             int16_t y1,
+                             int16_t x2,
+                             int16_t y2,
+                             uint32_t color);
+
+void GFX2DCLIP_draw_filled_triangle(GFX2DCLIP_instance_t* clip,
+                                    int16_t x0,
+                                    int16_t y0,
+                                    int16_t x1,
+                                    int16_t y1,
+                                    int16_t x2,
+                                    int16_t y2,
+                                    uint32_t color);
+
+void GFX2DCLIP_draw_circle(GFX2DCLIP_instance_t* clip,
+                           int16_t x0,
+                           int16_t y0,
+                           int16_t radius,
+                           uint32_t color);
+
+void GFX2DCLIP_draw_filled_circle(GFX2DCLIP_instance_t* clip,
+                                  int16_t x0,
+                                  int16_t y0,
+                                  int16_t radius,
+                                  uint32_t color);
+
+void GFX2DCLIP_draw_rectangle(GFX2DCLIP_instance_t* clip,
+                              int16_t x,
+                              int16_t y,
+                              int16_t width,
+                              int16_t height,
+                              uint32_t color);
+
+void GFX2DCLIP_draw_filled_rectangle(GFX2DCLIP_instance_t* clip,
+                                     int16_t x,
+                                     int16_t y,
+                                     int16_t width,
+                                     int16_t height,
+                                     uint32_t color);
+
+void GFX2DCLIP_draw_rounded_rectangle(GFX2DCLIP_instance_t* clip,
+                                      int16_t x,
+                                      int16_t y,
+                                      int16_t width,
+                                      int16_t height,
+                                      int16_t radius,
+                                      uint32_t color);
+
+void GFX2DCLIP_draw_filled_rounded_rectangle(GFX2DCLIP_instance_t* clip,
+                                             int16_t x,
+                                             int16_t y,
+                                             int16_t width,
+                                             int16_t height,
+                                             int16_t radius,
+                                             uint32_t color);
+
+void GFX2DCLIP_draw_binary_bitmap(GFX2DCLIP_instance_t* clip,
+                                  const uint8_t* bitmap,
+                                  int16_t x0,
+                                  int16_t y0,
+                                  uint16_t bitmap_x0,
+                                  uint16_t bitmap_y0,
+                                  uint16_t bitmap_width_draw,
+                                  uint16_t bitmap_height_draw,
+                                  uint16_t bitmap_width_total,
+                                  uint16_t bitmap_height_total,
+                                  uint32_t color,
+                                  uint32_t background_color);
+
+void GFX2DCLIP_draw_rgb_bitmap(GFX2DCLIP_instance_t* clip,
+                               GFX2D_rgb_bitmap_t rgb_bitmap,
+                               const uint8_t* bitmap,
+                               const uint8_t* alpha_mask,
+                               int16_t x0,
+                               int16_t y0,
+                               uint16_t bitmap_x0,
+                               uint16_t bitmap_y0,
+                               uint16_t bitmap_width_draw,
+                               uint16_t bitmap_height_draw,
+                               uint16_t bitmap_width_total,
+                               uint16_t bitmap_height_total);
+
+void GFX2DCLIP_draw_char(GFX2DCLIP_instance_t* clip, uint8_t c);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // GFX2DCLIP_J_H
+
+/*******************************************************************************
+ *
+ *  Display list for GFX2D. The draw calls of a frame are recorded once, with
+ *  the bounding box of each call, and replayed into any number of GFX2D
+ *  canvas segments. A replay skips the calls which do not touch the segment,
+ *  hence, segmented rendering no longer re-runs the UI code of the frame, and
+ *  each segment only draws what it shows.
+ *
+ *  The record functions take the same parameters as the GFX2D functions of
+ *  the same name. Bitmaps and fonts are referenced, so they must remain valid
+ *  until the last replay, whereas text is copied into the list.
+ *
+ *  Typical use:
+ *
+ *   GFX2DLIST_clear(&list);
+ *   GFX2DLIST_fill_canvas(&list, background);
+ *   GFX2DLIST_draw_filled_rounded_rectangle(&list, 10, 10, 200, 60, 8, panel);
+ *   GFX2DLIST_draw_text(&list, &font, 20, 50, 2, 2, white, label);
+ *
+ *   for (int16_t y = 0; y < 320; y += 40)
+ *   {
+ *     GFX2D_set_canvas_dimensions(&gfx, 0, y, 240, 40);
+ *     GFX2DLIST_replay(&list, &gfx);
+ *     ... send segment ...
+ *   }
+ *
+ *  Clip rectangles are pushed and popped as in GFX2DCLIP. Calls outside of
+ *  the clip rectangle are not recorded, and the others are replayed through
+ *  GFX2DCLIP, so a scrolled list or a widget only records and draws what it
+ *  shows.
+ *
+ *  A list is not thread safe while recording. Once recorded, it can be
+ *  replayed concurrently into different GFX2D instances.
+ *
+ ******************************************************************************/
+
+#ifndef GFX2DLIST_J_H
+#define GFX2DLIST_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ *
+ * GFX2DLIST_command_type_t
+ *
+ * DESCRIPTION:
+ *  Enumerates the recorded GFX2D calls.
+ *
+ ******************************************************************************/
+
+typedef enum
+{
+  GFX2DLIST_COMMAND_FILL_CANVAS           = 0,
+  GFX2DLIST_COMMAND_PIXEL,
+  GFX2DLIST_COMMAND_HLINE,
+  GFX2DLIST_COMMAND_VLINE,
+  GFX2DLIST_COMMAND_LINE,
+  GFX2DLIST_COMMAND_TRIANGLE,
+  GFX2DLIST_COMMAND_FILLED_TRIANGLE,
+  GFX2DLIST_COMMAND_CIRCLE,
+  GFX2DLIST_COMMAND_FILLED_CIRCLE,
+  GFX2DLIST_COMMAND_RECTANGLE,
+  GFX2DLIST_COMMAND_FILLED_RECTANGLE,
+  GFX2DLIST_COMMAND_ROUNDED_RECTANGLE,
+  GFX2DLIST_COMMAND_FILLED_ROUNDED_RECTANGLE,
+  GFX2DLIST_COMMAND_BINARY_BITMAP,
+  GFX2DLIST_COMMAND_RGB_BITMAP,
+  GFX2DLIST_COMMAND_TEXT,
+  GFX2DLIST_COMMAND_PUSH_CLIP,
+  GFX2DLIST_COMMAND_POP_CLIP
+}
+GFX2DLIST_command_type_t;
+
+/*******************************************************************************
+ *
+ * GFX2DLIST_command_t
+ *
+ * DESCRIPTION:
+ *  A recorded call. Only to be allocated by the user, as the command array of
+ *  the list.
+ *
+ * type
+ *  See GFX2DLIST_command_type_t.
+ *
+ * left, top, right, bottom
+ *  Bounding box of the pixels drawn by the call, inclusive, in target display
+ *  coordinates, trimmed to the clip rectangle.
+ *
+ * color
+ *  See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ * shape
+ *  Coordinates of the shapes, in the order of the GFX2D parameters, or the
+ *  rectangle of a pushed clip.
+ *
+ * bitmap
+ *  Parameters of the bitmaps, see GFX2D_draw_rgb_bitmap.
+ *
+ * text
+ *  Font, cursor, magnification, and the text location in the text buffer.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint8_t type;
+  int16_t left;
+  int16_t top;
+  int16_t right;
+  int16_t bottom;
+  uint32_t color;
+  union
+  {
+    int16_t shape[6];
+    struct
+    {
+      const uint8_t* bitmap;
+      const uint8_t* alpha_mask;
+      uint32_t background_color;
+      int16_t x0;
+      int16_t y0;
+      uint16_t bitmap_x0;
+      uint16_t bitmap_y0;
+      uint16_t bitmap_width_draw;
+      uint16_t bitmap_height_draw;
+      uint16_t bitmap_width_total;
+      uint16_t bitmap_height_total;
+      uint8_t rgb_bitmap;
+    }
+    bitmap;
+    struct
+    {
+      GFX2DFONT_font_t* font;
+      uint32_t offset;
+      uint16_t length;
+      int16_t cursor_x;
+      int16_t cursor_y;
+      uint8_t x_magnification;
+      uint8_t y_magnification;
+    }
+    text;
+  };
+}
+GFX2DLIST_command_t;
+
+/*******************************************************************************
+ *
+ * GFX2DLIST_instance_t
+ *
+ * DESCRIPTION:
+ *  Instance data.
+ *
+ * commands
+ *  User-provided array of commands.
+ *
+ * command_capacity
+ *  Number of elements in the command array.
+ *
+ * command_count
+ *  Number of commands recorded in the current frame.
+ *
+ * text_buffer
+ *  User-provided buffer holding the text of the text commands. Can be NULL if
+ *  no text is drawn.
+ *
+ * text_buffer_length
+ *  Length of the text buffer in bytes.
+ *
+ * text_length
+ *  Number of text bytes recorded in the current frame.
+ *
+ * overflow
+ *  Set when a call could not be recorded because the command array or text
+ *  buffer was full. Cleared by GFX2DLIST_clear.
+ *
+ * clip
+ *  Clip rectangles pushed while recording.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  GFX2DLIST_command_t* commands;
+  uint32_t command_capacity;
+  uint32_t command_count;
+  char* text_buffer;
+  uint32_t text_buffer_length;
+  uint32_t text_length;
+  bool overflow;
+  GFX2DCLIP_instance_t clip;
+}
+GFX2DLIST_instance_t;
+
+/*******************************************************************************
+ *
+ * GFX2DLIST_initialize
+ *
+ * DESCRIPTION:
+ *  Initializes a module instance with an empty list.
+ *
+ * PARAMETERS:
+ *  See GFX2DLIST_instance_t.
+ *
+ ******************************************************************************/
+
+void GFX2DLIST_initialize(GFX2DLIST_instance_t* list,
+                          GFX2DLIST_command_t* commands,
+                          uint32_t command_capacity,
+                          char* text_buffer,
+                          uint32_t text_buffer_length);
+
+/*******************************************************************************
+ *
+ * GFX2DLIST_clear
+ *
+ * DESCRIPTION:
+ *  Empties the list to record a new frame.
+ *
+ ******************************************************************************/
+
+void GFX2DLIST_clear(GFX2DLIST_instance_t* list);
+
+/*******************************************************************************
+ *
+ * GFX2DLIST_replay
+ *
+ * DESCRIPTION:
+ *  Draws the recorded calls, in order, into the current canvas of a GFX2D
+ *  instance, through GFX2DCLIP. Calls whose bounding box lies outside of the
+ *  canvas are skipped.
+ *
+ * PARAMETERS:
+ *  instance
+ *   Pointer to an initialized GFX2D instance.
+ *
+ * NOTES:
+ *  The font, font color, magnification, and cursor of the GFX2D instance are
+ *  changed by text commands. Text is drawn without wrapping.
+ *
+ ******************************************************************************/
+
+void GFX2DLIST_replay(GFX2DLIST_instance_t* list, GFX2D_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * GFX2DLIST_fill_canvas
+ * GFX2DLIST_draw_*
+ *
+ * DESCRIPTION:
+ *  Records a call of the GFX2D function of the same name.
+ *
+ * RETURN:
+ *  True if the call was recorded or draws nothing, else, false if the list is
+ *  full.
+ *
+ ******************************************************************************/
+
+bool GFX2DLIST_fill_canvas(GFX2DLIST_instance_t* list, uint32_t color);
+
+bool GFX2DLIST_draw_pixel(GFX2DLIST_instance_t* list,
+                          int16_t x,
+                          int16_t y,
+                          uint32_t color);
+
+bool GFX2DLIST_draw_hline(GFX2DLIST_instance_t* list,
+                          int16_t x,
+                          int16_t y,
+                          int16_t length,
+                          uint32_t color);
+
+bool GFX2DLIST_draw_vline(GFX2DLIST_instance_t* list,
+                          int16_t x,
+                          int16_t y,
+                          int16_t length,
+                          uint32_t color);
+
+bool GFX2DLIST_draw_line(GFX2DLIST_instance_t* list,
+                         int16_t x0,
+                         int16_t y0,
+                         int16_t x1,
+                         int16_t y1,
+                         uint32_t color);
+
+bool GFX2DLIST_draw_triangle(GFX2DLIST_instance_t* list,
+                             int16_t x0,
+                             int16_t y0,
+                             int16_t x1,
+                             int16_t y1,
+                             int16_t x2,
+                             int16_t y2,
+                             uint32_t color);
+
+bool GFX2DLIST_draw_filled_triangle(GFX2DLIST_instance_t* list,
+                                    int16_t x0,
+                                    int16_t y0,
+                                    int16_t x1,
+                                    int16_t y1,
+                                    int16_t x2,
+                                    int16_t y2,
+                                    uint32_t color);
+
+bool GFX2DLIST_draw_circle(GFX2DLIST_instance_t* list,
+                           int16_t x0,
+                           int16_t y0,
+                           int16_t radius,
+                           uint32_t color);
+
+bool GFX2DLIST_draw_filled_circle(GFX2DLIST_instance_t* list,
+                                  int16_t x0,
+                                  int16_t y0,
+                                  int16_t radius,
+                                  uint32_t color);
+
+bool GFX2DLIST_draw_rectangle(GFX2DLIST_instance_t* list,
+                              int16_t x,
+                              int16_t y,
+                              int16_t width,
+                              int16_t height,
+                              uint32_t color);
+
+bool GFX2DLIST_draw_filled_rectangle(GFX2DLIST_instance_t* list,
+                                     int16_t x,
+                                     int16_t y,
+                                     int16_t width,
+                                     int16_t height,
+                                     uint32_t color);
+
+bool GFX2DLIST_draw_rounded_rectangle(GFX2DLIST_instance_t* list,
+                                      int16_t x,
+                                      int16_t y,
+                                      int16_t width,
+                                      int16_t height,
+                                      int16_t radius,
+                                      uint32_t color);
+
+bool GFX2DLIST_draw_filled_rounded_rectangle(GFX2DLIST_instance_t* list,
+                                             int16_t x,
+                                             int16_t y,
+                                             int16_t width,
+                                             int16_t height,
+                                             int16_t radius,
+                                             uint32_t color);
+
+bool GFX2DLIST_draw_binary_bitmap(GFX2DLIST_instance_t* list,
+                                  const uint8_t* bitmap,
+                                  int16_t x0,
+                                  int16_t y0,
+                                  uint16_t bitmap_x0,
+                                  uint16_t bitmap_y0,
+                                  uint16_t bitmap_width_draw,
+                                  uint16_t bitmap_height_draw,
+                                  uint16_t bitmap_width_total,
+                                  uint16_t bitmap_height_total,
+                                  uint32_t color,
+                                  uint32_t background_color);
+
+bool GFX2DLIST_draw_rgb_bitmap(GFX2DLIST_instance_t* list,
+                               GFX2D_rgb_bitmap_t rgb_bitmap,
+                               const uint8_t* bitmap,
+                               const uint8_t* alpha_mask,
+                               int16_t x0,
+                               int16_t y0,
+                               uint16_t bitmap_x0,
+                               uint16_t bitmap_y0,
+                               uint16_t bitmap_width_draw,
+                               uint16_t bitmap_height_draw,
+                               uint16_t bitmap_width_total,
+                               uint16_t bitmap_height_total);
+
+/*******************************************************************************
+ *
+ * GFX2DLIST_draw_text
+ *
+ * DESCRIPTION:
+ *  Records a string drawn with GFX2D_draw_char, starting at a cursor position.
+ *  The text is copied into the text buffer.
+ *
+ * PARAMETERS:
+ *  font
+ *   Pointer to font structure.
+ *
+ *  cursor_x, cursor_y
+ *   Cursor position of the first character, see GFX2D_font_t.
+ *
+ *  x_magnification, y_magnification
+ *   See GFX2D_set_text_magnification.
+ *
+ *  color
+ *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *
+ *  text
+ *   Null terminated string.
+ *
+ * RETURN:
+ *  True if the text was recorded, else, false if the list is full.
+ *
+ ******************************************************************************/
+
+bool GFX2DLIST_draw_text(GFX2DLIST_instance_t* list,
+                         GFX2DFONT_font_t* font,
+                         int16_t cursor_x,
+                         int16_t cursor_y,
+                         uint8_t x_magnification,
+                         uint8_t y_magnification,
+                         uint32_t color,
+                         const char* text);
+
+/*******************************************************************************
+ *
+ * GFX2DLIST_push_clip
+ * GFX2DLIST_pop_clip
+ *
+ * DESCRIPTION:
+ *  Records a call of the GFX2DCLIP function of the same name. The calls
+ *  recorded in between are clipped to the rectangle.
+ *
+ * RETURN:
+ *  True if the call was recorded, else, false if the list is full.
+ *
+ ******************************************************************************/
+
+bool GFX2DLIST_push_clip(GFX2DLIST_instance_t* list,
+                         int16_t x,
+                         int16_t y,
+                         int16_t width,
+                         int16_t height);
+
+bool GFX2DLIST_pop_clip(GFX2DLIST_instance_t* list);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // GFX2DLIST_J_H
+
+/*******************************************************************************
+ *
+ *  Ili9341 display module which utilizes the Gfx2d library and sends pixel
+ *  data through SPI DMA. Requires proper initialization and the service
+ *  routine to be called repeatedly after a new task request until the task
+ *  is completed.
+ *
+ ******************************************************************************/
+
+#ifndef ILI9XXX_J_H
+#define ILI9XXX_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The default timeout for chip select and unselect.
+ */
+
+#define ILI9341_CHIP_SELECT_TIMEOUT_uS    100000U
+
+/*******************************************************************************
+ *
+ * ILI9341_custom_command_t
+ *
+ * DESCRIPTION:
+ *  Custom command values which are used during the device initialization to
+ *  indicate certain behaviors. These values are either not found or not used
+ *  in the regular function of the device.
+ *
+ ******************************************************************************/
+
+typedef enum
+{
+  ILI9341_CUSTOM_COMMAND_END_OF_LIST      = 0x00,
+  ILI9341_CUSTOM_COMMAND_DELAY_MS         = 0xFF
+}
+ILI9341_custom_command_t;
+
+/*******************************************************************************
+ *
+ * ILI9341_flags_t
+ *
+ * DESCRIPTION:
+ *  Module flags.
+ *
+ * busy
+ *  Set when the module is busy with a task and cleared when the task is
+ *  completed.
+ *
+ * dma_busy
+ *  Set when the DMA is given data to load into the SPI transmit register.
+ *  Cleared in interrupt context when the DMA transfer is completed.
+ *
+ * reg_write
+ *  Set when the current task is a register write and cleared when the task is
+ *  a register read.
+ *
+ * single_segment
+ *  Set during initialization if the dispaly buffer is large enough to hold
+ *  the entire target display frame. This allows us to do some one-time
+ *  calculations during initialization and save time during the display update.
+ *
+ * task_state
+ *  State machine state.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t busy                          : 1;
+    uint8_t dma_busy                      : 1;
+    uint8_t reg_write                     : 1;
+    uint8_t single_segment                : 1;
+    uint8_t task_state                    : 4;
+  };
+}
+ILI9341_flags_t;
+
+/*******************************************************************************
+ *
+ * ILI9341_error_flags_t
+ *
+ * DESCRIPTION:
+ *  Module error flags.
+ *
+ * timeout
+ *  The maximum allowable time between receiving or transmitting the next data
+ *  element has passed.
+ *
+ * other
+ *  All other types of errors.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t timeout                       : 1;
+    uint8_t other                         : 1;
+    uint8_t reserved2                     : 6;
+  };
+}
+ILI9341_error_flags_t;
+
+/*******************************************************************************
+ *
+ * ILI9341_draw_handler_t
+ *
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called to render
+ *  the display buffer utilizing the GFX2D module.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
+ *
+ ******************************************************************************/
+
+typedef void (*ILI9341_draw_handler_t)(void);
+
+/*******************************************************************************
+ *
+ * ILI9341_pre_task_callback_t
+ *
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called when a new
+ *  task is accepted and initialized but before the task actually begins. This
+ *  allows the user to perform any last additional configurations before the
+ *  actual logic of the task begins.
+ *
+ * PARAMETERS:
+ *  context
+ *   User-provided context.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - YES
+ *
+ ******************************************************************************/
+
+typedef void (*ILI9341_pre_task_callback_t)(uint32_t);
+
+/*******************************************************************************
+ *
+ * ILI9341_post_task_callback_t
+ *
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called after a
+ *  task completes.
+ *
+ * PARAMETERS:
+ *  context
+ *   User-provided context.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - YES
+ *
+ ******************************************************************************/
+
+typedef void (*ILI9341_post_task_callback_t)(uint32_t);
+
+/*******************************************************************************
+ *
+ * ILI9341_hal_set_chip_select_t
+ *
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will enable or disable the device chip select. A boolean return is
+ *  provided to allow more iteration time to select/unselect the chip. This
+ *  function will continue to be called until true is returned.
+ *
+ * PARAMETERS:
+ *  enable
+ *   True to select the device, else, false.
+ *
+ * RETURN:
+ *  True if the chip selection was completed, else, false.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
+ *
+ ******************************************************************************/
+
+typedef bool (*ILI9341_hal_set_chip_select_t)(bool);
+
+/*******************************************************************************
+ *
+ * ILI9341_hal_set_dc_select_t
+ *
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will set the data-command line. (generally data:1, command:0).
+ *
+ * PARAMETERS:
+ *  enable
+ *   True to enable data mode, else, false to enable command mode.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
+ *
+ *  I had considered making this a boolean return to allow "slow" setting of
+ *  the data/command select, but ultimately decided against it. While the
+ *  chip select is only triggered at the start and end of a transaction, the
+ *  DC is triggered throughout the transaction - it really should have a GPIO,
+ *  or something equivalent, assigned to drive it.
+ *
+ *
+ ******************************************************************************/
+
+typedef void (*ILI9341_hal_set_dc_select_t)(bool);
+
+/*******************************************************************************
+ *
+ * ILI9341_hal_configure_dma_t
+ *
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will configure and start the DMA transfer for pixel data.
+ *
+ * PARAMETERS:
+ *  src_addr
+ *   Starting address of the pixel buffer.
+ *
+ *  src_length
+ *   Length of the source buffer in bytes.
+ *
+ * RETURN:
+ *  True if the configuration was successful and started, else, false.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
+ *
+ ******************************************************************************/
+
+typedef bool (*ILI9341_hal_configure_dma_t)(void*, uint32_t);
+
+/*******************************************************************************
+ *
+ * ILI9341_hal_disable_dma_t
+ *
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will disable the DMA.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
+ *
+ ******************************************************************************/
+
+typedef void (*ILI9341_hal_disable_dma_t)(void);
+
+/*******************************************************************************
+ *
+ * ILI9341_instance_t
+ *
+ * DESCRIPTION:
+ *  Instance data and function pointers.
+ *
+ * flags
+ *  Module flags.
+ *
+ * errors
+ *  Errors which occurred in the last transaction.
+ *
+ * gfx2d
+ *  User-provided initialized instance of a GFX2D.
+ *
+ * utimer
+ *  User-provided initialized instance of a UTIMER.
+ *
+ * spi
+ *  User-provided initialized instance of a SERSPI.
+ *
+ * utimer_ticket
+ *  Data structure used with the UTIMER instance.
+ *
+ * bus_mutex
+ *  User-provided initialized instance of a BUSMUTEX.
+ *
+ * bus_id
+ *  The BUS ID associated with the BUSMUTEX instance.
+ *
+ * render_y0
+ *  Keeps track of the last rendered y-offset.
+ *
+ * render_rows
+ *  The number of rows starting from render_y0 which are buffered and sent to
+ *  the display in a single rendering iteration.
+ *
+ * render_page_buffer
+ *  Holds the register and parameters for setting the starting page/row.
+ *
+ * display_adjust_y
+ *  Adjusts the column and row starting and ending positions. (This is used for
+ *  cheap screens which may not be properly aligned within their frames).
+ *
+ * reg_address
+ *  Register address to read/write in register rw task.
+ *
+ * reg_buffer
+ *  Buffer which holds the value to write to the register or will hold the
+ *  value read from the register in a register rw task.
+ *
+ * reg_length
+ *  Length of the reg_buffer.
+ *
+ * chip_select_timeout_us
+ *  The time allowed for the chip select to complete before aborting. The value
+ *  is initialized to the defined default, but can be directly modified by the
+ *  user.
+ *
+ * dma_bytes_per_transfer
+ *  The maximum number of bytes which can be sent in a single DMA transaction.
+ *
+ * dma_transfer_timeout_us
+ *  The timeout allowed for the DMA transfer to complete before giving up.
+ *
+ * dma_transfer_counter
+ *  The number of bytes which have been transferred by the DMA.
+ *
+ * dma_transfer_count
+ *  The total number of bytes which need to be transferred by the DMA.
+ *
+ * dma_transfer_last_packet_length
+ *  The length, in bytes, of the last data packet which will be transmitted by
+ *  the DMA. This is calculated early on to avoid repetitive math during the
+ *  transaction process.
+ *
+ * dma_src_buffer_offset
+ *  Offset into the source buffer which is being transmitted by DMA.
+ *
+ * callback_context
+ *  Context passed into the user pre/post operation callbacks.
+ *
+ * service_handler
+ *  Function pointer to the service routine applicable to the initialized
+ *  service mode.
+ *
+ * draw_handler
+ *  See ILI9341_draw_handler_t
+ *
+ * *_task_*
+ * *_hal_*
+ *  User-provided functions. See typedef comments.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  volatile ILI9341_flags_t flags;
+  ILI9341_error_flags_t errors;
+  GFX2D_instance_t* gfx2d;
+  UTIMER_instance_t* utimer;
+  SERSPI_instance_t* spi;
+  UTIMER_ticket_t utimer_ticket;
+  BUSMUTEX_instance_t* bus_mutex;
+  BUSMUTEX_bus_id_t bus_id;
+  uint16_t render_y0;
+  uint16_t render_rows;
+  uint8_t render_page_buffer[4];
+  int8_t display_adjust_y;
+  uint8_t reg_address;
+  void* reg_buffer;
+  uint32_t reg_length;
+  uint32_t chip_select_timeout_us;
+  uint32_t dma_bytes_per_transfer;
+  uint32_t dma_transfer_timeout_us;
+  uint32_t dma_transfer_counter;
+  uint32_t dma_transfer_count;
+  uint32_t dma_transfer_last_packet_length;
+  uint32_t dma_src_buffer_offset;
+  uint32_t callback_context;
+  bool (*service_handler)(void* instance);
+  ILI9341_draw_handler_t draw_handler;
+  ILI9341_pre_task_callback_t pre_task_callback;
+  ILI9341_post_task_callback_t post_task_callback;
+  ILI9341_hal_set_chip_select_t set_chip_select;
+  ILI9341_hal_set_dc_select_t set_dc_select;
+  ILI9341_hal_configure_dma_t configure_dma;
+  ILI9341_hal_disable_dma_t disable_dma;
+}
+ILI9341_instance_t;
+
+/*******************************************************************************
+ *
+ * ILI9341_dma_transfer_complete_handler
+ *
+ * DESCRIPTION:
+ *  Handler for the DMA transfer complete interrupt. The user code must call
+ *  this function from their DMA transfer complete ISR.
+ *
+ * IMPORTANT:
+ *  The user MUST ensure that the DMA transmission complete interrupt is
+ *  enabled and that this handler is called from that ISR.
+ *
+ ******************************************************************************/
+
+void ILI9341_dma_transfer_complete_handler(ILI9341_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * ILI9341_initialize
+ *
+ * DESCRIPTION:
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
+ *
+ * PARAMETERS:
+ *  See ILI9341_instance_t.
+ *
+ ******************************************************************************/
+
+void ILI9341_initialize(ILI9341_instance_t* instance,
+                        GFX2D_instance_t* gfx2d,
+                        UTIMER_instance_t* utimer,
+                        SERSPI_instance_t* spi,
+                        BUSMUTEX_instance_t* bus_mutex,
+                        BUSMUTEX_bus_id_t bus_id,
+                        uint32_t dma_bytes_per_transfer,
+                        uint32_t dma_transfer_timeout_us,
+                        ILI9341_draw_handler_t draw_handler,
+                        ILI9341_pre_task_callback_t pre_task_callback,
+                        ILI9341_post_task_callback_t post_task_callback,
+                        ILI9341_hal_set_chip_select_t set_chip_select,
+                        ILI9341_hal_set_dc_select_t set_dc_select,
+                        ILI9341_hal_configure_dma_t configure_dma,
+                        ILI9341_hal_disable_dma_t disable_dma);
+
+/*******************************************************************************
+ *
+ * ILI9341_configure_display
+ *
+ * DESCRIPTION:
+ *  Sends a series of commands to the display to initialize it and turn it on.
+ *  The passed in array must follow a special format which indicates the
+ *  commands and arguments to send. The format is as follows:
+ *
+ *    <command>, <arg_count>, <...arguments...>,
+ *
+ *  If the argument count is 0 then the arguments field is omitted. Additional
+ *  custom commands can be found in ILI9341_custom_command_t. The delay command
+ *  takes a single argument, which represents the number of milliseconds to
+ *  delay, which takes the place of the arg_count field. Eg.
+ *
+ *    <delay_command>, <ms>,
+ *
+ *  The user must terminate the list with a 0x00 command.
+ *
+ *    <0x00>
+ *
+ *  This command is expected to be called soon after system initialization. To
+ *  keep things simple, this function will block until the configuration is
+ *  completed.
+ *
+ * PARAMETERS:
+ *  command_list
+ *   List of bytes which follow the sequence described above.
+ *
+ * NOTES:
+ *  Included part of the command_list should be commands 0x2A and 0x2B which
+ *  set the draw matrix on the display. For this library, the user should
+ *  set the matrix to be the entire screen area. For example, a 128 by 160
+ *  screen might look like this:
+ *    0x2A, 4, 0x00, 0x00, 0x00, 0x7F,
+ *    0x2B, 4, 0x00, 0x00, 0x00, 0x9F,
+ *
+ ******************************************************************************/
+
+void ILI9341_configure_display(ILI9341_instance_t* instance, const uint8_t* command_list);
+
+/*******************************************************************************
+ *
+ * ILI9341_begin_new_register_write
+ *
+ * DESCRIPTION:
+ *  Attempts to begin a new register write task.
+ *
+ * PARAMETERS:
+ *  reg_address
+ *   The register address or access code.
+ *
+ *  buffer
+ *   The buffer which holds the value to be written to the register.
+ *
+ *  length
+ *   The length, in bytes, of the buffer (number of bytes to write).
+ *
+ * RETURN:
+ *  True if the task request was accepted, else, false.
+ *
+ ******************************************************************************/
+
+bool ILI9341_begin_new_register_write(ILI9341_instance_t* instance,
+                                      uint8_t reg_address,
+                                      void* buffer,
+                                      uint32_t length);
+
+/*******************************************************************************
+ *
+ * ILI9341_begin_new_register_read
+ *
+ * DESCRIPTION:
+ *  Attempts to begin a new register read task.
+ *
+ * PARAMETERS:
+ *  reg_address
+ *   The register address or access code.
+ *
+ *  buffer
+ *   The buffer which will hold the value read from the register.
+ *
+ *  length
+ *   The length, in bytes, of the buffer (number of bytes to write).
+ *
+ * RETURN:
+ *  True if the task request was accepted, else, false.
+ *
+ ******************************************************************************/
+
+bool ILI9341_begin_new_register_read(ILI9341_instance_t* instance,
+                                     uint8_t reg_address,
+                                     void* buffer,
+                                     uint32_t length);
+
+/*******************************************************************************
+ *
+ * ILI9341_begin_new_display_update
+ *
+ * DESCRIPTION:
+ *  Attempts to begin a new display update task.
+ *
+ * RETURN:
+ *  True if the task request was accepted, else, false.
+ *
+ ******************************************************************************/
+
+bool ILI9341_begin_new_display_update(ILI9341_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * ILI9341_service
+ *
+ * DESCRIPTION:
+ *  Services the task state machine. Must be called repeatedly until the task
+ *  is completed.
+ *
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true.
+ *
+ ******************************************************************************/
+
+bool ILI9341_service(ILI9341_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * ILI9341_is_busy
+ *
+ * DESCRIPTION:
+ *  Determines if an instance is currently busy with a task.
+ *
+ * RETURN:
+ *  True if the instance is busy with a task, else, false.
+ *
+ ******************************************************************************/
+
+bool ILI9341_is_busy(ILI9341_instance_t* instance);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // ILI9XXX_J_H
+
+/*******************************************************************************
+ *
+ *  RGB LED module which supports off, on, pattern, and ramping modes. Requires
+ *  proper initialization and the service routine to be called periodically.
+ *
+ ******************************************************************************/
+
+#ifndef RGB_J_H
+#define RGB_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Helper pre-compile function for creating a OFF 64-bit UI code.
+ */
+
+#define RGB_MODE_OFF_UI_CODE()            0ULL
+
+/*
+ * Helper pre-compile function for creating a ON 64-bit UI code with the use
+ * of an palette index -- compare to RGB_led_mode_on_ui_t for the bit field
+ * locations.
+ */
+
+#define RGB_MODE_ON_PALETTE_UI_CODE(RGB_ARG_PALETTE_INDEX) \
+(                                           \
+  0ULL                                    | \
+  (uint64_t)RGB_ARG_PALETTE_INDEX << 32U  | \
+  1ULL << 40U                               \
+)
+
+/*
+ * Helper pre-compile function for creating a ON 64-bit UI code with the use
+ * of an RGB color-- compare to RGB_led_mode_on_ui_t for the bit field
+ * locations.
+ */
+
+#define RGB_MODE_ON_COLOR_UI_CODE(RGB_ARG_RED, RGB_ARG_GREEN, RGB_ARG_BLUE) \
+(                                           \
+  0ULL                                    | \
+  (uint64_t)RGB_ARG_RED << 0U             | \
+  (uint64_t)RGB_ARG_GREEN << 8U           | \
+  (uint64_t)RGB_ARG_BLUE << 16U             \
+)
+
+/*
+ * Helper pre-compile function for creating a PATTERN 64-bit UI code -- compare
+ * to RGB_led_mode_pattern_ui_t for the bit field locations.
+ */
+
+#define RGB_MODE_PATTERN_UI_CODE(RGB_ARG_PATTERN, RGB_ARG_PHASES,     \
+                                 RGB_ARG_DIVISOR, RGB_ARG_ITERATIONS, \
+                                 RGB_ARG_FORCE_SYNC)                  \
+(                                           \
+  0ULL                                    | \
+  (uint64_t)RGB_ARG_PHASES << 0U          | \
+  (uint64_t)RGB_ARG_DIVISOR << 4U         | \
+  (uint64_t)RGB_ARG_FORCE_SYNC << 7U      | \
+  (uint64_t)RGB_ARG_ITERATIONS << 8U      | \
+  (uint64_t)RGB_ARG_PATTERN << 16U          \
+)
+
+/*
+ * Helper pre-compile function for creating a RAMP 64-bit UI code -- compare to
+ * RGB_led_mode_ramp_ui_t for the bit field locations.
+ */
+
+#define RGB_MODE_RAMP_UI_CODE(RGB_ARG_PALETTE_START, RGB_ARG_PALETTE_END,  \
+                              RGB_ARG_ITERATIONS, RGB_ARG_START_DELAY,     \
+                              RGB_ARG_UP, RGB_ARG_UP_HOLD,                 \
+                              RGB_ARG_DOWN, RGB_ARG_DOWN_HOLD)             \
+(                                           \
+  0ULL                                    | \
+  (uint64_t)RGB_ARG_PALETTE_START << 0U   | \
+  (uint64_t)RGB_ARG_PALETTE_END << 4U     | \
+  (uint64_t)RGB_ARG_ITERATIONS << 8U      | \
+  (uint64_t)RGB_ARG_START_DELAY << 16U    | \
+  (uint64_t)RGB_ARG_UP << 24U             | \
+  (uint64_t)RGB_ARG_UP_HOLD << 32U        | \
+  (uint64_t)RGB_ARG_DOWN << 40U           | \
+  (uint64_t)RGB_ARG_DOWN_HOLD << 48U        \
+)
+
+/*
+ * Instances of the RGB module are meant to be serviced periodically at a set
+ * interval - generally serviced by the system tick interrupt. The default
+ * value defined here is ideal for a 1-ms periodic tick as it divides the
+ * pattern phases somewhat evenly across 1-second. (1000 / 12) = 83.333 The
+ * user can adjust the variable value to speed up or slow down the pattern
+ * and ramp animations.
+ */
+
+#define RGB_TICKS_PER_QUANTA_DEFAULT      83U
+
+/*
+ * The individual patterns of each LED are kept somewhat synchronous with each
+ * other in an single instance by a instance-level step-counter. There are 12-
+ * steps in a single instance period - each step is measured as a single
+ * quanta which is defined by a tick count which is incremented each time the
+ * instance service routine is called.
+ */
+
+#define RGB_PATTERN_STEPS_PER_PERIOD      12U
+
+/*
+ * The maximum pattern length, or phases, that a single LED can have. While
+ * this value is the same as RGB_PATTERN_STEPS_PER_PERIOD, it is not treated
+ * the same. Depending on the pattern divisor, a single iteration of the
+ * pattern may or may not last longer than the instance period.
+ */
+
+#define RGB_PATTERN_MAX_LENGTH            12U
+
+/*
+ * In PATTERN and RAMP modes, an iteration value of 0 means that the animation
+ * should run forever.
+ */
+
+#define RGB_INFINITE_ITERATIONS           0U
+
+/*
+ * Number of bits which compose the semaphore flag and associated maximum value
+ * of the semaphore.
+ */
+
+#define RGB_SEMAPHORE_BIT_LENGTH          8U
+#define RGB_SEMAPHORE_MAX_VALUE           ((1 << RGB_SEMAPHORE_BIT_LENGTH) - 1)
+
+/*******************************************************************************
+ *
+ * RGB_led_color_t
+ *
+ * DESCRIPTION:
+ *  A 24-bit color is composed of a red, green, and blue intensity. Intensities
+ *  will range from 0 to 255 (8-bits each).
+ *
+ * red
+ *  The red intensity.
+ *
+ * green
+ *  The green intensity.
+ *
+ * blue
+ *  The blue intensity.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint32_t all;
+  struct
+  {
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+    uint8_t reserved;
+  };
+}
+RGB_led_color_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_color_hr_t
+ *
+ * DESCRIPTION:
+ *  In ramping mode, the interpolation between colors can be very subtle such
+ *  that several quanta is needed to increment to the next ramp value in the
+ *  range of 0 to 255. To simplify the math and keep track of the progress of
+ *  the interpolation, the color intensities can be stored as 24-bit values.
+ *  (We do not want to use the full 32-bits to avoid overflow during the math
+ *  operations for interpolation -- besides, 24-bit resolution is high enough
+ *  and may require less work than 31-bit.)
+ *
+ * red
+ *  The red intensity in high-resolution 24-bit format.
+ *
+ * green
+ *  The green intensity in high-resolution 24-bit format.
+ *
+ * blue
+ *  The blue intensity in high-resolution 24-bit format.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  int32_t red;
+  int32_t green;
+  int32_t blue;
+}
+RGB_led_color_hr_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_mode_id_t
+ *
+ * DESCRIPTION:
+ *  An LED can be in one of 4-modes: OFF, ON, PATTERN, and RAMP.
+ *
+ ******************************************************************************/
+
+typedef enum
+{
+  RGB_LED_MODE_ID_OFF                     = 0,
+  RGB_LED_MODE_ID_ON,
+  RGB_LED_MODE_ID_PATTERN,
+  RGB_LED_MODE_ID_RAMP
+}
+RGB_led_mode_id_t;
+
+/*******************************************************************************
+ *
+ * RGB_pattern_divisor_t
+ *
+ * DESCRIPTION:
+ *  A pattern iteration can be slowed down by setting the divisor. The divisor
+ *  must be able to evenly divide the number of steps in a pattern period.
+ *  Hence, the allowed divisors are /1, /2, /3, /4, /6, /12. A truth table
+ *  will be used on each pattern handler phase to check if the next phase of
+ *  the LED pattern should become active based upon the instance pattern step.
+ *
+ ******************************************************************************/
+
+typedef enum
+{
+  RGB_PATTERN_DIVISOR_1                   = 0,
+  RGB_PATTERN_DIVISOR_2,
+  RGB_PATTERN_DIVISOR_3,
+  RGB_PATTERN_DIVISOR_4,
+  RGB_PATTERN_DIVISOR_6,
+  RGB_PATTERN_DIVISOR_12,
+  RGB_PATTERN_DIVISOR_COUNT
+}
+RGB_pattern_divisor_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_palette_slot_t
+ *
+ * DESCRIPTION:
+ *  Referring to an painter palette which provides quick access to working
+ *  colors, each LED will have its own palette of customizable colors. The
+ *  palette slot count is purposefully capped at 16 so that it a single palette
+ *  index can be packed into 4-bits. To save memory space, the first several
+ *  slots are shared amongst all the LEDs in the instance. The last few are
+ *  unique for each LED.
+ *
+ * NOTE:
+ *  The number of shared slots may be reduced by moving the position of
+ *  RGB_LED_PALETTE_SHARED_COUNT. Checks are already in place to properly
+ *  handle the palette index based upon shared versus unique palette.
+ *
+ ******************************************************************************/
+
+typedef enum
+{
+  RGB_LED_PALETTE_SLOT_0                  = 0,
+  RGB_LED_PALETTE_SLOT_1                  = 1,
+  RGB_LED_PALETTE_SLOT_2                  = 2,
+  RGB_LED_PALETTE_SLOT_3                  = 3,
+  RGB_LED_PALETTE_SLOT_4                  = 4,
+  RGB_LED_PALETTE_SLOT_5                  = 5,
+  RGB_LED_PALETTE_SLOT_6                  = 6,
+  RGB_LED_PALETTE_SLOT_7                  = 7,
+  RGB_LED_PALETTE_SLOT_8                  = 8,
+  RGB_LED_PALETTE_SLOT_9                  = 9,
+  RGB_LED_PALETTE_SLOT_A                  = 10,
+  RGB_LED_PALETTE_SLOT_B                  = 11,
+  RGB_LED_PALETTE_SHARED_COUNT,
+  RGB_LED_PALETTE_SLOT_C                  = 12,
+  RGB_LED_PALETTE_SLOT_D                  = 13,
+  RGB_LED_PALETTE_SLOT_E                  = 14,
+  RGB_LED_PALETTE_SLOT_F                  = 15,
+  RGB_LED_PALETTE_SLOT_COUNT,
+  RGB_LED_PALETTE_UNIQUE_COUNT            = (RGB_LED_PALETTE_SLOT_COUNT -
+                                             RGB_LED_PALETTE_SHARED_COUNT)
+}
+RGB_led_palette_slot_t;
+
+/*******************************************************************************
+ *
+ * RGB_shared_palette_t
+ *
+ * DESCRIPTION:
+ *  The palette which is shared with all the LEDs in a single instance.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  RGB_led_color_t slots[RGB_LED_PALETTE_SHARED_COUNT];
+}
+RGB_shared_palette_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_palette_t
+ *
+ * DESCRIPTION:
+ *  The palette which is unique to each LED in the instance.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  RGB_led_color_t slots[RGB_LED_PALETTE_UNIQUE_COUNT];
+}
+RGB_led_palette_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_mode_on_ui_t
+ *
+ * DESCRIPTION:
+ *  User-interface values for the ON mode.
+ *
+ * red
+ *  Red color intensity.
+ *
+ * green
+ *  Green color intensity.
+ *
+ * blue
+ *  Blue color intensity.
+ *
+ * palette
+ *  RGB output color as described by a palette color slot.
+ *
+ * use_palette
+ *  Flag indicating if the palette value should be used (true), or if the
+ *  32-bit RGB color should be used.
+ *
+ * NOTES:
+ *  The red, green, and blue values were taken out of the rgb_led_color
+ *  structure context to guard against Endianess in bit-shifting.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint64_t all;
+  struct
+  {
+    uint64_t red                          : 8;
+    uint64_t green                        : 8;
+    uint64_t blue                         : 8;
+    uint64_t reserved24                   : 8;
+    uint64_t palette                      : 4;
+    uint64_t reserved36                   : 4;
+    uint64_t use_palette                  : 1;
+    uint64_t reserved41                   : 7;
+    uint64_t reserved48                   : 16;
+  };
+}
+RGB_led_mode_on_ui_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_mode_on_t
+ *
+ * DESCRIPTION:
+ *  Internal working variables for the ON mode including the UI subset.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  RGB_led_mode_on_ui_t ui;
+}
+RGB_led_mode_on_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_mode_pattern_ui_t
+ *
+ * DESCRIPTION:
+ *  User-interface values for the PATTERN mode.
+ *
+ * phases
+ *  Length of, or number of phases (4-bit palette colors), in the pattern value.
+ *
+ * divisor
+ *  Divides the pattern phase rate by RGB_pattern_divisor_t.
+ *
+ * force_sync
+ *  Forces the instance pattern step to reset to step-0, thus causing any new
+ *  pattern(s) to start immediately. Otherwise, new pattern(s) will not begin
+ *  until the instance pattern step reaches step-0.
+ *
+ * iterations
+ *  Number of times to repeat the pattern. Value 0 indicates repeat forever.
+ *
+ * pattern
+ *  Up to 12-phases defined by palette slot colors at 4-bits each. For example,
+ *  a pattern that traverses from palette slots 0 -> 1 -> 2 -> 3 would be
+ *  0x3210.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint64_t all;
+  struct
+  {
+    uint64_t phases                       : 4;
+    uint64_t divisor                      : 3;
+    uint64_t force_sync                   : 1;
+    uint64_t iterations                   : 8;
+    uint64_t pattern                      : 48;
+  };
+}
+RGB_led_mode_pattern_ui_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_mode_pattern_t
+ *
+ * DESCRIPTION:
+ *  Internal working variables for the PATTERN mode including the UI subset.
+ *
+ * working_pattern
+ *  Pattern which originally gets set to the pattern value and then is shifted
+ *  by 4-bits at each new phase in the LED pattern.
+ *
+ * phase_counter
+ *  Keeps track of the number of pattern phases of the LED pattern which have
+ *  passed.
+ *
+ * iteration_counter
+ *  Keeps track of the number of times the pattern has repeated.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  RGB_led_mode_pattern_ui_t ui;
+  uint64_t working_pattern;
+  uint8_t phase_counter;
+  uint8_t iteration_counter;
+}
+RGB_led_mode_pattern_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_mode_ramp_ui_t
+ *
+ * DESCRIPTION:
+ *  User-interface values for the RAMP mode.
+ *
+ * palette_start
+ *  Starting color for the ramp-up and hold value for the ramp_down_hold.
+ *
+ * palette_end
+ *  Starting color for the ramp-down and hold value for the ramp_up_hold.
+ *
+ * iterations
+ *  Number of times to repeat the ramp. Value 0 indicates repeat forever.
+ *
+ * start_delay_quanta
+ *  Quanta to wait before starting the ramp-up. This delay is only done once on
+ *  the first iteration of the ramp.
+ *
+ * ramp_up_quanta
+ *  Quanta to ramp-up from the start to end colors.
+ *
+ * ramp_up_hold_quanta
+ *  Quanta to hold the palette_end color after the ramp-up.
+ *
+ * ramp_down_quanta
+ *  Quanta to ramp-down from the end to start colors.
+ *
+ * ramp_down_hold_quanta
+ *  Quanta to hold the palette_start color after the ramp-down.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint64_t all;
+  struct
+  {
+    uint64_t palette_start                : 4;
+    uint64_t palette_end                  : 4;
+    uint64_t iterations                   : 8;
+    uint64_t start_delay_quanta           : 8;
+    uint64_t ramp_up_quanta               : 8;
+    uint64_t ramp_up_hold_quanta          : 8;
+    uint64_t ramp_down_quanta             : 8;
+    uint64_t ramp_down_hold_quanta        : 8;
+    uint64_t reserved56                   : 8;
+  };
+}
+RGB_led_mode_ramp_ui_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_mode_ramp_t
+ *
+ * DESCRIPTION:
+ *  Internal working variables for the RAMP mode including the UI subset.
+ *
+ * hres_start
+ *  High resolution equivalent of the start color.
+ *
+ * hres_end
+ *  High resolution equivalent of the end color.
+ *
+ * hres_color
+ *  High resolution equivalent of the current output color.
+ *
+ * hres_step_up
+ *  Interpolation step between the start and end colors during each ramp-up
+ *  tick.
+ *
+ * hres_step_down
+ *  Interpolation step between the end and start colors during each ramp-down
+ *  tick.
+ *
+ * iteration_counter
+ *  Keeps track of the number of times the ramp has repeated.
+ *
+ * tick_counter
+ *  Keeps track of the number of times the ramp service has been called.
+ *
+ * quanta_counter
+ *  Keeps track of the number of quanta (N ticks in a quanta) which have
+ *  passed. This value is compared to the various ramp quanta timing values
+ *  and is reset to 0 at the start of each new ramping state.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  RGB_led_mode_ramp_ui_t ui;
+  RGB_led_color_hr_t hres_start;
+  RGB_led_color_hr_t hres_end;
+  RGB_led_color_hr_t hres_color;
+  RGB_led_color_hr_t hres_step_up;
+  RGB_led_color_hr_t hres_step_down;
+  uint8_t iteration_counter;
+  uint8_t tick_counter;
+  uint8_t quanta_counter;
+}
+RGB_led_mode_ramp_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_mode_t
+ *
+ * DESCRIPTION:
+ *  Union of the LED modes to save memory space - each LED can only be in
+ *  one mode at a time.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  RGB_led_mode_on_t on;
+  RGB_led_mode_pattern_t pattern;
+  RGB_led_mode_ramp_t ramp;
+}
+RGB_led_mode_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_mode_flags_t
+ *
+ * DESCRIPTION:
+ *  Additional flags related to the LED mode.
+ *
+ * mode
+ *  Current mode of the LED, RGB_led_mode_id_t.
+ *
+ * busy
+ *  Set true when the LED is performing a finite animation and automatically set
+ *  false when that animation finishes. The OFF, ON, and infinite patterns or
+ *  ramps will keep this flag false.
+ *
+ * repeat_forever
+ *  Indicates that the pattern or ramp should repeat forever.
+ *
+ * new_pattern
+ *  Indicates that the LED in pattern mode has a new pattern and should wait
+ *  for the first global pattern phase to activate.
+ *
+ * ramp_state
+ *  State of the ramp state machine, RGB_ramp_state_t.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t mode                          : 3;
+    uint8_t busy                          : 1;
+    uint8_t repeat_forever                : 1;
+    uint8_t new_pattern                   : 1;
+    uint8_t ramp_state                    : 3;
+  };
+}
+RGB_led_mode_flags_t;
+
+/*******************************************************************************
+ *
+ * RGB_led_t
+ *
+ * DESCRIPTION:
+ *  RGB LED settings and data variable collection.
+ *
+ * flags
+ *  Mode flags.
+ *
+ * data
+ *  Mode data variables.
+ *
+ * palette
+ *  Unique customizable palette for the LED.
+ *
+ * output
+ *  The final generated RGB output of the LED.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  RGB_led_mode_flags_t flags;
+  RGB_led_mode_t data;
+  RGB_led_palette_t palette;
+  RGB_led_color_t output;
+}
+RGB_led_t;
+
+/*******************************************************************************
+ *
+ * RGB_flags_t
+ *
+ * DESCRIPTION:
+ *  Module flags.
+ *
+ * halt_semaphore
+ *  Provides a way to halt the service of pattern and ramp LEDs. This allows
+ *  the user to prepare all the LEDs to their liking and then un-halt the
+ *  instance and allow the LEDs to begin their animations at the same time.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t halt_semaphore                : RGB_SEMAPHORE_BIT_LENGTH;
+  };
+}
+RGB_flags_t;
+
+/*******************************************************************************
+ *
+ * RGB_instance_t
+ *
+ * DESCRIPTION:
+ *  Instance data and function pointers.
+ *
+ * flags
+ *  Module flags.
+ *
+ * ticks_per_quanta
+ *  A tick is defined as an entry into the service routine, which routine is
+ *  meant to be called periodically. After every N-ticks, the quanta counter
+ *  is incremented. When initialized, the value will be set to the default
+ *  RGB_TICKS_PER_QUANTA_DEFAULT.
+ *
+ * pattern_step_counter
+ *  Keeps track of the instance pattern step. Incremented at the start of a
+ *  new quanta and reset to 0 after the 12th quanta.
+ *
+ * pattern_tick_counter
+ *  Keeps track of the instance pattern tick counter. Every N-ticks will
+ *  increment the pattern_step_counter.
+ *
+ * palette
+ *  The shared color palette for all LEDs in the instance.
+ *
+ * led_count
+ *  Number of RGB LEDs in the instance led_list.
+ *
+ * led_list
+ *  List of RGB LEDs.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  RGB_flags_t flags;
+  uint8_t ticks_per_quanta;
+  uint8_t pattern_step_counter;
+  uint8_t pattern_tick_counter;
+  RGB_shared_palette_t palette;
+  uint32_t led_count;
+  RGB_led_t* led_list;
+}
+RGB_instance_t;
+
+/*******************************************************************************
+ *
+ * RGB_initialize
+ *
+ * DESCRIPTION:
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
+ *
+ * PARAMETERS:
+ *  See RGB_instance_t.
+ *
+ ******************************************************************************/
+
+void RGB_initialize(RGB_instance_t* instance,
+                    RGB_led_t* led_list,
+                    uint32_t led_count);
+
+/*******************************************************************************
+ *
+ * RGB_set_ticks_per_quanta
+ *
+ * DESCRIPTION:
+ *  Sets the instance ticks per quanta value. Decreasing the tick value will
+ *  speed up the pattern and ramp animations, and increasing the tick value
+ *  will slow the animations down.
+ *
+ * PARAMETERS:
+ *  ticks
+ *   Value ranging from 0-255. A value of 0 will cause the default value to
+ *   be written.
+ *
+ ******************************************************************************/
+
+void RGB_set_ticks_per_quanta(RGB_instance_t* instance, uint8_t ticks);
+
+/*******************************************************************************
+ *
+ * RGB_halt_semaphore_increment
+ *
+ * DESCRIPTION:
+ *  Increases the halt semaphore count by 1. The halt semaphore enables/
+ *  disables the instance from servicing. This allows for a momentary hold
+ *  while LEDs are synchronized so that the animations of all LEDs in the
+ *  instance can all begin together. LED servicing will only run when the
+ *  semaphore count is 0.
+ *
+ ******************************************************************************/
+
+void RGB_halt_semaphore_increment(RGB_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * RGB_halt_semaphore_decrement
+ *
+ * DESCRIPTION:
+ *  Decreases the halt semaphore count by 1. The halt semaphore enables/
+ *  disables the instance from servicing. This allows for a momentary hold
+ *  while LEDs are synchronized so that the animations of all LEDs in the
+ *  instance can all begin together. LED servicing will only run when the
+ *  semaphore count is 0.
+ *
+ ******************************************************************************/
+
+void RGB_halt_semaphore_decrement(RGB_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * RGB_set_palette_slot_color
+ *
+ * DESCRIPTION:
+ *  Sets the RGB color of a palette slot.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED palette. This is not applicable and can be set as 0 if
+ *   the palette index is within the shared instance palette.
+ *
+ *  palette_index
+ *   Index of the palette slot. The index is analyzed to determine if the
+ *   palette slot is within the shared or unique LED palette.
+ *
+ *  red, green, blue
+ *   Color intensities.
+ *
+ ******************************************************************************/
+
+void RGB_set_palette_slot_color(RGB_instance_t* instance,
+                                uint32_t led_index,
+                                uint8_t palette_index,
+                                uint8_t red,
+                                uint8_t green,
+                                uint8_t blue);
+
+/*******************************************************************************
+ *
+ * RGB_get_palette_slot_color
+ *
+ * DESCRIPTION:
+ *  Gets the RGB color of a palette slot.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED palette. This is not applicable and can be set as 0 if
+ *   the palette index is within the shared instance palette.
+ *
+ *  palette_index
+ *   Index of the palette slot. The index is analyzed to determine if the
+ *   palette slot is within the shared or unique LED palette.
+ *
+ * RETURN:
+ *  The RGB color of the palette slot.
+ *
+ ******************************************************************************/
+
+RGB_led_color_t RGB_get_palette_slot_color(RGB_instance_t* instance,
+                                            uint32_t led_index,
+                                            uint8_t palette_index);
+
+/*******************************************************************************
+ *
+ * RGB_set_mode_off
+ *
+ * DESCRIPTION:
+ *  Sets the RGB LED into off mode, setting the output color to all 0's.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ ******************************************************************************/
+
+void RGB_set_mode_off(RGB_instance_t* instance, uint32_t led_index);
+
+/*******************************************************************************
+ *
+ * RGB_set_all_off
+ *
+ * DESCRIPTION:
+ *  Sets all RGB LEDs into off mode, setting the output color to all 0's.
+ *
+ ******************************************************************************/
+
+void RGB_set_all_off(RGB_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * RGB_set_mode_on
+ *
+ * DESCRIPTION:
+ *  Sets the RGB LED into on mode.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ *  ui
+ *   User-interface data subset.
+ *
+ ******************************************************************************/
+
+void RGB_set_mode_on(RGB_instance_t* instance,
+                     uint32_t led_index,
+                     RGB_led_mode_on_ui_t* ui);
+
+/*******************************************************************************
+ *
+ * RGB_set_mode_on_color
+ *
+ * DESCRIPTION:
+ *  Sets the RGB LED into on mode based on RGB color.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ *  red, green, blue
+ *   Color intensities.
+ *
+ ******************************************************************************/
+
+void RGB_set_mode_on_color(RGB_instance_t* instance,
+                           uint32_t led_index,
+                           uint8_t red,
+                           uint8_t green,
+                           uint8_t blue);
+
+/*******************************************************************************
+ *
+ * RGB_set_mode_on_palette
+ *
+ * DESCRIPTION:
+ *  Sets the RGB LED into on mode based on palette color.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ *  palette_index
+ *   Palette slot color.
+ *
+ ******************************************************************************/
+
+void RGB_set_mode_on_palette(RGB_instance_t* instance,
+                             uint32_t led_index,
+                             uint8_t palette_index);
+
+/*******************************************************************************
+ *
+ * RGB_set_mode_pattern
+ *
+ * DESCRIPTION:
+ *  Sets the RGB LED into pattern mode.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ *  ui
+ *   User-interface data subset.
+ *
+ ******************************************************************************/
+
+void RGB_set_mode_pattern(RGB_instance_t* instance,
+                          uint32_t led_index,
+                          RGB_led_mode_pattern_ui_t* ui);
+
+/*******************************************************************************
+ *
+ * RGB_set_mode_pattern_palette
+ *
+ * DESCRIPTION:
+ *  Sets the RGB LED into pattern mode.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ *  iterations
+ *   Number of times to repeat. Value 0 indicates repeat forever.
+ *
+ *  divisor
+ *   Divides the pattern phase rate by RGB_pattern_divisor_t.
+ *
+ *  pattern_phases
+ *   Length of, or number of phases (4-bit palette colors), in the pattern
+ *   value.
+ *
+ *  palette_pattern
+ *   Up to 12-phases defined by palette slot colors at 4-bits each. For example,
+ *   a pattern that traverses from palette slots 0 -> 1 -> 2 -> 3 would be
+ *   0x3210.
+ *
+ *  force_sync
+ *   Forces the instance pattern step to reset to step-0, thus causing any new
+ *   pattern(s) to start immediately. Otherwise, new pattern(s) will not begin
+ *   until the instance pattern step reaches step-0.
+ *
+ ******************************************************************************/
+
+void RGB_set_mode_pattern_palette(RGB_instance_t* instance,
+                                  uint32_t led_index,
+                                  uint32_t iterations,
+                                  RGB_pattern_divisor_t divisor,
+                                  uint8_t pattern_phases,
+                                  uint64_t palette_pattern,
+                                  bool force_sync);
+
+/*******************************************************************************
+ *
+ * RGB_set_mode_ramp
+ *
+ * DESCRIPTION:
+ *  Sets the RGB LED into ramping mode.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ *  ui
+ *   User-interface data subset.
+ *
+ ******************************************************************************/
+
+void RGB_set_mode_ramp(RGB_instance_t* instance,
+                       uint32_t led_index,
+                       RGB_led_mode_ramp_ui_t* ui);
+
+/*******************************************************************************
+ *
+ * RGB_set_mode_ramp_color
+ *
+ * DESCRIPTION:
+ *  Sets the RGB LED into ramping mode. The ramp is indicated by two RGB colors.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ *  iterations
+ *   Number of times to repeat. Value 0 indicates repeat forever.
+ *
+ *  start_delay_quanta
+ *   Quanta to wait before starting the ramp-up. This delay is only done once on
+ *   the first iteration of the ramp.
+ *
+ *  ramp_up_quanta
+ *   Quanta to ramp-up from the start to end colors.
+ *
+ *  ramp_up_hold_quanta
+ *   Quanta to hold the palette_end color after the ramp-up.
+ *
+ *  ramp_down_quanta
+ *   Quanta to ramp-down from the end to start colors.
+ *
+ *  ramp_down_hold_quanta
+ *   Quanta to hold the palette_start color after the ramp-down.
+ *
+ *  *_start
+ *   Ramp start color.
+ *
+ *  *_end
+ *   Ramp end color.
+ *
+ * NOTES:
+ *  The internal ramp data structure works with palette indices, not RGB color
+ *  values. Hence, when this method is used it will automatically overwrite the
+ *  last two palette slots with the start and end RGB colors specified.
+ *
+ ******************************************************************************/
+
+void RGB_set_mode_ramp_color(RGB_instance_t* instance,
+                             uint32_t led_index,
+                             uint32_t iterations,
+                             uint8_t start_delay_quanta,
+                             uint8_t ramp_up_quanta,
+                             uint8_t ramp_up_hold_quanta,
+                             uint8_t ramp_down_quanta,
+                             uint8_t ramp_down_hold_quanta,
+                             uint8_t red_start,
+                             uint8_t green_start,
+                             uint8_t blue_start,
+                             uint8_t red_end,
+                             uint8_t green_end,
+                             uint8_t blue_end);
+
+/*******************************************************************************
+ *
+ * RGB_set_mode_ramp_palette
+ *
+ * DESCRIPTION:
+ *  Sets the RGB LED into ramping mode. The ramp is indicated by palette slots.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ *  iterations
+ *   Number of times to repeat. Value 0 indicates repeat forever.
+ *
+ *  start_delay_quanta
+ *   Quanta to wait before starting the ramp-up. This delay is only done once on
+ *   the first iteration of the ramp.
+ *
+ *  ramp_up_quanta
+ *   Quanta to ramp-up from the start to end colors.
+ *
+ *  ramp_up_hold_quanta
+ *   Quanta to hold the palette_end color after the ramp-up.
+ *
+ *  ramp_down_quanta
+ *   Quanta to ramp-down from the end to start colors.
+ *
+ *  ramp_down_hold_quanta
+ *   Quanta to hold the palette_start color after the ramp-down.
+ *
+ *  palette_index_start
+ *   Palette index of the start color.
+ *
+ *  palette_index_end
+ *   Palette index of the end color
+ *
+ ******************************************************************************/
+
+void RGB_set_mode_ramp_palette(RGB_instance_t* instance,
+                               uint32_t led_index,
+                               uint32_t iterations,
+                               uint8_t start_delay_quanta,
+                               uint8_t ramp_up_quanta,
+                               uint8_t ramp_up_hold_quanta,
+                               uint8_t ramp_down_quanta,
+                               uint8_t ramp_down_hold_quanta,
+                               uint8_t palette_index_start,
+                               uint8_t palette_index_end);
+
+/*******************************************************************************
+ *
+ * RGB_service
+ *
+ * DESCRIPTION:
+ *  Services the RGB pattern and ramp animations. Intended to be called
+ *  periodically at a 1-ms interval. Every time this function is called the
+ *  internal tick counter is incremented - which is the basis for advancing
+ *  the ramp and pattern animations.
+ *
+ ******************************************************************************/
+
+void RGB_service(RGB_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * RGB_service_pattern
+ *
+ * DESCRIPTION:
+ *  Called from the service routine. Handles pattern-specific animations.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ * NOTES:
+ *  Helper function primarily called from RGB_service. Exposed here for
+ *  unit testing.
+ *
+ ******************************************************************************/
+
+void RGB_service_pattern(RGB_instance_t* instance, uint32_t led_index);
+
+/*******************************************************************************
+ *
+ * RGB_service_ramp
+ *
+ * DESCRIPTION:
+ *  Called from the service routine.Handles ramp-specific animations.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ * NOTES:
+ *  Helper function primarily called from RGB_service. Exposed here for
+ *  unit testing.
+ *
+ ******************************************************************************/
+
+void RGB_service_ramp(RGB_instance_t* instance, uint32_t led_index);
+
+/*******************************************************************************
+ *
+ * RGB_pattern_force_sync
+ *
+ * DESCRIPTION:
+ *  Forces the pattern phase step to restart at phase-0 on the next service
+ *  tick, causing new patterns to start immediately.
+ *
+ * NOTES:
+ *  Helper function primarily called from RGB_set_mode_pattern. Exposed here
+ *  for unit testing.
+ *
+ ******************************************************************************/
+
+void RGB_pattern_force_sync(RGB_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * RGB_pattern_tick_increment
+ *
+ * DESCRIPTION:
+ *  Called from the service routine. Increments the pattern tick counter which,
+ *  in-turn, may increment the phase counter.
+ *
+ * RETURN:
+ *  True if a new pattern phase has been reached and patterns need to be
+ *  serviced, else, false.
+ *
+ * NOTES:
+ *  Helper function primarily called from RGB_service. Exposed here for
+ *  unit testing.
+ *
+ ******************************************************************************/
+
+bool RGB_pattern_tick_increment(RGB_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * RGB_ramp_update_output
+ *
+ * DESCRIPTION:
+ *  Called from the ramp service routine. Translates the high-resolution ramp
+ *  working colors to the final 8-bit output colors.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance led_list.
+ *
+ * NOTES:
+ *  Helper function primarily called from RGB_service_ramp. Exposed here for
+ *  unit testing.
+ *
+ ******************************************************************************/
+
+void RGB_ramp_update_output(RGB_instance_t* instance, uint32_t led_index);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // RGB_J_H
+
+/*******************************************************************************
+ *
+ *  Configures and drives animations for RGB LEDs. Requires proper
+ *  initialization and the service routine to be called periodically.
+ *
+ ******************************************************************************/
+
+#ifndef LED_ANIMATION_J_H
+#define LED_ANIMATION_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ *
+ * LEDANIMATION_entry_flags_t
+ *
+ * DESCRIPTION:
+ *  Animation flags for a single LED.
+ *
+ * active
+ *  Set if the animation is running or is in queue to run.
+ *
+ * led_mode
+ *  RGB LED mode (OFF, ON, PATTERN, RAMP).
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t active                        : 1;
+    uint8_t led_mode                      : 2;
+    uint8_t reserved3                     : 5;
+  };
+}
+LEDANIMATION_entry_flags_t;
+
+/*******************************************************************************
+ *
+ * LEDANIMATION_entry_t
+ *
+ * DESCRIPTION:
+ *  A single animation entry for a single LED. The order of entries on the
+ *  table indicate the animation priority. Other animation information is
+ *  stored in this structure.
+ *
+ * animation_id
+ *  The user should create a list of animation ID's. Then, several LEDs which
+ *  need to work together to create an animation should use the same animation
+ *  ID which is assigned to each different animation by the user.
+ *
+ * flags
+ *  LED animation flags.
+ *
+ * rgb_ui_code
+ *  The RGB UI code which is used by the RGB module to put an LED into OFF, ON,
+ *  PATTERN, or RAMP modes.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint8_t animation_id;
+  LEDANIMATION_entry_flags_t flags;
+  uint64_t rgb_ui_code;
+}
+LEDANIMATION_entry_t;
+
+/*******************************************************************************
+ *
+ * RGB_animation_table_t
+ *
+ * DESCRIPTION:
+ *  Collection of LEDANIMATION_entry_t for a single LED which makes up an
+ *  animation table with the higher priority animations listed first on the
+ *  table.
+ *
+ * table
+ *  Pointer to an array of user-defined LEDANIMATION_entry_t which have already
+ *  been initialized with the animation IDs, LED mode, and RGB UI code.
+ *
+ * table_length
+ *  Number of animations in the table. May have up to 255-entries ranging from
+ *  0 to 254.
+ *
+ * active_index
+ *  Index into the table of the currently highest priority animation which is
+ *  active.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  LEDANIMATION_entry_t* table;
+  uint8_t table_length;
+  uint8_t active_index;
+}
+LEDANIMATION_led_table_t;
+
+/*******************************************************************************
+ *
+ * LEDANIMATION_flags_t
+ *
+ * DESCRIPTION:
+ *  Module flags.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t reserved0                     : 8;
+  };
+}
+LEDANIMATION_flags_t;
+
+/*******************************************************************************
+ *
+ * LEDANIMATION_instance_t
+ *
+ * DESCRIPTION:
+ *  Instance data and function pointers.
+ *
+ * flags
+ *  Module flags.
+ *
+ * list
+ *  List of LED animation tables. Each table index corresponds directly to
+ *  the same index of an LED in the RGB instance. The animation list may be
+ *  smaller than or equal to the RGB list, but it cannot be greater.
+ *
+ * list_length
+ *  Number of tables in the list.
+ *
+ * rgb
+ *  User-provided RGB instance which has already been initialized.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  LEDANIMATION_flags_t flags;
+  LEDANIMATION_led_table_t* list;
+  uint32_t list_length;
+  RGB_instance_t* rgb;
+}
+LEDANIMATION_instance_t;
+
+/*******************************************************************************
+ *
+ * LEDANIMATION_initialize
+ *
+ * DESCRIPTION:
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
+ *
+ * PARAMETERS:
+ *  See LEDANIMATION_instance_t.
+ *
+ ******************************************************************************/
+
+void LEDANIMATION_initialize(LEDANIMATION_instance_t* instance,
+                             LEDANIMATION_led_table_t* list,
+                             uint32_t list_length,
+                             RGB_instance_t* rgb);
+
+/*******************************************************************************
+ *
+ * LEDANIMATION_service
+ *
+ * DESCRIPTION:
+ *  Meant to be called periodically on a basis of around 100-milliseconds.
+ *  Services the module instance - checks the status of the highest priority
+ *  animation for each LED and de-activates the animation if the animation was
+ *  finite and has completed. Will then look through the list for the next
+ *  highest priority task. Should be called periodically on a basis of around
+ *  100-milliseconds.
+ *
+ ******************************************************************************/
+
+void LEDANIMATION_service(LEDANIMATION_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * LEDANIMATION_set
+ *
+ * DESCRIPTION:
+ *  Traverses all LED tables and for each LED activates the selected animation.
+ *  If the animation is highest priority then the new animation will either
+ *  begin immediately or at the next pattern start cycle.
+ *
+ * PARAMETERS:
+ *  animation_id
+ *   The animation id to set active.
+ *
+ ******************************************************************************/
+
+void LEDANIMATION_set(LEDANIMATION_instance_t* instance, uint8_t animation_id);
+
+/*******************************************************************************
+ *
+ * LEDANIMATION_clear
+ *
+ * DESCRIPTION:
+ *  Traverses all LED tables and for each LED stops the selected animation if
+ *  it is currently running, else, de-activates the animation so it is not
+ *  pending to run.
+ *
+ * PARAMETERS:
+ *  animation_id
+ *   The animation id to set de-activate.
+ *
+ ******************************************************************************/
+
+void LEDANIMATION_clear(LEDANIMATION_instance_t* instance, uint8_t animation_id);
+
+/*******************************************************************************
+ *
+ * LEDANIMATION_start
+ *
+ * DESCRIPTION:
+ *  Helper function which starts a specified animation for a specified LED.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance LED list.
+ *
+ *  animation_index
+ *   Index of the animation in the LED animation table.
+ *
+ * NOTES:
+ *  Helper function called internally. Exposed here for unit testing.
+ *
+ ******************************************************************************/
+
+void LEDANIMATION_start(LEDANIMATION_instance_t* instance,
+                        uint32_t led_index,
+                        uint8_t animation_index);
+
+/*******************************************************************************
+ *
+ * LEDANIMATION_is_finite
+ *
+ * DESCRIPTION:
+ *  Helper function which determines if a given animation is finite.
+ *
+ * PARAMETERS:
+ *  led_index
+ *   Index of the LED in the instance LED list.
+ *
+ *  animation_index
+ *   Index of the animation in the LED animation table.
+ *
+ * RETURN:
+ *  True if the animation is finite (OFF, ON, PATTER or RAMP with infinite
+ *  iterations), else, false.
+ *
+ * NOTES:
+ *  Helper function called internally. Exposed here for unit testing.
+ *
+ ******************************************************************************/
+
+bool LEDANIMATION_is_finite(LEDANIMATION_instance_t* instance,
+                            uint32_t led_index,
+                            uint8_t animation_index);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // LED_ANIMATION_J_H
+
+/*******************************************************************************
+ *
+ *  Simple settings storage on EEPROM media. The module uses a 4-byte header
+ *  to wear-level the NVM ensure data integrity. Requires proper initialization
+ *  and the service routine to be called repeatedly after a new task request
+ *  until the task is completed.
+ *
+ ******************************************************************************/
+
+#ifndef NVMBASIC_J_H
+#define NVMBASIC_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ *
+ * NVMBASIC_data_meta_flags_t
+ *
+ * DESCRIPTION:
+ *  Flags which are used for data status and NVM wear leveling.
+ *
+ * data_present
+ *  Indicates that the associated block of NVM was used to store data.
+ *
+ * data_old
+ *  Inidcates that this block of NVM data is outdated and that a newer version
+ *  of the data exists in a later block.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint16_t all;
+  struct
+  {
+    uint16_t reserved0                    : 14;
+    uint16_t data_present                 : 1;
+    uint16_t data_old                     : 1;
+  };
+}
+NVMBASIC_data_meta_flags_t;
+
+/*******************************************************************************
+ *
+ * NVMBASIC_data_meta_t
+ *
+ * DESCRIPTION:
+ *  Data structure which MUST be the first entry in the user data structure.
+ *  Contains information which is used to help evenly wear NVM and ensure
+ *  data integrity.
+ *
+ * crc16
+ *  The CRC16 of the data starting immediately after the CRC bytes.
+ *
+ * flags
+ *  See NVMBASIC_data_meta_flags_t.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint16_t crc16;
+  NVMBASIC_data_meta_flags_t flags;
+}
+NVMBASIC_data_meta_t;
+
+/*******************************************************************************
+ *
+ * NVMBASIC_flags_t
+ *
+ * DESCRIPTION:
+ *  Module flags.
+ *
+ * busy
+ *  Set when the module is busy with a task and cleared when the task is
+ *  completed.
+ *
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t busy                          : 1;
+    uint8_t reserved1                     : 3;
+    uint8_t task_state                    : 3;
+    uint8_t reserved7                     : 1;
+  };
+}
+NVMBASIC_flags_t;
+
+/*******************************************************************************
+ *
+ * NVMBASIC_pre_task_callback_t
+ *
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called when a new
+ *  task is accepted and initialized but before the task actually begins. This
+ *  allows the user to perform any last additional configurations before the
+ *  actual logic of the task begins.
+ *
+ * PARAMETERS:
+ *  context
+ *   User-provided context.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - YES
+ *
+ ******************************************************************************/
+
+typedef void (*NVMBASIC_pre_task_callback_t)(uint32_t);
+
+/*******************************************************************************
+ *
+ * NVMBASIC_post_task_callback_t
+ *
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called after a
+ *  task completes.
+ *
+ * PARAMETERS:
+ *  context
+ *   User-provided context.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - YES
+ *
+ ******************************************************************************/
+
+typedef void (*NVMBASIC_post_task_callback_t)(uint32_t);
+
+/*******************************************************************************
+ *
+ * NVMBASIC_instance_t
+ *
+ * DESCRIPTION:
+ *  Instance data and function pointers.
+ *
+ * flags
+ *  Module flags.
+ *
+ * eeprom
+ *  User-provided initialized instance of a EEPROM.
+ *
+ * bus_mutex
+ *  User-provided initialized instance of a BUSMUTEX.
+ *
+ * bus_id
+ *  The BUS ID associated with the BUSMUTEX instance.
+ *
+ * data_stable
+ *  Pointer to a user buffer dedicated for holding the data to be written to
+ *  EEPROM, and to maintain that data as a volatile copy of what is currently
+ *  on EEPROM.
+ *
+ * data_working
+ *  Pointer to the user data structure which is, presumably, being updated by
+ *  the user code.
+ *
+ * data_length
+ *  The length, in bytes, of the data structure. This should be the length of
+ *  the data_stable and data_working buffers.
+ *
+ * memory_start
+ *  The starting address, inclusive, in EEPROM memory that is dedicated to
+ *  the data. The address must be word-aligned.
+ *
+ * memory_end
+ *  The ending address, exclusive, in EEPROM memory that is dedicated to the
+ *  data. The length from the start address to the end address must be evenly
+ *  divisble by the data length.
+ *
+ * next_address
+ *  The next EEPROM starting memory address where the data will be written.
+ *
+ * previous_address
+ *  The last EEPROM starting memory address where the data was written.
+ *
+ * callback_context
+ *  Context passed into the user pre/post operation callbacks.
+ *
+ * previous_meta_page_buffer
+ *  Copy of the previous data structure, up to the first EEPROM page (i.e. if
+ *  the data structue is larger than an EEPROM page, then the buffer will be
+ *  only the first EEPROM page used by the previous data structure. If the
+ *  data structure is smaller than an EEPROM page, then the entire previous
+ *  data structure is stored in this buffer). Keeping a copy eliminates the
+ *  need to re-read the old meta before doing a write to mark the data entry
+ *  as old. We need to store up to an entire EEPROM page since any un-written
+ *  bytes will be erased by the EEPROM.
+ *
+ * previous_meta_page_buffer_length
+ *  The length, in bytes, of the previous_meta_page_buffer. This is set during
+ *  initialization and is the smaller of the data structure length and EEPROM
+ *  page length.
+ *
+ * *_task_*
+ *  User-provided functions. See typedef comments.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  NVMBASIC_flags_t flags;
+  EEPROM_instance_t* eeprom;
+  BUSMUTEX_instance_t* bus_mutex;
+  BUSMUTEX_bus_id_t bus_id;
+  uint8_t* data_stable;
+  uint8_t* data_working;
+  uint32_t data_length;
+  uint32_t memory_start;
+  uint32_t memory_end;
+  uint32_t next_address;
+  uint32_t previous_address;
+  uint32_t callback_context;
+  uint8_t* previous_meta_page_buffer;
+  uint32_t previous_meta_page_buffer_length;
+  NVMBASIC_pre_task_callback_t pre_task_callback;
+  NVMBASIC_post_task_callback_t post_task_callback;
+}
+NVMBASIC_instance_t;
+
+/*******************************************************************************
+ *
+ * NVMBASIC_initialize
+ *
+ * DESCRIPTION:
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
+ *
+ * PARAMETERS:
+ *  See NVMBASIC_instance_t.
+ *
+ ******************************************************************************/
+
+void NVMBASIC_initialize(NVMBASIC_instance_t* instance,
+                         EEPROM_instance_t* eeprom,
+                         BUSMUTEX_instance_t* bus_mutex,
+                         BUSMUTEX_bus_id_t bus_id,
+                         uint8_t* data_stable,
+                         uint8_t* data_working,
+                         uint32_t data_length,
+                         uint32_t memory_start,
+                         uint32_t memory_end,
+                         uint8_t* previous_meta_page_buffer,
+                         NVMBASIC_pre_task_callback_t pre_task_callback,
+                         NVMBASIC_post_task_callback_t post_task_callback);
+
+/*******************************************************************************
+ *
+ * NVMBASIC_blocked_restore
+ *
+ * DESCRIPTION:
+ *  Blocking function which attempts to restore the latest saved version of the
+ *  data from the EEPROM. This is a blocking function intended to be called
+ *  during initialization.
+ *
+ * RETURN:
+ *  True if the task request was performed and a restore point was found and
+ *  restored, else, false.
+ *
+ ******************************************************************************/
+
+bool NVMBASIC_blocked_restore(NVMBASIC_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * NVMBASIC_blocked_purge
+ *
+ * DESCRIPTION:
+ *  Blocking function which erases the allocated memory block and resets the
+ *  next write location to the beggining of the memory space.
+ *
+ * RETURN:
+ *  True if the task request was performed, else, false.
+ *
+ ******************************************************************************/
+
+bool NVMBASIC_blocked_purge(NVMBASIC_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * NVMBASIC_save
+ *
+ * DESCRIPTION:
+ *  Captures and saves a copy of the working data in EEPROM.
+ *
+ * PARAMETERS:
+ *  force
+ *   Forces the save even if the stable and working data buffers are the same.
+ *
+ * RETURN:
+ *  True if the task request was accepted, else, false.
+ *
+ ******************************************************************************/
+
+bool NVMBASIC_save(NVMBASIC_instance_t* instance, bool force);
+
+/*******************************************************************************
+ *
+ * NVMBASIC_service
+ *
+ * DESCRIPTION:
+ *  Services the task state machine. Must be called repeatedly until the task
+ *  is completed.
+ *
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true.
+ *
+ ******************************************************************************/
+
+bool NVMBASIC_service(NVMBASIC_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * NVMBASIC_is_busy
+ *
+ * DESCRIPTION:
+ *  Determines if an instance is currently busy with a task.
+ *
+ * RETURN:
+ *  True if the instance is busy with a task, else, false.
+ *
+ ******************************************************************************/
+
+bool NVMBASIC_is_busy(NVMBASIC_instance_t* instance);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // NVMBASIC_J_H
+
+/*******************************************************************************
+ *
+ *  Simple, and comparably tiny, replacement for stdio printf. This module
+ *  parses standard variable types into their ASCII equivalents and places the
+ *  characters on a user-provided Queue instance - it is expected that the user
+ *  provides a character queue (element byte size of 1) and will transmit the
+ *  queue via communication protocol to the terminal elsewhere.
+ *
+ ******************************************************************************/
+
+#ifndef PRINT_J_H
+#define PRINT_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Provide a shortened command interface for the Print module and an easy way
+ * to enable/disable printing. (Disabling will completely remove the code from
+ * the build.) The user should define PRINT_TERMINAL_QUEUE in their code as
+ * their dedicated/default terminal output Queue.
+ */
+
+#ifdef PRINT_TERMINAL_QUEUE
+#define PCHAR(Z)                PRINT_char(&PRINT_TERMINAL_QUEUE, Z)
+#define PMSTR(Z, M)             PRINT_mstring(&PRINT_TERMINAL_QUEUE, Z, M)
+#define PSTR(Z)                 PRINT_string(&PRINT_TERMINAL_QUEUE, Z)
+#define PU32(Z)                 PRINT_uint32(&PRINT_TERMINAL_QUEUE, Z)
+#define PI32(Z)                 PRINT_int32(&PRINT_TERMINAL_QUEUE, Z)
+#define PH4(Z)                  PRINT_hex4(&PRINT_TERMINAL_QUEUE, Z)
+#define PH8(Z)                  PRINT_hex8(&PRINT_TERMINAL_QUEUE, Z)
+#define PH16(Z)                 PRINT_hex16(&PRINT_TERMINAL_QUEUE, Z)
+#define PH32(Z)                 PRINT_hex32(&PRINT_TERMINAL_QUEUE, Z)
+#define PB4(Z)                  PRINT_bin4(&PRINT_TERMINAL_QUEUE, Z)
+#define PB8(Z)                  PRINT_bin8(&PRINT_TERMINAL_QUEUE, Z)
+#define PB16(Z)                 PRINT_bin16(&PRINT_TERMINAL_QUEUE, Z)
+#define PB32(Z)                 PRINT_bin32(&PRINT_TERMINAL_QUEUE, Z)
+#define PNL()                   PRINT_newline(&PRINT_TERMINAL_QUEUE)
+#define PCLEAR()                PRINT_clear(&PRINT_TERMINAL_QUEUE)
+#else
+#define PCHAR(Z)
+#define PMSTR(Z, M)
+#define PSTR(Z)
+#define PU32(Z)
+#define PI32(Z)
+#define PH4(Z)
+#define PH8(Z)
+#define PH16(Z)
+#define PH32(Z)
+#define PB4(Z)
+#define PB8(Z)
+#define PB16(Z)
+#define PB32(Z)
+#define PNL()
+#define PCLEAR()
+#endif
+
+/*******************************************************************************
+ *
+ * PRINT_char
+ *
+ * DESCRIPTION:
+ *  Enqueues a single ASCII character.
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * PARAMETERS:
+ *  value
+ *   ASCII characters to enqueue.
  *
  ******************************************************************************/
 
-void GFX2D_draw_rectangle(GFX2D_instance_t* instance,
-                          int16_t x,
-                          int16_t y,
-                          int16_t width,
-                          int16_t height,
-                          uint32_t color);
+void PRINT_char(QUEUE_instance_t* instance, char value);
 
 /*******************************************************************************
  *
- * GFX2D_draw_filled_rectangle
+ * PRINT_string
  *
  * DESCRIPTION:
- *  Draws a filled rectangle.
+ *  Enqueues an array of ASCII characters, a string, until a null character is
+ *  reached.
  *
  * PARAMETERS:
- *  x
- *   X-Coords starting point of rectangle.
+ *  value
+ *   ASCII characters to enqueue.
  *
- *  y
- *   Y-Coords starting point of rectangle.
+ ******************************************************************************/
+
+void PRINT_string(QUEUE_instance_t* instance, char* value);
+
+/*******************************************************************************
  *
- *  width
- *   Width of the rectangle in pixels.
+ * PRINT_mstring
  *
- *  height
- *   Height of the rectangle in pixels.
+ * DESCRIPTION:
+ *  Enqueues an array of ASCII characters, a string, until a null character or
+ *  maximum length is reached.
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * PARAMETERS:
+ *  value
+ *   ASCII characters to enqueue.
+ *
+ *  length
+ *   Maximum number of characters to print if a null character is not reached.
  *
  ******************************************************************************/
 
-void GFX2D_draw_filled_rectangle(GFX2D_instance_t* instance,
-                                int16_t x,
-                                int16_t y,
-                                int16_t width,
-                                int16_t height,
-                                uint32_t color);
+void PRINT_mstring(QUEUE_instance_t* instance, char* value, uint32_t length);
 
 /*******************************************************************************
  *
- * GFX2D_draw_rounded_rectangle
+ * PRINT_uint32
  *
  * DESCRIPTION:
- *  Draws a rectangle with rounded edges.
+ *  Enqueues the ASCII representation of the provided uint32_t.
  *
  * PARAMETERS:
- *  x
- *   X-Coords starting point of rectangle.
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
- *  y
- *   Y-Coords starting point of rectangle.
+ ******************************************************************************/
+
+void PRINT_uint32(QUEUE_instance_t* instance, uint32_t value);
+
+/*******************************************************************************
  *
- *  width
- *   Width of the rectangle in pixels.
+ * PRINT_int32
  *
- *  height
- *   Height of the rectangle in pixels.
+ * DESCRIPTION:
+ *  Enqueues the ASCII representation of the provided int32_t.
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * PARAMETERS:
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
  ******************************************************************************/
 
-void GFX2D_draw_rounded_rectangle(GFX2D_instance_t* instance,
-                                  int16_t x,
-                                  int16_t y,
-                                  int16_t width,
-                                  int16_t height,
-                                  int16_t radius,
-                                  uint32_t color);
+void PRINT_int32(QUEUE_instance_t* instance, int32_t value);
 
 /*******************************************************************************
  *
- * GFX2D_draw_filled_rounded_rectangle
+ * PRINT_uint64
  *
  * DESCRIPTION:
- *  Draws a filled rectangle with rounded edges.
+ *  Enqueues the ASCII representation of the provided uint64_t.
  *
  * PARAMETERS:
- *  x
- *   X-Coords starting point of rectangle.
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
- *  y
- *   Y-Coords starting point of rectangle.
+ ******************************************************************************/
+
+void PRINT_uint64(QUEUE_instance_t* instance, uint64_t value);
+
+/*******************************************************************************
  *
- *  width
- *   Width of the rectangle in pixels.
+ * PRINT_int64
  *
- *  height
- *   Height of the rectangle in pixels.
+ * DESCRIPTION:
+ *  Enqueues the ASCII representation of the provided int64_t.
  *
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ * PARAMETERS:
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
  ******************************************************************************/
 
-void GFX2D_draw_filled_rounded_rectangle(GFX2D_instance_t* instance,
-                                         int16_t x,
-                                         int16_t y,
-                                         int16_t width,
-                                         int16_t height,
-                                         int16_t radius,
-                                         uint32_t color);
+void PRINT_int64(QUEUE_instance_t* instance, int64_t value);
 
 /*******************************************************************************
  *
- * GFX2D_draw_binary_bitmap
+ * PRINT_hex4
  *
  * DESCRIPTION:
- *  Draws a binary color bitmap at the specified x,y location. If the color and
- *  background color are the same value, then the background color will not be
- *  drawn and will instead act as a transparent pixel.
+ *  Enqueues the ASCII representation of the provided uint8_t in hex-decimal
+ *  format. The output will contain 1-characters.
  *
  * PARAMETERS:
- *  bitmap
- *   Pointer to the binary bitmap.
+ *  value
+ *   Value to translate to ASCII character and enqueue.
  *
- *  x0, y0
- *   Target display write origin.
+ ******************************************************************************/
+
+void PRINT_hex4(QUEUE_instance_t* instance, uint8_t value);
+
+/*******************************************************************************
  *
- *  bitmap_x0, bitmap_y0
- *   Bitmap read origin.
+ * PRINT_hex8
  *
- *  bitmap_width_draw
- *   The width, in pixels, of the bitmap portion to draw.
+ * DESCRIPTION:
+ *  Enqueues the ASCII representation of the provided uint8_t in hex-decimal
+ *  format. The output will contain 2-characters.
  *
- *  bitmap_height_draw
- *   The height, in pixels, of the bitmap portion to draw.
+ * PARAMETERS:
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
- *  bitmap_width_total
- *   The width, in pixels, of the complete bitmap image.
+ ******************************************************************************/
+
+void PRINT_hex8(QUEUE_instance_t* instance, uint8_t value);
+
+/*******************************************************************************
  *
- *  bitmap_height_total
- *   The height, in pixels, of the complete bitmap image.
+ * PRINT_hex16
  *
- *  color
- *   Color set to a pixel when the corresponding bitmap bit is a 1.
+ * DESCRIPTION:
+ *  Enqueues the ASCII representation of the provided uint16_t in hex-decimal
+ *  format. The output will contain 4-characters.
  *
- *  background_color
- *   Color set to a pixel when the corresponding bitmap bit is a 0. If the
- *   background color is the same as color, then the pixel is not drawn in
- *   the case of 0 (transparent).
+ * PARAMETERS:
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
  ******************************************************************************/
 
-void GFX2D_draw_binary_bitmap(GFX2D_instance_t* instance,
-                              const uint8_t* bitmap,
-                              int16_t x0,
-                              int16_t y0,
-                              uint16_t bitmap_x0,
-                              uint16_t bitmap_y0,
-                              uint16_t bitmap_width_draw,
-                              uint16_t bitmap_height_draw,
-                              uint16_t bitmap_width_total,
-                              uint16_t bitmap_height_total,
-                              uint32_t color,
-                              uint32_t background_color);
+void PRINT_hex16(QUEUE_instance_t* instance, uint16_t value);
 
 /*******************************************************************************
  *
- * GFX2D_draw_rgb_bitmap
+ * PRINT_hex32
  *
  * DESCRIPTION:
- *  Draws an RGB bitmap at the specified x,y location.
+ *  Enqueues the ASCII representation of the provided uint32_t in hex-decimal
+ *  format. The output will contain 8-characters.
  *
  * PARAMETERS:
- *  rgb_bitmap
- *   Bitmap format (332, 565, 888).
- *
- *  alpha_mask
- *   Bit-mask indicating which pixels should be transparent (0) and which
- *   should be opaque (1). Each bit represents a pixel, so the length of the
- *   bitmap array in bytes should be the cieling of the number of bitmap pixels
- *   divided by 8. This parameter can be left NULL if not needed.
- *
- *  See GFX2D_draw_binary_bitmap.
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
  ******************************************************************************/
 
-void GFX2D_draw_rgb_bitmap(GFX2D_instance_t* instance,
-                           GFX2D_rgb_bitmap_t rgb_bitmap,
-                           const uint8_t* bitmap,
-                           const uint8_t* alpha_mask,
-                           int16_t x0,
-                           int16_t y0,
-                           uint16_t bitmap_x0,
-                           uint16_t bitmap_y0,
-                           uint16_t bitmap_width_draw,
-                           uint16_t bitmap_height_draw,
-                           uint16_t bitmap_width_total,
-                           uint16_t bitmap_height_total);
+void PRINT_hex32(QUEUE_instance_t* instance, uint32_t value);
 
 /*******************************************************************************
  *
- * GFX2D_set_text_magnification
+ * PRINT_bin4
  *
  * DESCRIPTION:
- *  Sets the x and y text magnifications.To keep the text in proper proportions,
- *  the x and y values should be the same.
+ *  Enqueues the ASCII representation of the provided uint8_t in binary
+ *  format. The output will contain 4-characters.
  *
  * PARAMETERS:
- *  x_magnification
- *   Text magnification in the x-direction.
- *
- *  y_magnification
- *   Text magnification in the y-direction.
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
  ******************************************************************************/
 
-void GFX2D_set_text_magnification(GFX2D_instance_t* instance,
-                                  uint8_t x_magnification,
-                                  uint8_t y_magnification);
+void PRINT_bin4(QUEUE_instance_t* instance, uint8_t value);
 
 /*******************************************************************************
  *
- * GFX2D_set_font
+ * PRINT_bin8
  *
  * DESCRIPTION:
- *  Sets the font.
+ *  Enqueues the ASCII representation of the provided uint8_t in binary
+ *  format. The output will contain 8-characters.
  *
  * PARAMETERS:
- *  font
- *   Pointer to font structure.
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
  ******************************************************************************/
 
-void GFX2D_set_font(GFX2D_instance_t* instance, GFX2DFONT_font_t* font);
+void PRINT_bin8(QUEUE_instance_t* instance, uint8_t value);
 
 /*******************************************************************************
  *
- * GFX2D_set_font_color
+ * PRINT_bin16
  *
  * DESCRIPTION:
- *  Sets the font color.
+ *  Enqueues the ASCII representation of the provided uint16_t in binary
+ *  format. The output will contain 16-characters.
  *
  * PARAMETERS:
- *  color
- *   See GFX2D_rgba_t. (Uint32_t used for quicker access.)
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
  ******************************************************************************/
 
-void GFX2D_set_font_color(GFX2D_instance_t* instance, uint32_t color);
+void PRINT_bin16(QUEUE_instance_t* instance, uint16_t value);
 
 /*******************************************************************************
  *
- * GFX2D_set_inverted
+ * PRINT_bin32
  *
  * DESCRIPTION:
- *  Enables or disables inverted rendering.
+ *  Enqueues the ASCII representation of the provided uint32_t in binary
+ *  format. The output will contain 32-characters.
  *
  * PARAMETERS:
- *  enable_inverted
- *   True to enable inverted rendering, else, false to disable.
+ *  value
+ *   Value to translate to ASCII characters and enqueue.
  *
  ******************************************************************************/
 
-void GFX2D_set_inverted(GFX2D_instance_t* instance, bool enable_inverted);
+void PRINT_bin32(QUEUE_instance_t* instance, uint32_t value);
 
 /*******************************************************************************
  *
- * GFX2D_set_text_wrap
+ * PRINT_newline
  *
  * DESCRIPTION:
- *  Enables or disables text wrapping - text will automatically go to the next
- *  line if the end of the row is reached.
- *
- * PARAMETERS:
- *  enable_wrap
- *   True to enable wrapping, else, false to disable.
+ *  Enqueues the carriage return and newline characters which produces a new
+ *  line.
  *
  ******************************************************************************/
 
-void GFX2D_set_text_wrap(GFX2D_instance_t* instance, bool enable_wrap);
+void PRINT_newline(QUEUE_instance_t* instance);
 
 /*******************************************************************************
  *
- * GFX2D_draw_char
+ * PRINT_clear
  *
  * DESCRIPTION:
- *  Draws a single character from the font module.
- *
- * PARAMETERS:
- *  c
- *   ASCII character to draw. Characters/glyph not supported by the font
- *   module will not be drawn.
+ *  Enqueues the special character sequence recognized by most terminal
+ *  applications to clear the screen.
  *
  ******************************************************************************/
 
-void GFX2D_draw_char(GFX2D_instance_t* instance, uint8_t c);
+void PRINT_clear(QUEUE_instance_t* instance);
 
 #ifdef __cplusplus
 }
 #endif
-#endif // GFX2D_J_H
+#endif // PRINT_J_H
 
 /*******************************************************************************
- *
- *  Ili9341 display module which utilizes the Gfx2d library and sends pixel
- *  data through SPI DMA. Requires proper initialization and the service
- *  routine to be called repeatedly after a new task request until the task
- *  is completed.
+ *  Rotary encoder/wheel with a A/B phase. Requires proper initialization and
+ *  the service routine to be called periodically to detect changes in the A/B
+ *  phases. Callback function is called when a rotation "click" is confirmed.
  *
  ******************************************************************************/
 
-#ifndef ILI9XXX_J_H
-#define ILI9XXX_J_H
+#ifndef ROTARYENCODER_J_H
+#define ROTARYENCODER_J_H
 
 // Support C++ builds.
 
@@ -7842,86 +13353,52 @@ void GFX2D_draw_char(GFX2D_instance_t* instance, uint8_t c);
 extern "C" {
 #endif
 
-/*
- * The default timeout for chip select and unselect.
- */
-
-#define ILI9341_CHIP_SELECT_TIMEOUT_uS    100000U
-
 /*******************************************************************************
  *
- * ILI9341_custom_command_t
+ * ROTARYENCODER_edge_trigger_t
  *
  * DESCRIPTION:
- *  Custom command values which are used during the device initialization to
- *  indicate certain behaviors. These values are either not found or not used
- *  in the regular function of the device.
+ *  The edge (rising, falling, or both) which will trigger the start of a new
+ *  rotation tick.
  *
  ******************************************************************************/
 
 typedef enum
 {
-  ILI9341_CUSTOM_COMMAND_END_OF_LIST      = 0x00,
-  ILI9341_CUSTOM_COMMAND_DELAY_MS         = 0xFF
+  ROTARYENCODER_EDGE_TRIGGER_FALLING      = 0,
+  ROTARYENCODER_EDGE_TRIGGER_RISING,
+  ROTARYENCODER_EDGE_TRIGGER_BOTH
 }
-ILI9341_custom_command_t;
+ROTARYENCODER_edge_trigger_t;
 
 /*******************************************************************************
  *
- * ILI9341_flags_t
+ * ROTARYENCODER_flags_t
  *
  * DESCRIPTION:
  *  Module flags.
  *
- * busy
- *  Set when the module is busy with a task and cleared when the task is
- *  completed.
- *
- * dma_busy
- *  Set when the DMA is given data to load into the SPI transmit register.
- *  Cleared in interrupt context when the DMA transfer is completed.
- *
- * reg_write
- *  Set when the current task is a register write and cleared when the task is
- *  a register read.
- *
- * single_segment
- *  Set during initialization if the dispaly buffer is large enough to hold
- *  the entire target display frame. This allows us to do some one-time
- *  calculations during initialization and save time during the display update.
- *
- * task_state
- *  State machine state.
- *
- ******************************************************************************/
-
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t busy                          : 1;
-    uint8_t dma_busy                      : 1;
-    uint8_t reg_write                     : 1;
-    uint8_t single_segment                : 1;
-    uint8_t task_state                    : 4;
-  };
-}
-ILI9341_flags_t;
-
-/*******************************************************************************
+ * rotation_in_progress
+ *  Set when a new rotation is detected. Cleared when the "click" is complete,
+ *  that is, when A and B phases are the same.
  *
- * ILI9341_error_flags_t
+ * clockwise_rotation
+ *  Set if the detected rotation is clockwise, else, cleared if counter-
+ *  clockwise.
  *
- * DESCRIPTION:
- *  Module error flags.
+ * debounced_a, debounced_b
+ *  Set during an active rotation once each phase is debounced, and cleared
+ *  at the "end" of the tick rotation. These are used to guard against false
+ *  negatives that may occur by rotating the knob enough to trigger on phase
+ *  and have it debounce, but then reverting to the previous tick location.
  *
- * timeout
- *  The maximum allowable time between receiving or transmitting the next data
- *  element has passed.
+ * last_a, last_b
+ *  The last debounced phase A/B GPIO state.
  *
- * other
- *  All other types of errors.
+ * edge_trigger
+ *  The type of edge which will qualify a for a new rotation tick. (I have
+ *  found that encoders vary in their behavior. Some alternate between high
+ *  and low while others will always pull back high or low after every tick.)
  *
  ******************************************************************************/
 
@@ -7930,161 +13407,72 @@ typedef union
   uint8_t all;
   struct
   {
-    uint8_t timeout                       : 1;
-    uint8_t other                         : 1;
-    uint8_t reserved2                     : 6;
+    uint8_t rotation_in_progress          : 1;
+    uint8_t clockwise_rotation            : 1;
+    uint8_t debounced_a                   : 1;
+    uint8_t debounced_b                   : 1;
+    uint8_t last_a                        : 1;
+    uint8_t last_b                        : 1;
+    uint8_t edge_trigger                  : 2;
   };
 }
-ILI9341_error_flags_t;
-
-/*******************************************************************************
- *
- * ILI9341_draw_handler_t
- *
- * DESCRIPTION:
- *  Function template for a user-provided function which is called to render
- *  the display buffer utilizing the GFX2D module.
- *
- * NOTES:
- *  Can be initialized as NULL - NO
- *
- ******************************************************************************/
-
-typedef void (*ILI9341_draw_handler_t)(void);
-
-/*******************************************************************************
- *
- * ILI9341_pre_task_callback_t
- *
- * DESCRIPTION:
- *  Function template for a user-provided function which is called when a new
- *  task is accepted and initialized but before the task actually begins. This
- *  allows the user to perform any last additional configurations before the
- *  actual logic of the task begins.
- *
- * PARAMETERS:
- *  context
- *   User-provided context.
- *
- * NOTES:
- *  Can be initialized as NULL - YES
- *
- ******************************************************************************/
-
-typedef void (*ILI9341_pre_task_callback_t)(uint32_t);
-
-/*******************************************************************************
- *
- * ILI9341_post_task_callback_t
- *
- * DESCRIPTION:
- *  Function template for a user-provided function which is called after a
- *  task completes.
- *
- * PARAMETERS:
- *  context
- *   User-provided context.
- *
- * NOTES:
- *  Can be initialized as NULL - YES
- *
- ******************************************************************************/
-
-typedef void (*ILI9341_post_task_callback_t)(uint32_t);
+ROTARYENCODER_flags_t;
 
 /*******************************************************************************
  *
- * ILI9341_hal_set_chip_select_t
+ * ROTARYENCODER_hal_is_phase_a_set_t
  *
  * DESCRIPTION:
  *  Hardware abstraction layer function template for a user-provided function
- *  which will enable or disable the device chip select. A boolean return is
- *  provided to allow more iteration time to select/unselect the chip. This
- *  function will continue to be called until true is returned.
- *
- * PARAMETERS:
- *  enable
- *   True to select the device, else, false.
+ *  which will check if phase 'a' of the rotary encoder is set.
  *
  * RETURN:
- *  True if the chip selection was completed, else, false.
- *
- * NOTES:
- *  Can be initialized as NULL - NO
- *
- ******************************************************************************/
-
-typedef bool (*ILI9341_hal_set_chip_select_t)(bool);
-
-/*******************************************************************************
- *
- * ILI9341_hal_set_dc_select_t
- *
- * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will set the data-command line. (generally data:1, command:0).
- *
- * PARAMETERS:
- *  enable
- *   True to enable data mode, else, false to enable command mode.
+ *  True if phase 'a' is set, else, false.
  *
  * NOTES:
  *  Can be initialized as NULL - NO
  *
- *  I had considered making this a boolean return to allow "slow" setting of
- *  the data/command select, but ultimately decided against it. While the
- *  chip select is only triggered at the start and end of a transaction, the
- *  DC is triggered throughout the transaction - it really should have a GPIO,
- *  or something equivalent, assigned to drive it.
- *
- *
  ******************************************************************************/
 
-typedef void (*ILI9341_hal_set_dc_select_t)(bool);
+typedef bool (*ROTARYENCODER_hal_is_phase_a_set_t)(void);
 
 /*******************************************************************************
  *
- * ILI9341_hal_configure_dma_t
+ * ROTARYENCODER_hal_is_phase_b_set_t
  *
  * DESCRIPTION:
  *  Hardware abstraction layer function template for a user-provided function
- *  which will configure and start the DMA transfer for pixel data.
- *
- * PARAMETERS:
- *  src_addr
- *   Starting address of the pixel buffer.
- *
- *  src_length
- *   Length of the source buffer in bytes.
+ *  which will check if phase 'b of the rotary encoder is set.
  *
  * RETURN:
- *  True if the configuration was successful and started, else, false.
+ *  True if phase 'b' is set, else, false.
  *
  * NOTES:
  *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef bool (*ILI9341_hal_configure_dma_t)(void*, uint32_t);
+typedef bool (*ROTARYENCODER_hal_is_phase_b_set_t)(void);
 
 /*******************************************************************************
  *
- * ILI9341_hal_disable_dma_t
+ * ROTARYENCODER_rotation_tick_callback_t
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will disable the DMA.
+ *  Function template for a user-provided function which is called when there is
+ *  a successful clockwise (true) or counter-clockwise (false) rotation.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * PARAMETERS:
+ *  clockwise
+ *   True if the tick was clockwise, else, false for counter-clockwise.
  *
  ******************************************************************************/
 
-typedef void (*ILI9341_hal_disable_dma_t)(void);
+typedef void (*ROTARYENCODER_rotation_tick_callback_t)(bool);
 
 /*******************************************************************************
  *
- * ILI9341_instance_t
+ * ROTARYENCODER_instance_t
  *
  * DESCRIPTION:
  *  Instance data and function pointers.
@@ -8092,87 +13480,22 @@ typedef void (*ILI9341_hal_disable_dma_t)(void);
  * flags
  *  Module flags.
  *
- * errors
- *  Errors which occurred in the last transaction.
- *
- * gfx2d
- *  User-provided initialized instance of a GFX2D.
- *
- * utimer
- *  User-provided initialized instance of a UTIMER.
- *
- * spi
- *  User-provided initialized instance of a SERSPI.
- *
- * utimer_ticket
- *  Data structure used with the UTIMER instance.
- *
- * bus_mutex
- *  User-provided initialized instance of a BUSMUTEX.
- *
- * bus_id
- *  The BUS ID associated with the BUSMUTEX instance.
- *
- * render_y0
- *  Keeps track of the last rendered y-offset.
- *
- * render_rows
- *  The number of rows starting from render_y0 which are buffered and sent to
- *  the display in a single rendering iteration.
- *
- * render_page_buffer
- *  Holds the register and parameters for setting the starting page/row.
- *
- * display_adjust_y
- *  Adjusts the column and row starting and ending positions. (This is used for
- *  cheap screens which may not be properly aligned within their frames).
- *
- * reg_address
- *  Register address to read/write in register rw task.
- *
- * reg_buffer
- *  Buffer which holds the value to write to the register or will hold the
- *  value read from the register in a register rw task.
- *
- * reg_length
- *  Length of the reg_buffer.
- *
- * chip_select_timeout_us
- *  The time allowed for the chip select to complete before aborting. The value
- *  is initialized to the defined default, but can be directly modified by the
- *  user.
- *
- * dma_bytes_per_transfer
- *  The maximum number of bytes which can be sent in a single DMA transaction.
- *
- * dma_transfer_timeout_us
- *  The timeout allowed for the DMA transfer to complete before giving up.
- *
- * dma_transfer_counter
- *  The number of bytes which have been transferred by the DMA.
- *
- * dma_transfer_count
- *  The total number of bytes which need to be transferred by the DMA.
- *
- * dma_transfer_last_packet_length
- *  The length, in bytes, of the last data packet which will be transmitted by
- *  the DMA. This is calculated early on to avoid repetitive math during the
- *  transaction process.
- *
- * dma_src_buffer_offset
- *  Offset into the source buffer which is being transmitted by DMA.
+ * debounce_count
+ *  The number of times, for both rotation directions, which the phase GPIO
+ *  must be detected as stable before accepting a GPIO change.
  *
- * callback_context
- *  Context passed into the user pre/post operation callbacks.
+ * clockwise_debounce_counter
+ *  Keeps track of the debounce count in the clockwise direction.
  *
- * service_handler
- *  Function pointer to the service routine applicable to the initialized
- *  service mode.
+ * counterclockwise_debounce_counter
+ *  Keeps track of the debounce count in the counterclockwise direction.
  *
- * draw_handler
- *  See ILI9341_draw_handler_t
+ * edge_trigger_check
+ *  Internal helper function which is pointed to during initialization based
+ *  upon the edge trigger type. This provides a more efficient check than
+ *  repeated conditionals in each iteration.
  *
- * *_task_*
+ * *_callback
  * *_hal_*
  *  User-provided functions. See typedef comments.
  *
@@ -8180,238 +13503,312 @@ typedef void (*ILI9341_hal_disable_dma_t)(void);
 
 typedef struct
 {
-  volatile ILI9341_flags_t flags;
-  ILI9341_error_flags_t errors;
-  GFX2D_instance_t* gfx2d;
-  UTIMER_instance_t* utimer;
-  SERSPI_instance_t* spi;
-  UTIMER_ticket_t utimer_ticket;
-  BUSMUTEX_instance_t* bus_mutex;
-  BUSMUTEX_bus_id_t bus_id;
-  uint16_t render_y0;
-  uint16_t render_rows;
-  uint8_t render_page_buffer[4];
-  int8_t display_adjust_y;
-  uint8_t reg_address;
-  void* reg_buffer;
-  uint32_t reg_length;
-  uint32_t chip_select_timeout_us;
-  uint32_t dma_bytes_per_transfer;
-  uint32_t dma_transfer_timeout_us;
-  uint32_t dma_transfer_counter;
-  uint32_t dma_transfer_count;
-  uint32_t dma_transfer_last_packet_length;
-  uint32_t dma_src_buffer_offset;
-  uint32_t callback_context;
-  bool (*service_handler)(void* instance);
-  ILI9341_draw_handler_t draw_handler;
-  ILI9341_pre_task_callback_t pre_task_callback;
-  ILI9341_post_task_callback_t post_task_callback;
-  ILI9341_hal_set_chip_select_t set_chip_select;
-  ILI9341_hal_set_dc_select_t set_dc_select;
-  ILI9341_hal_configure_dma_t configure_dma;
-  ILI9341_hal_disable_dma_t disable_dma;
+  ROTARYENCODER_flags_t flags;
+  uint16_t debounce_count;
+  uint16_t clockwise_debounce_counter;
+  uint16_t counterclockwise_debounce_counter;
+  bool (*edge_trigger_check)(bool edge);
+  ROTARYENCODER_rotation_tick_callback_t rotation_tick_callback;
+  ROTARYENCODER_hal_is_phase_a_set_t is_phase_a_set;
+  ROTARYENCODER_hal_is_phase_b_set_t is_phase_b_set;
 }
-ILI9341_instance_t;
+ROTARYENCODER_instance_t;
 
 /*******************************************************************************
  *
- * ILI9341_dma_transfer_complete_handler
+ * ROTARYENCODER_initialize
  *
  * DESCRIPTION:
- *  Handler for the DMA transfer complete interrupt. The user code must call
- *  this function from their DMA transfer complete ISR.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
  *
- * IMPORTANT:
- *  The user MUST ensure that the DMA transmission complete interrupt is
- *  enabled and that this handler is called from that ISR.
+ * PARAMETERS:
+ *  See ROTARYENCODER_instance_t.
  *
  ******************************************************************************/
 
-void ILI9341_dma_transfer_complete_handler(ILI9341_instance_t* instance);
+void ROTARYENCODER_initialize(ROTARYENCODER_instance_t* instance,
+                              uint16_t debounce_count,
+                              ROTARYENCODER_edge_trigger_t edge_trigger,
+                              ROTARYENCODER_rotation_tick_callback_t rotation_tick_callback,
+                              ROTARYENCODER_hal_is_phase_a_set_t is_phase_a_set,
+                              ROTARYENCODER_hal_is_phase_b_set_t is_phase_b_set);
 
 /*******************************************************************************
  *
- * ILI9341_initialize
+ * ROTARYENCODER_service
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values.
- *
- * PARAMETERS:
- *  See ILI9341_instance_t.
+ *  Services the task state machine.
  *
  ******************************************************************************/
 
-void ILI9341_initialize(ILI9341_instance_t* instance,
-                        GFX2D_instance_t* gfx2d,
-                        UTIMER_instance_t* utimer,
-                        SERSPI_instance_t* spi,
-                        BUSMUTEX_instance_t* bus_mutex,
-                        BUSMUTEX_bus_id_t bus_id,
-                        uint32_t dma_bytes_per_transfer,
-                        uint32_t dma_transfer_timeout_us,
-                        ILI9341_draw_handler_t draw_handler,
-                        ILI9341_pre_task_callback_t pre_task_callback,
-                        ILI9341_post_task_callback_t post_task_callback,
-                        ILI9341_hal_set_chip_select_t set_chip_select,
-                        ILI9341_hal_set_dc_select_t set_dc_select,
-                        ILI9341_hal_configure_dma_t configure_dma,
-                        ILI9341_hal_disable_dma_t disable_dma);
+void ROTARYENCODER_service(ROTARYENCODER_instance_t* instance);
+
+/*
+ * Default number of quadrature state transitions per mechanical detent. Most
+ * encoders complete a full A/B cycle, 4 transitions, per detent.
+ */
+
+#define ROTARYENCODER_QUADRATURE_STEPS_PER_DETENT_DEFAULT  4U
 
 /*******************************************************************************
  *
- * ILI9341_configure_display
+ * ROTARYENCODER_quadrature_flags_t
  *
  * DESCRIPTION:
- *  Sends a series of commands to the display to initialize it and turn it on.
- *  The passed in array must follow a special format which indicates the
- *  commands and arguments to send. The format is as follows:
+ *  Table-driven quadrature decoder flags.
  *
- *    <command>, <arg_count>, <...arguments...>,
- *
- *  If the argument count is 0 then the arguments field is omitted. Additional
- *  custom commands can be found in ILI9341_custom_command_t. The delay command
- *  takes a single argument, which represents the number of milliseconds to
- *  delay, which takes the place of the arg_count field. Eg.
+ * reversed
+ *  Set to swap the clockwise and counter-clockwise directions.
  *
- *    <delay_command>, <ms>,
+ * acceleration_enabled
+ *  Set if detent deltas are multiplied according to rotation velocity.
  *
- *  The user must terminate the list with a 0x00 command.
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t reversed                      : 1;
+    uint8_t acceleration_enabled          : 1;
+    uint8_t reserved2                     : 6;
+  };
+}
+ROTARYENCODER_quadrature_flags_t;
+
+/*******************************************************************************
  *
- *    <0x00>
+ * ROTARYENCODER_detent_callback_t
  *
- *  This command is expected to be called soon after system initialization. To
- *  keep things simple, this function will block until the configuration is
- *  completed.
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called when the
+ *  table-driven quadrature decoder completes a detent.
  *
  * PARAMETERS:
- *  command_list
- *   List of bytes which follow the sequence described above.
+ *  context
+ *   User-provided context.
+ *
+ *  delta
+ *   Accelerated position change, positive for clockwise and negative for
+ *   counter-clockwise.
  *
  * NOTES:
- *  Included part of the command_list should be commands 0x2A and 0x2B which
- *  set the draw matrix on the display. For this library, the user should
- *  set the matrix to be the entire screen area. For example, a 128 by 160
- *  screen might look like this:
- *    0x2A, 4, 0x00, 0x00, 0x00, 0x7F,
- *    0x2B, 4, 0x00, 0x00, 0x00, 0x9F,
+ *  Can be initialized as NULL - YES
  *
  ******************************************************************************/
 
-void ILI9341_configure_display(ILI9341_instance_t* instance, const uint8_t* command_list);
+typedef void (*ROTARYENCODER_detent_callback_t)(uint32_t, int32_t);
 
 /*******************************************************************************
  *
- * ILI9341_begin_new_register_write
+ * ROTARYENCODER_quadrature_instance_t
  *
  * DESCRIPTION:
- *  Attempts to begin a new register write task.
+ *  Instance data for the table-driven quadrature decoder. Rather than
+ *  debouncing each phase, every A/B state change is looked up in a 16-entry
+ *  transition table indexed by the previous and current states. Contact
+ *  bounce then cancels itself out, no edges are lost on fast spins, and
+ *  impossible transitions (both phases changing at once) are counted.
  *
- * PARAMETERS:
- *  reg_address
- *   The register address or access code.
+ *  Several encoders sharing a GPIO port are decoded in one pass from a single
+ *  port sample, so the decoder can be run from a GPIO-change ISR or from a
+ *  batch of samples captured by a timer-triggered DMA.
  *
- *  buffer
- *   The buffer which holds the value to be written to the register.
+ * flags
+ *  See ROTARYENCODER_quadrature_flags_t.
  *
- *  length
- *   The length, in bytes, of the buffer (number of bytes to write).
+ * pin_a, pin_b
+ *  Bit positions of the A and B phases in the GPIO port sample.
+ *
+ * state
+ *  The last sampled A/B state as (A << 1) | B.
+ *
+ * step_accumulator
+ *  Net transitions since the last completed detent. Wider than the steps per
+ *  detent, so it holds any count up to a detent in either direction.
+ *
+ * steps_per_detent
+ *  Number of transitions which make up a single detent.
+ *
+ * acceleration_max_multiplier
+ *  The largest multiplier applied to a detent when turning at full speed.
+ *
+ * acceleration_threshold_us
+ *  Detents which arrive faster than this interval are accelerated. The
+ *  multiplier scales linearly from 1, at the threshold, up to the maximum
+ *  multiplier as the interval approaches 0.
+ *
+ * position
+ *  Accumulated, accelerated, position.
+ *
+ * illegal_transition_count
+ *  Number of impossible transitions detected, generally a sign of sampling
+ *  too slowly or of excessive noise.
+ *
+ * utimer
+ *  User-provided initialized instance of a UTIMER. Only required for
+ *  acceleration.
+ *
+ * utimer_ticket
+ *  Ticket created at every detent to measure the interval to the next one.
+ *
+ * callback_context
+ *  Context passed into the user detent callback.
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ * *_callback
+ *  User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
-bool ILI9341_begin_new_register_write(ILI9341_instance_t* instance,
-                                      uint8_t reg_address,
-                                      void* buffer,
-                                      uint32_t length);
+typedef struct
+{
+  ROTARYENCODER_quadrature_flags_t flags;
+  uint8_t pin_a;
+  uint8_t pin_b;
+  uint8_t state;
+  int16_t step_accumulator;
+  uint8_t steps_per_detent;
+  uint8_t acceleration_max_multiplier;
+  uint32_t acceleration_threshold_us;
+  volatile int32_t position;
+  uint32_t illegal_transition_count;
+  UTIMER_instance_t* utimer;
+  UTIMER_ticket_t utimer_ticket;
+  uint32_t callback_context;
+  ROTARYENCODER_detent_callback_t detent_callback;
+}
+ROTARYENCODER_quadrature_instance_t;
 
 /*******************************************************************************
  *
- * ILI9341_begin_new_register_read
+ * ROTARYENCODER_quadrature_initialize
  *
  * DESCRIPTION:
- *  Attempts to begin a new register read task.
+ *  Initializes a table-driven quadrature decoder instance, erasing all data
+ *  structures and setting default values. Acceleration is disabled.
  *
  * PARAMETERS:
- *  reg_address
- *   The register address or access code.
- *
- *  buffer
- *   The buffer which will hold the value read from the register.
- *
- *  length
- *   The length, in bytes, of the buffer (number of bytes to write).
+ *  See ROTARYENCODER_quadrature_instance_t.
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ *  port_sample
+ *   Current GPIO port value, used as the initial A/B state.
  *
  ******************************************************************************/
 
-bool ILI9341_begin_new_register_read(ILI9341_instance_t* instance,
-                                     uint8_t reg_address,
-                                     void* buffer,
-                                     uint32_t length);
+void ROTARYENCODER_quadrature_initialize(ROTARYENCODER_quadrature_instance_t* instance,
+                                         uint8_t pin_a,
+                                         uint8_t pin_b,
+                                         uint8_t steps_per_detent,
+                                         bool reversed,
+                                         uint32_t port_sample,
+                                         uint32_t callback_context,
+                                         ROTARYENCODER_detent_callback_t detent_callback);
 
 /*******************************************************************************
  *
- * ILI9341_begin_new_display_update
+ * ROTARYENCODER_quadrature_set_acceleration
  *
  * DESCRIPTION:
- *  Attempts to begin a new display update task.
+ *  Configures velocity-based acceleration. A maximum multiplier of 0 or 1
+ *  disables acceleration.
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ * PARAMETERS:
+ *  See ROTARYENCODER_quadrature_instance_t.
  *
  ******************************************************************************/
 
-bool ILI9341_begin_new_display_update(ILI9341_instance_t* instance);
+void ROTARYENCODER_quadrature_set_acceleration(ROTARYENCODER_quadrature_instance_t* instance,
+                                               UTIMER_instance_t* utimer,
+                                               uint32_t acceleration_threshold_us,
+                                               uint8_t acceleration_max_multiplier);
 
 /*******************************************************************************
  *
- * ILI9341_service
+ * ROTARYENCODER_quadrature_sample
  *
  * DESCRIPTION:
- *  Services the task state machine. Must be called repeatedly until the task
- *  is completed.
+ *  Decodes a single GPIO port sample for a group of encoders. Meant to be
+ *  called from the GPIO-change ISR of the port the encoders share.
  *
- * RETURN:
- *  False if there is an ongoing task which has not completed, else, true.
+ * PARAMETERS:
+ *  instances
+ *   Array of initialized decoder instances sharing the port.
+ *
+ *  instance_count
+ *   Number of instances in the array.
+ *
+ *  port_sample
+ *   The GPIO port value.
  *
  ******************************************************************************/
 
-bool ILI9341_service(ILI9341_instance_t* instance);
+void ROTARYENCODER_quadrature_sample(ROTARYENCODER_quadrature_instance_t* instances,
+                                     uint8_t instance_count,
+                                     uint32_t port_sample);
 
 /*******************************************************************************
  *
- * ILI9341_is_busy
+ * ROTARYENCODER_quadrature_process_samples
  *
  * DESCRIPTION:
- *  Determines if an instance is currently busy with a task.
+ *  Decodes a batch of GPIO port samples, in order, for a group of encoders.
+ *  Consecutive duplicate samples are skipped. Meant to be called with a buffer
+ *  of samples captured by a timer-triggered DMA.
  *
- * RETURN:
- *  True if the instance is busy with a task, else, false.
+ * PARAMETERS:
+ *  instances
+ *   Array of initialized decoder instances sharing the port.
+ *
+ *  instance_count
+ *   Number of instances in the array.
+ *
+ *  samples
+ *   Buffer of GPIO port values.
+ *
+ *  sample_count
+ *   Number of samples in the buffer.
+ *
+ * NOTES:
+ *  Acceleration measures detent intervals at processing time, hence, the
+ *  batch should be processed at least as often as the acceleration threshold.
  *
  ******************************************************************************/
 
-bool ILI9341_is_busy(ILI9341_instance_t* instance);
+void ROTARYENCODER_quadrature_process_samples(ROTARYENCODER_quadrature_instance_t* instances,
+                                              uint8_t instance_count,
+                                              const uint32_t* samples,
+                                              uint32_t sample_count);
 
 #ifdef __cplusplus
 }
 #endif
-#endif // ILI9XXX_J_H
+#endif // ROTARYENCODER_J_H
 
 /*******************************************************************************
  *
- *  RGB LED module which supports off, on, pattern, and ramping modes. Requires
- *  proper initialization and the service routine to be called periodically.
+ *  Deferred input event output for the BiButton and RotaryEncoder modules.
+ *  Instead of running user callbacks inline within the service routines, which
+ *  are often called from the system tick interrupt, compact timestamped events
+ *  are posted to a user-provided QUEUE for later processing. Requires proper
+ *  initialization.
+ *
+ *  The user QUEUE should be initialized with an element size equal to the
+ *  size of INPUTEVENT_event_t. The module posts events from the service
+ *  context and the application consumes them from its own context, hence the
+ *  QUEUE should be initialized as thread-safe.
+ *
+ *  Rapid rotary encoder ticks can optionally be coalesced into a single event
+ *  carrying the net rotation delta. Coalesced events are held back until the
+ *  coalescing window closes, which requires the service routine to be called
+ *  periodically from the same context the events are posted from.
  *
  ******************************************************************************/
 
-#ifndef RGB_J_H
-#define RGB_J_H
+#ifndef INPUTEVENT_J_H
+#define INPUTEVENT_J_H
 
 // Support C++ builds.
 
@@ -8419,1834 +13816,1939 @@ bool ILI9341_is_busy(ILI9341_instance_t* instance);
 extern "C" {
 #endif
 
-/*
- * Helper pre-compile function for creating a OFF 64-bit UI code.
- */
-
-#define RGB_MODE_OFF_UI_CODE()            0ULL
-
-/*
- * Helper pre-compile function for creating a ON 64-bit UI code with the use
- * of an palette index -- compare to RGB_led_mode_on_ui_t for the bit field
- * locations.
- */
-
-#define RGB_MODE_ON_PALETTE_UI_CODE(RGB_ARG_PALETTE_INDEX) \
-(                                           \
-  0ULL                                    | \
-  (uint64_t)RGB_ARG_PALETTE_INDEX << 32U  | \
-  1ULL << 40U                               \
-)
-
-/*
- * Helper pre-compile function for creating a ON 64-bit UI code with the use
- * of an RGB color-- compare to RGB_led_mode_on_ui_t for the bit field
- * locations.
- */
-
-#define RGB_MODE_ON_COLOR_UI_CODE(RGB_ARG_RED, RGB_ARG_GREEN, RGB_ARG_BLUE) \
-(                                           \
-  0ULL                                    | \
-  (uint64_t)RGB_ARG_RED << 0U             | \
-  (uint64_t)RGB_ARG_GREEN << 8U           | \
-  (uint64_t)RGB_ARG_BLUE << 16U             \
-)
-
-/*
- * Helper pre-compile function for creating a PATTERN 64-bit UI code -- compare
- * to RGB_led_mode_pattern_ui_t for the bit field locations.
- */
-
-#define RGB_MODE_PATTERN_UI_CODE(RGB_ARG_PATTERN, RGB_ARG_PHASES,     \
-                                 RGB_ARG_DIVISOR, RGB_ARG_ITERATIONS, \
-                                 RGB_ARG_FORCE_SYNC)                  \
-(                                           \
-  0ULL                                    | \
-  (uint64_t)RGB_ARG_PHASES << 0U          | \
-  (uint64_t)RGB_ARG_DIVISOR << 4U         | \
-  (uint64_t)RGB_ARG_FORCE_SYNC << 7U      | \
-  (uint64_t)RGB_ARG_ITERATIONS << 8U      | \
-  (uint64_t)RGB_ARG_PATTERN << 16U          \
-)
-
-/*
- * Helper pre-compile function for creating a RAMP 64-bit UI code -- compare to
- * RGB_led_mode_ramp_ui_t for the bit field locations.
- */
-
-#define RGB_MODE_RAMP_UI_CODE(RGB_ARG_PALETTE_START, RGB_ARG_PALETTE_END,  \
-                              RGB_ARG_ITERATIONS, RGB_ARG_START_DELAY,     \
-                              RGB_ARG_UP, RGB_ARG_UP_HOLD,                 \
-                              RGB_ARG_DOWN, RGB_ARG_DOWN_HOLD)             \
-(                                           \
-  0ULL                                    | \
-  (uint64_t)RGB_ARG_PALETTE_START << 0U   | \
-  (uint64_t)RGB_ARG_PALETTE_END << 4U     | \
-  (uint64_t)RGB_ARG_ITERATIONS << 8U      | \
-  (uint64_t)RGB_ARG_START_DELAY << 16U    | \
-  (uint64_t)RGB_ARG_UP << 24U             | \
-  (uint64_t)RGB_ARG_UP_HOLD << 32U        | \
-  (uint64_t)RGB_ARG_DOWN << 40U           | \
-  (uint64_t)RGB_ARG_DOWN_HOLD << 48U        \
-)
-
-/*
- * Instances of the RGB module are meant to be serviced periodically at a set
- * interval - generally serviced by the system tick interrupt. The default
- * value defined here is ideal for a 1-ms periodic tick as it divides the
- * pattern phases somewhat evenly across 1-second. (1000 / 12) = 83.333 The
- * user can adjust the variable value to speed up or slow down the pattern
- * and ramp animations.
- */
-
-#define RGB_TICKS_PER_QUANTA_DEFAULT      83U
-
-/*
- * The individual patterns of each LED are kept somewhat synchronous with each
- * other in an single instance by a instance-level step-counter. There are 12-
- * steps in a single instance period - each step is measured as a single
- * quanta which is defined by a tick count which is incremented each time the
- * instance service routine is called.
- */
-
-#define RGB_PATTERN_STEPS_PER_PERIOD      12U
-
-/*
- * The maximum pattern length, or phases, that a single LED can have. While
- * this value is the same as RGB_PATTERN_STEPS_PER_PERIOD, it is not treated
- * the same. Depending on the pattern divisor, a single iteration of the
- * pattern may or may not last longer than the instance period.
- */
-
-#define RGB_PATTERN_MAX_LENGTH            12U
-
-/*
- * In PATTERN and RAMP modes, an iteration value of 0 means that the animation
- * should run forever.
- */
-
-#define RGB_INFINITE_ITERATIONS           0U
-
-/*
- * Number of bits which compose the semaphore flag and associated maximum value
- * of the semaphore.
- */
-
-#define RGB_SEMAPHORE_BIT_LENGTH          8U
-#define RGB_SEMAPHORE_MAX_VALUE           ((1 << RGB_SEMAPHORE_BIT_LENGTH) - 1)
-
 /*******************************************************************************
  *
- * RGB_led_color_t
+ * INPUTEVENT_source_t
  *
  * DESCRIPTION:
- *  A 24-bit color is composed of a red, green, and blue intensity. Intensities
- *  will range from 0 to 255 (8-bits each).
- *
- * red
- *  The red intensity.
- *
- * green
- *  The green intensity.
- *
- * blue
- *  The blue intensity.
+ *  The module which generated an event.
  *
  ******************************************************************************/
 
-typedef union
+typedef enum
 {
-  uint32_t all;
-  struct
-  {
-    uint8_t red;
-    uint8_t green;
-    uint8_t blue;
-    uint8_t reserved;
-  };
+  INPUTEVENT_SOURCE_BIBUTTON              = 0,
+  INPUTEVENT_SOURCE_ROTARYENCODER
 }
-RGB_led_color_t;
+INPUTEVENT_source_t;
 
 /*******************************************************************************
  *
- * RGB_led_color_hr_t
+ * INPUTEVENT_event_t
  *
  * DESCRIPTION:
- *  In ramping mode, the interpolation between colors can be very subtle such
- *  that several quanta is needed to increment to the next ramp value in the
- *  range of 0 to 255. To simplify the math and keep track of the progress of
- *  the interpolation, the color intensities can be stored as 24-bit values.
- *  (We do not want to use the full 32-bits to avoid overflow during the math
- *  operations for interpolation -- besides, 24-bit resolution is high enough
- *  and may require less work than 31-bit.)
- *
- * red
- *  The red intensity in high-resolution 24-bit format.
- *
- * green
- *  The green intensity in high-resolution 24-bit format.
- *
- * blue
- *  The blue intensity in high-resolution 24-bit format.
- *
- ******************************************************************************/
-
-typedef struct
-{
-  int32_t red;
-  int32_t green;
-  int32_t blue;
-}
-RGB_led_color_hr_t;
-
-/*******************************************************************************
+ *  Single input event as stored on the user QUEUE.
  *
- * RGB_led_mode_id_t
+ * timestamp_us
+ *  UTIMER time, in microseconds, since module initialization at which the
+ *  event occurred. For coalesced events, the time of the first merged tick.
+ *  Wraps roughly every 71 minutes.
  *
- * DESCRIPTION:
- *  An LED can be in one of 4-modes: OFF, ON, PATTERN, and RAMP.
+ * origin
+ *  The matched BIBUTTON_pattern_instance_t or the ROTARYENCODER_instance_t
+ *  which generated the event.
  *
- ******************************************************************************/
-
-typedef enum
-{
-  RGB_LED_MODE_ID_OFF                     = 0,
-  RGB_LED_MODE_ID_ON,
-  RGB_LED_MODE_ID_PATTERN,
-  RGB_LED_MODE_ID_RAMP
-}
-RGB_led_mode_id_t;
-
-/*******************************************************************************
+ * context
+ *  The pattern callback context for button events, or the user-provided
+ *  context for rotary encoder events.
  *
- * RGB_pattern_divisor_t
+ * delta
+ *  Net number of rotation ticks, positive for clockwise and negative for
+ *  counter-clockwise. Always 0 for button events.
  *
- * DESCRIPTION:
- *  A pattern iteration can be slowed down by setting the divisor. The divisor
- *  must be able to evenly divide the number of steps in a pattern period.
- *  Hence, the allowed divisors are /1, /2, /3, /4, /6, /12. A truth table
- *  will be used on each pattern handler phase to check if the next phase of
- *  the LED pattern should become active based upon the instance pattern step.
+ * source
+ *  See INPUTEVENT_source_t.
  *
  ******************************************************************************/
 
-typedef enum
+typedef struct
 {
-  RGB_PATTERN_DIVISOR_1                   = 0,
-  RGB_PATTERN_DIVISOR_2,
-  RGB_PATTERN_DIVISOR_3,
-  RGB_PATTERN_DIVISOR_4,
-  RGB_PATTERN_DIVISOR_6,
-  RGB_PATTERN_DIVISOR_12,
-  RGB_PATTERN_DIVISOR_COUNT
+  uint32_t timestamp_us;
+  void* origin;
+  uint32_t context;
+  int16_t delta;
+  uint8_t source;
+  uint8_t reserved;
 }
-RGB_pattern_divisor_t;
+INPUTEVENT_event_t;
 
 /*******************************************************************************
  *
- * RGB_led_palette_slot_t
+ * INPUTEVENT_flags_t
  *
  * DESCRIPTION:
- *  Referring to an painter palette which provides quick access to working
- *  colors, each LED will have its own palette of customizable colors. The
- *  palette slot count is purposefully capped at 16 so that it a single palette
- *  index can be packed into 4-bits. To save memory space, the first several
- *  slots are shared amongst all the LEDs in the instance. The last few are
- *  unique for each LED.
+ *  Module flags.
  *
- * NOTE:
- *  The number of shared slots may be reduced by moving the position of
- *  RGB_LED_PALETTE_SHARED_COUNT. Checks are already in place to properly
- *  handle the palette index based upon shared versus unique palette.
+ * coalesce_enabled
+ *  Set if rotary encoder ticks are coalesced.
+ *
+ * pending
+ *  Set while a coalesced event is being accumulated and has not yet been
+ *  posted to the queue.
  *
  ******************************************************************************/
 
-typedef enum
+typedef union
 {
-  RGB_LED_PALETTE_SLOT_0                  = 0,
-  RGB_LED_PALETTE_SLOT_1                  = 1,
-  RGB_LED_PALETTE_SLOT_2                  = 2,
-  RGB_LED_PALETTE_SLOT_3                  = 3,
-  RGB_LED_PALETTE_SLOT_4                  = 4,
-  RGB_LED_PALETTE_SLOT_5                  = 5,
-  RGB_LED_PALETTE_SLOT_6                  = 6,
-  RGB_LED_PALETTE_SLOT_7                  = 7,
-  RGB_LED_PALETTE_SLOT_8                  = 8,
-  RGB_LED_PALETTE_SLOT_9                  = 9,
-  RGB_LED_PALETTE_SLOT_A                  = 10,
-  RGB_LED_PALETTE_SLOT_B                  = 11,
-  RGB_LED_PALETTE_SHARED_COUNT,
-  RGB_LED_PALETTE_SLOT_C                  = 12,
-  RGB_LED_PALETTE_SLOT_D                  = 13,
-  RGB_LED_PALETTE_SLOT_E                  = 14,
-  RGB_LED_PALETTE_SLOT_F                  = 15,
-  RGB_LED_PALETTE_SLOT_COUNT,
-  RGB_LED_PALETTE_UNIQUE_COUNT            = (RGB_LED_PALETTE_SLOT_COUNT -
-                                             RGB_LED_PALETTE_SHARED_COUNT)
+  uint8_t all;
+  struct
+  {
+    uint8_t coalesce_enabled              : 1;
+    uint8_t pending                       : 1;
+    uint8_t reserved2                     : 6;
+  };
 }
-RGB_led_palette_slot_t;
+INPUTEVENT_flags_t;
 
 /*******************************************************************************
  *
- * RGB_shared_palette_t
+ * INPUTEVENT_instance_t
  *
  * DESCRIPTION:
- *  The palette which is shared with all the LEDs in a single instance.
+ *  Instance data and function pointers.
+ *
+ * flags
+ *  Module flags.
+ *
+ * queue
+ *  User-provided initialized instance of a QUEUE which holds the events.
+ *
+ * utimer
+ *  User-provided initialized instance of a UTIMER.
+ *
+ * utimer_ticket
+ *  Ticket created at initialization which serves as the timestamp epoch.
+ *
+ * coalesce_window_us
+ *  Time, in microseconds, over which consecutive ticks from the same encoder
+ *  are merged into a single event. A value of 0 disables coalescing.
+ *
+ * pending_event
+ *  Coalesced event being accumulated.
+ *
+ * dropped_count
+ *  Number of events which could not be posted because the queue was full.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  RGB_led_color_t slots[RGB_LED_PALETTE_SHARED_COUNT];
+  INPUTEVENT_flags_t flags;
+  QUEUE_instance_t* queue;
+  UTIMER_instance_t* utimer;
+  UTIMER_ticket_t utimer_ticket;
+  uint32_t coalesce_window_us;
+  INPUTEVENT_event_t pending_event;
+  uint32_t dropped_count;
 }
-RGB_shared_palette_t;
+INPUTEVENT_instance_t;
 
 /*******************************************************************************
  *
- * RGB_led_palette_t
+ * INPUTEVENT_initialize
  *
  * DESCRIPTION:
- *  The palette which is unique to each LED in the instance.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
+ *
+ * PARAMETERS:
+ *  See INPUTEVENT_instance_t.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  RGB_led_color_t slots[RGB_LED_PALETTE_UNIQUE_COUNT];
-}
-RGB_led_palette_t;
+void INPUTEVENT_initialize(INPUTEVENT_instance_t* instance,
+                           QUEUE_instance_t* queue,
+                           UTIMER_instance_t* utimer,
+                           uint32_t coalesce_window_us);
 
 /*******************************************************************************
  *
- * RGB_led_mode_on_ui_t
+ * INPUTEVENT_post
  *
  * DESCRIPTION:
- *  User-interface values for the ON mode.
+ *  Timestamps and posts a new event. Rotary encoder events are merged into
+ *  the pending coalesced event when coalescing is enabled. Any pending event
+ *  from a different origin is posted first so that event order is retained.
  *
- * red
- *  Red color intensity.
+ * PARAMETERS:
+ *  See INPUTEVENT_event_t.
  *
- * green
- *  Green color intensity.
+ * RETURN:
+ *  True if the event was posted or coalesced, else, false if the queue was
+ *  full and the event was dropped.
  *
- * blue
- *  Blue color intensity.
+ ******************************************************************************/
+
+bool INPUTEVENT_post(INPUTEVENT_instance_t* instance,
+                     INPUTEVENT_source_t source,
+                     void* origin,
+                     uint32_t context,
+                     int16_t delta);
+
+/*******************************************************************************
  *
- * palette
- *  RGB output color as described by a palette color slot.
+ * INPUTEVENT_service
  *
- * use_palette
- *  Flag indicating if the palette value should be used (true), or if the
- *  32-bit RGB color should be used.
+ * DESCRIPTION:
+ *  Posts the pending coalesced event once its coalescing window has closed.
+ *  Must be called periodically from the same context which posts events.
  *
- * NOTES:
- *  The red, green, and blue values were taken out of the rgb_led_color
- *  structure context to guard against Endianess in bit-shifting.
+ * RETURN:
+ *  False if a coalesced event is still pending, else, true.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint64_t all;
-  struct
-  {
-    uint64_t red                          : 8;
-    uint64_t green                        : 8;
-    uint64_t blue                         : 8;
-    uint64_t reserved24                   : 8;
-    uint64_t palette                      : 4;
-    uint64_t reserved36                   : 4;
-    uint64_t use_palette                  : 1;
-    uint64_t reserved41                   : 7;
-    uint64_t reserved48                   : 16;
-  };
-}
-RGB_led_mode_on_ui_t;
+bool INPUTEVENT_service(INPUTEVENT_instance_t* instance);
 
 /*******************************************************************************
  *
- * RGB_led_mode_on_t
+ * INPUTEVENT_dispatch
  *
  * DESCRIPTION:
- *  Internal working variables for the ON mode including the UI subset.
+ *  Dequeues a single event and calls the callback which would have been
+ *  called inline by the source module. Button events call the matched pattern
+ *  callback. Rotary encoder events call the encoder rotation tick callback
+ *  once per tick of the event delta. Meant to be called from the application
+ *  context.
+ *
+ * PARAMETERS:
+ *  event
+ *   Pointer to a location to store a copy of the dispatched event. Can be
+ *   NULL if the copy is not needed.
+ *
+ * RETURN:
+ *  True if an event was dequeued and dispatched, else, false.
  *
  ******************************************************************************/
 
-typedef union
-{
-  RGB_led_mode_on_ui_t ui;
-}
-RGB_led_mode_on_t;
+bool INPUTEVENT_dispatch(INPUTEVENT_instance_t* instance, INPUTEVENT_event_t* event);
 
 /*******************************************************************************
  *
- * RGB_led_mode_pattern_ui_t
+ * INPUTEVENT_attach_bibutton
  *
  * DESCRIPTION:
- *  User-interface values for the PATTERN mode.
+ *  Sets the match handler of a compiled BIBUTTON matcher so that pattern
+ *  matches are posted as events instead of calling the pattern callbacks
+ *  inline. Must be called after BIBUTTON_matcher_compile.
  *
- * phases
- *  Length of, or number of phases (4-bit palette colors), in the pattern value.
+ * PARAMETERS:
+ *  matcher
+ *   Compiled BIBUTTON matcher serviced through BIBUTTON_matcher_service.
  *
- * divisor
- *  Divides the pattern phase rate by RGB_pattern_divisor_t.
+ ******************************************************************************/
+
+void INPUTEVENT_attach_bibutton(INPUTEVENT_instance_t* instance,
+                                BIBUTTON_matcher_t* matcher);
+
+/*******************************************************************************
  *
- * force_sync
- *  Forces the instance pattern step to reset to step-0, thus causing any new
- *  pattern(s) to start immediately. Otherwise, new pattern(s) will not begin
- *  until the instance pattern step reaches step-0.
+ * INPUTEVENT_rotaryencoder_service
  *
- * iterations
- *  Number of times to repeat the pattern. Value 0 indicates repeat forever.
+ * DESCRIPTION:
+ *  Replacement for ROTARYENCODER_service which posts rotation ticks as events
+ *  instead of calling the rotation tick callback inline. The encoder callback
+ *  is left untouched for use by INPUTEVENT_dispatch.
  *
- * pattern
- *  Up to 12-phases defined by palette slot colors at 4-bits each. For example,
- *  a pattern that traverses from palette slots 0 -> 1 -> 2 -> 3 would be
- *  0x3210.
+ * PARAMETERS:
+ *  encoder
+ *   Initialized instance of a ROTARYENCODER.
+ *
+ *  context
+ *   Value stored as the event context.
+ *
+ * NOTES:
+ *  The rotation tick callback of the encoder has no context parameter, hence,
+ *  the active instance is held by the module while the encoder is serviced.
+ *  All encoders routed through this function must be serviced from a single
+ *  context (i.e. the same interrupt).
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint64_t all;
-  struct
-  {
-    uint64_t phases                       : 4;
-    uint64_t divisor                      : 3;
-    uint64_t force_sync                   : 1;
-    uint64_t iterations                   : 8;
-    uint64_t pattern                      : 48;
-  };
+void INPUTEVENT_rotaryencoder_service(INPUTEVENT_instance_t* instance,
+                                      ROTARYENCODER_instance_t* encoder,
+                                      uint32_t context);
+
+#ifdef __cplusplus
 }
-RGB_led_mode_pattern_ui_t;
+#endif
+#endif // INPUTEVENT_J_H
 
 /*******************************************************************************
  *
- * RGB_led_mode_pattern_t
+ *  Supports both bit-banged and SPI methods. Both methods require proper
+ *  initialization and the service routine to be called repeatedly after a new
+ *  task request until the task is completed.
  *
- * DESCRIPTION:
- *  Internal working variables for the PATTERN mode including the UI subset.
+ *  A shift PISO is generally composed of three operation pins - shift/latch
+ *  (SL), clock (CLK), and serial output (SO). SL is pulled low to activate
+ *  the latch. A rising clock edge will cause the parallel input pins to be
+ *  read. SL is then pulled high to activate shift mode. Each rising clock
+ *  edge will shift the contents of each register to the next register in
+ *  line. The last register in the apparatus will output to SO.
  *
- * working_pattern
- *  Pattern which originally gets set to the pattern value and then is shifted
- *  by 4-bits at each new phase in the LED pattern.
+ *  In the SPI method, the task takes place in two SPI transactions. The first
+ *  triggers the latch and the second shifts the values out. The pins should
+ *  be as follows:
  *
- * phase_counter
- *  Keeps track of the number of pattern phases of the LED pattern which have
- *  passed.
+ *   MOSI - Latch(0)/Shift(1)
+ *   MISO - Serial Output (Q)
+ *   CLK  - CLK
  *
- * iteration_counter
- *  Keeps track of the number of times the pattern has repeated.
+ *  Shift registers generally have a propagation delay of around 50nS or less.
+ *  Hence, the application code should set the SPI frequency to around 20MHz or
+ *  slower.
+ *
+ *  The nature of the shift register is that the first bit to enter the shift
+ *  apparatus will actually be the "last" bit, or the farthest away bit, from
+ *  the head where the MOSI and CLK are connected. The resulting bit order
+ *  will differ depending on the endianness of the processor and the method
+ *  used.
+ *
+ *  This module has been tested on both active low and active high MOSI/CLK
+ *  configurations.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  RGB_led_mode_pattern_ui_t ui;
-  uint64_t working_pattern;
-  uint8_t phase_counter;
-  uint8_t iteration_counter;
-}
-RGB_led_mode_pattern_t;
+#ifndef SHIFTPISO_J_H
+#define SHIFTPISO_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /*******************************************************************************
  *
- * RGB_led_mode_ramp_ui_t
+ * SHIFTPISO_flags_t
  *
  * DESCRIPTION:
- *  User-interface values for the RAMP mode.
+ *  Module flags.
  *
- * palette_start
- *  Starting color for the ramp-up and hold value for the ramp_down_hold.
+ * busy
+ *  Set when the module is busy with a task and cleared when the task is
+ *  completed.
  *
- * palette_end
- *  Starting color for the ramp-down and hold value for the ramp_up_hold.
+ * bit_banged
+ *  Set if the instance has been initialized to use the bit-banging method.
  *
- * iterations
- *  Number of times to repeat the ramp. Value 0 indicates repeat forever.
+ * task_state
+ *  State machine state.
  *
- * start_delay_quanta
- *  Quanta to wait before starting the ramp-up. This delay is only done once on
- *  the first iteration of the ramp.
+ ******************************************************************************/
+
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t busy                          : 1;
+    uint8_t bit_banged                    : 1;
+    uint8_t reserved2                     : 2;
+    uint8_t task_state                    : 3;
+    uint8_t reserved7                     : 1;
+  };
+}
+SHIFTPISO_flags_t;
+
+/*******************************************************************************
  *
- * ramp_up_quanta
- *  Quanta to ramp-up from the start to end colors.
+ * SHIFTPISO_error_flags_t
  *
- * ramp_up_hold_quanta
- *  Quanta to hold the palette_end color after the ramp-up.
+ * DESCRIPTION:
+ *  Module error flags.
  *
- * ramp_down_quanta
- *  Quanta to ramp-down from the end to start colors.
+ * other
+ *  All other types of errors.
  *
- * ramp_down_hold_quanta
- *  Quanta to hold the palette_start color after the ramp-down.
+ * spi
+ *  Errors relating to the SPI.
  *
  ******************************************************************************/
 
 typedef union
 {
-  uint64_t all;
+  uint8_t all;
   struct
   {
-    uint64_t palette_start                : 4;
-    uint64_t palette_end                  : 4;
-    uint64_t iterations                   : 8;
-    uint64_t start_delay_quanta           : 8;
-    uint64_t ramp_up_quanta               : 8;
-    uint64_t ramp_up_hold_quanta          : 8;
-    uint64_t ramp_down_quanta             : 8;
-    uint64_t ramp_down_hold_quanta        : 8;
-    uint64_t reserved56                   : 8;
+    uint8_t other                         : 1;
+    uint8_t spi                           : 1;
+    uint8_t reserved2                     : 6;
   };
 }
-RGB_led_mode_ramp_ui_t;
+SHIFTPISO_error_flags_t;
 
 /*******************************************************************************
  *
- * RGB_led_mode_ramp_t
+ * SHIFTPISO_pre_task_callback_t
  *
  * DESCRIPTION:
- *  Internal working variables for the RAMP mode including the UI subset.
- *
- * hres_start
- *  High resolution equivalent of the start color.
+ *  Function template for a user-provided function which is called when a new
+ *  task is accepted and initialized but before the task actually begins. This
+ *  allows the user to perform any last additional configurations before the
+ *  actual logic of the task begins.
  *
- * hres_end
- *  High resolution equivalent of the end color.
+ * PARAMETERS:
+ *  context
+ *   User-provided context.
  *
- * hres_color
- *  High resolution equivalent of the current output color.
+ * NOTES:
+ *  Can be initialized as NULL - YES
  *
- * hres_step_up
- *  Interpolation step between the start and end colors during each ramp-up
- *  tick.
+ ******************************************************************************/
+
+typedef void (*SHIFTPISO_pre_task_callback_t)(uint32_t);
+
+/*******************************************************************************
  *
- * hres_step_down
- *  Interpolation step between the end and start colors during each ramp-down
- *  tick.
+ * SHIFTPISO_post_task_callback_t
  *
- * iteration_counter
- *  Keeps track of the number of times the ramp has repeated.
+ * DESCRIPTION:
+ *  Function template for a user-provided function which is called after a
+ *  task completes.
  *
- * tick_counter
- *  Keeps track of the number of times the ramp service has been called.
+ * PARAMETERS:
+ *  context
+ *   User-provided context.
  *
- * quanta_counter
- *  Keeps track of the number of quanta (N ticks in a quanta) which have
- *  passed. This value is compared to the various ramp quanta timing values
- *  and is reset to 0 at the start of each new ramping state.
+ * NOTES:
+ *  Can be initialized as NULL - YES
  *
  ******************************************************************************/
 
-typedef struct
-{
-  RGB_led_mode_ramp_ui_t ui;
-  RGB_led_color_hr_t hres_start;
-  RGB_led_color_hr_t hres_end;
-  RGB_led_color_hr_t hres_color;
-  RGB_led_color_hr_t hres_step_up;
-  RGB_led_color_hr_t hres_step_down;
-  uint8_t iteration_counter;
-  uint8_t tick_counter;
-  uint8_t quanta_counter;
-}
-RGB_led_mode_ramp_t;
+typedef void (*SHIFTPISO_post_task_callback_t)(uint32_t);
 
 /*******************************************************************************
  *
- * RGB_led_mode_t
+ * SHIFTPISO_hal_set_clock_t
  *
  * DESCRIPTION:
- *  Union of the LED modes to save memory space - each LED can only be in
- *  one mode at a time.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will set the shift/latch clock line high or low.
+ *
+ * PARAMETERS:
+ *  value
+ *   True to set high, false to set low.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef union
-{
-  RGB_led_mode_on_t on;
-  RGB_led_mode_pattern_t pattern;
-  RGB_led_mode_ramp_t ramp;
-}
-RGB_led_mode_t;
+typedef void (*SHIFTPISO_hal_set_clock_t)(bool);
 
 /*******************************************************************************
  *
- * RGB_led_mode_flags_t
+ * SHIFTPISO_hal_set_latch_shift_t
  *
  * DESCRIPTION:
- *  Additional flags related to the LED mode.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will set the latch/shift line high or low.
  *
- * mode
- *  Current mode of the LED, RGB_led_mode_id_t.
+ * PARAMETERS:
+ *  value
+ *   True to activate latch, else, false to activate shift.
  *
- * busy
- *  Set true when the LED is performing a finite animation and automatically set
- *  false when that animation finishes. The OFF, ON, and infinite patterns or
- *  ramps will keep this flag false.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
- * repeat_forever
- *  Indicates that the pattern or ramp should repeat forever.
+ ******************************************************************************/
+
+typedef void (*SHIFTPISO_hal_set_latch_shift_t)(bool);
+
+/*******************************************************************************
  *
- * new_pattern
- *  Indicates that the LED in pattern mode has a new pattern and should wait
- *  for the first global pattern phase to activate.
+ * SHIFTPISO_hal_get_serial_t
  *
- * ramp_state
- *  State of the ramp state machine, RGB_ramp_state_t.
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will get the serial line state.
+ *
+ * RETURN:
+ *  True if the line is high, else, false.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t mode                          : 3;
-    uint8_t busy                          : 1;
-    uint8_t repeat_forever                : 1;
-    uint8_t new_pattern                   : 1;
-    uint8_t ramp_state                    : 3;
-  };
-}
-RGB_led_mode_flags_t;
+typedef bool (*SHIFTPISO_hal_get_serial_t)(void);
 
 /*******************************************************************************
  *
- * RGB_led_t
+ * SHIFTPISO_instance_t
  *
  * DESCRIPTION:
- *  RGB LED settings and data variable collection.
+ *  Instance data and function pointers.
  *
  * flags
- *  Mode flags.
+ *  Module flags.
  *
- * data
- *  Mode data variables.
+ * errors
+ *  Errors which occurred in the last transaction.
  *
- * palette
- *  Unique customizable palette for the LED.
+ * utimer
+ *  User-provided initialized instance of a UTIMER.
  *
- * output
- *  The final generated RGB output of the LED.
+ * utimer_ticket
+ *  Data structure used with the UTIMER instance.
+ *
+ * spi
+ *  User-provided initialized instance of a SERSPI.
+ *
+ * bus_mutex
+ *  User-provided initialized instance of a BUSMUTEX.
+ *
+ * bus_id
+ *  The BUS ID associated with the BUSMUTEX instance.
+ *
+ * propagation_delay_us
+ *  Microseconds required to delay between hardware operations in order to
+ *  allow the internal circuits to stabilize.
+ *
+ * register_count
+ *  Total number of shift registers (total channels, not the number of physical
+ *  devices) in the apparatus.
+ *
+ * register_counter
+ *  Keeps track of the which register is currently being serviced.
+ *
+ * byte_offset
+ *  Keeps track of the byte offset in the serial buffer.
+ *
+ * bit_offset
+ *  Keeps track of the bit offset in the serial buffer.
+ *
+ * serial_buffer_length
+ *  Required length, in bytes, of the serial buffer.
+ *
+ * serial_buffer
+ *  Buffer which stores the shift register values to be written.
+ *
+ * callback_context
+ *  Context passed into the user pre/post task callbacks.
+ *
+ * service_handler
+ *  Internal-use pointer to the active state machine service.
+ *
+ * *_task_*
+ * *_hal_*
+ *  User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  RGB_led_mode_flags_t flags;
-  RGB_led_mode_t data;
-  RGB_led_palette_t palette;
-  RGB_led_color_t output;
+  SHIFTPISO_flags_t flags;
+  SHIFTPISO_error_flags_t errors;
+  UTIMER_instance_t* utimer;
+  UTIMER_ticket_t utimer_ticket;
+  SERSPI_instance_t* spi;
+  BUSMUTEX_instance_t* bus_mutex;
+  BUSMUTEX_bus_id_t bus_id;
+  uint16_t propagation_delay_us;
+  uint16_t register_count;
+  uint16_t register_counter;
+  uint16_t byte_offset;
+  uint8_t bit_offset;
+  uint16_t serial_buffer_length;
+  uint8_t* serial_buffer;
+  uint32_t callback_context;
+  bool (*service_handler)(void*);
+  SHIFTPISO_pre_task_callback_t pre_task_callback;
+  SHIFTPISO_post_task_callback_t post_task_callback;
+  SHIFTPISO_hal_set_clock_t set_clock;
+  SHIFTPISO_hal_set_latch_shift_t set_latch_shift;
+  SHIFTPISO_hal_get_serial_t get_serial;
 }
-RGB_led_t;
+SHIFTPISO_instance_t;
 
 /*******************************************************************************
  *
- * RGB_flags_t
+ * SHIFTPISO_initialize
  *
  * DESCRIPTION:
- *  Module flags.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values. SPI method.
  *
- * halt_semaphore
- *  Provides a way to halt the service of pattern and ramp LEDs. This allows
- *  the user to prepare all the LEDs to their liking and then un-halt the
- *  instance and allow the LEDs to begin their animations at the same time.
+ * PARAMETERS:
+ *  See SHIFTPISO_instance_t.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t halt_semaphore                : RGB_SEMAPHORE_BIT_LENGTH;
-  };
-}
-RGB_flags_t;
+void SHIFTPISO_initialize(SHIFTPISO_instance_t* instance,
+                          SERSPI_instance_t* spi,
+                          BUSMUTEX_instance_t* bus_mutex,
+                          BUSMUTEX_bus_id_t bus_id,
+                          uint16_t register_count,
+                          SHIFTPISO_pre_task_callback_t pre_task_callback,
+                          SHIFTPISO_post_task_callback_t post_task_callback);
 
 /*******************************************************************************
  *
- * RGB_instance_t
+ * SHIFTPISO_initialize_bb
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
- *
- * flags
- *  Module flags.
- *
- * ticks_per_quanta
- *  A tick is defined as an entry into the service routine, which routine is
- *  meant to be called periodically. After every N-ticks, the quanta counter
- *  is incremented. When initialized, the value will be set to the default
- *  RGB_TICKS_PER_QUANTA_DEFAULT.
- *
- * pattern_step_counter
- *  Keeps track of the instance pattern step. Incremented at the start of a
- *  new quanta and reset to 0 after the 12th quanta.
- *
- * pattern_tick_counter
- *  Keeps track of the instance pattern tick counter. Every N-ticks will
- *  increment the pattern_step_counter.
- *
- * palette
- *  The shared color palette for all LEDs in the instance.
- *
- * led_count
- *  Number of RGB LEDs in the instance led_list.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values. Bit-bang method.
  *
- * led_list
- *  List of RGB LEDs.
+ * PARAMETERS:
+ *  See SHIFTPISO_instance_t.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  RGB_flags_t flags;
-  uint8_t ticks_per_quanta;
-  uint8_t pattern_step_counter;
-  uint8_t pattern_tick_counter;
-  RGB_shared_palette_t palette;
-  uint32_t led_count;
-  RGB_led_t* led_list;
-}
-RGB_instance_t;
+void SHIFTPISO_initialize_bb(SHIFTPISO_instance_t* instance,
+                             UTIMER_instance_t* utimer,
+                             uint16_t propagation_delay_us,
+                             uint16_t register_count,
+                             SHIFTPISO_pre_task_callback_t pre_task_callback,
+                             SHIFTPISO_post_task_callback_t post_task_callback,
+                             SHIFTPISO_hal_set_clock_t set_clock,
+                             SHIFTPISO_hal_set_latch_shift_t set_latch_shift,
+                             SHIFTPISO_hal_get_serial_t get_serial);
 
 /*******************************************************************************
  *
- * RGB_initialize
+ * SHIFTPISO_begin_new_read
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values.
+ *  Attempts to begin a new serial input task.
  *
  * PARAMETERS:
- *  See RGB_instance_t.
+ *  serial_buffer
+ *   Buffer which will hold the read data. Each bit represents a single
+ *   register. The buffer should be large enough to accommodate the entirety of
+ *   the shift apparatus.
+ *
+ * RETURN:
+ *  True if the task request was accepted, else, false.
  *
  ******************************************************************************/
 
-void RGB_initialize(RGB_instance_t* instance,
-                    RGB_led_t* led_list,
-                    uint32_t led_count);
+bool SHIFTPISO_begin_new_read(SHIFTPISO_instance_t* instance, uint8_t* serial_buffer);
 
 /*******************************************************************************
  *
- * RGB_set_ticks_per_quanta
+ * SHIFTPISO_service
  *
  * DESCRIPTION:
- *  Sets the instance ticks per quanta value. Decreasing the tick value will
- *  speed up the pattern and ramp animations, and increasing the tick value
- *  will slow the animations down.
+ *  Services the task state machine. Must be called repeatedly until the task
+ *  is completed.
  *
- * PARAMETERS:
- *  ticks
- *   Value ranging from 0-255. A value of 0 will cause the default value to
- *   be written.
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true.
  *
  ******************************************************************************/
 
-void RGB_set_ticks_per_quanta(RGB_instance_t* instance, uint8_t ticks);
+bool SHIFTPISO_service(SHIFTPISO_instance_t* instance);
 
 /*******************************************************************************
  *
- * RGB_halt_semaphore_increment
+ * SHIFTPISO_is_busy
  *
  * DESCRIPTION:
- *  Increases the halt semaphore count by 1. The halt semaphore enables/
- *  disables the instance from servicing. This allows for a momentary hold
- *  while LEDs are synchronized so that the animations of all LEDs in the
- *  instance can all begin together. LED servicing will only run when the
- *  semaphore count is 0.
+ *  Determines if an instance is currently busy with a task.
+ *
+ * RETURN:
+ *  True if the instance is busy with a task, else, false.
  *
  ******************************************************************************/
 
-void RGB_halt_semaphore_increment(RGB_instance_t* instance);
+bool SHIFTPISO_is_busy(SHIFTPISO_instance_t* instance);
+
+/*
+ * Number of 32-bit words needed for each of the change-monitor buffers of a
+ * shift register apparatus with the given number of registers.
+ */
+
+#define SHIFTPISO_MONITOR_BUFFER_WORDS(REGISTER_COUNT)  (((REGISTER_COUNT) + 31U) / 32U)
 
 /*******************************************************************************
  *
- * RGB_halt_semaphore_decrement
+ * SHIFTPISO_change_callback_t
  *
  * DESCRIPTION:
- *  Decreases the halt semaphore count by 1. The halt semaphore enables/
- *  disables the instance from servicing. This allows for a momentary hold
- *  while LEDs are synchronized so that the animations of all LEDs in the
- *  instance can all begin together. LED servicing will only run when the
- *  semaphore count is 0.
+ *  Function template for a user-provided function which is called when a
+ *  monitored sample differs from the previous sample.
+ *
+ * PARAMETERS:
+ *  context
+ *   User-provided context.
+ *
+ *  inputs
+ *   The newly sampled input states, laid out as in SHIFTPISO_begin_new_read.
+ *
+ *  changed
+ *   Change mask with the same layout, where set bits are inputs which have
+ *   changed state since the previous sample.
+ *
+ *  length
+ *   Length, in bytes, of the input and change buffers.
+ *
+ * NOTES:
+ *  Both buffers are only valid for the duration of the call.
  *
  ******************************************************************************/
 
-void RGB_halt_semaphore_decrement(RGB_instance_t* instance);
+typedef void (*SHIFTPISO_change_callback_t)(uint32_t, const uint8_t*, const uint8_t*, uint16_t);
 
 /*******************************************************************************
  *
- * RGB_set_palette_slot_color
+ * SHIFTPISO_monitor_flags_t
  *
  * DESCRIPTION:
- *  Sets the RGB color of a palette slot.
+ *  Change-monitor flags.
  *
- * PARAMETERS:
- *  led_index
- *   Index of the LED palette. This is not applicable and can be set as 0 if
- *   the palette index is within the shared instance palette.
+ * enabled
+ *  Set while the monitor is free-running.
  *
- *  palette_index
- *   Index of the palette slot. The index is analyzed to determine if the
- *   palette slot is within the shared or unique LED palette.
+ * read_in_progress
+ *  Set while a sample is being read.
  *
- *  red, green, blue
- *   Color intensities.
+ * baseline_valid
+ *  Set once a first sample has been read to compare against.
  *
  ******************************************************************************/
 
-void RGB_set_palette_slot_color(RGB_instance_t* instance,
-                                uint32_t led_index,
-                                uint8_t palette_index,
-                                uint8_t red,
-                                uint8_t green,
-                                uint8_t blue);
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t enabled                       : 1;
+    uint8_t read_in_progress              : 1;
+    uint8_t baseline_valid                : 1;
+    uint8_t reserved3                     : 5;
+  };
+}
+SHIFTPISO_monitor_flags_t;
 
 /*******************************************************************************
  *
- * RGB_get_palette_slot_color
+ * SHIFTPISO_monitor_instance_t
  *
  * DESCRIPTION:
- *  Gets the RGB color of a palette slot.
+ *  Free-running sampler for a shift PISO apparatus which only reports inputs
+ *  which have changed. Samples are double-buffered - each new sample is read
+ *  into one buffer while the other holds the previous sample, and the change
+ *  mask is computed in place with a word-by-word XOR. The callback is only
+ *  called when at least one input has changed.
  *
- * PARAMETERS:
- *  led_index
- *   Index of the LED palette. This is not applicable and can be set as 0 if
- *   the palette index is within the shared instance palette.
+ * flags
+ *  See SHIFTPISO_monitor_flags_t.
  *
- *  palette_index
- *   Index of the palette slot. The index is analyzed to determine if the
- *   palette slot is within the shared or unique LED palette.
+ * piso
+ *  User-provided initialized instance of a SHIFTPISO. The monitor drives the
+ *  instance service routine, which must not be called elsewhere.
  *
- * RETURN:
- *  The RGB color of the palette slot.
+ * utimer
+ *  User-provided initialized instance of a UTIMER.
+ *
+ * utimer_ticket
+ *  Data structure used with the UTIMER instance to pace samples.
+ *
+ * sample_period_us
+ *  Time, in microseconds, from the start of one sample to the start of the
+ *  next. A value of 0 samples back-to-back.
+ *
+ * buffers
+ *  User-provided, 32-bit aligned, sample buffers. Each must be at least
+ *  SHIFTPISO_MONITOR_BUFFER_WORDS(register_count) words long.
+ *
+ * read_index
+ *  Index of the buffer the next sample is read into.
+ *
+ * word_count
+ *  Number of words compared per sample.
+ *
+ * sample_counter
+ *  Number of samples taken.
+ *
+ * callback_context
+ *  Context passed into the user change callback.
+ *
+ * *_callback
+ *  User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
-RGB_led_color_t RGB_get_palette_slot_color(RGB_instance_t* instance,
-                                            uint32_t led_index,
-                                            uint8_t palette_index);
+typedef struct
+{
+  SHIFTPISO_monitor_flags_t flags;
+  SHIFTPISO_instance_t* piso;
+  UTIMER_instance_t* utimer;
+  UTIMER_ticket_t utimer_ticket;
+  uint32_t sample_period_us;
+  uint32_t* buffers[2];
+  uint8_t read_index;
+  uint16_t word_count;
+  uint32_t sample_counter;
+  uint32_t callback_context;
+  SHIFTPISO_change_callback_t change_callback;
+}
+SHIFTPISO_monitor_instance_t;
 
 /*******************************************************************************
  *
- * RGB_set_mode_off
+ * SHIFTPISO_monitor_initialize
  *
  * DESCRIPTION:
- *  Sets the RGB LED into off mode, setting the output color to all 0's.
+ *  Initializes a change-monitor instance, erasing all data structures and
+ *  setting default values. The monitor is enabled and the first sample serves
+ *  as the baseline without being reported.
  *
  * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
+ *  See SHIFTPISO_monitor_instance_t.
+ *
+ *  buffer_a, buffer_b
+ *   See buffers.
  *
  ******************************************************************************/
 
-void RGB_set_mode_off(RGB_instance_t* instance, uint32_t led_index);
+void SHIFTPISO_monitor_initialize(SHIFTPISO_monitor_instance_t* instance,
+                                  SHIFTPISO_instance_t* piso,
+                                  UTIMER_instance_t* utimer,
+                                  uint32_t* buffer_a,
+                                  uint32_t* buffer_b,
+                                  uint32_t sample_period_us,
+                                  uint32_t callback_context,
+                                  SHIFTPISO_change_callback_t change_callback);
 
 /*******************************************************************************
  *
- * RGB_set_all_off
+ * SHIFTPISO_monitor_enable
  *
  * DESCRIPTION:
- *  Sets all RGB LEDs into off mode, setting the output color to all 0's.
+ *  Enables or disables free-running sampling. A sample in progress completes
+ *  and is reported normally. Re-enabling keeps the previous baseline.
+ *
+ * PARAMETERS:
+ *  enable
+ *   True to enable sampling, else, false.
  *
  ******************************************************************************/
 
-void RGB_set_all_off(RGB_instance_t* instance);
+void SHIFTPISO_monitor_enable(SHIFTPISO_monitor_instance_t* instance, bool enable);
 
 /*******************************************************************************
  *
- * RGB_set_mode_on
+ * SHIFTPISO_monitor_service
  *
  * DESCRIPTION:
- *  Sets the RGB LED into on mode.
- *
- * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
+ *  Services the monitor - starts new samples at the sample rate, services the
+ *  SHIFTPISO task, and reports changes when a sample completes. Must be called
+ *  repeatedly.
  *
- *  ui
- *   User-interface data subset.
+ * RETURN:
+ *  False if a sample is in progress, else, true.
  *
  ******************************************************************************/
 
-void RGB_set_mode_on(RGB_instance_t* instance,
-                     uint32_t led_index,
-                     RGB_led_mode_on_ui_t* ui);
+bool SHIFTPISO_monitor_service(SHIFTPISO_monitor_instance_t* instance);
 
 /*******************************************************************************
  *
- * RGB_set_mode_on_color
+ * SHIFTPISO_hal_port_write_t
  *
  * DESCRIPTION:
- *  Sets the RGB LED into on mode based on RGB color.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will set and clear several pins of a single GPIO port in one
+ *  register write (i.e. a BSRR or SET/CLR register).
  *
  * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
+ *  set_mask
+ *   Port pins to set high.
  *
- *  red, green, blue
- *   Color intensities.
+ *  clear_mask
+ *   Port pins to set low.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-void RGB_set_mode_on_color(RGB_instance_t* instance,
-                           uint32_t led_index,
-                           uint8_t red,
-                           uint8_t green,
-                           uint8_t blue);
-
+typedef void (*SHIFTPISO_hal_port_write_t)(uint32_t, uint32_t);
+
 /*******************************************************************************
  *
- * RGB_set_mode_on_palette
+ * SHIFTPISO_hal_port_read_t
  *
  * DESCRIPTION:
- *  Sets the RGB LED into on mode based on palette color.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will read the input register of the GPIO port.
  *
- * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
+ * RETURN:
+ *  Port input register value.
  *
- *  palette_index
- *   Palette slot color.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-void RGB_set_mode_on_palette(RGB_instance_t* instance,
-                             uint32_t led_index,
-                             uint8_t palette_index);
+typedef uint32_t (*SHIFTPISO_hal_port_read_t)(void);
 
 /*******************************************************************************
  *
- * RGB_set_mode_pattern
+ * SHIFTPISO_port_masks_t
  *
  * DESCRIPTION:
- *  Sets the RGB LED into pattern mode.
- *
- * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
- *
- *  ui
- *   User-interface data subset.
+ *  Precomputed set and clear masks for a single port write.
  *
  ******************************************************************************/
 
-void RGB_set_mode_pattern(RGB_instance_t* instance,
-                          uint32_t led_index,
-                          RGB_led_mode_pattern_ui_t* ui);
+typedef struct
+{
+  uint32_t set_mask;
+  uint32_t clear_mask;
+}
+SHIFTPISO_port_masks_t;
 
 /*******************************************************************************
  *
- * RGB_set_mode_pattern_palette
+ * SHIFTPISO_port_t
  *
  * DESCRIPTION:
- *  Sets the RGB LED into pattern mode.
+ *  Port-level bit-bang shifter. Clock, latch/shift, and serial output are
+ *  pins of a single GPIO port, and every pin transition is a precomputed
+ *  register write. A bit costs two port writes and one port read instead of
+ *  several HAL calls, and the read loop handles a whole byte per iteration.
  *
- * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
- *
- *  iterations
- *   Number of times to repeat. Value 0 indicates repeat forever.
+ *  Reads are blocking - at port-write speeds a full chain completes in a few
+ *  microseconds. The loop assumes each port write takes longer than the shift
+ *  register propagation delay (generally 50nS or less).
  *
- *  divisor
- *   Divides the pattern phase rate by RGB_pattern_divisor_t.
+ * clock_high, clock_low
+ *  Port writes for the clock line active and inactive levels.
  *
- *  pattern_phases
- *   Length of, or number of phases (4-bit palette colors), in the pattern
- *   value.
+ * latch, shift
+ *  Port writes which activate the latch or the shift mode.
  *
- *  palette_pattern
- *   Up to 12-phases defined by palette slot colors at 4-bits each. For example,
- *   a pattern that traverses from palette slots 0 -> 1 -> 2 -> 3 would be
- *   0x3210.
+ * serial_pin
+ *  Bit position of the serial output (Q) pin in the port input register.
  *
- *  force_sync
- *   Forces the instance pattern step to reset to step-0, thus causing any new
- *   pattern(s) to start immediately. Otherwise, new pattern(s) will not begin
- *   until the instance pattern step reaches step-0.
+ * *_hal_*
+ *  User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
-void RGB_set_mode_pattern_palette(RGB_instance_t* instance,
-                                  uint32_t led_index,
-                                  uint32_t iterations,
-                                  RGB_pattern_divisor_t divisor,
-                                  uint8_t pattern_phases,
-                                  uint64_t palette_pattern,
-                                  bool force_sync);
+typedef struct
+{
+  SHIFTPISO_port_masks_t clock_high;
+  SHIFTPISO_port_masks_t clock_low;
+  SHIFTPISO_port_masks_t latch;
+  SHIFTPISO_port_masks_t shift;
+  uint8_t serial_pin;
+  SHIFTPISO_hal_port_write_t port_write;
+  SHIFTPISO_hal_port_read_t port_read;
+}
+SHIFTPISO_port_t;
 
 /*******************************************************************************
  *
- * RGB_set_mode_ramp
+ * SHIFTPISO_port_initialize
  *
  * DESCRIPTION:
- *  Sets the RGB LED into ramping mode.
+ *  Precomputes the port writes of a port-level bit-bang shifter.
  *
  * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
+ *  See SHIFTPISO_port_t.
  *
- *  ui
- *   User-interface data subset.
+ *  clock_mask
+ *   Port mask of the clock pin.
+ *
+ *  latch_shift_mask
+ *   Port mask of the latch/shift pin.
+ *
+ *  latch_active_high
+ *   True if the latch is activated by driving the latch/shift pin high, else,
+ *   false if it is activated low (i.e. the 74HC165 SH/LD pin).
  *
  ******************************************************************************/
 
-void RGB_set_mode_ramp(RGB_instance_t* instance,
-                       uint32_t led_index,
-                       RGB_led_mode_ramp_ui_t* ui);
+void SHIFTPISO_port_initialize(SHIFTPISO_port_t* port,
+                               uint32_t clock_mask,
+                               uint32_t latch_shift_mask,
+                               uint8_t serial_pin,
+                               bool latch_active_high,
+                               SHIFTPISO_hal_port_write_t port_write,
+                               SHIFTPISO_hal_port_read_t port_read);
 
 /*******************************************************************************
  *
- * RGB_set_mode_ramp_color
+ * SHIFTPISO_port_read
  *
  * DESCRIPTION:
- *  Sets the RGB LED into ramping mode. The ramp is indicated by two RGB colors.
+ *  Latches the parallel inputs and shifts in the whole apparatus. Bits are
+ *  stored in the same order as SHIFTPISO_begin_new_read, least-significant
+ *  bit of the first byte first.
  *
  * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
+ *  serial_buffer
+ *   Buffer which will hold the read data.
  *
- *  iterations
- *   Number of times to repeat. Value 0 indicates repeat forever.
+ *  register_count
+ *   Total number of shift registers in the apparatus.
  *
- *  start_delay_quanta
- *   Quanta to wait before starting the ramp-up. This delay is only done once on
- *   the first iteration of the ramp.
+ ******************************************************************************/
+
+void SHIFTPISO_port_read(SHIFTPISO_port_t* port,
+                         uint8_t* serial_buffer,
+                         uint16_t register_count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // SHIFTPISO_J_H
+
+/*******************************************************************************
  *
- *  ramp_up_quanta
- *   Quanta to ramp-up from the start to end colors.
+ *  Supports both bit-banged and SPI methods. Both methods require proper
+ *  initialization and the service routine to be called repeatedly after a new
+ *  task request until the task is completed.
  *
- *  ramp_up_hold_quanta
- *   Quanta to hold the palette_end color after the ramp-up.
+ *  A shift SIPO is generally composed of three operating pins - shift clock
+ *  (SCLK), register clock (RCLK), and serial input (SI). The rising edge on the
+ *  SCLK causes all the shift registers to transfer their bit-value to the next
+ *  shift register in line. The first shift register takes up the value provided
+ *  by SI. This process is done until all shift registers are loaded with the
+ *  desired output. The RCLK is then pulsed to transfer the content of the shift
+ *  registers into the data registers. So long as the output enable line is
+ *  opened, the values on the data registers will be sent out through the
+ *  parallel lines.
  *
- *  ramp_down_quanta
- *   Quanta to ramp-down from the end to start colors.
+ *  In the SPI method, the task takes place in a single SPI transaction, which
+ *  loads the shift registers, followed by a RCLK toggle via GPIO. The pin-outs,
+ *  for a simple approach, should be as follows:
  *
- *  ramp_down_hold_quanta
- *   Quanta to hold the palette_start color after the ramp-down.
+ *   MOSI - Serial Input
+ *   CLK  - Shift Clock
+ *   GPIO - Register Clock
+ *   GND  - Output Enable
  *
- *  *_start
- *   Ramp start color.
+ *  Shift registers generally have a propagation delay of around 50nS or less.
+ *  Hence, the application code should set the SPI frequency to around 20MHz or
+ *  slower.
  *
- *  *_end
- *   Ramp end color.
+ *  The nature of the shift register is that the first bit to enter the shift
+ *  apparatus will actually be the "last" bit, or the farthest away bit, from
+ *  the head where the MOSI and CLK are connected. The resulting bit order
+ *  will differ depending on the endianness of the processor and the method
+ *  used.
  *
- * NOTES:
- *  The internal ramp data structure works with palette indices, not RGB color
- *  values. Hence, when this method is used it will automatically overwrite the
- *  last two palette slots with the start and end RGB colors specified.
+ *  This module has been tested on both active low and active high MOSI/CLK
+ *  configurations.
  *
  ******************************************************************************/
 
-void RGB_set_mode_ramp_color(RGB_instance_t* instance,
-                             uint32_t led_index,
-                             uint32_t iterations,
-                             uint8_t start_delay_quanta,
-                             uint8_t ramp_up_quanta,
-                             uint8_t ramp_up_hold_quanta,
-                             uint8_t ramp_down_quanta,
-                             uint8_t ramp_down_hold_quanta,
-                             uint8_t red_start,
-                             uint8_t green_start,
-                             uint8_t blue_start,
-                             uint8_t red_end,
-                             uint8_t green_end,
-                             uint8_t blue_end);
+#ifndef SHIFTSIPO_J_H
+#define SHIFTSIPO_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /*******************************************************************************
  *
- * RGB_set_mode_ramp_palette
+ * SHIFTSIPO_flags_t
  *
  * DESCRIPTION:
- *  Sets the RGB LED into ramping mode. The ramp is indicated by palette slots.
- *
- * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
- *
- *  iterations
- *   Number of times to repeat. Value 0 indicates repeat forever.
- *
- *  start_delay_quanta
- *   Quanta to wait before starting the ramp-up. This delay is only done once on
- *   the first iteration of the ramp.
- *
- *  ramp_up_quanta
- *   Quanta to ramp-up from the start to end colors.
- *
- *  ramp_up_hold_quanta
- *   Quanta to hold the palette_end color after the ramp-up.
- *
- *  ramp_down_quanta
- *   Quanta to ramp-down from the end to start colors.
+ *  Module flags.
  *
- *  ramp_down_hold_quanta
- *   Quanta to hold the palette_start color after the ramp-down.
+ * busy
+ *  Set when the module is busy with a task and cleared when the task is
+ *  completed.
  *
- *  palette_index_start
- *   Palette index of the start color.
+ * bit_banged
+ *  Set if the instance has been initialized to use the bit-banging method.
  *
- *  palette_index_end
- *   Palette index of the end color
+ * task_state
+ *  State machine state.
  *
  ******************************************************************************/
 
-void RGB_set_mode_ramp_palette(RGB_instance_t* instance,
-                               uint32_t led_index,
-                               uint32_t iterations,
-                               uint8_t start_delay_quanta,
-                               uint8_t ramp_up_quanta,
-                               uint8_t ramp_up_hold_quanta,
-                               uint8_t ramp_down_quanta,
-                               uint8_t ramp_down_hold_quanta,
-                               uint8_t palette_index_start,
-                               uint8_t palette_index_end);
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t busy                          : 1;
+    uint8_t bit_banged                    : 1;
+    uint8_t reserved2                     : 2;
+    uint8_t task_state                    : 3;
+    uint8_t reserved7                     : 1;
+  };
+}
+SHIFTSIPO_flags_t;
 
 /*******************************************************************************
  *
- * RGB_service
+ * SHIFTSIPO_error_flags_t
  *
  * DESCRIPTION:
- *  Services the RGB pattern and ramp animations. Intended to be called
- *  periodically at a 1-ms interval. Every time this function is called the
- *  internal tick counter is incremented - which is the basis for advancing
- *  the ramp and pattern animations.
+ *  Module error flags.
+ *
+ * other
+ *  All other types of errors.
+ *
+ * spi
+ *  Errors relating to the SPI.
  *
  ******************************************************************************/
 
-void RGB_service(RGB_instance_t* instance);
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t other                         : 1;
+    uint8_t spi                           : 1;
+    uint8_t reserved2                     : 6;
+  };
+}
+SHIFTSIPO_error_flags_t;
 
 /*******************************************************************************
  *
- * RGB_service_pattern
+ * SHIFTSIPO_pre_task_callback_t
  *
  * DESCRIPTION:
- *  Called from the service routine. Handles pattern-specific animations.
+ *  Function template for a user-provided function which is called when a new
+ *  task is accepted and initialized but before the task actually begins. This
+ *  allows the user to perform any last additional configurations before the
+ *  actual logic of the task begins.
  *
  * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
+ *  context
+ *   User-provided context.
  *
  * NOTES:
- *  Helper function primarily called from RGB_service. Exposed here for
- *  unit testing.
+ *  Can be initialized as NULL - YES
  *
  ******************************************************************************/
 
-void RGB_service_pattern(RGB_instance_t* instance, uint32_t led_index);
+typedef void (*SHIFTSIPO_pre_task_callback_t)(uint32_t);
 
 /*******************************************************************************
  *
- * RGB_service_ramp
+ * SHIFTSIPO_post_task_callback_t
  *
  * DESCRIPTION:
- *  Called from the service routine.Handles ramp-specific animations.
+ *  Function template for a user-provided function which is called after a
+ *  task completes.
  *
  * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
+ *  context
+ *   User-provided context.
  *
  * NOTES:
- *  Helper function primarily called from RGB_service. Exposed here for
- *  unit testing.
+ *  Can be initialized as NULL - YES
  *
  ******************************************************************************/
 
-void RGB_service_ramp(RGB_instance_t* instance, uint32_t led_index);
+typedef void (*SHIFTSIPO_post_task_callback_t)(uint32_t);
 
 /*******************************************************************************
  *
- * RGB_pattern_force_sync
+ * SHIFTSIPO_hal_set_shift_clock_t
  *
  * DESCRIPTION:
- *  Forces the pattern phase step to restart at phase-0 on the next service
- *  tick, causing new patterns to start immediately.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will set the shift clock line high or low.
+ *
+ * PARAMETERS:
+ *  value
+ *   True to set high, false to set low.
  *
  * NOTES:
- *  Helper function primarily called from RGB_set_mode_pattern. Exposed here
- *  for unit testing.
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-void RGB_pattern_force_sync(RGB_instance_t* instance);
+typedef void (*SHIFTSIPO_hal_set_shift_clock_t)(bool);
 
 /*******************************************************************************
  *
- * RGB_pattern_tick_increment
+ * SHIFTSIPO_hal_set_register_clock_t
  *
  * DESCRIPTION:
- *  Called from the service routine. Increments the pattern tick counter which,
- *  in-turn, may increment the phase counter.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will set the register clock line high or low.
  *
- * RETURN:
- *  True if a new pattern phase has been reached and patterns need to be
- *  serviced, else, false.
+ * PARAMETERS:
+ *  value
+ *   True to set high, false to set low.
  *
  * NOTES:
- *  Helper function primarily called from RGB_service. Exposed here for
- *  unit testing.
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-bool RGB_pattern_tick_increment(RGB_instance_t* instance);
+typedef void (*SHIFTSIPO_hal_set_register_clock_t)(bool);
 
 /*******************************************************************************
  *
- * RGB_ramp_update_output
+ * SHIFTSIPO_hal_set_serial_t
  *
  * DESCRIPTION:
- *  Called from the ramp service routine. Translates the high-resolution ramp
- *  working colors to the final 8-bit output colors.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will set the serial line high or low.
  *
  * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance led_list.
+ *  value
+ *   True to set high, false to set low.
  *
  * NOTES:
- *  Helper function primarily called from RGB_service_ramp. Exposed here for
- *  unit testing.
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-void RGB_ramp_update_output(RGB_instance_t* instance, uint32_t led_index);
-
-#ifdef __cplusplus
-}
-#endif
-#endif // RGB_J_H
+typedef void (*SHIFTSIPO_hal_set_serial_t)(bool);
 
 /*******************************************************************************
  *
- *  Configures and drives animations for RGB LEDs. Requires proper
- *  initialization and the service routine to be called periodically.
+ * SHIFTSIPO_instance_t
  *
- ******************************************************************************/
-
-#ifndef LED_ANIMATION_J_H
-#define LED_ANIMATION_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*******************************************************************************
+ * DESCRIPTION:
+ *  Instance data and function pointers.
  *
- * LEDANIMATION_entry_flags_t
+ * flags
+ *  Module flags.
  *
- * DESCRIPTION:
- *  Animation flags for a single LED.
+ * errors
+ *  Errors which occurred in the last transaction.
  *
- * active
- *  Set if the animation is running or is in queue to run.
+ * utimer
+ *  User-provided initialized instance of a UTIMER.
  *
- * led_mode
- *  RGB LED mode (OFF, ON, PATTERN, RAMP).
+ * utimer_ticket
+ *  Data structure used with the UTIMER instance.
  *
- ******************************************************************************/
-
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t active                        : 1;
-    uint8_t led_mode                      : 2;
-    uint8_t reserved3                     : 5;
-  };
-}
-LEDANIMATION_entry_flags_t;
-
-/*******************************************************************************
+ * spi
+ *  User-provided initialized instance of a SERSPI.
  *
- * LEDANIMATION_entry_t
+ * bus_mutex
+ *  User-provided initialized instance of a BUSMUTEX.
  *
- * DESCRIPTION:
- *  A single animation entry for a single LED. The order of entries on the
- *  table indicate the animation priority. Other animation information is
- *  stored in this structure.
+ * bus_id
+ *  The BUS ID associated with the BUSMUTEX instance.
  *
- * animation_id
- *  The user should create a list of animation ID's. Then, several LEDs which
- *  need to work together to create an animation should use the same animation
- *  ID which is assigned to each different animation by the user.
+ * propagation_delay_us
+ *  Microseconds required to delay between hardware operations in order to
+ *  allow the internal circuits to stabilize.
  *
- * flags
- *  LED animation flags.
+ * register_count
+ *  Total number of shift registers (total channels, not the number of physical
+ *  devices) in the apparatus.
  *
- * rgb_ui_code
- *  The RGB UI code which is used by the RGB module to put an LED into OFF, ON,
- *  PATTERN, or RAMP modes.
+ * register_counter
+ *  Keeps track of the which register is currently being serviced.
+ *
+ * byte_offset
+ *  Keeps track of the byte offset in the serial buffer.
+ *
+ * bit_offset
+ *  Keeps track of the bit offset in the serial buffer.
+ *
+ * serial_buffer_length
+ *  Required length, in bytes, of the serial buffer.
+ *
+ * serial_buffer
+ *  Buffer which stores the shift register values to be written.
+ *
+ * callback_context
+ *  Context passed into the user pre/post task callbacks.
+ *
+ * service_handler
+ *  Internal-use pointer to the active state machine service.
+ *
+ * *_task_*
+ * *_hal_*
+ *  User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  uint8_t animation_id;
-  LEDANIMATION_entry_flags_t flags;
-  uint64_t rgb_ui_code;
+  SHIFTSIPO_flags_t flags;
+  SHIFTSIPO_error_flags_t errors;
+  UTIMER_instance_t* utimer;
+  UTIMER_ticket_t utimer_ticket;
+  SERSPI_instance_t* spi;
+  BUSMUTEX_instance_t* bus_mutex;
+  BUSMUTEX_bus_id_t bus_id;
+  uint16_t propagation_delay_us;
+  uint16_t register_count;
+  uint16_t register_counter;
+  uint16_t byte_offset;
+  uint8_t bit_offset;
+  uint16_t serial_buffer_length;
+  uint8_t* serial_buffer;
+  uint32_t callback_context;
+  bool (*service_handler)(void*);
+  SHIFTSIPO_pre_task_callback_t pre_task_callback;
+  SHIFTSIPO_post_task_callback_t post_task_callback;
+  SHIFTSIPO_hal_set_shift_clock_t set_shift_clock;
+  SHIFTSIPO_hal_set_register_clock_t set_register_clock;
+  SHIFTSIPO_hal_set_serial_t set_serial;
 }
-LEDANIMATION_entry_t;
+SHIFTSIPO_instance_t;
 
 /*******************************************************************************
  *
- * RGB_animation_table_t
+ * SHIFTSIPO_initialize
  *
  * DESCRIPTION:
- *  Collection of LEDANIMATION_entry_t for a single LED which makes up an
- *  animation table with the higher priority animations listed first on the
- *  table.
- *
- * table
- *  Pointer to an array of user-defined LEDANIMATION_entry_t which have already
- *  been initialized with the animation IDs, LED mode, and RGB UI code.
- *
- * table_length
- *  Number of animations in the table. May have up to 255-entries ranging from
- *  0 to 254.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values. SPI method.
  *
- * active_index
- *  Index into the table of the currently highest priority animation which is
- *  active.
+ * PARAMETERS:
+ *  See SHIFTSIPO_instance_t.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  LEDANIMATION_entry_t* table;
-  uint8_t table_length;
-  uint8_t active_index;
-}
-LEDANIMATION_led_table_t;
+void SHIFTSIPO_initialize(SHIFTSIPO_instance_t* instance,
+                          UTIMER_instance_t* utimer,
+                          SERSPI_instance_t* spi,
+                          BUSMUTEX_instance_t* bus_mutex,
+                          BUSMUTEX_bus_id_t bus_id,
+                          uint16_t propagation_delay_us,
+                          uint16_t register_count,
+                          SHIFTSIPO_pre_task_callback_t pre_task_callback,
+                          SHIFTSIPO_post_task_callback_t post_task_callback,
+                          SHIFTSIPO_hal_set_register_clock_t set_register_clock);
 
 /*******************************************************************************
  *
- * LEDANIMATION_flags_t
+ * SHIFTSIPO_initialize_bb
  *
  * DESCRIPTION:
- *  Module flags.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values. Bit-bang method.
+ *
+ * PARAMETERS:
+ *  See SHIFTSIPO_instance_t.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t reserved0                     : 8;
-  };
-}
-LEDANIMATION_flags_t;
+void SHIFTSIPO_initialize_bb(SHIFTSIPO_instance_t* instance,
+                             UTIMER_instance_t* utimer,
+                             uint16_t propagation_delay_us,
+                             uint16_t register_count,
+                             SHIFTSIPO_pre_task_callback_t pre_task_callback,
+                             SHIFTSIPO_post_task_callback_t post_task_callback,
+                             SHIFTSIPO_hal_set_shift_clock_t set_shift_clock,
+                             SHIFTSIPO_hal_set_register_clock_t set_register_clock,
+                             SHIFTSIPO_hal_set_serial_t set_serial);
 
 /*******************************************************************************
  *
- * LEDANIMATION_instance_t
+ * SHIFTSIPO_begin_new_write
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
- *
- * flags
- *  Module flags.
- *
- * list
- *  List of LED animation tables. Each table index corresponds directly to
- *  the same index of an LED in the RGB instance. The animation list may be
- *  smaller than or equal to the RGB list, but it cannot be greater.
+ *  Attempts to begin a new serial output task.
  *
- * list_length
- *  Number of tables in the list.
+ * PARAMETERS:
+ *  serial_buffer
+ *   Buffer which contains the data to be written. Each bit represents a single
+ *   register. The buffer should be large enough to accommodate the entirety of
+ *   the shift apparatus.
  *
- * rgb
- *  User-provided RGB instance which has already been initialized.
+ * RETURN:
+ *  True if the task request was accepted, else, false.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  LEDANIMATION_flags_t flags;
-  LEDANIMATION_led_table_t* list;
-  uint32_t list_length;
-  RGB_instance_t* rgb;
-}
-LEDANIMATION_instance_t;
+bool SHIFTSIPO_begin_new_write(SHIFTSIPO_instance_t* instance, uint8_t* serial_buffer);
 
 /*******************************************************************************
  *
- * LEDANIMATION_initialize
+ * SHIFTSIPO_service
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values.
+ *  Services the task state machine. Must be called repeatedly until the task
+ *  is completed.
  *
- * PARAMETERS:
- *  See LEDANIMATION_instance_t.
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true.
  *
  ******************************************************************************/
 
-void LEDANIMATION_initialize(LEDANIMATION_instance_t* instance,
-                             LEDANIMATION_led_table_t* list,
-                             uint32_t list_length,
-                             RGB_instance_t* rgb);
+bool SHIFTSIPO_service(SHIFTSIPO_instance_t* instance);
 
 /*******************************************************************************
  *
- * LEDANIMATION_service
+ * SHIFTSIPO_is_busy
  *
  * DESCRIPTION:
- *  Meant to be called periodically on a basis of around 100-milliseconds.
- *  Services the module instance - checks the status of the highest priority
- *  animation for each LED and de-activates the animation if the animation was
- *  finite and has completed. Will then look through the list for the next
- *  highest priority task. Should be called periodically on a basis of around
- *  100-milliseconds.
+ *  Determines if an instance is currently busy with a task.
+ *
+ * RETURN:
+ *  True if the instance is busy with a task, else, false.
  *
  ******************************************************************************/
 
-void LEDANIMATION_service(LEDANIMATION_instance_t* instance);
+bool SHIFTSIPO_is_busy(SHIFTSIPO_instance_t* instance);
 
 /*******************************************************************************
  *
- * LEDANIMATION_set
+ * SHIFTSIPO_hal_configure_dma_t
  *
  * DESCRIPTION:
- *  Traverses all LED tables and for each LED activates the selected animation.
- *  If the animation is highest priority then the new animation will either
- *  begin immediately or at the next pattern start cycle.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will configure and start an SPI transmit DMA transfer.
  *
  * PARAMETERS:
- *  animation_id
- *   The animation id to set active.
+ *  src_addr
+ *   Starting memory address of the data to be transferred.
+ *
+ *  src_length
+ *   Number of bytes to transfer.
+ *
+ * RETURN:
+ *  True if the configuration was successful and started, else, false.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-void LEDANIMATION_set(LEDANIMATION_instance_t* instance, uint8_t animation_id);
+typedef bool (*SHIFTSIPO_hal_configure_dma_t)(void*, uint32_t);
 
 /*******************************************************************************
  *
- * LEDANIMATION_clear
+ * SHIFTSIPO_hal_start_timer_t
  *
  * DESCRIPTION:
- *  Traverses all LED tables and for each LED stops the selected animation if
- *  it is currently running, else, de-activates the animation so it is not
- *  pending to run.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will start a one-shot hardware timer. The timer ISR must call
+ *  SHIFTSIPO_refresh_timer_isr_handler on expiration.
  *
  * PARAMETERS:
- *  animation_id
- *   The animation id to set de-activate.
+ *  period_us
+ *   Microseconds until expiration.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-void LEDANIMATION_clear(LEDANIMATION_instance_t* instance, uint8_t animation_id);
+typedef void (*SHIFTSIPO_hal_start_timer_t)(uint32_t);
 
 /*******************************************************************************
  *
- * LEDANIMATION_start
+ * SHIFTSIPO_hal_select_row_t
  *
  * DESCRIPTION:
- *  Helper function which starts a specified animation for a specified LED.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will drive the row select lines of a multiplexed display. Called
+ *  right after the register clock latches a new row.
  *
  * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance LED list.
- *
- *  animation_index
- *   Index of the animation in the LED animation table.
+ *  row
+ *   Index of the row to enable.
  *
  * NOTES:
- *  Helper function called internally. Exposed here for unit testing.
+ *  Can be initialized as NULL - YES (i.e. the row select lines are driven by
+ *  shift register outputs included in the row data)
  *
  ******************************************************************************/
 
-void LEDANIMATION_start(LEDANIMATION_instance_t* instance,
-                        uint32_t led_index,
-                        uint8_t animation_index);
+typedef void (*SHIFTSIPO_hal_select_row_t)(uint16_t);
 
 /*******************************************************************************
  *
- * LEDANIMATION_is_finite
+ * SHIFTSIPO_hal_set_output_enable_t
  *
  * DESCRIPTION:
- *  Helper function which determines if a given animation is finite.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will drive the output enable line of the shift registers (or of the
+ *  row drivers). The outputs are blanked while a new row is latched and
+ *  selected, so the data of the new row never shows on the previous row.
  *
  * PARAMETERS:
- *  led_index
- *   Index of the LED in the instance LED list.
- *
- *  animation_index
- *   Index of the animation in the LED animation table.
- *
- * RETURN:
- *  True if the animation is finite (OFF, ON, PATTER or RAMP with infinite
- *  iterations), else, false.
+ *  enable
+ *   True to drive the outputs, else, false to blank them.
  *
  * NOTES:
- *  Helper function called internally. Exposed here for unit testing.
+ *  Can be initialized as NULL - YES (i.e. single row displays, where no
+ *  ghosting can occur)
  *
  ******************************************************************************/
 
-bool LEDANIMATION_is_finite(LEDANIMATION_instance_t* instance,
-                            uint32_t led_index,
-                            uint8_t animation_index);
+typedef void (*SHIFTSIPO_hal_set_output_enable_t)(bool);
 
-#ifdef __cplusplus
-}
+/*
+ * Maximum number of is_tx_complete polls before the refresh latches a slot.
+ * Once the DMA has written the last byte, the SPI holds at most its transmit
+ * FIFO and shift register, one to a few bytes on most parts, i.e. 16 SPI
+ * clocks or about 1 us at 16 MHz, which is well within a few tens of polls.
+ * Past the limit (e.g. a SPI fault), the latch is deferred to a timer retry
+ * one base period later rather than spinning in the ISR. Can be overridden in
+ * the project build properties.
+ */
+
+#ifndef SHIFTSIPO_REFRESH_TX_COMPLETE_POLLS_MAX
+#define SHIFTSIPO_REFRESH_TX_COMPLETE_POLLS_MAX  256U
 #endif
-#endif // LED_ANIMATION_J_H
 
 /*******************************************************************************
  *
- *  Simple settings storage on EEPROM media. The module uses a 4-byte header
- *  to wear-level the NVM ensure data integrity. Requires proper initialization
- *  and the service routine to be called repeatedly after a new task request
- *  until the task is completed.
+ * SHIFTSIPO_hal_is_tx_complete_t
+ *
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will check if the SPI has shifted out the last bit of a transfer,
+ *  e.g. the SPI busy flag is clear. The DMA transfer complete interrupt of
+ *  most parts fires once the last byte is written to the SPI, before it is
+ *  shifted out, so the latch waits for this, for up to
+ *  SHIFTSIPO_REFRESH_TX_COMPLETE_POLLS_MAX polls.
+ *
+ * RETURN:
+ *  True if the SPI transfer is complete, else, false.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - YES (in which case
+ *  SHIFTSIPO_refresh_dma_transfer_complete_isr_handler must be called from
+ *  the SPI transfer complete interrupt rather than the DMA one)
  *
  ******************************************************************************/
 
-#ifndef NVMBASIC_J_H
-#define NVMBASIC_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
+typedef bool (*SHIFTSIPO_hal_is_tx_complete_t)(void);
 
 /*******************************************************************************
  *
- * NVMBASIC_data_meta_flags_t
+ * SHIFTSIPO_refresh_flags_t
  *
  * DESCRIPTION:
- *  Flags which are used for data status and NVM wear leveling.
+ *  Continuous refresh flags.
  *
- * data_present
- *  Indicates that the associated block of NVM was used to store data.
+ * running
+ *  Set while the refresh is running.
  *
- * data_old
- *  Inidcates that this block of NVM data is outdated and that a newer version
- *  of the data exists in a later block.
+ * dma_complete
+ *  Set when the row data for the next slot has been shifted out.
+ *
+ * timer_expired
+ *  Set when the display period of the current slot has elapsed.
  *
  ******************************************************************************/
 
 typedef union
 {
-  uint16_t all;
+  uint8_t all;
   struct
   {
-    uint16_t reserved0                    : 14;
-    uint16_t data_present                 : 1;
-    uint16_t data_old                     : 1;
+    uint8_t running                       : 1;
+    uint8_t dma_complete                  : 1;
+    uint8_t timer_expired                 : 1;
+    uint8_t reserved3                     : 5;
   };
 }
-NVMBASIC_data_meta_flags_t;
+SHIFTSIPO_refresh_flags_t;
 
 /*******************************************************************************
  *
- * NVMBASIC_data_meta_t
+ * SHIFTSIPO_refresh_instance_t
  *
  * DESCRIPTION:
- *  Data structure which MUST be the first entry in the user data structure.
- *  Contains information which is used to help evenly wear NVM and ensure
- *  data integrity.
+ *  Continuous, DMA-driven, refresh of a multiplexed LED matrix or 7-segment
+ *  display attached to a SPI shift register chain. A frame is made of rows,
+ *  and every row is made of bit planes for binary code modulation (BCM). Each
+ *  row/plane "slot" is latched and displayed for a period proportional to its
+ *  bit weight, base_period_us << plane, which gives 2^bit_depth brightness
+ *  levels per output.
  *
- * crc16
- *  The CRC16 of the data starting immediately after the CRC bytes.
+ *  The shift register output stage holds the displayed slot while the DMA
+ *  shifts in the next one, so the only per-slot CPU work is the latch pulse
+ *  and the start of the next DMA and timer, all done from the DMA complete
+ *  and timer ISRs. Each latch blanks the outputs, pulses the register clock,
+ *  selects the row, and drives the outputs again.
+ *
+ *  The frame source is double-buffered. The application draws into the back
+ *  buffer and requests a swap, which takes effect at the next frame boundary
+ *  to avoid tearing.
+ *
+ *  Frame buffer layout, in bytes:
+ *
+ *   [row 0: plane 0 .. plane (bit_depth - 1)] ... [row (row_count - 1): ...]
+ *
+ *  where each plane is row_length bytes of shift register data.
  *
  * flags
- *  See NVMBASIC_data_meta_flags_t.
+ *  See SHIFTSIPO_refresh_flags_t. Only modified from the ISR handlers once
+ *  the refresh is running.
  *
- ******************************************************************************/
-
-typedef struct
-{
-  uint16_t crc16;
-  NVMBASIC_data_meta_flags_t flags;
-}
-NVMBASIC_data_meta_t;
-
-/*******************************************************************************
+ * stop_requested
+ *  Set by the application to stop the refresh at the next slot.
  *
- * NVMBASIC_flags_t
+ * swap_requested
+ *  Set by the application to request a buffer swap, which takes place at the
+ *  next frame boundary, and cleared once the swap has taken place. Kept apart
+ *  from the flags so that the application and the ISRs never write the same
+ *  memory.
  *
- * DESCRIPTION:
- *  Module flags.
+ * bus_mutex
+ *  User-provided initialized instance of a BUSMUTEX. The bus is held for as
+ *  long as the refresh is running.
  *
- * busy
- *  Set when the module is busy with a task and cleared when the task is
- *  completed.
+ * bus_id
+ *  The BUS ID associated with the BUSMUTEX instance.
+ *
+ * front_buffer
+ *  The frame buffer being displayed.
+ *
+ * back_buffer
+ *  The frame buffer available to the application.
+ *
+ * row_count
+ *  Number of multiplexed rows.
+ *
+ * row_length
+ *  Number of bytes shifted out per row plane. Must not exceed the maximum
+ *  single DMA transfer length.
+ *
+ * bit_depth
+ *  Number of BCM bit planes, from 1 to 8.
+ *
+ * base_period_us
+ *  Display period of the least significant bit plane.
+ *
+ * slot_count
+ *  Calculated number of slots per frame (row_count * bit_depth), which must
+ *  not exceed 65535.
+ *
+ * loading_slot
+ *  The slot currently being shifted in by the DMA.
+ *
+ * frame_counter
+ *  Number of frames displayed since the refresh started.
+ *
+ * *_hal_*
+ *  User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
-typedef union
+typedef struct
 {
-  uint8_t all;
-  struct
-  {
-    uint8_t busy                          : 1;
-    uint8_t reserved1                     : 3;
-    uint8_t task_state                    : 3;
-    uint8_t reserved7                     : 1;
-  };
+  volatile SHIFTSIPO_refresh_flags_t flags;
+  volatile bool stop_requested;
+  volatile bool swap_requested;
+  BUSMUTEX_instance_t* bus_mutex;
+  BUSMUTEX_bus_id_t bus_id;
+  uint8_t* volatile front_buffer;
+  uint8_t* volatile back_buffer;
+  uint16_t row_count;
+  uint16_t row_length;
+  uint8_t bit_depth;
+  uint16_t base_period_us;
+  uint16_t slot_count;
+  uint16_t loading_slot;
+  volatile uint32_t frame_counter;
+  SHIFTSIPO_hal_configure_dma_t configure_dma;
+  SHIFTSIPO_hal_start_timer_t start_timer;
+  SHIFTSIPO_hal_set_register_clock_t set_register_clock;
+  SHIFTSIPO_hal_select_row_t select_row;
+  SHIFTSIPO_hal_set_output_enable_t set_output_enable;
+  SHIFTSIPO_hal_is_tx_complete_t is_tx_complete;
 }
-NVMBASIC_flags_t;
+SHIFTSIPO_refresh_instance_t;
 
 /*******************************************************************************
  *
- * NVMBASIC_pre_task_callback_t
+ * SHIFTSIPO_refresh_initialize
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called when a new
- *  task is accepted and initialized but before the task actually begins. This
- *  allows the user to perform any last additional configurations before the
- *  actual logic of the task begins.
+ *  Initializes a continuous refresh instance, erasing all data structures and
+ *  setting default values. Both frame buffers are cleared.
  *
  * PARAMETERS:
- *  context
- *   User-provided context.
+ *  See SHIFTSIPO_refresh_instance_t.
  *
- * NOTES:
- *  Can be initialized as NULL - YES
+ *  frame_buffer_a, frame_buffer_b
+ *   User-provided DMA compatible frame buffers, each of
+ *   (row_count * bit_depth * row_length) bytes.
  *
  ******************************************************************************/
 
-typedef void (*NVMBASIC_pre_task_callback_t)(uint32_t);
+void SHIFTSIPO_refresh_initialize(SHIFTSIPO_refresh_instance_t* instance,
+                                  BUSMUTEX_instance_t* bus_mutex,
+                                  BUSMUTEX_bus_id_t bus_id,
+                                  uint8_t* frame_buffer_a,
+                                  uint8_t* frame_buffer_b,
+                                  uint16_t row_count,
+                                  uint16_t row_length,
+                                  uint8_t bit_depth,
+                                  uint16_t base_period_us,
+                                  SHIFTSIPO_hal_configure_dma_t configure_dma,
+                                  SHIFTSIPO_hal_start_timer_t start_timer,
+                                  SHIFTSIPO_hal_set_register_clock_t set_register_clock,
+                                  SHIFTSIPO_hal_select_row_t select_row,
+                                  SHIFTSIPO_hal_set_output_enable_t set_output_enable,
+                                  SHIFTSIPO_hal_is_tx_complete_t is_tx_complete);
 
 /*******************************************************************************
  *
- * NVMBASIC_post_task_callback_t
+ * SHIFTSIPO_refresh_start
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called after a
- *  task completes.
- *
- * PARAMETERS:
- *  context
- *   User-provided context.
+ *  Acquires the bus and starts the continuous refresh.
  *
- * NOTES:
- *  Can be initialized as NULL - YES
+ * RETURN:
+ *  True if the refresh was started, else, false.
  *
  ******************************************************************************/
 
-typedef void (*NVMBASIC_post_task_callback_t)(uint32_t);
+bool SHIFTSIPO_refresh_start(SHIFTSIPO_refresh_instance_t* instance);
 
 /*******************************************************************************
  *
- * NVMBASIC_instance_t
+ * SHIFTSIPO_refresh_stop
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
- *
- * flags
- *  Module flags.
+ *  Requests the continuous refresh to stop once the in-flight DMA and timer
+ *  complete, at which point the bus is released. The last latched row remains
+ *  driven, hence, the application should blank the display if needed.
  *
- * eeprom
- *  User-provided initialized instance of a EEPROM.
+ ******************************************************************************/
+
+void SHIFTSIPO_refresh_stop(SHIFTSIPO_refresh_instance_t* instance);
+
+/*******************************************************************************
  *
- * bus_mutex
- *  User-provided initialized instance of a BUSMUTEX.
+ * SHIFTSIPO_refresh_dma_transfer_complete_isr_handler
  *
- * bus_id
- *  The BUS ID associated with the BUSMUTEX instance.
+ * DESCRIPTION:
+ *  Handler for the DMA transfer complete interrupt. The user code must call
+ *  this function from their DMA transfer complete ISR, or from their SPI
+ *  transfer complete ISR if no is_tx_complete HAL function is provided.
  *
- * data_stable
- *  Pointer to a user buffer dedicated for holding the data to be written to
- *  EEPROM, and to maintain that data as a volatile copy of what is currently
- *  on EEPROM.
+ * IMPORTANT:
+ *  The DMA and timer ISRs must run at the same interrupt priority.
  *
- * data_working
- *  Pointer to the user data structure which is, presumably, being updated by
- *  the user code.
+ ******************************************************************************/
+
+void SHIFTSIPO_refresh_dma_transfer_complete_isr_handler(SHIFTSIPO_refresh_instance_t* instance);
+
+/*******************************************************************************
  *
- * data_length
- *  The length, in bytes, of the data structure. This should be the length of
- *  the data_stable and data_working buffers.
+ * SHIFTSIPO_refresh_timer_isr_handler
  *
- * memory_start
- *  The starting address, inclusive, in EEPROM memory that is dedicated to
- *  the data. The address must be word-aligned.
+ * DESCRIPTION:
+ *  Handler for the one-shot timer expiration interrupt. The user code must
+ *  call this function from their timer ISR.
  *
- * memory_end
- *  The ending address, exclusive, in EEPROM memory that is dedicated to the
- *  data. The length from the start address to the end address must be evenly
- *  divisble by the data length.
+ * IMPORTANT:
+ *  The DMA and timer ISRs must run at the same interrupt priority.
  *
- * next_address
- *  The next EEPROM starting memory address where the data will be written.
+ ******************************************************************************/
+
+void SHIFTSIPO_refresh_timer_isr_handler(SHIFTSIPO_refresh_instance_t* instance);
+
+/*******************************************************************************
  *
- * previous_address
- *  The last EEPROM starting memory address where the data was written.
+ * SHIFTSIPO_refresh_set_output
  *
- * callback_context
- *  Context passed into the user pre/post operation callbacks.
+ * DESCRIPTION:
+ *  Sets the brightness of a single shift register output in the back buffer
+ *  by spreading the brightness bits across the bit planes of the row.
  *
- * previous_meta_page_buffer
- *  Copy of the previous data structure, up to the first EEPROM page (i.e. if
- *  the data structue is larger than an EEPROM page, then the buffer will be
- *  only the first EEPROM page used by the previous data structure. If the
- *  data structure is smaller than an EEPROM page, then the entire previous
- *  data structure is stored in this buffer). Keeping a copy eliminates the
- *  need to re-read the old meta before doing a write to mark the data entry
- *  as old. We need to store up to an entire EEPROM page since any un-written
- *  bytes will be erased by the EEPROM.
+ * PARAMETERS:
+ *  row
+ *   Row index.
  *
- * previous_meta_page_buffer_length
- *  The length, in bytes, of the previous_meta_page_buffer. This is set during
- *  initialization and is the smaller of the data structure length and EEPROM
- *  page length.
+ *  output
+ *   Output (register) index within the row. Output N is bit (N % 8) of byte
+ *   (N / 8) of the row data.
  *
- * *_task_*
- *  User-provided functions. See typedef comments.
+ *  brightness
+ *   Brightness from 0 to (2^bit_depth - 1).
  *
  ******************************************************************************/
 
-typedef struct
-{
-  NVMBASIC_flags_t flags;
-  EEPROM_instance_t* eeprom;
-  BUSMUTEX_instance_t* bus_mutex;
-  BUSMUTEX_bus_id_t bus_id;
-  uint8_t* data_stable;
-  uint8_t* data_working;
-  uint32_t data_length;
-  uint32_t memory_start;
-  uint32_t memory_end;
-  uint32_t next_address;
-  uint32_t previous_address;
-  uint32_t callback_context;
-  uint8_t* previous_meta_page_buffer;
-  uint32_t previous_meta_page_buffer_length;
-  NVMBASIC_pre_task_callback_t pre_task_callback;
-  NVMBASIC_post_task_callback_t post_task_callback;
-}
-NVMBASIC_instance_t;
+void SHIFTSIPO_refresh_set_output(SHIFTSIPO_refresh_instance_t* instance,
+                                  uint16_t row,
+                                  uint16_t output,
+                                  uint8_t brightness);
 
 /*******************************************************************************
  *
- * NVMBASIC_initialize
+ * SHIFTSIPO_refresh_swap_buffers
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values.
- *
- * PARAMETERS:
- *  See NVMBASIC_instance_t.
+ *  Requests that the back buffer be displayed from the next frame boundary.
+ *  The previous front buffer becomes the back buffer, with the content of an
+ *  older frame, once the swap has taken place. If the refresh is not running
+ *  the swap takes place immediately.
  *
  ******************************************************************************/
 
-void NVMBASIC_initialize(NVMBASIC_instance_t* instance,
-                         EEPROM_instance_t* eeprom,
-                         BUSMUTEX_instance_t* bus_mutex,
-                         BUSMUTEX_bus_id_t bus_id,
-                         uint8_t* data_stable,
-                         uint8_t* data_working,
-                         uint32_t data_length,
-                         uint32_t memory_start,
-                         uint32_t memory_end,
-                         uint8_t* previous_meta_page_buffer,
-                         NVMBASIC_pre_task_callback_t pre_task_callback,
-                         NVMBASIC_post_task_callback_t post_task_callback);
+void SHIFTSIPO_refresh_swap_buffers(SHIFTSIPO_refresh_instance_t* instance);
 
 /*******************************************************************************
  *
- * NVMBASIC_blocked_restore
+ * SHIFTSIPO_refresh_is_swap_pending
  *
  * DESCRIPTION:
- *  Blocking function which attempts to restore the latest saved version of the
- *  data from the EEPROM. This is a blocking function intended to be called
- *  during initialization.
+ *  Determines if a requested buffer swap has yet to take place. The back
+ *  buffer must not be modified while a swap is pending.
  *
  * RETURN:
- *  True if the task request was performed and a restore point was found and
- *  restored, else, false.
+ *  True if a swap is pending, else, false.
  *
  ******************************************************************************/
 
-bool NVMBASIC_blocked_restore(NVMBASIC_instance_t* instance);
+bool SHIFTSIPO_refresh_is_swap_pending(SHIFTSIPO_refresh_instance_t* instance);
 
 /*******************************************************************************
  *
- * NVMBASIC_blocked_purge
+ * SHIFTSIPO_hal_port_write_t
  *
  * DESCRIPTION:
- *  Blocking function which erases the allocated memory block and resets the
- *  next write location to the beggining of the memory space.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will set and clear several pins of a single GPIO port in one
+ *  register write (i.e. a BSRR or SET/CLR register).
  *
- * RETURN:
- *  True if the task request was performed, else, false.
+ * PARAMETERS:
+ *  set_mask
+ *   Port pins to set high.
+ *
+ *  clear_mask
+ *   Port pins to set low.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-bool NVMBASIC_blocked_purge(NVMBASIC_instance_t* instance);
+typedef void (*SHIFTSIPO_hal_port_write_t)(uint32_t, uint32_t);
 
 /*******************************************************************************
  *
- * NVMBASIC_save
+ * SHIFTSIPO_port_masks_t
  *
  * DESCRIPTION:
- *  Captures and saves a copy of the working data in EEPROM.
+ *  Precomputed set and clear masks for a single port write.
  *
- * PARAMETERS:
- *  force
- *   Forces the save even if the stable and working data buffers are the same.
+ ******************************************************************************/
+
+typedef struct
+{
+  uint32_t set_mask;
+  uint32_t clear_mask;
+}
+SHIFTSIPO_port_masks_t;
+
+/*******************************************************************************
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ * SHIFTSIPO_port_t
+ *
+ * DESCRIPTION:
+ *  Port-level bit-bang shifter. Shift clock, register clock, and serial input
+ *  are pins of a single GPIO port, and every pin transition is a precomputed
+ *  register write. The serial line and the falling shift clock are combined
+ *  into one write, so a bit costs two port writes instead of several HAL
+ *  calls, and the write loop handles a whole byte per iteration.
+ *
+ *  Writes are blocking - at port-write speeds a full chain completes in a few
+ *  microseconds. The loop assumes each port write takes longer than the shift
+ *  register propagation delay (generally 50nS or less).
+ *
+ * serial_bit
+ *  Port writes which drive the shift clock low along with a serial value of
+ *  0 or 1.
+ *
+ * shift_clock_high
+ *  Port write for the shift clock rising edge.
+ *
+ * register_clock_high, register_clock_low
+ *  Port writes for the register clock pulse.
+ *
+ * *_hal_*
+ *  User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
-bool NVMBASIC_save(NVMBASIC_instance_t* instance, bool force);
+typedef struct
+{
+  SHIFTSIPO_port_masks_t serial_bit[2];
+  SHIFTSIPO_port_masks_t shift_clock_high;
+  SHIFTSIPO_port_masks_t register_clock_high;
+  SHIFTSIPO_port_masks_t register_clock_low;
+  SHIFTSIPO_hal_port_write_t port_write;
+}
+SHIFTSIPO_port_t;
 
 /*******************************************************************************
  *
- * NVMBASIC_service
+ * SHIFTSIPO_port_initialize
  *
  * DESCRIPTION:
- *  Services the task state machine. Must be called repeatedly until the task
- *  is completed.
+ *  Precomputes the port writes of a port-level bit-bang shifter.
  *
- * RETURN:
- *  False if there is an ongoing task which has not completed, else, true.
+ * PARAMETERS:
+ *  See SHIFTSIPO_port_t.
+ *
+ *  shift_clock_mask
+ *   Port mask of the shift clock pin.
+ *
+ *  register_clock_mask
+ *   Port mask of the register clock pin.
+ *
+ *  serial_mask
+ *   Port mask of the serial input pin.
  *
  ******************************************************************************/
 
-bool NVMBASIC_service(NVMBASIC_instance_t* instance);
+void SHIFTSIPO_port_initialize(SHIFTSIPO_port_t* port,
+                               uint32_t shift_clock_mask,
+                               uint32_t register_clock_mask,
+                               uint32_t serial_mask,
+                               SHIFTSIPO_hal_port_write_t port_write);
 
 /*******************************************************************************
  *
- * NVMBASIC_is_busy
+ * SHIFTSIPO_port_write
  *
  * DESCRIPTION:
- *  Determines if an instance is currently busy with a task.
+ *  Shifts out the whole apparatus and pulses the register clock. Bits are
+ *  sent in the same order as SHIFTSIPO_begin_new_write, least-significant
+ *  bit of the first byte first.
  *
- * RETURN:
- *  True if the instance is busy with a task, else, false.
+ * PARAMETERS:
+ *  serial_buffer
+ *   Buffer which contains the data to be written.
+ *
+ *  register_count
+ *   Total number of shift registers in the apparatus.
  *
  ******************************************************************************/
 
-bool NVMBASIC_is_busy(NVMBASIC_instance_t* instance);
+void SHIFTSIPO_port_write(SHIFTSIPO_port_t* port,
+                          uint8_t* serial_buffer,
+                          uint16_t register_count);
 
 #ifdef __cplusplus
 }
 #endif
-#endif // NVMBASIC_J_H
+#endif // SHIFTSIPO_J_H
 
 /*******************************************************************************
  *
- *  Simple, and comparably tiny, replacement for stdio printf. This module
- *  parses standard variable types into their ASCII equivalents and places the
- *  characters on a user-provided Queue instance - it is expected that the user
- *  provides a character queue (element byte size of 1) and will transmit the
- *  queue via communication protocol to the terminal elsewhere.
+ *  Terminal framework configured for 80-character width windows. The framework
+ *  is composed of nodes, and each node is composed of a list of menu entries.
+ *  Entries link to user handler functions, which can be sub-state machines or
+ *  one-shot actions, or another menu node. The user is responsible for
+ *  correctly linking nodes and providing function handlers when setting up the
+ *  data structures. This module requires proper initialization and the service
+ *  routine to be called repeatedly to process requests.
  *
  ******************************************************************************/
 
-#ifndef PRINT_J_H
-#define PRINT_J_H
+#ifndef TERMENU_J_H
+#define TERMENU_J_H
 
 // Support C++ builds.
 
@@ -10255,449 +15757,535 @@ extern "C" {
 #endif
 
 /*
- * Provide a shortened command interface for the Print module and an easy way
- * to enable/disable printing. (Disabling will completely remove the code from
- * the build.) The user should define PRINT_TERMINAL_QUEUE in their code as
- * their dedicated/default terminal output Queue.
+ * The maximum length of a description. When printed, the description string
+ * will terminate at this length limit or when a NULL terminator is reached.
  */
 
-#ifdef PRINT_TERMINAL_QUEUE
-#define PCHAR(Z)                PRINT_char(&PRINT_TERMINAL_QUEUE, Z)
-#define PMSTR(Z, M)             PRINT_mstring(&PRINT_TERMINAL_QUEUE, Z, M)
-#define PSTR(Z)                 PRINT_string(&PRINT_TERMINAL_QUEUE, Z)
-#define PU32(Z)                 PRINT_uint32(&PRINT_TERMINAL_QUEUE, Z)
-#define PI32(Z)                 PRINT_int32(&PRINT_TERMINAL_QUEUE, Z)
-#define PH4(Z)                  PRINT_hex4(&PRINT_TERMINAL_QUEUE, Z)
-#define PH8(Z)                  PRINT_hex8(&PRINT_TERMINAL_QUEUE, Z)
-#define PH16(Z)                 PRINT_hex16(&PRINT_TERMINAL_QUEUE, Z)
-#define PH32(Z)                 PRINT_hex32(&PRINT_TERMINAL_QUEUE, Z)
-#define PB4(Z)                  PRINT_bin4(&PRINT_TERMINAL_QUEUE, Z)
-#define PB8(Z)                  PRINT_bin8(&PRINT_TERMINAL_QUEUE, Z)
-#define PB16(Z)                 PRINT_bin16(&PRINT_TERMINAL_QUEUE, Z)
-#define PB32(Z)                 PRINT_bin32(&PRINT_TERMINAL_QUEUE, Z)
-#define PNL()                   PRINT_newline(&PRINT_TERMINAL_QUEUE)
-#define PCLEAR()                PRINT_clear(&PRINT_TERMINAL_QUEUE)
-#else
-#define PCHAR(Z)
-#define PMSTR(Z, M)
-#define PSTR(Z)
-#define PU32(Z)
-#define PI32(Z)
-#define PH4(Z)
-#define PH8(Z)
-#define PH16(Z)
-#define PH32(Z)
-#define PB4(Z)
-#define PB8(Z)
-#define PB16(Z)
-#define PB32(Z)
-#define PNL()
-#define PCLEAR()
-#endif
+#define TERMENU_DESCRIPTION_LENGTH_MAX    32U
 
 /*******************************************************************************
  *
- * PRINT_char
+ * TERMENU_entry_handler_leaf_t
  *
  * DESCRIPTION:
- *  Enqueues a single ASCII character.
+ *  Function template for a user-provided function which is called as the
+ *  handler for a leaf-type entry.
  *
  * PARAMETERS:
- *  value
- *   ASCII characters to enqueue.
- *
- ******************************************************************************/
-
-void PRINT_char(QUEUE_instance_t* instance, char value);
-
-/*******************************************************************************
- *
- * PRINT_string
+ *  context
+ *   User-provided context.
  *
- * DESCRIPTION:
- *  Enqueues an array of ASCII characters, a string, until a null character is
- *  reached.
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true. If
+ *  false is returned, the module state machine will continue to call the
+ *  handler until true is returned. This allows the handler to implement its
+ *  own sub-state machine if needed.
  *
- * PARAMETERS:
- *  value
- *   ASCII characters to enqueue.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-void PRINT_string(QUEUE_instance_t* instance, char* value);
+typedef bool (*TERMENU_entry_handler_leaf_t)(uint32_t);
 
 /*******************************************************************************
  *
- * PRINT_mstring
+ * TERMENU_entry_handler_comment_t
  *
  * DESCRIPTION:
- *  Enqueues an array of ASCII characters, a string, until a null character or
- *  maximum length is reached.
- *
- * PARAMETERS:
- *  value
- *   ASCII characters to enqueue.
- *
- *  length
- *   Maximum number of characters to print if a null character is not reached.
+ *  Function template for a user-provided function which is called as the
+ *  handler for a comment-type entry.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-void PRINT_mstring(QUEUE_instance_t* instance, char* value, uint32_t length);
+typedef void (*TERMENU_entry_handler_comment_t)(void);
 
 /*******************************************************************************
  *
- * PRINT_uint32
+ * TERMENU_entry_type_t
  *
  * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided uint32_t.
+ *  The various ways a menu entry can be interpreted. When a menu entry is
+ *  selected, the way its handler is interpreted will depend on its type.
  *
- * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
+ * LEAF
+ *  Indicates that the handler is a user-provided function, either a sub-state
+ *  machine or a one-shot action. The active menu will remain the same.
+ *
+ * NODE
+ *  Indicates that the handler is a pointer to another menu node. The new
+ *  menu becomes active and is printed.
+ *
+ * COMMENT
+ *  Indicates that the entry is text which needs to be inserted. The handler
+ *  is a pointer to a function which will be called when the entry is printed.
  *
  ******************************************************************************/
 
-void PRINT_uint32(QUEUE_instance_t* instance, uint32_t value);
+typedef enum
+{
+  TERMENU_ENTRY_TYPE_LEAF                 = 0,
+  TERMENU_ENTRY_TYPE_NODE,
+  TERMENU_ENTRY_TYPE_COMMENT
+}
+TERMENU_entry_type_t;
 
 /*******************************************************************************
  *
- * PRINT_int32
+ * TERMENU_entry_t
  *
  * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided int32_t.
+ *  Single menu entry variables and handlers.
  *
- * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
+ * type
+ *  See TERMENU_entry_type_t.
+ *
+ * code
+ *  Single character which indicates the value the user must enter to select
+ *  the menu entry. The code should be unique for entry in a single menu. If
+ *  more than one entries have the same code, only the first listed entry will
+ *  be handled.
+ *
+ * description
+ *  NULL-terminated string which describes the menu entry and/or what happens
+ *  when it is selected.
+ *
+ * handler
+ *  Pointer or function which will be triggered upon entry selection. It will
+ *  be interpreted corresponding to the entry type.
+ *
+ * context
+ *  Value which will be passed as an argument into the handler if the entry
+ *  type is a leaf.
  *
  ******************************************************************************/
 
-void PRINT_int32(QUEUE_instance_t* instance, int32_t value);
+typedef struct
+{
+  TERMENU_entry_type_t type;
+  char code;
+  char* description;
+  void* handler;
+  uint32_t context;
+}
+TERMENU_entry_t;
 
 /*******************************************************************************
  *
- * PRINT_uint64
+ * TERMENU_node_t
  *
  * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided uint64_t.
+ *  Collection of menu entries with an uplink to the parent node.
  *
- * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
+ * entry_list
+ *  List of menu entries.
+ *
+ * length
+ *  The length, in number of entries, of the entry list.
+ *
+ * parent
+ *  Parent node menu. The parent node will become active if the user presses
+ *  <ESC>. If the parent is NULL, then the node is considered to be the root.
  *
  ******************************************************************************/
 
-void PRINT_uint64(QUEUE_instance_t* instance, uint64_t value);
+typedef struct
+{
+  TERMENU_entry_t* entry_list;
+  uint8_t length;
+  void* parent;
+}
+TERMENU_node_t;
 
 /*******************************************************************************
  *
- * PRINT_int64
+ * TERMENU_flags_t
  *
  * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided int64_t.
+ *  Module flags.
  *
- * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
+ * busy
+ *  Set when the module is busy with tasks and cleared when all tasks are
+ *  completed. All tasks are considered completed when the Rx queue is emptied
+ *  and the state machine state is idle.
+ *
+ * task_state
+ *  State machine state.
  *
  ******************************************************************************/
 
-void PRINT_int64(QUEUE_instance_t* instance, int64_t value);
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t busy                          : 1;
+    uint8_t reserved1                     : 3;
+    uint8_t task_state                    : 2;
+    uint8_t reserved6                     : 2;
+  };
+}
+TERMENU_flags_t;
 
 /*******************************************************************************
  *
- * PRINT_hex4
+ * TERMENU_instance_t
  *
  * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided uint8_t in hex-decimal
- *  format. The output will contain 1-characters.
+ *  Instance data and function pointers.
  *
- * PARAMETERS:
- *  value
- *   Value to translate to ASCII character and enqueue.
+ * flags
+ *  Module flags.
+ *
+ * rx_queue
+ *  User-provided initialized instance of a QUEUE which has been setup to hold
+ *  received terminal bytes.
+ *
+ * tx_queue
+ *  User-provided initialized instance of a QUEUE which has been setup to hold
+ *  terminal bytes to be sent.
+ *
+ * active_node
+ *  The node, or menu, which is currently displayed and listening for user
+ *  input. When the module is initialized, this should normally be the top or
+ *  root menu.
+ *
+ * password
+ *  Pointer to a password string which is used to both protect terminal access
+ *  as well as protect against electrical noise which might trigger false
+ *  input data.
+ *
+ * password_length
+ *  The length of the password string, not including the NULL-terminator. (Eg.
+ *  The password "CAT" would have a length of 3.)
+ *
+ * password_offset
+ *  Keeps track of the number of continuous characters entered by the user
+ *  which match the password. When this value reaches the password length, the
+ *  password is accepted and the terminal unlocked.
+ *
+ * task_entry_index
+ *  Index into the active node entry list of the entry handler which is being
+ *  processed.
  *
  ******************************************************************************/
 
-void PRINT_hex4(QUEUE_instance_t* instance, uint8_t value);
+typedef struct
+{
+  TERMENU_flags_t flags;
+  QUEUE_instance_t* rx_queue;
+  QUEUE_instance_t* tx_queue;
+  TERMENU_node_t* active_node;
+  char* password;
+  uint8_t password_length;
+  uint8_t password_offset;
+  uint8_t task_entry_index;
+}
+TERMENU_instance_t;
 
 /*******************************************************************************
  *
- * PRINT_hex8
+ * TERMENU_initialize
  *
  * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided uint8_t in hex-decimal
- *  format. The output will contain 2-characters.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
  *
  * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
+ *  See TERMENU_instance_t.
  *
  ******************************************************************************/
 
-void PRINT_hex8(QUEUE_instance_t* instance, uint8_t value);
+void TERMENU_initialize(TERMENU_instance_t* instance,
+                        QUEUE_instance_t* rx_queue,
+                        QUEUE_instance_t* tx_queue,
+                        TERMENU_node_t* active_node,
+                        char* password,
+                        uint8_t password_length);
 
 /*******************************************************************************
  *
- * PRINT_hex16
+ * TERMENU_service
  *
  * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided uint16_t in hex-decimal
- *  format. The output will contain 4-characters.
- *
- * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
+ *  Services the task state machine. Must be called repeatedly.
  *
  ******************************************************************************/
 
-void PRINT_hex16(QUEUE_instance_t* instance, uint16_t value);
+void TERMENU_service(TERMENU_instance_t* instance);
 
 /*******************************************************************************
  *
- * PRINT_hex32
+ * TERMENU_is_busy
  *
  * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided uint32_t in hex-decimal
- *  format. The output will contain 8-characters.
+ *  Determines if an instance is currently busy with a task.
  *
- * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
+ * RETURN:
+ *  True if the instance is busy with a task, else, false.
  *
  ******************************************************************************/
 
-void PRINT_hex32(QUEUE_instance_t* instance, uint32_t value);
+bool TERMENU_is_busy(TERMENU_instance_t* instance);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // TERMENU_J_H
 
 /*******************************************************************************
  *
- * PRINT_bin4
- *
- * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided uint8_t in binary
- *  format. The output will contain 4-characters.
- *
- * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
+ *  Terminal framework plugin for variable editing. A single instance consists
+ *  of a list of variables which are displayed in table format. The variables
+ *  are marked as RW for read/write or RO for read-only. When a RW variable is
+ *  selected, the user may modify the variable value. Read and write hooks can
+ *  be optionally used to handle read/write tasks which are more complex than
+ *  simply writing to memory space. This module requires proper initialization
+ *  and the service routine to be called repeatedly to process requests.
  *
  ******************************************************************************/
 
-void PRINT_bin4(QUEUE_instance_t* instance, uint8_t value);
+#ifndef TERVAR_J_H
+#define TERVAR_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The maximum list length for a single node/instance. This length based on the
+ * available alpha-numeric characters which will be used to number the entries.
+ */
+
+#define TERVAR_ENTRY_LIST_LENGTH_MAX      (10U + 26U + 26U)
+
+/*
+ * The maximum length of a description. When printed, the description string
+ * will terminate at this length limit or when a NULL terminator is reached.
+ */
+
+#define TERVAR_DESCRIPTION_LENGTH_MAX     32U
+
+/*
+ * The maximum number of input characters for a variable edit. The longest
+ * string should be a negative 31-bit integer which requires 11-characters.
+ */
+
+#define TERVAR_INPUT_LENGTH_MAX           11U
 
 /*******************************************************************************
  *
- * PRINT_bin8
+ * TERVAR_hal_var_read_handler_t
  *
  * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided uint8_t in binary
- *  format. The output will contain 8-characters.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will provide special variable read handling if needed. The read value
+ *  should be written to the input handler variable value.
  *
  * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
- *
- ******************************************************************************/
-
-void PRINT_bin8(QUEUE_instance_t* instance, uint8_t value);
-
-/*******************************************************************************
- *
- * PRINT_bin16
+ *  entry
+ *   Pointer to the variable entry.
  *
- * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided uint16_t in binary
- *  format. The output will contain 16-characters.
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true. If
+ *  false is returned, the terminal framework state machine will continue to
+ *  call the handler until true is returned. This allows the handler to
+ *  implement its own sub-state machine if needed.
  *
- * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
+ * NOTES:
+ *  Can be initialized as NULL - YES
  *
  ******************************************************************************/
 
-void PRINT_bin16(QUEUE_instance_t* instance, uint16_t value);
+typedef bool (*TERVAR_hal_var_read_handler_t)(void*);
 
 /*******************************************************************************
  *
- * PRINT_bin32
+ * TERVAR_hal_var_write_handler_t
  *
  * DESCRIPTION:
- *  Enqueues the ASCII representation of the provided uint32_t in binary
- *  format. The output will contain 32-characters.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will provide special variable write handling if needed. The value
+ *  to be written will have been set as the variable value in the input handler
+ *  previous to this function call.
  *
  * PARAMETERS:
- *  value
- *   Value to translate to ASCII characters and enqueue.
+ *  var_handle
+ *   Pointer to the variable entry.
+ *
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true. If
+ *  false is returned, the terminal framework state machine will continue to
+ *  call the handler until true is returned. This allows the handler to
+ *  implement its own sub-state machine if needed.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - YES
  *
  ******************************************************************************/
 
-void PRINT_bin32(QUEUE_instance_t* instance, uint32_t value);
+typedef bool (*TERVAR_hal_var_write_handler_t)(void*);
 
 /*******************************************************************************
  *
- * PRINT_newline
+ * TERVAR_var_type_t
  *
  * DESCRIPTION:
- *  Enqueues the carriage return and newline characters which produces a new
- *  line.
+ *  Lists the ways which a variable entry may be interpreted and handled when
+ *  printed and edited.
  *
  ******************************************************************************/
 
-void PRINT_newline(QUEUE_instance_t* instance);
+typedef enum
+{
+  TERVAR_VAR_TYPE_UINT8                   = 0,
+  TERVAR_VAR_TYPE_INT8,
+  TERVAR_VAR_TYPE_UINT16,
+  TERVAR_VAR_TYPE_INT16,
+  TERVAR_VAR_TYPE_UINT32,
+  TERVAR_VAR_TYPE_INT32,
+  TERVAR_VAR_TYPE_FLOAT
+}
+TERVAR_var_type_t;
 
 /*******************************************************************************
  *
- * PRINT_clear
+ * TERVAR_var_flags_t
  *
  * DESCRIPTION:
- *  Enqueues the special character sequence recognized by most terminal
- *  applications to clear the screen.
+ *  Variable node flags.
  *
- ******************************************************************************/
-
-void PRINT_clear(QUEUE_instance_t* instance);
-
-#ifdef __cplusplus
-}
-#endif
-#endif // PRINT_J_H
-
-/*******************************************************************************
- *  Rotary encoder/wheel with a A/B phase. Requires proper initialization and
- *  the service routine to be called periodically to detect changes in the A/B
- *  phases. Callback function is called when a rotation "click" is confirmed.
+ * read_only
+ *  Indicates that the variable is read-only an cannot be edited.
+ *
+ * type
+ *  See TERVAR_var_type_t.
  *
  ******************************************************************************/
 
-#ifndef ROTARYENCODER_J_H
-#define ROTARYENCODER_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t read_only                     : 1;
+    uint8_t reserved1                     : 3;
+    uint8_t type                          : 4;
+  };
+}
+TERVAR_var_flags_t;
 
 /*******************************************************************************
  *
- * ROTARYENCODER_edge_trigger_t
+ * TERVAR_input_buffer_t
  *
  * DESCRIPTION:
- *  The edge (rising, falling, or both) which will trigger the start of a new
- *  rotation tick.
+ *  Buffer which will be used to hold user input when editing a variable.
  *
  ******************************************************************************/
 
-typedef enum
+typedef struct
 {
-  ROTARYENCODER_EDGE_TRIGGER_FALLING      = 0,
-  ROTARYENCODER_EDGE_TRIGGER_RISING,
-  ROTARYENCODER_EDGE_TRIGGER_BOTH
+  uint8_t buffer[TERVAR_INPUT_LENGTH_MAX];
 }
-ROTARYENCODER_edge_trigger_t;
+TERVAR_input_buffer_t;
 
 /*******************************************************************************
  *
- * ROTARYENCODER_flags_t
+ * TERVAR_entry_t
  *
  * DESCRIPTION:
- *  Module flags.
+ *  Single variable entry variables and handlers.
  *
- * rotation_in_progress
- *  Set when a new rotation is detected. Cleared when the "click" is complete,
- *  that is, when A and B phases are the same.
+ *  variable
+ *   Pointer to the variable to view/edit.
  *
- * clockwise_rotation
- *  Set if the detected rotation is clockwise, else, cleared if counter-
- *  clockwise.
+ *  context
+ *   Value which can provide additional information for the read and write
+ *   handlers. For example, the register offset in I2C.
  *
- * debounced_a, debounced_b
- *  Set during an active rotation once each phase is debounced, and cleared
- *  at the "end" of the tick rotation. These are used to guard against false
- *  negatives that may occur by rotating the knob enough to trigger on phase
- *  and have it debounce, but then reverting to the previous tick location.
+ *  description
+ *   NULL-terminated string which describes the variable.
  *
- * last_a, last_b
- *  The last debounced phase A/B GPIO state.
+ *  flags
+ *   See TERVAR_var_flags_t.
  *
- * edge_trigger
- *  The type of edge which will qualify a for a new rotation tick. (I have
- *  found that encoders vary in their behavior. Some alternate between high
- *  and low while others will always pull back high or low after every tick.)
+ *  *_hal_*
+ *   User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
-typedef union
+typedef struct
 {
-  uint8_t all;
-  struct
-  {
-    uint8_t rotation_in_progress          : 1;
-    uint8_t clockwise_rotation            : 1;
-    uint8_t debounced_a                   : 1;
-    uint8_t debounced_b                   : 1;
-    uint8_t last_a                        : 1;
-    uint8_t last_b                        : 1;
-    uint8_t edge_trigger                  : 2;
-  };
+  void* variable;
+  uint32_t context;
+  char* description;
+  TERVAR_var_flags_t flags;
+  TERVAR_hal_var_read_handler_t read_handler;
+  TERVAR_hal_var_write_handler_t write_handler;
 }
-ROTARYENCODER_flags_t;
+TERVAR_entry_t;
 
 /*******************************************************************************
  *
- * ROTARYENCODER_hal_is_phase_a_set_t
+ * TERVAR_node_t
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will check if phase 'a' of the rotary encoder is set.
+ *  Collection of variable edit entries.
  *
- * RETURN:
- *  True if phase 'a' is set, else, false.
+ * entry_list
+ *  List of variable edit entries.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * length
+ *  The length, in number of entries, of the entry list.
  *
  ******************************************************************************/
 
-typedef bool (*ROTARYENCODER_hal_is_phase_a_set_t)(void);
+typedef struct
+{
+  TERVAR_entry_t* entry_list;
+  uint8_t length;
+}
+TERVAR_node_t;
 
 /*******************************************************************************
  *
- * ROTARYENCODER_hal_is_phase_b_set_t
+ * TERVAR_flags_t
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will check if phase 'b of the rotary encoder is set.
- *
- * RETURN:
- *  True if phase 'b' is set, else, false.
- *
- * NOTES:
- *  Can be initialized as NULL - NO
- *
- ******************************************************************************/
-
-typedef bool (*ROTARYENCODER_hal_is_phase_b_set_t)(void);
-
-/*******************************************************************************
- *
- * ROTARYENCODER_rotation_tick_callback_t
+ *  Module flags.
  *
- * DESCRIPTION:
- *  Function template for a user-provided function which is called when there is
- *  a successful clockwise (true) or counter-clockwise (false) rotation.
+ * busy
+ *  Set when the module is busy with tasks and cleared when all tasks are
+ *  completed. All tasks are considered completed when the Rx queue is emptied
+ *  and the state machine state is idle.
  *
- * PARAMETERS:
- *  clockwise
- *   True if the tick was clockwise, else, false for counter-clockwise.
+ * task_state
+ *  State machine state.
  *
  ******************************************************************************/
 
-typedef void (*ROTARYENCODER_rotation_tick_callback_t)(bool);
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t busy                          : 1;
+    uint8_t reserved1                     : 3;
+    uint8_t task_state                    : 2;
+    uint8_t reserved6                     : 2;
+  };
+}
+TERVAR_flags_t;
 
 /*******************************************************************************
  *
- * ROTARYENCODER_instance_t
+ * TERVAR_instance_t
  *
  * DESCRIPTION:
  *  Instance data and function pointers.
@@ -10705,114 +16293,134 @@ typedef void (*ROTARYENCODER_rotation_tick_callback_t)(bool);
  * flags
  *  Module flags.
  *
- * debounce_count
- *  The number of times, for both rotation directions, which the phase GPIO
- *  must be detected as stable before accepting a GPIO change.
+ * rx_queue
+ *  User-provided initialized instance of a QUEUE which has been setup to hold
+ *  received terminal bytes.
  *
- * clockwise_debounce_counter
- *  Keeps track of the debounce count in the clockwise direction.
+ * tx_queue
+ *  User-provided initialized instance of a QUEUE which has been setup to hold
+ *  terminal bytes to be sent.
  *
- * counterclockwise_debounce_counter
- *  Keeps track of the debounce count in the counterclockwise direction.
+ * node
+ *  Pointer to variable editor list.
  *
- * edge_trigger_check
- *  Internal helper function which is pointed to during initialization based
- *  upon the edge trigger type. This provides a more efficient check than
- *  repeated conditionals in each iteration.
+ * input_buffer
+ *  Pointer to user-provided buffer for holding user input when editing a
+ *  variable. Defined as a pointer to a buffer since several instances can
+ *  share the same input buffer if used under a single instance of the
+ *  framework.
  *
- * *_callback
- * *_hal_*
- *  User-provided functions. See typedef comments.
+ * input_index
+ *  Working index into the input buffer.
+ *
+ * task_entry_index
+ *  Index into the active node entry list of the entry handler which is being
+ *  processed.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  ROTARYENCODER_flags_t flags;
-  uint16_t debounce_count;
-  uint16_t clockwise_debounce_counter;
-  uint16_t counterclockwise_debounce_counter;
-  bool (*edge_trigger_check)(bool edge);
-  ROTARYENCODER_rotation_tick_callback_t rotation_tick_callback;
-  ROTARYENCODER_hal_is_phase_a_set_t is_phase_a_set;
-  ROTARYENCODER_hal_is_phase_b_set_t is_phase_b_set;
+  TERVAR_flags_t flags;
+  QUEUE_instance_t* rx_queue;
+  QUEUE_instance_t* tx_queue;
+  TERVAR_node_t* node;
+  TERVAR_input_buffer_t* input_buffer;
+  uint8_t input_index;
+  uint8_t task_entry_index;
 }
-ROTARYENCODER_instance_t;
+TERVAR_instance_t;
 
 /*******************************************************************************
  *
- * ROTARYENCODER_initialize
+ * TERVAR_initialize
  *
  * DESCRIPTION:
  *  Initializes a module instance, erasing all data structures and setting
  *  default values.
  *
  * PARAMETERS:
- *  See ROTARYENCODER_instance_t.
+ *  See TERVAR_instance_t.
  *
  ******************************************************************************/
 
-void ROTARYENCODER_initialize(ROTARYENCODER_instance_t* instance,
-                              uint16_t debounce_count,
-                              ROTARYENCODER_edge_trigger_t edge_trigger,
-                              ROTARYENCODER_rotation_tick_callback_t rotation_tick_callback,
-                              ROTARYENCODER_hal_is_phase_a_set_t is_phase_a_set,
-                              ROTARYENCODER_hal_is_phase_b_set_t is_phase_b_set);
+void TERVAR_initialize(TERVAR_instance_t* instance,
+                       QUEUE_instance_t* rx_queue,
+                       QUEUE_instance_t* tx_queue,
+                       TERVAR_node_t* node,
+                       TERVAR_input_buffer_t* input_buffer);
 
 /*******************************************************************************
  *
- * ROTARYENCODER_service
+ * TERVAR_service
  *
  * DESCRIPTION:
- *  Services the task state machine.
+ *  Services the task state machine. Must be called repeatedly.
+ *
+ * RETURN:
+ *  False if there is an ongoing task which has not completed, else, true.
  *
  ******************************************************************************/
 
-void ROTARYENCODER_service(ROTARYENCODER_instance_t* instance);
+bool TERVAR_service(TERVAR_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * TERVAR_is_busy
+ *
+ * DESCRIPTION:
+ *  Determines if an instance is currently busy with a task.
+ *
+ * RETURN:
+ *  True if the instance is busy with a task, else, false.
+ *
+ ******************************************************************************/
+
+bool TERVAR_is_busy(TERVAR_instance_t* instance);
 
 #ifdef __cplusplus
 }
 #endif
-#endif // ROTARYENCODER_J_H
+#endif // TERVAR_J_H
 
 /*******************************************************************************
  *
- *  Supports both bit-banged and SPI methods. Both methods require proper
- *  initialization and the service routine to be called repeatedly after a new
- *  task request until the task is completed.
+ *  Trace recorder for timing analysis across modules. Trace points record
+ *  compact timestamped events into a ring buffer, which can be dumped and
+ *  converted to the Chrome/Perfetto trace format with tools/trace2json.py.
  *
- *  A shift PISO is generally composed of three operation pins - shift/latch
- *  (SL), clock (CLK), and serial output (SO). SL is pulled low to activate
- *  the latch. A rising clock edge will cause the parallel input pins to be
- *  read. SL is then pulled high to activate shift mode. Each rising clock
- *  edge will shift the contents of each register to the next register in
- *  line. The last register in the apparatus will output to SO.
+ *  Trace points are compiled in by defining the TRACE_ON macro in the project
+ *  build properties. When it is not defined, they are replaced with nothing.
  *
- *  In the SPI method, the task takes place in two SPI transactions. The first
- *  triggers the latch and the second shifts the values out. The pins should
- *  be as follows:
+ *  The modules provided as source have trace points for:
+ *   - EXECUTOR task passes and sleeps.
+ *   - BUSMUTEX atomic holds, and requesters queued to wait.
+ *   - DMAENGINE segments, from start to the transfer complete ISR, and errors.
+ *   - SHIFTSIPO refresh ISR entries and row latches.
+ *   - WEBSERVER connection state transitions.
  *
- *   MOSI - Latch(0)/Shift(1)
- *   MISO - Serial Output (Q)
- *   CLK  - CLK
+ *  Recording takes no lock, so that trace points can be placed in ISRs. Each
+ *  record claims its slot with an atomic increment of the write index, and the
+ *  oldest records are overwritten. On cores without atomic read-modify-write
+ *  instructions, e.g. Cortex-M0, the slot is claimed within the critical
+ *  section HALs.
  *
- *  Shift registers generally have a propagation delay of around 50nS or less.
- *  Hence, the application code should set the SPI frequency to around 20MHz or
- *  slower.
+ *  Typical use:
  *
- *  The nature of the shift register is that the first bit to enter the shift
- *  apparatus will actually be the "last" bit, or the farthest away bit, from
- *  the head where the MOSI and CLK are connected. The resulting bit order
- *  will differ depending on the endianness of the processor and the method
- *  used.
+ *   static TRACE_record_t records[1024];
  *
- *  This module has been tested on both active low and active high MOSI/CLK
- *  configurations.
+ *   TRACE_initialize(&trace, records, 1024, SystemCoreClock, read_cyccnt, NULL, NULL);
+ *   TRACE_start(&trace);
+ *   ...
+ *   TRACE_stop();
+ *   TRACE_dump(&trace, uart_write);
+ *
+ *   $ tools/trace2json.py trace.bin -o trace.json
  *
  ******************************************************************************/
 
-#ifndef SHIFTPISO_J_H
-#define SHIFTPISO_J_H
+#ifndef TRACE_J_H
+#define TRACE_J_H
 
 // Support C++ builds.
 
@@ -10820,391 +16428,402 @@ void ROTARYENCODER_service(ROTARYENCODER_instance_t* instance);
 extern "C" {
 #endif
 
+/*
+ * Dump header magic ("JTRC") and format version.
+ */
+
+#define TRACE_DUMP_MAGIC                  0x4352544AUL
+#define TRACE_DUMP_VERSION                1U
+
 /*******************************************************************************
  *
- * SHIFTPISO_flags_t
+ * TRACE_event_t
  *
  * DESCRIPTION:
- *  Module flags.
+ *  Record event types.
  *
- * busy
- *  Set when the module is busy with a task and cleared when the task is
- *  completed.
+ * TRACE_EVENT_BEGIN, TRACE_EVENT_END
+ *  Start and end of a slice. The slice is identified by the trace ID and the
+ *  argument.
  *
- * bit_banged
- *  Set if the instance has been initialized to use the bit-banging method.
+ * TRACE_EVENT_INSTANT
+ *  Event without duration.
  *
- * task_state
- *  State machine state.
+ * TRACE_EVENT_STATE
+ *  New state of a state machine. The state lasts until the next state record
+ *  with the same trace ID and the same upper byte of the argument.
+ *
+ * TRACE_EVENT_COUNTER
+ *  New value of a counter.
  *
  ******************************************************************************/
 
-typedef union
+typedef enum
 {
-  uint8_t all;
-  struct
-  {
-    uint8_t busy                          : 1;
-    uint8_t bit_banged                    : 1;
-    uint8_t reserved2                     : 2;
-    uint8_t task_state                    : 3;
-    uint8_t reserved7                     : 1;
-  };
+  TRACE_EVENT_BEGIN                       = 0,
+  TRACE_EVENT_END,
+  TRACE_EVENT_INSTANT,
+  TRACE_EVENT_STATE,
+  TRACE_EVENT_COUNTER
 }
-SHIFTPISO_flags_t;
+TRACE_event_t;
 
 /*******************************************************************************
  *
- * SHIFTPISO_error_flags_t
+ * TRACE_id_t
  *
  * DESCRIPTION:
- *  Module error flags.
+ *  Trace IDs of the trace points in the modules provided as source, and their
+ *  arguments. Application trace points use IDs from TRACE_ID_USER.
  *
- * other
- *  All other types of errors.
+ * TRACE_ID_EXECUTOR_TASK
+ *  Slice per task pass. Argument is the task index in registration order.
  *
- * spi
- *  Errors relating to the SPI.
+ * TRACE_ID_EXECUTOR_SLEEP
+ *  Slice per sleep.
  *
- ******************************************************************************/
-
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t other                         : 1;
-    uint8_t spi                           : 1;
-    uint8_t reserved2                     : 6;
-  };
-}
-SHIFTPISO_error_flags_t;
-
-/*******************************************************************************
+ * TRACE_ID_BUSMUTEX_HOLD
+ *  Slice from acquisition to release of a bus. Argument is the owner ID in the
+ *  upper byte and the bus ID in the lower byte.
  *
- * SHIFTPISO_pre_task_callback_t
+ * TRACE_ID_BUSMUTEX_WAIT
+ *  Instant when a requester is queued. Argument as for TRACE_ID_BUSMUTEX_HOLD.
  *
- * DESCRIPTION:
- *  Function template for a user-provided function which is called when a new
- *  task is accepted and initialized but before the task actually begins. This
- *  allows the user to perform any last additional configurations before the
- *  actual logic of the task begins.
+ * TRACE_ID_DMAENGINE_SEGMENT
+ *  Slice from the start of a segment to its transfer complete ISR. Argument
+ *  identifies the channel, see TRACE_CHANNEL_KEY.
  *
- * PARAMETERS:
- *  context
- *   User-provided context.
+ * TRACE_ID_DMAENGINE_ERROR
+ *  Instant when a transfer fails. Argument as for TRACE_ID_DMAENGINE_SEGMENT.
  *
- * NOTES:
- *  Can be initialized as NULL - YES
+ * TRACE_ID_SHIFTSIPO_REFRESH_DMA_ISR, TRACE_ID_SHIFTSIPO_REFRESH_TIMER_ISR
+ *  Instant on ISR entry. Argument is the slot being shifted in.
+ *
+ * TRACE_ID_SHIFTSIPO_REFRESH_LATCH
+ *  Instant when a slot is latched. Argument is the slot.
+ *
+ * TRACE_ID_WEBSERVER_CONNECTION
+ *  State of a connection. Argument is the socket in the upper byte and the
+ *  WEBSERVER_connection_state_t in the lower byte.
  *
  ******************************************************************************/
 
-typedef void (*SHIFTPISO_pre_task_callback_t)(uint32_t);
+typedef enum
+{
+  TRACE_ID_EXECUTOR_TASK                  = 1,
+  TRACE_ID_EXECUTOR_SLEEP,
+  TRACE_ID_BUSMUTEX_HOLD,
+  TRACE_ID_BUSMUTEX_WAIT,
+  TRACE_ID_DMAENGINE_SEGMENT,
+  TRACE_ID_DMAENGINE_ERROR,
+  TRACE_ID_SHIFTSIPO_REFRESH_DMA_ISR,
+  TRACE_ID_SHIFTSIPO_REFRESH_TIMER_ISR,
+  TRACE_ID_SHIFTSIPO_REFRESH_LATCH,
+  TRACE_ID_WEBSERVER_CONNECTION,
+  TRACE_ID_USER                           = 0x80
+}
+TRACE_id_t;
+
+/*
+ * Trace points. Arguments are truncated to 16 bits. When TRACE_ON is not
+ * defined, the argument is not evaluated and no code is generated.
+ */
+
+#if defined (TRACE_ON)
+#define TRACE_BEGIN(id, argument)    TRACE_record(TRACE_EVENT_BEGIN, (id), (uint16_t)(argument))
+#define TRACE_END(id, argument)      TRACE_record(TRACE_EVENT_END, (id), (uint16_t)(argument))
+#define TRACE_INSTANT(id, argument)  TRACE_record(TRACE_EVENT_INSTANT, (id), (uint16_t)(argument))
+#define TRACE_STATE(id, argument)    TRACE_record(TRACE_EVENT_STATE, (id), (uint16_t)(argument))
+#define TRACE_COUNTER(id, value)     TRACE_record(TRACE_EVENT_COUNTER, (id), (uint16_t)(value))
+#else
+#define TRACE_BEGIN(id, argument)    ((void)sizeof((uint16_t)(argument)))
+#define TRACE_END(id, argument)      ((void)sizeof((uint16_t)(argument)))
+#define TRACE_INSTANT(id, argument)  ((void)sizeof((uint16_t)(argument)))
+#define TRACE_STATE(id, argument)    ((void)sizeof((uint16_t)(argument)))
+#define TRACE_COUNTER(id, value)     ((void)sizeof((uint16_t)(value)))
+#endif
+
+/*
+ * Derives a 16 bit argument from an instance address, for modules where
+ * instances have no index.
+ */
+
+#define TRACE_CHANNEL_KEY(instance)  ((uint16_t)((uintptr_t)(instance) >> 2))
 
 /*******************************************************************************
  *
- * SHIFTPISO_post_task_callback_t
+ * TRACE_record_t
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called after a
- *  task completes.
+ *  Trace record.
  *
- * PARAMETERS:
- *  context
- *   User-provided context.
+ * timestamp
+ *  Timestamp counter value at the time of the record.
  *
- * NOTES:
- *  Can be initialized as NULL - YES
+ * event
+ *  TRACE_event_t.
+ *
+ * id
+ *  TRACE_id_t, or an application ID from TRACE_ID_USER.
+ *
+ * argument
+ *  Event argument, see TRACE_id_t.
  *
  ******************************************************************************/
 
-typedef void (*SHIFTPISO_post_task_callback_t)(uint32_t);
+typedef struct
+{
+  uint32_t timestamp;
+  uint8_t event;
+  uint8_t id;
+  uint16_t argument;
+}
+TRACE_record_t;
 
 /*******************************************************************************
  *
- * SHIFTPISO_hal_set_clock_t
+ * TRACE_dump_header_t
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will set the shift/latch clock line high or low.
- *
- * PARAMETERS:
- *  value
- *   True to set high, false to set low.
+ *  Header written ahead of the records by TRACE_dump. All fields are little
+ *  endian, as are the records.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * magic
+ *  TRACE_DUMP_MAGIC.
  *
- ******************************************************************************/
-
-typedef void (*SHIFTPISO_hal_set_clock_t)(bool);
-
-/*******************************************************************************
+ * version
+ *  TRACE_DUMP_VERSION.
  *
- * SHIFTPISO_hal_set_latch_shift_t
+ * record_length
+ *  Size of TRACE_record_t.
  *
- * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will set the latch/shift line high or low.
+ * record_count
+ *  Number of record slots in the ring buffer.
  *
- * PARAMETERS:
- *  value
- *   True to activate latch, else, false to activate shift.
+ * write_index
+ *  Number of records written since initialization. The oldest record is at
+ *  the write index modulo the record count once the ring buffer has wrapped.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * timestamp_frequency_hz
+ *  Frequency of the timestamp counter.
  *
  ******************************************************************************/
 
-typedef void (*SHIFTPISO_hal_set_latch_shift_t)(bool);
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_length;
+  uint32_t record_count;
+  uint32_t write_index;
+  uint32_t timestamp_frequency_hz;
+}
+TRACE_dump_header_t;
 
 /*******************************************************************************
  *
- * SHIFTPISO_hal_get_serial_t
+ * TRACE_hal_get_timestamp_t
  *
  * DESCRIPTION:
  *  Hardware abstraction layer function template for a user-provided function
- *  which will get the serial line state.
- *
- * RETURN:
- *  True if the line is high, else, false.
+ *  which will return the value of a free running 32 bit counter, e.g. the DWT
+ *  cycle counter.
  *
  * NOTES:
  *  Can be initialized as NULL - NO
  *
+ *  Records which are more than half of the counter period apart can not be
+ *  ordered. Hence, the counter frequency is a trade-off between resolution and
+ *  the length of gaps without records.
+ *
  ******************************************************************************/
 
-typedef bool (*SHIFTPISO_hal_get_serial_t)(void);
+typedef uint32_t (*TRACE_hal_get_timestamp_t)(void);
 
 /*******************************************************************************
  *
- * SHIFTPISO_instance_t
+ * TRACE_hal_enter_critical_t
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
- *
- * flags
- *  Module flags.
- *
- * errors
- *  Errors which occurred in the last transaction.
- *
- * utimer
- *  User-provided initialized instance of a UTIMER.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will disable interrupts, e.g. by setting PRIMASK.
  *
- * utimer_ticket
- *  Data structure used with the UTIMER instance.
+ * NOTES:
+ *  Can be initialized as NULL - YES, on cores with atomic read-modify-write
+ *  instructions, or if trace points are not used in ISRs.
  *
- * spi
- *  User-provided initialized instance of a SERSPI.
+ *  Trace points in ISRs, or user trace points in code which has already
+ *  disabled interrupts, are reached with interrupts disabled. The HAL pair
+ *  must then nest, e.g. save PRIMASK here and restore it on exit, rather
+ *  than enable interrupts unconditionally. The library modules do not place
+ *  trace points inside their own critical sections.
  *
- * bus_mutex
- *  User-provided initialized instance of a BUSMUTEX.
+ ******************************************************************************/
+
+typedef void (*TRACE_hal_enter_critical_t)(void);
+
+/*******************************************************************************
  *
- * bus_id
- *  The BUS ID associated with the BUSMUTEX instance.
+ * TRACE_hal_exit_critical_t
  *
- * propagation_delay_us
- *  Microseconds required to delay between hardware operations in order to
- *  allow the internal circuits to stabilize.
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will re-enable interrupts, or restore the state saved by the enter
+ *  function, see TRACE_hal_enter_critical_t.
  *
- * register_count
- *  Total number of shift registers (total channels, not the number of physical
- *  devices) in the apparatus.
+ * NOTES:
+ *  Can be initialized as NULL - YES, on cores with atomic read-modify-write
+ *  instructions, or if trace points are not used in ISRs.
  *
- * register_counter
- *  Keeps track of the which register is currently being serviced.
+ ******************************************************************************/
+
+typedef void (*TRACE_hal_exit_critical_t)(void);
+
+/*******************************************************************************
  *
- * byte_offset
- *  Keeps track of the byte offset in the serial buffer.
+ * TRACE_hal_write_t
  *
- * bit_offset
- *  Keeps track of the bit offset in the serial buffer.
+ * DESCRIPTION:
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will write dump data out, e.g. to a UART, a file or a debugger
+ *  buffer.
  *
- * serial_buffer_length
- *  Required length, in bytes, of the serial buffer.
+ * PARAMETERS:
+ *  data
+ *   Data to be written.
  *
- * serial_buffer
- *  Buffer which stores the shift register values to be written.
+ *  length
+ *   Length of the data to be written.
  *
- * callback_context
- *  Context passed into the user pre/post task callbacks.
+ ******************************************************************************/
+
+typedef void (*TRACE_hal_write_t)(const void* data, uint32_t length);
+
+/*******************************************************************************
  *
- * service_handler
- *  Internal-use pointer to the active state machine service.
+ * TRACE_instance_t
  *
- * *_task_*
- * *_hal_*
- *  User-provided functions. See typedef comments.
+ * DESCRIPTION:
+ *  Trace recorder instance.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  SHIFTPISO_flags_t flags;
-  SHIFTPISO_error_flags_t errors;
-  UTIMER_instance_t* utimer;
-  UTIMER_ticket_t utimer_ticket;
-  SERSPI_instance_t* spi;
-  BUSMUTEX_instance_t* bus_mutex;
-  BUSMUTEX_bus_id_t bus_id;
-  uint16_t propagation_delay_us;
-  uint16_t register_count;
-  uint16_t register_counter;
-  uint16_t byte_offset;
-  uint8_t bit_offset;
-  uint16_t serial_buffer_length;
-  uint8_t* serial_buffer;
-  uint32_t callback_context;
-  bool (*service_handler)(void*);
-  SHIFTPISO_pre_task_callback_t pre_task_callback;
-  SHIFTPISO_post_task_callback_t post_task_callback;
-  SHIFTPISO_hal_set_clock_t set_clock;
-  SHIFTPISO_hal_set_latch_shift_t set_latch_shift;
-  SHIFTPISO_hal_get_serial_t get_serial;
+  TRACE_record_t* records;
+  uint32_t record_mask;
+  volatile uint32_t write_index;
+  uint32_t timestamp_frequency_hz;
+  TRACE_hal_get_timestamp_t get_timestamp;
+  TRACE_hal_enter_critical_t enter_critical;
+  TRACE_hal_exit_critical_t exit_critical;
 }
-SHIFTPISO_instance_t;
+TRACE_instance_t;
 
 /*******************************************************************************
  *
- * SHIFTPISO_initialize
+ * TRACE_initialize
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values. SPI method.
+ *  Initializes the instance.
  *
  * PARAMETERS:
- *  See SHIFTPISO_instance_t.
+ *  records
+ *   Ring buffer of records.
+ *
+ *  record_count
+ *   Number of records in the ring buffer, a power of two.
+ *
+ *  timestamp_frequency_hz
+ *   Frequency of the timestamp counter, reported in the dump.
  *
  ******************************************************************************/
 
-void SHIFTPISO_initialize(SHIFTPISO_instance_t* instance,
-                          SERSPI_instance_t* spi,
-                          BUSMUTEX_instance_t* bus_mutex,
-                          BUSMUTEX_bus_id_t bus_id,
-                          uint16_t register_count,
-                          SHIFTPISO_pre_task_callback_t pre_task_callback,
-                          SHIFTPISO_post_task_callback_t post_task_callback);
+void TRACE_initialize(TRACE_instance_t* instance,
+                      TRACE_record_t* records,
+                      uint32_t record_count,
+                      uint32_t timestamp_frequency_hz,
+                      TRACE_hal_get_timestamp_t get_timestamp,
+                      TRACE_hal_enter_critical_t enter_critical,
+                      TRACE_hal_exit_critical_t exit_critical);
 
 /*******************************************************************************
  *
- * SHIFTPISO_initialize_bb
+ * TRACE_start
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values. Bit-bang method.
- *
- * PARAMETERS:
- *  See SHIFTPISO_instance_t.
+ *  Starts recording the trace points to the instance.
  *
  ******************************************************************************/
 
-void SHIFTPISO_initialize_bb(SHIFTPISO_instance_t* instance,
-                             UTIMER_instance_t* utimer,
-                             uint16_t propagation_delay_us,
-                             uint16_t register_count,
-                             SHIFTPISO_pre_task_callback_t pre_task_callback,
-                             SHIFTPISO_post_task_callback_t post_task_callback,
-                             SHIFTPISO_hal_set_clock_t set_clock,
-                             SHIFTPISO_hal_set_latch_shift_t set_latch_shift,
-                             SHIFTPISO_hal_get_serial_t get_serial);
+void TRACE_start(TRACE_instance_t* instance);
 
 /*******************************************************************************
  *
- * SHIFTPISO_begin_new_read
+ * TRACE_stop
  *
  * DESCRIPTION:
- *  Attempts to begin a new serial input task.
- *
- * PARAMETERS:
- *  serial_buffer
- *   Buffer which will hold the read data. Each bit represents a single
- *   register. The buffer should be large enough to accommodate the entirety of
- *   the shift apparatus.
+ *  Stops recording the trace points.
  *
- * RETURN:
- *  True if the task request was accepted, else, false.
+ * NOTES:
+ *  A record started by an ISR just before the call may still complete after
+ *  it.
  *
  ******************************************************************************/
 
-bool SHIFTPISO_begin_new_read(SHIFTPISO_instance_t* instance, uint8_t* serial_buffer);
+void TRACE_stop(void);
 
 /*******************************************************************************
  *
- * SHIFTPISO_service
+ * TRACE_record
  *
  * DESCRIPTION:
- *  Services the task state machine. Must be called repeatedly until the task
- *  is completed.
+ *  Records an event to the started instance, if any. Normally used through
+ *  the TRACE_BEGIN, TRACE_END, TRACE_INSTANT, TRACE_STATE and TRACE_COUNTER
+ *  macros.
  *
- * RETURN:
- *  False if there is an ongoing task which has not completed, else, true.
+ * PARAMETERS:
+ *  event
+ *   TRACE_event_t.
+ *
+ *  id
+ *   TRACE_id_t, or an application ID from TRACE_ID_USER.
+ *
+ *  argument
+ *   Event argument.
  *
  ******************************************************************************/
 
-bool SHIFTPISO_service(SHIFTPISO_instance_t* instance);
+void TRACE_record(uint8_t event, uint8_t id, uint16_t argument);
 
 /*******************************************************************************
  *
- * SHIFTPISO_is_busy
+ * TRACE_dump
  *
  * DESCRIPTION:
- *  Determines if an instance is currently busy with a task.
+ *  Writes a TRACE_dump_header_t followed by the ring buffer.
  *
- * RETURN:
- *  True if the instance is busy with a task, else, false.
+ * NOTES:
+ *  Recording is to be stopped while dumping, else, records may be overwritten
+ *  while they are written out.
  *
  ******************************************************************************/
 
-bool SHIFTPISO_is_busy(SHIFTPISO_instance_t* instance);
+void TRACE_dump(TRACE_instance_t* instance, TRACE_hal_write_t write);
 
 #ifdef __cplusplus
 }
 #endif
-#endif // SHIFTPISO_J_H
+#endif // TRACE_J_H
 
 /*******************************************************************************
  *
- *  Supports both bit-banged and SPI methods. Both methods require proper
- *  initialization and the service routine to be called repeatedly after a new
- *  task request until the task is completed.
- *
- *  A shift SIPO is generally composed of three operating pins - shift clock
- *  (SCLK), register clock (RCLK), and serial input (SI). The rising edge on the
- *  SCLK causes all the shift registers to transfer their bit-value to the next
- *  shift register in line. The first shift register takes up the value provided
- *  by SI. This process is done until all shift registers are loaded with the
- *  desired output. The RCLK is then pulsed to transfer the content of the shift
- *  registers into the data registers. So long as the output enable line is
- *  opened, the values on the data registers will be sent out through the
- *  parallel lines.
- *
- *  In the SPI method, the task takes place in a single SPI transaction, which
- *  loads the shift registers, followed by a RCLK toggle via GPIO. The pin-outs,
- *  for a simple approach, should be as follows:
- *
- *   MOSI - Serial Input
- *   CLK  - Shift Clock
- *   GPIO - Register Clock
- *   GND  - Output Enable
- *
- *  Shift registers generally have a propagation delay of around 50nS or less.
- *  Hence, the application code should set the SPI frequency to around 20MHz or
- *  slower.
- *
- *  The nature of the shift register is that the first bit to enter the shift
- *  apparatus will actually be the "last" bit, or the farthest away bit, from
- *  the head where the MOSI and CLK are connected. The resulting bit order
- *  will differ depending on the endianness of the processor and the method
- *  used.
- *
- *  This module has been tested on both active low and active high MOSI/CLK
- *  configurations.
+ *  Collection of general purpose utilities (small helper functions).
  *
  ******************************************************************************/
 
-#ifndef SHIFTSIPO_J_H
-#define SHIFTSIPO_J_H
+#ifndef UTILITIES_J_H
+#define UTILITIES_J_H
 
 // Support C++ builds.
 
@@ -11212,532 +16831,634 @@ bool SHIFTPISO_is_busy(SHIFTPISO_instance_t* instance);
 extern "C" {
 #endif
 
+/*
+ * Asserts can be turned on by defining the UTILITIES_ASSERT_ON macro in the
+ * project build properties. When asserts are turned off, they will be replaced
+ * with nothing.
+ */
+
+#if defined (UTILITIES_ASSERT_ON)
+#define UTILS_ASSERT(Z)  UTILITIES_assert(Z)
+#else
+#define UTILS_ASSERT(Z)
+#endif
+
+/*
+ * Shortcut for byte-swapping operation for non-pointer types.
+ */
+
+#define UTILS_BYTE_SWAP(Z)  UTILITIES_swap_byte_order((uint8_t*)(&Z), sizeof(Z))
+
+/*
+ * MIN and MAX math operations.
+ */
+
+#define UTILS_MIN(Y, Z)  ((Y < Z) ? Y : Z)
+#define UTILS_MAX(Y, Z)  ((Y < Z) ? Z : Y)
+
 /*******************************************************************************
  *
- * SHIFTSIPO_flags_t
+ * UTILITIES_assert
  *
  * DESCRIPTION:
- *  Module flags.
+ *  Asserts that a given argument is true. If it is not true, enters into an
+ *  infinite loop. This function is meant to be used during debugging and
+ *  turned off for production builds.
  *
- * busy
- *  Set when the module is busy with a task and cleared when the task is
- *  completed.
+ * PARAMETERS:
+ *  assertion
+ *   The assertion to be checked. User should normally pass in an inline
+ *   comparison which returns a boolean result.
  *
- * bit_banged
- *  Set if the instance has been initialized to use the bit-banging method.
+ ******************************************************************************/
+
+void UTILITIES_assert(bool assertion);
+
+/*******************************************************************************
  *
- * task_state
- *  State machine state.
+ * UTILITIES_memclear
+ *
+ * DESCRIPTION:
+ *  Lite alternative for memset in the string library which writes all 0's to
+ *  a memory buffer.
+ *
+ * PARAMETERS:
+ *  start_addr
+ *   The starting address of the memory to clear.
+ *
+ *  length
+ *   The number of bytes to clear.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t busy                          : 1;
-    uint8_t bit_banged                    : 1;
-    uint8_t reserved2                     : 2;
-    uint8_t task_state                    : 3;
-    uint8_t reserved7                     : 1;
-  };
-}
-SHIFTSIPO_flags_t;
+void UTILITIES_memclear(void* start_addr, uint32_t length);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_error_flags_t
+ * UTILITIES_memset
  *
  * DESCRIPTION:
- *  Module error flags.
+ *  Lite alternative for memset in the string library.
  *
- * other
- *  All other types of errors.
+ * PARAMETERS:
+ *  start_addr
+ *   The starting address of the memory to copy.
  *
- * spi
- *  Errors relating to the SPI.
+ *  value
+ *   Value to write for every byte.
+ *
+ *  length
+ *   The number of bytes to copy.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t other                         : 1;
-    uint8_t spi                           : 1;
-    uint8_t reserved2                     : 6;
-  };
-}
-SHIFTSIPO_error_flags_t;
+void UTILITIES_memset(void* start_addr, uint8_t value, uint32_t length);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_pre_task_callback_t
+ * UTILITIES_memcpy
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called when a new
- *  task is accepted and initialized but before the task actually begins. This
- *  allows the user to perform any last additional configurations before the
- *  actual logic of the task begins.
+ *  Lite alternative for memcpy in the string library.
  *
  * PARAMETERS:
- *  context
- *   User-provided context.
+ *  dest_addr
+ *   The starting destination address.
  *
- * NOTES:
- *  Can be initialized as NULL - YES
+ *  src_addr
+ *   The starting source address of the memory to copy.
+ *
+ *  length
+ *   The number of bytes to copy.
  *
  ******************************************************************************/
 
-typedef void (*SHIFTSIPO_pre_task_callback_t)(uint32_t);
+void UTILITIES_memcpy(void* dest_addr, void* src_addr, uint32_t length);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_post_task_callback_t
+ * UTILITIES_memcmp
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called after a
- *  task completes.
+ *  Lite alternative for memcmp in the string library.
  *
  * PARAMETERS:
- *  context
- *   User-provided context.
+ *  a_addr
+ *   The starting address of memory block a.
  *
- * NOTES:
- *  Can be initialized as NULL - YES
+ *  b_addr
+ *   The starting address of memory block b.
+ *
+ *  length
+ *   The number of bytes to compare.
+ *
+ * RETURN:
+ *  0 if the memory blocks are equal, -1 if block a is less than block b,
+ *  and 1 if block a is greater than block b.
  *
  ******************************************************************************/
 
-typedef void (*SHIFTSIPO_post_task_callback_t)(uint32_t);
+int8_t UTILITIES_memcmp(void* a_addr, void* b_addr, uint32_t length);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_hal_set_shift_clock_t
+ * UTILITIES_strlen
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will set the shift clock line high or low.
+ *  Lite alternative for strlen in the string library. Counts the number of
+ *  characters up to, but not including, the NULL terminator.
  *
  * PARAMETERS:
- *  value
- *   True to set high, false to set low.
+ *  str
+ *   Input string.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * RETURN:
+ *  The number of characters up to, but not including, the NULL terminator.
  *
  ******************************************************************************/
 
-typedef void (*SHIFTSIPO_hal_set_shift_clock_t)(bool);
+uint32_t UTILITIES_strlen(char* str);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_hal_set_register_clock_t
+ * UTILITIES_strnlen
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will set the register clock line high or low.
+ *  Lite alternative for strlen_s in the string library. Counts the number of
+ *  characters up to, but not including, the NULL terminator or until a maximum
+ *  length is reached.
  *
  * PARAMETERS:
- *  value
- *   True to set high, false to set low.
+ *  str
+ *   Input string.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ *  length
+ *   Maximum characters to compare.
+ *
+ * RETURN:
+ *  The number of characters up to, but not including, the NULL terminator or
+ *  the maximum length if no NULL terminator is reached.
  *
  ******************************************************************************/
 
-typedef void (*SHIFTSIPO_hal_set_register_clock_t)(bool);
+uint32_t UTILITIES_strnlen(char* str, uint32_t length);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_hal_set_serial_t
+ * UTILITIES_strncpy
  *
  * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will set the serial line high or low.
+ *  Lite alternative for strncpy in the string library. Copies up to (n - 1)
+ *  bytes, or up to the source string NULL terminator, whichever comes first,
+ *  from a source string to a destination string.
  *
  * PARAMETERS:
- *  value
- *   True to set high, false to set low.
+ *  dest_str
+ *   The starting address of the destination string.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ *  src_str
+ *   The starting address of the source string.
+ *
+ *  n
+ *   The maximum length of the destination string, including a space for the
+ *   NULL terminator. This cannot be zero.
+ *
+ * RETURNS:
+ *  The number of bytes written, including the NULL terminator.
  *
  ******************************************************************************/
 
-typedef void (*SHIFTSIPO_hal_set_serial_t)(bool);
+uint32_t UTILITIES_strncpy(char* dest_str, char* src_str, uint32_t n);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_instance_t
+ * UTILITIES_strncmp
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
- *
- * flags
- *  Module flags.
- *
- * errors
- *  Errors which occurred in the last transaction.
- *
- * utimer
- *  User-provided initialized instance of a UTIMER.
+ *  Lite alternative for strncmp in the string library.
  *
- * utimer_ticket
- *  Data structure used with the UTIMER instance.
+ * PARAMETERS:
+ *  a_str
+ *   The starting address of string a.
  *
- * spi
- *  User-provided initialized instance of a SERSPI.
+ *  b_addr
+ *   The starting address of string b.
  *
- * bus_mutex
- *  User-provided initialized instance of a BUSMUTEX.
+ *  length
+ *   The maximum number of characters to compare in the case that a NULL-
+ *   terminator is not detected in either string first.
  *
- * bus_id
- *  The BUS ID associated with the BUSMUTEX instance.
+ * RETURN:
+ *  0 if the strings are equal, -1 if string a is less than string b, and 1 if
+ *  string a is greater than string b.
  *
- * propagation_delay_us
- *  Microseconds required to delay between hardware operations in order to
- *  allow the internal circuits to stabilize.
+ ******************************************************************************/
+
+int8_t UTILITIES_strncmp(char* a_str, char* b_str, uint32_t length);
+
+/*******************************************************************************
  *
- * register_count
- *  Total number of shift registers (total channels, not the number of physical
- *  devices) in the apparatus.
+ * UTILITIES_absolute_value
  *
- * register_counter
- *  Keeps track of the which register is currently being serviced.
+ * DESCRIPTION:
+ *  Calculates the absolute value of an input integer up to 63-bits with the
+ *  MSB sign (0x7FFFFFFFFFFFFFFF = 9223372036854775807).
  *
- * byte_offset
- *  Keeps track of the byte offset in the serial buffer.
+ * PARAMETERS:
+ *  value
+ *   The value which is passed through the absolute value algorithm.
  *
- * bit_offset
- *  Keeps track of the bit offset in the serial buffer.
+ * RETURN:
+ *  The absolute value of value.
  *
- * serial_buffer_length
- *  Required length, in bytes, of the serial buffer.
+ ******************************************************************************/
+
+uint64_t UTILITIES_absolute_value(int64_t value);
+
+/*******************************************************************************
  *
- * serial_buffer
- *  Buffer which stores the shift register values to be written.
+ * UTILITIES_swap_byte_order
  *
- * callback_context
- *  Context passed into the user pre/post task callbacks.
+ * DESCRIPTION:
+ *  Swaps the byte order of an array of bytes. The array could represent
+ *  anything from a 2-byte integer to an array of N elements.
  *
- * service_handler
- *  Internal-use pointer to the active state machine service.
+ * PARAMETERS:
+ *  byte_ary
+ *   Pointer to the byte array which will be byte order swapped.
  *
- * *_task_*
- * *_hal_*
- *  User-provided functions. See typedef comments.
+ *  length
+ *   Length of the passed in array in bytes.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  SHIFTSIPO_flags_t flags;
-  SHIFTSIPO_error_flags_t errors;
-  UTIMER_instance_t* utimer;
-  UTIMER_ticket_t utimer_ticket;
-  SERSPI_instance_t* spi;
-  BUSMUTEX_instance_t* bus_mutex;
-  BUSMUTEX_bus_id_t bus_id;
-  uint16_t propagation_delay_us;
-  uint16_t register_count;
-  uint16_t register_counter;
-  uint16_t byte_offset;
-  uint8_t bit_offset;
-  uint16_t serial_buffer_length;
-  uint8_t* serial_buffer;
-  uint32_t callback_context;
-  bool (*service_handler)(void*);
-  SHIFTSIPO_pre_task_callback_t pre_task_callback;
-  SHIFTSIPO_post_task_callback_t post_task_callback;
-  SHIFTSIPO_hal_set_shift_clock_t set_shift_clock;
-  SHIFTSIPO_hal_set_register_clock_t set_register_clock;
-  SHIFTSIPO_hal_set_serial_t set_serial;
-}
-SHIFTSIPO_instance_t;
+void UTILITIES_swap_byte_order(uint8_t* byte_ary, uint32_t length);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_initialize
+ * UTILITIES_is_ascii_numeric
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values. SPI method.
+ *  Determines if the provided character is a numeric ASCII value '0' - '9'.
  *
  * PARAMETERS:
- *  See SHIFTSIPO_instance_t.
+ *  value
+ *   The ASCII character to evaluate.
+ *
+ * RETURN:
+ *  True if the character is ASCII numeric, else, false.
  *
  ******************************************************************************/
 
-void SHIFTSIPO_initialize(SHIFTSIPO_instance_t* instance,
-                          UTIMER_instance_t* utimer,
-                          SERSPI_instance_t* spi,
-                          BUSMUTEX_instance_t* bus_mutex,
-                          BUSMUTEX_bus_id_t bus_id,
-                          uint16_t propagation_delay_us,
-                          uint16_t register_count,
-                          SHIFTSIPO_pre_task_callback_t pre_task_callback,
-                          SHIFTSIPO_post_task_callback_t post_task_callback,
-                          SHIFTSIPO_hal_set_register_clock_t set_register_clock);
+bool UTILITIES_is_ascii_numeric(char value);
+
+/*******************************************************************************
+ *
+ * UTILITIES_is_ascii_alpha_lower
+ *
+ * DESCRIPTION:
+ *  Determines if the provided character is a lower-case ASCII letter value
+ *  'a' - 'z'.
+ *
+ * PARAMETERS:
+ *  value
+ *   The ASCII character to evaluate.
+ *
+ * RETURN:
+ *  True if the character is ASCII lower-case letter, else, false.
+ *
+ ******************************************************************************/
+
+bool UTILITIES_is_ascii_alpha_lower(char value);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_initialize_bb
+ * UTILITIES_is_ascii_alpha_upper
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values. Bit-bang method.
+ *  Determines if the provided character is a upper-case ASCII letter value
+ *  'A' - 'Z'.
  *
  * PARAMETERS:
- *  See SHIFTSIPO_instance_t.
+ *  value
+ *   The ASCII character to evaluate.
+ *
+ * RETURN:
+ *  True if the character is ASCII upper-case letter, else, false.
  *
  ******************************************************************************/
 
-void SHIFTSIPO_initialize_bb(SHIFTSIPO_instance_t* instance,
-                             UTIMER_instance_t* utimer,
-                             uint16_t propagation_delay_us,
-                             uint16_t register_count,
-                             SHIFTSIPO_pre_task_callback_t pre_task_callback,
-                             SHIFTSIPO_post_task_callback_t post_task_callback,
-                             SHIFTSIPO_hal_set_shift_clock_t set_shift_clock,
-                             SHIFTSIPO_hal_set_register_clock_t set_register_clock,
-                             SHIFTSIPO_hal_set_serial_t set_serial);
+bool UTILITIES_is_ascii_alpha_upper(char value);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_begin_new_write
+ * UTILITIES_is_ascii_alpha_numeric
  *
  * DESCRIPTION:
- *  Attempts to begin a new serial output task.
+ *  Determines if the provided character is an ASCII letter, upper or lower, or
+ *  if it is a ASCII numeric value.
  *
  * PARAMETERS:
- *  serial_buffer
- *   Buffer which contains the data to be written. Each bit represents a single
- *   register. The buffer should be large enough to accommodate the entirety of
- *   the shift apparatus.
+ *  value
+ *   The ASCII character to evaluate.
  *
  * RETURN:
- *  True if the task request was accepted, else, false.
+ *  True if the character is ASCII letter or numeric, else, false.
  *
  ******************************************************************************/
 
-bool SHIFTSIPO_begin_new_write(SHIFTSIPO_instance_t* instance, uint8_t* serial_buffer);
+bool UTILITIES_is_ascii_alpha_numeric(char value);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_service
+ * UTILITIES_is_ascii_hex_numeric
  *
  * DESCRIPTION:
- *  Services the task state machine. Must be called repeatedly until the task
- *  is completed.
+ *  Determines if the provided character is a valid hex-decimal ASCII character,
+ *  upper or lower case for letters A through F.
+ *
+ * PARAMETERS:
+ *  value
+ *   The ASCII character to evaluate.
  *
  * RETURN:
- *  False if there is an ongoing task which has not completed, else, true.
+ *  True if the character is a valid ASCII hex-decimal value, else, false.
  *
  ******************************************************************************/
 
-bool SHIFTSIPO_service(SHIFTSIPO_instance_t* instance);
+bool UTILITIES_is_ascii_hex_numeric(char value);
 
 /*******************************************************************************
  *
- * SHIFTSIPO_is_busy
+ * UTILITIES_is_ascii_binary_numeric
  *
  * DESCRIPTION:
- *  Determines if an instance is currently busy with a task.
+ *  Determines if the provided character is a valid binary ASCII character,
+ *  either a '1' or a '0'.
+ *
+ * PARAMETERS:
+ *  value
+ *   The ASCII character to evaluate.
  *
  * RETURN:
- *  True if the instance is busy with a task, else, false.
+ *  True if the character is a valid ASCII binary value, else, false.
  *
  ******************************************************************************/
 
-bool SHIFTSIPO_is_busy(SHIFTSIPO_instance_t* instance);
-
-#ifdef __cplusplus
-}
-#endif
-#endif // SHIFTSIPO_J_H
+bool UTILITIES_is_ascii_binary_numeric(char value);
 
 /*******************************************************************************
  *
- *  Terminal framework configured for 80-character width windows. The framework
- *  is composed of nodes, and each node is composed of a list of menu entries.
- *  Entries link to user handler functions, which can be sub-state machines or
- *  one-shot actions, or another menu node. The user is responsible for
- *  correctly linking nodes and providing function handlers when setting up the
- *  data structures. This module requires proper initialization and the service
- *  routine to be called repeatedly to process requests.
+ * UTILITIES_parse_integer
+ *
+ * DESCRIPTION:
+ *  Parses an integer, up to a signed 64-bit value, from a provided character
+ *  string. The parse function supports decimal, hex-decimal, and binary input.
+ *  Hex-decimal should be preceeded with 0x or 0X, and binary with a 0b or 0B.
+ *  Non-applicable characters before or after the first detected numerical
+ *  value or negative sign '-' will be ignored. In a string containing two
+ *  integers separated by junk characters, only the first integer will be
+ *  parsed.
+ *
+ * PARAMETERS:
+ *  input
+ *   Character string which contains the integer value in ASCII format. User
+ *   may specify hex-decimal input by preceding the value with a 0x or 0X and
+ *   binary input with 0b or 0B. The negative sign '-' will also be considered
+ *   part of the valid integer string if found.
+ *
+ *  length
+ *   Length, in bytes, of the input buffer. The input string will be evaluated
+ *   until a NULL-terminator is detected or until this length is met.
+ *
+ * RETURN:
+ *  The parsed integer value. The user can cast the result into the appropriate
+ *  data type.
  *
  ******************************************************************************/
 
-#ifndef TERMENU_J_H
-#define TERMENU_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*
- * The maximum length of a description. When printed, the description string
- * will terminate at this length limit or when a NULL terminator is reached.
- */
-
-#define TERMENU_DESCRIPTION_LENGTH_MAX    32U
+int64_t UTILITIES_parse_integer(char* input, uint8_t length);
 
 /*******************************************************************************
  *
- * TERMENU_entry_handler_leaf_t
+ * UTILITIES_crc16
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called as the
- *  handler for a leaf-type entry.
+ *  Calculates the CRC16 (IBM version) of a provided buffer. The initial CRC
+ *  is taken as the first parameter so that large buffers can be split up and
+ *  sent through this function in chunks. For the first call, the user should
+ *  start with a CRC value of 0.
  *
  * PARAMETERS:
- *  context
- *   User-provided context.
+ *  crc
+ *   The CRC-seed (0) or on-going CRC value if this function is called multiple
+ *   times for a large buffer split into smaller parts.
  *
- * RETURN:
- *  False if there is an ongoing task which has not completed, else, true. If
- *  false is returned, the module state machine will continue to call the
- *  handler until true is returned. This allows the handler to implement its
- *  own sub-state machine if needed.
+ *  buffer
+ *   Data buffer to send through the CRC algorithm.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ *  length
+ *   Length, in bytes, of the buffer.
+ *
+ * RETURN:
+ *  Calculated CRC-16 value.
  *
  ******************************************************************************/
 
-typedef bool (*TERMENU_entry_handler_leaf_t)(uint32_t);
+uint16_t UTILITIES_crc16(uint16_t crc, void* buffer, uint32_t length);
 
 /*******************************************************************************
  *
- * TERMENU_entry_handler_comment_t
+ * UTILITIES_cidr_to_netmask
  *
  * DESCRIPTION:
- *  Function template for a user-provided function which is called as the
- *  handler for a comment-type entry.
+ *  Converts the cidr (Classlesss Inter-Domain Routing) into the equivalent 32-
+ *  bit netmask.
  *
- * NOTES:
- *  Can be initialized as NULL - NO
+ * PARAMETERS:
+ *  cidr
+ *   Classlesss Inter-Domain Routing is shorthand for the subnet mask which
+ *   is represented by /n where n can be 0-31 (the LSB must not be used for
+ *   the subnet (i.e. /32) since at least one address is needed for the IP).
+ *
+ * RETURN:
+ *  32-bit subnet mask.
  *
  ******************************************************************************/
 
-typedef void (*TERMENU_entry_handler_comment_t)(void);
+uint32_t UTILITIES_cidr_to_netmask(uint8_t cidr);
 
 /*******************************************************************************
  *
- * TERMENU_entry_type_t
+ * UTILITIES_dummy_*
  *
  * DESCRIPTION:
- *  The various ways a menu entry can be interpreted. When a menu entry is
- *  selected, the way its handler is interpreted will depend on its type.
- *
- * LEAF
- *  Indicates that the handler is a user-provided function, either a sub-state
- *  machine or a one-shot action. The active menu will remain the same.
- *
- * NODE
- *  Indicates that the handler is a pointer to another menu node. The new
- *  menu becomes active and is printed.
+ *  Collection of dummy functions. These functions are assigned to function
+ *  pointers which the user had the option to populate but did not. The use of
+ *  dummy functions takes the place of repetitive NULL checks.
  *
- * COMMENT
- *  Indicates that the entry is text which needs to be inserted. The handler
- *  is a pointer to a function which will be called when the entry is printed.
+ *  The naming convention is _<returnType>_<argType0>_<argType1>_ ...
  *
  ******************************************************************************/
 
-typedef enum
-{
-  TERMENU_ENTRY_TYPE_LEAF                 = 0,
-  TERMENU_ENTRY_TYPE_NODE,
-  TERMENU_ENTRY_TYPE_COMMENT
+void UTILITIES_dummy_void_void(void);
+void UTILITIES_dummy_void_bool(bool b);
+bool UTILITIES_dummy_false_void(void);
+bool UTILITIES_dummy_true_void(void);
+bool UTILITIES_dummy_true_bool(bool b);
+bool UTILITIES_dummy_false_voidp_u32(void* voidp, uint32_t u32) ;
+uint32_t UTILITIES_dummy_u32_void(void);
+void UTILITIES_dummy_void_u32(uint32_t u32);
+
+#ifdef __cplusplus
 }
-TERMENU_entry_type_t;
+#endif
+#endif // UTILITIES_J_H
 
 /*******************************************************************************
  *
- * TERMENU_entry_t
- *
- * DESCRIPTION:
- *  Single menu entry variables and handlers.
+ *  Website base templates, libraries, and other utilities.
  *
- * type
- *  See TERMENU_entry_type_t.
+ ******************************************************************************/
+
+#ifndef WEB_J_H
+#define WEB_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bootstrap v5.3 JavaScript.
+ */
+
+extern const uint8_t WEB_BOOTSTRAP_JS[];
+
+/*
+ * Bootstrap v5.3 CSS.
+ */
+
+extern const uint8_t WEB_BOOTSTRAP_CSS[];
+
+/*
+ * Static asset ready to be sent as a response body as is. The data is already
+ * encoded as per content_encoding, so it can be handed to the transport
+ * without copying. Asset sources are generated by tools/webasset.py.
+ */
+
+typedef struct
+{
+  const char* path;                // Request path, e.g. "/bootstrap.min.js".
+  const char* content_type;        // Value of the Content-Type header.
+  const char* content_encoding;    // Value of the Content-Encoding header, NULL if not encoded.
+  const char* etag;                // Quoted strong entity tag of the uncompressed content.
+  const uint8_t* data;
+  uint32_t length;
+  uint32_t uncompressed_length;
+}
+WEB_asset_t;
+
+/*
+ * Gzip precompressed Bootstrap v5.3 JavaScript and CSS. Unlike the arrays
+ * above, these are built from src/WebCompressed.c, so the uncompressed
+ * arrays are not linked in unless referenced.
+ */
+
+extern const uint8_t WEB_BOOTSTRAP_JS_GZ_DATA[];
+extern const uint8_t WEB_BOOTSTRAP_CSS_GZ_DATA[];
+extern const WEB_asset_t WEB_BOOTSTRAP_JS_GZ;
+extern const WEB_asset_t WEB_BOOTSTRAP_CSS_GZ;
+
+#ifdef __cplusplus
+}
+#endif
+#endif // WEB_J_H
+
+/*******************************************************************************
  *
- * code
- *  Single character which indicates the value the user must enter to select
- *  the menu entry. The code should be unique for entry in a single menu. If
- *  more than one entries have the same code, only the first listed entry will
- *  be handled.
+ *  Read-only asset file system for the WEB modules. An image holds a set of
+ *  files, packed contiguously, and a perfect hash index of their paths, so
+ *  that a path is resolved in constant time with a single string comparison.
+ *  File data, paths, and metadata are referenced in place, hence, an image
+ *  stored in flash is served without copying anything to RAM.
  *
- * description
- *  NULL-terminated string which describes the menu entry and/or what happens
- *  when it is selected.
+ *  Images are built from a directory by tools/webasset.py romfs, either as a
+ *  C source file or as a raw binary to be programmed separately. Images are
+ *  little-endian and must be 4 byte aligned.
  *
- * handler
- *  Pointer or function which will be triggered upon entry selection. It will
- *  be interpreted corresponding to the entry type.
+ *  Layout:
+ *   ROMFS_header_t
+ *   uint16_t displacements[bucket_count], padded to 4 bytes
+ *   ROMFS_entry_t entries[file_count]
+ *   NUL-terminated strings
+ *   file data, each file 4 byte aligned
  *
- * context
- *  Value which will be passed as an argument into the handler if the entry
- *  type is a leaf.
+ *  A path is hashed with the seeded FNV-1a function ROMFS_hash. Its bucket is
+ *  hash(path, 0) % bucket_count and its entry is
+ *  hash(path, displacements[bucket]) % file_count.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  TERMENU_entry_type_t type;
-  char code;
-  char* description;
-  void* handler;
-  uint32_t context;
-}
-TERMENU_entry_t;
+#ifndef ROMFS_J_H
+#define ROMFS_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ROMFS_MAGIC                       0x464D4F52U   // "ROMF"
+#define ROMFS_VERSION                     1U
+#define ROMFS_OFFSET_NONE                 0xFFFFFFFFU
 
 /*******************************************************************************
  *
- * TERMENU_node_t
+ * ROMFS_header_t
  *
  * DESCRIPTION:
- *  Collection of menu entries with an uplink to the parent node.
+ *  Image header.
  *
- * entry_list
- *  List of menu entries.
+ * magic
+ *  ROMFS_MAGIC.
  *
- * length
- *  The length, in number of entries, of the entry list.
+ * version
+ *  ROMFS_VERSION.
  *
- * parent
- *  Parent node menu. The parent node will become active if the user presses
- *  <ESC>. If the parent is NULL, then the node is considered to be the root.
+ * file_count
+ *  Number of entries. Aliases such as "/" for "/index.html" are entries of
+ *  their own which share the file data.
+ *
+ * bucket_count
+ *  Number of displacement buckets of the path index.
+ *
+ * image_length
+ *  Total image length in bytes.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  TERMENU_entry_t* entry_list;
-  uint8_t length;
-  void* parent;
+  uint32_t magic;
+  uint16_t version;
+  uint16_t file_count;
+  uint16_t bucket_count;
+  uint16_t reserved;
+  uint32_t image_length;
 }
-TERMENU_node_t;
+ROMFS_header_t;
 
 /*******************************************************************************
  *
- * TERMENU_flags_t
+ * ROMFS_entry_flags_t
  *
  * DESCRIPTION:
- *  Module flags.
- *
- * busy
- *  Set when the module is busy with tasks and cleared when all tasks are
- *  completed. All tasks are considered completed when the Rx queue is emptied
- *  and the state machine state is idle.
+ *  Entry flags.
  *
- * task_state
- *  State machine state.
+ * gzip
+ *  Set if the file data is gzip compressed.
  *
  ******************************************************************************/
 
@@ -11746,134 +17467,159 @@ typedef union
   uint8_t all;
   struct
   {
-    uint8_t busy                          : 1;
-    uint8_t reserved1                     : 3;
-    uint8_t task_state                    : 2;
-    uint8_t reserved6                     : 2;
+    uint8_t gzip                          : 1;
+    uint8_t reserved1                     : 7;
   };
 }
-TERMENU_flags_t;
+ROMFS_entry_flags_t;
 
 /*******************************************************************************
  *
- * TERMENU_instance_t
+ * ROMFS_entry_t
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
+ *  Index entry. All offsets are from the start of the image.
  *
- * flags
- *  Module flags.
- *
- * rx_queue
- *  User-provided initialized instance of a QUEUE which has been setup to hold
- *  received terminal bytes.
- *
- * tx_queue
- *  User-provided initialized instance of a QUEUE which has been setup to hold
- *  terminal bytes to be sent.
+ * path_offset
+ *  Request path, e.g. "/js/app.js".
  *
- * active_node
- *  The node, or menu, which is currently displayed and listening for user
- *  input. When the module is initialized, this should normally be the top or
- *  root menu.
+ * content_type_offset
+ *  Content-Type header value.
  *
- * password
- *  Pointer to a password string which is used to both protect terminal access
- *  as well as protect against electrical noise which might trigger false
- *  input data.
+ * etag_offset
+ *  Quoted entity tag, ROMFS_OFFSET_NONE if none.
  *
- * password_length
- *  The length of the password string, not including the NULL-terminator. (Eg.
- *  The password "CAT" would have a length of 3.)
+ * data_offset / length
+ *  File data as stored.
  *
- * password_offset
- *  Keeps track of the number of continuous characters entered by the user
- *  which match the password. When this value reaches the password length, the
- *  password is accepted and the terminal unlocked.
+ * uncompressed_length
+ *  Length of the file before compression.
  *
- * task_entry_index
- *  Index into the active node entry list of the entry handler which is being
- *  processed.
+ * flags
+ *  See ROMFS_entry_flags_t.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  TERMENU_flags_t flags;
-  QUEUE_instance_t* rx_queue;
-  QUEUE_instance_t* tx_queue;
-  TERMENU_node_t* active_node;
-  char* password;
-  uint8_t password_length;
-  uint8_t password_offset;
-  uint8_t task_entry_index;
+  uint32_t path_offset;
+  uint32_t content_type_offset;
+  uint32_t etag_offset;
+  uint32_t data_offset;
+  uint32_t length;
+  uint32_t uncompressed_length;
+  ROMFS_entry_flags_t flags;
+  uint8_t reserved[3];
 }
-TERMENU_instance_t;
+ROMFS_entry_t;
 
 /*******************************************************************************
  *
- * TERMENU_initialize
+ * ROMFS_hash
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values.
+ *  Seeded 32-bit FNV-1a hash of a NUL-terminated path.
  *
  * PARAMETERS:
- *  See TERMENU_instance_t.
+ *  seed
+ *   Value mixed into the offset basis.
+ *
+ * RETURN:
+ *  The hash value.
  *
  ******************************************************************************/
 
-void TERMENU_initialize(TERMENU_instance_t* instance,
-                        QUEUE_instance_t* rx_queue,
-                        QUEUE_instance_t* tx_queue,
-                        TERMENU_node_t* active_node,
-                        char* password,
-                        uint8_t password_length);
+uint32_t ROMFS_hash(const char* path, uint32_t seed);
 
 /*******************************************************************************
  *
- * TERMENU_service
+ * ROMFS_is_valid
  *
  * DESCRIPTION:
- *  Services the task state machine. Must be called repeatedly.
+ *  Checks the image header.
+ *
+ * RETURN:
+ *  True if the image has a supported header, else, false.
  *
  ******************************************************************************/
 
-void TERMENU_service(TERMENU_instance_t* instance);
+bool ROMFS_is_valid(const void* image);
 
 /*******************************************************************************
  *
- * TERMENU_is_busy
+ * ROMFS_lookup
  *
  * DESCRIPTION:
- *  Determines if an instance is currently busy with a task.
+ *  Finds the entry of a path.
+ *
+ * PARAMETERS:
+ *  image
+ *   Valid image, see ROMFS_is_valid.
+ *
+ *  path
+ *   NUL-terminated request path without a query.
  *
  * RETURN:
- *  True if the instance is busy with a task, else, false.
+ *  Pointer to the entry in the image, else, NULL if the image has no such
+ *  path.
  *
  ******************************************************************************/
 
-bool TERMENU_is_busy(TERMENU_instance_t* instance);
+const ROMFS_entry_t* ROMFS_lookup(const void* image, const char* path);
+
+/*******************************************************************************
+ *
+ * ROMFS_open
+ *
+ * DESCRIPTION:
+ *  Finds a path and describes its file as a WEB asset whose strings and data
+ *  point into the image. The signature matches WEBSERVER_asset_resolver_t, so
+ *  an image can be served by passing this function and the image to
+ *  WEBSERVER_set_asset_resolver.
+ *
+ * PARAMETERS:
+ *  image
+ *   Valid image, see ROMFS_is_valid.
+ *
+ *  path
+ *   NUL-terminated request path without a query.
+ *
+ *  asset
+ *   Asset to fill in.
+ *
+ * RETURN:
+ *  True if the path was found, else, false.
+ *
+ ******************************************************************************/
+
+bool ROMFS_open(const void* image, const char* path, WEB_asset_t* asset);
 
 #ifdef __cplusplus
 }
 #endif
-#endif // TERMENU_J_H
+#endif // ROMFS_J_H
 
 /*******************************************************************************
  *
- *  Terminal framework plugin for variable editing. A single instance consists
- *  of a list of variables which are displayed in table format. The variables
- *  are marked as RW for read/write or RO for read-only. When a RW variable is
- *  selected, the user may modify the variable value. Read and write hooks can
- *  be optionally used to handle read/write tasks which are more complex than
- *  simply writing to memory space. This module requires proper initialization
- *  and the service routine to be called repeatedly to process requests.
+ *  Non-blocking HTTP/1.1 server for static WEB assets and small API handlers.
+ *  Requires proper initialization and the service routine to be called
+ *  repeatedly.
+ *
+ *  The server runs on top of a minimal, non-blocking socket HAL and holds a
+ *  fixed number of user-provided connections, each with its own request and
+ *  response buffers. Persistent (keep-alive) connections are supported, as
+ *  are pipelined requests, which are answered in order.
+ *
+ *  Requests are matched against a user-provided route table. Asset routes
+ *  send a WEB_asset_t body directly from where it is stored, in chunks, so
+ *  that large assets are never copied into RAM. Handler routes call a user
+ *  function which writes a small response body, typically JSON, into the
+ *  connection response buffer.
  *
  ******************************************************************************/
 
-#ifndef TERVAR_J_H
-#define TERVAR_J_H
+#ifndef WEBSERVER_J_H
+#define WEBSERVER_J_H
 
 // Support C++ builds.
 
@@ -11882,861 +17628,968 @@ extern "C" {
 #endif
 
 /*
- * The maximum list length for a single node/instance. This length based on the
- * available alpha-numeric characters which will be used to number the entries.
+ * Size of the per connection request buffer, which must hold the request
+ * line, headers, and body of a single request. Larger requests are answered
+ * with an error. Can be overridden in the project build properties.
  */
 
-#define TERVAR_ENTRY_LIST_LENGTH_MAX      (10U + 26U + 26U)
+#ifndef WEBSERVER_REQUEST_BUFFER_LENGTH
+#define WEBSERVER_REQUEST_BUFFER_LENGTH   1024U
+#endif
 
 /*
- * The maximum length of a description. When printed, the description string
- * will terminate at this length limit or when a NULL terminator is reached.
+ * Size of the per connection response buffer, which holds the response
+ * headers and handler response bodies. Can be overridden in the project build
+ * properties.
  */
 
-#define TERVAR_DESCRIPTION_LENGTH_MAX     32U
+#ifndef WEBSERVER_RESPONSE_BUFFER_LENGTH
+#define WEBSERVER_RESPONSE_BUFFER_LENGTH  768U
+#endif
 
 /*
- * The maximum number of input characters for a variable edit. The longest
- * string should be a negative 31-bit integer which requires 11-characters.
+ * Portion of the response buffer reserved for response headers. The rest is
+ * available to handlers for the response body.
  */
 
-#define TERVAR_INPUT_LENGTH_MAX           11U
+#define WEBSERVER_RESPONSE_HEADER_LENGTH_MAX  256U
 
-/*******************************************************************************
- *
- * TERVAR_hal_var_read_handler_t
- *
- * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will provide special variable read handling if needed. The read value
- *  should be written to the input handler variable value.
- *
- * PARAMETERS:
- *  entry
- *   Pointer to the variable entry.
- *
- * RETURN:
- *  False if there is an ongoing task which has not completed, else, true. If
- *  false is returned, the terminal framework state machine will continue to
- *  call the handler until true is returned. This allows the handler to
- *  implement its own sub-state machine if needed.
- *
- * NOTES:
- *  Can be initialized as NULL - YES
- *
- ******************************************************************************/
+/*
+ * Maximum number of bytes handed to the send HAL function at once. Matching
+ * the TCP maximum segment size keeps the transport from buffering a copy.
+ */
 
-typedef bool (*TERVAR_hal_var_read_handler_t)(void*);
+#ifndef WEBSERVER_SEND_CHUNK_LENGTH
+#define WEBSERVER_SEND_CHUNK_LENGTH       1460U
+#endif
 
-/*******************************************************************************
- *
- * TERVAR_hal_var_write_handler_t
- *
- * DESCRIPTION:
- *  Hardware abstraction layer function template for a user-provided function
- *  which will provide special variable write handling if needed. The value
- *  to be written will have been set as the variable value in the input handler
- *  previous to this function call.
- *
- * PARAMETERS:
- *  var_handle
- *   Pointer to the variable entry.
- *
- * RETURN:
- *  False if there is an ongoing task which has not completed, else, true. If
- *  false is returned, the terminal framework state machine will continue to
- *  call the handler until true is returned. This allows the handler to
- *  implement its own sub-state machine if needed.
- *
- * NOTES:
- *  Can be initialized as NULL - YES
- *
- ******************************************************************************/
+/*
+ * Maximum number of send HAL calls per connection per service call, so that
+ * one large transfer cannot starve the other connections.
+ */
 
-typedef bool (*TERVAR_hal_var_write_handler_t)(void*);
+#define WEBSERVER_SEND_CHUNKS_PER_SERVICE 4U
 
 /*******************************************************************************
  *
- * TERVAR_var_type_t
+ * WEBSERVER_method_t
  *
  * DESCRIPTION:
- *  Lists the ways which a variable entry may be interpreted and handled when
- *  printed and edited.
+ *  Request methods. Values are bit masks so that a route can allow several.
  *
  ******************************************************************************/
 
 typedef enum
 {
-  TERVAR_VAR_TYPE_UINT8                   = 0,
-  TERVAR_VAR_TYPE_INT8,
-  TERVAR_VAR_TYPE_UINT16,
-  TERVAR_VAR_TYPE_INT16,
-  TERVAR_VAR_TYPE_UINT32,
-  TERVAR_VAR_TYPE_INT32,
-  TERVAR_VAR_TYPE_FLOAT
+  WEBSERVER_METHOD_GET                    = 0x01,
+  WEBSERVER_METHOD_HEAD                   = 0x02,
+  WEBSERVER_METHOD_POST                   = 0x04,
+  WEBSERVER_METHOD_PUT                    = 0x08,
+  WEBSERVER_METHOD_DELETE                 = 0x10
 }
-TERVAR_var_type_t;
+WEBSERVER_method_t;
 
 /*******************************************************************************
  *
- * TERVAR_var_flags_t
+ * WEBSERVER_request_t
  *
  * DESCRIPTION:
- *  Variable node flags.
+ *  Parsed request as passed to route handlers. All strings are NUL-terminated
+ *  and point into the connection request buffer.
  *
- * read_only
- *  Indicates that the variable is read-only an cannot be edited.
+ * method
+ *  See WEBSERVER_method_t.
  *
- * type
- *  See TERVAR_var_type_t.
+ * keep_alive
+ *  True if the connection is kept open after the response.
  *
- ******************************************************************************/
-
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t read_only                     : 1;
-    uint8_t reserved1                     : 3;
-    uint8_t type                          : 4;
-  };
-}
-TERVAR_var_flags_t;
-
-/*******************************************************************************
+ * path
+ *  Request target without the query.
  *
- * TERVAR_input_buffer_t
+ * query
+ *  Query string without the leading '?', NULL if the target has none.
  *
- * DESCRIPTION:
- *  Buffer which will be used to hold user input when editing a variable.
+ * if_none_match
+ *  Value of the If-None-Match header, NULL if not present.
+ *
+ * accept_encoding
+ *  Value of the Accept-Encoding header, NULL if not present.
+ *
+ * headers / headers_length
+ *  Raw header fields, see WEBSERVER_request_header.
+ *
+ * body
+ *  Request body, NULL if the request has none.
+ *
+ * body_length
+ *  Length of the request body in bytes.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  uint8_t buffer[TERVAR_INPUT_LENGTH_MAX];
+  uint8_t method;
+  bool keep_alive;
+  char* path;
+  char* query;
+  char* if_none_match;
+  char* accept_encoding;
+  char* headers;
+  uint16_t headers_length;
+  uint8_t* body;
+  uint16_t body_length;
 }
-TERVAR_input_buffer_t;
+WEBSERVER_request_t;
 
 /*******************************************************************************
  *
- * TERVAR_entry_t
+ * WEBSERVER_response_t
  *
  * DESCRIPTION:
- *  Single variable entry variables and handlers.
- *
- *  variable
- *   Pointer to the variable to view/edit.
+ *  Response body written by route handlers.
  *
- *  context
- *   Value which can provide additional information for the read and write
- *   handlers. For example, the register offset in I2C.
+ * content_type
+ *  Value of the Content-Type header. Defaults to "application/json".
  *
- *  description
- *   NULL-terminated string which describes the variable.
+ * body
+ *  Buffer to write the body into.
  *
- *  flags
- *   See TERVAR_var_flags_t.
+ * body_capacity
+ *  Size of the body buffer.
  *
- *  *_hal_*
- *   User-provided functions. See typedef comments.
+ * body_length
+ *  Number of body bytes written.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  void* variable;
-  uint32_t context;
-  char* description;
-  TERVAR_var_flags_t flags;
-  TERVAR_hal_var_read_handler_t read_handler;
-  TERVAR_hal_var_write_handler_t write_handler;
+  const char* content_type;
+  char* body;
+  uint16_t body_capacity;
+  uint16_t body_length;
 }
-TERVAR_entry_t;
+WEBSERVER_response_t;
 
 /*******************************************************************************
  *
- * TERVAR_node_t
+ * WEBSERVER_handler_t
  *
  * DESCRIPTION:
- *  Collection of variable edit entries.
+ *  Function template for a user-provided route handler. Called from the
+ *  service routine once a complete request has been received.
  *
- * entry_list
- *  List of variable edit entries.
+ * PARAMETERS:
+ *  context
+ *   The route context.
  *
- * length
- *  The length, in number of entries, of the entry list.
+ *  request
+ *   The parsed request.
+ *
+ *  response
+ *   The response whose body the handler writes, see
+ *   WEBSERVER_response_append.
+ *
+ * RETURN:
+ *  The response status code, e.g. 200.
  *
  ******************************************************************************/
 
-typedef struct
-{
-  TERVAR_entry_t* entry_list;
-  uint8_t length;
-}
-TERVAR_node_t;
+typedef uint16_t (*WEBSERVER_handler_t)(uint32_t context,
+                                        const WEBSERVER_request_t* request,
+                                        WEBSERVER_response_t* response);
 
 /*******************************************************************************
  *
- * TERVAR_flags_t
+ * WEBSERVER_upgrade_handler_t
  *
  * DESCRIPTION:
- *  Module flags.
+ *  Function template for a user-provided protocol upgrade handler, e.g. for
+ *  WebSocket. Called from the service routine once a complete request has
+ *  been received.
  *
- * busy
- *  Set when the module is busy with tasks and cleared when all tasks are
- *  completed. All tasks are considered completed when the Rx queue is emptied
- *  and the state machine state is idle.
+ * PARAMETERS:
+ *  context
+ *   The route context.
  *
- * task_state
- *  State machine state.
+ *  socket
+ *   Socket handle of the connection.
+ *
+ *  request
+ *   The parsed request.
+ *
+ * RETURN:
+ *  101 if the handler has taken over the socket, in which case it sends the
+ *  101 response itself and becomes responsible for closing the socket. Else,
+ *  the error status code for the server to respond with.
  *
  ******************************************************************************/
 
-typedef union
-{
-  uint8_t all;
-  struct
-  {
-    uint8_t busy                          : 1;
-    uint8_t reserved1                     : 3;
-    uint8_t task_state                    : 2;
-    uint8_t reserved6                     : 2;
-  };
-}
-TERVAR_flags_t;
+typedef uint16_t (*WEBSERVER_upgrade_handler_t)(uint32_t context,
+                                                int32_t socket,
+                                                const WEBSERVER_request_t* request);
 
 /*******************************************************************************
  *
- * TERVAR_instance_t
+ * WEBSERVER_route_t
  *
  * DESCRIPTION:
- *  Instance data and function pointers.
+ *  Route table entry. A route either sends a static asset, calls a handler,
+ *  or hands the connection over to an upgrade handler.
  *
- * flags
- *  Module flags.
- *
- * rx_queue
- *  User-provided initialized instance of a QUEUE which has been setup to hold
- *  received terminal bytes.
+ * path
+ *  Request path to match exactly. Can be NULL for asset routes to use the
+ *  asset path.
  *
- * tx_queue
- *  User-provided initialized instance of a QUEUE which has been setup to hold
- *  terminal bytes to be sent.
+ * methods
+ *  Bitwise OR of the allowed WEBSERVER_method_t values. Asset routes only
+ *  support GET and HEAD.
  *
- * node
- *  Pointer to variable editor list.
+ * asset
+ *  Asset to send, NULL for handler routes.
  *
- * input_buffer
- *  Pointer to user-provided buffer for holding user input when editing a
- *  variable. Defined as a pointer to a buffer since several instances can
- *  share the same input buffer if used under a single instance of the
- *  framework.
+ * handler
+ *  Handler to call, NULL for asset and upgrade routes.
  *
- * input_index
- *  Working index into the input buffer.
+ * context
+ *  Value passed to the handler.
  *
- * task_entry_index
- *  Index into the active node entry list of the entry handler which is being
- *  processed.
+ * upgrade
+ *  Upgrade handler to call, NULL for asset and handler routes.
  *
  ******************************************************************************/
 
 typedef struct
 {
-  TERVAR_flags_t flags;
-  QUEUE_instance_t* rx_queue;
-  QUEUE_instance_t* tx_queue;
-  TERVAR_node_t* node;
-  TERVAR_input_buffer_t* input_buffer;
-  uint8_t input_index;
-  uint8_t task_entry_index;
+  const char* path;
+  uint8_t methods;
+  const WEB_asset_t* asset;
+  WEBSERVER_handler_t handler;
+  uint32_t context;
+  WEBSERVER_upgrade_handler_t upgrade;
 }
-TERVAR_instance_t;
+WEBSERVER_route_t;
 
 /*******************************************************************************
  *
- * TERVAR_initialize
+ * WEBSERVER_asset_resolver_t
  *
  * DESCRIPTION:
- *  Initializes a module instance, erasing all data structures and setting
- *  default values.
+ *  Function template for a user-provided function which will look up assets
+ *  not listed in the route table, e.g. ROMFS_open. Only called for GET and
+ *  HEAD requests.
  *
  * PARAMETERS:
- *  See TERVAR_instance_t.
- *
- ******************************************************************************/
-
-void TERVAR_initialize(TERVAR_instance_t* instance,
-                       QUEUE_instance_t* rx_queue,
-                       QUEUE_instance_t* tx_queue,
-                       TERVAR_node_t* node,
-                       TERVAR_input_buffer_t* input_buffer);
-
-/*******************************************************************************
+ *  context
+ *   The resolver context, e.g. the ROMFS image.
  *
- * TERVAR_service
+ *  path
+ *   Request path.
  *
- * DESCRIPTION:
- *  Services the task state machine. Must be called repeatedly.
+ *  asset
+ *   Asset to fill in. The strings and data it points to must remain valid
+ *   while the module is used.
  *
  * RETURN:
- *  False if there is an ongoing task which has not completed, else, true.
+ *  True if the asset was found, else, false.
  *
  ******************************************************************************/
 
-bool TERVAR_service(TERVAR_instance_t* instance);
+typedef bool (*WEBSERVER_asset_resolver_t)(const void* context, const char* path, WEB_asset_t* asset);
 
 /*******************************************************************************
  *
- * TERVAR_is_busy
+ * WEBSERVER_connection_state_t
  *
  * DESCRIPTION:
- *  Determines if an instance is currently busy with a task.
- *
- * RETURN:
- *  True if the instance is busy with a task, else, false.
+ *  Connection state machine states.
  *
  ******************************************************************************/
 
-bool TERVAR_is_busy(TERVAR_instance_t* instance);
-
-#ifdef __cplusplus
+typedef enum
+{
+  WEBSERVER_CONNECTION_STATE_FREE         = 0,
+  WEBSERVER_CONNECTION_STATE_RECEIVING,
+  WEBSERVER_CONNECTION_STATE_SENDING
 }
-#endif
-#endif // TERVAR_J_H
+WEBSERVER_connection_state_t;
 
 /*******************************************************************************
  *
- *  Collection of general purpose utilities (small helper functions).
+ * WEBSERVER_connection_flags_t
+ *
+ * DESCRIPTION:
+ *  Connection flags.
+ *
+ * state
+ *  See WEBSERVER_connection_state_t.
+ *
+ * keep_alive
+ *  Set if the connection is kept open once the current response is sent.
  *
  ******************************************************************************/
 
-#ifndef UTILITIES_J_H
-#define UTILITIES_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*
- * Asserts can be turned on by defining the UTILITIES_ASSERT_ON macro in the
- * project build properties. When asserts are turned off, they will be replaced
- * with nothing.
- */
-
-#if defined (UTILITIES_ASSERT_ON)
-#define UTILS_ASSERT(Z)  UTILITIES_assert(Z)
-#else
-#define UTILS_ASSERT(Z)
-#endif
-
-/*
- * Shortcut for byte-swapping operation for non-pointer types.
- */
-
-#define UTILS_BYTE_SWAP(Z)  UTILITIES_swap_byte_order((uint8_t*)(&Z), sizeof(Z))
-
-/*
- * MIN and MAX math operations.
- */
-
-#define UTILS_MIN(Y, Z)  ((Y < Z) ? Y : Z)
-#define UTILS_MAX(Y, Z)  ((Y < Z) ? Z : Y)
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t state                         : 2;
+    uint8_t keep_alive                    : 1;
+    uint8_t reserved3                     : 5;
+  };
+}
+WEBSERVER_connection_flags_t;
 
 /*******************************************************************************
  *
- * UTILITIES_assert
+ * WEBSERVER_connection_t
  *
  * DESCRIPTION:
- *  Asserts that a given argument is true. If it is not true, enters into an
- *  infinite loop. This function is meant to be used during debugging and
- *  turned off for production builds.
+ *  Connection data and buffers. Only to be allocated by the user, all fields
+ *  are managed by the module.
  *
- * PARAMETERS:
- *  assertion
- *   The assertion to be checked. User should normally pass in an inline
- *   comparison which returns a boolean result.
+ * socket
+ *  Socket handle as returned by the accept HAL function.
  *
- ******************************************************************************/
-
-void UTILITIES_assert(bool assertion);
-
-/*******************************************************************************
+ * idle_ticket
+ *  Restarted whenever data is received or sent. The connection is closed once
+ *  it expires.
  *
- * UTILITIES_memclear
+ * received_length
+ *  Number of bytes in the request buffer.
  *
- * DESCRIPTION:
- *  Lite alternative for memset in the string library which writes all 0's to
- *  a memory buffer.
+ * header_length
+ *  Length of the request line and headers including the terminating empty
+ *  line, 0 while not yet fully received.
  *
- * PARAMETERS:
- *  start_addr
- *   The starting address of the memory to clear.
+ * request_length
+ *  Length of the request being answered, 0 while the headers are not yet
+ *  parsed. Bytes past it belong to the next pipelined request.
  *
- *  length
- *   The number of bytes to clear.
+ * scan_offset
+ *  Request buffer offset from which to resume searching for the end of the
+ *  headers.
+ *
+ * send_data / send_remaining
+ *  Segment being sent.
+ *
+ * body_data / body_remaining
+ *  Segment to send once the current one is sent, i.e. the asset body after
+ *  the response headers.
+ *
+ * request
+ *  The parsed request, valid once request_length is set.
  *
  ******************************************************************************/
 
-void UTILITIES_memclear(void* start_addr, uint32_t length);
+typedef struct
+{
+  WEBSERVER_connection_flags_t flags;
+  int32_t socket;
+  UTIMER_ticket_t idle_ticket;
+  uint16_t received_length;
+  uint16_t header_length;
+  uint16_t request_length;
+  uint16_t scan_offset;
+  const uint8_t* send_data;
+  uint32_t send_remaining;
+  const uint8_t* body_data;
+  uint32_t body_remaining;
+  WEBSERVER_request_t request;
+  uint8_t request_buffer[WEBSERVER_REQUEST_BUFFER_LENGTH];
+  uint8_t response[WEBSERVER_RESPONSE_BUFFER_LENGTH];
+}
+WEBSERVER_connection_t;
 
 /*******************************************************************************
  *
- * UTILITIES_memset
+ * WEBSERVER_flags_t
  *
  * DESCRIPTION:
- *  Lite alternative for memset in the string library.
- *
- * PARAMETERS:
- *  start_addr
- *   The starting address of the memory to copy.
- *
- *  value
- *   Value to write for every byte.
- *
- *  length
- *   The number of bytes to copy.
+ *  Module flags.
  *
  ******************************************************************************/
 
-void UTILITIES_memset(void* start_addr, uint8_t value, uint32_t length);
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t reserved0                     : 8;
+  };
+}
+WEBSERVER_flags_t;
 
 /*******************************************************************************
  *
- * UTILITIES_memcpy
+ * WEBSERVER_hal_accept_t
  *
  * DESCRIPTION:
- *  Lite alternative for memcpy in the string library.
- *
- * PARAMETERS:
- *  dest_addr
- *   The starting destination address.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will accept a pending connection on the listening socket without
+ *  blocking. Only called when a connection slot is free, so that excess
+ *  connections wait in the listen backlog.
  *
- *  src_addr
- *   The starting source address of the memory to copy.
+ * RETURN:
+ *  Handle of the accepted socket, else, a negative value if no connection is
+ *  pending.
  *
- *  length
- *   The number of bytes to copy.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-void UTILITIES_memcpy(void* dest_addr, void* src_addr, uint32_t length);
+typedef int32_t (*WEBSERVER_hal_accept_t)(void);
 
 /*******************************************************************************
  *
- * UTILITIES_memcmp
+ * WEBSERVER_hal_recv_t
  *
  * DESCRIPTION:
- *  Lite alternative for memcmp in the string library.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will read received data from a socket without blocking.
  *
  * PARAMETERS:
- *  a_addr
- *   The starting address of memory block a.
+ *  socket
+ *   Socket handle.
  *
- *  b_addr
- *   The starting address of memory block b.
+ *  buffer
+ *   Buffer to copy the received data into.
  *
  *  length
- *   The number of bytes to compare.
+ *   Maximum number of bytes to copy.
  *
  * RETURN:
- *  0 if the memory blocks are equal, -1 if block a is less than block b,
- *  and 1 if block a is greater than block b.
+ *  Number of bytes copied, 0 if no data is available, else, a negative value
+ *  if the peer closed the connection or an error occurred.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-int8_t UTILITIES_memcmp(void* a_addr, void* b_addr, uint32_t length);
+typedef int32_t (*WEBSERVER_hal_recv_t)(int32_t socket, uint8_t* buffer, uint32_t length);
 
 /*******************************************************************************
  *
- * UTILITIES_strlen
+ * WEBSERVER_hal_send_t
  *
  * DESCRIPTION:
- *  Lite alternative for strlen in the string library. Counts the number of
- *  characters up to, but not including, the NULL terminator.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will queue data for sending on a socket without blocking.
  *
  * PARAMETERS:
- *  str
- *   Input string.
+ *  socket
+ *   Socket handle.
+ *
+ *  data
+ *   Data to send. May point to flash.
+ *
+ *  length
+ *   Number of bytes to send.
  *
  * RETURN:
- *  The number of characters up to, but not including, the NULL terminator.
+ *  Number of bytes accepted, which may be fewer than requested, 0 if the
+ *  transport cannot accept any data yet, else, a negative value if an error
+ *  occurred.
+ *
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-uint32_t UTILITIES_strlen(char* str);
+typedef int32_t (*WEBSERVER_hal_send_t)(int32_t socket, const uint8_t* data, uint32_t length);
 
 /*******************************************************************************
  *
- * UTILITIES_strnlen
+ * WEBSERVER_hal_close_t
  *
  * DESCRIPTION:
- *  Lite alternative for strlen_s in the string library. Counts the number of
- *  characters up to, but not including, the NULL terminator or until a maximum
- *  length is reached.
+ *  Hardware abstraction layer function template for a user-provided function
+ *  which will close a socket.
  *
  * PARAMETERS:
- *  str
- *   Input string.
- *
- *  length
- *   Maximum characters to compare.
+ *  socket
+ *   Socket handle.
  *
- * RETURN:
- *  The number of characters up to, but not including, the NULL terminator or
- *  the maximum length if no NULL terminator is reached.
+ * NOTES:
+ *  Can be initialized as NULL - NO
  *
  ******************************************************************************/
 
-uint32_t UTILITIES_strnlen(char* str, uint32_t length);
+typedef void (*WEBSERVER_hal_close_t)(int32_t socket);
 
 /*******************************************************************************
  *
- * UTILITIES_strncpy
+ * WEBSERVER_instance_t
  *
  * DESCRIPTION:
- *  Lite alternative for strncpy in the string library. Copies up to (n - 1)
- *  bytes, or up to the source string NULL terminator, whichever comes first,
- *  from a source string to a destination string.
+ *  Instance data and function pointers.
  *
- * PARAMETERS:
- *  dest_str
- *   The starting address of the destination string.
+ * flags
+ *  Module flags.
  *
- *  src_str
- *   The starting address of the source string.
+ * utimer
+ *  User-provided initialized instance of a UTIMER.
  *
- *  n
- *   The maximum length of the destination string, including a space for the
- *   NULL terminator. This cannot be zero.
+ * connections
+ *  User-provided array of connections.
  *
- * RETURNS:
- *  The number of bytes written, including the NULL terminator.
+ * connection_count
+ *  Number of connections in the array, i.e. the maximum number of
+ *  simultaneously open connections.
  *
- ******************************************************************************/
-
-uint32_t UTILITIES_strncpy(char* dest_str, char* src_str, uint32_t n);
-
-/*******************************************************************************
+ * routes
+ *  User-provided route table. Must remain valid while the module is used.
  *
- * UTILITIES_strncmp
+ * route_count
+ *  Number of routes in the table.
  *
- * DESCRIPTION:
- *  Lite alternative for strncmp in the string library.
+ * idle_timeout_us
+ *  Time, in microseconds, after which a connection without any progress is
+ *  closed.
  *
- * PARAMETERS:
- *  a_str
- *   The starting address of string a.
+ * asset_resolver / asset_resolver_context
+ *  Optional lookup for paths not in the route table, see
+ *  WEBSERVER_set_asset_resolver.
  *
- *  b_addr
- *   The starting address of string b.
+ * request_count
+ *  Number of requests answered.
  *
- *  length
- *   The maximum number of characters to compare in the case that a NULL-
- *   terminator is not detected in either string first.
+ * error_count
+ *  Number of malformed or oversized requests, and connections closed because
+ *  of a socket error or timeout.
  *
- * RETURN:
- *  0 if the strings are equal, -1 if string a is less than string b, and 1 if
- *  string a is greater than string b.
+ * *_hal_*
+ *  User-provided functions. See typedef comments.
  *
  ******************************************************************************/
 
-int8_t UTILITIES_strncmp(char* a_str, char* b_str, uint32_t length);
+typedef struct
+{
+  WEBSERVER_flags_t flags;
+  UTIMER_instance_t* utimer;
+  WEBSERVER_connection_t* connections;
+  uint8_t connection_count;
+  const WEBSERVER_route_t* routes;
+  uint16_t route_count;
+  uint32_t idle_timeout_us;
+  WEBSERVER_asset_resolver_t asset_resolver;
+  const void* asset_resolver_context;
+  uint32_t request_count;
+  uint32_t error_count;
+  WEBSERVER_hal_accept_t accept;
+  WEBSERVER_hal_recv_t recv;
+  WEBSERVER_hal_send_t send;
+  WEBSERVER_hal_close_t close;
+}
+WEBSERVER_instance_t;
 
 /*******************************************************************************
  *
- * UTILITIES_absolute_value
+ * WEBSERVER_initialize
  *
  * DESCRIPTION:
- *  Calculates the absolute value of an input integer up to 63-bits with the
- *  MSB sign (0x7FFFFFFFFFFFFFFF = 9223372036854775807).
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
  *
  * PARAMETERS:
- *  value
- *   The value which is passed through the absolute value algorithm.
- *
- * RETURN:
- *  The absolute value of value.
+ *  See WEBSERVER_instance_t.
  *
  ******************************************************************************/
 
-uint64_t UTILITIES_absolute_value(int64_t value);
+void WEBSERVER_initialize(WEBSERVER_instance_t* instance,
+                          UTIMER_instance_t* utimer,
+                          WEBSERVER_connection_t* connections,
+                          uint8_t connection_count,
+                          const WEBSERVER_route_t* routes,
+                          uint16_t route_count,
+                          uint32_t idle_timeout_us,
+                          WEBSERVER_hal_accept_t accept,
+                          WEBSERVER_hal_recv_t recv,
+                          WEBSERVER_hal_send_t send,
+                          WEBSERVER_hal_close_t close);
 
 /*******************************************************************************
  *
- * UTILITIES_swap_byte_order
+ * WEBSERVER_set_asset_resolver
  *
  * DESCRIPTION:
- *  Swaps the byte order of an array of bytes. The array could represent
- *  anything from a 2-byte integer to an array of N elements.
+ *  Sets the function which looks up assets for GET and HEAD requests whose
+ *  path is not in the route table. Set to NULL to answer such requests with
+ *  404.
  *
  * PARAMETERS:
- *  byte_ary
- *   Pointer to the byte array which will be byte order swapped.
- *
- *  length
- *   Length of the passed in array in bytes.
+ *  See WEBSERVER_instance_t.
  *
  ******************************************************************************/
 
-void UTILITIES_swap_byte_order(uint8_t* byte_ary, uint32_t length);
+void WEBSERVER_set_asset_resolver(WEBSERVER_instance_t* instance,
+                                  WEBSERVER_asset_resolver_t asset_resolver,
+                                  const void* asset_resolver_context);
 
 /*******************************************************************************
  *
- * UTILITIES_is_ascii_numeric
+ * WEBSERVER_service
  *
  * DESCRIPTION:
- *  Determines if the provided character is a numeric ASCII value '0' - '9'.
- *
- * PARAMETERS:
- *  value
- *   The ASCII character to evaluate.
+ *  Accepts new connections while there are free connection slots, receives
+ *  and answers requests, and sends pending response data. Each connection is
+ *  given a bounded amount of work per call.
  *
  * RETURN:
- *  True if the character is ASCII numeric, else, false.
+ *  False while a request is partially received or a response is being sent,
+ *  else, true.
  *
  ******************************************************************************/
 
-bool UTILITIES_is_ascii_numeric(char value);
+bool WEBSERVER_service(WEBSERVER_instance_t* instance);
 
 /*******************************************************************************
  *
- * UTILITIES_is_ascii_alpha_lower
+ * WEBSERVER_response_append
  *
  * DESCRIPTION:
- *  Determines if the provided character is a lower-case ASCII letter value
- *  'a' - 'z'.
- *
- * PARAMETERS:
- *  value
- *   The ASCII character to evaluate.
+ *  Appends a NUL-terminated string to a handler response body.
  *
  * RETURN:
- *  True if the character is ASCII lower-case letter, else, false.
+ *  True if the string was appended, else, false if it did not fit, in which
+ *  case nothing is appended.
  *
  ******************************************************************************/
 
-bool UTILITIES_is_ascii_alpha_lower(char value);
+bool WEBSERVER_response_append(WEBSERVER_response_t* response, const char* text);
 
 /*******************************************************************************
  *
- * UTILITIES_is_ascii_alpha_upper
+ * WEBSERVER_request_header
  *
  * DESCRIPTION:
- *  Determines if the provided character is a upper-case ASCII letter value
- *  'A' - 'Z'.
+ *  Looks up a request header field which is not parsed by the module.
  *
  * PARAMETERS:
- *  value
- *   The ASCII character to evaluate.
+ *  lower_name
+ *   Field name in lower case. Field names are matched ignoring case.
  *
  * RETURN:
- *  True if the character is ASCII upper-case letter, else, false.
+ *  NUL-terminated field value, without the white space around it, else,
+ *  NULL if the request has no such field.
  *
  ******************************************************************************/
 
-bool UTILITIES_is_ascii_alpha_upper(char value);
+char* WEBSERVER_request_header(const WEBSERVER_request_t* request, const char* lower_name);
 
 /*******************************************************************************
  *
- * UTILITIES_is_ascii_alpha_numeric
+ * WEBSERVER_response_append_integer
  *
  * DESCRIPTION:
- *  Determines if the provided character is an ASCII letter, upper or lower, or
- *  if it is a ASCII numeric value.
- *
- * PARAMETERS:
- *  value
- *   The ASCII character to evaluate.
+ *  Appends the decimal representation of a signed integer to a handler
+ *  response body.
  *
  * RETURN:
- *  True if the character is ASCII letter or numeric, else, false.
+ *  True if the value was appended, else, false if it did not fit, in which
+ *  case nothing is appended.
  *
  ******************************************************************************/
 
-bool UTILITIES_is_ascii_alpha_numeric(char value);
+bool WEBSERVER_response_append_integer(WEBSERVER_response_t* response, int32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // WEBSERVER_J_H
 
 /*******************************************************************************
  *
- * UTILITIES_is_ascii_hex_numeric
+ *  WebSocket live telemetry channel for the WEB user interface. Requires
+ *  proper initialization and the service routine to be called repeatedly.
  *
- * DESCRIPTION:
- *  Determines if the provided character is a valid hex-decimal ASCII character,
- *  upper or lower case for letters A through F.
+ *  A WEBSERVER upgrade route hands a WebSocket connection over to the module,
+ *  which then pushes the values of a list of TERVAR entries to the client in
+ *  a single binary frame per period, and applies writes sent back by the
+ *  client. Only one client is served at a time.
  *
- * PARAMETERS:
- *  value
- *   The ASCII character to evaluate.
+ *  All messages are binary frames with a little-endian payload, starting
+ *  with a WEBTELEMETRY_message_t byte:
  *
- * RETURN:
- *  True if the character is a valid ASCII hex-decimal value, else, false.
+ *  DESCRIBE (server, once after connecting)
+ *   u8 type, u8 entry count, then per entry: u8 TERVAR_var_flags_t,
+ *   u8 description length, description.
+ *
+ *  UPDATE (server, every period)
+ *   u8 type, u8 entry count, u16 sequence, u32 timestamp in microseconds
+ *   since connecting, then per entry: 4 byte value. Integers are sign- or
+ *   zero-extended to 32 bits and floats are sent as their IEEE-754 bits.
+ *
+ *  WRITE (client)
+ *   u8 type, u8 entry index, u16 reserved, 4 byte value as above.
+ *
+ *  Updates always carry the latest values. If the previous update has not
+ *  yet been taken by the transport when a period elapses, the update is
+ *  skipped rather than queued.
  *
  ******************************************************************************/
 
-bool UTILITIES_is_ascii_hex_numeric(char value);
+#ifndef WEBTELEMETRY_J_H
+#define WEBTELEMETRY_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Size of the transmit buffer, which must hold the handshake response and the
+ * DESCRIBE message of the entry list, else, the upgrade is refused. Can be
+ * overridden in the project build properties.
+ */
+
+#ifndef WEBTELEMETRY_TX_BUFFER_LENGTH
+#define WEBTELEMETRY_TX_BUFFER_LENGTH     1024U
+#endif
+
+/*
+ * Size of the receive buffer. Client frames larger than the buffer close the
+ * connection.
+ */
+
+#define WEBTELEMETRY_RX_BUFFER_LENGTH     160U
 
 /*******************************************************************************
  *
- * UTILITIES_is_ascii_binary_numeric
+ * WEBTELEMETRY_message_t
  *
  * DESCRIPTION:
- *  Determines if the provided character is a valid binary ASCII character,
- *  either a '1' or a '0'.
+ *  Message types. See the module description for the message layouts.
  *
- * PARAMETERS:
- *  value
- *   The ASCII character to evaluate.
+ ******************************************************************************/
+
+typedef enum
+{
+  WEBTELEMETRY_MESSAGE_DESCRIBE           = 0,
+  WEBTELEMETRY_MESSAGE_UPDATE,
+  WEBTELEMETRY_MESSAGE_WRITE
+}
+WEBTELEMETRY_message_t;
+
+/*******************************************************************************
  *
- * RETURN:
- *  True if the character is a valid ASCII binary value, else, false.
+ * WEBTELEMETRY_flags_t
+ *
+ * DESCRIPTION:
+ *  Module flags.
+ *
+ * connected
+ *  Set while a client is connected.
+ *
+ * closing
+ *  Set once the connection is to be closed after the transmit buffer has
+ *  been sent.
+ *
+ * write_pending
+ *  Set while the write handler of a written entry has not completed.
+ *
+ * read_pending
+ *  Set while the read handlers for the next update have not all completed.
  *
  ******************************************************************************/
 
-bool UTILITIES_is_ascii_binary_numeric(char value);
+typedef union
+{
+  uint8_t all;
+  struct
+  {
+    uint8_t connected                     : 1;
+    uint8_t closing                       : 1;
+    uint8_t write_pending                 : 1;
+    uint8_t read_pending                  : 1;
+    uint8_t reserved4                     : 4;
+  };
+}
+WEBTELEMETRY_flags_t;
 
 /*******************************************************************************
  *
- * UTILITIES_parse_integer
+ * WEBTELEMETRY_instance_t
  *
  * DESCRIPTION:
- *  Parses an integer, up to a signed 64-bit value, from a provided character
- *  string. The parse function supports decimal, hex-decimal, and binary input.
- *  Hex-decimal should be preceeded with 0x or 0X, and binary with a 0b or 0B.
- *  Non-applicable characters before or after the first detected numerical
- *  value or negative sign '-' will be ignored. In a string containing two
- *  integers separated by junk characters, only the first integer will be
- *  parsed.
+ *  Instance data and function pointers.
  *
- * PARAMETERS:
- *  input
- *   Character string which contains the integer value in ASCII format. User
- *   may specify hex-decimal input by preceding the value with a 0x or 0X and
- *   binary input with 0b or 0B. The negative sign '-' will also be considered
- *   part of the valid integer string if found.
+ * flags
+ *  Module flags.
  *
- *  length
- *   Length, in bytes, of the input buffer. The input string will be evaluated
- *   until a NULL-terminator is detected or until this length is met.
+ * socket
+ *  Socket handle of the connected client, -1 if none.
  *
- * RETURN:
- *  The parsed integer value. The user can cast the result into the appropriate
- *  data type.
+ * utimer
+ *  User-provided initialized instance of a UTIMER.
+ *
+ * period_ticket
+ *  Expires when the next update is due.
+ *
+ * epoch_ticket
+ *  Created on connection, serves as the update timestamp epoch.
+ *
+ * period_us
+ *  Time, in microseconds, between updates. A value of 0 sends an update on
+ *  every service call in which the transport can take one.
+ *
+ * entries
+ *  User-provided list of entries to send. The read and write handlers are
+ *  called as in TERVAR, i.e. again on the following service calls until they
+ *  return true. An update is sampled once all read handlers have completed.
+ *
+ * entry_count
+ *  Number of entries in the list.
+ *
+ * write_index
+ *  Index of the entry with a pending write.
+ *
+ * read_index
+ *  Index of the entry whose read handler is to be called next.
+ *
+ * sequence
+ *  Sequence number of the next update.
+ *
+ * update_count
+ *  Number of updates sent.
+ *
+ * skipped_count
+ *  Number of updates skipped because the transport was busy.
+ *
+ * tx_length / tx_offset
+ *  Number of bytes in the transmit buffer and number of those already sent.
+ *
+ * rx_length
+ *  Number of bytes in the receive buffer.
+ *
+ * *_hal_*
+ *  User-provided functions. See the WEBSERVER typedef comments.
  *
  ******************************************************************************/
 
-int64_t UTILITIES_parse_integer(char* input, uint8_t length);
+typedef struct
+{
+  WEBTELEMETRY_flags_t flags;
+  int32_t socket;
+  UTIMER_instance_t* utimer;
+  UTIMER_ticket_t period_ticket;
+  UTIMER_ticket_t epoch_ticket;
+  uint32_t period_us;
+  TERVAR_entry_t* entries;
+  uint8_t entry_count;
+  uint8_t write_index;
+  uint8_t read_index;
+  uint16_t sequence;
+  uint32_t update_count;
+  uint32_t skipped_count;
+  uint16_t tx_length;
+  uint16_t tx_offset;
+  uint16_t rx_length;
+  WEBSERVER_hal_recv_t recv;
+  WEBSERVER_hal_send_t send;
+  WEBSERVER_hal_close_t close;
+  uint8_t tx_buffer[WEBTELEMETRY_TX_BUFFER_LENGTH];
+  uint8_t rx_buffer[WEBTELEMETRY_RX_BUFFER_LENGTH];
+}
+WEBTELEMETRY_instance_t;
 
 /*******************************************************************************
  *
- * UTILITIES_crc16
+ * WEBTELEMETRY_initialize
  *
  * DESCRIPTION:
- *  Calculates the CRC16 (IBM version) of a provided buffer. The initial CRC
- *  is taken as the first parameter so that large buffers can be split up and
- *  sent through this function in chunks. For the first call, the user should
- *  start with a CRC value of 0.
+ *  Initializes a module instance, erasing all data structures and setting
+ *  default values.
  *
  * PARAMETERS:
- *  crc
- *   The CRC-seed (0) or on-going CRC value if this function is called multiple
- *   times for a large buffer split into smaller parts.
+ *  See WEBTELEMETRY_instance_t.
+ *
+ ******************************************************************************/
+
+void WEBTELEMETRY_initialize(WEBTELEMETRY_instance_t* instance,
+                             UTIMER_instance_t* utimer,
+                             TERVAR_entry_t* entries,
+                             uint8_t entry_count,
+                             uint32_t period_us,
+                             WEBSERVER_hal_recv_t recv,
+                             WEBSERVER_hal_send_t send,
+                             WEBSERVER_hal_close_t close);
+
+/*******************************************************************************
  *
- *  buffer
- *   Data buffer to send through the CRC algorithm.
+ * WEBTELEMETRY_upgrade
  *
- *  length
- *   Length, in bytes, of the buffer.
+ * DESCRIPTION:
+ *  Validates a WebSocket handshake request and takes over its socket. Meant
+ *  to be called from a WEBSERVER_upgrade_handler_t, e.g.
+ *
+ *   static uint16_t telemetry_upgrade(uint32_t context,
+ *                                     int32_t socket,
+ *                                     const WEBSERVER_request_t* request)
+ *   {
+ *     return WEBTELEMETRY_upgrade(&telemetry, socket, request);
+ *   }
  *
  * RETURN:
- *  Calculated CRC-16 value.
+ *  101 if the connection was taken over, 503 if a client is already
+ *  connected, 500 if the DESCRIBE message of the entry list does not fit in
+ *  WEBTELEMETRY_TX_BUFFER_LENGTH together with the handshake response, else,
+ *  400 for an invalid handshake.
  *
  ******************************************************************************/
 
-uint16_t UTILITIES_crc16(uint16_t crc, void* buffer, uint32_t length);
+uint16_t WEBTELEMETRY_upgrade(WEBTELEMETRY_instance_t* instance,
+                              int32_t socket,
+                              const WEBSERVER_request_t* request);
 
 /*******************************************************************************
  *
- * UTILITIES_cidr_to_netmask
+ * WEBTELEMETRY_service
  *
  * DESCRIPTION:
- *  Converts the cidr (Classlesss Inter-Domain Routing) into the equivalent 32-
- *  bit netmask.
- *
- * PARAMETERS:
- *  cidr
- *   Classlesss Inter-Domain Routing is shorthand for the subnet mask which
- *   is represented by /n where n can be 0-31 (the LSB must not be used for
- *   the subnet (i.e. /32) since at least one address is needed for the IP).
+ *  Applies received writes, answers control frames, sends the update when
+ *  due, and sends pending transmit data.
  *
  * RETURN:
- *  32-bit subnet mask.
+ *  False while transmit data, a write or a read is pending, else, true.
  *
  ******************************************************************************/
 
-uint32_t UTILITIES_cidr_to_netmask(uint8_t cidr);
+bool WEBTELEMETRY_service(WEBTELEMETRY_instance_t* instance);
 
 /*******************************************************************************
  *
- * UTILITIES_dummy_*
+ * WEBTELEMETRY_is_connected
  *
  * DESCRIPTION:
- *  Collection of dummy functions. These functions are assigned to function
- *  pointers which the user had the option to populate but did not. The use of
- *  dummy functions takes the place of repetitive NULL checks.
+ *  Checks if a client is connected.
  *
- *  The naming convention is _<returnType>_<argType0>_<argType1>_ ...
+ * RETURN:
+ *  True if a client is connected, else, false.
  *
  ******************************************************************************/
 
-void UTILITIES_dummy_void_void(void);
-void UTILITIES_dummy_void_bool(bool b);
-bool UTILITIES_dummy_false_void(void);
-bool UTILITIES_dummy_true_void(void);
-bool UTILITIES_dummy_true_bool(bool b);
-bool UTILITIES_dummy_false_voidp_u32(void* voidp, uint32_t u32) ;
-uint32_t UTILITIES_dummy_u32_void(void);
-void UTILITIES_dummy_void_u32(uint32_t u32);
-
-#ifdef __cplusplus
-}
-#endif
-#endif // UTILITIES_J_H
+bool WEBTELEMETRY_is_connected(WEBTELEMETRY_instance_t* instance);
 
 /*******************************************************************************
  *
- *  Website base templates, libraries, and other utilities.
+ * WEBTELEMETRY_disconnect
+ *
+ * DESCRIPTION:
+ *  Sends a close frame and closes the connection once it has been sent.
  *
  ******************************************************************************/
 
-#ifndef WEB_J_H
-#define WEB_J_H
-
-// Support C++ builds.
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*
- * Bootstrap v5.3 JavaScript.
- */
-
-extern const uint8_t WEB_BOOTSTRAP_JS[];
-
-/*
- * Bootstrap v5.3 CSS.
- */
-
-extern const uint8_t WEB_BOOTSTRAP_CSS[];
+void WEBTELEMETRY_disconnect(WEBTELEMETRY_instance_t* instance);
 
 #ifdef __cplusplus
 }
 #endif
-#endif // WEB_J_H
+#endif // WEBTELEMETRY_J_H
 
 /*******************************************************************************
  *
@@ -13228,3 +19081,356 @@ bool WS2812_is_busy(WS2812_instance_t* instance);
 }
 #endif
 #endif // WS2812_J_H
+
+/*******************************************************************************
+ *
+ *  Optimized kernels for Cortex-M3/M4/M7 (armv7-m and armv7e-m) builds. The
+ *  library archives are built for the Cortex-M0 and do not use the word and
+ *  multiple load/store, unaligned access, or DSP instructions of the larger
+ *  cores. These kernels are drop-in replacements for the hot loops:
+ *   - KERNEL_memcpy and KERNEL_crc16 for UTILITIES_memcpy and UTILITIES_crc16.
+ *   - Canvas fills and filled rectangles of GFX2D, see KERNEL_gfx2d_bind.
+ *   - RGB565 span fills, copies, alpha blends, and color keyed blits.
+ *   - WS2812 GRB encoding, see KERNEL_ws2812_parse_grb_array.
+ *   - UTIMER ticket math, see KERNEL_utimer_ticket_create.
+ *
+ *  The kernels are plain C and are also correct on the Cortex-M0 and host
+ *  builds. Compile src/ with e.g. -mcpu=cortex-m4 -mthumb to use them. When
+ *  the DSP extension is available (__ARM_FEATURE_DSP, Cortex-M4/M7), the
+ *  color keyed blit compares and selects two pixels at once with USUB16 and
+ *  SEL.
+ *
+ *  The formats match the library: pixels are stored in the target byte order
+ *  as formatted by GFX2D_rgba_to_pixel_t, and WS2812 encoding uses the bit
+ *  codes of the instance.
+ *
+ *  Typical use:
+ *
+ *   GFX2D_initialize(&gfx, frame, sizeof(frame), 320, 240, 16, rgba_to_rgb565);
+ *   KERNEL_gfx2d_bind(&gfx);
+ *
+ ******************************************************************************/
+
+#ifndef KERNEL_J_H
+#define KERNEL_J_H
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ *
+ * KERNEL_memcpy
+ *
+ * DESCRIPTION:
+ *  Copies memory a word at a time. Same as UTILITIES_memcpy. When source and
+ *  destination have different alignment, words are only copied on cores with
+ *  unaligned access, else, bytes are copied.
+ *
+ * PARAMETERS:
+ *  dest_addr
+ *   The starting destination address.
+ *
+ *  src_addr
+ *   The starting source address of the memory to copy.
+ *
+ *  length
+ *   The number of bytes to copy.
+ *
+ ******************************************************************************/
+
+void KERNEL_memcpy(void* dest_addr, void* src_addr, uint32_t length);
+
+/*******************************************************************************
+ *
+ * KERNEL_crc16
+ *
+ * DESCRIPTION:
+ *  Calculates the CRC16 (IBM version) of a provided buffer, four bytes at a
+ *  time (slicing-by-4). Same as UTILITIES_crc16, the results can be mixed.
+ *
+ * PARAMETERS:
+ *  crc
+ *   The CRC-seed (0) or on-going CRC value if this function is called multiple
+ *   times for a large buffer split into smaller parts.
+ *
+ *  buffer
+ *   Data buffer to send through the CRC algorithm.
+ *
+ *  length
+ *   Length, in bytes, of the buffer.
+ *
+ * RETURN:
+ *  Calculated CRC-16 value.
+ *
+ * NOTES:
+ *  The lookup tables occupy 2 KB of flash.
+ *
+ ******************************************************************************/
+
+uint16_t KERNEL_crc16(uint16_t crc, void* buffer, uint32_t length);
+
+/*******************************************************************************
+ *
+ * KERNEL_fill16
+ *
+ * DESCRIPTION:
+ *  Fills a span of 16-bit pixels, two pixels per word store.
+ *
+ * PARAMETERS:
+ *  dest
+ *   Pointer to the first pixel. Must be 16-bit aligned.
+ *
+ *  pixel
+ *   Formatted pixel color.
+ *
+ *  count
+ *   The number of pixels to fill.
+ *
+ ******************************************************************************/
+
+void KERNEL_fill16(uint16_t* dest, uint16_t pixel, uint32_t count);
+
+/*******************************************************************************
+ *
+ * KERNEL_fill32
+ *
+ * DESCRIPTION:
+ *  Fills a span of 32-bit pixels.
+ *
+ * PARAMETERS:
+ *  dest
+ *   Pointer to the first pixel. Must be 32-bit aligned.
+ *
+ *  pixel
+ *   Formatted pixel color.
+ *
+ *  count
+ *   The number of pixels to fill.
+ *
+ ******************************************************************************/
+
+void KERNEL_fill32(uint32_t* dest, uint32_t pixel, uint32_t count);
+
+/*******************************************************************************
+ *
+ * KERNEL_copy_rect16
+ *
+ * DESCRIPTION:
+ *  Copies a rectangle of 16-bit pixels, e.g. a sprite or icon into a frame
+ *  buffer, or a frame buffer region into a DMA buffer.
+ *
+ * PARAMETERS:
+ *  dest
+ *   Pointer to the top left destination pixel.
+ *
+ *  dest_stride
+ *   The number of pixels between two destination rows.
+ *
+ *  src
+ *   Pointer to the top left source pixel.
+ *
+ *  src_stride
+ *   The number of pixels between two source rows.
+ *
+ *  width
+ *   Width of the rectangle in pixels.
+ *
+ *  height
+ *   Height of the rectangle in pixels.
+ *
+ ******************************************************************************/
+
+void KERNEL_copy_rect16(uint16_t* dest,
+                        uint32_t dest_stride,
+                        uint16_t* src,
+                        uint32_t src_stride,
+                        uint16_t width,
+                        uint16_t height);
+
+/*******************************************************************************
+ *
+ * KERNEL_blend_rgb565
+ *
+ * DESCRIPTION:
+ *  Alpha blends a span of RGB565 source pixels onto the destination pixels,
+ *  dest = (src * alpha + dest * (255 - alpha)) / 255, approximately. Two
+ *  pixels are blended per word with the channels in 16-bit lanes.
+ *
+ * PARAMETERS:
+ *  dest
+ *   Pointer to the first destination pixel.
+ *
+ *  src
+ *   Pointer to the first source pixel.
+ *
+ *  count
+ *   The number of pixels to blend.
+ *
+ *  alpha
+ *   Opacity of the source, 0 keeps the destination and 255 copies the
+ *   source.
+ *
+ * NOTES:
+ *  The pixels must be in the native byte order. Byte-swapped formats, e.g.
+ *  for the ILI9XXX, should be blended before swapping.
+ *
+ ******************************************************************************/
+
+void KERNEL_blend_rgb565(uint16_t* dest, uint16_t* src, uint32_t count, uint8_t alpha);
+
+/*******************************************************************************
+ *
+ * KERNEL_blit_keyed16
+ *
+ * DESCRIPTION:
+ *  Copies a span of 16-bit source pixels onto the destination pixels, except
+ *  for those which equal the color key, which are transparent.
+ *
+ * PARAMETERS:
+ *  dest
+ *   Pointer to the first destination pixel.
+ *
+ *  src
+ *   Pointer to the first source pixel.
+ *
+ *  count
+ *   The number of pixels to copy.
+ *
+ *  key
+ *   Formatted pixel color of the transparent source pixels.
+ *
+ ******************************************************************************/
+
+void KERNEL_blit_keyed16(uint16_t* dest, uint16_t* src, uint32_t count, uint16_t key);
+
+/*******************************************************************************
+ *
+ * KERNEL_gfx2d_bind
+ *
+ * DESCRIPTION:
+ *  Replaces the canvas fill and filled rectangle handlers of a GFX2D instance
+ *  with word store kernels, for 8, 16, and 32 bits per pixel. These handlers
+ *  are used by GFX2D_fill_canvas and all filled rectangles, e.g. panels and
+ *  buttons. The handlers of other formats are kept.
+ *
+ * PARAMETERS:
+ *  instance
+ *   Pointer to an initialized GFX2D instance.
+ *
+ * NOTES:
+ *  Must be called after GFX2D_initialize, which sets the default handlers.
+ *
+ ******************************************************************************/
+
+void KERNEL_gfx2d_bind(GFX2D_instance_t* instance);
+
+/*******************************************************************************
+ *
+ * KERNEL_ws2812_parse_grb_array
+ *
+ * DESCRIPTION:
+ *  Same as WS2812_parse_grb_array, with the SPI bit codes of a byte looked up
+ *  a nibble at a time. The unused remainder of the source buffer is cleared.
+ *
+ * PARAMETERS:
+ *  grb_array
+ *   Pointer to a user-provided byte-array, see WS2812_parse_grb_array.
+ *
+ *  grb_array_length
+ *   Total length of the array in bytes. This must be a value divisible by 3.
+ *
+ ******************************************************************************/
+
+void KERNEL_ws2812_parse_grb_array(WS2812_instance_t* instance,
+                                   uint8_t* grb_array,
+                                   uint32_t grb_array_length);
+
+/*******************************************************************************
+ *
+ * KERNEL_utimer_ticket_create
+ *
+ * DESCRIPTION:
+ *  Same as UTIMER_ticket_create, the tickets can be checked with
+ *  UTIMER_ticket_has_expired. The library calls the 64-bit multiply and
+ *  divide routines on every ticket, this kernel shifts instead when the
+ *  ticks per period are a power of two, and divides with a single 32-bit
+ *  division when the expiration fits in 32 bits.
+ *
+ * PARAMETERS:
+ *  See UTIMER_ticket_create.
+ *
+ ******************************************************************************/
+
+void KERNEL_utimer_ticket_create(UTIMER_instance_t* instance,
+                                 UTIMER_ticket_t* ticket,
+                                 uint64_t expiration_us);
+
+/*******************************************************************************
+ *
+ * KERNEL_utimer_ticket_elapsed_time
+ *
+ * DESCRIPTION:
+ *  Same as UTIMER_ticket_elapsed_time, dividing by the ticks per microsecond
+ *  as KERNEL_utimer_ticket_create divides by the ticks per period.
+ *
+ * RETURN:
+ *  Time elapsed since the ticket was created, in microseconds.
+ *
+ ******************************************************************************/
+
+uint64_t KERNEL_utimer_ticket_elapsed_time(UTIMER_instance_t* instance, UTIMER_ticket_t* ticket);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // KERNEL_J_H
+
+/*******************************************************************************
+ *
+ *  Compile-time HAL binding for the modules provided as source. By default,
+ *  each HAL hook is called through the function pointer stored in the
+ *  instance. A build can instead bind hooks to fixed functions, so that the
+ *  calls on interrupt and transfer paths are direct, and can be inlined, and
+ *  unneeded hooks compile to nothing.
+ *
+ *  To do so, define JLIB_HAL_BINDINGS as the name of a header, e.g.
+ *  -DJLIB_HAL_BINDINGS='"board_hal.h"', which defines the binding macros of
+ *  the hooks to bind. The header is included after all module declarations,
+ *  so it can define static inline HAL functions. A bound hook ignores the
+ *  function pointer given at initialization, hence, binding suits modules
+ *  with a single instance or instances which share the same hardware.
+ *
+ *  Example:
+ *
+ *   static inline void board_latch(bool level) { GPIOB->BSRR = ... }
+ *   #define SHIFTSIPO_REFRESH_HAL_SET_REGISTER_CLOCK(instance, level) board_latch(level)
+ *   #define SHIFTSIPO_REFRESH_HAL_SELECT_ROW(instance, row) ((void)0)
+ *
+ *  Binding macros:
+ *
+ *   BUSMUTEX_ATOMIC_HAL_ENTER_CRITICAL(instance)
+ *   BUSMUTEX_ATOMIC_HAL_EXIT_CRITICAL(instance)
+ *   DMAENGINE_HAL_START(channel, src_addr, src_length)
+ *   DMAENGINE_HAL_STOP(channel)
+ *   EXECUTOR_HAL_ENTER_CRITICAL(instance)
+ *   EXECUTOR_HAL_EXIT_CRITICAL(instance)
+ *   EXECUTOR_HAL_SLEEP(instance, sleep_us)
+ *   SHIFTSIPO_REFRESH_HAL_CONFIGURE_DMA(instance, src_addr, src_length)
+ *   SHIFTSIPO_REFRESH_HAL_START_TIMER(instance, period_us)
+ *   SHIFTSIPO_REFRESH_HAL_SET_REGISTER_CLOCK(instance, level)
+ *   SHIFTSIPO_REFRESH_HAL_SELECT_ROW(instance, row)
+ *   SHIFTSIPO_REFRESH_HAL_SET_OUTPUT_ENABLE(instance, enable)
+ *   SHIFTSIPO_REFRESH_HAL_IS_TX_COMPLETE(instance)
+ *
+ *  The modules provided only as library archives are compiled with function
+ *  pointer dispatch and are not affected.
+ *
+ ******************************************************************************/
+
+#if defined(JLIB_HAL_BINDINGS) && !defined(JLIB_HAL_BINDINGS_J_H)
+#define JLIB_HAL_BINDINGS_J_H
+#include JLIB_HAL_BINDINGS
+#endif // JLIB_HAL_BINDINGS
@@ -0,0 +1,163 @@
+/*******************************************************************************
+ *
+ *  Build configuration of the modules provided as source. Each module and
+ *  optional feature is compiled in when its macro is 1, the default, and
+ *  compiled out when it is 0, so that all of src/ can be built for every
+ *  product.
+ *
+ *  A product overrides the defaults in its own header, given to the build with
+ *  e.g. -DJLIB_CONFIG_FILE='"product_config.h"', which is included by JLib.h
+ *  ahead of this file:
+ *
+ *   #define JLIB_CONFIG_WEB_BOOTSTRAP          0
+ *   #define JLIB_CONFIG_BUSMUTEX_ARBITRATION   0
+ *
+ *  Sizes of a configuration are reported per module from the linker map with
+ *  tools/sizereport.py.
+ *
+ *  The modules provided only as library archives are not affected. Their
+ *  unused functions are removed when linking with --gc-sections.
+ *
+ *  Other build flags, which are not enabled by default:
+ *   UTILITIES_ASSERT_ON - asserts, see UTILITIES.
+ *   TRACE_ON            - trace points, see TRACE.
+ *   JLIB_HAL_BINDINGS   - compile-time HAL binding, see the end of JLib.h.
+ *
+ ******************************************************************************/
+
+#ifndef JLIB_CONFIG_J_H
+#define JLIB_CONFIG_J_H
+
+/*
+ * Input modules.
+ */
+
+#ifndef JLIB_CONFIG_BIBUTTON_MATCHER
+#define JLIB_CONFIG_BIBUTTON_MATCHER      1
+#endif
+
+#ifndef JLIB_CONFIG_ROTARYENCODER_QUADRATURE
+#define JLIB_CONFIG_ROTARYENCODER_QUADRATURE 1
+#endif
+
+#ifndef JLIB_CONFIG_INPUTEVENT
+#define JLIB_CONFIG_INPUTEVENT            1
+#endif
+
+/*
+ * Bus and transfer modules. BUSMUTEX_ARBITRATION covers the priorities and
+ * the hold and wait statistics of the atomic BUSMUTEX, see
+ * BUSMUTEX_atomic_configure_arbitration.
+ */
+
+#ifndef JLIB_CONFIG_BUSMUTEX_ATOMIC
+#define JLIB_CONFIG_BUSMUTEX_ATOMIC       1
+#endif
+
+#ifndef JLIB_CONFIG_BUSMUTEX_ARBITRATION
+#define JLIB_CONFIG_BUSMUTEX_ARBITRATION  1
+#endif
+
+#ifndef JLIB_CONFIG_DMAENGINE
+#define JLIB_CONFIG_DMAENGINE             1
+#endif
+
+/*
+ * Shift register modules.
+ */
+
+#ifndef JLIB_CONFIG_SHIFTPISO_PORT
+#define JLIB_CONFIG_SHIFTPISO_PORT        1
+#endif
+
+#ifndef JLIB_CONFIG_SHIFTPISO_MONITOR
+#define JLIB_CONFIG_SHIFTPISO_MONITOR     1
+#endif
+
+#ifndef JLIB_CONFIG_SHIFTSIPO_PORT
+#define JLIB_CONFIG_SHIFTSIPO_PORT        1
+#endif
+
+#ifndef JLIB_CONFIG_SHIFTSIPO_REFRESH
+#define JLIB_CONFIG_SHIFTSIPO_REFRESH     1
+#endif
+
+/*
+ * Scheduling and diagnostics modules. The EXECUTOR only supports
+ * EXECUTOR_set_stats with SERVICESTATS compiled in.
+ */
+
+#ifndef JLIB_CONFIG_EXECUTOR
+#define JLIB_CONFIG_EXECUTOR              1
+#endif
+
+#ifndef JLIB_CONFIG_SERVICESTATS
+#define JLIB_CONFIG_SERVICESTATS          1
+#endif
+
+#ifndef JLIB_CONFIG_TRACE
+#define JLIB_CONFIG_TRACE                 1
+#endif
+
+/*
+ * Graphics modules. GFX2DCLIP clips GFX2D calls to a stack of clip rectangles,
+ * GFX2DLIST records the GFX2D calls of a frame for replay into canvas
+ * segments, GFX2DUFONT draws UTF-8 text with sparse fonts. GFX2DLIST replays
+ * through GFX2DCLIP.
+ */
+
+#ifndef JLIB_CONFIG_GFX2DCLIP
+#define JLIB_CONFIG_GFX2DCLIP             1
+#endif
+
+#ifndef JLIB_CONFIG_GFX2DLIST
+#define JLIB_CONFIG_GFX2DLIST             1
+#endif
+
+#ifndef JLIB_CONFIG_GFX2DUFONT
+#define JLIB_CONFIG_GFX2DUFONT            1
+#endif
+
+/*
+ * Optimized kernels for Cortex-M3/M4/M7 builds, see KERNEL.
+ */
+
+#ifndef JLIB_CONFIG_KERNEL
+#define JLIB_CONFIG_KERNEL                1
+#endif
+
+/*
+ * WEB modules. WEB_BOOTSTRAP covers the full precompressed Bootstrap assets in
+ * src/WebCompressed.c, about 54 KB. Products serving a reduced Bootstrap
+ * generated with tools/webasset.py subset can compile them out.
+ */
+
+#ifndef JLIB_CONFIG_WEB_BOOTSTRAP
+#define JLIB_CONFIG_WEB_BOOTSTRAP         1
+#endif
+
+#ifndef JLIB_CONFIG_ROMFS
+#define JLIB_CONFIG_ROMFS                 1
+#endif
+
+#ifndef JLIB_CONFIG_WEBSERVER
+#define JLIB_CONFIG_WEBSERVER             1
+#endif
+
+#ifndef JLIB_CONFIG_WEBTELEMETRY
+#define JLIB_CONFIG_WEBTELEMETRY          1
+#endif
+
+#if JLIB_CONFIG_WEBTELEMETRY && !JLIB_CONFIG_WEBSERVER
+#error "JLIB_CONFIG_WEBTELEMETRY requires JLIB_CONFIG_WEBSERVER"
+#endif
+
+#if JLIB_CONFIG_GFX2DLIST && !JLIB_CONFIG_GFX2DCLIP
+#error "JLIB_CONFIG_GFX2DLIST requires JLIB_CONFIG_GFX2DCLIP"
+#endif
+
+#if defined (TRACE_ON) && !JLIB_CONFIG_TRACE
+#error "TRACE_ON requires JLIB_CONFIG_TRACE"
+#endif
+
+#endif // JLIB_CONFIG_J_H
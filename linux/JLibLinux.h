@@ -0,0 +1,487 @@
+#ifndef JLIB_LINUX_J_H
+#define JLIB_LINUX_J_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Display backends for running GFX2D user interfaces on embedded Linux, e.g.
+ *  gateways with a panel on /dev/fb0:
+ *
+ *   LINUX_display  Linux framebuffer device, or a POSIX shared memory buffer
+ *                  for headless boxes and external viewers.
+ *   LINUX_tiles    Renders a GFX2DLIST frame in tiles, replaying the display
+ *                  list per tile on a pool of threads, one GFX2D instance and
+ *                  tile buffer each.
+ *
+ *  Only the calls of the display list which touch a tile are replayed into
+ *  it, and a tile fits in the cache of its core, so frame rates scale with
+ *  the number of cores at 800x480 and above. tools/tilebench.c measures it.
+ *
+ *  Web servers on the same gateways, or on a workstation while developing
+ *  pages, run WEBSERVER and WEBTELEMETRY on:
+ *
+ *   LINUX_timer    UTIMER hardware counter on CLOCK_MONOTONIC.
+ *   LINUX_socket   Socket HALs for the connections of a TCP listening socket.
+ *
+ *  tools/webload.c exercises and loads them over the loopback interface.
+ *
+ *  Build with -pthread, and -lrt on older C libraries for shm_open.
+ *
+ ******************************************************************************/
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ *
+ *  Displays.
+ *
+ ******************************************************************************/
+
+/*
+ * Shared memory header magic ("JSHM") and format version.
+ */
+
+#define LINUX_SHM_MAGIC                   0x4D48534AUL
+#define LINUX_SHM_VERSION                 1U
+
+/*******************************************************************************
+ *
+ * LINUX_shm_header_t
+ *
+ * DESCRIPTION:
+ *  Header at the start of a shared memory display, followed by the pixels.
+ *
+ * magic, version
+ *  See LINUX_SHM_MAGIC and LINUX_SHM_VERSION.
+ *
+ * width, height, bits_per_pixel
+ *  Format of the pixels.
+ *
+ * stride
+ *  Bytes from one row of pixels to the next.
+ *
+ * frame_counter
+ *  Incremented, with release ordering, each time a frame is presented. A
+ *  viewer copies the pixels once the counter changes.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t bits_per_pixel;
+  uint16_t width;
+  uint16_t height;
+  uint32_t stride;
+  uint32_t frame_counter;
+}
+LINUX_shm_header_t;
+
+/*******************************************************************************
+ *
+ * LINUX_display_t
+ *
+ * DESCRIPTION:
+ *  An open display. Only to be allocated by the user.
+ *
+ * pixels
+ *  Mapped pixels of the display, row by row.
+ *
+ * stride
+ *  Bytes from one row of pixels to the next.
+ *
+ * width, height
+ *  Dimensions in pixels.
+ *
+ * bits_per_pixel
+ *  Pixel size. The GFX2D_rgba_to_pixel_t of the renderer must produce pixels
+ *  in the format of the display, e.g. RGB565 or XRGB8888.
+ *
+ * fd, map, map_length
+ *  Device or shared memory file and its mapping.
+ *
+ * shm_header
+ *  Header of a shared memory display, else, NULL.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint8_t* pixels;
+  uint32_t stride;
+  int16_t width;
+  int16_t height;
+  uint8_t bits_per_pixel;
+  int fd;
+  void* map;
+  size_t map_length;
+  LINUX_shm_header_t* shm_header;
+}
+LINUX_display_t;
+
+/*******************************************************************************
+ *
+ * LINUX_display_open_fbdev
+ *
+ * DESCRIPTION:
+ *  Opens and maps a framebuffer device, taking the format of its current
+ *  video mode.
+ *
+ * PARAMETERS:
+ *  path
+ *   Device, e.g. "/dev/fb0".
+ *
+ * RETURN:
+ *  True if the device was opened, else, false, with errno set.
+ *
+ ******************************************************************************/
+
+bool LINUX_display_open_fbdev(LINUX_display_t* display, const char* path);
+
+/*******************************************************************************
+ *
+ * LINUX_display_open_shm
+ *
+ * DESCRIPTION:
+ *  Creates, or opens, and maps a POSIX shared memory display.
+ *
+ * PARAMETERS:
+ *  name
+ *   Shared memory object name, e.g. "/jlib_display".
+ *
+ *  width, height, bits_per_pixel
+ *   Format of the display. Bits per pixel must be 8, 16, 24, or 32.
+ *
+ * RETURN:
+ *  True if the display was opened, else, false, with errno set.
+ *
+ ******************************************************************************/
+
+bool LINUX_display_open_shm(LINUX_display_t* display,
+                            const char* name,
+                            int16_t width,
+                            int16_t height,
+                            uint8_t bits_per_pixel);
+
+/*******************************************************************************
+ *
+ * LINUX_display_present
+ *
+ * DESCRIPTION:
+ *  Signals that a frame has been rendered. Publishes the frame counter of a
+ *  shared memory display; the framebuffer device shows the pixels as they are
+ *  written.
+ *
+ ******************************************************************************/
+
+void LINUX_display_present(LINUX_display_t* display);
+
+/*******************************************************************************
+ *
+ * LINUX_display_close
+ *
+ * DESCRIPTION:
+ *  Unmaps and closes a display. A shared memory object is kept for viewers,
+ *  and removed with shm_unlink by the application.
+ *
+ ******************************************************************************/
+
+void LINUX_display_close(LINUX_display_t* display);
+
+/*******************************************************************************
+ *
+ *  Tile renderer.
+ *
+ ******************************************************************************/
+
+#define LINUX_TILES_THREADS_MAX           16U
+
+/*******************************************************************************
+ *
+ * LINUX_tiles_worker_t
+ *
+ * DESCRIPTION:
+ *  Rendering thread state.
+ *
+ * gfx
+ *  GFX2D instance with the canvas set to the tile being rendered.
+ *
+ * buffer
+ *  Tile buffer of the GFX2D instance.
+ *
+ * thread
+ *  Thread, except for worker 0, which is the calling thread.
+ *
+ * tiles
+ *  Pointer to LINUX_tiles_t.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  GFX2D_instance_t gfx;
+  uint8_t* buffer;
+  pthread_t thread;
+  void* tiles;
+}
+LINUX_tiles_worker_t;
+
+/*******************************************************************************
+ *
+ * LINUX_tiles_t
+ *
+ * DESCRIPTION:
+ *  Renderer state. Only to be allocated by the user.
+ *
+ * workers, thread_count
+ *  Rendering threads, including the calling thread.
+ *
+ * tile_width, tile_height
+ *  Tile dimensions in pixels.
+ *
+ * columns, tile_count
+ *  Tiles per row and in total.
+ *
+ * list, display
+ *  Frame being rendered.
+ *
+ * lock, start, done
+ *  Frame hand-over between the calling thread and the workers.
+ *
+ * generation
+ *  Incremented for each frame.
+ *
+ * next_tile
+ *  Next tile to render, claimed atomically.
+ *
+ * busy_workers
+ *  Threads still rendering the frame.
+ *
+ * stop
+ *  Set to end the threads.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  LINUX_tiles_worker_t workers[LINUX_TILES_THREADS_MAX];
+  uint8_t thread_count;
+  int16_t tile_width;
+  int16_t tile_height;
+  uint32_t columns;
+  uint32_t tile_count;
+  GFX2DLIST_instance_t* list;
+  LINUX_display_t* display;
+  pthread_mutex_t lock;
+  pthread_cond_t start;
+  pthread_cond_t done;
+  uint32_t generation;
+  uint32_t next_tile;
+  uint8_t busy_workers;
+  bool stop;
+}
+LINUX_tiles_t;
+
+/*******************************************************************************
+ *
+ * LINUX_tiles_initialize
+ *
+ * DESCRIPTION:
+ *  Allocates the tile buffers and starts the threads of a renderer for a
+ *  display.
+ *
+ * PARAMETERS:
+ *  display
+ *   Open display which the frames are rendered into.
+ *
+ *  thread_count
+ *   Number of rendering threads, 1 to LINUX_TILES_THREADS_MAX, typically the
+ *   number of cores. With 1, frames are rendered by the calling thread only.
+ *
+ *  tile_width, tile_height
+ *   Tile dimensions, e.g. 128x64. Smaller tiles balance better between
+ *   threads and cull more calls, larger tiles replay the list less often.
+ *
+ *  rgba_to_pixel
+ *   See GFX2D_rgba_to_pixel_t.
+ *
+ * RETURN:
+ *  True if the renderer was started, else, false.
+ *
+ ******************************************************************************/
+
+bool LINUX_tiles_initialize(LINUX_tiles_t* tiles,
+                            LINUX_display_t* display,
+                            uint8_t thread_count,
+                            int16_t tile_width,
+                            int16_t tile_height,
+                            GFX2D_rgba_to_pixel_t rgba_to_pixel);
+
+/*******************************************************************************
+ *
+ * LINUX_tiles_render
+ *
+ * DESCRIPTION:
+ *  Renders a recorded frame into the display, returning once all tiles are
+ *  written. Tiles are cleared to 0 first unless the list starts with
+ *  GFX2DLIST_fill_canvas. The display is not presented.
+ *
+ ******************************************************************************/
+
+void LINUX_tiles_render(LINUX_tiles_t* tiles, GFX2DLIST_instance_t* list);
+
+/*******************************************************************************
+ *
+ * LINUX_tiles_deinitialize
+ *
+ * DESCRIPTION:
+ *  Stops the threads and frees the tile buffers.
+ *
+ ******************************************************************************/
+
+void LINUX_tiles_deinitialize(LINUX_tiles_t* tiles);
+
+/*******************************************************************************
+ *
+ *  Clock.
+ *
+ ******************************************************************************/
+
+/*
+ * One tick per nanosecond of CLOCK_MONOTONIC, with the same period as the
+ * virtual timer of sim/.
+ */
+
+#define LINUX_TIMER_TICKS_PER_MICROSECOND 1000ULL
+#define LINUX_TIMER_TICKS_PER_PERIOD      0x40000000ULL
+
+/*******************************************************************************
+ *
+ * LINUX_timer_initialize
+ *
+ * DESCRIPTION:
+ *  Initializes a UTIMER instance to run on CLOCK_MONOTONIC. Only one
+ *  instance is supported.
+ *
+ ******************************************************************************/
+
+void LINUX_timer_initialize(UTIMER_instance_t* utimer);
+
+/*******************************************************************************
+ *
+ * LINUX_timer_get_hardware_counter
+ *
+ * DESCRIPTION:
+ *  UTIMER_hal_get_hardware_counter_t backend. Periods which have passed since
+ *  the previous read are reported to UTIMER_period_isr_handler first, as the
+ *  period interrupt would have.
+ *
+ ******************************************************************************/
+
+uint64_t LINUX_timer_get_hardware_counter(void);
+
+/*******************************************************************************
+ *
+ *  Sockets.
+ *
+ ******************************************************************************/
+
+/*
+ * Maximum number of connections open at once, listed for LINUX_socket_wait.
+ */
+
+#define LINUX_SOCKET_CONNECTIONS_MAX      64U
+
+/*******************************************************************************
+ *
+ * LINUX_socket_listen
+ *
+ * DESCRIPTION:
+ *  Opens the non-blocking TCP listening socket whose connections the HAL
+ *  functions below serve to WEBSERVER and WEBTELEMETRY. Only one listening
+ *  socket is supported.
+ *
+ * PARAMETERS:
+ *  address
+ *   IPv4 address to bind to, NULL for the loopback address 127.0.0.1.
+ *
+ *  port
+ *   Port to bind to, 0 for any free port (see LINUX_socket_port).
+ *
+ * RETURN:
+ *  True if listening, else, false, with errno set.
+ *
+ ******************************************************************************/
+
+bool LINUX_socket_listen(const char* address, uint16_t port);
+
+/*******************************************************************************
+ *
+ * LINUX_socket_port
+ *
+ * DESCRIPTION:
+ *  Gets the port of the listening socket.
+ *
+ ******************************************************************************/
+
+uint16_t LINUX_socket_port(void);
+
+/*******************************************************************************
+ *
+ * LINUX_socket_accept, LINUX_socket_recv, LINUX_socket_send,
+ * LINUX_socket_close
+ *
+ * DESCRIPTION:
+ *  WEBSERVER_hal_accept_t, WEBSERVER_hal_recv_t, WEBSERVER_hal_send_t and
+ *  WEBSERVER_hal_close_t backends. Accepted sockets are non-blocking, with
+ *  Nagle's algorithm disabled, and connections beyond
+ *  LINUX_SOCKET_CONNECTIONS_MAX are left in the listen backlog.
+ *
+ ******************************************************************************/
+
+int32_t LINUX_socket_accept(void);
+int32_t LINUX_socket_recv(int32_t socket, uint8_t* buffer, uint32_t length);
+int32_t LINUX_socket_send(int32_t socket, const uint8_t* data, uint32_t length);
+void LINUX_socket_close(int32_t socket);
+
+/*******************************************************************************
+ *
+ * LINUX_socket_wait
+ *
+ * DESCRIPTION:
+ *  Blocks until a connection is pending or data is received on an open
+ *  connection, or a timeout. Called in place of a sleep when the service
+ *  routines are idle.
+ *
+ * PARAMETERS:
+ *  timeout_us
+ *   Maximum time to block, in microseconds.
+ *
+ ******************************************************************************/
+
+void LINUX_socket_wait(uint32_t timeout_us);
+
+/*******************************************************************************
+ *
+ * LINUX_socket_shutdown
+ *
+ * DESCRIPTION:
+ *  Closes the listening socket and all open connections.
+ *
+ ******************************************************************************/
+
+void LINUX_socket_shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // JLIB_LINUX_J_H
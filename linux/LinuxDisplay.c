@@ -0,0 +1,152 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/fb.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "JLibLinux.h"
+
+/*******************************************************************************
+ *
+ *  Framebuffer device and shared memory displays.
+ *
+ ******************************************************************************/
+
+static void LINUX_display_reset(LINUX_display_t* display)
+{
+  UTILITIES_memclear(display, sizeof(LINUX_display_t));
+  display->fd = -1;
+}
+
+bool LINUX_display_open_fbdev(LINUX_display_t* display, const char* path)
+{
+  struct fb_var_screeninfo variable;
+  struct fb_fix_screeninfo fixed;
+
+  LINUX_display_reset(display);
+
+  display->fd = open(path, O_RDWR | O_CLOEXEC);
+
+  if (display->fd < 0)
+  {
+    return false;
+  }
+
+  if ((ioctl(display->fd, FBIOGET_VSCREENINFO, &variable) < 0) ||
+      (ioctl(display->fd, FBIOGET_FSCREENINFO, &fixed) < 0))
+  {
+    LINUX_display_close(display);
+    return false;
+  }
+
+  if ((variable.xres > INT16_MAX) || (variable.yres > INT16_MAX) || ((variable.bits_per_pixel % 8) != 0))
+  {
+    LINUX_display_close(display);
+    errno = ENOTSUP;
+    return false;
+  }
+
+  display->map_length = fixed.smem_len;
+  display->map = mmap(NULL, display->map_length, PROT_READ | PROT_WRITE, MAP_SHARED, display->fd, 0);
+
+  if (display->map == MAP_FAILED)
+  {
+    display->map = NULL;
+    LINUX_display_close(display);
+    return false;
+  }
+
+  // The visible frame starts at the panning offset of the virtual screen.
+
+  display->stride = fixed.line_length;
+  display->width = (int16_t)variable.xres;
+  display->height = (int16_t)variable.yres;
+  display->bits_per_pixel = (uint8_t)variable.bits_per_pixel;
+  display->pixels = (uint8_t*)display->map +
+                    (size_t)variable.yoffset * fixed.line_length +
+                    (size_t)variable.xoffset * (variable.bits_per_pixel / 8U);
+
+  return true;
+}
+
+bool LINUX_display_open_shm(LINUX_display_t* display,
+                            const char* name,
+                            int16_t width,
+                            int16_t height,
+                            uint8_t bits_per_pixel)
+{
+  LINUX_display_reset(display);
+
+  if ((width < 1) || (height < 1) || (bits_per_pixel == 0) || (bits_per_pixel > 32) || ((bits_per_pixel % 8) != 0))
+  {
+    errno = EINVAL;
+    return false;
+  }
+
+  // Rows are padded to 32 bits, so that every row starts word aligned.
+
+  uint32_t stride = (((uint32_t)width * (bits_per_pixel / 8U)) + 3U) & ~3U;
+
+  display->map_length = sizeof(LINUX_shm_header_t) + (size_t)stride * (uint32_t)height;
+  display->fd = shm_open(name, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+  if (display->fd < 0)
+  {
+    return false;
+  }
+
+  if (ftruncate(display->fd, (off_t)display->map_length) < 0)
+  {
+    LINUX_display_close(display);
+    return false;
+  }
+
+  display->map = mmap(NULL, display->map_length, PROT_READ | PROT_WRITE, MAP_SHARED, display->fd, 0);
+
+  if (display->map == MAP_FAILED)
+  {
+    display->map = NULL;
+    LINUX_display_close(display);
+    return false;
+  }
+
+  display->shm_header = (LINUX_shm_header_t*)display->map;
+  display->shm_header->magic = LINUX_SHM_MAGIC;
+  display->shm_header->version = LINUX_SHM_VERSION;
+  display->shm_header->bits_per_pixel = bits_per_pixel;
+  display->shm_header->width = (uint16_t)width;
+  display->shm_header->height = (uint16_t)height;
+  display->shm_header->stride = stride;
+
+  display->stride = stride;
+  display->width = width;
+  display->height = height;
+  display->bits_per_pixel = bits_per_pixel;
+  display->pixels = (uint8_t*)display->map + sizeof(LINUX_shm_header_t);
+
+  return true;
+}
+
+void LINUX_display_present(LINUX_display_t* display)
+{
+  if (display->shm_header != NULL)
+  {
+    __atomic_fetch_add(&display->shm_header->frame_counter, 1U, __ATOMIC_RELEASE);
+  }
+}
+
+void LINUX_display_close(LINUX_display_t* display)
+{
+  if (display->map != NULL)
+  {
+    munmap(display->map, display->map_length);
+  }
+
+  if (display->fd >= 0)
+  {
+    close(display->fd);
+  }
+
+  LINUX_display_reset(display);
+}
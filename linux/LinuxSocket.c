@@ -0,0 +1,180 @@
+#define _GNU_SOURCE
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "JLibLinux.h"
+
+/*******************************************************************************
+ *
+ *  Socket HALs of a TCP listening socket.
+ *
+ ******************************************************************************/
+
+static struct
+{
+  int listen_fd;
+  uint16_t port;
+  uint8_t connection_count;
+  int connections[LINUX_SOCKET_CONNECTIONS_MAX];
+}
+LINUX_socket = {-1, 0, 0, {0}};
+
+bool LINUX_socket_listen(const char* address, uint16_t port)
+{
+  struct sockaddr_in bound;
+  socklen_t bound_length = sizeof(bound);
+  int enable = 1;
+
+  UTILITIES_memclear(&bound, sizeof(bound));
+  bound.sin_family = AF_INET;
+  bound.sin_port = htons(port);
+  bound.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  if ((address != NULL) && (inet_pton(AF_INET, address, &bound.sin_addr) != 1))
+  {
+    errno = EINVAL;
+    return false;
+  }
+
+  LINUX_socket_shutdown();
+
+  LINUX_socket.listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+  if (LINUX_socket.listen_fd < 0)
+  {
+    return false;
+  }
+
+  setsockopt(LINUX_socket.listen_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+  if ((bind(LINUX_socket.listen_fd, (struct sockaddr*)&bound, sizeof(bound)) < 0) ||
+      (listen(LINUX_socket.listen_fd, SOMAXCONN) < 0) ||
+      (getsockname(LINUX_socket.listen_fd, (struct sockaddr*)&bound, &bound_length) < 0))
+  {
+    int error = errno;
+
+    LINUX_socket_shutdown();
+    errno = error;
+    return false;
+  }
+
+  LINUX_socket.port = ntohs(bound.sin_port);
+  return true;
+}
+
+uint16_t LINUX_socket_port(void)
+{
+  return LINUX_socket.port;
+}
+
+int32_t LINUX_socket_accept(void)
+{
+  if ((LINUX_socket.listen_fd < 0) || (LINUX_socket.connection_count == LINUX_SOCKET_CONNECTIONS_MAX))
+  {
+    return -1;
+  }
+
+  int fd = accept4(LINUX_socket.listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+  if (fd < 0)
+  {
+    return -1;
+  }
+
+  // Responses are written in whole segments, so there is nothing for Nagle's
+  // algorithm to coalesce.
+
+  int enable = 1;
+
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+  LINUX_socket.connections[LINUX_socket.connection_count++] = fd;
+  return fd;
+}
+
+int32_t LINUX_socket_recv(int32_t socket, uint8_t* buffer, uint32_t length)
+{
+  ssize_t received = recv(socket, buffer, length, 0);
+
+  if (received > 0)
+  {
+    return (int32_t)received;
+  }
+
+  if ((received < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)))
+  {
+    return 0;
+  }
+
+  return -1;
+}
+
+int32_t LINUX_socket_send(int32_t socket, const uint8_t* data, uint32_t length)
+{
+  ssize_t sent = send(socket, data, length, MSG_NOSIGNAL);
+
+  if (sent >= 0)
+  {
+    return (int32_t)sent;
+  }
+
+  return ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) ? 0 : -1;
+}
+
+void LINUX_socket_close(int32_t socket)
+{
+  for (uint8_t i = 0; i < LINUX_socket.connection_count; i++)
+  {
+    if (LINUX_socket.connections[i] == socket)
+    {
+      LINUX_socket.connections[i] = LINUX_socket.connections[--LINUX_socket.connection_count];
+      break;
+    }
+  }
+
+  close(socket);
+}
+
+void LINUX_socket_wait(uint32_t timeout_us)
+{
+  struct pollfd fds[LINUX_SOCKET_CONNECTIONS_MAX + 1U];
+  nfds_t count = 0;
+
+  if (LINUX_socket.listen_fd >= 0)
+  {
+    fds[count].fd = LINUX_socket.listen_fd;
+    fds[count++].events = POLLIN;
+  }
+
+  for (uint8_t i = 0; i < LINUX_socket.connection_count; i++)
+  {
+    fds[count].fd = LINUX_socket.connections[i];
+    fds[count++].events = POLLIN;
+  }
+
+  struct timespec timeout = {(time_t)(timeout_us / 1000000U), (long)(timeout_us % 1000000U) * 1000L};
+
+  ppoll(fds, count, &timeout, NULL);
+}
+
+void LINUX_socket_shutdown(void)
+{
+  while (LINUX_socket.connection_count != 0)
+  {
+    LINUX_socket_close(LINUX_socket.connections[0]);
+  }
+
+  if (LINUX_socket.listen_fd >= 0)
+  {
+    close(LINUX_socket.listen_fd);
+  }
+
+  LINUX_socket.listen_fd = -1;
+  LINUX_socket.port = 0;
+}
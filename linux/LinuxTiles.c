@@ -0,0 +1,217 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "JLibLinux.h"
+
+/*******************************************************************************
+ *
+ *  Tile renderer.
+ *
+ ******************************************************************************/
+
+static void LINUX_tiles_render_tile(LINUX_tiles_worker_t* worker, uint32_t tile)
+{
+  LINUX_tiles_t* tiles = (LINUX_tiles_t*)worker->tiles;
+  LINUX_display_t* display = tiles->display;
+  GFX2DLIST_instance_t* list = tiles->list;
+  GFX2D_instance_t* gfx = &worker->gfx;
+  int16_t x0 = (int16_t)((tile % tiles->columns) * (uint32_t)tiles->tile_width);
+  int16_t y0 = (int16_t)((tile / tiles->columns) * (uint32_t)tiles->tile_height);
+  int16_t width = (int16_t)UTILS_MIN(tiles->tile_width, display->width - x0);
+  int16_t height = (int16_t)UTILS_MIN(tiles->tile_height, display->height - y0);
+
+  GFX2D_set_canvas_dimensions(gfx, x0, y0, width, height);
+
+  uint32_t row_length = (uint32_t)width * gfx->bytes_per_pixel;
+
+  if ((list->command_count == 0) || (list->commands[0].type != GFX2DLIST_COMMAND_FILL_CANVAS))
+  {
+    memset(worker->buffer, 0, row_length * (uint32_t)height);
+  }
+
+  GFX2DLIST_replay(list, gfx);
+
+  uint8_t* dest = display->pixels + (size_t)y0 * display->stride + (size_t)x0 * gfx->bytes_per_pixel;
+  uint8_t* src = worker->buffer;
+
+  for (int16_t row = 0; row < height; row++)
+  {
+    memcpy(dest, src, row_length);
+    dest += display->stride;
+    src += row_length;
+  }
+}
+
+static void LINUX_tiles_run(LINUX_tiles_worker_t* worker)
+{
+  LINUX_tiles_t* tiles = (LINUX_tiles_t*)worker->tiles;
+  uint32_t tile;
+
+  while ((tile = __atomic_fetch_add(&tiles->next_tile, 1U, __ATOMIC_RELAXED)) < tiles->tile_count)
+  {
+    LINUX_tiles_render_tile(worker, tile);
+  }
+}
+
+static void LINUX_tiles_finish(LINUX_tiles_t* tiles)
+{
+  if (--tiles->busy_workers == 0)
+  {
+    pthread_cond_signal(&tiles->done);
+  }
+}
+
+static void* LINUX_tiles_thread(void* argument)
+{
+  LINUX_tiles_worker_t* worker = (LINUX_tiles_worker_t*)argument;
+  LINUX_tiles_t* tiles = (LINUX_tiles_t*)worker->tiles;
+  uint32_t generation = 0;
+
+  pthread_mutex_lock(&tiles->lock);
+
+  while (true)
+  {
+    while (!tiles->stop && (tiles->generation == generation))
+    {
+      pthread_cond_wait(&tiles->start, &tiles->lock);
+    }
+
+    if (tiles->stop)
+    {
+      break;
+    }
+
+    generation = tiles->generation;
+    pthread_mutex_unlock(&tiles->lock);
+
+    LINUX_tiles_run(worker);
+
+    pthread_mutex_lock(&tiles->lock);
+    LINUX_tiles_finish(tiles);
+  }
+
+  pthread_mutex_unlock(&tiles->lock);
+
+  return NULL;
+}
+
+bool LINUX_tiles_initialize(LINUX_tiles_t* tiles,
+                            LINUX_display_t* display,
+                            uint8_t thread_count,
+                            int16_t tile_width,
+                            int16_t tile_height,
+                            GFX2D_rgba_to_pixel_t rgba_to_pixel)
+{
+  memset(tiles, 0, sizeof(LINUX_tiles_t));
+
+  if ((thread_count == 0) || (thread_count > LINUX_TILES_THREADS_MAX) ||
+      (tile_width < 1) || (tile_height < 1) ||
+      (display->width < 1) || (display->height < 1) ||
+      ((display->bits_per_pixel % 8) != 0))
+  {
+    return false;
+  }
+
+  tiles->display = display;
+  tiles->tile_width = (int16_t)UTILS_MIN(tile_width, display->width);
+  tiles->tile_height = (int16_t)UTILS_MIN(tile_height, display->height);
+  tiles->columns = ((uint32_t)display->width + tiles->tile_width - 1U) / tiles->tile_width;
+  tiles->tile_count = tiles->columns * (((uint32_t)display->height + tiles->tile_height - 1U) / tiles->tile_height);
+
+  pthread_mutex_init(&tiles->lock, NULL);
+  pthread_cond_init(&tiles->start, NULL);
+  pthread_cond_init(&tiles->done, NULL);
+
+  uint32_t buffer_length = (uint32_t)tiles->tile_width * (uint32_t)tiles->tile_height * (display->bits_per_pixel / 8U);
+
+  for (uint8_t i = 0; i < thread_count; i++)
+  {
+    LINUX_tiles_worker_t* worker = &tiles->workers[i];
+
+    worker->tiles = tiles;
+    worker->buffer = (uint8_t*)malloc(buffer_length);
+
+    if (worker->buffer == NULL)
+    {
+      LINUX_tiles_deinitialize(tiles);
+      return false;
+    }
+
+    GFX2D_initialize(&worker->gfx,
+                     worker->buffer,
+                     buffer_length,
+                     display->width,
+                     display->height,
+                     display->bits_per_pixel,
+                     rgba_to_pixel);
+
+#if JLIB_CONFIG_KERNEL
+    KERNEL_gfx2d_bind(&worker->gfx);
+#endif
+  }
+
+  // Worker 0 is the thread calling LINUX_tiles_render.
+
+  tiles->thread_count = 1;
+
+  for (uint8_t i = 1; i < thread_count; i++)
+  {
+    if (pthread_create(&tiles->workers[i].thread, NULL, LINUX_tiles_thread, &tiles->workers[i]) != 0)
+    {
+      LINUX_tiles_deinitialize(tiles);
+      return false;
+    }
+
+    tiles->thread_count++;
+  }
+
+  return true;
+}
+
+void LINUX_tiles_render(LINUX_tiles_t* tiles, GFX2DLIST_instance_t* list)
+{
+  pthread_mutex_lock(&tiles->lock);
+  tiles->list = list;
+  tiles->next_tile = 0;
+  tiles->busy_workers = tiles->thread_count;
+  tiles->generation++;
+  pthread_cond_broadcast(&tiles->start);
+  pthread_mutex_unlock(&tiles->lock);
+
+  LINUX_tiles_run(&tiles->workers[0]);
+
+  pthread_mutex_lock(&tiles->lock);
+  LINUX_tiles_finish(tiles);
+
+  while (tiles->busy_workers != 0)
+  {
+    pthread_cond_wait(&tiles->done, &tiles->lock);
+  }
+
+  pthread_mutex_unlock(&tiles->lock);
+}
+
+void LINUX_tiles_deinitialize(LINUX_tiles_t* tiles)
+{
+  pthread_mutex_lock(&tiles->lock);
+  tiles->stop = true;
+  pthread_cond_broadcast(&tiles->start);
+  pthread_mutex_unlock(&tiles->lock);
+
+  for (uint8_t i = 1; i < tiles->thread_count; i++)
+  {
+    pthread_join(tiles->workers[i].thread, NULL);
+  }
+
+  for (uint8_t i = 0; i < LINUX_TILES_THREADS_MAX; i++)
+  {
+    free(tiles->workers[i].buffer);
+    tiles->workers[i].buffer = NULL;
+  }
+
+  tiles->thread_count = 0;
+
+  pthread_cond_destroy(&tiles->done);
+  pthread_cond_destroy(&tiles->start);
+  pthread_mutex_destroy(&tiles->lock);
+}
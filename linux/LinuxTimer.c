@@ -0,0 +1,51 @@
+#include <time.h>
+
+#include "JLibLinux.h"
+
+/*******************************************************************************
+ *
+ *  UTIMER clock on CLOCK_MONOTONIC.
+ *
+ ******************************************************************************/
+
+static struct
+{
+  UTIMER_instance_t* utimer;
+  uint64_t periods;
+}
+LINUX_timer;
+
+static uint64_t LINUX_timer_now_ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void LINUX_timer_initialize(UTIMER_instance_t* utimer)
+{
+  UTIMER_initialize(utimer,
+                    LINUX_TIMER_TICKS_PER_MICROSECOND,
+                    LINUX_TIMER_TICKS_PER_PERIOD,
+                    LINUX_timer_get_hardware_counter);
+
+  // The period counter starts at 0 with the period the clock is in.
+
+  LINUX_timer.utimer = utimer;
+  LINUX_timer.periods = LINUX_timer_now_ns() / LINUX_TIMER_TICKS_PER_PERIOD;
+}
+
+uint64_t LINUX_timer_get_hardware_counter(void)
+{
+  uint64_t now_ns = LINUX_timer_now_ns();
+
+  while (LINUX_timer.periods < now_ns / LINUX_TIMER_TICKS_PER_PERIOD)
+  {
+    LINUX_timer.periods++;
+    UTIMER_period_isr_handler(LINUX_timer.utimer);
+  }
+
+  return now_ns % LINUX_TIMER_TICKS_PER_PERIOD;
+}
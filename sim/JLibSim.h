@@ -0,0 +1,629 @@
+#ifndef JLIB_SIM_J_H
+#define JLIB_SIM_J_H
+
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Simulated peripheral HALs for host builds. Each backend implements the HAL
+ *  templates of a JLIB module against a software model, so that service
+ *  routines can be run, benchmarked and fuzzed on a workstation under perf
+ *  and the sanitizers:
+ *
+ *   SIM_timer   UTIMER hardware counter driven by virtual time.
+ *   SIM_spi     SERSPI bus (standard and burst methods) with chip selected
+ *               device models: SIM_ili9341 and SIM_eeprom25.
+ *   SIM_i2c     SERI2C bus with register file slaves.
+ *   SIM_uart    SERUART loopback.
+ *   SIM_eeprom  EEPROM driver HALs backed by a SIM_eeprom25 model.
+ *
+ *  The HAL templates take no instance argument, hence, each backend is a
+ *  single peripheral. Bus transfers complete immediately and advance virtual
+ *  time by their duration on the wire, if a clock rate is set.
+ *
+ *  Host builds without a host build of the library archive link stand-ins
+ *  for the library modules instead. They implement the JLib.h interfaces with
+ *  plain C loops, for testing rather than speed:
+ *
+ *   SimGfx2d.c    GFX2D, with a 5x7 GFX2DFONT_DEFAULT_FONT.
+ *   SimLibrary.c  UTILITIES, UTIMER, QUEUE, BUSMUTEX, BIBUTTON,
+ *                 ROTARYENCODER, SHIFTPISO (bit-bang method only) and
+ *                 WS2812 (encoding only).
+ *
+ *  sim/Makefile builds src/ and sim/ with them under the sanitizers and runs
+ *  SimSelfTest.c against the backends.
+ *
+ ******************************************************************************/
+
+// Support C++ builds.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ *
+ *  Virtual timer.
+ *
+ ******************************************************************************/
+
+/*
+ * One tick per nanosecond. The period is kept short enough that the UTIMER
+ * period handling is exercised within seconds of virtual time.
+ */
+
+#define SIM_TIMER_TICKS_PER_MICROSECOND   1000ULL
+#define SIM_TIMER_TICKS_PER_PERIOD        0x40000000ULL
+
+/*******************************************************************************
+ *
+ * SIM_timer_initialize
+ *
+ * DESCRIPTION:
+ *  Resets virtual time to 0 and initializes a UTIMER instance to use it.
+ *
+ * PARAMETERS:
+ *  auto_advance_ns
+ *   Virtual time added each time the counter is read, so that polling loops
+ *   waiting on a timeout make progress. Can be 0.
+ *
+ ******************************************************************************/
+
+void SIM_timer_initialize(UTIMER_instance_t* utimer, uint32_t auto_advance_ns);
+
+/*******************************************************************************
+ *
+ * SIM_timer_get_hardware_counter
+ *
+ * DESCRIPTION:
+ *  UTIMER_hal_get_hardware_counter_t backend.
+ *
+ ******************************************************************************/
+
+uint64_t SIM_timer_get_hardware_counter(void);
+
+/*******************************************************************************
+ *
+ * SIM_timer_advance_ns
+ *
+ * DESCRIPTION:
+ *  Advances virtual time, calling UTIMER_period_isr_handler for each period
+ *  boundary crossed.
+ *
+ ******************************************************************************/
+
+void SIM_timer_advance_ns(uint64_t ns);
+
+/*******************************************************************************
+ *
+ * SIM_timer_now_ns
+ *
+ * DESCRIPTION:
+ *  Gets the virtual time.
+ *
+ ******************************************************************************/
+
+uint64_t SIM_timer_now_ns(void);
+
+/*******************************************************************************
+ *
+ *  Virtual SPI bus.
+ *
+ ******************************************************************************/
+
+#define SIM_SPI_BURST_LENGTH_MAX          4096U
+
+/*******************************************************************************
+ *
+ * SIM_spi_device_t
+ *
+ * DESCRIPTION:
+ *  Device model attached to the bus.
+ *
+ * select
+ *  Called when the chip select of the device changes.
+ *
+ * exchange
+ *  Called for each byte clocked while the device is selected, returning the
+ *  MISO byte.
+ *
+ * model
+ *  Passed to the functions.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  void (*select)(void* model, bool selected);
+  uint8_t (*exchange)(void* model, uint8_t mosi);
+  void* model;
+}
+SIM_spi_device_t;
+
+/*******************************************************************************
+ *
+ * SIM_spi_initialize
+ *
+ * DESCRIPTION:
+ *  Resets the bus.
+ *
+ * PARAMETERS:
+ *  data_width_bytes
+ *   Bytes clocked per Tx register write, matching the SERSPI data width.
+ *
+ *  clock_hz
+ *   SPI clock rate used to advance virtual time, 0 if transfers take no time.
+ *
+ ******************************************************************************/
+
+void SIM_spi_initialize(uint8_t data_width_bytes, uint32_t clock_hz);
+
+/*******************************************************************************
+ *
+ * SIM_spi_select
+ *
+ * DESCRIPTION:
+ *  Selects a device, deselecting the current one. NULL deselects all.
+ *
+ ******************************************************************************/
+
+void SIM_spi_select(SIM_spi_device_t* device);
+
+/*******************************************************************************
+ *
+ * SIM_spi_inject_errors
+ *
+ * DESCRIPTION:
+ *  Raises the error flags reported to SERSPI until cleared by it.
+ *
+ ******************************************************************************/
+
+void SIM_spi_inject_errors(bool rx_overflow, bool frame, bool other);
+
+/*
+ * SERSPI HAL backends, standard method.
+ */
+
+bool SIM_spi_is_rx_ready(void);
+bool SIM_spi_is_tx_ready(void);
+uint32_t SIM_spi_read_rx_register(void);
+void SIM_spi_write_tx_register(uint32_t value);
+bool SIM_spi_is_spi_busy(void);
+bool SIM_spi_error_check_rx_overflow(void);
+bool SIM_spi_error_check_frame(void);
+bool SIM_spi_error_check_other(void);
+void SIM_spi_clear_error_flags(void);
+void SIM_spi_new_task_reset(void);
+
+/*
+ * SERSPI HAL backends, burst method.
+ */
+
+void SIM_spi_burst_write_mosi_buffer(uint8_t* buffer, uint32_t length);
+void SIM_spi_burst_write_mosi_buffer_dummy(uint32_t value, uint32_t length);
+void SIM_spi_burst_read_miso_buffer(uint8_t* buffer, uint32_t length);
+void SIM_spi_burst_set_length(uint32_t length);
+void SIM_spi_burst_start(void);
+
+/*******************************************************************************
+ *
+ *  ILI9341 display model. Implements the commands used to draw: software
+ *  reset, sleep out, display on/off, memory access control, column and page
+ *  address set and memory write, with 16-bit RGB565 pixels.
+ *
+ ******************************************************************************/
+
+#define SIM_ILI9341_WIDTH                 240U
+#define SIM_ILI9341_HEIGHT                320U
+
+/*******************************************************************************
+ *
+ * SIM_ili9341_t
+ *
+ * DESCRIPTION:
+ *  Model state. Only to be allocated by the user.
+ *
+ * device
+ *  Bus device of the model.
+ *
+ * framebuffer
+ *  Display memory, RGB565.
+ *
+ * data_mode
+ *  State of the DC line, true for data.
+ *
+ * command
+ *  Current command.
+ *
+ * parameter_index
+ *  Index of the next parameter byte of the current command.
+ *
+ * parameters
+ *  Parameter bytes of the current command.
+ *
+ * column_start, column_end, page_start, page_end
+ *  Address window.
+ *
+ * column, page
+ *  Address of the next pixel.
+ *
+ * pixel_high
+ *  High byte of a pixel awaiting its low byte, if pixel_pending.
+ *
+ * sleeping, display_on
+ *  Power state.
+ *
+ * madctl
+ *  Memory access control parameter, stored only.
+ *
+ * command_count, pixel_count
+ *  Counters.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  SIM_spi_device_t device;
+  uint16_t framebuffer[SIM_ILI9341_WIDTH * SIM_ILI9341_HEIGHT];
+  bool data_mode;
+  uint8_t command;
+  uint8_t parameter_index;
+  uint8_t parameters[4];
+  uint16_t column_start;
+  uint16_t column_end;
+  uint16_t page_start;
+  uint16_t page_end;
+  uint16_t column;
+  uint16_t page;
+  uint8_t pixel_high;
+  bool pixel_pending;
+  bool sleeping;
+  bool display_on;
+  uint8_t madctl;
+  uint32_t command_count;
+  uint32_t pixel_count;
+}
+SIM_ili9341_t;
+
+/*******************************************************************************
+ *
+ * SIM_ili9341_initialize
+ *
+ * DESCRIPTION:
+ *  Resets a model and makes it the target of the ILI9341 HAL backends.
+ *
+ ******************************************************************************/
+
+void SIM_ili9341_initialize(SIM_ili9341_t* model);
+
+/*******************************************************************************
+ *
+ * SIM_ili9341_write_ppm
+ *
+ * DESCRIPTION:
+ *  Writes the framebuffer to a binary PPM file for visual regression checks.
+ *
+ * RETURN:
+ *  True if the file was written, else, false.
+ *
+ ******************************************************************************/
+
+bool SIM_ili9341_write_ppm(SIM_ili9341_t* model, const char* path);
+
+/*******************************************************************************
+ *
+ * SIM_ili9341_set_dma_complete_callback
+ *
+ * DESCRIPTION:
+ *  Sets the function called once SIM_ili9341_configure_dma has streamed a
+ *  buffer, typically calling ILI9341_dma_transfer_complete_handler.
+ *
+ ******************************************************************************/
+
+void SIM_ili9341_set_dma_complete_callback(void (*callback)(void));
+
+/*******************************************************************************
+ *
+ * SIM_ili9341_dma_service
+ *
+ * DESCRIPTION:
+ *  Calls the DMA complete callback once for a transfer started since the last
+ *  call, as the DMA interrupt would. To be called from the host main loop, so
+ *  that completion is never signaled before the configure HAL has returned.
+ *
+ ******************************************************************************/
+
+void SIM_ili9341_dma_service(void);
+
+/*
+ * ILI9341 HAL backends.
+ */
+
+bool SIM_ili9341_set_chip_select(bool enable);
+void SIM_ili9341_set_dc_select(bool enable);
+bool SIM_ili9341_configure_dma(void* src_addr, uint32_t src_length);
+void SIM_ili9341_disable_dma(void);
+
+/*******************************************************************************
+ *
+ *  25xx SPI EEPROM model. Implements WREN, WRDI, RDSR, READ and WRITE with
+ *  page wrap-around and a write cycle, during which the device is busy, timed
+ *  in virtual time.
+ *
+ ******************************************************************************/
+
+#define SIM_EEPROM25_WRSR                 0x01U
+#define SIM_EEPROM25_WRITE                0x02U
+#define SIM_EEPROM25_READ                 0x03U
+#define SIM_EEPROM25_WRDI                 0x04U
+#define SIM_EEPROM25_RDSR                 0x05U
+#define SIM_EEPROM25_WREN                 0x06U
+
+#define SIM_EEPROM25_STATUS_WIP           0x01U
+#define SIM_EEPROM25_STATUS_WEL           0x02U
+
+/*******************************************************************************
+ *
+ * SIM_eeprom25_t
+ *
+ * DESCRIPTION:
+ *  Model state. Only to be allocated by the user.
+ *
+ * device
+ *  Bus device of the model.
+ *
+ * memory
+ *  User-provided memory array.
+ *
+ * total_length, page_length, address_length
+ *  Geometry, the address length in bytes.
+ *
+ * write_cycle_ns
+ *  Duration of a page commit.
+ *
+ * status
+ *  Status register.
+ *
+ * busy_until_ns
+ *  Virtual time at which the current write cycle ends.
+ *
+ * command, byte_index, address
+ *  Transaction state.
+ *
+ * page_buffer, page_dirty
+ *  Latched write data, committed on deselect.
+ *
+ * page_commits
+ *  Number of write cycles, for wear checks.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  SIM_spi_device_t device;
+  uint8_t* memory;
+  uint32_t total_length;
+  uint16_t page_length;
+  uint8_t address_length;
+  uint32_t write_cycle_ns;
+  uint8_t status;
+  uint64_t busy_until_ns;
+  uint8_t command;
+  uint32_t byte_index;
+  uint32_t address;
+  uint8_t* page_buffer;
+  bool* page_dirty;
+  uint32_t page_commits;
+}
+SIM_eeprom25_t;
+
+/*******************************************************************************
+ *
+ * SIM_eeprom25_initialize
+ *
+ * DESCRIPTION:
+ *  Resets a model, filling the memory with 0xFF.
+ *
+ * PARAMETERS:
+ *  page_buffer
+ *   User-provided buffer of page_length bytes.
+ *
+ *  page_dirty
+ *   User-provided array of page_length flags.
+ *
+ ******************************************************************************/
+
+void SIM_eeprom25_initialize(SIM_eeprom25_t* model,
+                             uint8_t* memory,
+                             uint32_t total_length,
+                             uint8_t* page_buffer,
+                             bool* page_dirty,
+                             uint16_t page_length,
+                             uint8_t address_length,
+                             uint32_t write_cycle_ns);
+
+/*******************************************************************************
+ *
+ *  EEPROM driver HAL backends. Run a whole read or write against a 25xx model
+ *  through the bus, for use of the EEPROM module without a SERSPI driver. The
+ *  write is completed by the driver service once the write cycle has ended.
+ *
+ ******************************************************************************/
+
+void SIM_eeprom_attach(SIM_eeprom25_t* model);
+bool SIM_eeprom_driver_read(uint32_t address, uint8_t address_reg_length, uint8_t* buffer, uint32_t length);
+bool SIM_eeprom_driver_write(uint32_t address, uint8_t address_reg_length, uint8_t* buffer, uint32_t length);
+bool SIM_eeprom_driver_service(void);
+bool SIM_eeprom_driver_timeout(void);
+
+/*******************************************************************************
+ *
+ *  Virtual I2C bus with register file slaves. A write transaction sets the
+ *  register pointer with its first pointer_length bytes and writes registers
+ *  with the following bytes. A read transaction reads registers from the
+ *  pointer. The pointer auto-increments and wraps at the register count.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ *
+ * SIM_i2c_slave_t
+ *
+ * DESCRIPTION:
+ *  Register file slave. Only to be allocated by the user.
+ *
+ * address
+ *  7-bit slave address.
+ *
+ * registers
+ *  User-provided register file.
+ *
+ * register_count
+ *  Number of registers.
+ *
+ * pointer_length
+ *  Bytes of register pointer, 1 or 2, sent most significant first.
+ *
+ * pointer
+ *  Register pointer.
+ *
+ * next_slave
+ *  Next slave on the bus, managed by the bus.
+ *
+ ******************************************************************************/
+
+typedef struct
+{
+  uint8_t address;
+  uint8_t* registers;
+  uint16_t register_count;
+  uint8_t pointer_length;
+  uint16_t pointer;
+  void* next_slave;
+}
+SIM_i2c_slave_t;
+
+/*******************************************************************************
+ *
+ * SIM_i2c_initialize
+ *
+ * DESCRIPTION:
+ *  Resets the bus and detaches all slaves.
+ *
+ * PARAMETERS:
+ *  clock_hz
+ *   SCL rate used to advance virtual time, 0 if transfers take no time.
+ *
+ ******************************************************************************/
+
+void SIM_i2c_initialize(uint32_t clock_hz);
+
+/*******************************************************************************
+ *
+ * SIM_i2c_attach
+ *
+ * DESCRIPTION:
+ *  Attaches a slave to the bus.
+ *
+ ******************************************************************************/
+
+void SIM_i2c_attach(SIM_i2c_slave_t* slave,
+                    uint8_t address,
+                    uint8_t* registers,
+                    uint16_t register_count,
+                    uint8_t pointer_length);
+
+/*******************************************************************************
+ *
+ * SIM_i2c_inject_errors
+ *
+ * DESCRIPTION:
+ *  Raises the error flags reported to SERI2C until cleared by it.
+ *
+ ******************************************************************************/
+
+void SIM_i2c_inject_errors(bool collision, bool rx_overflow, bool other);
+
+/*
+ * SERI2C HAL backends.
+ */
+
+bool SIM_i2c_is_rx_ready(void);
+bool SIM_i2c_is_tx_ready(void);
+uint8_t SIM_i2c_read_rx_register(void);
+void SIM_i2c_write_tx_register(uint8_t value);
+void SIM_i2c_send_start_condition(void);
+bool SIM_i2c_is_send_start_condition_completed(void);
+void SIM_i2c_send_restart_condition(void);
+bool SIM_i2c_is_send_restart_condition_completed(void);
+void SIM_i2c_send_stop_condition(void);
+bool SIM_i2c_is_send_stop_condition_completed(void);
+void SIM_i2c_send_ack(void);
+bool SIM_i2c_is_send_ack_completed(void);
+void SIM_i2c_send_nak(void);
+bool SIM_i2c_is_send_nak_completed(void);
+bool SIM_i2c_is_ack_received(void);
+bool SIM_i2c_error_check_nak_received(void);
+bool SIM_i2c_error_check_collision(void);
+bool SIM_i2c_error_check_rx_overflow(void);
+bool SIM_i2c_error_check_other(void);
+void SIM_i2c_clear_errors(void);
+void SIM_i2c_enable_rx(bool last_byte);
+void SIM_i2c_new_task_reset(void);
+
+/*******************************************************************************
+ *
+ *  UART loopback. Transmitted elements are received back, in order, once
+ *  their frame time has passed in virtual time.
+ *
+ ******************************************************************************/
+
+#define SIM_UART_LOOPBACK_LENGTH          256U
+
+/*******************************************************************************
+ *
+ * SIM_uart_initialize
+ *
+ * DESCRIPTION:
+ *  Empties the loopback.
+ *
+ * PARAMETERS:
+ *  baud_rate
+ *   Rate used to time frames of 10 bits, 0 if frames take no time.
+ *
+ ******************************************************************************/
+
+void SIM_uart_initialize(uint32_t baud_rate);
+
+/*******************************************************************************
+ *
+ * SIM_uart_inject_errors
+ *
+ * DESCRIPTION:
+ *  Raises the Rx error flags reported to SERUART until cleared by it.
+ *
+ ******************************************************************************/
+
+void SIM_uart_inject_errors(bool rx_overflow, bool rx_frame, bool rx_parity);
+
+/*
+ * SERUART HAL backends.
+ */
+
+bool SIM_uart_is_rx_ready(void);
+bool SIM_uart_is_tx_ready(void);
+bool SIM_uart_is_tx_empty(void);
+uint16_t SIM_uart_read_rx_register(void);
+void SIM_uart_write_tx_register(uint16_t value);
+bool SIM_uart_error_check_rx_overflow(void);
+bool SIM_uart_error_check_rx_frame(void);
+bool SIM_uart_error_check_rx_parity(void);
+void SIM_uart_clear_rx_error_flags(void);
+void SIM_uart_clear_tx_error_flags(void);
+void SIM_uart_new_rx_task_reset(void);
+void SIM_uart_new_tx_task_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // JLIB_SIM_J_H
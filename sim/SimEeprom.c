@@ -0,0 +1,324 @@
+#include "JLibSim.h"
+
+/*******************************************************************************
+ *
+ *  25xx SPI EEPROM model and EEPROM driver HAL backends.
+ *
+ ******************************************************************************/
+
+typedef enum
+{
+  SIM_EEPROM_DRIVER_IDLE = 0,
+  SIM_EEPROM_DRIVER_READ,
+  SIM_EEPROM_DRIVER_WRITE,
+  SIM_EEPROM_DRIVER_WRITE_CYCLE
+}
+SIM_eeprom_driver_state_t;
+
+static struct
+{
+  SIM_eeprom25_t* model;
+  SIM_eeprom_driver_state_t state;
+  uint32_t address;
+  uint8_t* buffer;
+  uint32_t length;
+}
+SIM_eeprom_driver;
+
+static void SIM_eeprom25_update_status(SIM_eeprom25_t* model)
+{
+  if ((model->status & SIM_EEPROM25_STATUS_WIP) && (SIM_timer_now_ns() >= model->busy_until_ns))
+  {
+    model->status &= (uint8_t)~SIM_EEPROM25_STATUS_WIP;
+  }
+}
+
+static void SIM_eeprom25_commit(SIM_eeprom25_t* model)
+{
+  uint32_t page_base = model->address - (model->address % model->page_length);
+  bool dirty = false;
+
+  for (uint16_t offset = 0; offset < model->page_length; offset++)
+  {
+    if (model->page_dirty[offset])
+    {
+      model->memory[(page_base + offset) % model->total_length] = model->page_buffer[offset];
+      model->page_dirty[offset] = false;
+      dirty = true;
+    }
+  }
+
+  model->status &= (uint8_t)~SIM_EEPROM25_STATUS_WEL;
+
+  if (dirty)
+  {
+    model->status |= SIM_EEPROM25_STATUS_WIP;
+    model->busy_until_ns = SIM_timer_now_ns() + model->write_cycle_ns;
+    model->page_commits++;
+  }
+}
+
+static void SIM_eeprom25_select(void* model_pointer, bool selected)
+{
+  SIM_eeprom25_t* model = (SIM_eeprom25_t*)model_pointer;
+
+  // A write is latched in the page buffer and committed once deselected.
+
+  if (!selected && (model->command == SIM_EEPROM25_WRITE) && (model->byte_index > model->address_length))
+  {
+    SIM_eeprom25_commit(model);
+  }
+
+  model->command = 0;
+  model->byte_index = 0;
+}
+
+static uint8_t SIM_eeprom25_exchange(void* model_pointer, uint8_t mosi)
+{
+  SIM_eeprom25_t* model = (SIM_eeprom25_t*)model_pointer;
+  uint32_t byte_index = model->byte_index++;
+
+  SIM_eeprom25_update_status(model);
+
+  if (byte_index == 0)
+  {
+    // Only the status can be read during a write cycle. A write is only
+    // accepted with the write enable latch set.
+
+    if (((model->status & SIM_EEPROM25_STATUS_WIP) && (mosi != SIM_EEPROM25_RDSR)) ||
+        ((mosi == SIM_EEPROM25_WRITE) && !(model->status & SIM_EEPROM25_STATUS_WEL)))
+    {
+      return 0xFF;
+    }
+
+    model->command = mosi;
+    model->address = 0;
+
+    if (mosi == SIM_EEPROM25_WREN)
+    {
+      model->status |= SIM_EEPROM25_STATUS_WEL;
+    }
+    else if (mosi == SIM_EEPROM25_WRDI)
+    {
+      model->status &= (uint8_t)~SIM_EEPROM25_STATUS_WEL;
+    }
+
+    return 0xFF;
+  }
+
+  switch (model->command)
+  {
+    case SIM_EEPROM25_RDSR:
+      return model->status;
+
+    case SIM_EEPROM25_READ:
+      if (byte_index <= model->address_length)
+      {
+        model->address = (model->address << 8) | mosi;
+        return 0xFF;
+      }
+
+      return model->memory[model->address++ % model->total_length];
+
+    case SIM_EEPROM25_WRITE:
+      if (byte_index <= model->address_length)
+      {
+        model->address = (model->address << 8) | mosi;
+        return 0xFF;
+      }
+
+      // The address wraps around within the page.
+
+      {
+        uint16_t offset = (uint16_t)(model->address % model->page_length);
+
+        model->page_buffer[offset] = mosi;
+        model->page_dirty[offset] = true;
+        model->address = model->address - offset + ((offset + 1U) % model->page_length);
+      }
+
+      return 0xFF;
+
+    default:
+      return 0xFF;
+  }
+}
+
+static void SIM_eeprom_clock(uint8_t* data, uint32_t length)
+{
+  while (length != 0)
+  {
+    uint32_t chunk_length = UTILS_MIN(length, SIM_SPI_BURST_LENGTH_MAX);
+
+    SIM_spi_burst_write_mosi_buffer(data, chunk_length);
+    SIM_spi_burst_start();
+    SIM_spi_burst_read_miso_buffer(data, chunk_length);
+
+    data += chunk_length;
+    length -= chunk_length;
+  }
+}
+
+static void SIM_eeprom_command(uint8_t command, uint32_t address, bool with_address)
+{
+  uint8_t header[4];
+  uint32_t header_length = 1;
+
+  header[0] = command;
+
+  if (with_address)
+  {
+    for (uint8_t byte_index = SIM_eeprom_driver.model->address_length; byte_index > 0; byte_index--)
+    {
+      header[header_length++] = (uint8_t)(address >> ((byte_index - 1U) * 8U));
+    }
+  }
+
+  SIM_eeprom_clock(header, header_length);
+}
+
+static bool SIM_eeprom_is_busy(void)
+{
+  uint8_t status[2] = { SIM_EEPROM25_RDSR, 0xFF };
+
+  SIM_spi_select(&SIM_eeprom_driver.model->device);
+  SIM_eeprom_clock(status, sizeof(status));
+  SIM_spi_select(NULL);
+
+  return (status[1] & SIM_EEPROM25_STATUS_WIP);
+}
+
+void SIM_eeprom25_initialize(SIM_eeprom25_t* model,
+                             uint8_t* memory,
+                             uint32_t total_length,
+                             uint8_t* page_buffer,
+                             bool* page_dirty,
+                             uint16_t page_length,
+                             uint8_t address_length,
+                             uint32_t write_cycle_ns)
+{
+  UTILS_ASSERT((address_length >= 1) && (address_length <= 3));
+
+  UTILITIES_memclear(model, sizeof(SIM_eeprom25_t));
+  UTILITIES_memset(memory, 0xFF, total_length);
+  UTILITIES_memclear(page_dirty, (uint32_t)page_length * sizeof(bool));
+
+  model->device.select = SIM_eeprom25_select;
+  model->device.exchange = SIM_eeprom25_exchange;
+  model->device.model = model;
+  model->memory = memory;
+  model->total_length = total_length;
+  model->page_buffer = page_buffer;
+  model->page_dirty = page_dirty;
+  model->page_length = page_length;
+  model->address_length = address_length;
+  model->write_cycle_ns = write_cycle_ns;
+}
+
+void SIM_eeprom_attach(SIM_eeprom25_t* model)
+{
+  UTILITIES_memclear(&SIM_eeprom_driver, sizeof(SIM_eeprom_driver));
+
+  SIM_eeprom_driver.model = model;
+}
+
+bool SIM_eeprom_driver_read(uint32_t address, uint8_t address_reg_length, uint8_t* buffer, uint32_t length)
+{
+  (void)address_reg_length;
+
+  if (SIM_eeprom_driver.state != SIM_EEPROM_DRIVER_IDLE)
+  {
+    return false;
+  }
+
+  SIM_eeprom_driver.state = SIM_EEPROM_DRIVER_READ;
+  SIM_eeprom_driver.address = address;
+  SIM_eeprom_driver.buffer = buffer;
+  SIM_eeprom_driver.length = length;
+
+  return true;
+}
+
+bool SIM_eeprom_driver_write(uint32_t address, uint8_t address_reg_length, uint8_t* buffer, uint32_t length)
+{
+  (void)address_reg_length;
+
+  if (SIM_eeprom_driver.state != SIM_EEPROM_DRIVER_IDLE)
+  {
+    return false;
+  }
+
+  SIM_eeprom_driver.state = SIM_EEPROM_DRIVER_WRITE;
+  SIM_eeprom_driver.address = address;
+  SIM_eeprom_driver.buffer = buffer;
+  SIM_eeprom_driver.length = length;
+
+  return true;
+}
+
+bool SIM_eeprom_driver_service(void)
+{
+  switch (SIM_eeprom_driver.state)
+  {
+    case SIM_EEPROM_DRIVER_READ:
+      if (SIM_eeprom_is_busy())
+      {
+        return false;
+      }
+
+      SIM_spi_select(&SIM_eeprom_driver.model->device);
+      SIM_eeprom_command(SIM_EEPROM25_READ, SIM_eeprom_driver.address, true);
+      UTILITIES_memset(SIM_eeprom_driver.buffer, 0xFF, SIM_eeprom_driver.length);
+      SIM_eeprom_clock(SIM_eeprom_driver.buffer, SIM_eeprom_driver.length);
+      SIM_spi_select(NULL);
+
+      SIM_eeprom_driver.state = SIM_EEPROM_DRIVER_IDLE;
+      return true;
+
+    case SIM_EEPROM_DRIVER_WRITE:
+      if (SIM_eeprom_is_busy())
+      {
+        return false;
+      }
+
+      SIM_spi_select(&SIM_eeprom_driver.model->device);
+      SIM_eeprom_command(SIM_EEPROM25_WREN, 0, false);
+      SIM_spi_select(NULL);
+
+      // The bus exchanges data in place, hence, the source is sent from a
+      // copy.
+
+      SIM_spi_select(&SIM_eeprom_driver.model->device);
+      SIM_eeprom_command(SIM_EEPROM25_WRITE, SIM_eeprom_driver.address, true);
+
+      for (uint32_t offset = 0; offset < SIM_eeprom_driver.length; offset += SIM_SPI_BURST_LENGTH_MAX)
+      {
+        uint32_t chunk_length = UTILS_MIN(SIM_eeprom_driver.length - offset, SIM_SPI_BURST_LENGTH_MAX);
+
+        SIM_spi_burst_write_mosi_buffer(SIM_eeprom_driver.buffer + offset, chunk_length);
+        SIM_spi_burst_start();
+      }
+
+      SIM_spi_select(NULL);
+
+      SIM_eeprom_driver.state = SIM_EEPROM_DRIVER_WRITE_CYCLE;
+      return false;
+
+    case SIM_EEPROM_DRIVER_WRITE_CYCLE:
+      if (SIM_eeprom_is_busy())
+      {
+        return false;
+      }
+
+      SIM_eeprom_driver.state = SIM_EEPROM_DRIVER_IDLE;
+      return true;
+
+    default:
+      return true;
+  }
+}
+
+bool SIM_eeprom_driver_timeout(void)
+{
+  return false;
+}
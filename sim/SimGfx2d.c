@@ -0,0 +1,975 @@
+#include "JLibSim.h"
+
+/*******************************************************************************
+ *
+ *  GFX2D stand-in.
+ *
+ ******************************************************************************/
+
+/*
+ * Default 5x7 font, printable ASCII. Glyphs are trimmed to their set pixels
+ * and advance by 6 pixels.
+ */
+
+static const uint8_t SIM_GFX2D_FONT_BITMAP[] =
+{
+  0xFA, 0xB6, 0x80, 0x52, 0xBE, 0xAF, 0xA9, 0x40, 0x23, 0xE8, 0xE2, 0xF8, 0x80,
+  0xC6, 0x44, 0x44, 0x4C, 0x60, 0x64, 0xA8, 0x8A, 0xC9, 0xA0, 0xD8, 0x2A, 0x48,
+  0x88, 0x88, 0x92, 0xA0, 0x25, 0x5D, 0x52, 0x00, 0x21, 0x3E, 0x42, 0x00, 0xD8,
+  0xF8, 0xF0, 0x08, 0x88, 0x88, 0x00, 0x74, 0x67, 0x5C, 0xC5, 0xC0, 0x59, 0x24,
+  0xB8, 0x74, 0x42, 0x22, 0x23, 0xE0, 0xF8, 0x88, 0x20, 0xC5, 0xC0, 0x11, 0x95,
+  0x2F, 0x88, 0x40, 0xFC, 0x3C, 0x10, 0xC5, 0xC0, 0x32, 0x21, 0xE8, 0xC5, 0xC0,
+  0xF8, 0x44, 0x44, 0x21, 0x00, 0x74, 0x62, 0xE8, 0xC5, 0xC0, 0x74, 0x62, 0xF0,
+  0x89, 0x80, 0xF3, 0xC0, 0xF3, 0x60, 0x12, 0x48, 0x42, 0x10, 0xF8, 0x3E, 0x84,
+  0x21, 0x24, 0x80, 0x74, 0x42, 0x22, 0x00, 0x80, 0x74, 0x42, 0xDA, 0xD5, 0xC0,
+  0x74, 0x63, 0x1F, 0xC6, 0x20, 0xF4, 0x63, 0xE8, 0xC7, 0xC0, 0x74, 0x61, 0x08,
+  0x45, 0xC0, 0xE4, 0xA3, 0x18, 0xCB, 0x80, 0xFC, 0x21, 0xE8, 0x43, 0xE0, 0xFC,
+  0x21, 0xE8, 0x42, 0x00, 0x74, 0x61, 0x78, 0xC5, 0xE0, 0x8C, 0x63, 0xF8, 0xC6,
+  0x20, 0xE9, 0x24, 0xB8, 0x38, 0x84, 0x21, 0x49, 0x80, 0x8C, 0xA9, 0x8A, 0x4A,
+  0x20, 0x84, 0x21, 0x08, 0x43, 0xE0, 0x8E, 0xEB, 0x58, 0xC6, 0x20, 0x8C, 0x73,
+  0x59, 0xC6, 0x20, 0x74, 0x63, 0x18, 0xC5, 0xC0, 0xF4, 0x63, 0xE8, 0x42, 0x00,
+  0x74, 0x63, 0x1A, 0xC9, 0xA0, 0xF4, 0x63, 0xEA, 0x4A, 0x20, 0x7C, 0x20, 0xE0,
+  0x87, 0xC0, 0xF9, 0x08, 0x42, 0x10, 0x80, 0x8C, 0x63, 0x18, 0xC5, 0xC0, 0x8C,
+  0x63, 0x18, 0xA8, 0x80, 0x8C, 0x63, 0x5A, 0xD5, 0x40, 0x8C, 0x54, 0x45, 0x46,
+  0x20, 0x8C, 0x62, 0xA2, 0x10, 0x80, 0xF8, 0x44, 0x44, 0x43, 0xE0, 0xF2, 0x49,
+  0x38, 0x82, 0x08, 0x20, 0x80, 0xE4, 0x92, 0x78, 0x22, 0xA2, 0xF8, 0x88, 0x80,
+  0x70, 0x5F, 0x17, 0x80, 0x84, 0x2D, 0x98, 0xC7, 0xC0, 0x74, 0x21, 0x17, 0x00,
+  0x08, 0x5B, 0x38, 0xC5, 0xE0, 0x74, 0x7F, 0x07, 0x00, 0x32, 0x51, 0xC4, 0x21,
+  0x00, 0x7C, 0x62, 0xF0, 0xB8, 0x84, 0x2D, 0x98, 0xC6, 0x20, 0x43, 0x24, 0xB8,
+  0x10, 0x31, 0x19, 0x60, 0x88, 0x9A, 0xCA, 0x90, 0xC9, 0x24, 0xB8, 0xD5, 0x6B,
+  0x18, 0x80, 0xB6, 0x63, 0x18, 0x80, 0x74, 0x63, 0x17, 0x00, 0xF4, 0x7D, 0x08,
+  0x00, 0x6C, 0xDE, 0x10, 0x80, 0xB6, 0x61, 0x08, 0x00, 0x74, 0x1C, 0x1F, 0x00,
+  0x42, 0x38, 0x84, 0x24, 0xC0, 0x8C, 0x63, 0x36, 0x80, 0x8C, 0x62, 0xA2, 0x00,
+  0x8C, 0x6B, 0x55, 0x00, 0x8A, 0x88, 0xA8, 0x80, 0x8C, 0x5E, 0x17, 0x00, 0xF8,
+  0x88, 0x8F, 0x80, 0x29, 0x44, 0x88, 0xFE, 0x89, 0x14, 0xA0, 0x45, 0x44
+};
+
+static const GFX2DFONT_glyph_t SIM_GFX2D_FONT_GLYPHS[] =
+{
+  {   0, 0, 0, 6, 0,  0}, // 0x20 ' '
+  {   0, 1, 7, 6, 2, -7}, // 0x21 '!'
+  {   1, 3, 3, 6, 1, -7}, // 0x22 '"'
+  {   3, 5, 7, 6, 0, -7}, // 0x23 '#'
+  {   8, 5, 7, 6, 0, -7}, // 0x24 '$'
+  {  13, 5, 7, 6, 0, -7}, // 0x25 '%'
+  {  18, 5, 7, 6, 0, -7}, // 0x26 '&'
+  {  23, 2, 3, 6, 1, -7}, // 0x27
+  {  24, 3, 7, 6, 1, -7}, // 0x28 '('
+  {  27, 3, 7, 6, 1, -7}, // 0x29 ')'
+  {  30, 5, 5, 6, 0, -6}, // 0x2A '*'
+  {  34, 5, 5, 6, 0, -6}, // 0x2B '+'
+  {  38, 2, 3, 6, 1, -3}, // 0x2C ','
+  {  39, 5, 1, 6, 0, -4}, // 0x2D '-'
+  {  40, 2, 2, 6, 1, -2}, // 0x2E '.'
+  {  41, 5, 5, 6, 0, -6}, // 0x2F '/'
+  {  45, 5, 7, 6, 0, -7}, // 0x30 '0'
+  {  50, 3, 7, 6, 1, -7}, // 0x31 '1'
+  {  53, 5, 7, 6, 0, -7}, // 0x32 '2'
+  {  58, 5, 7, 6, 0, -7}, // 0x33 '3'
+  {  63, 5, 7, 6, 0, -7}, // 0x34 '4'
+  {  68, 5, 7, 6, 0, -7}, // 0x35 '5'
+  {  73, 5, 7, 6, 0, -7}, // 0x36 '6'
+  {  78, 5, 7, 6, 0, -7}, // 0x37 '7'
+  {  83, 5, 7, 6, 0, -7}, // 0x38 '8'
+  {  88, 5, 7, 6, 0, -7}, // 0x39 '9'
+  {  93, 2, 5, 6, 1, -6}, // 0x3A ':'
+  {  95, 2, 6, 6, 1, -6}, // 0x3B ';'
+  {  97, 4, 7, 6, 0, -7}, // 0x3C '<'
+  { 101, 5, 3, 6, 0, -5}, // 0x3D '='
+  { 103, 4, 7, 6, 1, -7}, // 0x3E '>'
+  { 107, 5, 7, 6, 0, -7}, // 0x3F '?'
+  { 112, 5, 7, 6, 0, -7}, // 0x40 '@'
+  { 117, 5, 7, 6, 0, -7}, // 0x41 'A'
+  { 122, 5, 7, 6, 0, -7}, // 0x42 'B'
+  { 127, 5, 7, 6, 0, -7}, // 0x43 'C'
+  { 132, 5, 7, 6, 0, -7}, // 0x44 'D'
+  { 137, 5, 7, 6, 0, -7}, // 0x45 'E'
+  { 142, 5, 7, 6, 0, -7}, // 0x46 'F'
+  { 147, 5, 7, 6, 0, -7}, // 0x47 'G'
+  { 152, 5, 7, 6, 0, -7}, // 0x48 'H'
+  { 157, 3, 7, 6, 1, -7}, // 0x49 'I'
+  { 160, 5, 7, 6, 0, -7}, // 0x4A 'J'
+  { 165, 5, 7, 6, 0, -7}, // 0x4B 'K'
+  { 170, 5, 7, 6, 0, -7}, // 0x4C 'L'
+  { 175, 5, 7, 6, 0, -7}, // 0x4D 'M'
+  { 180, 5, 7, 6, 0, -7}, // 0x4E 'N'
+  { 185, 5, 7, 6, 0, -7}, // 0x4F 'O'
+  { 190, 5, 7, 6, 0, -7}, // 0x50 'P'
+  { 195, 5, 7, 6, 0, -7}, // 0x51 'Q'
+  { 200, 5, 7, 6, 0, -7}, // 0x52 'R'
+  { 205, 5, 7, 6, 0, -7}, // 0x53 'S'
+  { 210, 5, 7, 6, 0, -7}, // 0x54 'T'
+  { 215, 5, 7, 6, 0, -7}, // 0x55 'U'
+  { 220, 5, 7, 6, 0, -7}, // 0x56 'V'
+  { 225, 5, 7, 6, 0, -7}, // 0x57 'W'
+  { 230, 5, 7, 6, 0, -7}, // 0x58 'X'
+  { 235, 5, 7, 6, 0, -7}, // 0x59 'Y'
+  { 240, 5, 7, 6, 0, -7}, // 0x5A 'Z'
+  { 245, 3, 7, 6, 1, -7}, // 0x5B '['
+  { 248, 5, 5, 6, 0, -6}, // 0x5C
+  { 252, 3, 7, 6, 1, -7}, // 0x5D ']'
+  { 255, 5, 3, 6, 0, -7}, // 0x5E '^'
+  { 257, 5, 1, 6, 0, -1}, // 0x5F '_'
+  { 258, 3, 3, 6, 1, -7}, // 0x60 '`'
+  { 260, 5, 5, 6, 0, -5}, // 0x61 'a'
+  { 264, 5, 7, 6, 0, -7}, // 0x62 'b'
+  { 269, 5, 5, 6, 0, -5}, // 0x63 'c'
+  { 273, 5, 7, 6, 0, -7}, // 0x64 'd'
+  { 278, 5, 5, 6, 0, -5}, // 0x65 'e'
+  { 282, 5, 7, 6, 0, -7}, // 0x66 'f'
+  { 287, 5, 6, 6, 0, -6}, // 0x67 'g'
+  { 291, 5, 7, 6, 0, -7}, // 0x68 'h'
+  { 296, 3, 7, 6, 1, -7}, // 0x69 'i'
+  { 299, 4, 7, 6, 0, -7}, // 0x6A 'j'
+  { 303, 4, 7, 6, 0, -7}, // 0x6B 'k'
+  { 307, 3, 7, 6, 1, -7}, // 0x6C 'l'
+  { 310, 5, 5, 6, 0, -5}, // 0x6D 'm'
+  { 314, 5, 5, 6, 0, -5}, // 0x6E 'n'
+  { 318, 5, 5, 6, 0, -5}, // 0x6F 'o'
+  { 322, 5, 5, 6, 0, -5}, // 0x70 'p'
+  { 326, 5, 5, 6, 0, -5}, // 0x71 'q'
+  { 330, 5, 5, 6, 0, -5}, // 0x72 'r'
+  { 334, 5, 5, 6, 0, -5}, // 0x73 's'
+  { 338, 5, 7, 6, 0, -7}, // 0x74 't'
+  { 343, 5, 5, 6, 0, -5}, // 0x75 'u'
+  { 347, 5, 5, 6, 0, -5}, // 0x76 'v'
+  { 351, 5, 5, 6, 0, -5}, // 0x77 'w'
+  { 355, 5, 5, 6, 0, -5}, // 0x78 'x'
+  { 359, 5, 5, 6, 0, -5}, // 0x79 'y'
+  { 363, 5, 5, 6, 0, -5}, // 0x7A 'z'
+  { 367, 3, 7, 6, 1, -7}, // 0x7B '{'
+  { 370, 1, 7, 6, 2, -7}, // 0x7C '|'
+  { 371, 3, 7, 6, 1, -7}, // 0x7D '}'
+  { 374, 5, 3, 6, 0, -5}  // 0x7E '~'
+};
+
+const GFX2DFONT_font_t GFX2DFONT_DEFAULT_FONT =
+{
+  (uint8_t*)SIM_GFX2D_FONT_BITMAP,
+  (GFX2DFONT_glyph_t*)SIM_GFX2D_FONT_GLYPHS,
+  0x20,
+  0x7E,
+  8
+};
+
+/*******************************************************************************
+ * Canvas access
+ ******************************************************************************/
+
+/*
+ * Writes a formatted pixel at canvas coordinates which are known to be within
+ * the canvas. Byte-aligned pixels are stored little-endian, others are packed
+ * most significant bit first.
+ */
+
+static void SIM_gfx2d_write(GFX2D_instance_t* instance, int32_t x, int32_t y, uint32_t pixel)
+{
+  if (instance->flags.byte_aligned)
+  {
+    uint8_t* destination = &instance->display_buffer[((uint32_t)y * (uint32_t)instance->canvas_width + (uint32_t)x) *
+                                                     instance->bytes_per_pixel];
+
+    for (uint8_t i = 0; i < instance->bytes_per_pixel; i++)
+    {
+      destination[i] = (uint8_t)(pixel >> (8U * i));
+    }
+
+    return;
+  }
+
+  uint32_t bit = (uint32_t)y * instance->canvas_bits_per_row + (uint32_t)x * instance->bits_per_pixel;
+
+  for (uint8_t i = instance->bits_per_pixel; i > 0; i--, bit++)
+  {
+    uint8_t mask = (uint8_t)(0x80U >> (bit & 7U));
+
+    if ((pixel >> (i - 1U)) & 1U)
+    {
+      instance->display_buffer[bit >> 3] |= mask;
+    }
+    else
+    {
+      instance->display_buffer[bit >> 3] &= (uint8_t)~mask;
+    }
+  }
+}
+
+static void SIM_gfx2d_canvas_fill(void* instance, uint32_t color)
+{
+  GFX2D_instance_t* gfx = (GFX2D_instance_t*)instance;
+
+  for (int32_t y = 0; y < gfx->canvas_height; y++)
+  {
+    for (int32_t x = 0; x < gfx->canvas_width; x++)
+    {
+      SIM_gfx2d_write(gfx, x, y, color);
+    }
+  }
+}
+
+static void SIM_gfx2d_draw_filled_rectangle(void* instance,
+                                            int16_t x,
+                                            int16_t y,
+                                            int16_t width,
+                                            int16_t height,
+                                            uint32_t color)
+{
+  for (int32_t row = y; row < y + height; row++)
+  {
+    for (int32_t column = x; column < x + width; column++)
+    {
+      SIM_gfx2d_write((GFX2D_instance_t*)instance, column, row, color);
+    }
+  }
+}
+
+static void SIM_gfx2d_draw_hline(void* instance, int16_t x, int16_t y, int16_t length, uint32_t color)
+{
+  SIM_gfx2d_draw_filled_rectangle(instance, x, y, length, 1, color);
+}
+
+static void SIM_gfx2d_draw_vline(void* instance, int16_t x, int16_t y, int16_t length, uint32_t color)
+{
+  SIM_gfx2d_draw_filled_rectangle(instance, x, y, 1, length, color);
+}
+
+/*
+ * Fills a rectangle given in target display coordinates with a formatted
+ * pixel. The rectangle is mapped through the inversion, trimmed to the canvas
+ * and passed to the handlers in canvas coordinates.
+ */
+
+static void SIM_gfx2d_fill(GFX2D_instance_t* instance,
+                           int32_t x,
+                           int32_t y,
+                           int32_t width,
+                           int32_t height,
+                           uint32_t pixel)
+{
+  if (width < 0)
+  {
+    x += width + 1;
+    width = -width;
+  }
+
+  if (height < 0)
+  {
+    y += height + 1;
+    height = -height;
+  }
+
+  if (instance->flags.invert)
+  {
+    x = instance->display_target_width - x - width;
+    y = instance->display_target_height - y - height;
+  }
+
+  int32_t left = UTILS_MAX(x - instance->canvas_x0, 0);
+  int32_t top = UTILS_MAX(y - instance->canvas_y0, 0);
+  int32_t right = UTILS_MIN(x - instance->canvas_x0 + width, (int32_t)instance->canvas_width);
+  int32_t bottom = UTILS_MIN(y - instance->canvas_y0 + height, (int32_t)instance->canvas_height);
+
+  if ((right <= left) || (bottom <= top))
+  {
+    return;
+  }
+
+  if (bottom - top == 1)
+  {
+    instance->draw_hline_handler(instance, (int16_t)left, (int16_t)top, (int16_t)(right - left), pixel);
+  }
+  else if (right - left == 1)
+  {
+    instance->draw_vline_handler(instance, (int16_t)left, (int16_t)top, (int16_t)(bottom - top), pixel);
+  }
+  else
+  {
+    instance->draw_filled_rectangle_handler(instance,
+                                            (int16_t)left,
+                                            (int16_t)top,
+                                            (int16_t)(right - left),
+                                            (int16_t)(bottom - top),
+                                            pixel);
+  }
+}
+
+static bool SIM_gfx2d_plot(GFX2D_instance_t* instance, int32_t x, int32_t y, uint32_t pixel)
+{
+  if (instance->flags.invert)
+  {
+    x = instance->display_target_width - 1 - x;
+    y = instance->display_target_height - 1 - y;
+  }
+
+  x -= instance->canvas_x0;
+  y -= instance->canvas_y0;
+
+  if ((x < 0) || (y < 0) || (x >= instance->canvas_width) || (y >= instance->canvas_height))
+  {
+    return false;
+  }
+
+  SIM_gfx2d_write(instance, x, y, pixel);
+
+  return true;
+}
+
+/*******************************************************************************
+ * Shapes
+ ******************************************************************************/
+
+static void SIM_gfx2d_line(GFX2D_instance_t* instance,
+                           int32_t x0,
+                           int32_t y0,
+                           int32_t x1,
+                           int32_t y1,
+                           uint32_t pixel)
+{
+  if (y0 == y1)
+  {
+    SIM_gfx2d_fill(instance, UTILS_MIN(x0, x1), y0, abs(x1 - x0) + 1, 1, pixel);
+    return;
+  }
+
+  if (x0 == x1)
+  {
+    SIM_gfx2d_fill(instance, x0, UTILS_MIN(y0, y1), 1, abs(y1 - y0) + 1, pixel);
+    return;
+  }
+
+  int32_t dx = abs(x1 - x0);
+  int32_t dy = -abs(y1 - y0);
+  int32_t step_x = (x0 < x1) ? 1 : -1;
+  int32_t step_y = (y0 < y1) ? 1 : -1;
+  int32_t error = dx + dy;
+
+  for (;;)
+  {
+    SIM_gfx2d_plot(instance, x0, y0, pixel);
+
+    if ((x0 == x1) && (y0 == y1))
+    {
+      break;
+    }
+
+    int32_t error2 = 2 * error;
+
+    if (error2 >= dy)
+    {
+      error += dy;
+      x0 += step_x;
+    }
+
+    if (error2 <= dx)
+    {
+      error += dx;
+      y0 += step_y;
+    }
+  }
+}
+
+/*
+ * Midpoint circle. Draws the selected quadrants of the outline, or fills them
+ * with vertical spans from the horizontal axis out to the outline.
+ */
+
+static void SIM_gfx2d_arc(GFX2D_instance_t* instance,
+                          int32_t x0,
+                          int32_t y0,
+                          int32_t radius,
+                          uint8_t quadrant,
+                          uint32_t pixel,
+                          bool filled)
+{
+  int32_t f = 1 - radius;
+  int32_t ddf_x = 1;
+  int32_t ddf_y = -2 * radius;
+  int32_t x = 0;
+  int32_t y = radius;
+
+  for (;;)
+  {
+    if (filled)
+    {
+      if (quadrant & GFX2D_CIRCLE_QUADRANT_TOP_LEFT)
+      {
+        SIM_gfx2d_fill(instance, x0 - x, y0 - y, 1, y + 1, pixel);
+        SIM_gfx2d_fill(instance, x0 - y, y0 - x, 1, x + 1, pixel);
+      }
+
+      if (quadrant & GFX2D_CIRCLE_QUADRANT_TOP_RIGHT)
+      {
+        SIM_gfx2d_fill(instance, x0 + x, y0 - y, 1, y + 1, pixel);
+        SIM_gfx2d_fill(instance, x0 + y, y0 - x, 1, x + 1, pixel);
+      }
+
+      if (quadrant & GFX2D_CIRCLE_QUADRANT_BOTTOM_LEFT)
+      {
+        SIM_gfx2d_fill(instance, x0 - x, y0, 1, y + 1, pixel);
+        SIM_gfx2d_fill(instance, x0 - y, y0, 1, x + 1, pixel);
+      }
+
+      if (quadrant & GFX2D_CIRCLE_QUADRANT_BOTTOM_RIGHT)
+      {
+        SIM_gfx2d_fill(instance, x0 + x, y0, 1, y + 1, pixel);
+        SIM_gfx2d_fill(instance, x0 + y, y0, 1, x + 1, pixel);
+      }
+    }
+    else
+    {
+      if (quadrant & GFX2D_CIRCLE_QUADRANT_TOP_LEFT)
+      {
+        SIM_gfx2d_plot(instance, x0 - x, y0 - y, pixel);
+        SIM_gfx2d_plot(instance, x0 - y, y0 - x, pixel);
+      }
+
+      if (quadrant & GFX2D_CIRCLE_QUADRANT_TOP_RIGHT)
+      {
+        SIM_gfx2d_plot(instance, x0 + x, y0 - y, pixel);
+        SIM_gfx2d_plot(instance, x0 + y, y0 - x, pixel);
+      }
+
+      if (quadrant & GFX2D_CIRCLE_QUADRANT_BOTTOM_LEFT)
+      {
+        SIM_gfx2d_plot(instance, x0 - x, y0 + y, pixel);
+        SIM_gfx2d_plot(instance, x0 - y, y0 + x, pixel);
+      }
+
+      if (quadrant & GFX2D_CIRCLE_QUADRANT_BOTTOM_RIGHT)
+      {
+        SIM_gfx2d_plot(instance, x0 + x, y0 + y, pixel);
+        SIM_gfx2d_plot(instance, x0 + y, y0 + x, pixel);
+      }
+    }
+
+    if (x >= y)
+    {
+      break;
+    }
+
+    if (f >= 0)
+    {
+      y--;
+      ddf_y += 2;
+      f += ddf_y;
+    }
+
+    x++;
+    ddf_x += 2;
+    f += ddf_x;
+  }
+}
+
+static int32_t SIM_gfx2d_corner_radius(int32_t width, int32_t height, int32_t radius)
+{
+  return UTILS_MIN(abs(radius), UTILS_MIN(width, height) / 2);
+}
+
+/*
+ * Converts a bitmap pixel to a GFX2D_rgba_t.
+ */
+
+static uint32_t SIM_gfx2d_bitmap_rgba(GFX2D_rgb_bitmap_t rgb_bitmap, const uint8_t* bitmap, uint32_t index)
+{
+  GFX2D_rgba_t rgba;
+
+  rgba.all = 0;
+  rgba.a = 0xFF;
+
+  switch (rgb_bitmap)
+  {
+    case GFX2D_RGB_BITMAP_332:
+    {
+      uint8_t value = bitmap[index];
+
+      rgba.r = (uint8_t)(value & 0xE0U);
+      rgba.g = (uint8_t)((value << 3) & 0xE0U);
+      rgba.b = (uint8_t)((value << 6) & 0xC0U);
+      break;
+    }
+
+    case GFX2D_RGB_BITMAP_565:
+    {
+      uint16_t value = (uint16_t)(bitmap[2U * index] | (bitmap[2U * index + 1U] << 8));
+
+      rgba.r = (uint8_t)((value >> 8) & 0xF8U);
+      rgba.g = (uint8_t)((value >> 3) & 0xFCU);
+      rgba.b = (uint8_t)(value << 3);
+      break;
+    }
+
+    default:
+      rgba.r = bitmap[3U * index];
+      rgba.g = bitmap[3U * index + 1U];
+      rgba.b = bitmap[3U * index + 2U];
+      break;
+  }
+
+  return rgba.all;
+}
+
+static bool SIM_gfx2d_bit(const uint8_t* bits, uint32_t index)
+{
+  return (bits[index >> 3] & (0x80U >> (index & 7U))) != 0;
+}
+
+/*******************************************************************************
+ * Interface
+ ******************************************************************************/
+
+void GFX2D_initialize(GFX2D_instance_t* instance,
+                      uint8_t* display_buffer,
+                      uint32_t display_buffer_length_bytes,
+                      int16_t display_target_width,
+                      int16_t display_target_height,
+                      uint8_t bits_per_pixel,
+                      GFX2D_rgba_to_pixel_t rgba_to_pixel)
+{
+  UTILITIES_memclear(instance, sizeof(GFX2D_instance_t));
+
+  instance->flags.byte_aligned = ((bits_per_pixel % 8U) == 0) ? 1U : 0U;
+  instance->bits_per_pixel = bits_per_pixel;
+  instance->bytes_per_pixel = (uint8_t)(bits_per_pixel / 8U);
+  instance->display_buffer = display_buffer;
+  instance->display_buffer_length_bytes = display_buffer_length_bytes;
+  instance->display_buffer_length_pixels = (display_buffer_length_bytes * 8U) / bits_per_pixel;
+  instance->display_target_width = display_target_width;
+  instance->display_target_height = display_target_height;
+  instance->font.font = (GFX2DFONT_font_t*)&GFX2DFONT_DEFAULT_FONT;
+  instance->font.color = 0xFFFFFFFFU;
+  instance->font.x_magnification = 1;
+  instance->font.y_magnification = 1;
+  instance->rgba_to_pixel = rgba_to_pixel;
+  instance->canvas_fill_handler = SIM_gfx2d_canvas_fill;
+  instance->draw_hline_handler = SIM_gfx2d_draw_hline;
+  instance->draw_vline_handler = SIM_gfx2d_draw_vline;
+  instance->draw_filled_rectangle_handler = SIM_gfx2d_draw_filled_rectangle;
+
+  GFX2D_set_canvas_dimensions(instance, 0, 0, 1, 1);
+}
+
+bool GFX2D_set_canvas_dimensions(GFX2D_instance_t* instance,
+                                 int16_t canvas_x0,
+                                 int16_t canvas_y0,
+                                 int16_t canvas_width,
+                                 int16_t canvas_height)
+{
+  canvas_width = (int16_t)UTILS_MIN(canvas_width, instance->display_target_width - canvas_x0);
+  canvas_height = (int16_t)UTILS_MIN(canvas_height, instance->display_target_height - canvas_y0);
+
+  bool fits = (canvas_width > 0) && (canvas_height > 0) &&
+              ((uint32_t)canvas_width * (uint32_t)canvas_height <= instance->display_buffer_length_pixels);
+
+  if (!fits)
+  {
+    canvas_width = 1;
+    canvas_height = 1;
+  }
+
+  instance->canvas_x0 = canvas_x0;
+  instance->canvas_y0 = canvas_y0;
+  instance->canvas_width = canvas_width;
+  instance->canvas_height = canvas_height;
+  instance->canvas_bits_per_row = (uint32_t)canvas_width * instance->bits_per_pixel;
+  instance->canvas_bytes_per_row = (uint32_t)canvas_width * instance->bytes_per_pixel;
+  instance->canvas_length_pixels = (uint32_t)canvas_width * (uint32_t)canvas_height;
+  instance->canvas_length_bytes = (instance->canvas_length_pixels * instance->bits_per_pixel + 7U) / 8U;
+
+  return fits;
+}
+
+bool GFX2D_draw_pixel(GFX2D_instance_t* instance,
+                      int16_t x,
+                      int16_t y,
+                      uint32_t color)
+{
+  return SIM_gfx2d_plot(instance, x, y, instance->rgba_to_pixel(color));
+}
+
+void GFX2D_fill_canvas(GFX2D_instance_t* instance, uint32_t color)
+{
+  instance->canvas_fill_handler(instance, instance->rgba_to_pixel(color));
+}
+
+void GFX2D_draw_hline(GFX2D_instance_t* instance,
+                      int16_t x,
+                      int16_t y,
+                      int16_t length,
+                      uint32_t color)
+{
+  SIM_gfx2d_fill(instance, x, y, length, 1, instance->rgba_to_pixel(color));
+}
+
+void GFX2D_draw_vline(GFX2D_instance_t* instance,
+                      int16_t x,
+                      int16_t y,
+                      int16_t length,
+                      uint32_t color)
+{
+  SIM_gfx2d_fill(instance, x, y, 1, length, instance->rgba_to_pixel(color));
+}
+
+void GFX2D_draw_line(GFX2D_instance_t* instance,
+                     int16_t x0,
+                     int16_t y0,
+                     int16_t x1,
+                     int16_t y1,
+                     uint32_t color)
+{
+  SIM_gfx2d_line(instance, x0, y0, x1, y1, instance->rgba_to_pixel(color));
+}
+
+void GFX2D_draw_triangle(GFX2D_instance_t* instance,
+                         int16_t x0,
+                         int16_t y0,
+                         int16_t x1,
+                         int16_t y1,
+                         int16_t x2,
+                         int16_t y2,
+                         uint32_t color)
+{
+  uint32_t pixel = instance->rgba_to_pixel(color);
+
+  SIM_gfx2d_line(instance, x0, y0, x1, y1, pixel);
+  SIM_gfx2d_line(instance, x1, y1, x2, y2, pixel);
+  SIM_gfx2d_line(instance, x2, y2, x0, y0, pixel);
+}
+
+void GFX2D_draw_filled_triangle(GFX2D_instance_t* instance,
+                                int16_t x0,
+                                int16_t y0,
+                                int16_t x1,
+                                int16_t y1,
+                                int16_t x2,
+                                int16_t y2,
+                                uint32_t color)
+{
+  uint32_t pixel = instance->rgba_to_pixel(color);
+  int32_t points[3][2] = { { x0, y0 }, { x1, y1 }, { x2, y2 } };
+
+  // Sort by y, then fill one span per row between the long edge (0 to 2)
+  // and the two short edges.
+
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    for (uint8_t j = 0; j < (uint8_t)(2U - i); j++)
+    {
+      if (points[j][1] > points[j + 1][1])
+      {
+        int32_t swap_x = points[j][0];
+        int32_t swap_y = points[j][1];
+
+        points[j][0] = points[j + 1][0];
+        points[j][1] = points[j + 1][1];
+        points[j + 1][0] = swap_x;
+        points[j + 1][1] = swap_y;
+      }
+    }
+  }
+
+  int32_t top = points[0][1];
+  int32_t bottom = points[2][1];
+
+  if (top == bottom)
+  {
+    int32_t left = UTILS_MIN(points[0][0], UTILS_MIN(points[1][0], points[2][0]));
+    int32_t right = UTILS_MAX(points[0][0], UTILS_MAX(points[1][0], points[2][0]));
+
+    SIM_gfx2d_fill(instance, left, top, right - left + 1, 1, pixel);
+    return;
+  }
+
+  for (int32_t y = top; y <= bottom; y++)
+  {
+    int32_t a = points[0][0] + (points[2][0] - points[0][0]) * (y - top) / (bottom - top);
+    int32_t b;
+
+    if ((y < points[1][1]) || (points[1][1] == bottom))
+    {
+      b = (points[1][1] == top) ? points[1][0] :
+          points[0][0] + (points[1][0] - points[0][0]) * (y - top) / (points[1][1] - top);
+    }
+    else
+    {
+      b = points[1][0] + (points[2][0] - points[1][0]) * (y - points[1][1]) / (bottom - points[1][1]);
+    }
+
+    SIM_gfx2d_fill(instance, UTILS_MIN(a, b), y, abs(b - a) + 1, 1, pixel);
+  }
+}
+
+void GFX2D_draw_circle_arc(GFX2D_instance_t* instance,
+                           int16_t x0,
+                           int16_t y0,
+                           int16_t radius,
+                           GFX2D_circle_quadrant_t quadrant,
+                           uint32_t color)
+{
+  SIM_gfx2d_arc(instance, x0, y0, abs(radius), (uint8_t)quadrant, instance->rgba_to_pixel(color), false);
+}
+
+void GFX2D_draw_filled_circle_arc(GFX2D_instance_t* instance,
+                                  int16_t x0,
+                                  int16_t y0,
+                                  int16_t radius,
+                                  GFX2D_circle_quadrant_t quadrant,
+                                  uint32_t color)
+{
+  SIM_gfx2d_arc(instance, x0, y0, abs(radius), (uint8_t)quadrant, instance->rgba_to_pixel(color), true);
+}
+
+void GFX2D_draw_circle(GFX2D_instance_t* instance,
+                       int16_t x0,
+                       int16_t y0,
+                       int16_t radius,
+                       uint32_t color)
+{
+  GFX2D_draw_circle_arc(instance, x0, y0, radius, GFX2D_CIRCLE_QUADRANT_ALL, color);
+}
+
+void GFX2D_draw_filled_circle(GFX2D_instance_t* instance,
+                              int16_t x0,
+                              int16_t y0,
+                              int16_t radius,
+                              uint32_t color)
+{
+  GFX2D_draw_filled_circle_arc(instance, x0, y0, radius, GFX2D_CIRCLE_QUADRANT_ALL, color);
+}
+
+void GFX2D_draw_rectangle(GFX2D_instance_t* instance,
+                          int16_t x,
+                          int16_t y,
+                          int16_t width,
+                          int16_t height,
+                          uint32_t color)
+{
+  uint32_t pixel = instance->rgba_to_pixel(color);
+  int32_t left = (width < 0) ? x + width + 1 : x;
+  int32_t top = (height < 0) ? y + height + 1 : y;
+  int32_t w = abs(width);
+  int32_t h = abs(height);
+
+  if ((w == 0) || (h == 0))
+  {
+    return;
+  }
+
+  SIM_gfx2d_fill(instance, left, top, w, 1, pixel);
+  SIM_gfx2d_fill(instance, left, top + h - 1, w, 1, pixel);
+  SIM_gfx2d_fill(instance, left, top, 1, h, pixel);
+  SIM_gfx2d_fill(instance, left + w - 1, top, 1, h, pixel);
+}
+
+void GFX2D_draw_filled_rectangle(GFX2D_instance_t* instance,
+                                 int16_t x,
+                                 int16_t y,
+                                 int16_t width,
+                                 int16_t height,
+                                 uint32_t color)
+{
+  SIM_gfx2d_fill(instance, x, y, width, height, instance->rgba_to_pixel(color));
+}
+
+void GFX2D_draw_rounded_rectangle(GFX2D_instance_t* instance,
+                                  int16_t x,
+                                  int16_t y,
+                                  int16_t width,
+                                  int16_t height,
+                                  int16_t radius,
+                                  uint32_t color)
+{
+  uint32_t pixel = instance->rgba_to_pixel(color);
+  int32_t left = (width < 0) ? x + width + 1 : x;
+  int32_t top = (height < 0) ? y + height + 1 : y;
+  int32_t w = abs(width);
+  int32_t h = abs(height);
+  int32_t r = SIM_gfx2d_corner_radius(w, h, radius);
+
+  if ((w == 0) || (h == 0))
+  {
+    return;
+  }
+
+  SIM_gfx2d_fill(instance, left + r, top, w - 2 * r, 1, pixel);
+  SIM_gfx2d_fill(instance, left + r, top + h - 1, w - 2 * r, 1, pixel);
+  SIM_gfx2d_fill(instance, left, top + r, 1, h - 2 * r, pixel);
+  SIM_gfx2d_fill(instance, left + w - 1, top + r, 1, h - 2 * r, pixel);
+
+  SIM_gfx2d_arc(instance, left + r, top + r, r, GFX2D_CIRCLE_QUADRANT_TOP_LEFT, pixel, false);
+  SIM_gfx2d_arc(instance, left + w - r - 1, top + r, r, GFX2D_CIRCLE_QUADRANT_TOP_RIGHT, pixel, false);
+  SIM_gfx2d_arc(instance, left + r, top + h - r - 1, r, GFX2D_CIRCLE_QUADRANT_BOTTOM_LEFT, pixel, false);
+  SIM_gfx2d_arc(instance, left + w - r - 1, top + h - r - 1, r, GFX2D_CIRCLE_QUADRANT_BOTTOM_RIGHT, pixel, false);
+}
+
+void GFX2D_draw_filled_rounded_rectangle(GFX2D_instance_t* instance,
+                                         int16_t x,
+                                         int16_t y,
+                                         int16_t width,
+                                         int16_t height,
+                                         int16_t radius,
+                                         uint32_t color)
+{
+  uint32_t pixel = instance->rgba_to_pixel(color);
+  int32_t left = (width < 0) ? x + width + 1 : x;
+  int32_t top = (height < 0) ? y + height + 1 : y;
+  int32_t w = abs(width);
+  int32_t h = abs(height);
+  int32_t r = SIM_gfx2d_corner_radius(w, h, radius);
+
+  if ((w == 0) || (h == 0))
+  {
+    return;
+  }
+
+  SIM_gfx2d_fill(instance, left + r, top, w - 2 * r, h, pixel);
+  SIM_gfx2d_fill(instance, left, top + r, r, h - 2 * r, pixel);
+  SIM_gfx2d_fill(instance, left + w - r, top + r, r, h - 2 * r, pixel);
+
+  SIM_gfx2d_arc(instance, left + r, top + r, r, GFX2D_CIRCLE_QUADRANT_TOP_LEFT, pixel, true);
+  SIM_gfx2d_arc(instance, left + w - r - 1, top + r, r, GFX2D_CIRCLE_QUADRANT_TOP_RIGHT, pixel, true);
+  SIM_gfx2d_arc(instance, left + r, top + h - r - 1, r, GFX2D_CIRCLE_QUADRANT_BOTTOM_LEFT, pixel, true);
+  SIM_gfx2d_arc(instance, left + w - r - 1, top + h - r - 1, r, GFX2D_CIRCLE_QUADRANT_BOTTOM_RIGHT, pixel, true);
+}
+
+void GFX2D_draw_binary_bitmap(GFX2D_instance_t* instance,
+                              const uint8_t* bitmap,
+                              int16_t x0,
+                              int16_t y0,
+                              uint16_t bitmap_x0,
+                              uint16_t bitmap_y0,
+                              uint16_t bitmap_width_draw,
+                              uint16_t bitmap_height_draw,
+                              uint16_t bitmap_width_total,
+                              uint16_t bitmap_height_total,
+                              uint32_t color,
+                              uint32_t background_color)
+{
+  uint32_t pixel = instance->rgba_to_pixel(color);
+  uint32_t background_pixel = instance->rgba_to_pixel(background_color);
+  bool transparent = (color == background_color);
+
+  // Bits are packed row after row, most significant bit first, without
+  // padding at the end of a row.
+
+  for (uint32_t row = 0; (row < bitmap_height_draw) && (bitmap_y0 + row < bitmap_height_total); row++)
+  {
+    for (uint32_t column = 0; (column < bitmap_width_draw) && (bitmap_x0 + column < bitmap_width_total); column++)
+    {
+      bool set = SIM_gfx2d_bit(bitmap, (bitmap_y0 + row) * bitmap_width_total + bitmap_x0 + column);
+
+      if (set || !transparent)
+      {
+        SIM_gfx2d_plot(instance, x0 + (int32_t)column, y0 + (int32_t)row, set ? pixel : background_pixel);
+      }
+    }
+  }
+}
+
+void GFX2D_draw_rgb_bitmap(GFX2D_instance_t* instance,
+                           GFX2D_rgb_bitmap_t rgb_bitmap,
+                           const uint8_t* bitmap,
+                           const uint8_t* alpha_mask,
+                           int16_t x0,
+                           int16_t y0,
+                           uint16_t bitmap_x0,
+                           uint16_t bitmap_y0,
+                           uint16_t bitmap_width_draw,
+                           uint16_t bitmap_height_draw,
+                           uint16_t bitmap_width_total,
+                           uint16_t bitmap_height_total)
+{
+  // 565 pixels are little-endian, 888 pixels are in R, G, B byte order.
+
+  for (uint32_t row = 0; (row < bitmap_height_draw) && (bitmap_y0 + row < bitmap_height_total); row++)
+  {
+    for (uint32_t column = 0; (column < bitmap_width_draw) && (bitmap_x0 + column < bitmap_width_total); column++)
+    {
+      uint32_t index = (bitmap_y0 + row) * bitmap_width_total + bitmap_x0 + column;
+
+      if ((alpha_mask == NULL) || SIM_gfx2d_bit(alpha_mask, index))
+      {
+        SIM_gfx2d_plot(instance,
+                       x0 + (int32_t)column,
+                       y0 + (int32_t)row,
+                       instance->rgba_to_pixel(SIM_gfx2d_bitmap_rgba(rgb_bitmap, bitmap, index)));
+      }
+    }
+  }
+}
+
+void GFX2D_set_text_magnification(GFX2D_instance_t* instance,
+                                  uint8_t x_magnification,
+                                  uint8_t y_magnification)
+{
+  instance->font.x_magnification = UTILS_MAX(x_magnification, 1U);
+  instance->font.y_magnification = UTILS_MAX(y_magnification, 1U);
+}
+
+void GFX2D_set_font(GFX2D_instance_t* instance, GFX2DFONT_font_t* font)
+{
+  instance->font.font = (font != NULL) ? font : (GFX2DFONT_font_t*)&GFX2DFONT_DEFAULT_FONT;
+}
+
+void GFX2D_set_font_color(GFX2D_instance_t* instance, uint32_t color)
+{
+  instance->font.color = color;
+}
+
+void GFX2D_set_inverted(GFX2D_instance_t* instance, bool enable_inverted)
+{
+  instance->flags.invert = enable_inverted ? 1U : 0U;
+}
+
+void GFX2D_set_text_wrap(GFX2D_instance_t* instance, bool enable_wrap)
+{
+  instance->flags.wrap_text = enable_wrap ? 1U : 0U;
+}
+
+void GFX2D_draw_char(GFX2D_instance_t* instance, uint8_t c)
+{
+  GFX2DFONT_font_t* font = instance->font.font;
+  int32_t x_magnification = instance->font.x_magnification;
+  int32_t y_magnification = instance->font.y_magnification;
+
+  if (c == '\n')
+  {
+    instance->font.cursor_x = 0;
+    instance->font.cursor_y = (int16_t)(instance->font.cursor_y + font->y_advance * y_magnification);
+    return;
+  }
+
+  if ((c == '\r') || (c < font->first_ascii) || (c > font->last_ascii))
+  {
+    return;
+  }
+
+  GFX2DFONT_glyph_t* glyph = &font->glyph[c - font->first_ascii];
+
+  if (instance->flags.wrap_text &&
+      (instance->font.cursor_x + (glyph->x_offset + glyph->width) * x_magnification > instance->display_target_width))
+  {
+    instance->font.cursor_x = 0;
+    instance->font.cursor_y = (int16_t)(instance->font.cursor_y + font->y_advance * y_magnification);
+  }
+
+  uint32_t pixel = instance->rgba_to_pixel(instance->font.color);
+  uint32_t bit = (uint32_t)glyph->bitmap_offset * 8U;
+
+  for (int32_t row = 0; row < glyph->height; row++)
+  {
+    for (int32_t column = 0; column < glyph->width; column++, bit++)
+    {
+      if (SIM_gfx2d_bit(font->bitmap, bit))
+      {
+        SIM_gfx2d_fill(instance,
+                       instance->font.cursor_x + (glyph->x_offset + column) * x_magnification,
+                       instance->font.cursor_y + (glyph->y_offset + row) * y_magnification,
+                       x_magnification,
+                       y_magnification,
+                       pixel);
+      }
+    }
+  }
+
+  instance->font.cursor_x = (int16_t)(instance->font.cursor_x + glyph->x_advance * x_magnification);
+}
@@ -0,0 +1,264 @@
+#include "JLibSim.h"
+
+/*******************************************************************************
+ *
+ *  Virtual I2C bus with register file slaves.
+ *
+ ******************************************************************************/
+
+static struct
+{
+  SIM_i2c_slave_t* slaves;
+  SIM_i2c_slave_t* active;
+  uint32_t clock_hz;
+  bool expect_address;
+  bool read_mode;
+  uint8_t pointer_bytes;
+  bool ack_received;
+  bool nak_received;
+  bool rx_ready;
+  uint8_t rx_value;
+  bool error_collision;
+  bool error_rx_overflow;
+  bool error_other;
+}
+SIM_i2c;
+
+static void SIM_i2c_clock_byte(void)
+{
+  // Eight data bits and the acknowledge bit.
+
+  if (SIM_i2c.clock_hz != 0)
+  {
+    SIM_timer_advance_ns(9000000000ULL / SIM_i2c.clock_hz);
+  }
+}
+
+static SIM_i2c_slave_t* SIM_i2c_find(uint8_t address)
+{
+  for (SIM_i2c_slave_t* slave = SIM_i2c.slaves; slave != NULL; slave = (SIM_i2c_slave_t*)slave->next_slave)
+  {
+    if (slave->address == address)
+    {
+      return slave;
+    }
+  }
+
+  return NULL;
+}
+
+static void SIM_i2c_condition(void)
+{
+  SIM_i2c.expect_address = true;
+  SIM_i2c.active = NULL;
+  SIM_i2c.rx_ready = false;
+}
+
+void SIM_i2c_initialize(uint32_t clock_hz)
+{
+  UTILITIES_memclear(&SIM_i2c, sizeof(SIM_i2c));
+
+  SIM_i2c.clock_hz = clock_hz;
+}
+
+void SIM_i2c_attach(SIM_i2c_slave_t* slave,
+                    uint8_t address,
+                    uint8_t* registers,
+                    uint16_t register_count,
+                    uint8_t pointer_length)
+{
+  UTILS_ASSERT((register_count != 0) && (pointer_length >= 1) && (pointer_length <= 2));
+
+  slave->address = address;
+  slave->registers = registers;
+  slave->register_count = register_count;
+  slave->pointer_length = pointer_length;
+  slave->pointer = 0;
+  slave->next_slave = SIM_i2c.slaves;
+
+  SIM_i2c.slaves = slave;
+}
+
+void SIM_i2c_inject_errors(bool collision, bool rx_overflow, bool other)
+{
+  SIM_i2c.error_collision |= collision;
+  SIM_i2c.error_rx_overflow |= rx_overflow;
+  SIM_i2c.error_other |= other;
+}
+
+bool SIM_i2c_is_rx_ready(void)
+{
+  // The slave shifts out the next register when the master polls for it, so
+  // that no register is consumed ahead of the master.
+
+  if (!SIM_i2c.rx_ready && (SIM_i2c.active != NULL) && SIM_i2c.read_mode)
+  {
+    SIM_i2c_slave_t* slave = SIM_i2c.active;
+
+    SIM_i2c_clock_byte();
+
+    SIM_i2c.rx_value = slave->registers[slave->pointer];
+    SIM_i2c.rx_ready = true;
+    slave->pointer = (uint16_t)((slave->pointer + 1U) % slave->register_count);
+  }
+
+  return SIM_i2c.rx_ready;
+}
+
+bool SIM_i2c_is_tx_ready(void)
+{
+  return true;
+}
+
+uint8_t SIM_i2c_read_rx_register(void)
+{
+  if (!SIM_i2c_is_rx_ready())
+  {
+    return 0xFF;
+  }
+
+  SIM_i2c.rx_ready = false;
+
+  return SIM_i2c.rx_value;
+}
+
+void SIM_i2c_write_tx_register(uint8_t value)
+{
+  SIM_i2c_clock_byte();
+
+  if (SIM_i2c.expect_address)
+  {
+    SIM_i2c.expect_address = false;
+    SIM_i2c.active = SIM_i2c_find((uint8_t)(value >> 1));
+    SIM_i2c.read_mode = (value & 0x01U);
+    SIM_i2c.pointer_bytes = 0;
+    SIM_i2c.ack_received = (SIM_i2c.active != NULL);
+    SIM_i2c.nak_received = !SIM_i2c.ack_received;
+    return;
+  }
+
+  SIM_i2c_slave_t* slave = SIM_i2c.active;
+
+  if ((slave == NULL) || SIM_i2c.read_mode)
+  {
+    SIM_i2c.ack_received = false;
+    SIM_i2c.nak_received = true;
+    return;
+  }
+
+  if (SIM_i2c.pointer_bytes < slave->pointer_length)
+  {
+    slave->pointer = (SIM_i2c.pointer_bytes == 0) ? value : (uint16_t)((slave->pointer << 8) | value);
+    SIM_i2c.pointer_bytes++;
+
+    if (SIM_i2c.pointer_bytes == slave->pointer_length)
+    {
+      slave->pointer %= slave->register_count;
+    }
+  }
+  else
+  {
+    slave->registers[slave->pointer] = value;
+    slave->pointer = (uint16_t)((slave->pointer + 1U) % slave->register_count);
+  }
+
+  SIM_i2c.ack_received = true;
+  SIM_i2c.nak_received = false;
+}
+
+void SIM_i2c_send_start_condition(void)
+{
+  SIM_i2c_condition();
+}
+
+bool SIM_i2c_is_send_start_condition_completed(void)
+{
+  return true;
+}
+
+void SIM_i2c_send_restart_condition(void)
+{
+  SIM_i2c_condition();
+}
+
+bool SIM_i2c_is_send_restart_condition_completed(void)
+{
+  return true;
+}
+
+void SIM_i2c_send_stop_condition(void)
+{
+  SIM_i2c_condition();
+  SIM_i2c.expect_address = false;
+}
+
+bool SIM_i2c_is_send_stop_condition_completed(void)
+{
+  return true;
+}
+
+void SIM_i2c_send_ack(void)
+{
+}
+
+bool SIM_i2c_is_send_ack_completed(void)
+{
+  return true;
+}
+
+void SIM_i2c_send_nak(void)
+{
+  // The slave releases the bus after a NAK.
+
+  SIM_i2c.active = NULL;
+}
+
+bool SIM_i2c_is_send_nak_completed(void)
+{
+  return true;
+}
+
+bool SIM_i2c_is_ack_received(void)
+{
+  return SIM_i2c.ack_received;
+}
+
+bool SIM_i2c_error_check_nak_received(void)
+{
+  return SIM_i2c.nak_received;
+}
+
+bool SIM_i2c_error_check_collision(void)
+{
+  return SIM_i2c.error_collision;
+}
+
+bool SIM_i2c_error_check_rx_overflow(void)
+{
+  return SIM_i2c.error_rx_overflow;
+}
+
+bool SIM_i2c_error_check_other(void)
+{
+  return SIM_i2c.error_other;
+}
+
+void SIM_i2c_clear_errors(void)
+{
+  SIM_i2c.nak_received = false;
+  SIM_i2c.error_collision = false;
+  SIM_i2c.error_rx_overflow = false;
+  SIM_i2c.error_other = false;
+}
+
+void SIM_i2c_enable_rx(bool last_byte)
+{
+  (void)last_byte;
+}
+
+void SIM_i2c_new_task_reset(void)
+{
+  SIM_i2c.rx_ready = false;
+  SIM_i2c.ack_received = false;
+  SIM_i2c.nak_received = false;
+}
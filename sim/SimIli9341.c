@@ -0,0 +1,274 @@
+#include <stdio.h>
+
+#include "JLibSim.h"
+
+/*******************************************************************************
+ *
+ *  ILI9341 display model.
+ *
+ ******************************************************************************/
+
+#define SIM_ILI9341_SWRESET               0x01U
+#define SIM_ILI9341_SLPIN                 0x10U
+#define SIM_ILI9341_SLPOUT                0x11U
+#define SIM_ILI9341_DISPOFF               0x28U
+#define SIM_ILI9341_DISPON                0x29U
+#define SIM_ILI9341_CASET                 0x2AU
+#define SIM_ILI9341_PASET                 0x2BU
+#define SIM_ILI9341_RAMWR                 0x2CU
+#define SIM_ILI9341_MADCTL                0x36U
+
+static SIM_ili9341_t* SIM_ili9341_model;
+static void (*SIM_ili9341_dma_complete_callback)(void);
+static bool SIM_ili9341_dma_pending;
+
+static void SIM_ili9341_reset(SIM_ili9341_t* model)
+{
+  model->command = 0;
+  model->parameter_index = 0;
+  model->column_start = 0;
+  model->column_end = SIM_ILI9341_WIDTH - 1U;
+  model->page_start = 0;
+  model->page_end = SIM_ILI9341_HEIGHT - 1U;
+  model->column = 0;
+  model->page = 0;
+  model->pixel_pending = false;
+  model->sleeping = true;
+  model->display_on = false;
+  model->madctl = 0;
+}
+
+static void SIM_ili9341_write_pixel(SIM_ili9341_t* model, uint16_t pixel)
+{
+  if ((model->column < SIM_ILI9341_WIDTH) && (model->page < SIM_ILI9341_HEIGHT))
+  {
+    model->framebuffer[(uint32_t)model->page * SIM_ILI9341_WIDTH + model->column] = pixel;
+  }
+
+  model->pixel_count++;
+
+  if (model->column < model->column_end)
+  {
+    model->column++;
+    return;
+  }
+
+  model->column = model->column_start;
+  model->page = (model->page < model->page_end) ? (uint16_t)(model->page + 1U) : model->page_start;
+}
+
+static void SIM_ili9341_command(SIM_ili9341_t* model, uint8_t command)
+{
+  model->command = command;
+  model->parameter_index = 0;
+  model->pixel_pending = false;
+  model->command_count++;
+
+  switch (command)
+  {
+    case SIM_ILI9341_SWRESET:
+      SIM_ili9341_reset(model);
+      break;
+
+    case SIM_ILI9341_SLPIN:
+      model->sleeping = true;
+      break;
+
+    case SIM_ILI9341_SLPOUT:
+      model->sleeping = false;
+      break;
+
+    case SIM_ILI9341_DISPOFF:
+      model->display_on = false;
+      break;
+
+    case SIM_ILI9341_DISPON:
+      model->display_on = true;
+      break;
+
+    case SIM_ILI9341_RAMWR:
+      model->column = model->column_start;
+      model->page = model->page_start;
+      break;
+
+    default:
+      break;
+  }
+}
+
+static void SIM_ili9341_data(SIM_ili9341_t* model, uint8_t data)
+{
+  if (model->command == SIM_ILI9341_RAMWR)
+  {
+    if (!model->pixel_pending)
+    {
+      model->pixel_high = data;
+      model->pixel_pending = true;
+      return;
+    }
+
+    model->pixel_pending = false;
+    SIM_ili9341_write_pixel(model, (uint16_t)(((uint16_t)model->pixel_high << 8) | data));
+    return;
+  }
+
+  if (model->parameter_index < sizeof(model->parameters))
+  {
+    model->parameters[model->parameter_index] = data;
+  }
+
+  model->parameter_index++;
+
+  uint16_t first = (uint16_t)(((uint16_t)model->parameters[0] << 8) | model->parameters[1]);
+  uint16_t last = (uint16_t)(((uint16_t)model->parameters[2] << 8) | model->parameters[3]);
+
+  switch (model->command)
+  {
+    case SIM_ILI9341_CASET:
+      if (model->parameter_index == 4)
+      {
+        model->column_start = first;
+        model->column_end = last;
+      }
+      break;
+
+    case SIM_ILI9341_PASET:
+      if (model->parameter_index == 4)
+      {
+        model->page_start = first;
+        model->page_end = last;
+      }
+      break;
+
+    case SIM_ILI9341_MADCTL:
+      model->madctl = data;
+      break;
+
+    default:
+      break;
+  }
+}
+
+static void SIM_ili9341_select(void* model, bool selected)
+{
+  // A transaction ends with deselection, which drops a half pixel.
+
+  if (!selected)
+  {
+    ((SIM_ili9341_t*)model)->pixel_pending = false;
+  }
+}
+
+static uint8_t SIM_ili9341_exchange(void* model_pointer, uint8_t mosi)
+{
+  SIM_ili9341_t* model = (SIM_ili9341_t*)model_pointer;
+
+  if (model->data_mode)
+  {
+    SIM_ili9341_data(model, mosi);
+  }
+  else
+  {
+    SIM_ili9341_command(model, mosi);
+  }
+
+  return 0x00;
+}
+
+void SIM_ili9341_initialize(SIM_ili9341_t* model)
+{
+  UTILITIES_memclear(model, sizeof(SIM_ili9341_t));
+
+  model->device.select = SIM_ili9341_select;
+  model->device.exchange = SIM_ili9341_exchange;
+  model->device.model = model;
+
+  SIM_ili9341_reset(model);
+  SIM_ili9341_model = model;
+}
+
+bool SIM_ili9341_write_ppm(SIM_ili9341_t* model, const char* path)
+{
+  FILE* file = fopen(path, "wb");
+
+  if (file == NULL)
+  {
+    return false;
+  }
+
+  fprintf(file, "P6\n%u %u\n255\n", SIM_ILI9341_WIDTH, SIM_ILI9341_HEIGHT);
+
+  for (uint32_t index = 0; index < (SIM_ILI9341_WIDTH * SIM_ILI9341_HEIGHT); index++)
+  {
+    uint16_t pixel = model->framebuffer[index];
+    uint8_t rgb[3];
+
+    rgb[0] = (uint8_t)(((pixel >> 11) & 0x1FU) * 255U / 31U);
+    rgb[1] = (uint8_t)(((pixel >> 5) & 0x3FU) * 255U / 63U);
+    rgb[2] = (uint8_t)((pixel & 0x1FU) * 255U / 31U);
+
+    fwrite(rgb, 1, sizeof(rgb), file);
+  }
+
+  return (fclose(file) == 0);
+}
+
+void SIM_ili9341_set_dma_complete_callback(void (*callback)(void))
+{
+  SIM_ili9341_dma_complete_callback = callback;
+}
+
+bool SIM_ili9341_set_chip_select(bool enable)
+{
+  SIM_spi_select(enable ? &SIM_ili9341_model->device : NULL);
+
+  return true;
+}
+
+void SIM_ili9341_set_dc_select(bool enable)
+{
+  SIM_ili9341_model->data_mode = enable;
+}
+
+bool SIM_ili9341_configure_dma(void* src_addr, uint32_t src_length)
+{
+  // The transfer is clocked through the bus in bursts, so that it takes the
+  // same virtual time as on the wire.
+
+  uint8_t* source = (uint8_t*)src_addr;
+
+  while (src_length != 0)
+  {
+    uint32_t length = UTILS_MIN(src_length, SIM_SPI_BURST_LENGTH_MAX);
+
+    SIM_spi_burst_write_mosi_buffer(source, length);
+    SIM_spi_burst_start();
+
+    source += length;
+    src_length -= length;
+  }
+
+  SIM_ili9341_dma_pending = true;
+
+  return true;
+}
+
+void SIM_ili9341_disable_dma(void)
+{
+  SIM_ili9341_dma_pending = false;
+}
+
+void SIM_ili9341_dma_service(void)
+{
+  if (!SIM_ili9341_dma_pending)
+  {
+    return;
+  }
+
+  SIM_ili9341_dma_pending = false;
+
+  if (SIM_ili9341_dma_complete_callback != NULL)
+  {
+    SIM_ili9341_dma_complete_callback();
+  }
+}
@@ -0,0 +1,1149 @@
+#include "JLibSim.h"
+
+/*******************************************************************************
+ *
+ *  Library stand-ins.
+ *
+ ******************************************************************************/
+
+/*******************************************************************************
+ * UTILITIES
+ ******************************************************************************/
+
+void UTILITIES_assert(bool assertion)
+{
+  // Trapping, rather than looping, lets the sanitizers and debuggers report
+  // the failing call.
+
+  if (!assertion)
+  {
+    __builtin_trap();
+  }
+}
+
+void UTILITIES_memclear(void* start_addr, uint32_t length)
+{
+  UTILITIES_memset(start_addr, 0, length);
+}
+
+void UTILITIES_memset(void* start_addr, uint8_t value, uint32_t length)
+{
+  uint8_t* destination = (uint8_t*)start_addr;
+
+  while (length-- != 0)
+  {
+    *destination++ = value;
+  }
+}
+
+void UTILITIES_memcpy(void* dest_addr, void* src_addr, uint32_t length)
+{
+  uint8_t* destination = (uint8_t*)dest_addr;
+  uint8_t* source = (uint8_t*)src_addr;
+
+  while (length-- != 0)
+  {
+    *destination++ = *source++;
+  }
+}
+
+int8_t UTILITIES_memcmp(void* a_addr, void* b_addr, uint32_t length)
+{
+  uint8_t* a = (uint8_t*)a_addr;
+  uint8_t* b = (uint8_t*)b_addr;
+
+  for (uint32_t i = 0; i < length; i++)
+  {
+    if (a[i] != b[i])
+    {
+      return (a[i] < b[i]) ? -1 : 1;
+    }
+  }
+
+  return 0;
+}
+
+uint32_t UTILITIES_strlen(char* str)
+{
+  uint32_t length = 0;
+
+  while (str[length] != '\0')
+  {
+    length++;
+  }
+
+  return length;
+}
+
+uint32_t UTILITIES_strnlen(char* str, uint32_t length)
+{
+  uint32_t count = 0;
+
+  while ((count < length) && (str[count] != '\0'))
+  {
+    count++;
+  }
+
+  return count;
+}
+
+uint32_t UTILITIES_strncpy(char* dest_str, char* src_str, uint32_t n)
+{
+  uint32_t count = 0;
+
+  while ((count < n - 1U) && (src_str[count] != '\0'))
+  {
+    dest_str[count] = src_str[count];
+    count++;
+  }
+
+  dest_str[count] = '\0';
+
+  return count + 1U;
+}
+
+int8_t UTILITIES_strncmp(char* a_str, char* b_str, uint32_t length)
+{
+  for (uint32_t i = 0; i < length; i++)
+  {
+    uint8_t a = (uint8_t)a_str[i];
+    uint8_t b = (uint8_t)b_str[i];
+
+    if (a != b)
+    {
+      return (a < b) ? -1 : 1;
+    }
+
+    if (a == '\0')
+    {
+      break;
+    }
+  }
+
+  return 0;
+}
+
+uint64_t UTILITIES_absolute_value(int64_t value)
+{
+  return (value < 0) ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+}
+
+void UTILITIES_swap_byte_order(uint8_t* byte_ary, uint32_t length)
+{
+  for (uint32_t i = 0; i < length / 2U; i++)
+  {
+    uint8_t swap = byte_ary[i];
+
+    byte_ary[i] = byte_ary[length - 1U - i];
+    byte_ary[length - 1U - i] = swap;
+  }
+}
+
+bool UTILITIES_is_ascii_numeric(char value)
+{
+  return (value >= '0') && (value <= '9');
+}
+
+bool UTILITIES_is_ascii_alpha_lower(char value)
+{
+  return (value >= 'a') && (value <= 'z');
+}
+
+bool UTILITIES_is_ascii_alpha_upper(char value)
+{
+  return (value >= 'A') && (value <= 'Z');
+}
+
+bool UTILITIES_is_ascii_alpha_numeric(char value)
+{
+  return UTILITIES_is_ascii_alpha_lower(value) ||
+         UTILITIES_is_ascii_alpha_upper(value) ||
+         UTILITIES_is_ascii_numeric(value);
+}
+
+bool UTILITIES_is_ascii_hex_numeric(char value)
+{
+  return UTILITIES_is_ascii_numeric(value) ||
+         ((value >= 'a') && (value <= 'f')) ||
+         ((value >= 'A') && (value <= 'F'));
+}
+
+bool UTILITIES_is_ascii_binary_numeric(char value)
+{
+  return (value == '0') || (value == '1');
+}
+
+int64_t UTILITIES_parse_integer(char* input, uint8_t length)
+{
+  uint8_t i = 0;
+  bool negative = false;
+  uint8_t base = 10;
+  uint64_t value = 0;
+
+  // Skip to the first digit, remembering a sign right in front of it.
+
+  while ((i < length) && (input[i] != '\0') && !UTILITIES_is_ascii_numeric(input[i]))
+  {
+    negative = (input[i] == '-');
+    i++;
+  }
+
+  if ((i + 1U < length) && (input[i] == '0'))
+  {
+    if ((input[i + 1U] == 'x') || (input[i + 1U] == 'X'))
+    {
+      base = 16;
+      i = (uint8_t)(i + 2U);
+    }
+    else if ((input[i + 1U] == 'b') || (input[i + 1U] == 'B'))
+    {
+      base = 2;
+      i = (uint8_t)(i + 2U);
+    }
+  }
+
+  for (; (i < length) && (input[i] != '\0'); i++)
+  {
+    char c = input[i];
+    uint8_t digit;
+
+    if (UTILITIES_is_ascii_numeric(c))
+    {
+      digit = (uint8_t)(c - '0');
+    }
+    else if ((c >= 'a') && (c <= 'f'))
+    {
+      digit = (uint8_t)(c - 'a' + 10);
+    }
+    else if ((c >= 'A') && (c <= 'F'))
+    {
+      digit = (uint8_t)(c - 'A' + 10);
+    }
+    else
+    {
+      break;
+    }
+
+    if (digit >= base)
+    {
+      break;
+    }
+
+    value = value * base + digit;
+  }
+
+  return negative ? (int64_t)((uint64_t)0 - value) : (int64_t)value;
+}
+
+uint16_t UTILITIES_crc16(uint16_t crc, void* buffer, uint32_t length)
+{
+  uint8_t* data = (uint8_t*)buffer;
+
+  while (length-- != 0)
+  {
+    crc ^= *data++;
+
+    for (uint8_t bit = 0; bit < 8U; bit++)
+    {
+      crc = (crc & 1U) ? (uint16_t)((crc >> 1) ^ 0xA001U) : (uint16_t)(crc >> 1);
+    }
+  }
+
+  return crc;
+}
+
+uint32_t UTILITIES_cidr_to_netmask(uint8_t cidr)
+{
+  return (cidr == 0) ? 0 : (0xFFFFFFFFU << (32U - UTILS_MIN(cidr, 32U)));
+}
+
+void UTILITIES_dummy_void_void(void)
+{
+}
+
+void UTILITIES_dummy_void_bool(bool b)
+{
+  (void)b;
+}
+
+bool UTILITIES_dummy_false_void(void)
+{
+  return false;
+}
+
+bool UTILITIES_dummy_true_void(void)
+{
+  return true;
+}
+
+bool UTILITIES_dummy_true_bool(bool b)
+{
+  (void)b;
+  return true;
+}
+
+bool UTILITIES_dummy_false_voidp_u32(void* voidp, uint32_t u32)
+{
+  (void)voidp;
+  (void)u32;
+  return false;
+}
+
+uint32_t UTILITIES_dummy_u32_void(void)
+{
+  return 0;
+}
+
+void UTILITIES_dummy_void_u32(uint32_t u32)
+{
+  (void)u32;
+}
+
+/*******************************************************************************
+ * UTIMER
+ ******************************************************************************/
+
+// Gets the hardware tick count and the period count it belongs to. The
+// period counter is read again in case the period interrupt was taken in
+// between.
+
+static void SIM_utimer_now(UTIMER_instance_t* instance, uint64_t* periods, uint64_t* ticks)
+{
+  do
+  {
+    *periods = instance->period_counter;
+    *ticks = instance->get_hardware_counter();
+  }
+  while (*periods != instance->period_counter);
+}
+
+void UTIMER_period_isr_handler(UTIMER_instance_t* instance)
+{
+  instance->period_counter++;
+}
+
+void UTIMER_initialize(UTIMER_instance_t* instance,
+                       uint64_t ticks_per_microsecond,
+                       uint64_t ticks_per_period,
+                       UTIMER_hal_get_hardware_counter_t get_hardware_counter)
+{
+  UTILITIES_memclear(instance, sizeof(UTIMER_instance_t));
+
+  instance->ticks_per_microsecond = ticks_per_microsecond;
+  instance->ticks_per_period = ticks_per_period;
+  instance->get_hardware_counter = get_hardware_counter;
+}
+
+void UTIMER_ticket_create(UTIMER_instance_t* instance,
+                          UTIMER_ticket_t* ticket,
+                          uint64_t expiration_us)
+{
+  SIM_utimer_now(instance, &ticket->start_periods_capture, &ticket->start_ticks_capture);
+
+  uint64_t expiration_ticks = ticket->start_ticks_capture + expiration_us * instance->ticks_per_microsecond;
+
+  ticket->expiration_periods = ticket->start_periods_capture + expiration_ticks / instance->ticks_per_period;
+  ticket->expiration_ticks = expiration_ticks % instance->ticks_per_period;
+  ticket->expiration_us = expiration_us;
+}
+
+bool UTIMER_ticket_has_expired(UTIMER_instance_t* instance, UTIMER_ticket_t* ticket)
+{
+  uint64_t periods;
+  uint64_t ticks;
+
+  SIM_utimer_now(instance, &periods, &ticks);
+
+  return (periods > ticket->expiration_periods) ||
+         ((periods == ticket->expiration_periods) && (ticks >= ticket->expiration_ticks));
+}
+
+uint64_t UTIMER_ticket_elapsed_time(UTIMER_instance_t* instance, UTIMER_ticket_t* ticket)
+{
+  uint64_t periods;
+  uint64_t ticks;
+
+  SIM_utimer_now(instance, &periods, &ticks);
+
+  uint64_t elapsed_ticks = (periods - ticket->start_periods_capture) * instance->ticks_per_period +
+                           ticks - ticket->start_ticks_capture;
+
+  return elapsed_ticks / instance->ticks_per_microsecond;
+}
+
+/*******************************************************************************
+ * QUEUE
+ ******************************************************************************/
+
+// The head is the next element to dequeue and the tail the next slot to
+// enqueue into. Thread-safe queues leave one slot free, so that the producer
+// only writes the tail index and the consumer only writes the head index.
+
+static uint8_t* SIM_queue_element(QUEUE_instance_t* instance, uint32_t index)
+{
+  return (uint8_t*)instance->buffer + index * instance->element_size;
+}
+
+static uint32_t SIM_queue_next(QUEUE_instance_t* instance, uint32_t index)
+{
+  return (index + 1U == instance->queue_length_in_elements) ? 0 : index + 1U;
+}
+
+void QUEUE_initialize(QUEUE_instance_t* instance,
+                      void* buffer,
+                      uint32_t buffer_length,
+                      uint32_t element_size,
+                      bool wrapping_enabled,
+                      bool thread_safe)
+{
+  UTILITIES_memclear(instance, sizeof(QUEUE_instance_t));
+
+  instance->flags.wrapping_enabled = wrapping_enabled && !thread_safe;
+  instance->flags.thread_safe = thread_safe;
+  instance->buffer = buffer;
+  instance->buffer_length = buffer_length;
+  instance->element_size = element_size;
+  instance->queue_length_in_elements = buffer_length / element_size;
+}
+
+bool QUEUE_enqueue(QUEUE_instance_t* instance, void* element)
+{
+  if (instance->flags.thread_safe)
+  {
+    uint32_t tail_index = __atomic_load_n(&instance->tail_index, __ATOMIC_RELAXED);
+    uint32_t next_index = SIM_queue_next(instance, tail_index);
+
+    if (next_index == __atomic_load_n(&instance->head_index, __ATOMIC_ACQUIRE))
+    {
+      return false;
+    }
+
+    UTILITIES_memcpy(SIM_queue_element(instance, tail_index), element, instance->element_size);
+    __atomic_store_n(&instance->tail_index, next_index, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  if (instance->element_counter == instance->queue_length_in_elements)
+  {
+    if (!instance->flags.wrapping_enabled || (instance->queue_length_in_elements == 0))
+    {
+      return false;
+    }
+
+    // Overwrite the oldest element.
+
+    instance->head_index = SIM_queue_next(instance, instance->head_index);
+    instance->element_counter--;
+  }
+
+  UTILITIES_memcpy(SIM_queue_element(instance, instance->tail_index), element, instance->element_size);
+  instance->tail_index = SIM_queue_next(instance, instance->tail_index);
+  instance->element_counter++;
+  return true;
+}
+
+bool QUEUE_peek(QUEUE_instance_t* instance, void* element)
+{
+  if (QUEUE_is_empty(instance))
+  {
+    return false;
+  }
+
+  UTILITIES_memcpy(element, SIM_queue_element(instance, instance->head_index), instance->element_size);
+  return true;
+}
+
+bool QUEUE_dequeue(QUEUE_instance_t* instance, void* element)
+{
+  if (instance->flags.thread_safe)
+  {
+    uint32_t head_index = __atomic_load_n(&instance->head_index, __ATOMIC_RELAXED);
+
+    if (head_index == __atomic_load_n(&instance->tail_index, __ATOMIC_ACQUIRE))
+    {
+      return false;
+    }
+
+    UTILITIES_memcpy(element, SIM_queue_element(instance, head_index), instance->element_size);
+    __atomic_store_n(&instance->head_index, SIM_queue_next(instance, head_index), __ATOMIC_RELEASE);
+    return true;
+  }
+
+  if (instance->element_counter == 0)
+  {
+    return false;
+  }
+
+  UTILITIES_memcpy(element, SIM_queue_element(instance, instance->head_index), instance->element_size);
+  instance->head_index = SIM_queue_next(instance, instance->head_index);
+  instance->element_counter--;
+  return true;
+}
+
+uint32_t QUEUE_enqueue_buffer(QUEUE_instance_t* instance,
+                              void* element_buffer,
+                              uint32_t element_count)
+{
+  uint8_t* element = (uint8_t*)element_buffer;
+  uint32_t count = 0;
+
+  while ((count < element_count) && QUEUE_enqueue(instance, element))
+  {
+    element += instance->element_size;
+    count++;
+  }
+
+  return count;
+}
+
+uint32_t QUEUE_dequeue_buffer(QUEUE_instance_t* instance,
+                              void* element_buffer,
+                              uint32_t element_count)
+{
+  uint8_t* element = (uint8_t*)element_buffer;
+  uint32_t count = 0;
+
+  while ((count < element_count) && QUEUE_dequeue(instance, element))
+  {
+    element += instance->element_size;
+    count++;
+  }
+
+  return count;
+}
+
+bool QUEUE_get_element_position(QUEUE_instance_t* instance,
+                                void* element,
+                                uint32_t* position)
+{
+  uint32_t count = QUEUE_get_count(instance);
+  uint32_t index = instance->head_index;
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (UTILITIES_memcmp(SIM_queue_element(instance, index), element, instance->element_size) == 0)
+    {
+      *position = i;
+      return true;
+    }
+
+    index = SIM_queue_next(instance, index);
+  }
+
+  return false;
+}
+
+bool QUEUE_is_full(QUEUE_instance_t* instance)
+{
+  if (instance->flags.thread_safe)
+  {
+    return SIM_queue_next(instance, instance->tail_index) == instance->head_index;
+  }
+
+  return instance->element_counter == instance->queue_length_in_elements;
+}
+
+bool QUEUE_is_empty(QUEUE_instance_t* instance)
+{
+  return QUEUE_get_count(instance) == 0;
+}
+
+uint32_t QUEUE_get_count(QUEUE_instance_t* instance)
+{
+  if (instance->flags.thread_safe)
+  {
+    uint32_t head_index = __atomic_load_n(&instance->head_index, __ATOMIC_ACQUIRE);
+    uint32_t tail_index = __atomic_load_n(&instance->tail_index, __ATOMIC_ACQUIRE);
+
+    return (tail_index >= head_index) ? tail_index - head_index
+                                      : tail_index + instance->queue_length_in_elements - head_index;
+  }
+
+  return instance->element_counter;
+}
+
+void QUEUE_clear(QUEUE_instance_t* instance)
+{
+  if (instance->flags.thread_safe)
+  {
+    __atomic_store_n(&instance->head_index, __atomic_load_n(&instance->tail_index, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    return;
+  }
+
+  UTILITIES_memclear(instance->buffer, instance->buffer_length);
+  instance->element_counter = 0;
+  instance->head_index = 0;
+  instance->tail_index = 0;
+}
+
+/*******************************************************************************
+ * BUSMUTEX
+ ******************************************************************************/
+
+void BUSMUTEX_initialize(BUSMUTEX_instance_t* instance,
+                         BUSMUTEX_hal_enter_critical_t enter_critical,
+                         BUSMUTEX_hal_exit_critical_t exit_critical)
+{
+  UTILITIES_memclear(instance, sizeof(BUSMUTEX_instance_t));
+
+  instance->enter_critical = enter_critical;
+  instance->exit_critical = exit_critical;
+}
+
+bool BUSMUTEX_is_available(BUSMUTEX_instance_t* instance, BUSMUTEX_bus_id_t bus_id)
+{
+  return (bus_id == BUSMUTEX_BUS_ID_NULL) || !instance->bus_mutex[bus_id];
+}
+
+bool BUSMUTEX_request_mutex(BUSMUTEX_instance_t* instance, BUSMUTEX_bus_id_t bus_id)
+{
+  // The NULL bus ID is for devices which do not share their bus.
+
+  if (bus_id == BUSMUTEX_BUS_ID_NULL)
+  {
+    return true;
+  }
+
+  bool secured = false;
+
+  if (instance->enter_critical != NULL)
+  {
+    instance->enter_critical();
+  }
+
+  if (!instance->bus_mutex[bus_id])
+  {
+    instance->bus_mutex[bus_id] = true;
+    secured = true;
+  }
+
+  if (instance->exit_critical != NULL)
+  {
+    instance->exit_critical();
+  }
+
+  return secured;
+}
+
+bool BUSMUTEX_release_mutex(BUSMUTEX_instance_t* instance, BUSMUTEX_bus_id_t bus_id)
+{
+  if (bus_id == BUSMUTEX_BUS_ID_NULL)
+  {
+    return true;
+  }
+
+  bool released = false;
+
+  if (instance->enter_critical != NULL)
+  {
+    instance->enter_critical();
+  }
+
+  if (instance->bus_mutex[bus_id])
+  {
+    instance->bus_mutex[bus_id] = false;
+    released = true;
+  }
+
+  if (instance->exit_critical != NULL)
+  {
+    instance->exit_critical();
+  }
+
+  return released;
+}
+
+/*******************************************************************************
+ * BIBUTTON
+ ******************************************************************************/
+
+// A phase is logged each time the button debounces into a new state and
+// again for every full hold period it stays in that state.
+
+void BIBUTTON_initialize_basic(BIBUTTON_instance_t* instance,
+                               BIBUTTON_hal_get_button_state_t get_button_state)
+{
+  BIBUTTON_initialize(instance,
+                      BIBUTTON_DEBOUNCE_TICKS_DEFAULT,
+                      BIBUTTON_HOLD_TICKS_DEFAULT,
+                      false,
+                      get_button_state);
+}
+
+void BIBUTTON_initialize(BIBUTTON_instance_t* instance,
+                         uint16_t debounce_ticks_required,
+                         uint16_t hold_ticks_required,
+                         bool button_disabled,
+                         BIBUTTON_hal_get_button_state_t get_button_state)
+{
+  UTILITIES_memclear(instance, sizeof(BIBUTTON_instance_t));
+
+  instance->flags.disabled = button_disabled;
+  instance->debounce_ticks_required = debounce_ticks_required;
+  instance->hold_ticks_required = hold_ticks_required;
+  instance->get_button_state = get_button_state;
+}
+
+bool BIBUTTON_add_pattern(BIBUTTON_instance_t* instance,
+                          BIBUTTON_pattern_instance_t* pattern_instance,
+                          BIBUTTON_pattern_t pattern,
+                          uint8_t pattern_length,
+                          void (*callback)(uint32_t),
+                          uint32_t callback_context)
+{
+  if ((pattern_length == 0) || (pattern_length > 64U))
+  {
+    return false;
+  }
+
+  UTILITIES_memclear(pattern_instance, sizeof(BIBUTTON_pattern_instance_t));
+
+  pattern_instance->length = pattern_length;
+  pattern_instance->mask = (pattern_length == 64U) ? ~(BIBUTTON_pattern_t)0
+                                                   : (((BIBUTTON_pattern_t)1 << pattern_length) - 1U);
+  pattern_instance->pattern = pattern & pattern_instance->mask;
+  pattern_instance->callback = callback;
+  pattern_instance->callback_context = callback_context;
+
+  // Insert ahead of the first shorter pattern.
+
+  BIBUTTON_pattern_instance_t** link = &instance->registered_patterns;
+
+  while ((*link != NULL) && ((*link)->length >= pattern_length))
+  {
+    link = (BIBUTTON_pattern_instance_t**)&(*link)->next_pattern;
+  }
+
+  pattern_instance->next_pattern = *link;
+  *link = pattern_instance;
+  return true;
+}
+
+void BIBUTTON_service(BIBUTTON_instance_t* instance)
+{
+  if (instance->flags.disabled)
+  {
+    return;
+  }
+
+  BIBUTTON_debounce_and_hold_handler(instance);
+  BIBUTTON_pattern_handler(instance);
+}
+
+void BIBUTTON_enable(BIBUTTON_instance_t* instance, bool clear)
+{
+  if (clear)
+  {
+    instance->debounce_ticks_count = 0;
+    instance->hold_ticks_count = 0;
+    instance->flags.debounced_pressed = BIBUTTON_is_button_pressed(instance);
+  }
+
+  instance->flags.disabled = 0;
+}
+
+void BIBUTTON_disable(BIBUTTON_instance_t* instance)
+{
+  instance->flags.disabled = 1;
+}
+
+bool BIBUTTON_is_button_debounced_pressed(BIBUTTON_instance_t* instance)
+{
+  return instance->flags.debounced_pressed;
+}
+
+void BIBUTTON_clear_log(BIBUTTON_instance_t* instance)
+{
+  instance->log = 0;
+  instance->active_log_length = 0;
+}
+
+bool BIBUTTON_is_button_pressed(BIBUTTON_instance_t* instance)
+{
+  instance->flags.pressed = instance->get_button_state();
+  return instance->flags.pressed;
+}
+
+void BIBUTTON_log_event(BIBUTTON_instance_t* instance, bool pressed)
+{
+  instance->log = (instance->log << 1) | (pressed ? 1U : 0U);
+
+  if (instance->active_log_length < 64U)
+  {
+    instance->active_log_length++;
+  }
+}
+
+void BIBUTTON_debounce_and_hold_handler(BIBUTTON_instance_t* instance)
+{
+  bool pressed = BIBUTTON_is_button_pressed(instance);
+
+  if (pressed != instance->flags.debounced_pressed)
+  {
+    if (++instance->debounce_ticks_count >= instance->debounce_ticks_required)
+    {
+      instance->flags.debounced_pressed = pressed;
+      instance->debounce_ticks_count = 0;
+      instance->hold_ticks_count = 0;
+      BIBUTTON_log_event(instance, pressed);
+    }
+
+    return;
+  }
+
+  // Ticks spent in a failed debounce still count towards the hold.
+
+  instance->hold_ticks_count = (uint16_t)(instance->hold_ticks_count + instance->debounce_ticks_count + 1U);
+  instance->debounce_ticks_count = 0;
+
+  if (instance->hold_ticks_count >= instance->hold_ticks_required)
+  {
+    instance->hold_ticks_count = 0;
+    BIBUTTON_log_event(instance, pressed);
+  }
+}
+
+void BIBUTTON_pattern_handler(BIBUTTON_instance_t* instance)
+{
+  for (BIBUTTON_pattern_instance_t* pattern = instance->registered_patterns;
+       pattern != NULL;
+       pattern = (BIBUTTON_pattern_instance_t*)pattern->next_pattern)
+  {
+    if (!pattern->flags.disabled &&
+        (pattern->length <= instance->active_log_length) &&
+        ((instance->log & pattern->mask) == pattern->pattern))
+    {
+      instance->active_log_length = 0;
+
+      if (pattern->callback != NULL)
+      {
+        pattern->callback(pattern->callback_context);
+      }
+
+      return;
+    }
+  }
+}
+
+/*******************************************************************************
+ * ROTARYENCODER
+ ******************************************************************************/
+
+// A tick begins when one phase debounces away from the other, which gives the
+// direction, and ends when the phases agree again. It is reported if both
+// phases moved, rather than the first one returning, and the edge on which
+// the phases came to rest matches the edge trigger.
+
+static bool SIM_rotaryencoder_edge_falling(bool edge)
+{
+  return !edge;
+}
+
+static bool SIM_rotaryencoder_edge_rising(bool edge)
+{
+  return edge;
+}
+
+static bool SIM_rotaryencoder_edge_both(bool edge)
+{
+  (void)edge;
+  return true;
+}
+
+// Debounces a phase, returning true when its debounced state changes.
+
+static bool SIM_rotaryencoder_debounce(ROTARYENCODER_instance_t* instance,
+                                       bool phase,
+                                       bool last,
+                                       uint16_t* counter)
+{
+  if (phase == last)
+  {
+    *counter = 0;
+    return false;
+  }
+
+  if (++*counter < instance->debounce_count)
+  {
+    return false;
+  }
+
+  *counter = 0;
+  return true;
+}
+
+void ROTARYENCODER_initialize(ROTARYENCODER_instance_t* instance,
+                              uint16_t debounce_count,
+                              ROTARYENCODER_edge_trigger_t edge_trigger,
+                              ROTARYENCODER_rotation_tick_callback_t rotation_tick_callback,
+                              ROTARYENCODER_hal_is_phase_a_set_t is_phase_a_set,
+                              ROTARYENCODER_hal_is_phase_b_set_t is_phase_b_set)
+{
+  UTILITIES_memclear(instance, sizeof(ROTARYENCODER_instance_t));
+
+  instance->debounce_count = debounce_count;
+  instance->flags.edge_trigger = edge_trigger;
+  instance->rotation_tick_callback = rotation_tick_callback;
+  instance->is_phase_a_set = is_phase_a_set;
+  instance->is_phase_b_set = is_phase_b_set;
+
+  switch (edge_trigger)
+  {
+    case ROTARYENCODER_EDGE_TRIGGER_FALLING:
+      instance->edge_trigger_check = SIM_rotaryencoder_edge_falling;
+      break;
+
+    case ROTARYENCODER_EDGE_TRIGGER_RISING:
+      instance->edge_trigger_check = SIM_rotaryencoder_edge_rising;
+      break;
+
+    default:
+      instance->edge_trigger_check = SIM_rotaryencoder_edge_both;
+      break;
+  }
+
+  instance->flags.last_a = is_phase_a_set();
+  instance->flags.last_b = is_phase_b_set();
+}
+
+void ROTARYENCODER_service(ROTARYENCODER_instance_t* instance)
+{
+  bool a_changed = SIM_rotaryencoder_debounce(instance,
+                                              instance->is_phase_a_set(),
+                                              instance->flags.last_a,
+                                              &instance->clockwise_debounce_counter);
+  bool b_changed = SIM_rotaryencoder_debounce(instance,
+                                              instance->is_phase_b_set(),
+                                              instance->flags.last_b,
+                                              &instance->counterclockwise_debounce_counter);
+
+  instance->flags.last_a ^= a_changed;
+  instance->flags.last_b ^= b_changed;
+
+  if (!instance->flags.rotation_in_progress)
+  {
+    if ((a_changed != b_changed) && (instance->flags.last_a != instance->flags.last_b))
+    {
+      instance->flags.rotation_in_progress = 1;
+      instance->flags.clockwise_rotation = a_changed;
+      instance->flags.debounced_a = a_changed;
+      instance->flags.debounced_b = b_changed;
+    }
+
+    return;
+  }
+
+  instance->flags.debounced_a |= a_changed;
+  instance->flags.debounced_b |= b_changed;
+
+  if (instance->flags.last_a != instance->flags.last_b)
+  {
+    return;
+  }
+
+  if (instance->flags.debounced_a &&
+      instance->flags.debounced_b &&
+      instance->edge_trigger_check(instance->flags.last_a) &&
+      (instance->rotation_tick_callback != NULL))
+  {
+    instance->rotation_tick_callback(instance->flags.clockwise_rotation);
+  }
+
+  instance->flags.rotation_in_progress = 0;
+  instance->flags.debounced_a = 0;
+  instance->flags.debounced_b = 0;
+}
+
+/*******************************************************************************
+ * SHIFTPISO
+ ******************************************************************************/
+
+// Bit-bang method only, as the SPI method needs SERSPI, which has no
+// stand-in. The pin sequence and buffer layout are those of
+// SHIFTPISO_port_read: the first register shifted out goes to bit 0 of the
+// first byte. Each service call takes one step, once the propagation delay
+// since the previous step has passed.
+
+typedef enum
+{
+  SIM_SHIFTPISO_STATE_LATCH = 0,
+  SIM_SHIFTPISO_STATE_SHIFT,
+  SIM_SHIFTPISO_STATE_READ,
+}
+SIM_shiftpiso_state_t;
+
+static void SIM_shiftpiso_delay(SHIFTPISO_instance_t* instance)
+{
+  UTIMER_ticket_create(instance->utimer, &instance->utimer_ticket, instance->propagation_delay_us);
+}
+
+static bool SIM_shiftpiso_service_bb(void* context)
+{
+  SHIFTPISO_instance_t* instance = (SHIFTPISO_instance_t*)context;
+
+  if (!UTIMER_ticket_has_expired(instance->utimer, &instance->utimer_ticket))
+  {
+    return false;
+  }
+
+  switch (instance->flags.task_state)
+  {
+    case SIM_SHIFTPISO_STATE_LATCH:
+      instance->set_clock(false);
+      instance->set_latch_shift(true);
+      instance->flags.task_state = SIM_SHIFTPISO_STATE_SHIFT;
+      break;
+
+    case SIM_SHIFTPISO_STATE_SHIFT:
+      instance->set_clock(true);
+      instance->set_latch_shift(false);
+      instance->set_clock(false);
+      instance->flags.task_state = SIM_SHIFTPISO_STATE_READ;
+      break;
+
+    default:
+    {
+      // Bits past the last register read as 0.
+
+      if (instance->bit_offset == 0)
+      {
+        instance->serial_buffer[instance->byte_offset] = 0;
+      }
+
+      if (instance->get_serial())
+      {
+        instance->serial_buffer[instance->byte_offset] |= (uint8_t)(1U << instance->bit_offset);
+      }
+
+      instance->set_clock(true);
+      instance->set_clock(false);
+
+      if (++instance->bit_offset == 8U)
+      {
+        instance->bit_offset = 0;
+        instance->byte_offset++;
+      }
+
+      if (++instance->register_counter == instance->register_count)
+      {
+        return true;
+      }
+
+      break;
+    }
+  }
+
+  SIM_shiftpiso_delay(instance);
+  return false;
+}
+
+void SHIFTPISO_initialize_bb(SHIFTPISO_instance_t* instance,
+                             UTIMER_instance_t* utimer,
+                             uint16_t propagation_delay_us,
+                             uint16_t register_count,
+                             SHIFTPISO_pre_task_callback_t pre_task_callback,
+                             SHIFTPISO_post_task_callback_t post_task_callback,
+                             SHIFTPISO_hal_set_clock_t set_clock,
+                             SHIFTPISO_hal_set_latch_shift_t set_latch_shift,
+                             SHIFTPISO_hal_get_serial_t get_serial)
+{
+  UTILITIES_memclear(instance, sizeof(SHIFTPISO_instance_t));
+
+  instance->flags.bit_banged = 1;
+  instance->utimer = utimer;
+  instance->propagation_delay_us = propagation_delay_us;
+  instance->register_count = register_count;
+  instance->serial_buffer_length = (uint16_t)((register_count + 7U) / 8U);
+  instance->service_handler = SIM_shiftpiso_service_bb;
+  instance->pre_task_callback = pre_task_callback;
+  instance->post_task_callback = post_task_callback;
+  instance->set_clock = set_clock;
+  instance->set_latch_shift = set_latch_shift;
+  instance->get_serial = get_serial;
+}
+
+bool SHIFTPISO_begin_new_read(SHIFTPISO_instance_t* instance, uint8_t* serial_buffer)
+{
+  if (instance->flags.busy || (instance->service_handler == NULL) || (instance->register_count == 0))
+  {
+    return false;
+  }
+
+  instance->flags.busy = 1;
+  instance->flags.task_state = SIM_SHIFTPISO_STATE_LATCH;
+  instance->errors.all = 0;
+  instance->register_counter = 0;
+  instance->byte_offset = 0;
+  instance->bit_offset = 0;
+  instance->serial_buffer = serial_buffer;
+
+  UTIMER_ticket_create(instance->utimer, &instance->utimer_ticket, 0);
+
+  if (instance->pre_task_callback != NULL)
+  {
+    instance->pre_task_callback(instance->callback_context);
+  }
+
+  return true;
+}
+
+bool SHIFTPISO_service(SHIFTPISO_instance_t* instance)
+{
+  if (!instance->flags.busy)
+  {
+    return true;
+  }
+
+  if (!instance->service_handler(instance))
+  {
+    return false;
+  }
+
+  instance->flags.busy = 0;
+
+  if (instance->post_task_callback != NULL)
+  {
+    instance->post_task_callback(instance->callback_context);
+  }
+
+  return true;
+}
+
+bool SHIFTPISO_is_busy(SHIFTPISO_instance_t* instance)
+{
+  return instance->flags.busy;
+}
+
+/*******************************************************************************
+ * WS2812
+ ******************************************************************************/
+
+// Only the encoding, the transfers need SERSPI, which has no stand-in. Each
+// GRB bit becomes the 3-bit code of the instance, most significant bit
+// first, and the remainder of the source buffer is cleared.
+
+void WS2812_parse_grb_array(WS2812_instance_t* instance,
+                            uint8_t* grb_array,
+                            uint32_t grb_array_length)
+{
+  uint32_t offset = 0;
+
+  for (uint32_t i = 0; (i < grb_array_length) && (offset + 3U <= instance->src_buffer_length); i++)
+  {
+    uint32_t codes = 0;
+
+    for (uint8_t bit = 0x80; bit != 0; bit >>= 1)
+    {
+      codes = (codes << 3) | ((grb_array[i] & bit) ? instance->bit_code_1 : instance->bit_code_0);
+    }
+
+    instance->src_buffer[offset++] = (uint8_t)(codes >> 16);
+    instance->src_buffer[offset++] = (uint8_t)(codes >> 8);
+    instance->src_buffer[offset++] = (uint8_t)codes;
+  }
+
+  while (offset < instance->src_buffer_length)
+  {
+    instance->src_buffer[offset++] = 0;
+  }
+}
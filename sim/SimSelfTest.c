@@ -0,0 +1,706 @@
+#include "JLibSim.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ *
+ *  Self test of the simulated peripherals and the library stand-ins, built
+ *  and run under the sanitizers by sim/Makefile:
+ *
+ *   make -C sim
+ *
+ *  Each case drives a backend or stand-in the way a service routine would
+ *  and checks the result against the model. Failed checks are printed and
+ *  the exit status is the number of failures.
+ *
+ ******************************************************************************/
+
+static struct
+{
+  uint32_t checks;
+  uint32_t failures;
+}
+SIM_selftest;
+
+#define SIM_SELFTEST_CHECK(CONDITION)                                          \
+  SIM_selftest_check((CONDITION), #CONDITION, __FILE__, __LINE__)
+
+static void SIM_selftest_check(bool condition, const char* text, const char* file, int line)
+{
+  SIM_selftest.checks++;
+
+  if (!condition)
+  {
+    SIM_selftest.failures++;
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, text);
+  }
+}
+
+/*******************************************************************************
+ * UTIMER tickets across a period boundary.
+ ******************************************************************************/
+
+static void SIM_selftest_utimer(void)
+{
+  UTIMER_instance_t utimer;
+  UTIMER_ticket_t ticket;
+
+  SIM_timer_initialize(&utimer, 0);
+  SIM_timer_advance_ns(SIM_TIMER_TICKS_PER_PERIOD - 2000U);
+
+  UTIMER_ticket_create(&utimer, &ticket, 5);
+  SIM_SELFTEST_CHECK(!UTIMER_ticket_has_expired(&utimer, &ticket));
+
+  SIM_timer_advance_ns(2000);
+  SIM_SELFTEST_CHECK(utimer.period_counter == 1);
+  SIM_SELFTEST_CHECK(UTIMER_ticket_elapsed_time(&utimer, &ticket) == 2);
+  SIM_SELFTEST_CHECK(!UTIMER_ticket_has_expired(&utimer, &ticket));
+
+  SIM_timer_advance_ns(2999);
+  SIM_SELFTEST_CHECK(!UTIMER_ticket_has_expired(&utimer, &ticket));
+
+  SIM_timer_advance_ns(1);
+  SIM_SELFTEST_CHECK(UTIMER_ticket_has_expired(&utimer, &ticket));
+  SIM_SELFTEST_CHECK(UTIMER_ticket_elapsed_time(&utimer, &ticket) == 5);
+
+  SIM_timer_advance_ns(3U * SIM_TIMER_TICKS_PER_PERIOD);
+  SIM_SELFTEST_CHECK(utimer.period_counter == 4);
+}
+
+/*******************************************************************************
+ * QUEUE wrapping and thread-safe modes.
+ ******************************************************************************/
+
+static void SIM_selftest_queue(void)
+{
+  QUEUE_instance_t queue;
+  uint16_t buffer[4];
+  uint16_t values[6] = {1, 2, 3, 4, 5, 6};
+  uint16_t value;
+  uint32_t position;
+
+  QUEUE_initialize(&queue, buffer, sizeof(buffer), sizeof(uint16_t), true, false);
+  SIM_SELFTEST_CHECK(QUEUE_enqueue_buffer(&queue, values, 6) == 6);
+  SIM_SELFTEST_CHECK(QUEUE_is_full(&queue));
+  SIM_SELFTEST_CHECK(QUEUE_get_element_position(&queue, &values[4], &position) && (position == 2));
+  SIM_SELFTEST_CHECK(!QUEUE_get_element_position(&queue, &values[1], &position));
+  SIM_SELFTEST_CHECK(QUEUE_dequeue(&queue, &value) && (value == 3));
+
+  QUEUE_clear(&queue);
+  SIM_SELFTEST_CHECK(QUEUE_is_empty(&queue) && !QUEUE_dequeue(&queue, &value));
+
+  // Thread-safe queues hold one element less than the buffer.
+
+  QUEUE_initialize(&queue, buffer, sizeof(buffer), sizeof(uint16_t), false, true);
+  SIM_SELFTEST_CHECK(QUEUE_enqueue_buffer(&queue, values, 6) == 3);
+  SIM_SELFTEST_CHECK(QUEUE_is_full(&queue) && (QUEUE_get_count(&queue) == 3));
+  SIM_SELFTEST_CHECK(QUEUE_peek(&queue, &value) && (value == 1));
+
+  for (uint16_t i = 1; i <= 3; i++)
+  {
+    SIM_SELFTEST_CHECK(QUEUE_dequeue(&queue, &value) && (value == i));
+    SIM_SELFTEST_CHECK(QUEUE_enqueue(&queue, &values[i + 2U]));
+  }
+
+  SIM_SELFTEST_CHECK(QUEUE_dequeue_buffer(&queue, values, 6) == 3);
+  SIM_SELFTEST_CHECK((values[0] == 4) && (values[1] == 5) && (values[2] == 6));
+  SIM_SELFTEST_CHECK(QUEUE_is_empty(&queue));
+}
+
+/*******************************************************************************
+ * BUSMUTEX claims.
+ ******************************************************************************/
+
+static void SIM_selftest_busmutex(void)
+{
+  BUSMUTEX_instance_t bus_mutex;
+
+  BUSMUTEX_initialize(&bus_mutex, NULL, NULL);
+  SIM_SELFTEST_CHECK(BUSMUTEX_request_mutex(&bus_mutex, BUSMUTEX_BUS_ID_SPI_1));
+  SIM_SELFTEST_CHECK(!BUSMUTEX_request_mutex(&bus_mutex, BUSMUTEX_BUS_ID_SPI_1));
+  SIM_SELFTEST_CHECK(!BUSMUTEX_is_available(&bus_mutex, BUSMUTEX_BUS_ID_SPI_1));
+  SIM_SELFTEST_CHECK(BUSMUTEX_is_available(&bus_mutex, BUSMUTEX_BUS_ID_I2C_0));
+  SIM_SELFTEST_CHECK(BUSMUTEX_request_mutex(&bus_mutex, BUSMUTEX_BUS_ID_NULL));
+  SIM_SELFTEST_CHECK(BUSMUTEX_release_mutex(&bus_mutex, BUSMUTEX_BUS_ID_SPI_1));
+  SIM_SELFTEST_CHECK(!BUSMUTEX_release_mutex(&bus_mutex, BUSMUTEX_BUS_ID_SPI_1));
+}
+
+/*******************************************************************************
+ * BIBUTTON patterns, with the stand-in and the compiled matcher.
+ ******************************************************************************/
+
+static struct
+{
+  bool pressed;
+  uint32_t matches[2];
+}
+SIM_selftest_button;
+
+static bool SIM_selftest_button_get_state(void)
+{
+  return SIM_selftest_button.pressed;
+}
+
+static void SIM_selftest_button_callback(uint32_t context)
+{
+  SIM_selftest_button.matches[context]++;
+}
+
+static void SIM_selftest_button_run(BIBUTTON_instance_t* button,
+                                    BIBUTTON_matcher_t* matcher,
+                                    bool pressed,
+                                    uint16_t ticks)
+{
+  SIM_selftest_button.pressed = pressed;
+
+  while (ticks-- != 0)
+  {
+    if (matcher != NULL)
+    {
+      BIBUTTON_matcher_service(button, matcher);
+    }
+    else
+    {
+      BIBUTTON_service(button);
+    }
+  }
+}
+
+static void SIM_selftest_bibutton(bool compiled)
+{
+  BIBUTTON_instance_t button;
+  BIBUTTON_pattern_instance_t click;
+  BIBUTTON_pattern_instance_t long_press;
+  BIBUTTON_matcher_t matcher;
+  BIBUTTON_matcher_node_t nodes[8];
+  BIBUTTON_matcher_t* active_matcher = NULL;
+
+  UTILITIES_memclear(&SIM_selftest_button, sizeof(SIM_selftest_button));
+
+  // Debounce over 2 ticks and log a hold phase every 10 ticks.
+
+  BIBUTTON_initialize(&button, 2, 10, false, SIM_selftest_button_get_state);
+  SIM_SELFTEST_CHECK(BIBUTTON_add_pattern(&button, &click, 0x2U, 2, SIM_selftest_button_callback, 0));
+  SIM_SELFTEST_CHECK(BIBUTTON_add_pattern(&button, &long_press, 0x3U, 2, SIM_selftest_button_callback, 1));
+  SIM_SELFTEST_CHECK(!BIBUTTON_add_pattern(&button, &long_press, 0, 65, SIM_selftest_button_callback, 1));
+
+  if (compiled)
+  {
+    SIM_SELFTEST_CHECK(BIBUTTON_matcher_compile(&button, &matcher, nodes, 8));
+    active_matcher = &matcher;
+  }
+
+  SIM_selftest_button_run(&button, active_matcher, false, 3);
+  SIM_selftest_button_run(&button, active_matcher, true, 1);
+  SIM_selftest_button_run(&button, active_matcher, false, 3);
+  SIM_SELFTEST_CHECK(button.active_log_length == 0);
+
+  SIM_selftest_button_run(&button, active_matcher, true, 4);
+  SIM_SELFTEST_CHECK(BIBUTTON_is_button_debounced_pressed(&button));
+  SIM_selftest_button_run(&button, active_matcher, false, 3);
+  SIM_SELFTEST_CHECK((SIM_selftest_button.matches[0] == 1) && (SIM_selftest_button.matches[1] == 0));
+
+  SIM_selftest_button_run(&button, active_matcher, true, 2 + 10);
+  SIM_SELFTEST_CHECK((SIM_selftest_button.matches[0] == 1) && (SIM_selftest_button.matches[1] == 1));
+  SIM_SELFTEST_CHECK(button.active_log_length == 0);
+}
+
+/*******************************************************************************
+ * ROTARYENCODER ticks, reversals and edge triggers.
+ ******************************************************************************/
+
+static struct
+{
+  bool a;
+  bool b;
+  uint32_t clockwise;
+  uint32_t counterclockwise;
+}
+SIM_selftest_encoder;
+
+static bool SIM_selftest_encoder_is_phase_a_set(void)
+{
+  return SIM_selftest_encoder.a;
+}
+
+static bool SIM_selftest_encoder_is_phase_b_set(void)
+{
+  return SIM_selftest_encoder.b;
+}
+
+static void SIM_selftest_encoder_tick(bool clockwise)
+{
+  if (clockwise)
+  {
+    SIM_selftest_encoder.clockwise++;
+  }
+  else
+  {
+    SIM_selftest_encoder.counterclockwise++;
+  }
+}
+
+// Steps through the A/B states of a string such as "10 11", serviced twice
+// per state for a debounce count of 2.
+
+static void SIM_selftest_encoder_run(ROTARYENCODER_instance_t* encoder, const char* states)
+{
+  for (; *states != '\0'; states += (states[2] == ' ') ? 3 : 2)
+  {
+    SIM_selftest_encoder.a = (states[0] == '1');
+    SIM_selftest_encoder.b = (states[1] == '1');
+
+    ROTARYENCODER_service(encoder);
+    ROTARYENCODER_service(encoder);
+  }
+}
+
+static void SIM_selftest_rotaryencoder(void)
+{
+  ROTARYENCODER_instance_t encoder;
+
+  UTILITIES_memclear(&SIM_selftest_encoder, sizeof(SIM_selftest_encoder));
+
+  ROTARYENCODER_initialize(&encoder,
+                           2,
+                           ROTARYENCODER_EDGE_TRIGGER_BOTH,
+                           SIM_selftest_encoder_tick,
+                           SIM_selftest_encoder_is_phase_a_set,
+                           SIM_selftest_encoder_is_phase_b_set);
+
+  SIM_selftest_encoder_run(&encoder, "10 11 01 00");
+  SIM_SELFTEST_CHECK((SIM_selftest_encoder.clockwise == 2) && (SIM_selftest_encoder.counterclockwise == 0));
+
+  SIM_selftest_encoder_run(&encoder, "01 11 10 00");
+  SIM_SELFTEST_CHECK((SIM_selftest_encoder.clockwise == 2) && (SIM_selftest_encoder.counterclockwise == 2));
+
+  // A phase returning, or a glitch shorter than the debounce, is no tick.
+
+  SIM_selftest_encoder_run(&encoder, "10 00");
+  SIM_selftest_encoder.a = true;
+  ROTARYENCODER_service(&encoder);
+  SIM_selftest_encoder.a = false;
+  ROTARYENCODER_service(&encoder);
+  SIM_SELFTEST_CHECK((SIM_selftest_encoder.clockwise == 2) && (SIM_selftest_encoder.counterclockwise == 2));
+
+  ROTARYENCODER_initialize(&encoder,
+                           2,
+                           ROTARYENCODER_EDGE_TRIGGER_RISING,
+                           SIM_selftest_encoder_tick,
+                           SIM_selftest_encoder_is_phase_a_set,
+                           SIM_selftest_encoder_is_phase_b_set);
+
+  SIM_selftest_encoder_run(&encoder, "10 11 01 00");
+  SIM_SELFTEST_CHECK((SIM_selftest_encoder.clockwise == 3) && (SIM_selftest_encoder.counterclockwise == 2));
+}
+
+/*******************************************************************************
+ * SHIFTPISO bit-bang stand-in and port shifter against a 74HC165 chain.
+ ******************************************************************************/
+
+#define SIM_SELFTEST_PISO_REGISTERS       12U
+#define SIM_SELFTEST_PISO_CLOCK           (1UL << 0)
+#define SIM_SELFTEST_PISO_LOAD            (1UL << 1)
+#define SIM_SELFTEST_PISO_SERIAL_PIN      2U
+
+// Chain of parallel inputs and shift stages, stage 0 driving the serial
+// output. The load line is active low, and stages shift on a rising clock.
+
+static struct
+{
+  uint32_t port;
+  bool inputs[SIM_SELFTEST_PISO_REGISTERS];
+  bool stages[SIM_SELFTEST_PISO_REGISTERS];
+}
+SIM_selftest_piso;
+
+static void SIM_selftest_piso_port_write(uint32_t set_mask, uint32_t clear_mask)
+{
+  uint32_t previous = SIM_selftest_piso.port;
+
+  SIM_selftest_piso.port = (previous & ~clear_mask) | set_mask;
+
+  if ((SIM_selftest_piso.port & SIM_SELFTEST_PISO_LOAD) == 0)
+  {
+    UTILITIES_memcpy(SIM_selftest_piso.stages, SIM_selftest_piso.inputs, sizeof(SIM_selftest_piso.stages));
+  }
+  else if ((SIM_selftest_piso.port & ~previous & SIM_SELFTEST_PISO_CLOCK) != 0)
+  {
+    for (uint16_t i = 0; i < SIM_SELFTEST_PISO_REGISTERS - 1U; i++)
+    {
+      SIM_selftest_piso.stages[i] = SIM_selftest_piso.stages[i + 1U];
+    }
+
+    SIM_selftest_piso.stages[SIM_SELFTEST_PISO_REGISTERS - 1U] = false;
+  }
+}
+
+static uint32_t SIM_selftest_piso_port_read(void)
+{
+  return SIM_selftest_piso.port | ((uint32_t)SIM_selftest_piso.stages[0] << SIM_SELFTEST_PISO_SERIAL_PIN);
+}
+
+static void SIM_selftest_piso_set_clock(bool value)
+{
+  SIM_selftest_piso_port_write(value ? SIM_SELFTEST_PISO_CLOCK : 0, value ? 0 : SIM_SELFTEST_PISO_CLOCK);
+}
+
+static void SIM_selftest_piso_set_latch_shift(bool latch)
+{
+  SIM_selftest_piso_port_write(latch ? 0 : SIM_SELFTEST_PISO_LOAD, latch ? SIM_SELFTEST_PISO_LOAD : 0);
+}
+
+static bool SIM_selftest_piso_get_serial(void)
+{
+  return (SIM_selftest_piso_port_read() >> SIM_SELFTEST_PISO_SERIAL_PIN) & 1U;
+}
+
+static void SIM_selftest_shiftpiso(void)
+{
+  UTIMER_instance_t utimer;
+  SHIFTPISO_instance_t piso;
+  SHIFTPISO_port_t port;
+  uint8_t bb_buffer[2] = {0xFF, 0xFF};
+  uint8_t port_buffer[2] = {0, 0};
+  uint32_t services = 0;
+
+  for (uint16_t i = 0; i < SIM_SELFTEST_PISO_REGISTERS; i++)
+  {
+    SIM_selftest_piso.inputs[i] = ((0xA5CU >> i) & 1U) != 0;
+  }
+
+  SIM_selftest_piso.port = SIM_SELFTEST_PISO_LOAD;
+
+  SIM_timer_initialize(&utimer, 0);
+  SHIFTPISO_initialize_bb(&piso,
+                          &utimer,
+                          1,
+                          SIM_SELFTEST_PISO_REGISTERS,
+                          NULL,
+                          NULL,
+                          SIM_selftest_piso_set_clock,
+                          SIM_selftest_piso_set_latch_shift,
+                          SIM_selftest_piso_get_serial);
+
+  SIM_SELFTEST_CHECK(SHIFTPISO_begin_new_read(&piso, bb_buffer));
+  SIM_SELFTEST_CHECK(!SHIFTPISO_begin_new_read(&piso, bb_buffer));
+
+  while (!SHIFTPISO_service(&piso))
+  {
+    services++;
+    SIM_timer_advance_ns(500);
+  }
+
+  // Latch, shift and a step per register, every step but the first waiting
+  // out the 1 us propagation delay over one more service call.
+
+  SIM_SELFTEST_CHECK(!SHIFTPISO_is_busy(&piso));
+  SIM_SELFTEST_CHECK(services == 2U * (SIM_SELFTEST_PISO_REGISTERS + 1U));
+  SIM_SELFTEST_CHECK((bb_buffer[0] == 0x5C) && (bb_buffer[1] == 0x0A));
+
+  SHIFTPISO_port_initialize(&port,
+                            SIM_SELFTEST_PISO_CLOCK,
+                            SIM_SELFTEST_PISO_LOAD,
+                            SIM_SELFTEST_PISO_SERIAL_PIN,
+                            false,
+                            SIM_selftest_piso_port_write,
+                            SIM_selftest_piso_port_read);
+
+  SHIFTPISO_port_read(&port, port_buffer, SIM_SELFTEST_PISO_REGISTERS);
+  SIM_SELFTEST_CHECK((port_buffer[0] == bb_buffer[0]) && (port_buffer[1] == bb_buffer[1]));
+}
+
+/*******************************************************************************
+ * EEPROM page wrap.
+ ******************************************************************************/
+
+static void SIM_selftest_eeprom(void)
+{
+  static uint8_t memory[32768];
+  static uint8_t page_buffer[64];
+  static bool page_dirty[64];
+  static SIM_eeprom25_t eeprom;
+  UTIMER_instance_t utimer;
+  uint8_t data[6] = {0, 1, 2, 3, 4, 5};
+  uint8_t expected[8] = {0xFF, 0xFF, 0, 1, 2, 3, 0xFF, 0xFF};
+  uint8_t read[8];
+
+  SIM_timer_initialize(&utimer, 0);
+  SIM_spi_initialize(1, 10000000);
+  SIM_eeprom25_initialize(&eeprom, memory, sizeof(memory), page_buffer, page_dirty, 64, 2, 5000000);
+  SIM_eeprom_attach(&eeprom);
+
+  // A write across the end of a page wraps to the start of the page.
+
+  SIM_SELFTEST_CHECK(SIM_eeprom_driver_write(60, 2, data, sizeof(data)));
+
+  while (!SIM_eeprom_driver_service())
+  {
+    SIM_timer_advance_ns(100000);
+  }
+
+  SIM_SELFTEST_CHECK(eeprom.page_commits == 1);
+  SIM_SELFTEST_CHECK(SIM_timer_now_ns() >= 5000000U);
+
+  SIM_SELFTEST_CHECK(SIM_eeprom_driver_read(58, 2, read, sizeof(read)));
+
+  while (!SIM_eeprom_driver_service())
+  {
+  }
+
+  SIM_SELFTEST_CHECK(UTILITIES_memcmp(read, expected, sizeof(read)) == 0);
+  SIM_SELFTEST_CHECK((memory[0] == 4) && (memory[1] == 5) && (memory[2] == 0xFF));
+}
+
+/*******************************************************************************
+ * I2C register file writes, repeated start reads and NAKs.
+ ******************************************************************************/
+
+static void SIM_selftest_i2c(void)
+{
+  static uint8_t registers[16];
+  static SIM_i2c_slave_t slave;
+  UTIMER_instance_t utimer;
+
+  SIM_timer_initialize(&utimer, 0);
+  SIM_i2c_initialize(400000);
+  SIM_i2c_attach(&slave, 0x48, registers, 16, 1);
+
+  SIM_i2c_send_start_condition();
+  SIM_i2c_write_tx_register(0x90);
+  SIM_SELFTEST_CHECK(SIM_i2c_is_ack_received());
+  SIM_i2c_write_tx_register(3);
+  SIM_i2c_write_tx_register(0xAA);
+  SIM_i2c_write_tx_register(0xBB);
+  SIM_i2c_send_stop_condition();
+  SIM_SELFTEST_CHECK((registers[3] == 0xAA) && (registers[4] == 0xBB));
+
+  SIM_i2c_send_start_condition();
+  SIM_i2c_write_tx_register(0x90);
+  SIM_i2c_write_tx_register(3);
+  SIM_i2c_send_restart_condition();
+  SIM_i2c_write_tx_register(0x91);
+  SIM_SELFTEST_CHECK(SIM_i2c_read_rx_register() == 0xAA);
+  SIM_i2c_send_ack();
+  SIM_SELFTEST_CHECK(SIM_i2c_read_rx_register() == 0xBB);
+  SIM_i2c_send_nak();
+  SIM_i2c_send_stop_condition();
+
+  SIM_i2c_send_start_condition();
+  SIM_i2c_write_tx_register(0x20);
+  SIM_SELFTEST_CHECK(SIM_i2c_error_check_nak_received());
+  SIM_i2c_send_stop_condition();
+}
+
+/*******************************************************************************
+ * UART loopback timing.
+ ******************************************************************************/
+
+static void SIM_selftest_uart(void)
+{
+  UTIMER_instance_t utimer;
+
+  SIM_timer_initialize(&utimer, 0);
+  SIM_uart_initialize(115200);
+
+  SIM_uart_write_tx_register('h');
+  SIM_uart_write_tx_register('i');
+  SIM_SELFTEST_CHECK(!SIM_uart_is_rx_ready());
+
+  // Two 10-bit frames take 174 us at 115200 baud.
+
+  SIM_timer_advance_ns(200000);
+  SIM_SELFTEST_CHECK(SIM_uart_is_rx_ready());
+  SIM_SELFTEST_CHECK(SIM_uart_read_rx_register() == 'h');
+  SIM_SELFTEST_CHECK(SIM_uart_read_rx_register() == 'i');
+}
+
+/*******************************************************************************
+ * WEBSERVER header lookup with white space after the values.
+ ******************************************************************************/
+
+static struct
+{
+  const char* request;
+  uint32_t offset;
+  bool accepted;
+  bool closed;
+  uint32_t sent_length;
+  bool handled;
+  char values[5][16];
+}
+SIM_selftest_web;
+
+static int32_t SIM_selftest_web_accept(void)
+{
+  if (SIM_selftest_web.accepted)
+  {
+    return -1;
+  }
+
+  SIM_selftest_web.accepted = true;
+  return 3;
+}
+
+static int32_t SIM_selftest_web_recv(int32_t socket, uint8_t* buffer, uint32_t length)
+{
+  uint32_t remaining = (uint32_t)strlen(SIM_selftest_web.request) - SIM_selftest_web.offset;
+
+  (void)socket;
+  length = UTILS_MIN(length, remaining);
+  memcpy(buffer, &SIM_selftest_web.request[SIM_selftest_web.offset], length);
+  SIM_selftest_web.offset += length;
+
+  return (int32_t)length;
+}
+
+static int32_t SIM_selftest_web_send(int32_t socket, const uint8_t* buffer, uint32_t length)
+{
+  (void)socket;
+  (void)buffer;
+  SIM_selftest_web.sent_length += length;
+
+  return (int32_t)length;
+}
+
+static void SIM_selftest_web_close(int32_t socket)
+{
+  (void)socket;
+  SIM_selftest_web.closed = true;
+}
+
+static uint16_t SIM_selftest_web_handler(uint32_t context,
+                                         const WEBSERVER_request_t* request,
+                                         WEBSERVER_response_t* response)
+{
+  static const char* const NAMES[] = {"host", "x-tab", "upgrade", "x-last", "x-missing"};
+
+  (void)context;
+  (void)response;
+
+  for (uint32_t i = 0; i < 5U; i++)
+  {
+    char* value = WEBSERVER_request_header(request, NAMES[i]);
+
+    snprintf(SIM_selftest_web.values[i], sizeof(SIM_selftest_web.values[i]), "%s", (value != NULL) ? value : "(null)");
+  }
+
+  SIM_selftest_web.handled = true;
+  return 204;
+}
+
+static void SIM_selftest_webserver(void)
+{
+  static const WEBSERVER_route_t ROUTES[] =
+  {
+    {"/headers", WEBSERVER_METHOD_GET, NULL, SIM_selftest_web_handler, 0, NULL},
+  };
+
+  static WEBSERVER_instance_t webserver;
+  static WEBSERVER_connection_t connections[1];
+  UTIMER_instance_t utimer;
+
+  // Trailing white space on every field, the last one included, which is
+  // terminated before its CR.
+
+  SIM_selftest_web.request = "GET /headers HTTP/1.1\r\n"
+                             "Host: x \r\n"
+                             "X-Tab:\tone\t\r\n"
+                             "Upgrade: websocket\r\n"
+                             "X-Last: last  \r\n"
+                             "\r\n";
+
+  SIM_timer_initialize(&utimer, 0);
+  WEBSERVER_initialize(&webserver, &utimer, connections, 1, ROUTES, 1, 1000000,
+                       SIM_selftest_web_accept, SIM_selftest_web_recv,
+                       SIM_selftest_web_send, SIM_selftest_web_close);
+
+  for (uint32_t i = 0; (i < 16U) && !SIM_selftest_web.handled; i++)
+  {
+    WEBSERVER_service(&webserver);
+  }
+
+  SIM_SELFTEST_CHECK(SIM_selftest_web.handled);
+  SIM_SELFTEST_CHECK(strcmp(SIM_selftest_web.values[0], "x") == 0);
+  SIM_SELFTEST_CHECK(strcmp(SIM_selftest_web.values[1], "one") == 0);
+  SIM_SELFTEST_CHECK(strcmp(SIM_selftest_web.values[2], "websocket") == 0);
+  SIM_SELFTEST_CHECK(strcmp(SIM_selftest_web.values[3], "last") == 0);
+  SIM_SELFTEST_CHECK(strcmp(SIM_selftest_web.values[4], "(null)") == 0);
+
+  for (uint32_t i = 0; (i < 16U) && (SIM_selftest_web.sent_length == 0); i++)
+  {
+    WEBSERVER_service(&webserver);
+  }
+
+  SIM_SELFTEST_CHECK(SIM_selftest_web.sent_length != 0);
+}
+
+/*******************************************************************************
+ * ILI9341 window fill through the DMA HAL.
+ ******************************************************************************/
+
+static void SIM_selftest_ili9341_command(uint8_t command, const uint8_t* parameters, uint8_t length)
+{
+  SIM_ili9341_set_dc_select(false);
+  SIM_spi_write_tx_register(command);
+  SIM_ili9341_set_dc_select(true);
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    SIM_spi_write_tx_register(parameters[i]);
+  }
+}
+
+static void SIM_selftest_ili9341(void)
+{
+  static SIM_ili9341_t lcd;
+  static uint8_t pixels[200];
+  static const uint8_t columns[4] = {0, 10, 0, 19};
+  static const uint8_t pages[4] = {0, 20, 0, 29};
+  UTIMER_instance_t utimer;
+
+  SIM_timer_initialize(&utimer, 0);
+  SIM_spi_initialize(1, 40000000);
+  SIM_ili9341_initialize(&lcd);
+  SIM_ili9341_set_chip_select(true);
+
+  SIM_selftest_ili9341_command(0x2A, columns, 4);
+  SIM_selftest_ili9341_command(0x2B, pages, 4);
+  SIM_selftest_ili9341_command(0x2C, NULL, 0);
+
+  for (uint16_t i = 0; i < sizeof(pixels); i += 2)
+  {
+    pixels[i] = 0xF8;
+    pixels[i + 1U] = 0x00;
+  }
+
+  SIM_SELFTEST_CHECK(SIM_ili9341_configure_dma(pixels, sizeof(pixels)));
+  SIM_ili9341_set_chip_select(false);
+
+  SIM_SELFTEST_CHECK(lcd.pixel_count == 100);
+  SIM_SELFTEST_CHECK(lcd.framebuffer[20U * SIM_ILI9341_WIDTH + 10U] == 0xF800);
+  SIM_SELFTEST_CHECK(lcd.framebuffer[29U * SIM_ILI9341_WIDTH + 19U] == 0xF800);
+  SIM_SELFTEST_CHECK(lcd.framebuffer[20U * SIM_ILI9341_WIDTH + 9U] == 0);
+  SIM_SELFTEST_CHECK(lcd.framebuffer[30U * SIM_ILI9341_WIDTH + 10U] == 0);
+}
+
+int main(void)
+{
+  SIM_selftest_utimer();
+  SIM_selftest_queue();
+  SIM_selftest_busmutex();
+  SIM_selftest_bibutton(false);
+  SIM_selftest_bibutton(true);
+  SIM_selftest_rotaryencoder();
+  SIM_selftest_shiftpiso();
+  SIM_selftest_eeprom();
+  SIM_selftest_i2c();
+  SIM_selftest_uart();
+  SIM_selftest_webserver();
+  SIM_selftest_ili9341();
+
+  printf("%u checks, %u failed\n", SIM_selftest.checks, SIM_selftest.failures);
+
+  return (int)UTILS_MIN(SIM_selftest.failures, 125U);
+}
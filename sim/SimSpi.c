@@ -0,0 +1,177 @@
+#include "JLibSim.h"
+
+/*******************************************************************************
+ *
+ *  Virtual SPI bus.
+ *
+ ******************************************************************************/
+
+static struct
+{
+  SIM_spi_device_t* selected;
+  uint8_t data_width_bytes;
+  uint32_t clock_hz;
+  uint32_t rx_value;
+  bool rx_ready;
+  bool error_rx_overflow;
+  bool error_frame;
+  bool error_other;
+  uint32_t burst_length;
+  uint8_t burst_buffer[SIM_SPI_BURST_LENGTH_MAX];
+}
+SIM_spi;
+
+static uint8_t SIM_spi_clock_byte(uint8_t mosi)
+{
+  if (SIM_spi.clock_hz != 0)
+  {
+    SIM_timer_advance_ns(8000000000ULL / SIM_spi.clock_hz);
+  }
+
+  // An unselected bus floats high.
+
+  if (SIM_spi.selected == NULL)
+  {
+    return 0xFF;
+  }
+
+  return SIM_spi.selected->exchange(SIM_spi.selected->model, mosi);
+}
+
+void SIM_spi_initialize(uint8_t data_width_bytes, uint32_t clock_hz)
+{
+  UTILITIES_memclear(&SIM_spi, sizeof(SIM_spi));
+
+  SIM_spi.data_width_bytes = (data_width_bytes == 0) ? 1U : UTILS_MIN(data_width_bytes, 4U);
+  SIM_spi.clock_hz = clock_hz;
+}
+
+void SIM_spi_select(SIM_spi_device_t* device)
+{
+  if (SIM_spi.selected == device)
+  {
+    return;
+  }
+
+  if (SIM_spi.selected != NULL)
+  {
+    SIM_spi.selected->select(SIM_spi.selected->model, false);
+  }
+
+  SIM_spi.selected = device;
+
+  if (device != NULL)
+  {
+    device->select(device->model, true);
+  }
+}
+
+void SIM_spi_inject_errors(bool rx_overflow, bool frame, bool other)
+{
+  SIM_spi.error_rx_overflow |= rx_overflow;
+  SIM_spi.error_frame |= frame;
+  SIM_spi.error_other |= other;
+}
+
+bool SIM_spi_is_rx_ready(void)
+{
+  return SIM_spi.rx_ready;
+}
+
+bool SIM_spi_is_tx_ready(void)
+{
+  return true;
+}
+
+uint32_t SIM_spi_read_rx_register(void)
+{
+  SIM_spi.rx_ready = false;
+
+  return SIM_spi.rx_value;
+}
+
+void SIM_spi_write_tx_register(uint32_t value)
+{
+  uint32_t rx_value = 0;
+
+  // Elements wider than a byte are clocked most significant byte first.
+
+  for (uint8_t byte_index = SIM_spi.data_width_bytes; byte_index > 0; byte_index--)
+  {
+    uint8_t mosi = (uint8_t)(value >> ((byte_index - 1U) * 8U));
+
+    rx_value = (rx_value << 8) | SIM_spi_clock_byte(mosi);
+  }
+
+  SIM_spi.rx_value = rx_value;
+  SIM_spi.rx_ready = true;
+}
+
+bool SIM_spi_is_spi_busy(void)
+{
+  return false;
+}
+
+bool SIM_spi_error_check_rx_overflow(void)
+{
+  return SIM_spi.error_rx_overflow;
+}
+
+bool SIM_spi_error_check_frame(void)
+{
+  return SIM_spi.error_frame;
+}
+
+bool SIM_spi_error_check_other(void)
+{
+  return SIM_spi.error_other;
+}
+
+void SIM_spi_clear_error_flags(void)
+{
+  SIM_spi.error_rx_overflow = false;
+  SIM_spi.error_frame = false;
+  SIM_spi.error_other = false;
+}
+
+void SIM_spi_new_task_reset(void)
+{
+  SIM_spi.rx_ready = false;
+  SIM_spi.burst_length = 0;
+}
+
+void SIM_spi_burst_write_mosi_buffer(uint8_t* buffer, uint32_t length)
+{
+  length = UTILS_MIN(length, SIM_SPI_BURST_LENGTH_MAX);
+
+  UTILITIES_memcpy(SIM_spi.burst_buffer, buffer, length);
+  SIM_spi.burst_length = length;
+}
+
+void SIM_spi_burst_write_mosi_buffer_dummy(uint32_t value, uint32_t length)
+{
+  length = UTILS_MIN(length, SIM_SPI_BURST_LENGTH_MAX);
+
+  UTILITIES_memset(SIM_spi.burst_buffer, (uint8_t)value, length);
+  SIM_spi.burst_length = length;
+}
+
+void SIM_spi_burst_read_miso_buffer(uint8_t* buffer, uint32_t length)
+{
+  UTILITIES_memcpy(buffer, SIM_spi.burst_buffer, UTILS_MIN(length, SIM_spi.burst_length));
+}
+
+void SIM_spi_burst_set_length(uint32_t length)
+{
+  SIM_spi.burst_length = UTILS_MIN(length, SIM_SPI_BURST_LENGTH_MAX);
+}
+
+void SIM_spi_burst_start(void)
+{
+  // MISO bytes replace the MOSI bytes in place, as in a hardware FIFO.
+
+  for (uint32_t index = 0; index < SIM_spi.burst_length; index++)
+  {
+    SIM_spi.burst_buffer[index] = SIM_spi_clock_byte(SIM_spi.burst_buffer[index]);
+  }
+}
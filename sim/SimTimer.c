@@ -0,0 +1,64 @@
+#include "JLibSim.h"
+
+/*******************************************************************************
+ *
+ *  Virtual timer.
+ *
+ ******************************************************************************/
+
+static struct
+{
+  UTIMER_instance_t* utimer;
+  uint64_t now_ns;
+  uint32_t auto_advance_ns;
+}
+SIM_timer;
+
+void SIM_timer_initialize(UTIMER_instance_t* utimer, uint32_t auto_advance_ns)
+{
+  SIM_timer.utimer = NULL;
+  SIM_timer.now_ns = 0;
+  SIM_timer.auto_advance_ns = auto_advance_ns;
+
+  UTIMER_initialize(utimer,
+                    SIM_TIMER_TICKS_PER_MICROSECOND,
+                    SIM_TIMER_TICKS_PER_PERIOD,
+                    SIM_timer_get_hardware_counter);
+
+  SIM_timer.utimer = utimer;
+}
+
+uint64_t SIM_timer_get_hardware_counter(void)
+{
+  // Auto advance is applied before the read, as if the time had passed, and
+  // any period interrupt been taken, since the previous read.
+
+  if ((SIM_timer.auto_advance_ns != 0) && (SIM_timer.utimer != NULL))
+  {
+    SIM_timer_advance_ns(SIM_timer.auto_advance_ns);
+  }
+
+  return SIM_timer.now_ns % SIM_TIMER_TICKS_PER_PERIOD;
+}
+
+void SIM_timer_advance_ns(uint64_t ns)
+{
+  while (ns != 0)
+  {
+    uint64_t to_boundary = SIM_TIMER_TICKS_PER_PERIOD - (SIM_timer.now_ns % SIM_TIMER_TICKS_PER_PERIOD);
+    uint64_t step = UTILS_MIN(ns, to_boundary);
+
+    SIM_timer.now_ns += step;
+    ns -= step;
+
+    if ((step == to_boundary) && (SIM_timer.utimer != NULL))
+    {
+      UTIMER_period_isr_handler(SIM_timer.utimer);
+    }
+  }
+}
+
+uint64_t SIM_timer_now_ns(void)
+{
+  return SIM_timer.now_ns;
+}
@@ -0,0 +1,122 @@
+#include "JLibSim.h"
+
+/*******************************************************************************
+ *
+ *  UART loopback.
+ *
+ ******************************************************************************/
+
+static struct
+{
+  uint32_t frame_ns;
+  uint64_t line_free_ns;
+  uint16_t head;
+  uint16_t count;
+  uint16_t elements[SIM_UART_LOOPBACK_LENGTH];
+  uint64_t arrival_ns[SIM_UART_LOOPBACK_LENGTH];
+  bool error_rx_overflow;
+  bool error_rx_frame;
+  bool error_rx_parity;
+}
+SIM_uart;
+
+void SIM_uart_initialize(uint32_t baud_rate)
+{
+  UTILITIES_memclear(&SIM_uart, sizeof(SIM_uart));
+
+  // Start bit, 8 data bits and stop bit.
+
+  SIM_uart.frame_ns = (baud_rate == 0) ? 0 : (uint32_t)(10000000000ULL / baud_rate);
+}
+
+void SIM_uart_inject_errors(bool rx_overflow, bool rx_frame, bool rx_parity)
+{
+  SIM_uart.error_rx_overflow |= rx_overflow;
+  SIM_uart.error_rx_frame |= rx_frame;
+  SIM_uart.error_rx_parity |= rx_parity;
+}
+
+bool SIM_uart_is_rx_ready(void)
+{
+  return (SIM_uart.count != 0) && (SIM_timer_now_ns() >= SIM_uart.arrival_ns[SIM_uart.head]);
+}
+
+bool SIM_uart_is_tx_ready(void)
+{
+  return (SIM_timer_now_ns() >= SIM_uart.line_free_ns);
+}
+
+bool SIM_uart_is_tx_empty(void)
+{
+  return SIM_uart_is_tx_ready();
+}
+
+uint16_t SIM_uart_read_rx_register(void)
+{
+  if (!SIM_uart_is_rx_ready())
+  {
+    return 0;
+  }
+
+  uint16_t value = SIM_uart.elements[SIM_uart.head];
+
+  SIM_uart.head = (uint16_t)((SIM_uart.head + 1U) % SIM_UART_LOOPBACK_LENGTH);
+  SIM_uart.count--;
+
+  return value;
+}
+
+void SIM_uart_write_tx_register(uint16_t value)
+{
+  // Elements arriving at a full receiver are lost, as with a hardware FIFO
+  // which is not read in time.
+
+  if (SIM_uart.count == SIM_UART_LOOPBACK_LENGTH)
+  {
+    SIM_uart.error_rx_overflow = true;
+    return;
+  }
+
+  uint64_t now_ns = SIM_timer_now_ns();
+  uint64_t start_ns = (SIM_uart.line_free_ns > now_ns) ? SIM_uart.line_free_ns : now_ns;
+  uint16_t tail = (uint16_t)((SIM_uart.head + SIM_uart.count) % SIM_UART_LOOPBACK_LENGTH);
+
+  SIM_uart.line_free_ns = start_ns + SIM_uart.frame_ns;
+  SIM_uart.elements[tail] = value;
+  SIM_uart.arrival_ns[tail] = SIM_uart.line_free_ns;
+  SIM_uart.count++;
+}
+
+bool SIM_uart_error_check_rx_overflow(void)
+{
+  return SIM_uart.error_rx_overflow;
+}
+
+bool SIM_uart_error_check_rx_frame(void)
+{
+  return SIM_uart.error_rx_frame;
+}
+
+bool SIM_uart_error_check_rx_parity(void)
+{
+  return SIM_uart.error_rx_parity;
+}
+
+void SIM_uart_clear_rx_error_flags(void)
+{
+  SIM_uart.error_rx_overflow = false;
+  SIM_uart.error_rx_frame = false;
+  SIM_uart.error_rx_parity = false;
+}
+
+void SIM_uart_clear_tx_error_flags(void)
+{
+}
+
+void SIM_uart_new_rx_task_reset(void)
+{
+}
+
+void SIM_uart_new_tx_task_reset(void)
+{
+}
@@ -0,0 +1,176 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Compiled pattern matching for the binary button module. Registered
+ *  patterns are folded into a trie keyed by log bit, newest bit first, so a
+ *  single walk of the log resolves every candidate pattern at once.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_BIBUTTON_MATCHER
+
+static bool BIBUTTON_matcher_insert(BIBUTTON_matcher_t* matcher,
+                                    BIBUTTON_pattern_instance_t* pattern_instance)
+{
+  uint16_t node_index = 0;
+
+  for (uint8_t bit_index = 0; bit_index < pattern_instance->length; bit_index++)
+  {
+    uint8_t bit = (uint8_t)((pattern_instance->pattern >> bit_index) & 1U);
+    BIBUTTON_matcher_node_t* node = &matcher->node_buffer[node_index];
+
+    if (node->child[bit] == 0)
+    {
+      if (matcher->node_count >= matcher->node_buffer_length)
+      {
+        return false;
+      }
+
+      UTILITIES_memclear(&matcher->node_buffer[matcher->node_count],
+                         sizeof(BIBUTTON_matcher_node_t));
+      node->child[bit] = matcher->node_count;
+      matcher->node_count++;
+    }
+
+    node_index = node->child[bit];
+  }
+
+  if (matcher->node_buffer[node_index].pattern == NULL)
+  {
+    matcher->node_buffer[node_index].pattern = pattern_instance;
+  }
+
+  if (pattern_instance->length > matcher->max_length)
+  {
+    matcher->max_length = pattern_instance->length;
+  }
+
+  return true;
+}
+
+// Patterns with an identical length and value share the node of the first
+// one registered, so the match is the first of them which is enabled. NULL
+// if none is, or if no pattern terminates at the node.
+
+static BIBUTTON_pattern_instance_t* BIBUTTON_matcher_enabled(BIBUTTON_pattern_instance_t* pattern_instance)
+{
+  BIBUTTON_pattern_instance_t* duplicate = pattern_instance;
+
+  while (duplicate != NULL)
+  {
+    if ((duplicate->length == pattern_instance->length) &&
+        (duplicate->pattern == pattern_instance->pattern) &&
+        !duplicate->flags.disabled)
+    {
+      return duplicate;
+    }
+
+    duplicate = (BIBUTTON_pattern_instance_t*)duplicate->next_pattern;
+  }
+
+  return NULL;
+}
+
+bool BIBUTTON_matcher_compile(BIBUTTON_instance_t* instance,
+                              BIBUTTON_matcher_t* matcher,
+                              BIBUTTON_matcher_node_t* node_buffer,
+                              uint16_t node_buffer_length)
+{
+  UTILITIES_memclear(matcher, sizeof(BIBUTTON_matcher_t));
+
+  if ((node_buffer == NULL) || (node_buffer_length == 0))
+  {
+    return false;
+  }
+
+  matcher->node_buffer = node_buffer;
+  matcher->node_buffer_length = node_buffer_length;
+  matcher->last_log = instance->log;
+  matcher->last_active_log_length = instance->active_log_length;
+
+  // Root node.
+
+  UTILITIES_memclear(&node_buffer[0], sizeof(BIBUTTON_matcher_node_t));
+  matcher->node_count = 1;
+
+  BIBUTTON_pattern_instance_t* pattern_instance = instance->registered_patterns;
+
+  while (pattern_instance != NULL)
+  {
+    if (!BIBUTTON_matcher_insert(matcher, pattern_instance))
+    {
+      return false;
+    }
+
+    pattern_instance = (BIBUTTON_pattern_instance_t*)pattern_instance->next_pattern;
+  }
+
+  return true;
+}
+
+void BIBUTTON_matcher_pattern_handler(BIBUTTON_instance_t* instance,
+                                      BIBUTTON_matcher_t* matcher)
+{
+  BIBUTTON_log_t log = instance->log;
+  BIBUTTON_pattern_instance_t* match = NULL;
+  uint8_t depth = UTILS_MIN(instance->active_log_length, matcher->max_length);
+  uint16_t node_index = 0;
+
+  for (uint8_t bit_index = 0; bit_index < depth; bit_index++)
+  {
+    node_index = matcher->node_buffer[node_index].child[log & 1U];
+
+    if (node_index == 0)
+    {
+      break;
+    }
+
+    BIBUTTON_pattern_instance_t* pattern_instance = BIBUTTON_matcher_enabled(matcher->node_buffer[node_index].pattern);
+
+    if (pattern_instance != NULL)
+    {
+      match = pattern_instance;
+    }
+
+    log >>= 1;
+  }
+
+  if (match != NULL)
+  {
+    instance->active_log_length = 0;
+
+    if (matcher->match_handler != NULL)
+    {
+      matcher->match_handler(matcher->match_handler_context, match);
+    }
+    else
+    {
+      match->callback(match->callback_context);
+    }
+  }
+}
+
+void BIBUTTON_matcher_service(BIBUTTON_instance_t* instance,
+                              BIBUTTON_matcher_t* matcher)
+{
+  if (instance->flags.disabled)
+  {
+    return;
+  }
+
+  BIBUTTON_debounce_and_hold_handler(instance);
+
+  if ((instance->log == matcher->last_log) &&
+      (instance->active_log_length == matcher->last_active_log_length))
+  {
+    return;
+  }
+
+  BIBUTTON_matcher_pattern_handler(instance, matcher);
+
+  matcher->last_log = instance->log;
+  matcher->last_active_log_length = instance->active_log_length;
+}
+
+#endif // JLIB_CONFIG_BIBUTTON_MATCHER
@@ -0,0 +1,511 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Atomic bus mutex with owner IDs, waiters and priority arbitration.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_BUSMUTEX_ATOMIC
+
+// GCC and Clang define __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4 when 32-bit atomics
+// are lock-free. ARMv6-M has no exclusive access instructions, where the
+// builtins would become library calls, hence, the critical section is used.
+
+// HAL hooks, unless bound at compile time. See JLIB_HAL_BINDINGS.
+
+#ifndef BUSMUTEX_ATOMIC_HAL_ENTER_CRITICAL
+#define BUSMUTEX_ATOMIC_HAL_ENTER_CRITICAL(instance) \
+  (((instance)->enter_critical != NULL) ? (instance)->enter_critical() : (void)0)
+#endif
+
+#ifndef BUSMUTEX_ATOMIC_HAL_EXIT_CRITICAL
+#define BUSMUTEX_ATOMIC_HAL_EXIT_CRITICAL(instance) \
+  (((instance)->exit_critical != NULL) ? (instance)->exit_critical() : (void)0)
+#endif
+
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4) && !defined(__ARM_ARCH_6M__)
+#define BUSMUTEX_ATOMIC_LOCK_FREE         1
+#else
+#define BUSMUTEX_ATOMIC_LOCK_FREE         0
+#endif
+
+static void BUSMUTEX_atomic_enter_critical(BUSMUTEX_atomic_instance_t* instance)
+{
+  (void)instance;
+
+  BUSMUTEX_ATOMIC_HAL_ENTER_CRITICAL(instance);
+}
+
+static void BUSMUTEX_atomic_exit_critical(BUSMUTEX_atomic_instance_t* instance)
+{
+  (void)instance;
+
+  BUSMUTEX_ATOMIC_HAL_EXIT_CRITICAL(instance);
+}
+
+static bool BUSMUTEX_atomic_claim(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_bus_id_t bus_id)
+{
+  uint32_t mask = 1UL << bus_id;
+  uint32_t previous;
+
+#if BUSMUTEX_ATOMIC_LOCK_FREE
+  previous = __atomic_fetch_or(&instance->claimed_mask, mask, __ATOMIC_SEQ_CST);
+#else
+  BUSMUTEX_atomic_enter_critical(instance);
+  previous = instance->claimed_mask;
+  instance->claimed_mask = previous | mask;
+  BUSMUTEX_atomic_exit_critical(instance);
+#endif
+
+  return ((previous & mask) == 0);
+}
+
+// Same as BUSMUTEX_atomic_claim, for callers already inside the critical
+// section. The HAL pair masks and unmasks interrupts and does not nest, so
+// entering it again here would unmask them on the inner exit.
+
+static bool BUSMUTEX_atomic_claim_locked(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_bus_id_t bus_id)
+{
+#if BUSMUTEX_ATOMIC_LOCK_FREE
+  return BUSMUTEX_atomic_claim(instance, bus_id);
+#else
+  uint32_t mask = 1UL << bus_id;
+  uint32_t previous = instance->claimed_mask;
+
+  instance->claimed_mask = previous | mask;
+
+  return ((previous & mask) == 0);
+#endif
+}
+
+static void BUSMUTEX_atomic_unclaim(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_bus_id_t bus_id)
+{
+  uint32_t mask = 1UL << bus_id;
+
+#if BUSMUTEX_ATOMIC_LOCK_FREE
+  __atomic_fetch_and(&instance->claimed_mask, ~mask, __ATOMIC_SEQ_CST);
+#else
+  BUSMUTEX_atomic_enter_critical(instance);
+  instance->claimed_mask &= ~mask;
+  BUSMUTEX_atomic_exit_critical(instance);
+#endif
+}
+
+#if JLIB_CONFIG_BUSMUTEX_ARBITRATION
+
+static void BUSMUTEX_atomic_increment(BUSMUTEX_atomic_instance_t* instance, uint32_t* counter)
+{
+  (void)instance;
+
+#if BUSMUTEX_ATOMIC_LOCK_FREE
+  __atomic_fetch_add(counter, 1U, __ATOMIC_RELAXED);
+#else
+  BUSMUTEX_atomic_enter_critical(instance);
+  (*counter)++;
+  BUSMUTEX_atomic_exit_critical(instance);
+#endif
+}
+
+static BUSMUTEX_client_t* BUSMUTEX_atomic_client(BUSMUTEX_atomic_instance_t* instance, uint8_t owner_id)
+{
+  if ((instance->clients == NULL) || (owner_id >= instance->client_count))
+  {
+    return NULL;
+  }
+
+  return &instance->clients[owner_id];
+}
+
+static uint8_t BUSMUTEX_atomic_histogram_bin(uint64_t hold_time_us)
+{
+  uint64_t bin_limit_us = BUSMUTEX_HOLD_HISTOGRAM_FIRST_BIN_US;
+  uint8_t bin = 0;
+
+  while ((bin < (BUSMUTEX_HOLD_HISTOGRAM_BIN_COUNT - 1U)) && (hold_time_us >= bin_limit_us))
+  {
+    bin_limit_us <<= 2;
+    bin++;
+  }
+
+  return bin;
+}
+
+// Hold statistics are only written by the owner of the bus, hence, they need
+// no protection other than the claim itself.
+
+static void BUSMUTEX_atomic_begin_hold(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_bus_id_t bus_id)
+{
+  if (instance->bus_stats == NULL)
+  {
+    return;
+  }
+
+  BUSMUTEX_bus_stats_t* stats = &instance->bus_stats[bus_id];
+
+  stats->acquisitions++;
+  UTIMER_ticket_create(instance->utimer, &stats->hold_ticket, 0);
+}
+
+static void BUSMUTEX_atomic_end_hold(BUSMUTEX_atomic_instance_t* instance,
+                                     BUSMUTEX_bus_id_t bus_id,
+                                     uint8_t owner_id)
+{
+  if (instance->bus_stats == NULL)
+  {
+    return;
+  }
+
+  BUSMUTEX_bus_stats_t* stats = &instance->bus_stats[bus_id];
+  uint64_t hold_time_us = UTIMER_ticket_elapsed_time(instance->utimer, &stats->hold_ticket);
+  BUSMUTEX_client_t* client = BUSMUTEX_atomic_client(instance, owner_id);
+
+  stats->hold_time_total_us += hold_time_us;
+  stats->hold_histogram[BUSMUTEX_atomic_histogram_bin(hold_time_us)]++;
+
+  if (hold_time_us > stats->hold_time_max_us)
+  {
+    stats->hold_time_max_us = (uint32_t)UTILS_MIN(hold_time_us, UINT32_MAX);
+    stats->hold_time_max_owner_id = owner_id;
+  }
+
+  if (client == NULL)
+  {
+    return;
+  }
+
+  client->hold_time_total_us += hold_time_us;
+
+  if ((client->hold_budget_us != 0) && (hold_time_us > client->hold_budget_us))
+  {
+    client->budget_overruns++;
+    stats->budget_overruns++;
+  }
+}
+
+static void BUSMUTEX_atomic_end_wait(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_waiter_t* waiter)
+{
+  if (instance->bus_stats == NULL)
+  {
+    return;
+  }
+
+  BUSMUTEX_bus_stats_t* stats = &instance->bus_stats[waiter->bus_id];
+  uint64_t wait_time_us = UTIMER_ticket_elapsed_time(instance->utimer, &waiter->wait_ticket);
+
+  stats->waits++;
+  stats->wait_time_total_us += wait_time_us;
+
+  if (wait_time_us > stats->wait_time_max_us)
+  {
+    stats->wait_time_max_us = (uint32_t)UTILS_MIN(wait_time_us, UINT32_MAX);
+  }
+}
+
+#else
+
+#define BUSMUTEX_atomic_begin_hold(instance, bus_id)
+#define BUSMUTEX_atomic_end_hold(instance, bus_id, owner_id)
+#define BUSMUTEX_atomic_end_wait(instance, waiter)
+
+#endif // JLIB_CONFIG_BUSMUTEX_ARBITRATION
+
+static bool BUSMUTEX_atomic_try_request(BUSMUTEX_atomic_instance_t* instance,
+                                        BUSMUTEX_bus_id_t bus_id,
+                                        uint8_t owner_id,
+                                        bool count_contention)
+{
+  if (!BUSMUTEX_atomic_claim(instance, bus_id))
+  {
+#if JLIB_CONFIG_BUSMUTEX_ARBITRATION
+    if (count_contention && (instance->bus_stats != NULL))
+    {
+      BUSMUTEX_atomic_increment(instance, &instance->bus_stats[bus_id].contentions);
+    }
+#else
+    (void)count_contention;
+#endif
+
+    return false;
+  }
+
+  instance->owner_id[bus_id] = owner_id;
+  BUSMUTEX_atomic_begin_hold(instance, bus_id);
+  TRACE_BEGIN(TRACE_ID_BUSMUTEX_HOLD, ((uint16_t)owner_id << 8) | bus_id);
+
+  return true;
+}
+
+static bool BUSMUTEX_atomic_unlink(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_waiter_t* waiter)
+{
+  BUSMUTEX_waiter_t* volatile* link = &instance->waiters[waiter->bus_id];
+
+  while (*link != NULL)
+  {
+    if (*link == waiter)
+    {
+      *link = (BUSMUTEX_waiter_t*)waiter->next_waiter;
+      return true;
+    }
+
+    link = (BUSMUTEX_waiter_t* volatile*)&(*link)->next_waiter;
+  }
+
+  return false;
+}
+
+static void BUSMUTEX_atomic_grant(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_bus_id_t bus_id)
+{
+  BUSMUTEX_atomic_enter_critical(instance);
+
+  BUSMUTEX_waiter_t* waiter = instance->waiters[bus_id];
+
+  // Another requester may have claimed the bus since it was released, in
+  // which case the waiter stays queued until that owner releases it.
+
+  if ((waiter == NULL) || !BUSMUTEX_atomic_claim_locked(instance, bus_id))
+  {
+    BUSMUTEX_atomic_exit_critical(instance);
+    return;
+  }
+
+  instance->waiters[bus_id] = (BUSMUTEX_waiter_t*)waiter->next_waiter;
+  instance->owner_id[bus_id] = waiter->owner_id;
+
+  BUSMUTEX_atomic_exit_critical(instance);
+
+  BUSMUTEX_atomic_end_wait(instance, waiter);
+  BUSMUTEX_atomic_begin_hold(instance, bus_id);
+  TRACE_BEGIN(TRACE_ID_BUSMUTEX_HOLD, ((uint16_t)waiter->owner_id << 8) | bus_id);
+
+  waiter->next_waiter = NULL;
+  waiter->granted = true;
+
+  if (waiter->callback != NULL)
+  {
+    waiter->callback(waiter->callback_context, bus_id);
+  }
+}
+
+void BUSMUTEX_atomic_initialize(BUSMUTEX_atomic_instance_t* instance,
+                                BUSMUTEX_hal_enter_critical_t enter_critical,
+                                BUSMUTEX_hal_exit_critical_t exit_critical)
+{
+  UTILITIES_memclear(instance, sizeof(BUSMUTEX_atomic_instance_t));
+
+  instance->enter_critical = enter_critical;
+  instance->exit_critical = exit_critical;
+}
+
+#if JLIB_CONFIG_BUSMUTEX_ARBITRATION
+
+void BUSMUTEX_atomic_configure_arbitration(BUSMUTEX_atomic_instance_t* instance,
+                                           UTIMER_instance_t* utimer,
+                                           BUSMUTEX_client_t* clients,
+                                           uint16_t client_count,
+                                           BUSMUTEX_bus_stats_t* bus_stats)
+{
+  UTILS_ASSERT((bus_stats == NULL) || (utimer != NULL));
+
+  instance->utimer = utimer;
+  instance->clients = clients;
+  instance->client_count = (clients == NULL) ? 0 : client_count;
+  instance->bus_stats = bus_stats;
+
+  if (bus_stats != NULL)
+  {
+    UTILITIES_memclear(bus_stats, BUSMUTEX_BUS_ID_COUNT * sizeof(BUSMUTEX_bus_stats_t));
+  }
+
+  BUSMUTEX_atomic_clear_stats(instance);
+}
+
+void BUSMUTEX_atomic_clear_stats(BUSMUTEX_atomic_instance_t* instance)
+{
+  if (instance->bus_stats != NULL)
+  {
+    for (uint8_t bus_id = 0; bus_id < BUSMUTEX_BUS_ID_COUNT; bus_id++)
+    {
+      BUSMUTEX_bus_stats_t* stats = &instance->bus_stats[bus_id];
+
+      // The hold ticket is left running so that a current hold still ends
+      // with a valid time.
+
+      UTILITIES_memclear((uint8_t*)stats + sizeof(UTIMER_ticket_t),
+                         sizeof(BUSMUTEX_bus_stats_t) - sizeof(UTIMER_ticket_t));
+    }
+  }
+
+  for (uint16_t owner_id = 0; owner_id < instance->client_count; owner_id++)
+  {
+    instance->clients[owner_id].hold_time_total_us = 0;
+    instance->clients[owner_id].budget_overruns = 0;
+  }
+}
+
+#endif // JLIB_CONFIG_BUSMUTEX_ARBITRATION
+
+bool BUSMUTEX_atomic_is_available(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_bus_id_t bus_id)
+{
+  if ((bus_id == BUSMUTEX_BUS_ID_NULL) || (bus_id >= BUSMUTEX_BUS_ID_COUNT))
+  {
+    return true;
+  }
+
+  return ((instance->claimed_mask & (1UL << bus_id)) == 0);
+}
+
+uint8_t BUSMUTEX_atomic_get_owner(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_bus_id_t bus_id)
+{
+  if ((bus_id == BUSMUTEX_BUS_ID_NULL) || (bus_id >= BUSMUTEX_BUS_ID_COUNT))
+  {
+    return BUSMUTEX_OWNER_ID_NONE;
+  }
+
+  return instance->owner_id[bus_id];
+}
+
+bool BUSMUTEX_atomic_request_mutex(BUSMUTEX_atomic_instance_t* instance,
+                                   BUSMUTEX_bus_id_t bus_id,
+                                   uint8_t owner_id)
+{
+  if ((bus_id == BUSMUTEX_BUS_ID_NULL) || (bus_id >= BUSMUTEX_BUS_ID_COUNT))
+  {
+    return true;
+  }
+
+  UTILS_ASSERT(owner_id != BUSMUTEX_OWNER_ID_NONE);
+
+  return BUSMUTEX_atomic_try_request(instance, bus_id, owner_id, true);
+}
+
+bool BUSMUTEX_atomic_request_or_wait(BUSMUTEX_atomic_instance_t* instance,
+                                     BUSMUTEX_bus_id_t bus_id,
+                                     uint8_t owner_id,
+                                     BUSMUTEX_waiter_t* waiter)
+{
+  if (BUSMUTEX_atomic_request_mutex(instance, bus_id, owner_id))
+  {
+    return true;
+  }
+
+  waiter->granted = false;
+  waiter->owner_id = owner_id;
+  waiter->bus_id = (uint8_t)bus_id;
+  waiter->priority = 0;
+
+#if JLIB_CONFIG_BUSMUTEX_ARBITRATION
+  BUSMUTEX_client_t* client = BUSMUTEX_atomic_client(instance, owner_id);
+
+  if (client != NULL)
+  {
+    waiter->priority = client->priority;
+  }
+
+  if (instance->bus_stats != NULL)
+  {
+    UTIMER_ticket_create(instance->utimer, &waiter->wait_ticket, 0);
+  }
+#endif
+
+  BUSMUTEX_atomic_enter_critical(instance);
+
+  BUSMUTEX_waiter_t* volatile* link = &instance->waiters[bus_id];
+
+  while ((*link != NULL) && ((*link)->priority >= waiter->priority))
+  {
+    link = (BUSMUTEX_waiter_t* volatile*)&(*link)->next_waiter;
+  }
+
+  waiter->next_waiter = *link;
+  *link = waiter;
+
+  BUSMUTEX_atomic_exit_critical(instance);
+
+  TRACE_INSTANT(TRACE_ID_BUSMUTEX_WAIT, ((uint16_t)owner_id << 8) | bus_id);
+
+  // The owner may have released the bus before the waiter was queued, without
+  // seeing it. Retrying once after queueing closes that window, as a release
+  // from here on finds the waiter.
+
+  if (!BUSMUTEX_atomic_try_request(instance, bus_id, owner_id, false))
+  {
+    return false;
+  }
+
+  BUSMUTEX_atomic_enter_critical(instance);
+  BUSMUTEX_atomic_unlink(instance, waiter);
+  BUSMUTEX_atomic_exit_critical(instance);
+
+  return true;
+}
+
+bool BUSMUTEX_atomic_cancel_wait(BUSMUTEX_atomic_instance_t* instance, BUSMUTEX_waiter_t* waiter)
+{
+  BUSMUTEX_atomic_enter_critical(instance);
+  bool unlinked = BUSMUTEX_atomic_unlink(instance, waiter);
+  BUSMUTEX_atomic_exit_critical(instance);
+
+  return unlinked;
+}
+
+bool BUSMUTEX_atomic_release_mutex(BUSMUTEX_atomic_instance_t* instance,
+                                   BUSMUTEX_bus_id_t bus_id,
+                                   uint8_t owner_id)
+{
+  if ((bus_id == BUSMUTEX_BUS_ID_NULL) || (bus_id >= BUSMUTEX_BUS_ID_COUNT))
+  {
+    return true;
+  }
+
+  if ((owner_id == BUSMUTEX_OWNER_ID_NONE) || (instance->owner_id[bus_id] != owner_id))
+  {
+    return false;
+  }
+
+  BUSMUTEX_atomic_end_hold(instance, bus_id, owner_id);
+  TRACE_END(TRACE_ID_BUSMUTEX_HOLD, ((uint16_t)owner_id << 8) | bus_id);
+
+  instance->owner_id[bus_id] = BUSMUTEX_OWNER_ID_NONE;
+  BUSMUTEX_atomic_unclaim(instance, bus_id);
+
+  // Waiters are only looked at once the bus has been released, so that a
+  // waiter queued concurrently either sees the release or is seen here.
+
+  if (instance->waiters[bus_id] != NULL)
+  {
+    BUSMUTEX_atomic_grant(instance, bus_id);
+  }
+
+  return true;
+}
+
+#if JLIB_CONFIG_BUSMUTEX_ARBITRATION
+
+bool BUSMUTEX_atomic_should_yield(BUSMUTEX_atomic_instance_t* instance,
+                                  BUSMUTEX_bus_id_t bus_id,
+                                  uint8_t owner_id)
+{
+  if ((bus_id == BUSMUTEX_BUS_ID_NULL) ||
+      (bus_id >= BUSMUTEX_BUS_ID_COUNT) ||
+      (instance->bus_stats == NULL) ||
+      (instance->waiters[bus_id] == NULL) ||
+      (instance->owner_id[bus_id] != owner_id))
+  {
+    return false;
+  }
+
+  BUSMUTEX_client_t* client = BUSMUTEX_atomic_client(instance, owner_id);
+
+  if ((client == NULL) || (client->hold_budget_us == 0))
+  {
+    return false;
+  }
+
+  return (UTIMER_ticket_elapsed_time(instance->utimer, &instance->bus_stats[bus_id].hold_ticket) >
+          client->hold_budget_us);
+}
+
+#endif // JLIB_CONFIG_BUSMUTEX_ARBITRATION
+
+#endif // JLIB_CONFIG_BUSMUTEX_ATOMIC
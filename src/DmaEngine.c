@@ -0,0 +1,236 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  DMA channel engine with descriptor chains and automatic chunking.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_DMAENGINE
+
+// HAL hooks, unless bound at compile time. See JLIB_HAL_BINDINGS.
+
+#ifndef DMAENGINE_HAL_START
+#define DMAENGINE_HAL_START(channel, src_addr, src_length) (channel)->start((src_addr), (src_length))
+#endif
+
+#ifndef DMAENGINE_HAL_STOP
+#define DMAENGINE_HAL_STOP(channel) (channel)->stop()
+#endif
+
+static void DMAENGINE_skip_empty(DMAENGINE_channel_t* channel)
+{
+  while ((channel->descriptor != NULL) && (channel->descriptor_offset >= channel->descriptor->length))
+  {
+    channel->descriptor = (DMAENGINE_descriptor_t*)channel->descriptor->next_descriptor;
+    channel->descriptor_offset = 0;
+  }
+}
+
+static void DMAENGINE_rewind(DMAENGINE_channel_t* channel)
+{
+  channel->descriptor = channel->chain;
+  channel->descriptor_offset = 0;
+  channel->transferred_length = 0;
+  channel->flags.half_signaled = 0;
+
+  DMAENGINE_skip_empty(channel);
+}
+
+static bool DMAENGINE_start_segment(DMAENGINE_channel_t* channel)
+{
+  uint32_t length = UTILS_MIN(channel->descriptor->length - channel->descriptor_offset,
+                              channel->max_segment_length);
+  uint32_t half_length = channel->chain_length / 2U;
+
+  // The segment is cut at half of the chain so that the half complete
+  // callback is not late by up to a whole segment.
+
+  if (!channel->flags.half_signaled &&
+      (channel->transferred_length < half_length) &&
+      ((channel->transferred_length + length) > half_length))
+  {
+    length = half_length - channel->transferred_length;
+  }
+
+  channel->segment_length = length;
+
+  TRACE_BEGIN(TRACE_ID_DMAENGINE_SEGMENT, TRACE_CHANNEL_KEY(channel));
+
+  return DMAENGINE_HAL_START(channel, (uint8_t*)channel->descriptor->data + channel->descriptor_offset, length);
+}
+
+static void DMAENGINE_fail(DMAENGINE_channel_t* channel)
+{
+  DMAENGINE_HAL_STOP(channel);
+  channel->flags.busy = 0;
+  channel->flags.error = 1;
+
+  TRACE_INSTANT(TRACE_ID_DMAENGINE_ERROR, TRACE_CHANNEL_KEY(channel));
+
+  if (channel->error_callback != NULL)
+  {
+    channel->error_callback(channel->callback_context);
+  }
+}
+
+void DMAENGINE_initialize(DMAENGINE_channel_t* channel,
+                          uint32_t max_segment_length,
+                          DMAENGINE_hal_start_t start,
+                          DMAENGINE_hal_stop_t stop)
+{
+  UTILS_ASSERT(max_segment_length != 0);
+
+  UTILITIES_memclear(channel, sizeof(DMAENGINE_channel_t));
+
+  channel->max_segment_length = max_segment_length;
+  channel->start = start;
+  channel->stop = stop;
+}
+
+void DMAENGINE_set_callbacks(DMAENGINE_channel_t* channel,
+                             uint32_t callback_context,
+                             DMAENGINE_callback_t half_complete_callback,
+                             DMAENGINE_callback_t complete_callback,
+                             DMAENGINE_callback_t error_callback)
+{
+  channel->callback_context = callback_context;
+  channel->half_complete_callback = half_complete_callback;
+  channel->complete_callback = complete_callback;
+  channel->error_callback = error_callback;
+}
+
+bool DMAENGINE_submit(DMAENGINE_channel_t* channel, DMAENGINE_descriptor_t* chain, bool circular)
+{
+  if (channel->flags.busy)
+  {
+    return false;
+  }
+
+  uint32_t chain_length = 0;
+
+  for (DMAENGINE_descriptor_t* descriptor = chain;
+       descriptor != NULL;
+       descriptor = (DMAENGINE_descriptor_t*)descriptor->next_descriptor)
+  {
+    chain_length += descriptor->length;
+  }
+
+  if (chain_length == 0)
+  {
+    return false;
+  }
+
+  channel->chain = chain;
+  channel->chain_length = chain_length;
+  channel->flags.circular = circular;
+  channel->flags.error = 0;
+
+  DMAENGINE_rewind(channel);
+
+  channel->flags.busy = 1;
+
+  if (!DMAENGINE_start_segment(channel))
+  {
+    channel->flags.busy = 0;
+    channel->flags.error = 1;
+    return false;
+  }
+
+  return true;
+}
+
+bool DMAENGINE_transfer(DMAENGINE_channel_t* channel, void* data, uint32_t length)
+{
+  if (channel->flags.busy)
+  {
+    return false;
+  }
+
+  channel->single_descriptor.data = data;
+  channel->single_descriptor.length = length;
+  channel->single_descriptor.next_descriptor = NULL;
+
+  return DMAENGINE_submit(channel, &channel->single_descriptor, false);
+}
+
+void DMAENGINE_abort(DMAENGINE_channel_t* channel)
+{
+  DMAENGINE_HAL_STOP(channel);
+  channel->flags.busy = 0;
+}
+
+bool DMAENGINE_is_busy(DMAENGINE_channel_t* channel)
+{
+  return channel->flags.busy;
+}
+
+void DMAENGINE_transfer_complete_isr_handler(DMAENGINE_channel_t* channel)
+{
+  if (!channel->flags.busy)
+  {
+    return;
+  }
+
+  TRACE_END(TRACE_ID_DMAENGINE_SEGMENT, TRACE_CHANNEL_KEY(channel));
+
+  channel->segment_count++;
+  channel->transferred_length += channel->segment_length;
+  channel->descriptor_offset += channel->segment_length;
+
+  bool half_complete = false;
+  bool complete = false;
+
+  if (!channel->flags.half_signaled && (channel->transferred_length >= (channel->chain_length / 2U)))
+  {
+    channel->flags.half_signaled = 1;
+    half_complete = true;
+  }
+
+  DMAENGINE_skip_empty(channel);
+
+  if (channel->descriptor == NULL)
+  {
+    complete = true;
+
+    if (channel->flags.circular)
+    {
+      DMAENGINE_rewind(channel);
+    }
+    else
+    {
+      channel->flags.busy = 0;
+    }
+  }
+
+  // The next segment is started first to keep the gap between segments
+  // short. The callbacks then run while it is transferred.
+
+  if (channel->flags.busy && !DMAENGINE_start_segment(channel))
+  {
+    DMAENGINE_fail(channel);
+    return;
+  }
+
+  if (half_complete && (channel->half_complete_callback != NULL))
+  {
+    channel->half_complete_callback(channel->callback_context);
+  }
+
+  if (complete && (channel->complete_callback != NULL))
+  {
+    channel->complete_callback(channel->callback_context);
+  }
+}
+
+void DMAENGINE_transfer_error_isr_handler(DMAENGINE_channel_t* channel)
+{
+  if (!channel->flags.busy)
+  {
+    return;
+  }
+
+  DMAENGINE_fail(channel);
+}
+
+#endif // JLIB_CONFIG_DMAENGINE
@@ -0,0 +1,233 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Cooperative task executor for the module service routines.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_EXECUTOR
+
+// HAL hooks, unless bound at compile time. See JLIB_HAL_BINDINGS.
+
+#ifndef EXECUTOR_HAL_ENTER_CRITICAL
+#define EXECUTOR_HAL_ENTER_CRITICAL(instance) \
+  (((instance)->enter_critical != NULL) ? (instance)->enter_critical() : (void)0)
+#endif
+
+#ifndef EXECUTOR_HAL_EXIT_CRITICAL
+#define EXECUTOR_HAL_EXIT_CRITICAL(instance) \
+  (((instance)->exit_critical != NULL) ? (instance)->exit_critical() : (void)0)
+#endif
+
+#ifndef EXECUTOR_HAL_SLEEP
+#define EXECUTOR_HAL_SLEEP(instance, sleep_us) (instance)->sleep(sleep_us)
+#define EXECUTOR_HAL_SLEEP_IS_SET(instance) ((instance)->sleep != NULL)
+#else
+#define EXECUTOR_HAL_SLEEP_IS_SET(instance) true
+#endif
+
+static void EXECUTOR_arm_deadline(EXECUTOR_instance_t* instance, EXECUTOR_task_t* task, uint64_t delay_us)
+{
+  task->deadline_us = delay_us;
+  task->flags.deadline_armed = 1;
+
+  UTIMER_ticket_create(instance->utimer, &task->deadline_ticket, delay_us);
+}
+
+static bool EXECUTOR_task_is_due(EXECUTOR_instance_t* instance, EXECUTOR_task_t* task)
+{
+  return task->flags.ready ||
+         task->notified ||
+         (task->flags.deadline_armed && UTIMER_ticket_has_expired(instance->utimer, &task->deadline_ticket));
+}
+
+static void EXECUTOR_run_task(EXECUTOR_instance_t* instance, EXECUTOR_task_t* task)
+{
+  // Notifications are cleared before the pass, so that one given while the
+  // service routine runs leads to another pass.
+
+  task->notified = false;
+  task->flags.ready = 0;
+  task->flags.deadline_armed = 0;
+
+#if JLIB_CONFIG_SERVICESTATS
+  bool idle = (task->stats != NULL) ? SERVICESTATS_service(task->stats, task->service, task->instance) :
+                                      task->service(task->instance);
+#else
+  bool idle = task->service(task->instance);
+#endif
+
+  task->run_count++;
+  task->flags.busy = !idle;
+
+  if (!idle)
+  {
+    if (task->busy_period_us == 0)
+    {
+      task->flags.ready = 1;
+    }
+    else
+    {
+      EXECUTOR_arm_deadline(instance, task, task->busy_period_us);
+    }
+  }
+  else if (task->idle_period_us != 0)
+  {
+    EXECUTOR_arm_deadline(instance, task, task->idle_period_us);
+  }
+}
+
+static void EXECUTOR_enter_critical(EXECUTOR_instance_t* instance)
+{
+  (void)instance;
+
+  EXECUTOR_HAL_ENTER_CRITICAL(instance);
+}
+
+static void EXECUTOR_exit_critical(EXECUTOR_instance_t* instance)
+{
+  (void)instance;
+
+  EXECUTOR_HAL_EXIT_CRITICAL(instance);
+}
+
+void EXECUTOR_initialize(EXECUTOR_instance_t* instance,
+                         UTIMER_instance_t* utimer,
+                         EXECUTOR_hal_enter_critical_t enter_critical,
+                         EXECUTOR_hal_exit_critical_t exit_critical,
+                         EXECUTOR_hal_sleep_t sleep)
+{
+  UTILITIES_memclear(instance, sizeof(EXECUTOR_instance_t));
+
+  instance->utimer = utimer;
+  instance->enter_critical = enter_critical;
+  instance->exit_critical = exit_critical;
+  instance->sleep = sleep;
+}
+
+void EXECUTOR_register(EXECUTOR_instance_t* instance,
+                       EXECUTOR_task_t* task,
+                       EXECUTOR_service_t service,
+                       void* module_instance,
+                       uint32_t busy_period_us,
+                       uint32_t idle_period_us)
+{
+  UTILITIES_memclear(task, sizeof(EXECUTOR_task_t));
+
+  task->service = service;
+  task->instance = module_instance;
+  task->busy_period_us = busy_period_us;
+  task->idle_period_us = idle_period_us;
+  task->flags.ready = 1;
+
+  // Tasks are appended, so that they run in the order registered.
+
+  EXECUTOR_task_t** link = &instance->tasks;
+
+  while (*link != NULL)
+  {
+    link = (EXECUTOR_task_t**)&(*link)->next_task;
+  }
+
+  *link = task;
+}
+
+void EXECUTOR_notify(EXECUTOR_instance_t* instance, EXECUTOR_task_t* task)
+{
+  task->notified = true;
+  instance->notified = true;
+}
+
+void EXECUTOR_schedule(EXECUTOR_instance_t* instance, EXECUTOR_task_t* task, uint64_t delay_us)
+{
+  EXECUTOR_arm_deadline(instance, task, delay_us);
+}
+
+#if JLIB_CONFIG_SERVICESTATS
+void EXECUTOR_set_stats(EXECUTOR_task_t* task, SERVICESTATS_instance_t* stats)
+{
+  task->stats = stats;
+}
+#endif
+
+bool EXECUTOR_service(EXECUTOR_instance_t* instance)
+{
+  bool ran = false;
+  bool ready = false;
+  uint16_t task_index = 0;
+
+  instance->notified = false;
+
+  for (EXECUTOR_task_t* task = instance->tasks; task != NULL; task = (EXECUTOR_task_t*)task->next_task)
+  {
+    if (EXECUTOR_task_is_due(instance, task))
+    {
+      TRACE_BEGIN(TRACE_ID_EXECUTOR_TASK, task_index);
+      EXECUTOR_run_task(instance, task);
+      TRACE_END(TRACE_ID_EXECUTOR_TASK, task_index);
+      ran = true;
+    }
+
+    ready |= task->flags.ready;
+    task_index++;
+  }
+
+  if (ran)
+  {
+    instance->pass_count++;
+  }
+
+  // A task earlier in the list may have been notified while later ones ran.
+
+  return !ready && !instance->notified;
+}
+
+void EXECUTOR_sleep(EXECUTOR_instance_t* instance)
+{
+  if (!EXECUTOR_HAL_SLEEP_IS_SET(instance))
+  {
+    return;
+  }
+
+  uint64_t sleep_us = EXECUTOR_SLEEP_FOREVER;
+
+  for (EXECUTOR_task_t* task = instance->tasks; task != NULL; task = (EXECUTOR_task_t*)task->next_task)
+  {
+    if (task->flags.ready)
+    {
+      return;
+    }
+
+    if (task->flags.deadline_armed)
+    {
+      uint64_t elapsed_us = UTIMER_ticket_elapsed_time(instance->utimer, &task->deadline_ticket);
+
+      if (elapsed_us >= task->deadline_us)
+      {
+        return;
+      }
+
+      sleep_us = UTILS_MIN(sleep_us, task->deadline_us - elapsed_us);
+    }
+  }
+
+  // Trace points may take the TRACE critical section, whose exit would unmask
+  // interrupts between the notified check and the sleep, and a notify in
+  // between would be lost. The sleep is traced outside of the critical
+  // section instead, as a short span if a notify is already pending.
+
+  TRACE_BEGIN(TRACE_ID_EXECUTOR_SLEEP, 0);
+  EXECUTOR_enter_critical(instance);
+
+  if (!instance->notified)
+  {
+    instance->sleep_count++;
+    EXECUTOR_HAL_SLEEP(instance, sleep_us);
+  }
+
+  EXECUTOR_exit_critical(instance);
+  TRACE_END(TRACE_ID_EXECUTOR_SLEEP, 0);
+}
+
+#endif // JLIB_CONFIG_EXECUTOR
@@ -0,0 +1,1241 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Clipping for GFX2D.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_GFX2DCLIP
+
+#define GFX2DCLIP_OUTSIDE                 0U
+#define GFX2DCLIP_PARTIAL                 1U
+#define GFX2DCLIP_INSIDE                  2U
+
+#define GFX2DCLIP_OUTCODE_LEFT            0x01U
+#define GFX2DCLIP_OUTCODE_RIGHT           0x02U
+#define GFX2DCLIP_OUTCODE_TOP             0x04U
+#define GFX2DCLIP_OUTCODE_BOTTOM          0x08U
+
+// Circle corners, as numbered by the Adafruit GFX circle helpers.
+
+#define GFX2DCLIP_CORNER_TOP_LEFT         0x01U
+#define GFX2DCLIP_CORNER_TOP_RIGHT        0x02U
+#define GFX2DCLIP_CORNER_BOTTOM_RIGHT     0x04U
+#define GFX2DCLIP_CORNER_BOTTOM_LEFT      0x08U
+#define GFX2DCLIP_CORNER_ALL              0x0FU
+
+static int16_t GFX2DCLIP_clamp(int32_t value)
+{
+  return (int16_t)UTILS_MAX(UTILS_MIN(value, INT16_MAX), INT16_MIN);
+}
+
+// Range of the pixels of a line or side starting at a coordinate, with GFX2D
+// drawing negative lengths backwards from it. A length of 0 gives an empty
+// range.
+
+static void GFX2DCLIP_span(int16_t start, int16_t length, int32_t* low, int32_t* high)
+{
+  if (length >= 0)
+  {
+    *low = start;
+    *high = (int32_t)start + length - 1;
+  }
+  else
+  {
+    *low = (int32_t)start + length + 1;
+    *high = start;
+  }
+}
+
+static void GFX2DCLIP_swap(int32_t* x0, int32_t* y0, int32_t* x1, int32_t* y1)
+{
+  int32_t x = *x0;
+  int32_t y = *y0;
+
+  *x0 = *x1;
+  *y0 = *y1;
+  *x1 = x;
+  *y1 = y;
+}
+
+// Sets the bounds to the intersection of the top clip rectangle and the
+// canvas. The canvas is mapped back through the inversion, as GFX2D inverts
+// the coordinates of each call.
+
+static bool GFX2DCLIP_update(GFX2DCLIP_instance_t* clip)
+{
+  GFX2DCLIP_rectangle_t* bounds = &clip->bounds;
+  GFX2D_instance_t* gfx = clip->gfx;
+
+  if (clip->depth != 0)
+  {
+    *bounds = clip->stack[clip->depth - 1];
+  }
+  else
+  {
+    bounds->left = INT16_MIN;
+    bounds->top = INT16_MIN;
+    bounds->right = INT16_MAX;
+    bounds->bottom = INT16_MAX;
+  }
+
+  if (gfx != NULL)
+  {
+    int32_t left = gfx->canvas_x0;
+    int32_t top = gfx->canvas_y0;
+
+    if (gfx->flags.invert)
+    {
+      left = (int32_t)gfx->display_target_width - gfx->canvas_x0 - gfx->canvas_width;
+      top = (int32_t)gfx->display_target_height - gfx->canvas_y0 - gfx->canvas_height;
+    }
+
+    bounds->left = GFX2DCLIP_clamp(UTILS_MAX(left, bounds->left));
+    bounds->top = GFX2DCLIP_clamp(UTILS_MAX(top, bounds->top));
+    bounds->right = GFX2DCLIP_clamp(UTILS_MIN(left + gfx->canvas_width - 1, bounds->right));
+    bounds->bottom = GFX2DCLIP_clamp(UTILS_MIN(top + gfx->canvas_height - 1, bounds->bottom));
+  }
+
+  return (bounds->left <= bounds->right) && (bounds->top <= bounds->bottom);
+}
+
+static uint8_t GFX2DCLIP_test(GFX2DCLIP_instance_t* clip,
+                              int32_t left,
+                              int32_t top,
+                              int32_t right,
+                              int32_t bottom)
+{
+  GFX2DCLIP_rectangle_t* bounds = &clip->bounds;
+
+  if ((right < bounds->left) || (left > bounds->right) || (bottom < bounds->top) || (top > bounds->bottom))
+  {
+    return GFX2DCLIP_OUTSIDE;
+  }
+
+  if ((left >= bounds->left) && (right <= bounds->right) && (top >= bounds->top) && (bottom <= bounds->bottom))
+  {
+    return GFX2DCLIP_INSIDE;
+  }
+
+  return GFX2DCLIP_PARTIAL;
+}
+
+static void GFX2DCLIP_pixel(GFX2DCLIP_instance_t* clip, int32_t x, int32_t y, uint32_t color)
+{
+  GFX2DCLIP_rectangle_t* bounds = &clip->bounds;
+
+  if ((x >= bounds->left) && (x <= bounds->right) && (y >= bounds->top) && (y <= bounds->bottom))
+  {
+    GFX2D_draw_pixel(clip->gfx, (int16_t)x, (int16_t)y, color);
+  }
+}
+
+// Fills the visible part of a box, inclusive of all four edges. Single rows
+// and columns use the line handlers of GFX2D.
+
+static void GFX2DCLIP_fill(GFX2DCLIP_instance_t* clip,
+                           int32_t left,
+                           int32_t top,
+                           int32_t right,
+                           int32_t bottom,
+                           uint32_t color)
+{
+  GFX2DCLIP_rectangle_t* bounds = &clip->bounds;
+
+  left = UTILS_MAX(left, bounds->left);
+  top = UTILS_MAX(top, bounds->top);
+  right = UTILS_MIN(right, bounds->right);
+  bottom = UTILS_MIN(bottom, bounds->bottom);
+
+  if ((left > right) || (top > bottom))
+  {
+    return;
+  }
+
+  if (top == bottom)
+  {
+    GFX2D_draw_hline(clip->gfx, (int16_t)left, (int16_t)top, (int16_t)(right - left + 1), color);
+  }
+  else if (left == right)
+  {
+    GFX2D_draw_vline(clip->gfx, (int16_t)left, (int16_t)top, (int16_t)(bottom - top + 1), color);
+  }
+  else
+  {
+    GFX2D_draw_filled_rectangle(clip->gfx,
+                                (int16_t)left,
+                                (int16_t)top,
+                                (int16_t)(right - left + 1),
+                                (int16_t)(bottom - top + 1),
+                                color);
+  }
+}
+
+static uint8_t GFX2DCLIP_outcode(int32_t left,
+                                 int32_t top,
+                                 int32_t right,
+                                 int32_t bottom,
+                                 int32_t x,
+                                 int32_t y)
+{
+  uint8_t code = 0;
+
+  if (x < left)
+  {
+    code |= GFX2DCLIP_OUTCODE_LEFT;
+  }
+  else if (x > right)
+  {
+    code |= GFX2DCLIP_OUTCODE_RIGHT;
+  }
+
+  if (y < top)
+  {
+    code |= GFX2DCLIP_OUTCODE_TOP;
+  }
+  else if (y > bottom)
+  {
+    code |= GFX2DCLIP_OUTCODE_BOTTOM;
+  }
+
+  return code;
+}
+
+// Cohen-Sutherland clipping of a line to a box. Returns false if the line
+// lies outside of it. Intersections are computed from the original ends, so
+// the rounding of one does not add to the next.
+
+static bool GFX2DCLIP_cohen_sutherland(int32_t left,
+                                       int32_t top,
+                                       int32_t right,
+                                       int32_t bottom,
+                                       int32_t* x0,
+                                       int32_t* y0,
+                                       int32_t* x1,
+                                       int32_t* y1)
+{
+  int32_t line_x0 = *x0;
+  int32_t line_y0 = *y0;
+  int64_t dx = *x1 - *x0;
+  int64_t dy = *y1 - *y0;
+  uint8_t code0 = GFX2DCLIP_outcode(left, top, right, bottom, *x0, *y0);
+  uint8_t code1 = GFX2DCLIP_outcode(left, top, right, bottom, *x1, *y1);
+
+  while ((code0 | code1) != 0)
+  {
+    if ((code0 & code1) != 0)
+    {
+      return false;
+    }
+
+    uint8_t code = (code0 != 0) ? code0 : code1;
+    int32_t x;
+    int32_t y;
+
+    if (code & GFX2DCLIP_OUTCODE_TOP)
+    {
+      x = line_x0 + (int32_t)(dx * (top - line_y0) / dy);
+      y = top;
+    }
+    else if (code & GFX2DCLIP_OUTCODE_BOTTOM)
+    {
+      x = line_x0 + (int32_t)(dx * (bottom - line_y0) / dy);
+      y = bottom;
+    }
+    else if (code & GFX2DCLIP_OUTCODE_RIGHT)
+    {
+      x = right;
+      y = line_y0 + (int32_t)(dy * (right - line_x0) / dx);
+    }
+    else
+    {
+      x = left;
+      y = line_y0 + (int32_t)(dy * (left - line_x0) / dx);
+    }
+
+    if (code == code0)
+    {
+      *x0 = x;
+      *y0 = y;
+      code0 = GFX2DCLIP_outcode(left, top, right, bottom, x, y);
+    }
+    else
+    {
+      *x1 = x;
+      *y1 = y;
+      code1 = GFX2DCLIP_outcode(left, top, right, bottom, x, y);
+    }
+  }
+
+  return true;
+}
+
+// Draws the visible part of a diagonal line crossing the bounds. The line is
+// clipped to the bounds widened by a pixel, as Bresenham rounds to the nearest
+// pixel, and the clipped ends, widened by another pixel for the rounding of
+// the intersections, are the range of the major axis to step. Stepping starts
+// with the error term Bresenham has at that point, so the pixels are those of
+// the whole line. Each run of pixels on the major axis is drawn as one line,
+// trimmed to the bounds.
+
+static void GFX2DCLIP_clip_line(GFX2DCLIP_instance_t* clip,
+                                int32_t x0,
+                                int32_t y0,
+                                int32_t x1,
+                                int32_t y1,
+                                uint32_t color)
+{
+  GFX2DCLIP_rectangle_t* bounds = &clip->bounds;
+  int32_t clipped_x0 = x0;
+  int32_t clipped_y0 = y0;
+  int32_t clipped_x1 = x1;
+  int32_t clipped_y1 = y1;
+
+  if (!GFX2DCLIP_cohen_sutherland((int32_t)bounds->left - 1,
+                                  (int32_t)bounds->top - 1,
+                                  (int32_t)bounds->right + 1,
+                                  (int32_t)bounds->bottom + 1,
+                                  &clipped_x0,
+                                  &clipped_y0,
+                                  &clipped_x1,
+                                  &clipped_y1))
+  {
+    return;
+  }
+
+  bool steep = UTILS_MAX(y1 - y0, y0 - y1) > UTILS_MAX(x1 - x0, x0 - x1);
+  int32_t major0 = steep ? y0 : x0;
+  int32_t minor0 = steep ? x0 : y0;
+  int32_t major1 = steep ? y1 : x1;
+  int32_t minor1 = steep ? x1 : y1;
+  int32_t low = steep ? UTILS_MIN(clipped_y0, clipped_y1) : UTILS_MIN(clipped_x0, clipped_x1);
+  int32_t high = steep ? UTILS_MAX(clipped_y0, clipped_y1) : UTILS_MAX(clipped_x0, clipped_x1);
+
+  if (major0 > major1)
+  {
+    GFX2DCLIP_swap(&major0, &minor0, &major1, &minor1);
+  }
+
+  uint32_t dx = (uint32_t)(major1 - major0);
+  uint32_t dy = (uint32_t)UTILS_MAX(minor1 - minor0, minor0 - minor1);
+  int32_t minor_step = (minor0 < minor1) ? 1 : -1;
+  uint32_t first = (uint32_t)(UTILS_MAX(low - 1, major0) - major0);
+  uint32_t last = (uint32_t)(UTILS_MIN(high + 1, major1) - major0);
+
+  // Bresenham starts with an error of dx / 2, and takes a minor step each
+  // time dy is subtracted below 0, adding dx back.
+
+  uint32_t rise = first * dy;
+  uint32_t half = dx / 2U;
+  uint32_t steps = (rise > half) ? (rise - half + dx - 1U) / dx : 0;
+  int32_t error = (int32_t)(half + steps * dx - rise);
+  int32_t minor = minor0 + minor_step * (int32_t)steps;
+  int32_t run_start = major0 + (int32_t)first;
+
+  for (uint32_t i = first; i <= last; i++)
+  {
+    error -= (int32_t)dy;
+
+    if ((error < 0) || (i == last))
+    {
+      int32_t run_end = major0 + (int32_t)i;
+
+      if (steep)
+      {
+        GFX2DCLIP_fill(clip, minor, run_start, minor, run_end, color);
+      }
+      else
+      {
+        GFX2DCLIP_fill(clip, run_start, minor, run_end, minor, color);
+      }
+
+      minor += minor_step;
+      error += (int32_t)dx;
+      run_start = run_end + 1;
+    }
+  }
+}
+
+static void GFX2DCLIP_line(GFX2DCLIP_instance_t* clip,
+                           int16_t x0,
+                           int16_t y0,
+                           int16_t x1,
+                           int16_t y1,
+                           uint32_t color)
+{
+  if ((x0 == x1) || (y0 == y1))
+  {
+    GFX2DCLIP_fill(clip, UTILS_MIN(x0, x1), UTILS_MIN(y0, y1), UTILS_MAX(x0, x1), UTILS_MAX(y0, y1), color);
+    return;
+  }
+
+  switch (GFX2DCLIP_test(clip, UTILS_MIN(x0, x1), UTILS_MIN(y0, y1), UTILS_MAX(x0, x1), UTILS_MAX(y0, y1)))
+  {
+    case GFX2DCLIP_INSIDE:
+      GFX2D_draw_line(clip->gfx, x0, y0, x1, y1, color);
+      break;
+
+    case GFX2DCLIP_PARTIAL:
+      GFX2DCLIP_clip_line(clip, x0, y0, x1, y1, color);
+      break;
+
+    default:
+      break;
+  }
+}
+
+// Draws the corner arcs of a circle, as drawCircleHelper of Adafruit GFX.
+
+static void GFX2DCLIP_circle_corners(GFX2DCLIP_instance_t* clip,
+                                     int32_t x0,
+                                     int32_t y0,
+                                     int32_t radius,
+                                     uint8_t corners,
+                                     uint32_t color)
+{
+  int32_t f = 1 - radius;
+  int32_t ddf_x = 1;
+  int32_t ddf_y = -2 * radius;
+  int32_t x = 0;
+  int32_t y = radius;
+
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddf_y += 2;
+      f += ddf_y;
+    }
+
+    x++;
+    ddf_x += 2;
+    f += ddf_x;
+
+    if (corners & GFX2DCLIP_CORNER_BOTTOM_RIGHT)
+    {
+      GFX2DCLIP_pixel(clip, x0 + x, y0 + y, color);
+      GFX2DCLIP_pixel(clip, x0 + y, y0 + x, color);
+    }
+
+    if (corners & GFX2DCLIP_CORNER_TOP_RIGHT)
+    {
+      GFX2DCLIP_pixel(clip, x0 + x, y0 - y, color);
+      GFX2DCLIP_pixel(clip, x0 + y, y0 - x, color);
+    }
+
+    if (corners & GFX2DCLIP_CORNER_BOTTOM_LEFT)
+    {
+      GFX2DCLIP_pixel(clip, x0 - y, y0 + x, color);
+      GFX2DCLIP_pixel(clip, x0 - x, y0 + y, color);
+    }
+
+    if (corners & GFX2DCLIP_CORNER_TOP_LEFT)
+    {
+      GFX2DCLIP_pixel(clip, x0 - y, y0 - x, color);
+      GFX2DCLIP_pixel(clip, x0 - x, y0 - y, color);
+    }
+  }
+}
+
+// Fills the right (1) and left (2) halves of a circle with columns stretched
+// by delta rows, as fillCircleHelper of Adafruit GFX.
+
+static void GFX2DCLIP_fill_circle_corners(GFX2DCLIP_instance_t* clip,
+                                          int32_t x0,
+                                          int32_t y0,
+                                          int32_t radius,
+                                          uint8_t corners,
+                                          int32_t delta,
+                                          uint32_t color)
+{
+  int32_t f = 1 - radius;
+  int32_t ddf_x = 1;
+  int32_t ddf_y = -2 * radius;
+  int32_t x = 0;
+  int32_t y = radius;
+  int32_t previous_x = x;
+  int32_t previous_y = y;
+
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddf_y += 2;
+      f += ddf_y;
+    }
+
+    x++;
+    ddf_x += 2;
+    f += ddf_x;
+
+    // Columns at x are drawn until the octants meet, and those at the
+    // previous y only when y changes, so no column is drawn twice.
+
+    if (x < y + 1)
+    {
+      if (corners & 1U)
+      {
+        GFX2DCLIP_fill(clip, x0 + x, y0 - y, x0 + x, y0 + y + delta, color);
+      }
+
+      if (corners & 2U)
+      {
+        GFX2DCLIP_fill(clip, x0 - x, y0 - y, x0 - x, y0 + y + delta, color);
+      }
+    }
+
+    if (y != previous_y)
+    {
+      if (corners & 1U)
+      {
+        GFX2DCLIP_fill(clip, x0 + previous_y, y0 - previous_x, x0 + previous_y, y0 + previous_x + delta, color);
+      }
+
+      if (corners & 2U)
+      {
+        GFX2DCLIP_fill(clip, x0 - previous_y, y0 - previous_x, x0 - previous_y, y0 + previous_x + delta, color);
+      }
+
+      previous_y = y;
+    }
+
+    previous_x = x;
+  }
+}
+
+// Draws the visible rows of a filled triangle, as fillTriangle of Adafruit
+// GFX. The edge positions of a row are computed from the row, rather than
+// accumulated from the top vertex, so rows above the bounds are not stepped.
+
+static void GFX2DCLIP_fill_triangle(GFX2DCLIP_instance_t* clip,
+                                    int32_t x0,
+                                    int32_t y0,
+                                    int32_t x1,
+                                    int32_t y1,
+                                    int32_t x2,
+                                    int32_t y2,
+                                    uint32_t color)
+{
+  if (y0 > y1)
+  {
+    GFX2DCLIP_swap(&x0, &y0, &x1, &y1);
+  }
+
+  if (y1 > y2)
+  {
+    GFX2DCLIP_swap(&x1, &y1, &x2, &y2);
+  }
+
+  if (y0 > y1)
+  {
+    GFX2DCLIP_swap(&x0, &y0, &x1, &y1);
+  }
+
+  if (y0 == y2)
+  {
+    GFX2DCLIP_fill(clip,
+                   UTILS_MIN(UTILS_MIN(x0, x1), x2),
+                   y0,
+                   UTILS_MAX(UTILS_MAX(x0, x1), x2),
+                   y0,
+                   color);
+    return;
+  }
+
+  // The upper part includes the middle row only if the bottom is flat.
+
+  int32_t last = (y1 == y2) ? y1 : y1 - 1;
+  int32_t bottom = UTILS_MIN(y2, clip->bounds.bottom);
+
+  for (int32_t y = UTILS_MAX(y0, clip->bounds.top); y <= bottom; y++)
+  {
+    int32_t a = (y <= last) ?
+                x0 + (int32_t)((int64_t)(x1 - x0) * (y - y0) / (y1 - y0)) :
+                x1 + (int32_t)((int64_t)(x2 - x1) * (y - y1) / (y2 - y1));
+    int32_t b = x0 + (int32_t)((int64_t)(x2 - x0) * (y - y0) / (y2 - y0));
+
+    GFX2DCLIP_fill(clip, UTILS_MIN(a, b), y, UTILS_MAX(a, b), y, color);
+  }
+}
+
+// Normalizes a rounded rectangle to positive dimensions, and limits the
+// radius to half of the shorter side, as GFX2D.
+
+static void GFX2DCLIP_rounded(int16_t x,
+                              int16_t y,
+                              int16_t width,
+                              int16_t height,
+                              int16_t radius,
+                              int32_t* left,
+                              int32_t* top,
+                              int32_t* right,
+                              int32_t* bottom,
+                              int32_t* limited_radius)
+{
+  GFX2DCLIP_span(x, width, left, right);
+  GFX2DCLIP_span(y, height, top, bottom);
+
+  *limited_radius = UTILS_MIN(UTILS_MAX(radius, -radius),
+                              UTILS_MIN(*right - *left + 1, *bottom - *top + 1) / 2);
+}
+
+static void GFX2DCLIP_bitmap_trim(GFX2DCLIP_instance_t* clip,
+                                  int16_t* x0,
+                                  int16_t* y0,
+                                  uint16_t* bitmap_x0,
+                                  uint16_t* bitmap_y0,
+                                  uint16_t* bitmap_width_draw,
+                                  uint16_t* bitmap_height_draw)
+{
+  GFX2DCLIP_rectangle_t* bounds = &clip->bounds;
+  int32_t skip_x = UTILS_MAX((int32_t)bounds->left - *x0, 0);
+  int32_t skip_y = UTILS_MAX((int32_t)bounds->top - *y0, 0);
+  int32_t right = UTILS_MIN((int32_t)*x0 + *bitmap_width_draw - 1, bounds->right);
+  int32_t bottom = UTILS_MIN((int32_t)*y0 + *bitmap_height_draw - 1, bounds->bottom);
+
+  *bitmap_width_draw = (uint16_t)(right - *x0 - skip_x + 1);
+  *bitmap_height_draw = (uint16_t)(bottom - *y0 - skip_y + 1);
+  *bitmap_x0 = (uint16_t)(*bitmap_x0 + skip_x);
+  *bitmap_y0 = (uint16_t)(*bitmap_y0 + skip_y);
+  *x0 = (int16_t)(*x0 + skip_x);
+  *y0 = (int16_t)(*y0 + skip_y);
+}
+
+static void GFX2DCLIP_glyph_run(GFX2DCLIP_instance_t* clip,
+                                int32_t x0,
+                                int32_t y,
+                                uint8_t run_start,
+                                uint8_t run_length)
+{
+  GFX2D_instance_t* gfx = clip->gfx;
+
+  GFX2DCLIP_fill(clip,
+                 x0 + run_start * gfx->font.x_magnification,
+                 y,
+                 x0 + (run_start + run_length) * gfx->font.x_magnification - 1,
+                 y + gfx->font.y_magnification - 1,
+                 gfx->font.color);
+}
+
+// Draws the visible rows of a glyph, each horizontal run of set bits as one
+// rectangle.
+
+static void GFX2DCLIP_draw_glyph(GFX2DCLIP_instance_t* clip,
+                                 GFX2DFONT_font_t* font,
+                                 GFX2DFONT_glyph_t* glyph,
+                                 int32_t x0,
+                                 int32_t y0)
+{
+  GFX2D_instance_t* gfx = clip->gfx;
+  const uint8_t* bitmap = &font->bitmap[glyph->bitmap_offset];
+  int32_t y_magnification = gfx->font.y_magnification;
+  uint32_t bit = 0;
+
+  for (uint8_t row = 0; row < glyph->height; row++)
+  {
+    int32_t y = y0 + row * y_magnification;
+
+    if ((y + y_magnification <= clip->bounds.top) || (y > clip->bounds.bottom))
+    {
+      bit += glyph->width;
+      continue;
+    }
+
+    uint8_t run_start = 0;
+    uint8_t run_length = 0;
+
+    for (uint8_t column = 0; column < glyph->width; column++, bit++)
+    {
+      if (bitmap[bit >> 3] & (0x80U >> (bit & 7U)))
+      {
+        if (run_length++ == 0)
+        {
+          run_start = column;
+        }
+      }
+      else if (run_length != 0)
+      {
+        GFX2DCLIP_glyph_run(clip, x0, y, run_start, run_length);
+        run_length = 0;
+      }
+    }
+
+    if (run_length != 0)
+    {
+      GFX2DCLIP_glyph_run(clip, x0, y, run_start, run_length);
+    }
+  }
+}
+
+void GFX2DCLIP_initialize(GFX2DCLIP_instance_t* clip, GFX2D_instance_t* instance)
+{
+  UTILITIES_memclear(clip, sizeof(GFX2DCLIP_instance_t));
+
+  clip->gfx = instance;
+}
+
+bool GFX2DCLIP_push(GFX2DCLIP_instance_t* clip,
+                    int16_t x,
+                    int16_t y,
+                    int16_t width,
+                    int16_t height)
+{
+  int32_t left;
+  int32_t top;
+  int32_t right;
+  int32_t bottom;
+
+  if (clip->depth >= GFX2DCLIP_STACK_DEPTH)
+  {
+    if (clip->overflow < UINT8_MAX)
+    {
+      clip->overflow++;
+    }
+
+    return false;
+  }
+
+  GFX2DCLIP_span(x, width, &left, &right);
+  GFX2DCLIP_span(y, height, &top, &bottom);
+
+  if (clip->depth != 0)
+  {
+    GFX2DCLIP_rectangle_t* parent = &clip->stack[clip->depth - 1];
+
+    left = UTILS_MAX(left, parent->left);
+    top = UTILS_MAX(top, parent->top);
+    right = UTILS_MIN(right, parent->right);
+    bottom = UTILS_MIN(bottom, parent->bottom);
+  }
+
+  GFX2DCLIP_rectangle_t* rectangle = &clip->stack[clip->depth++];
+
+  if ((left > right) || (top > bottom))
+  {
+    rectangle->left = 0;
+    rectangle->top = 0;
+    rectangle->right = -1;
+    rectangle->bottom = -1;
+  }
+  else
+  {
+    rectangle->left = GFX2DCLIP_clamp(left);
+    rectangle->top = GFX2DCLIP_clamp(top);
+    rectangle->right = GFX2DCLIP_clamp(right);
+    rectangle->bottom = GFX2DCLIP_clamp(bottom);
+  }
+
+  return true;
+}
+
+void GFX2DCLIP_pop(GFX2DCLIP_instance_t* clip)
+{
+  if (clip->overflow != 0)
+  {
+    clip->overflow--;
+  }
+  else if (clip->depth != 0)
+  {
+    clip->depth--;
+  }
+}
+
+bool GFX2DCLIP_is_visible(GFX2DCLIP_instance_t* clip,
+                          int16_t left,
+                          int16_t top,
+                          int16_t right,
+                          int16_t bottom)
+{
+  return GFX2DCLIP_update(clip) && (GFX2DCLIP_test(clip, left, top, right, bottom) != GFX2DCLIP_OUTSIDE);
+}
+
+void GFX2DCLIP_fill_canvas(GFX2DCLIP_instance_t* clip, uint32_t color)
+{
+  if (clip->depth == 0)
+  {
+    GFX2D_fill_canvas(clip->gfx, color);
+  }
+  else if (GFX2DCLIP_update(clip))
+  {
+    GFX2DCLIP_fill(clip, clip->bounds.left, clip->bounds.top, clip->bounds.right, clip->bounds.bottom, color);
+  }
+}
+
+void GFX2DCLIP_draw_pixel(GFX2DCLIP_instance_t* clip,
+                          int16_t x,
+                          int16_t y,
+                          uint32_t color)
+{
+  if (GFX2DCLIP_update(clip))
+  {
+    GFX2DCLIP_pixel(clip, x, y, color);
+  }
+}
+
+void GFX2DCLIP_draw_hline(GFX2DCLIP_instance_t* clip,
+                          int16_t x,
+                          int16_t y,
+                          int16_t length,
+                          uint32_t color)
+{
+  int32_t left;
+  int32_t right;
+
+  if (GFX2DCLIP_update(clip))
+  {
+    GFX2DCLIP_span(x, length, &left, &right);
+    GFX2DCLIP_fill(clip, left, y, right, y, color);
+  }
+}
+
+void GFX2DCLIP_draw_vline(GFX2DCLIP_instance_t* clip,
+                          int16_t x,
+                          int16_t y,
+                          int16_t length,
+                          uint32_t color)
+{
+  int32_t top;
+  int32_t bottom;
+
+  if (GFX2DCLIP_update(clip))
+  {
+    GFX2DCLIP_span(y, length, &top, &bottom);
+    GFX2DCLIP_fill(clip, x, top, x, bottom, color);
+  }
+}
+
+void GFX2DCLIP_draw_line(GFX2DCLIP_instance_t* clip,
+                         int16_t x0,
+                         int16_t y0,
+                         int16_t x1,
+                         int16_t y1,
+                         uint32_t color)
+{
+  if (GFX2DCLIP_update(clip))
+  {
+    GFX2DCLIP_line(clip, x0, y0, x1, y1, color);
+  }
+}
+
+void GFX2DCLIP_draw_triangle(GFX2DCLIP_instance_t* clip,
+                             int16_t x0,
+                             int16_t y0,
+                             int16_t x1,
+                             int16_t y1,
+                             int16_t x2,
+                             int16_t y2,
+                             uint32_t color)
+{
+  if (!GFX2DCLIP_update(clip))
+  {
+    return;
+  }
+
+  switch (GFX2DCLIP_test(clip,
+                         UTILS_MIN(UTILS_MIN(x0, x1), x2),
+                         UTILS_MIN(UTILS_MIN(y0, y1), y2),
+                         UTILS_MAX(UTILS_MAX(x0, x1), x2),
+                         UTILS_MAX(UTILS_MAX(y0, y1), y2)))
+  {
+    case GFX2DCLIP_INSIDE:
+      GFX2D_draw_triangle(clip->gfx, x0, y0, x1, y1, x2, y2, color);
+      break;
+
+    case GFX2DCLIP_PARTIAL:
+      GFX2DCLIP_line(clip, x0, y0, x1, y1, color);
+      GFX2DCLIP_line(clip, x1, y1, x2, y2, color);
+      GFX2DCLIP_line(clip, x2, y2, x0, y0, color);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GFX2DCLIP_draw_filled_triangle(GFX2DCLIP_instance_t* clip,
+                                    int16_t x0,
+                                    int16_t y0,
+                                    int16_t x1,
+                                    int16_t y1,
+                                    int16_t x2,
+                                    int16_t y2,
+                                    uint32_t color)
+{
+  if (!GFX2DCLIP_update(clip))
+  {
+    return;
+  }
+
+  switch (GFX2DCLIP_test(clip,
+                         UTILS_MIN(UTILS_MIN(x0, x1), x2),
+                         UTILS_MIN(UTILS_MIN(y0, y1), y2),
+                         UTILS_MAX(UTILS_MAX(x0, x1), x2),
+                         UTILS_MAX(UTILS_MAX(y0, y1), y2)))
+  {
+    case GFX2DCLIP_INSIDE:
+      GFX2D_draw_filled_triangle(clip->gfx, x0, y0, x1, y1, x2, y2, color);
+      break;
+
+    case GFX2DCLIP_PARTIAL:
+      GFX2DCLIP_fill_triangle(clip, x0, y0, x1, y1, x2, y2, color);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GFX2DCLIP_draw_circle(GFX2DCLIP_instance_t* clip,
+                           int16_t x0,
+                           int16_t y0,
+                           int16_t radius,
+                           uint32_t color)
+{
+  int32_t extent = UTILS_MAX(radius, -radius);
+
+  if ((radius == 0) || !GFX2DCLIP_update(clip))
+  {
+    return;
+  }
+
+  switch (GFX2DCLIP_test(clip, x0 - extent, y0 - extent, x0 + extent, y0 + extent))
+  {
+    case GFX2DCLIP_INSIDE:
+      GFX2D_draw_circle(clip->gfx, x0, y0, radius, color);
+      break;
+
+    case GFX2DCLIP_PARTIAL:
+      GFX2DCLIP_pixel(clip, x0, y0 + extent, color);
+      GFX2DCLIP_pixel(clip, x0, y0 - extent, color);
+      GFX2DCLIP_pixel(clip, x0 + extent, y0, color);
+      GFX2DCLIP_pixel(clip, x0 - extent, y0, color);
+      GFX2DCLIP_circle_corners(clip, x0, y0, extent, GFX2DCLIP_CORNER_ALL, color);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GFX2DCLIP_draw_filled_circle(GFX2DCLIP_instance_t* clip,
+                                  int16_t x0,
+                                  int16_t y0,
+                                  int16_t radius,
+                                  uint32_t color)
+{
+  int32_t extent = UTILS_MAX(radius, -radius);
+
+  if (!GFX2DCLIP_update(clip))
+  {
+    return;
+  }
+
+  switch (GFX2DCLIP_test(clip, x0 - extent, y0 - extent, x0 + extent, y0 + extent))
+  {
+    case GFX2DCLIP_INSIDE:
+      GFX2D_draw_filled_circle(clip->gfx, x0, y0, radius, color);
+      break;
+
+    case GFX2DCLIP_PARTIAL:
+      GFX2DCLIP_fill(clip, x0, y0 - extent, x0, y0 + extent, color);
+      GFX2DCLIP_fill_circle_corners(clip, x0, y0, extent, 3U, 0, color);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GFX2DCLIP_draw_rectangle(GFX2DCLIP_instance_t* clip,
+                              int16_t x,
+                              int16_t y,
+                              int16_t width,
+                              int16_t height,
+                              uint32_t color)
+{
+  int32_t left;
+  int32_t top;
+  int32_t right;
+  int32_t bottom;
+
+  if ((width == 0) || (height == 0) || !GFX2DCLIP_update(clip))
+  {
+    return;
+  }
+
+  GFX2DCLIP_span(x, width, &left, &right);
+  GFX2DCLIP_span(y, height, &top, &bottom);
+
+  switch (GFX2DCLIP_test(clip, left, top, right, bottom))
+  {
+    case GFX2DCLIP_INSIDE:
+      GFX2D_draw_rectangle(clip->gfx, x, y, width, height, color);
+      break;
+
+    case GFX2DCLIP_PARTIAL:
+      GFX2DCLIP_fill(clip, left, top, right, top, color);
+      GFX2DCLIP_fill(clip, left, bottom, right, bottom, color);
+      GFX2DCLIP_fill(clip, left, top, left, bottom, color);
+      GFX2DCLIP_fill(clip, right, top, right, bottom, color);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GFX2DCLIP_draw_filled_rectangle(GFX2DCLIP_instance_t* clip,
+                                     int16_t x,
+                                     int16_t y,
+                                     int16_t width,
+                                     int16_t height,
+                                     uint32_t color)
+{
+  int32_t left;
+  int32_t top;
+  int32_t right;
+  int32_t bottom;
+
+  if (GFX2DCLIP_update(clip))
+  {
+    GFX2DCLIP_span(x, width, &left, &right);
+    GFX2DCLIP_span(y, height, &top, &bottom);
+    GFX2DCLIP_fill(clip, left, top, right, bottom, color);
+  }
+}
+
+void GFX2DCLIP_draw_rounded_rectangle(GFX2DCLIP_instance_t* clip,
+                                      int16_t x,
+                                      int16_t y,
+                                      int16_t width,
+                                      int16_t height,
+                                      int16_t radius,
+                                      uint32_t color)
+{
+  int32_t left;
+  int32_t top;
+  int32_t right;
+  int32_t bottom;
+  int32_t r;
+
+  if ((width == 0) || (height == 0) || !GFX2DCLIP_update(clip))
+  {
+    return;
+  }
+
+  GFX2DCLIP_rounded(x, y, width, height, radius, &left, &top, &right, &bottom, &r);
+
+  switch (GFX2DCLIP_test(clip, left, top, right, bottom))
+  {
+    case GFX2DCLIP_INSIDE:
+      GFX2D_draw_rounded_rectangle(clip->gfx, x, y, width, height, radius, color);
+      break;
+
+    case GFX2DCLIP_PARTIAL:
+      GFX2DCLIP_fill(clip, left + r, top, right - r, top, color);
+      GFX2DCLIP_fill(clip, left + r, bottom, right - r, bottom, color);
+      GFX2DCLIP_fill(clip, left, top + r, left, bottom - r, color);
+      GFX2DCLIP_fill(clip, right, top + r, right, bottom - r, color);
+      GFX2DCLIP_circle_corners(clip, left + r, top + r, r, GFX2DCLIP_CORNER_TOP_LEFT, color);
+      GFX2DCLIP_circle_corners(clip, right - r, top + r, r, GFX2DCLIP_CORNER_TOP_RIGHT, color);
+      GFX2DCLIP_circle_corners(clip, right - r, bottom - r, r, GFX2DCLIP_CORNER_BOTTOM_RIGHT, color);
+      GFX2DCLIP_circle_corners(clip, left + r, bottom - r, r, GFX2DCLIP_CORNER_BOTTOM_LEFT, color);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GFX2DCLIP_draw_filled_rounded_rectangle(GFX2DCLIP_instance_t* clip,
+                                             int16_t x,
+                                             int16_t y,
+                                             int16_t width,
+                                             int16_t height,
+                                             int16_t radius,
+                                             uint32_t color)
+{
+  int32_t left;
+  int32_t top;
+  int32_t right;
+  int32_t bottom;
+  int32_t r;
+
+  if ((width == 0) || (height == 0) || !GFX2DCLIP_update(clip))
+  {
+    return;
+  }
+
+  GFX2DCLIP_rounded(x, y, width, height, radius, &left, &top, &right, &bottom, &r);
+
+  switch (GFX2DCLIP_test(clip, left, top, right, bottom))
+  {
+    case GFX2DCLIP_INSIDE:
+      GFX2D_draw_filled_rounded_rectangle(clip->gfx, x, y, width, height, radius, color);
+      break;
+
+    case GFX2DCLIP_PARTIAL:
+      GFX2DCLIP_fill(clip, left + r, top, right - r, bottom, color);
+      GFX2DCLIP_fill_circle_corners(clip, right - r, top + r, r, 1U, bottom - top - 2 * r, color);
+      GFX2DCLIP_fill_circle_corners(clip, left + r, top + r, r, 2U, bottom - top - 2 * r, color);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GFX2DCLIP_draw_binary_bitmap(GFX2DCLIP_instance_t* clip,
+                                  const uint8_t* bitmap,
+                                  int16_t x0,
+                                  int16_t y0,
+                                  uint16_t bitmap_x0,
+                                  uint16_t bitmap_y0,
+                                  uint16_t bitmap_width_draw,
+                                  uint16_t bitmap_height_draw,
+                                  uint16_t bitmap_width_total,
+                                  uint16_t bitmap_height_total,
+                                  uint32_t color,
+                                  uint32_t background_color)
+{
+  if ((bitmap_width_draw == 0) || (bitmap_height_draw == 0) || !GFX2DCLIP_update(clip))
+  {
+    return;
+  }
+
+  switch (GFX2DCLIP_test(clip, x0, y0, (int32_t)x0 + bitmap_width_draw - 1, (int32_t)y0 + bitmap_height_draw - 1))
+  {
+    case GFX2DCLIP_PARTIAL:
+      GFX2DCLIP_bitmap_trim(clip, &x0, &y0, &bitmap_x0, &bitmap_y0, &bitmap_width_draw, &bitmap_height_draw);
+      // Fall through.
+
+    case GFX2DCLIP_INSIDE:
+      GFX2D_draw_binary_bitmap(clip->gfx,
+                               bitmap,
+                               x0,
+                               y0,
+                               bitmap_x0,
+                               bitmap_y0,
+                               bitmap_width_draw,
+                               bitmap_height_draw,
+                               bitmap_width_total,
+                               bitmap_height_total,
+                               color,
+                               background_color);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GFX2DCLIP_draw_rgb_bitmap(GFX2DCLIP_instance_t* clip,
+                               GFX2D_rgb_bitmap_t rgb_bitmap,
+                               const uint8_t* bitmap,
+                               const uint8_t* alpha_mask,
+                               int16_t x0,
+                               int16_t y0,
+                               uint16_t bitmap_x0,
+                               uint16_t bitmap_y0,
+                               uint16_t bitmap_width_draw,
+                               uint16_t bitmap_height_draw,
+                               uint16_t bitmap_width_total,
+                               uint16_t bitmap_height_total)
+{
+  if ((bitmap_width_draw == 0) || (bitmap_height_draw == 0) || !GFX2DCLIP_update(clip))
+  {
+    return;
+  }
+
+  switch (GFX2DCLIP_test(clip, x0, y0, (int32_t)x0 + bitmap_width_draw - 1, (int32_t)y0 + bitmap_height_draw - 1))
+  {
+    case GFX2DCLIP_PARTIAL:
+      GFX2DCLIP_bitmap_trim(clip, &x0, &y0, &bitmap_x0, &bitmap_y0, &bitmap_width_draw, &bitmap_height_draw);
+      // Fall through.
+
+    case GFX2DCLIP_INSIDE:
+      GFX2D_draw_rgb_bitmap(clip->gfx,
+                            rgb_bitmap,
+                            bitmap,
+                            alpha_mask,
+                            x0,
+                            y0,
+                            bitmap_x0,
+                            bitmap_y0,
+                            bitmap_width_draw,
+                            bitmap_height_draw,
+                            bitmap_width_total,
+                            bitmap_height_total);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GFX2DCLIP_draw_char(GFX2DCLIP_instance_t* clip, uint8_t c)
+{
+  GFX2D_instance_t* gfx = clip->gfx;
+  GFX2DFONT_font_t* font = gfx->font.font;
+
+  // Line breaks, characters without a glyph, and empty glyphs only move the
+  // cursor.
+
+  if ((c == '\n') || (c == '\r') || (c < font->first_ascii) || (c > font->last_ascii))
+  {
+    GFX2D_draw_char(gfx, c);
+    return;
+  }
+
+  GFX2DFONT_glyph_t* glyph = &font->glyph[c - font->first_ascii];
+
+  if ((glyph->width == 0) || (glyph->height == 0))
+  {
+    GFX2D_draw_char(gfx, c);
+    return;
+  }
+
+  if (gfx->flags.wrap_text &&
+      (gfx->font.cursor_x + (glyph->x_offset + glyph->width) * gfx->font.x_magnification > gfx->canvas_width))
+  {
+    gfx->font.cursor_x = 0;
+    gfx->font.cursor_y = (int16_t)(gfx->font.cursor_y + gfx->font.y_magnification * font->y_advance);
+  }
+
+  int32_t x0 = gfx->font.cursor_x + glyph->x_offset * gfx->font.x_magnification;
+  int32_t y0 = gfx->font.cursor_y + glyph->y_offset * gfx->font.y_magnification;
+  uint8_t visibility = GFX2DCLIP_OUTSIDE;
+
+  if (GFX2DCLIP_update(clip))
+  {
+    visibility = GFX2DCLIP_test(clip,
+                                x0,
+                                y0,
+                                x0 + glyph->width * gfx->font.x_magnification - 1,
+                                y0 + glyph->height * gfx->font.y_magnification - 1);
+  }
+
+  if (visibility == GFX2DCLIP_INSIDE)
+  {
+    // The cursor is already wrapped, so GFX2D must not wrap it again.
+
+    bool wrap_text = gfx->flags.wrap_text;
+
+    gfx->flags.wrap_text = 0;
+    GFX2D_draw_char(gfx, c);
+    gfx->flags.wrap_text = wrap_text;
+    return;
+  }
+
+  if (visibility == GFX2DCLIP_PARTIAL)
+  {
+    GFX2DCLIP_draw_glyph(clip, font, glyph, x0, y0);
+  }
+
+  gfx->font.cursor_x = (int16_t)(gfx->font.cursor_x + glyph->x_advance * gfx->font.x_magnification);
+}
+
+#endif // JLIB_CONFIG_GFX2DCLIP
@@ -0,0 +1,755 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Display list for GFX2D.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_GFX2DLIST
+
+static int16_t GFX2DLIST_clamp(int32_t value)
+{
+  return (int16_t)UTILS_MAX(UTILS_MIN(value, INT16_MAX), INT16_MIN);
+}
+
+// Range of the pixels of a line or side starting at a coordinate, with GFX2D
+// drawing negative lengths backwards from it.
+
+static void GFX2DLIST_span(int16_t start, int16_t length, int16_t* low, int16_t* high)
+{
+  if (length >= 0)
+  {
+    *low = start;
+    *high = GFX2DLIST_clamp((int32_t)start + length - 1);
+  }
+  else
+  {
+    *low = GFX2DLIST_clamp((int32_t)start + length + 1);
+    *high = start;
+  }
+}
+
+// Trims the bounding box of a call to the clip rectangle, returning false if
+// nothing of the call is visible.
+
+static bool GFX2DLIST_clip(GFX2DLIST_instance_t* list,
+                           int16_t* left,
+                           int16_t* top,
+                           int16_t* right,
+                           int16_t* bottom)
+{
+  GFX2DCLIP_rectangle_t* bounds = &list->clip.bounds;
+
+  if (!GFX2DCLIP_is_visible(&list->clip, *left, *top, *right, *bottom))
+  {
+    return false;
+  }
+
+  *left = UTILS_MAX(*left, bounds->left);
+  *top = UTILS_MAX(*top, bounds->top);
+  *right = UTILS_MIN(*right, bounds->right);
+  *bottom = UTILS_MIN(*bottom, bounds->bottom);
+
+  return true;
+}
+
+static GFX2DLIST_command_t* GFX2DLIST_add(GFX2DLIST_instance_t* list,
+                                          GFX2DLIST_command_type_t type,
+                                          int16_t left,
+                                          int16_t top,
+                                          int16_t right,
+                                          int16_t bottom,
+                                          uint32_t color)
+{
+  if (list->command_count >= list->command_capacity)
+  {
+    list->overflow = true;
+    return NULL;
+  }
+
+  GFX2DLIST_command_t* command = &list->commands[list->command_count++];
+
+  command->type = (uint8_t)type;
+  command->left = left;
+  command->top = top;
+  command->right = right;
+  command->bottom = bottom;
+  command->color = color;
+
+  return command;
+}
+
+static bool GFX2DLIST_add_shape(GFX2DLIST_instance_t* list,
+                                GFX2DLIST_command_type_t type,
+                                int16_t left,
+                                int16_t top,
+                                int16_t right,
+                                int16_t bottom,
+                                uint32_t color,
+                                const int16_t* shape,
+                                uint8_t shape_length)
+{
+  if (!GFX2DLIST_clip(list, &left, &top, &right, &bottom))
+  {
+    return true;
+  }
+
+  GFX2DLIST_command_t* command = GFX2DLIST_add(list, type, left, top, right, bottom, color);
+
+  if (command == NULL)
+  {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < shape_length; i++)
+  {
+    command->shape[i] = shape[i];
+  }
+
+  return true;
+}
+
+static bool GFX2DLIST_add_points(GFX2DLIST_instance_t* list,
+                                 GFX2DLIST_command_type_t type,
+                                 uint32_t color,
+                                 const int16_t* points,
+                                 uint8_t point_count)
+{
+  int16_t left = points[0];
+  int16_t top = points[1];
+  int16_t right = points[0];
+  int16_t bottom = points[1];
+
+  for (uint8_t i = 1; i < point_count; i++)
+  {
+    left = UTILS_MIN(left, points[2 * i]);
+    right = UTILS_MAX(right, points[2 * i]);
+    top = UTILS_MIN(top, points[2 * i + 1]);
+    bottom = UTILS_MAX(bottom, points[2 * i + 1]);
+  }
+
+  return GFX2DLIST_add_shape(list, type, left, top, right, bottom, color, points, (uint8_t)(2 * point_count));
+}
+
+static bool GFX2DLIST_add_rectangle(GFX2DLIST_instance_t* list,
+                                    GFX2DLIST_command_type_t type,
+                                    int16_t x,
+                                    int16_t y,
+                                    int16_t width,
+                                    int16_t height,
+                                    int16_t radius,
+                                    uint32_t color)
+{
+  int16_t shape[5] = {x, y, width, height, radius};
+  int16_t left;
+  int16_t top;
+  int16_t right;
+  int16_t bottom;
+
+  if ((width == 0) || (height == 0))
+  {
+    return true;
+  }
+
+  GFX2DLIST_span(x, width, &left, &right);
+  GFX2DLIST_span(y, height, &top, &bottom);
+
+  return GFX2DLIST_add_shape(list, type, left, top, right, bottom, color, shape, 5);
+}
+
+static bool GFX2DLIST_add_circle(GFX2DLIST_instance_t* list,
+                                 GFX2DLIST_command_type_t type,
+                                 int16_t x0,
+                                 int16_t y0,
+                                 int16_t radius,
+                                 uint32_t color)
+{
+  int16_t shape[3] = {x0, y0, radius};
+  int16_t extent = (int16_t)UTILS_MAX(radius, -radius);
+
+  return GFX2DLIST_add_shape(list,
+                             type,
+                             GFX2DLIST_clamp((int32_t)x0 - extent),
+                             GFX2DLIST_clamp((int32_t)y0 - extent),
+                             GFX2DLIST_clamp((int32_t)x0 + extent),
+                             GFX2DLIST_clamp((int32_t)y0 + extent),
+                             color,
+                             shape,
+                             3);
+}
+
+static bool GFX2DLIST_add_bitmap(GFX2DLIST_instance_t* list,
+                                 GFX2DLIST_command_type_t type,
+                                 uint8_t rgb_bitmap,
+                                 const uint8_t* bitmap,
+                                 const uint8_t* alpha_mask,
+                                 int16_t x0,
+                                 int16_t y0,
+                                 uint16_t bitmap_x0,
+                                 uint16_t bitmap_y0,
+                                 uint16_t bitmap_width_draw,
+                                 uint16_t bitmap_height_draw,
+                                 uint16_t bitmap_width_total,
+                                 uint16_t bitmap_height_total,
+                                 uint32_t color,
+                                 uint32_t background_color)
+{
+  int16_t left = x0;
+  int16_t top = y0;
+  int16_t right = GFX2DLIST_clamp((int32_t)x0 + bitmap_width_draw - 1);
+  int16_t bottom = GFX2DLIST_clamp((int32_t)y0 + bitmap_height_draw - 1);
+
+  if ((bitmap_width_draw == 0) ||
+      (bitmap_height_draw == 0) ||
+      !GFX2DLIST_clip(list, &left, &top, &right, &bottom))
+  {
+    return true;
+  }
+
+  GFX2DLIST_command_t* command = GFX2DLIST_add(list, type, left, top, right, bottom, color);
+
+  if (command == NULL)
+  {
+    return false;
+  }
+
+  command->bitmap.bitmap = bitmap;
+  command->bitmap.alpha_mask = alpha_mask;
+  command->bitmap.background_color = background_color;
+  command->bitmap.x0 = x0;
+  command->bitmap.y0 = y0;
+  command->bitmap.bitmap_x0 = bitmap_x0;
+  command->bitmap.bitmap_y0 = bitmap_y0;
+  command->bitmap.bitmap_width_draw = bitmap_width_draw;
+  command->bitmap.bitmap_height_draw = bitmap_height_draw;
+  command->bitmap.bitmap_width_total = bitmap_width_total;
+  command->bitmap.bitmap_height_total = bitmap_height_total;
+  command->bitmap.rgb_bitmap = rgb_bitmap;
+
+  return true;
+}
+
+static void GFX2DLIST_replay_text(GFX2DLIST_instance_t* list,
+                                  GFX2DLIST_command_t* command,
+                                  GFX2DCLIP_instance_t* clip)
+{
+  GFX2D_instance_t* instance = clip->gfx;
+
+  GFX2D_set_font(instance, command->text.font);
+  GFX2D_set_font_color(instance, command->color);
+  GFX2D_set_text_magnification(instance, command->text.x_magnification, command->text.y_magnification);
+  GFX2D_set_text_wrap(instance, false);
+
+  instance->font.cursor_x = command->text.cursor_x;
+  instance->font.cursor_y = command->text.cursor_y;
+
+  for (uint32_t i = 0; i < command->text.length; i++)
+  {
+    GFX2DCLIP_draw_char(clip, (uint8_t)list->text_buffer[command->text.offset + i]);
+  }
+}
+
+void GFX2DLIST_initialize(GFX2DLIST_instance_t* list,
+                          GFX2DLIST_command_t* commands,
+                          uint32_t command_capacity,
+                          char* text_buffer,
+                          uint32_t text_buffer_length)
+{
+  UTILITIES_memclear(list, sizeof(GFX2DLIST_instance_t));
+
+  list->commands = commands;
+  list->command_capacity = command_capacity;
+  list->text_buffer = text_buffer;
+  list->text_buffer_length = (text_buffer != NULL) ? text_buffer_length : 0;
+
+  GFX2DCLIP_initialize(&list->clip, NULL);
+}
+
+void GFX2DLIST_clear(GFX2DLIST_instance_t* list)
+{
+  list->command_count = 0;
+  list->text_length = 0;
+  list->overflow = false;
+
+  GFX2DCLIP_initialize(&list->clip, NULL);
+}
+
+void GFX2DLIST_replay(GFX2DLIST_instance_t* list, GFX2D_instance_t* instance)
+{
+  GFX2DCLIP_instance_t clip;
+
+  GFX2DCLIP_initialize(&clip, instance);
+
+  for (uint32_t i = 0; i < list->command_count; i++)
+  {
+    GFX2DLIST_command_t* command = &list->commands[i];
+    int16_t* shape = command->shape;
+
+    if (command->type == GFX2DLIST_COMMAND_PUSH_CLIP)
+    {
+      GFX2DCLIP_push(&clip, shape[0], shape[1], shape[2], shape[3]);
+      continue;
+    }
+
+    if (command->type == GFX2DLIST_COMMAND_POP_CLIP)
+    {
+      GFX2DCLIP_pop(&clip);
+      continue;
+    }
+
+    if (!GFX2DCLIP_is_visible(&clip, command->left, command->top, command->right, command->bottom))
+    {
+      continue;
+    }
+
+    switch (command->type)
+    {
+      case GFX2DLIST_COMMAND_FILL_CANVAS:
+        GFX2DCLIP_fill_canvas(&clip, command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_PIXEL:
+        GFX2DCLIP_draw_pixel(&clip, shape[0], shape[1], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_HLINE:
+        GFX2DCLIP_draw_hline(&clip, shape[0], shape[1], shape[2], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_VLINE:
+        GFX2DCLIP_draw_vline(&clip, shape[0], shape[1], shape[2], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_LINE:
+        GFX2DCLIP_draw_line(&clip, shape[0], shape[1], shape[2], shape[3], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_TRIANGLE:
+        GFX2DCLIP_draw_triangle(&clip, shape[0], shape[1], shape[2], shape[3], shape[4], shape[5], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_FILLED_TRIANGLE:
+        GFX2DCLIP_draw_filled_triangle(&clip, shape[0], shape[1], shape[2], shape[3], shape[4], shape[5], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_CIRCLE:
+        GFX2DCLIP_draw_circle(&clip, shape[0], shape[1], shape[2], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_FILLED_CIRCLE:
+        GFX2DCLIP_draw_filled_circle(&clip, shape[0], shape[1], shape[2], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_RECTANGLE:
+        GFX2DCLIP_draw_rectangle(&clip, shape[0], shape[1], shape[2], shape[3], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_FILLED_RECTANGLE:
+        GFX2DCLIP_draw_filled_rectangle(&clip, shape[0], shape[1], shape[2], shape[3], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_ROUNDED_RECTANGLE:
+        GFX2DCLIP_draw_rounded_rectangle(&clip, shape[0], shape[1], shape[2], shape[3], shape[4], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_FILLED_ROUNDED_RECTANGLE:
+        GFX2DCLIP_draw_filled_rounded_rectangle(&clip, shape[0], shape[1], shape[2], shape[3], shape[4], command->color);
+        break;
+
+      case GFX2DLIST_COMMAND_BINARY_BITMAP:
+        GFX2DCLIP_draw_binary_bitmap(&clip,
+                                     command->bitmap.bitmap,
+                                     command->bitmap.x0,
+                                     command->bitmap.y0,
+                                     command->bitmap.bitmap_x0,
+                                     command->bitmap.bitmap_y0,
+                                     command->bitmap.bitmap_width_draw,
+                                     command->bitmap.bitmap_height_draw,
+                                     command->bitmap.bitmap_width_total,
+                                     command->bitmap.bitmap_height_total,
+                                     command->color,
+                                     command->bitmap.background_color);
+        break;
+
+      case GFX2DLIST_COMMAND_RGB_BITMAP:
+        GFX2DCLIP_draw_rgb_bitmap(&clip,
+                                  (GFX2D_rgb_bitmap_t)command->bitmap.rgb_bitmap,
+                                  command->bitmap.bitmap,
+                                  command->bitmap.alpha_mask,
+                                  command->bitmap.x0,
+                                  command->bitmap.y0,
+                                  command->bitmap.bitmap_x0,
+                                  command->bitmap.bitmap_y0,
+                                  command->bitmap.bitmap_width_draw,
+                                  command->bitmap.bitmap_height_draw,
+                                  command->bitmap.bitmap_width_total,
+                                  command->bitmap.bitmap_height_total);
+        break;
+
+      case GFX2DLIST_COMMAND_TEXT:
+        GFX2DLIST_replay_text(list, command, &clip);
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+bool GFX2DLIST_fill_canvas(GFX2DLIST_instance_t* list, uint32_t color)
+{
+  int16_t left = INT16_MIN;
+  int16_t top = INT16_MIN;
+  int16_t right = INT16_MAX;
+  int16_t bottom = INT16_MAX;
+
+  if (!GFX2DLIST_clip(list, &left, &top, &right, &bottom))
+  {
+    return true;
+  }
+
+  return GFX2DLIST_add(list, GFX2DLIST_COMMAND_FILL_CANVAS, left, top, right, bottom, color) != NULL;
+}
+
+bool GFX2DLIST_draw_pixel(GFX2DLIST_instance_t* list,
+                          int16_t x,
+                          int16_t y,
+                          uint32_t color)
+{
+  int16_t shape[2] = {x, y};
+
+  return GFX2DLIST_add_shape(list, GFX2DLIST_COMMAND_PIXEL, x, y, x, y, color, shape, 2);
+}
+
+bool GFX2DLIST_draw_hline(GFX2DLIST_instance_t* list,
+                          int16_t x,
+                          int16_t y,
+                          int16_t length,
+                          uint32_t color)
+{
+  int16_t shape[3] = {x, y, length};
+  int16_t left;
+  int16_t right;
+
+  if (length == 0)
+  {
+    return true;
+  }
+
+  GFX2DLIST_span(x, length, &left, &right);
+
+  return GFX2DLIST_add_shape(list, GFX2DLIST_COMMAND_HLINE, left, y, right, y, color, shape, 3);
+}
+
+bool GFX2DLIST_draw_vline(GFX2DLIST_instance_t* list,
+                          int16_t x,
+                          int16_t y,
+                          int16_t length,
+                          uint32_t color)
+{
+  int16_t shape[3] = {x, y, length};
+  int16_t top;
+  int16_t bottom;
+
+  if (length == 0)
+  {
+    return true;
+  }
+
+  GFX2DLIST_span(y, length, &top, &bottom);
+
+  return GFX2DLIST_add_shape(list, GFX2DLIST_COMMAND_VLINE, x, top, x, bottom, color, shape, 3);
+}
+
+bool GFX2DLIST_draw_line(GFX2DLIST_instance_t* list,
+                         int16_t x0,
+                         int16_t y0,
+                         int16_t x1,
+                         int16_t y1,
+                         uint32_t color)
+{
+  int16_t points[4] = {x0, y0, x1, y1};
+
+  return GFX2DLIST_add_points(list, GFX2DLIST_COMMAND_LINE, color, points, 2);
+}
+
+bool GFX2DLIST_draw_triangle(GFX2DLIST_instance_t* list,
+                             int16_t x0,
+                             int16_t y0,
+                             int16_t x1,
+                             int16_t y1,
+                             int16_t x2,
+                             int16_t y2,
+                             uint32_t color)
+{
+  int16_t points[6] = {x0, y0, x1, y1, x2, y2};
+
+  return GFX2DLIST_add_points(list, GFX2DLIST_COMMAND_TRIANGLE, color, points, 3);
+}
+
+bool GFX2DLIST_draw_filled_triangle(GFX2DLIST_instance_t* list,
+                                    int16_t x0,
+                                    int16_t y0,
+                                    int16_t x1,
+                                    int16_t y1,
+                                    int16_t x2,
+                                    int16_t y2,
+                                    uint32_t color)
+{
+  int16_t points[6] = {x0, y0, x1, y1, x2, y2};
+
+  return GFX2DLIST_add_points(list, GFX2DLIST_COMMAND_FILLED_TRIANGLE, color, points, 3);
+}
+
+bool GFX2DLIST_draw_circle(GFX2DLIST_instance_t* list,
+                           int16_t x0,
+                           int16_t y0,
+                           int16_t radius,
+                           uint32_t color)
+{
+  return GFX2DLIST_add_circle(list, GFX2DLIST_COMMAND_CIRCLE, x0, y0, radius, color);
+}
+
+bool GFX2DLIST_draw_filled_circle(GFX2DLIST_instance_t* list,
+                                  int16_t x0,
+                                  int16_t y0,
+                                  int16_t radius,
+                                  uint32_t color)
+{
+  return GFX2DLIST_add_circle(list, GFX2DLIST_COMMAND_FILLED_CIRCLE, x0, y0, radius, color);
+}
+
+bool GFX2DLIST_draw_rectangle(GFX2DLIST_instance_t* list,
+                              int16_t x,
+                              int16_t y,
+                              int16_t width,
+                              int16_t height,
+                              uint32_t color)
+{
+  return GFX2DLIST_add_rectangle(list, GFX2DLIST_COMMAND_RECTANGLE, x, y, width, height, 0, color);
+}
+
+bool GFX2DLIST_draw_filled_rectangle(GFX2DLIST_instance_t* list,
+                                     int16_t x,
+                                     int16_t y,
+                                     int16_t width,
+                                     int16_t height,
+                                     uint32_t color)
+{
+  return GFX2DLIST_add_rectangle(list, GFX2DLIST_COMMAND_FILLED_RECTANGLE, x, y, width, height, 0, color);
+}
+
+bool GFX2DLIST_draw_rounded_rectangle(GFX2DLIST_instance_t* list,
+                                      int16_t x,
+                                      int16_t y,
+                                      int16_t width,
+                                      int16_t height,
+                                      int16_t radius,
+                                      uint32_t color)
+{
+  return GFX2DLIST_add_rectangle(list, GFX2DLIST_COMMAND_ROUNDED_RECTANGLE, x, y, width, height, radius, color);
+}
+
+bool GFX2DLIST_draw_filled_rounded_rectangle(GFX2DLIST_instance_t* list,
+                                             int16_t x,
+                                             int16_t y,
+                                             int16_t width,
+                                             int16_t height,
+                                             int16_t radius,
+                                             uint32_t color)
+{
+  return GFX2DLIST_add_rectangle(list, GFX2DLIST_COMMAND_FILLED_ROUNDED_RECTANGLE, x, y, width, height, radius, color);
+}
+
+bool GFX2DLIST_draw_binary_bitmap(GFX2DLIST_instance_t* list,
+                                  const uint8_t* bitmap,
+                                  int16_t x0,
+                                  int16_t y0,
+                                  uint16_t bitmap_x0,
+                                  uint16_t bitmap_y0,
+                                  uint16_t bitmap_width_draw,
+                                  uint16_t bitmap_height_draw,
+                                  uint16_t bitmap_width_total,
+                                  uint16_t bitmap_height_total,
+                                  uint32_t color,
+                                  uint32_t background_color)
+{
+  return GFX2DLIST_add_bitmap(list,
+                              GFX2DLIST_COMMAND_BINARY_BITMAP,
+                              0,
+                              bitmap,
+                              NULL,
+                              x0,
+                              y0,
+                              bitmap_x0,
+                              bitmap_y0,
+                              bitmap_width_draw,
+                              bitmap_height_draw,
+                              bitmap_width_total,
+                              bitmap_height_total,
+                              color,
+                              background_color);
+}
+
+bool GFX2DLIST_draw_rgb_bitmap(GFX2DLIST_instance_t* list,
+                               GFX2D_rgb_bitmap_t rgb_bitmap,
+                               const uint8_t* bitmap,
+                               const uint8_t* alpha_mask,
+                               int16_t x0,
+                               int16_t y0,
+                               uint16_t bitmap_x0,
+                               uint16_t bitmap_y0,
+                               uint16_t bitmap_width_draw,
+                               uint16_t bitmap_height_draw,
+                               uint16_t bitmap_width_total,
+                               uint16_t bitmap_height_total)
+{
+  return GFX2DLIST_add_bitmap(list,
+                              GFX2DLIST_COMMAND_RGB_BITMAP,
+                              (uint8_t)rgb_bitmap,
+                              bitmap,
+                              alpha_mask,
+                              x0,
+                              y0,
+                              bitmap_x0,
+                              bitmap_y0,
+                              bitmap_width_draw,
+                              bitmap_height_draw,
+                              bitmap_width_total,
+                              bitmap_height_total,
+                              0,
+                              0);
+}
+
+bool GFX2DLIST_draw_text(GFX2DLIST_instance_t* list,
+                         GFX2DFONT_font_t* font,
+                         int16_t cursor_x,
+                         int16_t cursor_y,
+                         uint8_t x_magnification,
+                         uint8_t y_magnification,
+                         uint32_t color,
+                         const char* text)
+{
+  uint32_t length = UTILITIES_strlen((char*)text);
+  int32_t x = cursor_x;
+  int32_t y = cursor_y;
+  int32_t left = INT16_MAX;
+  int32_t top = INT16_MAX;
+  int32_t right = INT16_MIN;
+  int32_t bottom = INT16_MIN;
+
+  if (length == 0)
+  {
+    return true;
+  }
+
+  // Bounding box of the glyphs, advancing the cursor as GFX2D_draw_char.
+  // Line breaks move the cursor to a position which depends on the canvas,
+  // hence, text with line breaks is only bounded above.
+
+  for (uint32_t i = 0; i < length; i++)
+  {
+    uint8_t c = (uint8_t)text[i];
+
+    if (c == '\n')
+    {
+      left = INT16_MIN;
+      right = INT16_MAX;
+      bottom = INT16_MAX;
+      y += font->y_advance * y_magnification;
+      continue;
+    }
+
+    if ((c == '\r') || (c < font->first_ascii) || (c > font->last_ascii))
+    {
+      continue;
+    }
+
+    GFX2DFONT_glyph_t* glyph = &font->glyph[c - font->first_ascii];
+
+    if ((glyph->width != 0) && (glyph->height != 0))
+    {
+      left = UTILS_MIN(left, x + glyph->x_offset * x_magnification);
+      right = UTILS_MAX(right, x + (glyph->x_offset + glyph->width) * x_magnification - 1);
+      top = UTILS_MIN(top, y + glyph->y_offset * y_magnification);
+      bottom = UTILS_MAX(bottom, y + (glyph->y_offset + glyph->height) * y_magnification - 1);
+    }
+
+    x += glyph->x_advance * x_magnification;
+  }
+
+  int16_t clip_left = GFX2DLIST_clamp(left);
+  int16_t clip_top = GFX2DLIST_clamp(top);
+  int16_t clip_right = GFX2DLIST_clamp(right);
+  int16_t clip_bottom = GFX2DLIST_clamp(bottom);
+
+  if ((top > bottom) || !GFX2DLIST_clip(list, &clip_left, &clip_top, &clip_right, &clip_bottom))
+  {
+    return true;
+  }
+
+  if ((length > UINT16_MAX) || (list->text_length + length > list->text_buffer_length))
+  {
+    list->overflow = true;
+    return false;
+  }
+
+  GFX2DLIST_command_t* command = GFX2DLIST_add(list, GFX2DLIST_COMMAND_TEXT, clip_left, clip_top, clip_right, clip_bottom, color);
+
+  if (command == NULL)
+  {
+    return false;
+  }
+
+  UTILITIES_memcpy(&list->text_buffer[list->text_length], (void*)text, length);
+
+  command->text.font = font;
+  command->text.offset = list->text_length;
+  command->text.length = (uint16_t)length;
+  command->text.cursor_x = cursor_x;
+  command->text.cursor_y = cursor_y;
+  command->text.x_magnification = x_magnification;
+  command->text.y_magnification = y_magnification;
+
+  list->text_length += length;
+
+  return true;
+}
+
+bool GFX2DLIST_push_clip(GFX2DLIST_instance_t* list,
+                         int16_t x,
+                         int16_t y,
+                         int16_t width,
+                         int16_t height)
+{
+  GFX2DLIST_command_t* command = GFX2DLIST_add(list, GFX2DLIST_COMMAND_PUSH_CLIP, INT16_MIN, INT16_MIN, INT16_MAX, INT16_MAX, 0);
+
+  if (command == NULL)
+  {
+    return false;
+  }
+
+  command->shape[0] = x;
+  command->shape[1] = y;
+  command->shape[2] = width;
+  command->shape[3] = height;
+
+  GFX2DCLIP_push(&list->clip, x, y, width, height);
+
+  return true;
+}
+
+bool GFX2DLIST_pop_clip(GFX2DLIST_instance_t* list)
+{
+  if (GFX2DLIST_add(list, GFX2DLIST_COMMAND_POP_CLIP, INT16_MIN, INT16_MIN, INT16_MAX, INT16_MAX, 0) == NULL)
+  {
+    return false;
+  }
+
+  GFX2DCLIP_pop(&list->clip);
+
+  return true;
+}
+
+#endif // JLIB_CONFIG_GFX2DLIST
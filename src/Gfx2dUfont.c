@@ -0,0 +1,559 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Sparse fonts for GFX2D.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_GFX2DUFONT
+
+#define GFX2DUFONT_NO_CODEPOINT           UINT32_MAX
+#define GFX2DUFONT_CODE_OPAQUE            0x80U
+#define GFX2DUFONT_CODE_RUN_MASK          0x78U
+#define GFX2DUFONT_CODE_RUN_SHIFT         3U
+#define GFX2DUFONT_CODE_ALPHA_MASK        0x07U
+#define GFX2DUFONT_RGB565_LANES           0x07E0F81FUL
+
+static void GFX2DUFONT_new_line(GFX2DUFONT_instance_t* instance)
+{
+  GFX2D_instance_t* gfx = instance->gfx;
+
+  gfx->font.cursor_x = 0;
+  gfx->font.cursor_y = (int16_t)(gfx->font.cursor_y + gfx->font.y_magnification * instance->font->y_advance);
+}
+
+// Places a glyph at the cursor. Glyphs outside the canvas segment are
+// skipped, and the rows to draw are clipped to it. Inversion is applied by
+// GFX2D on the target display coordinates, so inverted text is left to GFX2D
+// to clip.
+
+static bool GFX2DUFONT_place_glyph(GFX2DUFONT_instance_t* instance,
+                                   const GFX2DUFONT_glyph_t* glyph,
+                                   int32_t* x0,
+                                   int32_t* y0,
+                                   int32_t* clip_top,
+                                   int32_t* clip_bottom)
+{
+  GFX2D_instance_t* gfx = instance->gfx;
+
+  *x0 = gfx->font.cursor_x + glyph->x_offset * gfx->font.x_magnification;
+  *y0 = gfx->font.cursor_y + glyph->y_offset * gfx->font.y_magnification;
+  *clip_top = INT16_MIN;
+  *clip_bottom = INT16_MAX;
+
+  if (gfx->flags.invert)
+  {
+    return true;
+  }
+
+  int32_t x1 = *x0 + glyph->width * gfx->font.x_magnification;
+  int32_t y1 = *y0 + glyph->height * gfx->font.y_magnification;
+
+  *clip_top = gfx->canvas_y0;
+  *clip_bottom = gfx->canvas_y0 + gfx->canvas_height;
+
+  return (x1 > gfx->canvas_x0) && (*x0 < gfx->canvas_x0 + gfx->canvas_width) &&
+         (y1 > *clip_top) && (*y0 < *clip_bottom);
+}
+
+// Draws each horizontal run of set bits as one rectangle, rather than a
+// rectangle per pixel.
+
+static void GFX2DUFONT_draw_binary_glyph(GFX2DUFONT_instance_t* instance, const GFX2DUFONT_glyph_t* glyph)
+{
+  GFX2D_instance_t* gfx = instance->gfx;
+  const uint8_t* bitmap = &instance->font->bitmap[glyph->bitmap_offset];
+  int16_t x_magnification = gfx->font.x_magnification;
+  int16_t y_magnification = gfx->font.y_magnification;
+  int32_t x0;
+  int32_t y0;
+  int32_t clip_top;
+  int32_t clip_bottom;
+  uint32_t bit = 0;
+
+  if (!GFX2DUFONT_place_glyph(instance, glyph, &x0, &y0, &clip_top, &clip_bottom))
+  {
+    return;
+  }
+
+  for (uint8_t row = 0; row < glyph->height; row++)
+  {
+    int32_t y = y0 + row * y_magnification;
+
+    if ((y + y_magnification <= clip_top) || (y >= clip_bottom))
+    {
+      bit += glyph->width;
+      continue;
+    }
+
+    uint8_t run_start = 0;
+    uint8_t run_length = 0;
+
+    for (uint8_t column = 0; column < glyph->width; column++, bit++)
+    {
+      if (bitmap[bit >> 3] & (0x80U >> (bit & 7U)))
+      {
+        if (run_length++ == 0)
+        {
+          run_start = column;
+        }
+      }
+      else if (run_length != 0)
+      {
+        GFX2D_draw_filled_rectangle(gfx,
+                                    (int16_t)(x0 + run_start * x_magnification),
+                                    (int16_t)y,
+                                    (int16_t)(run_length * x_magnification),
+                                    y_magnification,
+                                    gfx->font.color);
+        run_length = 0;
+      }
+    }
+
+    if (run_length != 0)
+    {
+      GFX2D_draw_filled_rectangle(gfx,
+                                  (int16_t)(x0 + run_start * x_magnification),
+                                  (int16_t)y,
+                                  (int16_t)(run_length * x_magnification),
+                                  y_magnification,
+                                  gfx->font.color);
+    }
+  }
+}
+
+static uint16_t GFX2DUFONT_swap(uint16_t pixel)
+{
+  return (uint16_t)((pixel << 8) | (pixel >> 8));
+}
+
+// Blends with the red, green, and blue channels spread into lanes of a word,
+// alpha being 0 to 32.
+
+static uint16_t GFX2DUFONT_blend_rgb565(uint16_t dest, uint16_t color, uint32_t alpha)
+{
+  uint32_t background = (dest | ((uint32_t)dest << 16)) & GFX2DUFONT_RGB565_LANES;
+  uint32_t foreground = (color | ((uint32_t)color << 16)) & GFX2DUFONT_RGB565_LANES;
+  uint32_t result = ((((foreground - background) * alpha) >> 5) + background) & GFX2DUFONT_RGB565_LANES;
+
+  return (uint16_t)(result | (result >> 16));
+}
+
+// The palette holds the colors of each alpha value, blended from the
+// background color to the font color per channel, and is only recomputed
+// when either color changes.
+
+static void GFX2DUFONT_update_palette(GFX2DUFONT_instance_t* instance)
+{
+  GFX2D_instance_t* gfx = instance->gfx;
+  uint8_t alpha_bits = instance->font->alpha_bits;
+
+  if ((instance->palette_bits == alpha_bits) &&
+      (instance->palette_color == gfx->font.color) &&
+      (instance->palette_background == instance->background_color))
+  {
+    return;
+  }
+
+  uint32_t alpha_max = (1UL << alpha_bits) - 1U;
+
+  for (uint32_t alpha = 0; alpha <= alpha_max; alpha++)
+  {
+    uint32_t rgba = 0;
+
+    for (uint8_t shift = 0; shift < 32U; shift = (uint8_t)(shift + 8U))
+    {
+      uint32_t background = (instance->background_color >> shift) & 0xFFU;
+      uint32_t foreground = (gfx->font.color >> shift) & 0xFFU;
+
+      rgba |= ((background * (alpha_max - alpha) + foreground * alpha + alpha_max / 2U) / alpha_max) << shift;
+    }
+
+    instance->palette_rgba[alpha] = rgba;
+    instance->palette_pixel[alpha] = (uint16_t)gfx->rgba_to_pixel(rgba);
+  }
+
+  instance->palette_bits = alpha_bits;
+  instance->palette_color = gfx->font.color;
+  instance->palette_background = instance->background_color;
+}
+
+// Opaque runs are drawn as rectangles. The alpha of partially covered pixels
+// is read from the alpha values following the codes. Partially covered pixels of 16-bit
+// canvases are written directly, from the palette or blended with the canvas,
+// and otherwise drawn through GFX2D, from the palette or if at least half
+// covered.
+
+static void GFX2DUFONT_draw_alpha_glyph(GFX2DUFONT_instance_t* instance, const GFX2DUFONT_glyph_t* glyph)
+{
+  GFX2D_instance_t* gfx = instance->gfx;
+  const uint8_t* data = &instance->font->bitmap[glyph->bitmap_offset];
+  uint8_t alpha_bits = instance->font->alpha_bits;
+  uint8_t alpha_max = (uint8_t)((1U << alpha_bits) - 1U);
+  int16_t x_magnification = gfx->font.x_magnification;
+  int16_t y_magnification = gfx->font.y_magnification;
+  uint16_t* canvas = NULL;
+  uint16_t color = 0;
+  int32_t x0;
+  int32_t y0;
+  int32_t clip_top;
+  int32_t clip_bottom;
+  uint8_t column = 0;
+  uint8_t row = 0;
+
+  if (!GFX2DUFONT_place_glyph(instance, glyph, &x0, &y0, &clip_top, &clip_bottom))
+  {
+    return;
+  }
+
+  if (!gfx->flags.invert && (gfx->bits_per_pixel == 16) && (x_magnification == 1) && (y_magnification == 1))
+  {
+    canvas = (uint16_t*)gfx->display_buffer;
+    color = (uint16_t)gfx->rgba_to_pixel(gfx->font.color);
+
+    if (instance->pixel_format == GFX2DUFONT_PIXEL_FORMAT_RGB565_SWAPPED)
+    {
+      color = GFX2DUFONT_swap(color);
+    }
+  }
+
+  if (instance->background_known)
+  {
+    GFX2DUFONT_update_palette(instance);
+  }
+
+  uint16_t code_count = *data++;
+
+  if (code_count & 0x80U)
+  {
+    code_count = (uint16_t)(((code_count & 0x7FU) << 8) | *data++);
+  }
+
+  const uint8_t* alpha_data = data + code_count;
+  uint32_t alpha_count = (code_count == 0) ? (uint32_t)glyph->width * glyph->height : 0;
+  uint32_t alpha_scale = (32U * 256U + alpha_max / 2U) / alpha_max;
+  uint8_t shift = 8;
+
+  while (row < glyph->height)
+  {
+    if (alpha_count == 0)
+    {
+      uint8_t code = *data++;
+      uint8_t run = (uint8_t)((code & GFX2DUFONT_CODE_RUN_MASK) >> GFX2DUFONT_CODE_RUN_SHIFT);
+
+      alpha_count = code & GFX2DUFONT_CODE_ALPHA_MASK;
+
+      while (run != 0)
+      {
+        uint8_t count = (uint8_t)UTILS_MIN(run, (uint8_t)(glyph->width - column));
+        int32_t y = y0 + row * y_magnification;
+
+        if ((code & GFX2DUFONT_CODE_OPAQUE) && (y + y_magnification > clip_top) && (y < clip_bottom))
+        {
+          GFX2D_draw_filled_rectangle(gfx,
+                                      (int16_t)(x0 + column * x_magnification),
+                                      (int16_t)y,
+                                      (int16_t)(count * x_magnification),
+                                      y_magnification,
+                                      gfx->font.color);
+        }
+
+        run = (uint8_t)(run - count);
+        column = (uint8_t)(column + count);
+
+        if (column == glyph->width)
+        {
+          column = 0;
+          row++;
+        }
+      }
+
+      continue;
+    }
+
+    shift = (uint8_t)(shift - alpha_bits);
+
+    uint8_t alpha = (uint8_t)((*alpha_data >> shift) & alpha_max);
+    int32_t x = x0 + column * x_magnification;
+    int32_t y = y0 + row * y_magnification;
+
+    alpha_count--;
+
+    if (shift == 0)
+    {
+      shift = 8;
+      alpha_data++;
+    }
+
+    if (++column == glyph->width)
+    {
+      column = 0;
+      row++;
+    }
+
+    if ((alpha == 0) || (y + y_magnification <= clip_top) || (y >= clip_bottom))
+    {
+      continue;
+    }
+
+    if (canvas != NULL)
+    {
+      x -= gfx->canvas_x0;
+
+      if ((x < 0) || (x >= gfx->canvas_width))
+      {
+        continue;
+      }
+
+      uint16_t* pixel = &canvas[(y - gfx->canvas_y0) * gfx->canvas_width + x];
+
+      if (instance->background_known)
+      {
+        *pixel = instance->palette_pixel[alpha];
+      }
+      else if (instance->pixel_format == GFX2DUFONT_PIXEL_FORMAT_RGB565)
+      {
+        *pixel = GFX2DUFONT_blend_rgb565(*pixel, color, (alpha * alpha_scale + 128U) >> 8);
+      }
+      else if (instance->pixel_format == GFX2DUFONT_PIXEL_FORMAT_RGB565_SWAPPED)
+      {
+        *pixel = GFX2DUFONT_swap(GFX2DUFONT_blend_rgb565(GFX2DUFONT_swap(*pixel), color, (alpha * alpha_scale + 128U) >> 8));
+      }
+      else if (2U * alpha > alpha_max)
+      {
+        *pixel = color;
+      }
+    }
+    else if (instance->background_known || (2U * alpha > alpha_max))
+    {
+      GFX2D_draw_filled_rectangle(gfx,
+                                  (int16_t)x,
+                                  (int16_t)y,
+                                  x_magnification,
+                                  y_magnification,
+                                  instance->background_known ? instance->palette_rgba[alpha] : gfx->font.color);
+    }
+  }
+}
+
+void GFX2DUFONT_initialize(GFX2DUFONT_instance_t* instance,
+                           GFX2D_instance_t* gfx,
+                           const GFX2DUFONT_font_t* font)
+{
+  UTILITIES_memclear(instance, sizeof(GFX2DUFONT_instance_t));
+
+  instance->gfx = gfx;
+
+  if (gfx->bits_per_pixel == 16)
+  {
+    uint32_t red = gfx->rgba_to_pixel(0xFF0000FFUL);
+    uint32_t green = gfx->rgba_to_pixel(0xFF00FF00UL);
+    uint32_t blue = gfx->rgba_to_pixel(0xFFFF0000UL);
+
+    if ((red == 0xF800U) && (green == 0x07E0U) && (blue == 0x001FU))
+    {
+      instance->pixel_format = GFX2DUFONT_PIXEL_FORMAT_RGB565;
+    }
+    else if ((red == 0x00F8U) && (green == 0xE007U) && (blue == 0x1F00U))
+    {
+      instance->pixel_format = GFX2DUFONT_PIXEL_FORMAT_RGB565_SWAPPED;
+    }
+  }
+
+  GFX2DUFONT_set_font(instance, font);
+}
+
+void GFX2DUFONT_set_font(GFX2DUFONT_instance_t* instance, const GFX2DUFONT_font_t* font)
+{
+  instance->font = font;
+  instance->cached_codepoint = GFX2DUFONT_NO_CODEPOINT;
+  instance->cached_glyph = NULL;
+  instance->cached_range = 0;
+  instance->palette_bits = 0;
+}
+
+void GFX2DUFONT_set_background(GFX2DUFONT_instance_t* instance, bool enable, uint32_t color)
+{
+  instance->background_known = enable;
+  instance->background_color = color;
+}
+
+const GFX2DUFONT_glyph_t* GFX2DUFONT_find_glyph(GFX2DUFONT_instance_t* instance, uint32_t codepoint)
+{
+  if (codepoint == instance->cached_codepoint)
+  {
+    return instance->cached_glyph;
+  }
+
+  const GFX2DUFONT_font_t* font = instance->font;
+  const GFX2DUFONT_glyph_t* glyph = NULL;
+  uint16_t index = instance->cached_range;
+
+  if ((index >= font->range_count) || (codepoint - font->range[index].first_codepoint >= font->range[index].length))
+  {
+    uint16_t low = 0;
+    uint16_t high = font->range_count;
+
+    index = UINT16_MAX;
+
+    while (low < high)
+    {
+      uint16_t middle = (uint16_t)((low + high) / 2U);
+      const GFX2DUFONT_range_t* range = &font->range[middle];
+
+      if (codepoint < range->first_codepoint)
+      {
+        high = middle;
+      }
+      else if (codepoint - range->first_codepoint >= range->length)
+      {
+        low = (uint16_t)(middle + 1U);
+      }
+      else
+      {
+        index = middle;
+        break;
+      }
+    }
+  }
+
+  if (index != UINT16_MAX)
+  {
+    const GFX2DUFONT_range_t* range = &font->range[index];
+
+    glyph = &font->glyph[range->first_glyph + (codepoint - range->first_codepoint)];
+    instance->cached_range = index;
+  }
+
+  instance->cached_codepoint = codepoint;
+  instance->cached_glyph = glyph;
+
+  return glyph;
+}
+
+void GFX2DUFONT_draw_codepoint(GFX2DUFONT_instance_t* instance, uint32_t codepoint)
+{
+  GFX2D_instance_t* gfx = instance->gfx;
+
+  if (codepoint == '\r')
+  {
+    return;
+  }
+
+  if (codepoint == '\n')
+  {
+    GFX2DUFONT_new_line(instance);
+    return;
+  }
+
+  const GFX2DUFONT_glyph_t* glyph = GFX2DUFONT_find_glyph(instance, codepoint);
+
+  if (glyph == NULL)
+  {
+    return;
+  }
+
+  if ((glyph->width != 0) && (glyph->height != 0))
+  {
+    if (gfx->flags.wrap_text &&
+        (gfx->font.cursor_x + (glyph->x_offset + glyph->width) * gfx->font.x_magnification > gfx->canvas_width))
+    {
+      GFX2DUFONT_new_line(instance);
+    }
+
+    if (instance->font->alpha_bits == 0)
+    {
+      GFX2DUFONT_draw_binary_glyph(instance, glyph);
+    }
+    else
+    {
+      GFX2DUFONT_draw_alpha_glyph(instance, glyph);
+    }
+  }
+
+  gfx->font.cursor_x = (int16_t)(gfx->font.cursor_x + glyph->x_advance * gfx->font.x_magnification);
+}
+
+void GFX2DUFONT_draw_char(GFX2DUFONT_instance_t* instance, uint8_t c)
+{
+  if (c < 0x80U)
+  {
+    instance->utf8_remaining = 0;
+    GFX2DUFONT_draw_codepoint(instance, c);
+    return;
+  }
+
+  if ((c & 0xC0U) == 0x80U)
+  {
+    if (instance->utf8_remaining == 0)
+    {
+      return;
+    }
+
+    instance->utf8_codepoint = (instance->utf8_codepoint << 6) | (c & 0x3FU);
+
+    if (--instance->utf8_remaining != 0)
+    {
+      return;
+    }
+
+    uint32_t codepoint = instance->utf8_codepoint;
+    bool valid;
+
+    switch (instance->utf8_length)
+    {
+      case 2:
+        valid = (codepoint >= 0x80U);
+        break;
+      case 3:
+        valid = (codepoint >= 0x800U) && ((codepoint < 0xD800U) || (codepoint > 0xDFFFU));
+        break;
+      default:
+        valid = (codepoint >= 0x10000U) && (codepoint <= 0x10FFFFU);
+        break;
+    }
+
+    if (valid)
+    {
+      GFX2DUFONT_draw_codepoint(instance, codepoint);
+    }
+
+    return;
+  }
+
+  // A lead byte starts a new sequence, dropping any truncated one.
+
+  if ((c & 0xE0U) == 0xC0U)
+  {
+    instance->utf8_codepoint = c & 0x1FU;
+    instance->utf8_length = 2;
+  }
+  else if ((c & 0xF0U) == 0xE0U)
+  {
+    instance->utf8_codepoint = c & 0x0FU;
+    instance->utf8_length = 3;
+  }
+  else if ((c & 0xF8U) == 0xF0U)
+  {
+    instance->utf8_codepoint = c & 0x07U;
+    instance->utf8_length = 4;
+  }
+  else
+  {
+    instance->utf8_remaining = 0;
+    return;
+  }
+
+  instance->utf8_remaining = (uint8_t)(instance->utf8_length - 1U);
+}
+
+void GFX2DUFONT_draw_string(GFX2DUFONT_instance_t* instance, const char* text)
+{
+  while (*text != '\0')
+  {
+    GFX2DUFONT_draw_char(instance, (uint8_t)*text++);
+  }
+}
+
+#endif // JLIB_CONFIG_GFX2DUFONT
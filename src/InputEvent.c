@@ -0,0 +1,207 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Deferred input event output for the BiButton and RotaryEncoder modules.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_INPUTEVENT
+
+// Active instance and context while an encoder is serviced - see
+// INPUTEVENT_rotaryencoder_service notes.
+
+static INPUTEVENT_instance_t* INPUTEVENT_active_instance;
+static ROTARYENCODER_instance_t* INPUTEVENT_active_encoder;
+static uint32_t INPUTEVENT_active_context;
+
+static bool INPUTEVENT_enqueue(INPUTEVENT_instance_t* instance, INPUTEVENT_event_t* event)
+{
+  if (!QUEUE_enqueue(instance->queue, event))
+  {
+    instance->dropped_count++;
+    return false;
+  }
+
+  return true;
+}
+
+static bool INPUTEVENT_flush_pending(INPUTEVENT_instance_t* instance)
+{
+  if (!instance->flags.pending)
+  {
+    return true;
+  }
+
+  instance->flags.pending = 0;
+
+  return INPUTEVENT_enqueue(instance, &instance->pending_event);
+}
+
+static uint32_t INPUTEVENT_timestamp(INPUTEVENT_instance_t* instance)
+{
+  return (uint32_t)UTIMER_ticket_elapsed_time(instance->utimer, &instance->utimer_ticket);
+}
+
+void INPUTEVENT_initialize(INPUTEVENT_instance_t* instance,
+                           QUEUE_instance_t* queue,
+                           UTIMER_instance_t* utimer,
+                           uint32_t coalesce_window_us)
+{
+  UTILS_ASSERT(queue->element_size == sizeof(INPUTEVENT_event_t));
+
+  UTILITIES_memclear(instance, sizeof(INPUTEVENT_instance_t));
+
+  instance->queue = queue;
+  instance->utimer = utimer;
+  instance->coalesce_window_us = coalesce_window_us;
+  instance->flags.coalesce_enabled = (coalesce_window_us != 0);
+
+  UTIMER_ticket_create(utimer, &instance->utimer_ticket, 0);
+}
+
+bool INPUTEVENT_post(INPUTEVENT_instance_t* instance,
+                     INPUTEVENT_source_t source,
+                     void* origin,
+                     uint32_t context,
+                     int16_t delta)
+{
+  uint32_t timestamp_us = INPUTEVENT_timestamp(instance);
+  INPUTEVENT_event_t* pending = &instance->pending_event;
+
+  if (instance->flags.pending)
+  {
+    // Merge into the pending event if it is from the same encoder, within the
+    // coalescing window, and the net delta remains representable.
+
+    int32_t merged_delta = (int32_t)pending->delta + delta;
+
+    if ((source == INPUTEVENT_SOURCE_ROTARYENCODER) &&
+        (pending->origin == origin) &&
+        (pending->context == context) &&
+        ((timestamp_us - pending->timestamp_us) < instance->coalesce_window_us) &&
+        (merged_delta <= INT16_MAX) &&
+        (merged_delta >= INT16_MIN))
+    {
+      pending->delta = (int16_t)merged_delta;
+      return true;
+    }
+
+    INPUTEVENT_flush_pending(instance);
+  }
+
+  INPUTEVENT_event_t event;
+
+  event.timestamp_us = timestamp_us;
+  event.origin = origin;
+  event.context = context;
+  event.delta = delta;
+  event.source = (uint8_t)source;
+  event.reserved = 0;
+
+  if (instance->flags.coalesce_enabled && (source == INPUTEVENT_SOURCE_ROTARYENCODER))
+  {
+    *pending = event;
+    instance->flags.pending = 1;
+    return true;
+  }
+
+  return INPUTEVENT_enqueue(instance, &event);
+}
+
+bool INPUTEVENT_service(INPUTEVENT_instance_t* instance)
+{
+  if (!instance->flags.pending)
+  {
+    return true;
+  }
+
+  uint32_t elapsed_us = INPUTEVENT_timestamp(instance) - instance->pending_event.timestamp_us;
+
+  if (elapsed_us < instance->coalesce_window_us)
+  {
+    return false;
+  }
+
+  INPUTEVENT_flush_pending(instance);
+
+  return true;
+}
+
+bool INPUTEVENT_dispatch(INPUTEVENT_instance_t* instance, INPUTEVENT_event_t* event)
+{
+  INPUTEVENT_event_t dequeued;
+
+  if (!QUEUE_dequeue(instance->queue, &dequeued))
+  {
+    return false;
+  }
+
+  if (dequeued.source == INPUTEVENT_SOURCE_BIBUTTON)
+  {
+    BIBUTTON_pattern_instance_t* pattern_instance = (BIBUTTON_pattern_instance_t*)dequeued.origin;
+
+    pattern_instance->callback(pattern_instance->callback_context);
+  }
+  else
+  {
+    ROTARYENCODER_instance_t* encoder = (ROTARYENCODER_instance_t*)dequeued.origin;
+    bool clockwise = (dequeued.delta > 0);
+    uint16_t ticks = (uint16_t)(clockwise ? dequeued.delta : -dequeued.delta);
+
+    while (ticks-- > 0)
+    {
+      encoder->rotation_tick_callback(clockwise);
+    }
+  }
+
+  if (event != NULL)
+  {
+    *event = dequeued;
+  }
+
+  return true;
+}
+
+static void INPUTEVENT_bibutton_match_handler(void* context,
+                                              BIBUTTON_pattern_instance_t* pattern_instance)
+{
+  INPUTEVENT_post((INPUTEVENT_instance_t*)context,
+                  INPUTEVENT_SOURCE_BIBUTTON,
+                  pattern_instance,
+                  pattern_instance->callback_context,
+                  0);
+}
+
+void INPUTEVENT_attach_bibutton(INPUTEVENT_instance_t* instance,
+                                BIBUTTON_matcher_t* matcher)
+{
+  matcher->match_handler = INPUTEVENT_bibutton_match_handler;
+  matcher->match_handler_context = instance;
+}
+
+static void INPUTEVENT_rotation_tick_handler(bool clockwise)
+{
+  INPUTEVENT_post(INPUTEVENT_active_instance,
+                  INPUTEVENT_SOURCE_ROTARYENCODER,
+                  INPUTEVENT_active_encoder,
+                  INPUTEVENT_active_context,
+                  clockwise ? 1 : -1);
+}
+
+void INPUTEVENT_rotaryencoder_service(INPUTEVENT_instance_t* instance,
+                                      ROTARYENCODER_instance_t* encoder,
+                                      uint32_t context)
+{
+  ROTARYENCODER_rotation_tick_callback_t rotation_tick_callback = encoder->rotation_tick_callback;
+
+  INPUTEVENT_active_instance = instance;
+  INPUTEVENT_active_encoder = encoder;
+  INPUTEVENT_active_context = context;
+
+  encoder->rotation_tick_callback = INPUTEVENT_rotation_tick_handler;
+  ROTARYENCODER_service(encoder);
+  encoder->rotation_tick_callback = rotation_tick_callback;
+}
+
+#endif // JLIB_CONFIG_INPUTEVENT
@@ -0,0 +1,102 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Read-only asset file system for the WEB modules.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_ROMFS
+
+#define ROMFS_FNV_OFFSET_BASIS            0x811C9DC5U
+#define ROMFS_FNV_PRIME                   0x01000193U
+
+static const ROMFS_entry_t* ROMFS_entries(const ROMFS_header_t* header)
+{
+  uint32_t displacements_length = ((uint32_t)header->bucket_count * sizeof(uint16_t) + 3U) & ~3U;
+
+  return (const ROMFS_entry_t*)((const uint8_t*)header + sizeof(ROMFS_header_t) + displacements_length);
+}
+
+static bool ROMFS_string_equals(const char* a, const char* b)
+{
+  while ((*a != '\0') && (*a == *b))
+  {
+    a++;
+    b++;
+  }
+
+  return (*a == *b);
+}
+
+uint32_t ROMFS_hash(const char* path, uint32_t seed)
+{
+  uint32_t hash = ROMFS_FNV_OFFSET_BASIS ^ seed;
+
+  while (*path != '\0')
+  {
+    hash ^= (uint8_t)*path++;
+    hash *= ROMFS_FNV_PRIME;
+  }
+
+  return hash;
+}
+
+bool ROMFS_is_valid(const void* image)
+{
+  const ROMFS_header_t* header = (const ROMFS_header_t*)image;
+
+  return (header != NULL) &&
+         (header->magic == ROMFS_MAGIC) &&
+         (header->version == ROMFS_VERSION) &&
+         ((header->file_count == 0) || (header->bucket_count != 0));
+}
+
+const ROMFS_entry_t* ROMFS_lookup(const void* image, const char* path)
+{
+  const ROMFS_header_t* header = (const ROMFS_header_t*)image;
+
+  if (header->file_count == 0)
+  {
+    return NULL;
+  }
+
+  const uint16_t* displacements = (const uint16_t*)((const uint8_t*)image + sizeof(ROMFS_header_t));
+  uint16_t bucket = (uint16_t)(ROMFS_hash(path, 0) % header->bucket_count);
+  uint16_t slot = (uint16_t)(ROMFS_hash(path, displacements[bucket]) % header->file_count);
+  const ROMFS_entry_t* entry = &ROMFS_entries(header)[slot];
+
+  // Paths not in the image hash to an arbitrary entry, hence, the path is
+  // compared once.
+
+  if (!ROMFS_string_equals((const char*)image + entry->path_offset, path))
+  {
+    return NULL;
+  }
+
+  return entry;
+}
+
+bool ROMFS_open(const void* image, const char* path, WEB_asset_t* asset)
+{
+  const ROMFS_entry_t* entry = ROMFS_lookup(image, path);
+
+  if (entry == NULL)
+  {
+    return false;
+  }
+
+  const char* strings = (const char*)image;
+
+  asset->path = strings + entry->path_offset;
+  asset->content_type = strings + entry->content_type_offset;
+  asset->content_encoding = entry->flags.gzip ? "gzip" : NULL;
+  asset->etag = (entry->etag_offset == ROMFS_OFFSET_NONE) ? NULL : strings + entry->etag_offset;
+  asset->data = (const uint8_t*)image + entry->data_offset;
+  asset->length = entry->length;
+  asset->uncompressed_length = entry->uncompressed_length;
+
+  return true;
+}
+
+#endif // JLIB_CONFIG_ROMFS
@@ -0,0 +1,168 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Table-driven quadrature decoder for the rotary encoder module.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_ROTARYENCODER_QUADRATURE
+
+// Marks a transition where both phases changed at once.
+
+#define ROTARYENCODER_QUADRATURE_ILLEGAL  2
+
+/*
+ * Direction of each transition, indexed by (previous state << 2) | state,
+ * where a state is (A << 1) | B. Clockwise follows 00, 01, 11, 10.
+ */
+
+static const int8_t ROTARYENCODER_QUADRATURE_TABLE[16] =
+{
+   0,  1, -1,  ROTARYENCODER_QUADRATURE_ILLEGAL,
+  -1,  0,  ROTARYENCODER_QUADRATURE_ILLEGAL,  1,
+   1,  ROTARYENCODER_QUADRATURE_ILLEGAL,  0, -1,
+   ROTARYENCODER_QUADRATURE_ILLEGAL, -1,  1,  0
+};
+
+static uint8_t ROTARYENCODER_quadrature_state(ROTARYENCODER_quadrature_instance_t* instance,
+                                              uint32_t port_sample)
+{
+  return (uint8_t)((((port_sample >> instance->pin_a) & 1U) << 1) |
+                   ((port_sample >> instance->pin_b) & 1U));
+}
+
+static int32_t ROTARYENCODER_quadrature_accelerate(ROTARYENCODER_quadrature_instance_t* instance,
+                                                   int32_t direction)
+{
+  uint64_t interval_us = UTIMER_ticket_elapsed_time(instance->utimer, &instance->utimer_ticket);
+
+  UTIMER_ticket_create(instance->utimer, &instance->utimer_ticket, 0);
+
+  if (interval_us >= instance->acceleration_threshold_us)
+  {
+    return direction;
+  }
+
+  uint32_t multiplier = 1U + (uint32_t)(((uint64_t)(instance->acceleration_max_multiplier - 1U) *
+                                         (instance->acceleration_threshold_us - interval_us)) /
+                                        instance->acceleration_threshold_us);
+
+  return direction * (int32_t)multiplier;
+}
+
+static void ROTARYENCODER_quadrature_decode(ROTARYENCODER_quadrature_instance_t* instance,
+                                            uint32_t port_sample)
+{
+  uint8_t state = ROTARYENCODER_quadrature_state(instance, port_sample);
+
+  if (state == instance->state)
+  {
+    return;
+  }
+
+  int8_t step = ROTARYENCODER_QUADRATURE_TABLE[(instance->state << 2) | state];
+
+  instance->state = state;
+
+  if (step == ROTARYENCODER_QUADRATURE_ILLEGAL)
+  {
+    instance->illegal_transition_count++;
+    return;
+  }
+
+  instance->step_accumulator += step;
+
+  if ((instance->step_accumulator < instance->steps_per_detent) &&
+      (instance->step_accumulator > -instance->steps_per_detent))
+  {
+    return;
+  }
+
+  int32_t delta = (instance->step_accumulator > 0) ? 1 : -1;
+
+  instance->step_accumulator = 0;
+
+  if (instance->flags.reversed)
+  {
+    delta = -delta;
+  }
+
+  if (instance->flags.acceleration_enabled)
+  {
+    delta = ROTARYENCODER_quadrature_accelerate(instance, delta);
+  }
+
+  instance->position += delta;
+
+  if (instance->detent_callback != NULL)
+  {
+    instance->detent_callback(instance->callback_context, delta);
+  }
+}
+
+void ROTARYENCODER_quadrature_initialize(ROTARYENCODER_quadrature_instance_t* instance,
+                                         uint8_t pin_a,
+                                         uint8_t pin_b,
+                                         uint8_t steps_per_detent,
+                                         bool reversed,
+                                         uint32_t port_sample,
+                                         uint32_t callback_context,
+                                         ROTARYENCODER_detent_callback_t detent_callback)
+{
+  UTILITIES_memclear(instance, sizeof(ROTARYENCODER_quadrature_instance_t));
+
+  instance->pin_a = pin_a;
+  instance->pin_b = pin_b;
+  instance->steps_per_detent = (steps_per_detent == 0) ? 1U : steps_per_detent;
+  instance->flags.reversed = reversed;
+  instance->callback_context = callback_context;
+  instance->detent_callback = detent_callback;
+  instance->state = ROTARYENCODER_quadrature_state(instance, port_sample);
+}
+
+void ROTARYENCODER_quadrature_set_acceleration(ROTARYENCODER_quadrature_instance_t* instance,
+                                               UTIMER_instance_t* utimer,
+                                               uint32_t acceleration_threshold_us,
+                                               uint8_t acceleration_max_multiplier)
+{
+  instance->utimer = utimer;
+  instance->acceleration_threshold_us = acceleration_threshold_us;
+  instance->acceleration_max_multiplier = acceleration_max_multiplier;
+  instance->flags.acceleration_enabled = ((utimer != NULL) &&
+                                          (acceleration_threshold_us != 0) &&
+                                          (acceleration_max_multiplier > 1U));
+
+  if (instance->flags.acceleration_enabled)
+  {
+    UTIMER_ticket_create(utimer, &instance->utimer_ticket, 0);
+  }
+}
+
+void ROTARYENCODER_quadrature_sample(ROTARYENCODER_quadrature_instance_t* instances,
+                                     uint8_t instance_count,
+                                     uint32_t port_sample)
+{
+  for (uint8_t i = 0; i < instance_count; i++)
+  {
+    ROTARYENCODER_quadrature_decode(&instances[i], port_sample);
+  }
+}
+
+void ROTARYENCODER_quadrature_process_samples(ROTARYENCODER_quadrature_instance_t* instances,
+                                              uint8_t instance_count,
+                                              const uint32_t* samples,
+                                              uint32_t sample_count)
+{
+  for (uint32_t sample_index = 0; sample_index < sample_count; sample_index++)
+  {
+    if ((sample_index > 0) && (samples[sample_index] == samples[sample_index - 1]))
+    {
+      continue;
+    }
+
+    ROTARYENCODER_quadrature_sample(instances, instance_count, samples[sample_index]);
+  }
+}
+
+#endif // JLIB_CONFIG_ROTARYENCODER_QUADRATURE
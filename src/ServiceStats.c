@@ -0,0 +1,179 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Service efficiency counters for the polled module state machines.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_SERVICESTATS
+
+static uint32_t SERVICESTATS_timestamp(SERVICESTATS_instance_t* stats)
+{
+  return (stats->get_timestamp != NULL) ? stats->get_timestamp() : 0;
+}
+
+static void SERVICESTATS_unblock(SERVICESTATS_instance_t* stats, uint32_t timestamp)
+{
+  if (!stats->blocked)
+  {
+    return;
+  }
+
+  stats->states[stats->blocked_state].blocked_ticks += (uint32_t)(timestamp - stats->blocked_timestamp);
+  stats->blocked = false;
+}
+
+static void SERVICESTATS_wait(SERVICESTATS_instance_t* stats, void* instance, uint32_t ticks)
+{
+  stats->waiting_calls++;
+
+  if (stats->states == NULL)
+  {
+    return;
+  }
+
+  uint32_t state = (stats->state_probe != NULL) ? stats->state_probe(instance) : 0;
+  uint8_t index = (uint8_t)UTILS_MIN(state, (uint32_t)stats->state_count - 1U);
+
+  // A wait lasts until the state machine advances or moves to another state
+  // in which it waits.
+
+  if (stats->blocked && (stats->blocked_state != index))
+  {
+    SERVICESTATS_unblock(stats, stats->call_timestamp);
+  }
+
+  if (!stats->blocked)
+  {
+    stats->blocked = true;
+    stats->blocked_state = index;
+    stats->blocked_timestamp = stats->call_timestamp;
+  }
+
+  stats->states[index].waiting_calls++;
+  stats->states[index].waiting_ticks += ticks;
+}
+
+void SERVICESTATS_initialize(SERVICESTATS_instance_t* stats,
+                             SERVICESTATS_state_t* states,
+                             uint8_t state_count,
+                             SERVICESTATS_hal_get_timestamp_t get_timestamp,
+                             SERVICESTATS_probe_t progress_probe,
+                             SERVICESTATS_probe_t state_probe)
+{
+  UTILS_ASSERT((states == NULL) || (state_count != 0));
+
+  UTILITIES_memclear(stats, sizeof(SERVICESTATS_instance_t));
+
+  stats->states = states;
+  stats->state_count = state_count;
+  stats->get_timestamp = get_timestamp;
+  stats->progress_probe = progress_probe;
+  stats->state_probe = state_probe;
+
+  SERVICESTATS_clear(stats);
+}
+
+void SERVICESTATS_clear(SERVICESTATS_instance_t* stats)
+{
+  stats->calls = 0;
+  stats->progress_calls = 0;
+  stats->waiting_calls = 0;
+  stats->idle_calls = 0;
+  stats->service_ticks = 0;
+  stats->service_ticks_max = 0;
+  stats->idle = true;
+  stats->blocked = false;
+
+  if (stats->states != NULL)
+  {
+    UTILITIES_memclear(stats->states, (uint32_t)stats->state_count * sizeof(SERVICESTATS_state_t));
+  }
+}
+
+void SERVICESTATS_begin(SERVICESTATS_instance_t* stats, void* instance)
+{
+  stats->call_progress = (stats->progress_probe != NULL) ? stats->progress_probe(instance) : 0;
+  stats->call_timestamp = SERVICESTATS_timestamp(stats);
+}
+
+bool SERVICESTATS_end(SERVICESTATS_instance_t* stats, void* instance, bool idle)
+{
+  uint32_t ticks = SERVICESTATS_timestamp(stats) - stats->call_timestamp;
+  bool advanced = (stats->progress_probe != NULL) && (stats->progress_probe(instance) != stats->call_progress);
+  bool completed = idle && !stats->idle;
+
+  stats->calls++;
+  stats->service_ticks += ticks;
+  stats->service_ticks_max = UTILS_MAX(stats->service_ticks_max, ticks);
+  stats->idle = idle;
+
+  if (!idle && !advanced)
+  {
+    SERVICESTATS_wait(stats, instance, ticks);
+    return idle;
+  }
+
+  if (advanced || completed)
+  {
+    stats->progress_calls++;
+  }
+  else
+  {
+    stats->idle_calls++;
+  }
+
+  SERVICESTATS_unblock(stats, stats->call_timestamp);
+
+  return idle;
+}
+
+bool SERVICESTATS_service(SERVICESTATS_instance_t* stats, SERVICESTATS_service_t service, void* instance)
+{
+  return SERVICESTATS_SERVICE(stats, service, instance);
+}
+
+// The element counters only increase during a task and the flags change with
+// the task state, hence, their sum changes whenever the task advances.
+
+uint32_t SERVICESTATS_serspi_progress(void* instance)
+{
+  SERSPI_instance_t* spi = (SERSPI_instance_t*)instance;
+
+  return spi->rx_element_counter +
+         spi->tx_element_counter +
+         spi->tx_dummy_element_counter +
+         ((uint32_t)spi->flags.all << 24);
+}
+
+uint32_t SERVICESTATS_serspi_state(void* instance)
+{
+  return ((SERSPI_instance_t*)instance)->flags.task_state;
+}
+
+uint32_t SERVICESTATS_seruart_progress(void* instance)
+{
+  SERUART_instance_t* uart = (SERUART_instance_t*)instance;
+
+  return uart->rx_element_counter +
+         uart->tx_element_counter +
+         ((uint32_t)uart->flags.all << 24);
+}
+
+uint32_t SERVICESTATS_seri2c_progress(void* instance)
+{
+  SERI2C_instance_t* i2c = (SERI2C_instance_t*)instance;
+
+  return i2c->rx_element_counter +
+         i2c->tx_element_counter +
+         ((uint32_t)i2c->register_bytes_remaining << 16) +
+         ((uint32_t)i2c->flags.all << 24);
+}
+
+uint32_t SERVICESTATS_seri2c_state(void* instance)
+{
+  return ((SERI2C_instance_t*)instance)->flags.task_state;
+}
+
+#endif // JLIB_CONFIG_SERVICESTATS
@@ -0,0 +1,120 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Free-running change monitor for the shift PISO module.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_SHIFTPISO_MONITOR
+
+static void SHIFTPISO_monitor_compare(SHIFTPISO_monitor_instance_t* instance)
+{
+  uint32_t* current = instance->buffers[instance->read_index];
+  uint32_t* previous = instance->buffers[instance->read_index ^ 1U];
+
+  instance->read_index ^= 1U;
+
+  if (!instance->flags.baseline_valid)
+  {
+    instance->flags.baseline_valid = 1;
+    return;
+  }
+
+  // The previous sample is no longer needed once compared, so the change mask
+  // is written over it. That buffer then receives the next sample.
+
+  uint32_t changes = 0;
+
+  for (uint16_t word_index = 0; word_index < instance->word_count; word_index++)
+  {
+    previous[word_index] ^= current[word_index];
+    changes |= previous[word_index];
+  }
+
+  if (changes != 0)
+  {
+    instance->change_callback(instance->callback_context,
+                              (const uint8_t*)current,
+                              (const uint8_t*)previous,
+                              instance->piso->serial_buffer_length);
+  }
+}
+
+void SHIFTPISO_monitor_initialize(SHIFTPISO_monitor_instance_t* instance,
+                                  SHIFTPISO_instance_t* piso,
+                                  UTIMER_instance_t* utimer,
+                                  uint32_t* buffer_a,
+                                  uint32_t* buffer_b,
+                                  uint32_t sample_period_us,
+                                  uint32_t callback_context,
+                                  SHIFTPISO_change_callback_t change_callback)
+{
+  UTILITIES_memclear(instance, sizeof(SHIFTPISO_monitor_instance_t));
+
+  instance->piso = piso;
+  instance->utimer = utimer;
+  instance->sample_period_us = sample_period_us;
+  instance->buffers[0] = buffer_a;
+  instance->buffers[1] = buffer_b;
+  instance->word_count = (uint16_t)((piso->serial_buffer_length + 3U) / 4U);
+  instance->callback_context = callback_context;
+  instance->change_callback = change_callback;
+  instance->flags.enabled = 1;
+
+  // Padding bytes past the serial buffer length are never read into, hence,
+  // they must start out equal in both buffers.
+
+  UTILITIES_memclear(buffer_a, (uint32_t)instance->word_count * sizeof(uint32_t));
+  UTILITIES_memclear(buffer_b, (uint32_t)instance->word_count * sizeof(uint32_t));
+
+  UTIMER_ticket_create(utimer, &instance->utimer_ticket, 0);
+}
+
+void SHIFTPISO_monitor_enable(SHIFTPISO_monitor_instance_t* instance, bool enable)
+{
+  instance->flags.enabled = enable;
+}
+
+bool SHIFTPISO_monitor_service(SHIFTPISO_monitor_instance_t* instance)
+{
+  if (instance->flags.read_in_progress)
+  {
+    SHIFTPISO_service(instance->piso);
+
+    if (SHIFTPISO_is_busy(instance->piso))
+    {
+      return false;
+    }
+
+    instance->flags.read_in_progress = 0;
+
+    // A failed read is discarded so that it is not reported as changes.
+
+    if (instance->piso->errors.all == 0)
+    {
+      instance->sample_counter++;
+      SHIFTPISO_monitor_compare(instance);
+    }
+
+    return true;
+  }
+
+  if (!instance->flags.enabled ||
+      !UTIMER_ticket_has_expired(instance->utimer, &instance->utimer_ticket))
+  {
+    return true;
+  }
+
+  if (!SHIFTPISO_begin_new_read(instance->piso, (uint8_t*)instance->buffers[instance->read_index]))
+  {
+    return true;
+  }
+
+  UTIMER_ticket_create(instance->utimer, &instance->utimer_ticket, instance->sample_period_us);
+  instance->flags.read_in_progress = 1;
+
+  return false;
+}
+
+#endif // JLIB_CONFIG_SHIFTPISO_MONITOR
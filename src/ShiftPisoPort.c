@@ -0,0 +1,92 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Port-level bit-bang shifter for the shift PISO module.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_SHIFTPISO_PORT
+
+// Samples the serial output into bit position BIT and shifts the next
+// register onto the serial output.
+
+#define SHIFTPISO_PORT_READ_BIT(BIT)                                           \
+  value |= (uint8_t)(((port_read() >> serial_pin) & 1U) << (BIT));           \
+  port_write(clock_high.set_mask, clock_high.clear_mask);                      \
+  port_write(clock_low.set_mask, clock_low.clear_mask)
+
+void SHIFTPISO_port_initialize(SHIFTPISO_port_t* port,
+                               uint32_t clock_mask,
+                               uint32_t latch_shift_mask,
+                               uint8_t serial_pin,
+                               bool latch_active_high,
+                               SHIFTPISO_hal_port_write_t port_write,
+                               SHIFTPISO_hal_port_read_t port_read)
+{
+  UTILITIES_memclear(port, sizeof(SHIFTPISO_port_t));
+
+  port->clock_high.set_mask = clock_mask;
+  port->clock_low.clear_mask = clock_mask;
+
+  // The clock is driven low along with every latch/shift change.
+
+  port->latch.set_mask = latch_active_high ? latch_shift_mask : 0;
+  port->latch.clear_mask = clock_mask | (latch_active_high ? 0 : latch_shift_mask);
+  port->shift.set_mask = latch_active_high ? 0 : latch_shift_mask;
+  port->shift.clear_mask = clock_mask | (latch_active_high ? latch_shift_mask : 0);
+
+  port->serial_pin = serial_pin;
+  port->port_write = port_write;
+  port->port_read = port_read;
+}
+
+void SHIFTPISO_port_read(SHIFTPISO_port_t* port,
+                         uint8_t* serial_buffer,
+                         uint16_t register_count)
+{
+  // Local copies keep the loop free of instance loads.
+
+  SHIFTPISO_hal_port_write_t port_write = port->port_write;
+  SHIFTPISO_hal_port_read_t port_read = port->port_read;
+  SHIFTPISO_port_masks_t clock_high = port->clock_high;
+  SHIFTPISO_port_masks_t clock_low = port->clock_low;
+  uint8_t serial_pin = port->serial_pin;
+  uint8_t value;
+
+  port_write(port->latch.set_mask, port->latch.clear_mask);
+  port_write(clock_high.set_mask, clock_high.clear_mask);
+  port_write(port->shift.set_mask, port->shift.clear_mask);
+
+  for (uint16_t byte_count = (uint16_t)(register_count >> 3); byte_count > 0; byte_count--)
+  {
+    value = 0;
+
+    SHIFTPISO_PORT_READ_BIT(0);
+    SHIFTPISO_PORT_READ_BIT(1);
+    SHIFTPISO_PORT_READ_BIT(2);
+    SHIFTPISO_PORT_READ_BIT(3);
+    SHIFTPISO_PORT_READ_BIT(4);
+    SHIFTPISO_PORT_READ_BIT(5);
+    SHIFTPISO_PORT_READ_BIT(6);
+    SHIFTPISO_PORT_READ_BIT(7);
+
+    *serial_buffer++ = value;
+  }
+
+  uint8_t remaining_bits = (uint8_t)(register_count & 7U);
+
+  if (remaining_bits != 0)
+  {
+    value = 0;
+
+    for (uint8_t bit = 0; bit < remaining_bits; bit++)
+    {
+      SHIFTPISO_PORT_READ_BIT(bit);
+    }
+
+    *serial_buffer = value;
+  }
+}
+
+#endif // JLIB_CONFIG_SHIFTPISO_PORT
@@ -0,0 +1,81 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Port-level bit-bang shifter for the shift SIPO module.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_SHIFTSIPO_PORT
+
+// Drives bit position BIT onto the serial line with the shift clock low, then
+// raises the shift clock.
+
+#define SHIFTSIPO_PORT_WRITE_BIT(BIT)                                          \
+  bit_write = &serial_bit[(value >> (BIT)) & 1U];                              \
+  port_write(bit_write->set_mask, bit_write->clear_mask);                      \
+  port_write(shift_clock_high.set_mask, shift_clock_high.clear_mask)
+
+void SHIFTSIPO_port_initialize(SHIFTSIPO_port_t* port,
+                               uint32_t shift_clock_mask,
+                               uint32_t register_clock_mask,
+                               uint32_t serial_mask,
+                               SHIFTSIPO_hal_port_write_t port_write)
+{
+  UTILITIES_memclear(port, sizeof(SHIFTSIPO_port_t));
+
+  port->serial_bit[0].clear_mask = shift_clock_mask | serial_mask;
+  port->serial_bit[1].set_mask = serial_mask;
+  port->serial_bit[1].clear_mask = shift_clock_mask;
+  port->shift_clock_high.set_mask = shift_clock_mask;
+  port->register_clock_high.set_mask = register_clock_mask;
+  port->register_clock_low.clear_mask = register_clock_mask | shift_clock_mask;
+  port->port_write = port_write;
+}
+
+void SHIFTSIPO_port_write(SHIFTSIPO_port_t* port,
+                          uint8_t* serial_buffer,
+                          uint16_t register_count)
+{
+  // Local copies keep the loop free of instance loads.
+
+  SHIFTSIPO_hal_port_write_t port_write = port->port_write;
+  SHIFTSIPO_port_masks_t shift_clock_high = port->shift_clock_high;
+  const SHIFTSIPO_port_masks_t* serial_bit = port->serial_bit;
+  const SHIFTSIPO_port_masks_t* bit_write;
+  uint8_t value;
+
+  for (uint16_t byte_count = (uint16_t)(register_count >> 3); byte_count > 0; byte_count--)
+  {
+    value = *serial_buffer++;
+
+    SHIFTSIPO_PORT_WRITE_BIT(0);
+    SHIFTSIPO_PORT_WRITE_BIT(1);
+    SHIFTSIPO_PORT_WRITE_BIT(2);
+    SHIFTSIPO_PORT_WRITE_BIT(3);
+    SHIFTSIPO_PORT_WRITE_BIT(4);
+    SHIFTSIPO_PORT_WRITE_BIT(5);
+    SHIFTSIPO_PORT_WRITE_BIT(6);
+    SHIFTSIPO_PORT_WRITE_BIT(7);
+  }
+
+  uint8_t remaining_bits = (uint8_t)(register_count & 7U);
+
+  if (remaining_bits != 0)
+  {
+    value = *serial_buffer;
+
+    for (uint8_t bit = 0; bit < remaining_bits; bit++)
+    {
+      SHIFTSIPO_PORT_WRITE_BIT(bit);
+    }
+  }
+
+  // Transfer the shift registers to the output registers. The shift clock is
+  // returned low along with the register clock.
+
+  port_write(port->register_clock_high.set_mask, port->register_clock_high.clear_mask);
+  port_write(port->register_clock_low.set_mask, port->register_clock_low.clear_mask);
+}
+
+#endif // JLIB_CONFIG_SHIFTSIPO_PORT
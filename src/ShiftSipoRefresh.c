@@ -0,0 +1,281 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Continuous DMA-driven refresh with binary code modulation for the shift
+ *  SIPO module.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_SHIFTSIPO_REFRESH
+
+// HAL hooks, unless bound at compile time. See JLIB_HAL_BINDINGS.
+
+#ifndef SHIFTSIPO_REFRESH_HAL_CONFIGURE_DMA
+#define SHIFTSIPO_REFRESH_HAL_CONFIGURE_DMA(instance, src_addr, src_length) \
+  (instance)->configure_dma((src_addr), (src_length))
+#endif
+
+#ifndef SHIFTSIPO_REFRESH_HAL_START_TIMER
+#define SHIFTSIPO_REFRESH_HAL_START_TIMER(instance, period_us) (instance)->start_timer(period_us)
+#endif
+
+#ifndef SHIFTSIPO_REFRESH_HAL_SET_REGISTER_CLOCK
+#define SHIFTSIPO_REFRESH_HAL_SET_REGISTER_CLOCK(instance, level) (instance)->set_register_clock(level)
+#endif
+
+#ifndef SHIFTSIPO_REFRESH_HAL_SELECT_ROW
+#define SHIFTSIPO_REFRESH_HAL_SELECT_ROW(instance, row) (instance)->select_row(row)
+#endif
+
+#ifndef SHIFTSIPO_REFRESH_HAL_SET_OUTPUT_ENABLE
+#define SHIFTSIPO_REFRESH_HAL_SET_OUTPUT_ENABLE(instance, enable) (instance)->set_output_enable(enable)
+#endif
+
+#ifndef SHIFTSIPO_REFRESH_HAL_IS_TX_COMPLETE
+#define SHIFTSIPO_REFRESH_HAL_IS_TX_COMPLETE(instance) (instance)->is_tx_complete()
+#endif
+
+static void SHIFTSIPO_refresh_dummy_select_row(uint16_t row)
+{
+  (void)row;
+}
+
+static void SHIFTSIPO_refresh_dummy_set_output_enable(bool enable)
+{
+  (void)enable;
+}
+
+static bool SHIFTSIPO_refresh_dummy_is_tx_complete(void)
+{
+  return true;
+}
+
+static bool SHIFTSIPO_refresh_load_slot(SHIFTSIPO_refresh_instance_t* instance, uint16_t slot)
+{
+  instance->loading_slot = slot;
+
+  return SHIFTSIPO_REFRESH_HAL_CONFIGURE_DMA(instance,
+                                             &instance->front_buffer[(uint32_t)slot * instance->row_length],
+                                             instance->row_length);
+}
+
+static void SHIFTSIPO_refresh_advance(SHIFTSIPO_refresh_instance_t* instance)
+{
+  instance->flags.dma_complete = 0;
+  instance->flags.timer_expired = 0;
+
+  if (instance->stop_requested)
+  {
+    instance->flags.running = 0;
+    BUSMUTEX_release_mutex(instance->bus_mutex, instance->bus_id);
+    return;
+  }
+
+  // Latch the slot which was just shifted in and display it for the weight
+  // of its bit plane. The DMA can complete while the SPI still shifts out the
+  // last byte, and the outputs are blanked while the latched data and the
+  // row select lines disagree.
+
+  uint16_t displayed_slot = instance->loading_slot;
+  uint8_t plane = (uint8_t)(displayed_slot % instance->bit_depth);
+
+  // The SPI normally shifts out its last bytes within a few polls. Should it
+  // not, the current slot stays displayed and the latch is retried from the
+  // timer ISR, with the DMA still flagged complete, instead of hanging here.
+
+  uint32_t polls = 0;
+
+  while (!SHIFTSIPO_REFRESH_HAL_IS_TX_COMPLETE(instance))
+  {
+    if (++polls >= SHIFTSIPO_REFRESH_TX_COMPLETE_POLLS_MAX)
+    {
+      instance->flags.dma_complete = 1;
+      SHIFTSIPO_REFRESH_HAL_START_TIMER(instance, instance->base_period_us);
+      return;
+    }
+  }
+
+  TRACE_INSTANT(TRACE_ID_SHIFTSIPO_REFRESH_LATCH, displayed_slot);
+
+  SHIFTSIPO_REFRESH_HAL_SET_OUTPUT_ENABLE(instance, false);
+  SHIFTSIPO_REFRESH_HAL_SET_REGISTER_CLOCK(instance, true);
+  SHIFTSIPO_REFRESH_HAL_SET_REGISTER_CLOCK(instance, false);
+  SHIFTSIPO_REFRESH_HAL_SELECT_ROW(instance, (uint16_t)(displayed_slot / instance->bit_depth));
+  SHIFTSIPO_REFRESH_HAL_SET_OUTPUT_ENABLE(instance, true);
+  SHIFTSIPO_REFRESH_HAL_START_TIMER(instance, (uint32_t)instance->base_period_us << plane);
+
+  uint16_t next_slot = (uint16_t)(displayed_slot + 1U);
+
+  if (next_slot >= instance->slot_count)
+  {
+    next_slot = 0;
+    instance->frame_counter++;
+
+    if (instance->swap_requested)
+    {
+      uint8_t* buffer = instance->front_buffer;
+
+      instance->front_buffer = instance->back_buffer;
+      instance->back_buffer = buffer;
+      instance->swap_requested = false;
+    }
+  }
+
+  if (!SHIFTSIPO_refresh_load_slot(instance, next_slot))
+  {
+    instance->flags.running = 0;
+    BUSMUTEX_release_mutex(instance->bus_mutex, instance->bus_id);
+  }
+}
+
+void SHIFTSIPO_refresh_initialize(SHIFTSIPO_refresh_instance_t* instance,
+                                  BUSMUTEX_instance_t* bus_mutex,
+                                  BUSMUTEX_bus_id_t bus_id,
+                                  uint8_t* frame_buffer_a,
+                                  uint8_t* frame_buffer_b,
+                                  uint16_t row_count,
+                                  uint16_t row_length,
+                                  uint8_t bit_depth,
+                                  uint16_t base_period_us,
+                                  SHIFTSIPO_hal_configure_dma_t configure_dma,
+                                  SHIFTSIPO_hal_start_timer_t start_timer,
+                                  SHIFTSIPO_hal_set_register_clock_t set_register_clock,
+                                  SHIFTSIPO_hal_select_row_t select_row,
+                                  SHIFTSIPO_hal_set_output_enable_t set_output_enable,
+                                  SHIFTSIPO_hal_is_tx_complete_t is_tx_complete)
+{
+  UTILITIES_memclear(instance, sizeof(SHIFTSIPO_refresh_instance_t));
+
+  UTILS_ASSERT((bit_depth >= 1U) && (bit_depth <= 8U));
+  UTILS_ASSERT((uint32_t)row_count * bit_depth <= UINT16_MAX);
+
+  instance->bus_mutex = bus_mutex;
+  instance->bus_id = bus_id;
+  instance->front_buffer = frame_buffer_a;
+  instance->back_buffer = frame_buffer_b;
+  instance->row_count = row_count;
+  instance->row_length = row_length;
+  instance->bit_depth = bit_depth;
+  instance->base_period_us = base_period_us;
+  instance->slot_count = (uint16_t)(row_count * bit_depth);
+  instance->configure_dma = configure_dma;
+  instance->start_timer = start_timer;
+  instance->set_register_clock = set_register_clock;
+  instance->select_row = (select_row != NULL) ? select_row : SHIFTSIPO_refresh_dummy_select_row;
+  instance->set_output_enable = (set_output_enable != NULL) ? set_output_enable : SHIFTSIPO_refresh_dummy_set_output_enable;
+  instance->is_tx_complete = (is_tx_complete != NULL) ? is_tx_complete : SHIFTSIPO_refresh_dummy_is_tx_complete;
+
+  uint32_t frame_length = (uint32_t)instance->slot_count * row_length;
+
+  UTILITIES_memclear(frame_buffer_a, frame_length);
+  UTILITIES_memclear(frame_buffer_b, frame_length);
+}
+
+bool SHIFTSIPO_refresh_start(SHIFTSIPO_refresh_instance_t* instance)
+{
+  if (instance->flags.running || (instance->slot_count == 0))
+  {
+    return false;
+  }
+
+  if (!BUSMUTEX_request_mutex(instance->bus_mutex, instance->bus_id))
+  {
+    return false;
+  }
+
+  // Nothing is displayed yet, so the first slot is latched as soon as it has
+  // been shifted in.
+
+  instance->frame_counter = 0;
+  instance->stop_requested = false;
+  instance->flags.dma_complete = 0;
+  instance->flags.timer_expired = 1;
+  instance->flags.running = 1;
+
+  if (!SHIFTSIPO_refresh_load_slot(instance, 0))
+  {
+    instance->flags.running = 0;
+    BUSMUTEX_release_mutex(instance->bus_mutex, instance->bus_id);
+    return false;
+  }
+
+  return true;
+}
+
+void SHIFTSIPO_refresh_stop(SHIFTSIPO_refresh_instance_t* instance)
+{
+  if (instance->flags.running)
+  {
+    instance->stop_requested = true;
+  }
+}
+
+void SHIFTSIPO_refresh_dma_transfer_complete_isr_handler(SHIFTSIPO_refresh_instance_t* instance)
+{
+  TRACE_INSTANT(TRACE_ID_SHIFTSIPO_REFRESH_DMA_ISR, instance->loading_slot);
+
+  instance->flags.dma_complete = 1;
+
+  if (instance->flags.timer_expired)
+  {
+    SHIFTSIPO_refresh_advance(instance);
+  }
+}
+
+void SHIFTSIPO_refresh_timer_isr_handler(SHIFTSIPO_refresh_instance_t* instance)
+{
+  TRACE_INSTANT(TRACE_ID_SHIFTSIPO_REFRESH_TIMER_ISR, instance->loading_slot);
+
+  instance->flags.timer_expired = 1;
+
+  if (instance->flags.dma_complete)
+  {
+    SHIFTSIPO_refresh_advance(instance);
+  }
+}
+
+void SHIFTSIPO_refresh_set_output(SHIFTSIPO_refresh_instance_t* instance,
+                                  uint16_t row,
+                                  uint16_t output,
+                                  uint8_t brightness)
+{
+  uint8_t* row_data = &instance->back_buffer[(uint32_t)row * instance->bit_depth * instance->row_length];
+  uint16_t byte_offset = (uint16_t)(output >> 3);
+  uint8_t bit_mask = (uint8_t)(1U << (output & 7U));
+
+  for (uint8_t plane = 0; plane < instance->bit_depth; plane++)
+  {
+    if ((brightness >> plane) & 1U)
+    {
+      row_data[byte_offset] |= bit_mask;
+    }
+    else
+    {
+      row_data[byte_offset] &= (uint8_t)~bit_mask;
+    }
+
+    row_data += instance->row_length;
+  }
+}
+
+void SHIFTSIPO_refresh_swap_buffers(SHIFTSIPO_refresh_instance_t* instance)
+{
+  if (!instance->flags.running)
+  {
+    uint8_t* buffer = instance->front_buffer;
+
+    instance->front_buffer = instance->back_buffer;
+    instance->back_buffer = buffer;
+    return;
+  }
+
+  instance->swap_requested = true;
+}
+
+bool SHIFTSIPO_refresh_is_swap_pending(SHIFTSIPO_refresh_instance_t* instance)
+{
+  return instance->swap_requested;
+}
+
+#endif // JLIB_CONFIG_SHIFTSIPO_REFRESH
@@ -0,0 +1,108 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Trace recorder with a lock-free ring buffer.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_TRACE
+
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4) && !defined(__ARM_ARCH_6M__)
+#define TRACE_LOCK_FREE                   1
+#else
+#define TRACE_LOCK_FREE                   0
+#endif
+
+static TRACE_instance_t* volatile TRACE_active_instance;
+
+static uint32_t TRACE_claim(TRACE_instance_t* instance)
+{
+#if TRACE_LOCK_FREE
+  return __atomic_fetch_add(&instance->write_index, 1U, __ATOMIC_RELAXED);
+#else
+  uint32_t index;
+
+  if (instance->enter_critical != NULL)
+  {
+    instance->enter_critical();
+  }
+
+  index = instance->write_index++;
+
+  if (instance->exit_critical != NULL)
+  {
+    instance->exit_critical();
+  }
+
+  return index;
+#endif
+}
+
+void TRACE_initialize(TRACE_instance_t* instance,
+                      TRACE_record_t* records,
+                      uint32_t record_count,
+                      uint32_t timestamp_frequency_hz,
+                      TRACE_hal_get_timestamp_t get_timestamp,
+                      TRACE_hal_enter_critical_t enter_critical,
+                      TRACE_hal_exit_critical_t exit_critical)
+{
+  UTILS_ASSERT((record_count != 0) && ((record_count & (record_count - 1U)) == 0));
+
+  UTILITIES_memclear(instance, sizeof(TRACE_instance_t));
+  UTILITIES_memclear(records, record_count * sizeof(TRACE_record_t));
+
+  instance->records = records;
+  instance->record_mask = record_count - 1U;
+  instance->timestamp_frequency_hz = timestamp_frequency_hz;
+  instance->get_timestamp = get_timestamp;
+  instance->enter_critical = enter_critical;
+  instance->exit_critical = exit_critical;
+}
+
+void TRACE_start(TRACE_instance_t* instance)
+{
+  TRACE_active_instance = instance;
+}
+
+void TRACE_stop(void)
+{
+  TRACE_active_instance = NULL;
+}
+
+void TRACE_record(uint8_t event, uint8_t id, uint16_t argument)
+{
+  TRACE_instance_t* instance = TRACE_active_instance;
+
+  if (instance == NULL)
+  {
+    return;
+  }
+
+  // An ISR may record between the claim and the timestamp, hence, records are
+  // not strictly in timestamp order. The converter sorts them.
+
+  TRACE_record_t* record = &instance->records[TRACE_claim(instance) & instance->record_mask];
+
+  record->timestamp = instance->get_timestamp();
+  record->event = event;
+  record->id = id;
+  record->argument = argument;
+}
+
+void TRACE_dump(TRACE_instance_t* instance, TRACE_hal_write_t write)
+{
+  TRACE_dump_header_t header;
+
+  header.magic = TRACE_DUMP_MAGIC;
+  header.version = TRACE_DUMP_VERSION;
+  header.record_length = sizeof(TRACE_record_t);
+  header.record_count = instance->record_mask + 1U;
+  header.write_index = instance->write_index;
+  header.timestamp_frequency_hz = instance->timestamp_frequency_hz;
+
+  write(&header, sizeof(header));
+  write(instance->records, header.record_count * sizeof(TRACE_record_t));
+}
+
+#endif // JLIB_CONFIG_TRACE
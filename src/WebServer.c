@@ -0,0 +1,984 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  Non-blocking HTTP/1.1 server for static WEB assets and small API handlers.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_WEBSERVER
+
+typedef struct
+{
+  char* buffer;
+  uint16_t capacity;
+  uint16_t length;
+  bool overflow;
+}
+WEBSERVER_writer_t;
+
+/*******************************************************************************
+ * String helpers
+ ******************************************************************************/
+
+static uint16_t WEBSERVER_string_length(const char* text)
+{
+  uint16_t length = 0;
+
+  while (text[length] != '\0')
+  {
+    length++;
+  }
+
+  return length;
+}
+
+static bool WEBSERVER_string_equals(const char* a, const char* b)
+{
+  while ((*a != '\0') && (*a == *b))
+  {
+    a++;
+    b++;
+  }
+
+  return (*a == *b);
+}
+
+static char WEBSERVER_to_lower(char value)
+{
+  return UTILITIES_is_ascii_alpha_upper(value) ? (char)(value + ('a' - 'A')) : value;
+}
+
+// Compares a header name against a lower case name, ignoring case.
+
+static bool WEBSERVER_name_equals(const char* name, uint16_t length, const char* lower_name)
+{
+  for (uint16_t i = 0; i < length; i++)
+  {
+    if (WEBSERVER_to_lower(name[i]) != lower_name[i])
+    {
+      return false;
+    }
+  }
+
+  return (lower_name[length] == '\0');
+}
+
+// Checks if a comma-separated header value lists a token, ignoring case and
+// parameters such as ";q=0.5".
+
+static bool WEBSERVER_list_contains(const char* list, const char* token)
+{
+  while (*list != '\0')
+  {
+    while ((*list == ' ') || (*list == ','))
+    {
+      list++;
+    }
+
+    const char* element = list;
+    uint16_t length = 0;
+
+    while ((*list != '\0') && (*list != ',') && (*list != ';') && (*list != ' '))
+    {
+      list++;
+      length++;
+    }
+
+    if ((length > 0) && WEBSERVER_name_equals(element, length, token))
+    {
+      return true;
+    }
+
+    while ((*list != '\0') && (*list != ','))
+    {
+      list++;
+    }
+  }
+
+  return false;
+}
+
+// Checks if an If-None-Match value matches an entity tag.
+
+static bool WEBSERVER_etag_matches(const char* if_none_match, const char* etag)
+{
+  uint16_t etag_length = WEBSERVER_string_length(etag);
+
+  for (const char* value = if_none_match; *value != '\0'; value++)
+  {
+    if (*value == '*')
+    {
+      return true;
+    }
+
+    if ((*value == '"') && (UTILITIES_strncmp((char*)value, (char*)etag, etag_length) == 0))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*******************************************************************************
+ * Response writing
+ ******************************************************************************/
+
+static void WEBSERVER_write_bytes(WEBSERVER_writer_t* writer, const char* data, uint16_t length)
+{
+  if ((uint32_t)writer->length + length > writer->capacity)
+  {
+    writer->overflow = true;
+    return;
+  }
+
+  UTILITIES_memcpy(&writer->buffer[writer->length], (void*)data, length);
+  writer->length = (uint16_t)(writer->length + length);
+}
+
+static void WEBSERVER_write_string(WEBSERVER_writer_t* writer, const char* text)
+{
+  WEBSERVER_write_bytes(writer, text, WEBSERVER_string_length(text));
+}
+
+static void WEBSERVER_write_integer(WEBSERVER_writer_t* writer, int32_t value)
+{
+  char digits[11];
+  uint8_t index = sizeof(digits);
+  uint32_t magnitude = (value < 0) ? (0U - (uint32_t)value) : (uint32_t)value;
+
+  do
+  {
+    digits[--index] = (char)('0' + (magnitude % 10U));
+    magnitude /= 10U;
+  }
+  while (magnitude != 0);
+
+  if (value < 0)
+  {
+    WEBSERVER_write_bytes(writer, "-", 1);
+  }
+
+  WEBSERVER_write_bytes(writer, &digits[index], (uint16_t)(sizeof(digits) - index));
+}
+
+static const char* WEBSERVER_reason_phrase(uint16_t status)
+{
+  switch (status)
+  {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 204: return "No Content";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 406: return "Not Acceptable";
+    case 413: return "Content Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    default:  return "";
+  }
+}
+
+/*
+ * Writes the status line and headers to the start of the response buffer. An
+ * asset is given for asset responses so that its metadata is sent.
+ */
+
+static uint16_t WEBSERVER_write_header(WEBSERVER_connection_t* connection,
+                                       uint16_t status,
+                                       const char* content_type,
+                                       const WEB_asset_t* asset,
+                                       uint32_t content_length)
+{
+  WEBSERVER_writer_t writer;
+
+  writer.buffer = (char*)connection->response;
+  writer.capacity = WEBSERVER_RESPONSE_HEADER_LENGTH_MAX;
+  writer.length = 0;
+  writer.overflow = false;
+
+  WEBSERVER_write_string(&writer, "HTTP/1.1 ");
+  WEBSERVER_write_integer(&writer, status);
+  WEBSERVER_write_string(&writer, " ");
+  WEBSERVER_write_string(&writer, WEBSERVER_reason_phrase(status));
+  WEBSERVER_write_string(&writer, "\r\n");
+
+  // Neither 204 nor 304 responses have a body.
+
+  if ((status != 204) && (status != 304))
+  {
+    if (content_type != NULL)
+    {
+      WEBSERVER_write_string(&writer, "Content-Type: ");
+      WEBSERVER_write_string(&writer, content_type);
+      WEBSERVER_write_string(&writer, "\r\n");
+    }
+
+    WEBSERVER_write_string(&writer, "Content-Length: ");
+    WEBSERVER_write_integer(&writer, (int32_t)content_length);
+    WEBSERVER_write_string(&writer, "\r\n");
+  }
+
+  if (asset != NULL)
+  {
+    if ((asset->content_encoding != NULL) && (status == 200))
+    {
+      WEBSERVER_write_string(&writer, "Content-Encoding: ");
+      WEBSERVER_write_string(&writer, asset->content_encoding);
+      WEBSERVER_write_string(&writer, "\r\n");
+    }
+
+    if (asset->etag != NULL)
+    {
+      WEBSERVER_write_string(&writer, "ETag: ");
+      WEBSERVER_write_string(&writer, asset->etag);
+      WEBSERVER_write_string(&writer, "\r\nCache-Control: no-cache\r\n");
+    }
+
+    if (asset->content_encoding != NULL)
+    {
+      WEBSERVER_write_string(&writer, "Vary: Accept-Encoding\r\n");
+    }
+  }
+
+  WEBSERVER_write_string(&writer, connection->flags.keep_alive ? "Connection: keep-alive\r\n\r\n" :
+                                                                 "Connection: close\r\n\r\n");
+
+  return writer.overflow ? 0 : writer.length;
+}
+
+/*
+ * Starts sending the response headers, followed by the body if one is given.
+ * A header length of 0 indicates that the headers did not fit.
+ */
+
+static void WEBSERVER_send_response(WEBSERVER_connection_t* connection,
+                                    uint16_t header_length,
+                                    const uint8_t* body,
+                                    uint32_t body_length)
+{
+  if (header_length == 0)
+  {
+    static const char OVERFLOW_RESPONSE[] = "HTTP/1.1 500 Internal Server Error\r\n"
+                                            "Content-Length: 0\r\n"
+                                            "Connection: close\r\n\r\n";
+
+    connection->flags.keep_alive = 0;
+    UTILITIES_memcpy(connection->response, (void*)OVERFLOW_RESPONSE, sizeof(OVERFLOW_RESPONSE) - 1U);
+    header_length = (uint16_t)(sizeof(OVERFLOW_RESPONSE) - 1U);
+    body_length = 0;
+  }
+
+  connection->send_data = connection->response;
+  connection->send_remaining = header_length;
+  connection->body_data = body;
+  connection->body_remaining = body_length;
+  connection->flags.state = WEBSERVER_CONNECTION_STATE_SENDING;
+  TRACE_STATE(TRACE_ID_WEBSERVER_CONNECTION, ((uint16_t)connection->socket << 8) | WEBSERVER_CONNECTION_STATE_SENDING);
+}
+
+static void WEBSERVER_respond_empty(WEBSERVER_connection_t* connection, uint16_t status)
+{
+  WEBSERVER_send_response(connection, WEBSERVER_write_header(connection, status, NULL, NULL, 0), NULL, 0);
+}
+
+// Answers requests which cannot be framed, hence, the connection is closed.
+
+static void WEBSERVER_respond_error(WEBSERVER_instance_t* instance,
+                                    WEBSERVER_connection_t* connection,
+                                    uint16_t status)
+{
+  instance->error_count++;
+  connection->flags.keep_alive = 0;
+  connection->request_length = connection->received_length;
+  WEBSERVER_respond_empty(connection, status);
+}
+
+/*******************************************************************************
+ * Request handling
+ ******************************************************************************/
+
+static void WEBSERVER_respond_asset(WEBSERVER_connection_t* connection,
+                                    const WEBSERVER_request_t* request,
+                                    const WEB_asset_t* asset)
+{
+  uint16_t status = 200;
+
+  if ((request->if_none_match != NULL) &&
+      (asset->etag != NULL) &&
+      WEBSERVER_etag_matches(request->if_none_match, asset->etag))
+  {
+    status = 304;
+  }
+  else if ((asset->content_encoding != NULL) &&
+           ((request->accept_encoding == NULL) ||
+            !WEBSERVER_list_contains(request->accept_encoding, asset->content_encoding)))
+  {
+    WEBSERVER_respond_empty(connection, 406);
+    return;
+  }
+
+  // The asset is sent straight from where it is stored, see
+  // WEBSERVER_transmit.
+
+  bool send_body = ((status == 200) && (request->method != WEBSERVER_METHOD_HEAD));
+
+  WEBSERVER_send_response(connection,
+                          WEBSERVER_write_header(connection, status, asset->content_type,
+                                                 asset, asset->length),
+                          asset->data,
+                          send_body ? asset->length : 0);
+}
+
+static void WEBSERVER_respond_handler(WEBSERVER_connection_t* connection,
+                                      const WEBSERVER_request_t* request,
+                                      const WEBSERVER_route_t* route)
+{
+  WEBSERVER_response_t response;
+
+  response.content_type = "application/json";
+  response.body = (char*)&connection->response[WEBSERVER_RESPONSE_HEADER_LENGTH_MAX];
+  response.body_capacity = WEBSERVER_RESPONSE_BUFFER_LENGTH - WEBSERVER_RESPONSE_HEADER_LENGTH_MAX;
+  response.body_length = 0;
+
+  uint16_t status = route->handler(route->context, request, &response);
+  bool send_body = ((status != 204) && (status != 304) && (request->method != WEBSERVER_METHOD_HEAD));
+  uint16_t header_length = WEBSERVER_write_header(connection, status, response.content_type,
+                                                  NULL, send_body || (request->method == WEBSERVER_METHOD_HEAD) ?
+                                                  response.body_length : 0);
+
+  // The body is moved down to follow the headers so that small responses
+  // are sent as a single segment. The headers never reach past the body.
+
+  if (send_body && (header_length != 0))
+  {
+    uint8_t* source = (uint8_t*)response.body;
+    uint8_t* destination = &connection->response[header_length];
+
+    for (uint16_t i = 0; i < response.body_length; i++)
+    {
+      destination[i] = source[i];
+    }
+
+    header_length = (uint16_t)(header_length + response.body_length);
+  }
+
+  WEBSERVER_send_response(connection, header_length, NULL, 0);
+}
+
+static void WEBSERVER_route(WEBSERVER_instance_t* instance,
+                            WEBSERVER_connection_t* connection,
+                            const WEBSERVER_request_t* request)
+{
+  instance->request_count++;
+
+  for (uint16_t route_index = 0; route_index < instance->route_count; route_index++)
+  {
+    const WEBSERVER_route_t* route = &instance->routes[route_index];
+    const char* path = ((route->path == NULL) && (route->asset != NULL)) ? route->asset->path : route->path;
+
+    if ((path == NULL) || !WEBSERVER_string_equals(path, request->path))
+    {
+      continue;
+    }
+
+    if ((route->methods & request->method) == 0)
+    {
+      WEBSERVER_respond_empty(connection, 405);
+    }
+    else if (route->upgrade != NULL)
+    {
+      uint16_t status = route->upgrade(route->context, connection->socket, request);
+
+      if (status != 101)
+      {
+        connection->flags.keep_alive = 0;
+        WEBSERVER_respond_empty(connection, status);
+        return;
+      }
+
+      // The socket now belongs to the upgrade handler.
+
+      TRACE_STATE(TRACE_ID_WEBSERVER_CONNECTION, ((uint16_t)connection->socket << 8) | WEBSERVER_CONNECTION_STATE_FREE);
+      connection->flags.all = 0;
+      connection->socket = -1;
+    }
+    else if (route->asset != NULL)
+    {
+      WEBSERVER_respond_asset(connection, request, route->asset);
+    }
+    else
+    {
+      WEBSERVER_respond_handler(connection, request, route);
+    }
+
+    return;
+  }
+
+  WEB_asset_t asset;
+
+  if ((instance->asset_resolver != NULL) &&
+      ((request->method & (WEBSERVER_METHOD_GET | WEBSERVER_METHOD_HEAD)) != 0) &&
+      instance->asset_resolver(instance->asset_resolver_context, request->path, &asset))
+  {
+    WEBSERVER_respond_asset(connection, request, &asset);
+    return;
+  }
+
+  WEBSERVER_respond_empty(connection, 404);
+}
+
+static uint8_t WEBSERVER_parse_method(const char* method, uint16_t length)
+{
+  static const struct
+  {
+    const char* name;
+    uint8_t method;
+  }
+  METHODS[] =
+  {
+    { "GET",    WEBSERVER_METHOD_GET    },
+    { "HEAD",   WEBSERVER_METHOD_HEAD   },
+    { "POST",   WEBSERVER_METHOD_POST   },
+    { "PUT",    WEBSERVER_METHOD_PUT    },
+    { "DELETE", WEBSERVER_METHOD_DELETE },
+  };
+
+  for (uint8_t i = 0; i < sizeof(METHODS) / sizeof(METHODS[0]); i++)
+  {
+    if ((WEBSERVER_string_length(METHODS[i].name) == length) &&
+        (UTILITIES_strncmp((char*)method, (char*)METHODS[i].name, length) == 0))
+    {
+      return METHODS[i].method;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Parses the request line and headers in place, NUL-terminating the strings
+ * of interest. Returns 0 on success, else, the status code to answer with.
+ */
+
+static uint16_t WEBSERVER_parse_header(WEBSERVER_connection_t* connection,
+                                       WEBSERVER_request_t* request,
+                                       uint32_t* content_length)
+{
+  char* cursor = (char*)connection->request_buffer;
+  char* end = cursor + connection->header_length - 2U;
+
+  UTILITIES_memclear(request, sizeof(WEBSERVER_request_t));
+  *content_length = 0;
+
+  // Request line, "METHOD target HTTP/1.x".
+
+  char* method = cursor;
+
+  while ((cursor < end) && (*cursor != ' '))
+  {
+    cursor++;
+  }
+
+  request->method = WEBSERVER_parse_method(method, (uint16_t)(cursor - method));
+
+  if ((request->method == 0) || (cursor >= end))
+  {
+    return 400;
+  }
+
+  request->path = ++cursor;
+
+  while ((cursor < end) && (*cursor != ' '))
+  {
+    if ((*cursor == '?') && (request->query == NULL))
+    {
+      *cursor = '\0';
+      request->query = cursor + 1;
+    }
+
+    cursor++;
+  }
+
+  if ((cursor + 10 > end) || (UTILITIES_strncmp(cursor + 1, (char*)"HTTP/1.", 7) != 0))
+  {
+    return 400;
+  }
+
+  *cursor = '\0';
+  request->keep_alive = (cursor[8] == '1');
+  cursor += 9;
+
+  if ((cursor[0] != '\r') || (cursor[1] != '\n'))
+  {
+    return 400;
+  }
+
+  cursor += 2;
+  request->headers = cursor;
+  request->headers_length = (uint16_t)(end - cursor);
+
+  // Header fields, "Name: value".
+
+  while (cursor < end)
+  {
+    char* name = cursor;
+
+    while ((cursor < end) && (*cursor != ':') && (*cursor != '\r'))
+    {
+      cursor++;
+    }
+
+    if ((cursor >= end) || (*cursor != ':'))
+    {
+      return 400;
+    }
+
+    uint16_t name_length = (uint16_t)(cursor - name);
+
+    cursor++;
+
+    // Optional white space around the value is not part of it.
+
+    while ((*cursor == ' ') || (*cursor == '\t'))
+    {
+      cursor++;
+    }
+
+    char* value = cursor;
+
+    while (*cursor != '\r')
+    {
+      cursor++;
+    }
+
+    char* value_end = cursor;
+
+    while ((value_end > value) && ((value_end[-1] == ' ') || (value_end[-1] == '\t')))
+    {
+      value_end--;
+    }
+
+    *value_end = '\0';
+    cursor += 2;
+
+    if (WEBSERVER_name_equals(name, name_length, "content-length"))
+    {
+      uint32_t length = 0;
+
+      for (char* digit = value; *digit != '\0'; digit++)
+      {
+        if (!UTILITIES_is_ascii_numeric(*digit) || (length > WEBSERVER_REQUEST_BUFFER_LENGTH))
+        {
+          return 400;
+        }
+
+        length = (length * 10U) + (uint32_t)(*digit - '0');
+      }
+
+      *content_length = length;
+    }
+    else if (WEBSERVER_name_equals(name, name_length, "connection"))
+    {
+      if (WEBSERVER_list_contains(value, "close"))
+      {
+        request->keep_alive = false;
+      }
+      else if (WEBSERVER_list_contains(value, "keep-alive"))
+      {
+        request->keep_alive = true;
+      }
+    }
+    else if (WEBSERVER_name_equals(name, name_length, "if-none-match"))
+    {
+      request->if_none_match = value;
+    }
+    else if (WEBSERVER_name_equals(name, name_length, "accept-encoding"))
+    {
+      request->accept_encoding = value;
+    }
+    else if (WEBSERVER_name_equals(name, name_length, "transfer-encoding"))
+    {
+      // Chunked request bodies are not supported.
+
+      return 400;
+    }
+  }
+
+  return 0;
+}
+
+// Returns true once the end of the headers has been found.
+
+static bool WEBSERVER_find_header_end(WEBSERVER_connection_t* connection)
+{
+  uint8_t* request = connection->request_buffer;
+  uint16_t index = connection->scan_offset;
+
+  while ((uint32_t)index + 3U < connection->received_length)
+  {
+    if ((request[index] == '\r') && (request[index + 1] == '\n') &&
+        (request[index + 2] == '\r') && (request[index + 3] == '\n'))
+    {
+      connection->header_length = (uint16_t)(index + 4U);
+      return true;
+    }
+
+    index++;
+  }
+
+  connection->scan_offset = index;
+
+  return false;
+}
+
+static void WEBSERVER_close(WEBSERVER_instance_t* instance, WEBSERVER_connection_t* connection)
+{
+  instance->close(connection->socket);
+  TRACE_STATE(TRACE_ID_WEBSERVER_CONNECTION, ((uint16_t)connection->socket << 8) | WEBSERVER_CONNECTION_STATE_FREE);
+  connection->flags.all = 0;
+  connection->socket = -1;
+}
+
+static void WEBSERVER_receive(WEBSERVER_instance_t* instance, WEBSERVER_connection_t* connection)
+{
+  if (connection->received_length < WEBSERVER_REQUEST_BUFFER_LENGTH)
+  {
+    int32_t received = instance->recv(connection->socket,
+                                      &connection->request_buffer[connection->received_length],
+                                      WEBSERVER_REQUEST_BUFFER_LENGTH - connection->received_length);
+
+    if (received < 0)
+    {
+      // A peer closing an idle persistent connection is not an error.
+
+      if (connection->received_length != 0)
+      {
+        instance->error_count++;
+      }
+
+      WEBSERVER_close(instance, connection);
+      return;
+    }
+
+    if (received > 0)
+    {
+      connection->received_length = (uint16_t)(connection->received_length + received);
+      UTIMER_ticket_create(instance->utimer, &connection->idle_ticket, instance->idle_timeout_us);
+    }
+  }
+
+  if ((connection->header_length == 0) && !WEBSERVER_find_header_end(connection))
+  {
+    if (connection->received_length >= WEBSERVER_REQUEST_BUFFER_LENGTH)
+    {
+      WEBSERVER_respond_error(instance, connection, 431);
+    }
+    else if (UTIMER_ticket_has_expired(instance->utimer, &connection->idle_ticket))
+    {
+      if (connection->received_length != 0)
+      {
+        instance->error_count++;
+      }
+
+      WEBSERVER_close(instance, connection);
+    }
+
+    return;
+  }
+
+  WEBSERVER_request_t* request = &connection->request;
+
+  if (connection->request_length == 0)
+  {
+    uint32_t content_length;
+    uint16_t status = WEBSERVER_parse_header(connection, request, &content_length);
+
+    if (status != 0)
+    {
+      WEBSERVER_respond_error(instance, connection, status);
+      return;
+    }
+
+    if ((uint32_t)connection->header_length + content_length > WEBSERVER_REQUEST_BUFFER_LENGTH)
+    {
+      WEBSERVER_respond_error(instance, connection, 413);
+      return;
+    }
+
+    connection->request_length = (uint16_t)(connection->header_length + content_length);
+
+    if (content_length != 0)
+    {
+      request->body = &connection->request_buffer[connection->header_length];
+      request->body_length = (uint16_t)content_length;
+    }
+  }
+
+  if (connection->received_length < connection->request_length)
+  {
+    if (UTIMER_ticket_has_expired(instance->utimer, &connection->idle_ticket))
+    {
+      instance->error_count++;
+      WEBSERVER_close(instance, connection);
+    }
+
+    return;
+  }
+
+  connection->flags.keep_alive = request->keep_alive;
+
+  WEBSERVER_route(instance, connection, request);
+}
+
+static void WEBSERVER_transmit(WEBSERVER_instance_t* instance, WEBSERVER_connection_t* connection)
+{
+  for (uint8_t chunk = 0; chunk < WEBSERVER_SEND_CHUNKS_PER_SERVICE; chunk++)
+  {
+    if (connection->send_remaining == 0)
+    {
+      if (connection->body_remaining == 0)
+      {
+        break;
+      }
+
+      connection->send_data = connection->body_data;
+      connection->send_remaining = connection->body_remaining;
+      connection->body_remaining = 0;
+    }
+
+    int32_t sent = instance->send(connection->socket,
+                                  connection->send_data,
+                                  UTILS_MIN(connection->send_remaining, WEBSERVER_SEND_CHUNK_LENGTH));
+
+    if (sent < 0)
+    {
+      instance->error_count++;
+      WEBSERVER_close(instance, connection);
+      return;
+    }
+
+    if (sent == 0)
+    {
+      if (UTIMER_ticket_has_expired(instance->utimer, &connection->idle_ticket))
+      {
+        instance->error_count++;
+        WEBSERVER_close(instance, connection);
+      }
+
+      return;
+    }
+
+    connection->send_data += sent;
+    connection->send_remaining -= (uint32_t)sent;
+    UTIMER_ticket_create(instance->utimer, &connection->idle_ticket, instance->idle_timeout_us);
+  }
+
+  if ((connection->send_remaining != 0) || (connection->body_remaining != 0))
+  {
+    return;
+  }
+
+  if (!connection->flags.keep_alive)
+  {
+    WEBSERVER_close(instance, connection);
+    return;
+  }
+
+  // Move any pipelined request data to the start of the buffer.
+
+  uint16_t pipelined_length = (uint16_t)(connection->received_length - connection->request_length);
+
+  for (uint16_t i = 0; i < pipelined_length; i++)
+  {
+    connection->request_buffer[i] = connection->request_buffer[connection->request_length + i];
+  }
+
+  connection->received_length = pipelined_length;
+  connection->header_length = 0;
+  connection->request_length = 0;
+  connection->scan_offset = 0;
+  connection->flags.state = WEBSERVER_CONNECTION_STATE_RECEIVING;
+  TRACE_STATE(TRACE_ID_WEBSERVER_CONNECTION, ((uint16_t)connection->socket << 8) | WEBSERVER_CONNECTION_STATE_RECEIVING);
+}
+
+void WEBSERVER_initialize(WEBSERVER_instance_t* instance,
+                          UTIMER_instance_t* utimer,
+                          WEBSERVER_connection_t* connections,
+                          uint8_t connection_count,
+                          const WEBSERVER_route_t* routes,
+                          uint16_t route_count,
+                          uint32_t idle_timeout_us,
+                          WEBSERVER_hal_accept_t accept,
+                          WEBSERVER_hal_recv_t recv,
+                          WEBSERVER_hal_send_t send,
+                          WEBSERVER_hal_close_t close)
+{
+  UTILITIES_memclear(instance, sizeof(WEBSERVER_instance_t));
+
+  instance->utimer = utimer;
+  instance->connections = connections;
+  instance->connection_count = connection_count;
+  instance->routes = routes;
+  instance->route_count = route_count;
+  instance->idle_timeout_us = idle_timeout_us;
+  instance->accept = accept;
+  instance->recv = recv;
+  instance->send = send;
+  instance->close = close;
+
+  for (uint8_t i = 0; i < connection_count; i++)
+  {
+    connections[i].flags.all = 0;
+    connections[i].socket = -1;
+  }
+}
+
+void WEBSERVER_set_asset_resolver(WEBSERVER_instance_t* instance,
+                                  WEBSERVER_asset_resolver_t asset_resolver,
+                                  const void* asset_resolver_context)
+{
+  instance->asset_resolver = asset_resolver;
+  instance->asset_resolver_context = asset_resolver_context;
+}
+
+bool WEBSERVER_service(WEBSERVER_instance_t* instance)
+{
+  bool idle = true;
+
+  for (uint8_t i = 0; i < instance->connection_count; i++)
+  {
+    WEBSERVER_connection_t* connection = &instance->connections[i];
+
+    if (connection->flags.state == WEBSERVER_CONNECTION_STATE_FREE)
+    {
+      int32_t socket = instance->accept();
+
+      if (socket < 0)
+      {
+        continue;
+      }
+
+      UTILITIES_memclear(connection, offsetof(WEBSERVER_connection_t, request_buffer));
+      connection->socket = socket;
+      connection->flags.state = WEBSERVER_CONNECTION_STATE_RECEIVING;
+      TRACE_STATE(TRACE_ID_WEBSERVER_CONNECTION, ((uint16_t)connection->socket << 8) | WEBSERVER_CONNECTION_STATE_RECEIVING);
+      UTIMER_ticket_create(instance->utimer, &connection->idle_ticket, instance->idle_timeout_us);
+    }
+
+    if (connection->flags.state == WEBSERVER_CONNECTION_STATE_RECEIVING)
+    {
+      WEBSERVER_receive(instance, connection);
+    }
+
+    if (connection->flags.state == WEBSERVER_CONNECTION_STATE_SENDING)
+    {
+      WEBSERVER_transmit(instance, connection);
+    }
+
+    if ((connection->flags.state == WEBSERVER_CONNECTION_STATE_SENDING) ||
+        ((connection->flags.state == WEBSERVER_CONNECTION_STATE_RECEIVING) &&
+         (connection->received_length != 0)))
+    {
+      idle = false;
+    }
+  }
+
+  return idle;
+}
+
+bool WEBSERVER_response_append(WEBSERVER_response_t* response, const char* text)
+{
+  uint16_t length = WEBSERVER_string_length(text);
+
+  if ((uint32_t)response->body_length + length > response->body_capacity)
+  {
+    return false;
+  }
+
+  UTILITIES_memcpy(&response->body[response->body_length], (void*)text, length);
+  response->body_length = (uint16_t)(response->body_length + length);
+
+  return true;
+}
+
+char* WEBSERVER_request_header(const WEBSERVER_request_t* request, const char* lower_name)
+{
+  // Fields have been split in place into "Name: value" lines, each value
+  // terminated by a '\0' written over its trailing white space or CR. Every
+  // scan is bounded by the end of the headers, and the next field starts
+  // after the '\n' which follows the terminator.
+
+  char* cursor = request->headers;
+  char* end = cursor + request->headers_length;
+
+  while (cursor < end)
+  {
+    char* name = cursor;
+
+    while ((cursor < end) && (*cursor != ':'))
+    {
+      cursor++;
+    }
+
+    if (cursor >= end)
+    {
+      return NULL;
+    }
+
+    bool match = WEBSERVER_name_equals(name, (uint16_t)(cursor - name), lower_name);
+
+    cursor++;
+
+    while ((cursor < end) && ((*cursor == ' ') || (*cursor == '\t')))
+    {
+      cursor++;
+    }
+
+    if (match)
+    {
+      return cursor;
+    }
+
+    while ((cursor < end) && (*cursor != '\0'))
+    {
+      cursor++;
+    }
+
+    while ((cursor < end) && (*cursor != '\n'))
+    {
+      cursor++;
+    }
+
+    cursor++;
+  }
+
+  return NULL;
+}
+
+bool WEBSERVER_response_append_integer(WEBSERVER_response_t* response, int32_t value)
+{
+  WEBSERVER_writer_t writer;
+
+  writer.buffer = response->body;
+  writer.capacity = response->body_capacity;
+  writer.length = response->body_length;
+  writer.overflow = false;
+
+  WEBSERVER_write_integer(&writer, value);
+
+  if (writer.overflow)
+  {
+    return false;
+  }
+
+  response->body_length = writer.length;
+
+  return true;
+}
+
+#endif // JLIB_CONFIG_WEBSERVER
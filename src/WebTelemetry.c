@@ -0,0 +1,749 @@
+#include "JLib.h"
+
+/*******************************************************************************
+ *
+ *  WebSocket live telemetry channel for the WEB user interface.
+ *
+ ******************************************************************************/
+
+#if JLIB_CONFIG_WEBTELEMETRY
+
+#define WEBTELEMETRY_OPCODE_TEXT          0x1U
+#define WEBTELEMETRY_OPCODE_BINARY        0x2U
+#define WEBTELEMETRY_OPCODE_CLOSE         0x8U
+#define WEBTELEMETRY_OPCODE_PING          0x9U
+#define WEBTELEMETRY_OPCODE_PONG          0xAU
+
+#define WEBTELEMETRY_CLOSE_NORMAL         1000U
+#define WEBTELEMETRY_CLOSE_PROTOCOL_ERROR 1002U
+#define WEBTELEMETRY_CLOSE_TOO_BIG        1009U
+
+#define WEBTELEMETRY_UPDATE_HEADER_LENGTH 8U
+#define WEBTELEMETRY_WRITE_LENGTH         8U
+
+static const char WEBTELEMETRY_HANDSHAKE_GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+/*******************************************************************************
+ * Handshake
+ ******************************************************************************/
+
+static uint32_t WEBTELEMETRY_rotate_left(uint32_t value, uint8_t count)
+{
+  return (value << count) | (value >> (32U - count));
+}
+
+static void WEBTELEMETRY_sha1_block(uint32_t* state, const uint8_t* block)
+{
+  uint32_t w[80];
+
+  for (uint8_t i = 0; i < 16; i++)
+  {
+    w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) |
+           ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+  }
+
+  for (uint8_t i = 16; i < 80; i++)
+  {
+    w[i] = WEBTELEMETRY_rotate_left(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+  }
+
+  uint32_t a = state[0];
+  uint32_t b = state[1];
+  uint32_t c = state[2];
+  uint32_t d = state[3];
+  uint32_t e = state[4];
+
+  for (uint8_t i = 0; i < 80; i++)
+  {
+    uint32_t f;
+    uint32_t k;
+
+    if (i < 20)
+    {
+      f = (b & c) | (~b & d);
+      k = 0x5A827999U;
+    }
+    else if (i < 40)
+    {
+      f = b ^ c ^ d;
+      k = 0x6ED9EBA1U;
+    }
+    else if (i < 60)
+    {
+      f = (b & c) | (b & d) | (c & d);
+      k = 0x8F1BBCDCU;
+    }
+    else
+    {
+      f = b ^ c ^ d;
+      k = 0xCA62C1D6U;
+    }
+
+    uint32_t temp = WEBTELEMETRY_rotate_left(a, 5) + f + e + k + w[i];
+
+    e = d;
+    d = c;
+    c = WEBTELEMETRY_rotate_left(b, 30);
+    b = a;
+    a = temp;
+  }
+
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+}
+
+// SHA-1 of a message of up to 119 bytes, which covers the handshake key.
+
+static void WEBTELEMETRY_sha1(const uint8_t* message, uint8_t length, uint8_t* digest)
+{
+  uint32_t state[5] = { 0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U, 0xC3D2E1F0U };
+  uint8_t blocks[128];
+  uint8_t block_count = (uint8_t)((length + 8U) / 64U + 1U);
+  uint32_t bit_length = (uint32_t)length * 8U;
+
+  UTILITIES_memclear(blocks, sizeof(blocks));
+  UTILITIES_memcpy(blocks, (void*)message, length);
+  blocks[length] = 0x80;
+
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    blocks[block_count * 64U - 1U - i] = (uint8_t)(bit_length >> (i * 8U));
+  }
+
+  for (uint8_t i = 0; i < block_count; i++)
+  {
+    WEBTELEMETRY_sha1_block(state, &blocks[i * 64U]);
+  }
+
+  for (uint8_t i = 0; i < 20; i++)
+  {
+    digest[i] = (uint8_t)(state[i / 4U] >> (24U - (i % 4U) * 8U));
+  }
+}
+
+static uint8_t WEBTELEMETRY_base64(const uint8_t* data, uint8_t length, char* output)
+{
+  static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  uint8_t output_length = 0;
+
+  for (uint8_t i = 0; i < length; i += 3)
+  {
+    uint32_t group = (uint32_t)data[i] << 16;
+
+    if (i + 1U < length)
+    {
+      group |= (uint32_t)data[i + 1] << 8;
+    }
+
+    if (i + 2U < length)
+    {
+      group |= data[i + 2];
+    }
+
+    output[output_length++] = ALPHABET[(group >> 18) & 0x3FU];
+    output[output_length++] = ALPHABET[(group >> 12) & 0x3FU];
+    output[output_length++] = (i + 1U < length) ? ALPHABET[(group >> 6) & 0x3FU] : '=';
+    output[output_length++] = (i + 2U < length) ? ALPHABET[group & 0x3FU] : '=';
+  }
+
+  return output_length;
+}
+
+static bool WEBTELEMETRY_header_is(const char* value, const char* lower_token)
+{
+  // Matches a token within a comma-separated header value, ignoring case.
+
+  while ((value != NULL) && (*value != '\0'))
+  {
+    while ((*value == ' ') || (*value == ','))
+    {
+      value++;
+    }
+
+    const char* token = lower_token;
+
+    while ((*token != '\0') &&
+           ((*value == *token) ||
+            (UTILITIES_is_ascii_alpha_upper(*value) && ((char)(*value + ('a' - 'A')) == *token))))
+    {
+      value++;
+      token++;
+    }
+
+    if ((*token == '\0') && ((*value == '\0') || (*value == ',') || (*value == ' ')))
+    {
+      return true;
+    }
+
+    while ((*value != '\0') && (*value != ','))
+    {
+      value++;
+    }
+  }
+
+  return false;
+}
+
+/*******************************************************************************
+ * Framing
+ ******************************************************************************/
+
+/*
+ * Appends a frame header to the transmit buffer. Returns where the payload is
+ * to be written, else, NULL if the frame does not fit.
+ */
+
+static uint8_t* WEBTELEMETRY_queue_frame_header(WEBTELEMETRY_instance_t* instance,
+                                                uint8_t opcode,
+                                                uint16_t payload_length)
+{
+  uint8_t header_length = (payload_length < 126U) ? 2U : 4U;
+
+  if ((uint32_t)instance->tx_length + header_length + payload_length > WEBTELEMETRY_TX_BUFFER_LENGTH)
+  {
+    return NULL;
+  }
+
+  uint8_t* frame = &instance->tx_buffer[instance->tx_length];
+
+  frame[0] = (uint8_t)(0x80U | opcode);
+
+  if (header_length == 2U)
+  {
+    frame[1] = (uint8_t)payload_length;
+  }
+  else
+  {
+    frame[1] = 126U;
+    frame[2] = (uint8_t)(payload_length >> 8);
+    frame[3] = (uint8_t)payload_length;
+  }
+
+  instance->tx_length = (uint16_t)(instance->tx_length + header_length + payload_length);
+
+  return &frame[header_length];
+}
+
+static bool WEBTELEMETRY_queue_frame(WEBTELEMETRY_instance_t* instance,
+                                     uint8_t opcode,
+                                     const uint8_t* payload,
+                                     uint16_t payload_length)
+{
+  uint8_t* destination = WEBTELEMETRY_queue_frame_header(instance, opcode, payload_length);
+
+  if (destination == NULL)
+  {
+    return false;
+  }
+
+  UTILITIES_memcpy(destination, (void*)payload, payload_length);
+
+  return true;
+}
+
+static void WEBTELEMETRY_queue_close(WEBTELEMETRY_instance_t* instance, uint16_t code)
+{
+  uint8_t payload[2] = { (uint8_t)(code >> 8), (uint8_t)code };
+
+  WEBTELEMETRY_queue_frame(instance, WEBTELEMETRY_OPCODE_CLOSE, payload, sizeof(payload));
+  instance->flags.closing = 1;
+}
+
+static void WEBTELEMETRY_put_u32(uint8_t* buffer, uint32_t value)
+{
+  buffer[0] = (uint8_t)value;
+  buffer[1] = (uint8_t)(value >> 8);
+  buffer[2] = (uint8_t)(value >> 16);
+  buffer[3] = (uint8_t)(value >> 24);
+}
+
+static uint8_t WEBTELEMETRY_description_length(TERVAR_entry_t* entry)
+{
+  if (entry->description == NULL)
+  {
+    return 0;
+  }
+
+  return (uint8_t)UTILITIES_strnlen(entry->description, TERVAR_DESCRIPTION_LENGTH_MAX);
+}
+
+static bool WEBTELEMETRY_queue_describe(WEBTELEMETRY_instance_t* instance)
+{
+  uint16_t length = 2;
+
+  for (uint8_t i = 0; i < instance->entry_count; i++)
+  {
+    length = (uint16_t)(length + 2U + WEBTELEMETRY_description_length(&instance->entries[i]));
+  }
+
+  uint8_t* payload = WEBTELEMETRY_queue_frame_header(instance, WEBTELEMETRY_OPCODE_BINARY, length);
+
+  if (payload == NULL)
+  {
+    return false;
+  }
+
+  *payload++ = WEBTELEMETRY_MESSAGE_DESCRIBE;
+  *payload++ = instance->entry_count;
+
+  for (uint8_t i = 0; i < instance->entry_count; i++)
+  {
+    TERVAR_entry_t* entry = &instance->entries[i];
+    uint8_t description_length = WEBTELEMETRY_description_length(entry);
+
+    *payload++ = entry->flags.all;
+    *payload++ = description_length;
+
+    UTILITIES_memcpy(payload, entry->description, description_length);
+    payload += description_length;
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/*
+ * Calls the read handlers as TERVAR would, picking up at the first one which
+ * has not yet completed. Returns true once all have completed.
+ */
+
+static bool WEBTELEMETRY_read_entries(WEBTELEMETRY_instance_t* instance)
+{
+  while (instance->read_index < instance->entry_count)
+  {
+    TERVAR_entry_t* entry = &instance->entries[instance->read_index];
+
+    if ((entry->read_handler != NULL) && !entry->read_handler(entry))
+    {
+      return false;
+    }
+
+    instance->read_index++;
+  }
+
+  return true;
+}
+
+static uint32_t WEBTELEMETRY_read_entry(TERVAR_entry_t* entry)
+{
+  switch (entry->flags.type)
+  {
+    case TERVAR_VAR_TYPE_UINT8:  return *(uint8_t*)entry->variable;
+    case TERVAR_VAR_TYPE_INT8:   return (uint32_t)(int32_t)*(int8_t*)entry->variable;
+    case TERVAR_VAR_TYPE_UINT16: return *(uint16_t*)entry->variable;
+    case TERVAR_VAR_TYPE_INT16:  return (uint32_t)(int32_t)*(int16_t*)entry->variable;
+    case TERVAR_VAR_TYPE_UINT32: return *(uint32_t*)entry->variable;
+    case TERVAR_VAR_TYPE_INT32:  return (uint32_t)*(int32_t*)entry->variable;
+
+    case TERVAR_VAR_TYPE_FLOAT:
+    {
+      uint32_t bits;
+
+      UTILITIES_memcpy(&bits, entry->variable, sizeof(bits));
+      return bits;
+    }
+
+    default: return 0;
+  }
+}
+
+static void WEBTELEMETRY_store_entry(TERVAR_entry_t* entry, uint32_t value)
+{
+  switch (entry->flags.type)
+  {
+    case TERVAR_VAR_TYPE_UINT8:
+    case TERVAR_VAR_TYPE_INT8:
+      *(uint8_t*)entry->variable = (uint8_t)value;
+      break;
+
+    case TERVAR_VAR_TYPE_UINT16:
+    case TERVAR_VAR_TYPE_INT16:
+      *(uint16_t*)entry->variable = (uint16_t)value;
+      break;
+
+    case TERVAR_VAR_TYPE_UINT32:
+    case TERVAR_VAR_TYPE_INT32:
+    case TERVAR_VAR_TYPE_FLOAT:
+      UTILITIES_memcpy(entry->variable, &value, sizeof(value));
+      break;
+
+    default:
+      break;
+  }
+}
+
+static void WEBTELEMETRY_queue_update(WEBTELEMETRY_instance_t* instance)
+{
+  // Values are sampled straight into the transmit buffer.
+
+  uint16_t payload_length = (uint16_t)(WEBTELEMETRY_UPDATE_HEADER_LENGTH + instance->entry_count * 4U);
+  uint8_t* payload = WEBTELEMETRY_queue_frame_header(instance, WEBTELEMETRY_OPCODE_BINARY, payload_length);
+
+  if (payload == NULL)
+  {
+    instance->skipped_count++;
+    return;
+  }
+
+  payload[0] = WEBTELEMETRY_MESSAGE_UPDATE;
+  payload[1] = instance->entry_count;
+  payload[2] = (uint8_t)instance->sequence;
+  payload[3] = (uint8_t)(instance->sequence >> 8);
+  WEBTELEMETRY_put_u32(&payload[4], (uint32_t)UTIMER_ticket_elapsed_time(instance->utimer,
+                                                                         &instance->epoch_ticket));
+
+  for (uint8_t i = 0; i < instance->entry_count; i++)
+  {
+    WEBTELEMETRY_put_u32(&payload[WEBTELEMETRY_UPDATE_HEADER_LENGTH + i * 4U],
+                         WEBTELEMETRY_read_entry(&instance->entries[i]));
+  }
+
+  instance->sequence++;
+  instance->update_count++;
+}
+
+static void WEBTELEMETRY_apply_write(WEBTELEMETRY_instance_t* instance, const uint8_t* payload)
+{
+  uint8_t index = payload[1];
+
+  if ((index >= instance->entry_count) || instance->entries[index].flags.read_only)
+  {
+    return;
+  }
+
+  uint32_t value = (uint32_t)payload[4] | ((uint32_t)payload[5] << 8) |
+                   ((uint32_t)payload[6] << 16) | ((uint32_t)payload[7] << 24);
+
+  WEBTELEMETRY_store_entry(&instance->entries[index], value);
+
+  instance->write_index = index;
+  instance->flags.write_pending = 1;
+}
+
+/*******************************************************************************
+ * Receiving
+ ******************************************************************************/
+
+/*
+ * Processes one complete frame at the start of the receive buffer. Returns
+ * the frame length, 0 if the frame is not yet complete or the connection is
+ * closing.
+ */
+
+static uint16_t WEBTELEMETRY_process_frame(WEBTELEMETRY_instance_t* instance)
+{
+  uint8_t* frame = instance->rx_buffer;
+
+  if (instance->rx_length < 2U)
+  {
+    return 0;
+  }
+
+  uint8_t opcode = frame[0] & 0x0FU;
+  uint16_t payload_length = frame[1] & 0x7FU;
+  uint8_t header_length = 6;
+
+  // Client frames must be masked.
+
+  if ((frame[1] & 0x80U) == 0)
+  {
+    WEBTELEMETRY_queue_close(instance, WEBTELEMETRY_CLOSE_PROTOCOL_ERROR);
+    return 0;
+  }
+
+  if (payload_length == 126U)
+  {
+    if (instance->rx_length < 4U)
+    {
+      return 0;
+    }
+
+    payload_length = (uint16_t)(((uint16_t)frame[2] << 8) | frame[3]);
+    header_length = 8;
+  }
+
+  if ((payload_length == 127U) ||
+      ((uint32_t)header_length + payload_length > WEBTELEMETRY_RX_BUFFER_LENGTH))
+  {
+    WEBTELEMETRY_queue_close(instance, WEBTELEMETRY_CLOSE_TOO_BIG);
+    return 0;
+  }
+
+  if (instance->rx_length < header_length + payload_length)
+  {
+    return 0;
+  }
+
+  uint8_t* mask = &frame[header_length - 4U];
+  uint8_t* payload = &frame[header_length];
+
+  for (uint16_t i = 0; i < payload_length; i++)
+  {
+    payload[i] ^= mask[i & 3U];
+  }
+
+  switch (opcode)
+  {
+    case WEBTELEMETRY_OPCODE_BINARY:
+      if ((payload_length >= WEBTELEMETRY_WRITE_LENGTH) && (payload[0] == WEBTELEMETRY_MESSAGE_WRITE))
+      {
+        WEBTELEMETRY_apply_write(instance, payload);
+      }
+      break;
+
+    case WEBTELEMETRY_OPCODE_CLOSE:
+      WEBTELEMETRY_queue_close(instance, WEBTELEMETRY_CLOSE_NORMAL);
+      return 0;
+
+    case WEBTELEMETRY_OPCODE_PING:
+      WEBTELEMETRY_queue_frame(instance, WEBTELEMETRY_OPCODE_PONG, payload, payload_length);
+      break;
+
+    default:
+      // Text, pong, and continuation frames are ignored.
+      break;
+  }
+
+  return (uint16_t)(header_length + payload_length);
+}
+
+static void WEBTELEMETRY_close(WEBTELEMETRY_instance_t* instance)
+{
+  instance->close(instance->socket);
+  instance->socket = -1;
+  instance->flags.all = 0;
+}
+
+static void WEBTELEMETRY_receive(WEBTELEMETRY_instance_t* instance)
+{
+  int32_t received = instance->recv(instance->socket,
+                                    &instance->rx_buffer[instance->rx_length],
+                                    WEBTELEMETRY_RX_BUFFER_LENGTH - instance->rx_length);
+
+  if (received < 0)
+  {
+    WEBTELEMETRY_close(instance);
+    return;
+  }
+
+  instance->rx_length = (uint16_t)(instance->rx_length + received);
+
+  // A write is applied only once the previous one has completed.
+
+  while (!instance->flags.write_pending && !instance->flags.closing)
+  {
+    uint16_t frame_length = WEBTELEMETRY_process_frame(instance);
+
+    if (frame_length == 0)
+    {
+      break;
+    }
+
+    instance->rx_length = (uint16_t)(instance->rx_length - frame_length);
+
+    for (uint16_t i = 0; i < instance->rx_length; i++)
+    {
+      instance->rx_buffer[i] = instance->rx_buffer[frame_length + i];
+    }
+  }
+}
+
+static void WEBTELEMETRY_transmit(WEBTELEMETRY_instance_t* instance)
+{
+  while (instance->tx_offset < instance->tx_length)
+  {
+    int32_t sent = instance->send(instance->socket,
+                                  &instance->tx_buffer[instance->tx_offset],
+                                  instance->tx_length - instance->tx_offset);
+
+    if (sent < 0)
+    {
+      WEBTELEMETRY_close(instance);
+      return;
+    }
+
+    if (sent == 0)
+    {
+      return;
+    }
+
+    instance->tx_offset = (uint16_t)(instance->tx_offset + sent);
+  }
+
+  instance->tx_length = 0;
+  instance->tx_offset = 0;
+
+  if (instance->flags.closing)
+  {
+    WEBTELEMETRY_close(instance);
+  }
+}
+
+void WEBTELEMETRY_initialize(WEBTELEMETRY_instance_t* instance,
+                             UTIMER_instance_t* utimer,
+                             TERVAR_entry_t* entries,
+                             uint8_t entry_count,
+                             uint32_t period_us,
+                             WEBSERVER_hal_recv_t recv,
+                             WEBSERVER_hal_send_t send,
+                             WEBSERVER_hal_close_t close)
+{
+  UTILITIES_memclear(instance, sizeof(WEBTELEMETRY_instance_t));
+
+  instance->socket = -1;
+  instance->utimer = utimer;
+  instance->entries = entries;
+  instance->entry_count = entry_count;
+  instance->period_us = period_us;
+  instance->recv = recv;
+  instance->send = send;
+  instance->close = close;
+}
+
+uint16_t WEBTELEMETRY_upgrade(WEBTELEMETRY_instance_t* instance,
+                              int32_t socket,
+                              const WEBSERVER_request_t* request)
+{
+  if (instance->flags.connected)
+  {
+    return 503;
+  }
+
+  char* key = WEBSERVER_request_header(request, "sec-websocket-key");
+  char* version = WEBSERVER_request_header(request, "sec-websocket-version");
+
+  if ((request->method != WEBSERVER_METHOD_GET) ||
+      !WEBTELEMETRY_header_is(WEBSERVER_request_header(request, "upgrade"), "websocket") ||
+      !WEBTELEMETRY_header_is(WEBSERVER_request_header(request, "connection"), "upgrade") ||
+      (version == NULL) || (UTILITIES_strncmp(version, (char*)"13", 3) != 0) ||
+      (key == NULL) || (UTILITIES_strnlen(key, 25) != 24U))
+  {
+    return 400;
+  }
+
+  // Sec-WebSocket-Accept is the base64 encoded SHA-1 of the key followed by
+  // the protocol GUID.
+
+  uint8_t accept_input[24 + sizeof(WEBTELEMETRY_HANDSHAKE_GUID) - 1U];
+  uint8_t digest[20];
+
+  UTILITIES_memcpy(accept_input, key, 24);
+  UTILITIES_memcpy(&accept_input[24], (void*)WEBTELEMETRY_HANDSHAKE_GUID, sizeof(WEBTELEMETRY_HANDSHAKE_GUID) - 1U);
+  WEBTELEMETRY_sha1(accept_input, sizeof(accept_input), digest);
+
+  static const char RESPONSE_START[] = "HTTP/1.1 101 Switching Protocols\r\n"
+                                       "Upgrade: websocket\r\n"
+                                       "Connection: Upgrade\r\n"
+                                       "Sec-WebSocket-Accept: ";
+  char* response = (char*)instance->tx_buffer;
+  uint16_t length = sizeof(RESPONSE_START) - 1U;
+
+  UTILITIES_memcpy(response, (void*)RESPONSE_START, length);
+  length = (uint16_t)(length + WEBTELEMETRY_base64(digest, sizeof(digest), &response[length]));
+  UTILITIES_memcpy(&response[length], "\r\n\r\n", 4);
+
+  instance->tx_length = (uint16_t)(length + 4U);
+  instance->tx_offset = 0;
+  instance->rx_length = 0;
+  instance->sequence = 0;
+  instance->socket = socket;
+  instance->flags.all = 0;
+  instance->flags.connected = 1;
+
+  if (!WEBTELEMETRY_queue_describe(instance))
+  {
+    // The entry list is too long for WEBTELEMETRY_TX_BUFFER_LENGTH.
+
+    instance->tx_length = 0;
+    instance->socket = -1;
+    instance->flags.all = 0;
+
+    return 500;
+  }
+
+  UTIMER_ticket_create(instance->utimer, &instance->epoch_ticket, 0);
+  UTIMER_ticket_create(instance->utimer, &instance->period_ticket, 0);
+
+  WEBTELEMETRY_transmit(instance);
+
+  return 101;
+}
+
+bool WEBTELEMETRY_service(WEBTELEMETRY_instance_t* instance)
+{
+  if (!instance->flags.connected)
+  {
+    return true;
+  }
+
+  WEBTELEMETRY_receive(instance);
+
+  if (!instance->flags.connected)
+  {
+    return true;
+  }
+
+  if (instance->flags.write_pending)
+  {
+    TERVAR_entry_t* entry = &instance->entries[instance->write_index];
+
+    if ((entry->write_handler == NULL) || entry->write_handler(entry))
+    {
+      instance->flags.write_pending = 0;
+    }
+  }
+
+  if (!instance->flags.closing && !instance->flags.read_pending &&
+      UTIMER_ticket_has_expired(instance->utimer, &instance->period_ticket))
+  {
+    UTIMER_ticket_create(instance->utimer, &instance->period_ticket, instance->period_us);
+
+    if (instance->tx_length == 0)
+    {
+      instance->read_index = 0;
+      instance->flags.read_pending = 1;
+    }
+    else
+    {
+      instance->skipped_count++;
+    }
+  }
+
+  // The update is sampled once every read handler has completed.
+
+  if (instance->flags.read_pending && WEBTELEMETRY_read_entries(instance))
+  {
+    instance->flags.read_pending = 0;
+
+    if (!instance->flags.closing)
+    {
+      WEBTELEMETRY_queue_update(instance);
+    }
+  }
+
+  WEBTELEMETRY_transmit(instance);
+
+  return !instance->flags.connected ||
+         ((instance->tx_length == 0) && !instance->flags.write_pending && !instance->flags.read_pending);
+}
+
+bool WEBTELEMETRY_is_connected(WEBTELEMETRY_instance_t* instance)
+{
+  return instance->flags.connected;
+}
+
+void WEBTELEMETRY_disconnect(WEBTELEMETRY_instance_t* instance)
+{
+  if (instance->flags.connected && !instance->flags.closing)
+  {
+    WEBTELEMETRY_queue_close(instance, WEBTELEMETRY_CLOSE_NORMAL);
+  }
+}
+
+#endif // JLIB_CONFIG_WEBTELEMETRY
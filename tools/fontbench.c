@@ -0,0 +1,162 @@
+/*******************************************************************************
+ *
+ *  Benchmark of GFX2DUFONT text drawing. Draws gauge numerals with the same
+ *  font in 1, 2, and 4 bpp, anti-aliased text over a known background and
+ *  blended with the canvas, into a 320x240 RGB565 canvas, and reports the
+ *  glyphs per second of each:
+ *
+ *   fontbench [--glyphs N]
+ *
+ *  Build with the library stand-ins in sim/ (see sim/JLibSim.h), as for
+ *  tools/tilebench.c, with the fonts generated at the same size as
+ *  GFX2DUFONT_BENCH1, 2, and 4, e.g.:
+ *
+ *   for bpp in 1 2 4; do python3 tools/fontconvert.py DejaVuSans-Bold.ttf
+ *     --size 32 --bpp $bpp --name BENCH$bpp --output /tmp/FontBench$bpp; done
+ *   cc -std=gnu11 -O2 -I. -Isim tools/fontbench.c src/Gfx2dUfont.c
+ *      src/Kernel.c /tmp/FontBench1.c /tmp/FontBench2.c /tmp/FontBench4.c
+ *      sim/SimGfx2d.c sim/SimLibrary.c
+ *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "JLib.h"
+
+#define FONTBENCH_WIDTH                   320
+#define FONTBENCH_HEIGHT                  240
+
+extern const GFX2DUFONT_font_t GFX2DUFONT_BENCH1;
+extern const GFX2DUFONT_font_t GFX2DUFONT_BENCH2;
+extern const GFX2DUFONT_font_t GFX2DUFONT_BENCH4;
+
+typedef struct
+{
+  const char* name;
+  const GFX2DUFONT_font_t* font;
+  bool background_known;
+}
+FONTBENCH_case_t;
+
+static const FONTBENCH_case_t FONTBENCH_CASES[] =
+{
+  {"1 bpp", &GFX2DUFONT_BENCH1, false},
+  {"2 bpp, known background", &GFX2DUFONT_BENCH2, true},
+  {"2 bpp, blended", &GFX2DUFONT_BENCH2, false},
+  {"4 bpp, known background", &GFX2DUFONT_BENCH4, true},
+  {"4 bpp, blended", &GFX2DUFONT_BENCH4, false}
+};
+
+static const char FONTBENCH_TEXT[] = "0123456789.-%";
+
+static uint16_t FONTBENCH_canvas[FONTBENCH_WIDTH * FONTBENCH_HEIGHT];
+
+static uint32_t FONTBENCH_rgba_to_pixel(uint32_t rgba)
+{
+  GFX2D_rgba_t color;
+
+  color.all = rgba;
+
+  return ((uint32_t)(color.r >> 3) << 11) | ((uint32_t)(color.g >> 2) << 5) | (color.b >> 3);
+}
+
+static double FONTBENCH_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// Draws lines of numerals until the given number of glyphs is drawn,
+// starting over at the top of the canvas when full.
+
+static double FONTBENCH_run(const FONTBENCH_case_t* bench, uint32_t glyphs)
+{
+  GFX2D_instance_t gfx;
+  GFX2DUFONT_instance_t text;
+  uint32_t background = 0xFF402818UL;
+  uint32_t drawn = 0;
+
+  GFX2D_initialize(&gfx,
+                   (uint8_t*)FONTBENCH_canvas,
+                   sizeof(FONTBENCH_canvas),
+                   FONTBENCH_WIDTH,
+                   FONTBENCH_HEIGHT,
+                   16,
+                   FONTBENCH_rgba_to_pixel);
+  GFX2D_set_canvas_dimensions(&gfx, 0, 0, FONTBENCH_WIDTH, FONTBENCH_HEIGHT);
+
+#if JLIB_CONFIG_KERNEL
+  KERNEL_gfx2d_bind(&gfx);
+#endif
+
+  GFX2D_fill_canvas(&gfx, background);
+  GFX2D_set_font_color(&gfx, 0xFFF0F0F0UL);
+
+  GFX2DUFONT_initialize(&text, &gfx, bench->font);
+  GFX2DUFONT_set_background(&text, bench->background_known, background);
+
+  double start = FONTBENCH_now();
+
+  while (drawn < glyphs)
+  {
+    if (gfx.font.cursor_y == 0 || gfx.font.cursor_y >= FONTBENCH_HEIGHT)
+    {
+      gfx.font.cursor_y = bench->font->y_advance;
+    }
+
+    gfx.font.cursor_x = 0;
+
+    for (const char* c = &FONTBENCH_TEXT[drawn % (sizeof(FONTBENCH_TEXT) - 1)];
+         (*c != '\0') && (gfx.font.cursor_x < FONTBENCH_WIDTH) && (drawn < glyphs);
+         c++, drawn++)
+    {
+      GFX2DUFONT_draw_char(&text, (uint8_t)*c);
+    }
+
+    gfx.font.cursor_y = (int16_t)(gfx.font.cursor_y + bench->font->y_advance);
+  }
+
+  return (double)glyphs / (FONTBENCH_now() - start);
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t glyphs = 200000;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if ((strcmp(argv[i], "--glyphs") == 0) && (i + 1 < argc))
+    {
+      glyphs = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [--glyphs N]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  double baseline = 0;
+
+  for (size_t i = 0; i < sizeof(FONTBENCH_CASES) / sizeof(FONTBENCH_CASES[0]); i++)
+  {
+    double rate = FONTBENCH_run(&FONTBENCH_CASES[i], glyphs);
+
+    if (i == 0)
+    {
+      baseline = rate;
+    }
+
+    printf("%-26s %10.0f glyphs/s  %5.2fx\n", FONTBENCH_CASES[i].name, rate, rate / baseline);
+  }
+
+  return 0;
+}
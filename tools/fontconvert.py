@@ -0,0 +1,522 @@
+#!/usr/bin/env python3
+"""
+Host tool for GFX2DUFONT.
+
+Converts a TrueType font to a sparse GFX2DUFONT_font_t holding only the
+codepoints given with --ranges and --text:
+
+  fontconvert.py DejaVuSans.ttf --size 16 --name SANS16 \\
+      --ranges 0x20-0x7E,0xB0,0x400-0x44F --output src/FontSans16
+
+A .c and .h pair is written, the font being named GFX2DUFONT_<name>. The size
+is the em size in pixels. Glyph outlines are read and rasterized by this tool,
+without hinting, so no font library is needed. Codepoints the font does not
+provide are skipped.
+
+With --bpp 2 or 4, the glyphs are anti-aliased, with 2 or 4 bits of alpha per
+pixel, run-length encoded. The flash size of the font is reported along with
+that of the same font in 1 bpp.
+"""
+
+import argparse
+import math
+import struct
+import sys
+
+GLYPH_SIZE = 12
+RANGE_SIZE = 8
+FONT_SIZE = 16
+DENSE_GLYPH_SIZE = 8
+SUBSCANLINES = 16
+RANGE_LENGTH_MAX = 0xFFFF
+CODE_OPAQUE = 0x80
+CODE_RUN_MAX = 15
+CODE_ALPHA_MAX = 7
+CODE_COUNT_MAX = 0x7FFF
+
+
+class TrueTypeFont:
+    """Reads the glyph outlines, metrics and character map of a TrueType
+    (glyf) font."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        version, table_count = struct.unpack_from(">IH", self.data, 0)
+        if version not in (0x00010000, 0x74727565):
+            raise ValueError("%s is not a TrueType font" % path)
+        self.tables = {}
+        for i in range(table_count):
+            tag, _, offset, length = struct.unpack_from(">4sIII", self.data, 12 + 16 * i)
+            self.tables[tag.decode("latin-1")] = (offset, length)
+        for tag in ("head", "maxp", "hhea", "hmtx", "loca", "glyf", "cmap"):
+            if tag not in self.tables:
+                raise ValueError("%s has no %s table" % (path, tag))
+
+        head = self.tables["head"][0]
+        self.units_per_em = struct.unpack_from(">H", self.data, head + 18)[0]
+        long_loca = struct.unpack_from(">h", self.data, head + 50)[0] != 0
+        self.glyph_count = struct.unpack_from(">H", self.data, self.tables["maxp"][0] + 4)[0]
+        hhea = self.tables["hhea"][0]
+        self.ascender, self.descender, self.line_gap = struct.unpack_from(">hhh", self.data, hhea + 4)
+        metric_count = struct.unpack_from(">H", self.data, hhea + 34)[0]
+        self.advances = struct.unpack_from(">" + "Hh" * metric_count, self.data,
+                                           self.tables["hmtx"][0])[0::2]
+
+        loca = self.tables["loca"][0]
+        if long_loca:
+            self.loca = struct.unpack_from(">%dI" % (self.glyph_count + 1), self.data, loca)
+        else:
+            self.loca = [2 * o for o in struct.unpack_from(">%dH" % (self.glyph_count + 1), self.data, loca)]
+        self.cmap = self.read_cmap()
+
+    def read_cmap(self):
+        cmap = self.tables["cmap"][0]
+        subtable_count = struct.unpack_from(">H", self.data, cmap + 2)[0]
+        subtables = {}
+        for i in range(subtable_count):
+            platform, encoding, offset = struct.unpack_from(">HHI", self.data, cmap + 4 + 8 * i)
+            fmt = struct.unpack_from(">H", self.data, cmap + offset)[0]
+            subtables[(platform, encoding, fmt)] = cmap + offset
+        for key in ((3, 10, 12), (0, 4, 12), (0, 6, 12), (3, 1, 4), (0, 3, 4), (0, 1, 4), (0, 0, 4)):
+            if key in subtables:
+                return (self.read_cmap12 if key[2] == 12 else self.read_cmap4)(subtables[key])
+        raise ValueError("font has no Unicode character map")
+
+    def read_cmap4(self, offset):
+        segments = struct.unpack_from(">H", self.data, offset + 6)[0] // 2
+        ends = struct.unpack_from(">%dH" % segments, self.data, offset + 14)
+        starts = struct.unpack_from(">%dH" % segments, self.data, offset + 16 + 2 * segments)
+        deltas = struct.unpack_from(">%dh" % segments, self.data, offset + 16 + 4 * segments)
+        range_offsets_at = offset + 16 + 6 * segments
+        range_offsets = struct.unpack_from(">%dH" % segments, self.data, range_offsets_at)
+        cmap = {}
+        for i in range(segments):
+            for codepoint in range(starts[i], ends[i] + 1):
+                if codepoint == 0xFFFF:
+                    continue
+                if range_offsets[i] == 0:
+                    glyph = (codepoint + deltas[i]) & 0xFFFF
+                else:
+                    at = range_offsets_at + 2 * i + range_offsets[i] + 2 * (codepoint - starts[i])
+                    glyph = struct.unpack_from(">H", self.data, at)[0]
+                    if glyph != 0:
+                        glyph = (glyph + deltas[i]) & 0xFFFF
+                if glyph != 0:
+                    cmap[codepoint] = glyph
+        return cmap
+
+    def read_cmap12(self, offset):
+        group_count = struct.unpack_from(">I", self.data, offset + 12)[0]
+        cmap = {}
+        for i in range(group_count):
+            start, end, glyph = struct.unpack_from(">III", self.data, offset + 16 + 12 * i)
+            for codepoint in range(start, end + 1):
+                cmap[codepoint] = glyph + codepoint - start
+        return cmap
+
+    def advance(self, glyph):
+        return self.advances[min(glyph, len(self.advances) - 1)]
+
+    def contours(self, glyph, depth=0):
+        """Returns the contours of a glyph as lists of (x, y, on_curve)."""
+        start = self.tables["glyf"][0] + self.loca[glyph]
+        if self.loca[glyph + 1] == self.loca[glyph] or depth > 8:
+            return []
+        contour_count = struct.unpack_from(">h", self.data, start)[0]
+        if contour_count >= 0:
+            return self.simple_contours(start + 10, contour_count)
+        return self.composite_contours(start + 10, depth)
+
+    def simple_contours(self, at, contour_count):
+        ends = struct.unpack_from(">%dH" % contour_count, self.data, at)
+        at += 2 * contour_count
+        at += 2 + struct.unpack_from(">H", self.data, at)[0]
+        point_count = ends[-1] + 1 if ends else 0
+
+        flags = []
+        while len(flags) < point_count:
+            flag = self.data[at]
+            at += 1
+            repeat = 1
+            if flag & 8:
+                repeat += self.data[at]
+                at += 1
+            flags += [flag] * repeat
+
+        coordinates = []
+        for short, same in ((2, 16), (4, 32)):
+            value = 0
+            values = []
+            for flag in flags[:point_count]:
+                if flag & short:
+                    delta = self.data[at]
+                    at += 1
+                    value += delta if flag & same else -delta
+                elif not flag & same:
+                    value += struct.unpack_from(">h", self.data, at)[0]
+                    at += 2
+                values.append(value)
+            coordinates.append(values)
+
+        contours = []
+        first = 0
+        for end in ends:
+            contours.append([(coordinates[0][i], coordinates[1][i], bool(flags[i] & 1))
+                             for i in range(first, end + 1)])
+            first = end + 1
+        return contours
+
+    def composite_contours(self, at, depth):
+        contours = []
+        while True:
+            flags, glyph = struct.unpack_from(">HH", self.data, at)
+            at += 4
+            if flags & 1:
+                dx, dy = struct.unpack_from(">hh" if flags & 2 else ">HH", self.data, at)
+                at += 4
+            else:
+                dx, dy = struct.unpack_from(">bb" if flags & 2 else ">BB", self.data, at)
+                at += 2
+            if not flags & 2:
+                dx = dy = 0  # Point matching is not supported.
+            a, b, c, d = 1.0, 0.0, 0.0, 1.0
+            if flags & 8:
+                a = d = struct.unpack_from(">h", self.data, at)[0] / 16384.0
+                at += 2
+            elif flags & 0x40:
+                a, d = [v / 16384.0 for v in struct.unpack_from(">hh", self.data, at)]
+                at += 4
+            elif flags & 0x80:
+                a, b, c, d = [v / 16384.0 for v in struct.unpack_from(">hhhh", self.data, at)]
+                at += 8
+            for contour in self.contours(glyph, depth + 1):
+                contours.append([(a * x + c * y + dx, b * x + d * y + dy, on) for x, y, on in contour])
+            if not flags & 0x20:
+                return contours
+
+
+def flatten(contour, scale):
+    """Converts a contour of quadratic curves to a closed polygon in pixel
+    coordinates, y pointing down from the baseline."""
+    points = [(x * scale, -y * scale, on) for x, y, on in contour]
+    if not points:
+        return []
+    # Start on an on-curve point, implied between two off-curve points if none.
+    for i, point in enumerate(points):
+        if point[2]:
+            points = points[i:] + points[:i]
+            break
+    else:
+        x0, y0, _ = points[0]
+        x1, y1, _ = points[-1]
+        points.insert(0, ((x0 + x1) / 2, (y0 + y1) / 2, True))
+
+    polygon = [points[0][:2]]
+    control = None
+    for x, y, on in points[1:] + points[:1]:
+        if on:
+            if control is None:
+                polygon.append((x, y))
+            else:
+                polygon += quadratic(polygon[-1], control, (x, y))
+                control = None
+        elif control is None:
+            control = (x, y)
+        else:
+            middle = ((control[0] + x) / 2, (control[1] + y) / 2)
+            polygon += quadratic(polygon[-1], control, middle)
+            control = (x, y)
+    return polygon
+
+
+def quadratic(p0, p1, p2):
+    length = math.hypot(p1[0] - p0[0], p1[1] - p0[1]) + math.hypot(p2[0] - p1[0], p2[1] - p1[1])
+    steps = max(2, int(math.ceil(math.sqrt(length) * 2)))
+    result = []
+    for i in range(1, steps + 1):
+        t = i / steps
+        u = 1 - t
+        result.append((u * u * p0[0] + 2 * u * t * p1[0] + t * t * p2[0],
+                       u * u * p0[1] + 2 * u * t * p1[1] + t * t * p2[1]))
+    return result
+
+
+def rasterize(polygons, left, top, width, height):
+    """Returns the coverage, 0.0 to 1.0, of each pixel with the nonzero
+    winding rule. Coverage is exact horizontally and sampled vertically."""
+    edges = []
+    for polygon in polygons:
+        for (x0, y0), (x1, y1) in zip(polygon, polygon[1:] + polygon[:1]):
+            if y0 != y1:
+                edges.append((x0, y0, x1, y1, 1 if y1 > y0 else -1))
+
+    coverage = [[0.0] * width for _ in range(height)]
+    for row in range(height):
+        cells = coverage[row]
+        for k in range(SUBSCANLINES):
+            y = top + row + (k + 0.5) / SUBSCANLINES
+            crossings = []
+            for x0, y0, x1, y1, winding in edges:
+                if min(y0, y1) <= y < max(y0, y1):
+                    crossings.append((x0 + (y - y0) * (x1 - x0) / (y1 - y0) - left, winding))
+            crossings.sort()
+            winding = 0
+            for x, direction in crossings:
+                previous = winding
+                winding += direction
+                if previous == 0 and winding != 0:
+                    span_start = x
+                elif previous != 0 and winding == 0:
+                    add_span(cells, span_start, x, 1.0 / SUBSCANLINES)
+    return coverage
+
+
+def add_span(cells, start, end, weight):
+    start = max(start, 0.0)
+    end = min(end, float(len(cells)))
+    if end <= start:
+        return
+    first = int(start)
+    last = int(end)
+    if first == last:
+        cells[first] += (end - start) * weight
+        return
+    cells[first] += (first + 1 - start) * weight
+    for i in range(first + 1, last):
+        cells[i] += weight
+    if last < len(cells):
+        cells[last] += (end - last) * weight
+
+
+def render_glyph(font, glyph, scale):
+    """Returns (coverage rows, x_offset, y_offset, x_advance) of a glyph."""
+    x_advance = int(round(font.advance(glyph) * scale))
+    polygons = [p for p in (flatten(c, scale) for c in font.contours(glyph)) if len(p) > 2]
+    if not polygons:
+        return [], 0, 0, x_advance
+
+    left = int(math.floor(min(x for p in polygons for x, _ in p)))
+    right = int(math.ceil(max(x for p in polygons for x, _ in p)))
+    top = int(math.floor(min(y for p in polygons for _, y in p)))
+    bottom = int(math.ceil(max(y for p in polygons for _, y in p)))
+    return rasterize(polygons, left, top, right - left, bottom - top), left, top, x_advance
+
+
+def trim(coverage, x_offset, y_offset, threshold):
+    """Returns (coverage rows, width, height, x_offset, y_offset) trimmed to
+    the pixels of at least the threshold coverage."""
+    rows = [i for i, row in enumerate(coverage) if any(v >= threshold for v in row)]
+    if not rows:
+        return [], 0, 0, 0, 0
+    columns = [i for i in range(len(coverage[0])) if any(row[i] >= threshold for row in coverage)]
+    coverage = [row[columns[0]:columns[-1] + 1] for row in coverage[rows[0]:rows[-1] + 1]]
+    return (coverage, columns[-1] - columns[0] + 1, rows[-1] - rows[0] + 1,
+            x_offset + columns[0], y_offset + rows[0])
+
+
+def pack_bits(values, bpp):
+    """Packs values MSB first, padded to a byte."""
+    data = bytearray()
+    byte = 0
+    bits = 0
+    for value in values:
+        byte = (byte << bpp) | value
+        bits += bpp
+        if bits == 8:
+            data.append(byte)
+            byte = bits = 0
+    if bits:
+        data.append(byte << (8 - bits))
+    return bytes(data)
+
+
+def pack_1bpp(coverage):
+    """Packs the pixels of a glyph, rows not padded, as GFX2DFONT."""
+    return pack_bits([1 if v >= 0.5 else 0 for row in coverage for v in row], 1)
+
+
+def encode_alpha(coverage, bpp):
+    """Run-length encodes the alpha of the pixels of a glyph, row after row,
+    unless storing the alpha of every pixel is smaller, see
+    GFX2DUFONT_font_t."""
+    maximum = (1 << bpp) - 1
+    levels = [min(maximum, int(round(v * maximum))) for row in coverage for v in row]
+
+    codes = bytearray()
+    alpha = []
+    i = 0
+    while i < len(levels):
+        solid = levels[i] if levels[i] == maximum else 0
+        run = 0
+        while i < len(levels) and levels[i] == solid and run < CODE_RUN_MAX:
+            run += 1
+            i += 1
+        count = 0
+        while i < len(levels) and 0 < levels[i] < maximum and count < CODE_ALPHA_MAX:
+            alpha.append(levels[i])
+            count += 1
+            i += 1
+        codes.append((CODE_OPAQUE if solid else 0) | (run << 3) | count)
+
+    if len(codes) < 0x80:
+        header = bytes([len(codes)])
+    else:
+        header = struct.pack(">H", 0x8000 | len(codes))
+    compressed = header + codes + pack_bits(alpha, bpp)
+    uncompressed = b"\0" + pack_bits(levels, bpp)
+    if len(codes) > CODE_COUNT_MAX or len(uncompressed) <= len(compressed):
+        return uncompressed
+    return compressed
+
+
+def parse_ranges(text):
+    codepoints = set()
+    for item in text.split(","):
+        item = item.strip()
+        if not item:
+            continue
+        first, _, last = item.partition("-")
+        first = int(first, 0)
+        last = int(last, 0) if last else first
+        if last < first or last > 0x10FFFF:
+            raise argparse.ArgumentTypeError("invalid codepoint range %s" % item)
+        codepoints.update(range(first, last + 1))
+    return codepoints
+
+
+def build_ranges(codepoints):
+    """Returns (first_codepoint, length, first_glyph) runs of consecutive
+    codepoints, the glyphs being stored in codepoint order."""
+    ranges = []
+    for index, codepoint in enumerate(codepoints):
+        if ranges and ranges[-1][0] + ranges[-1][1] == codepoint and ranges[-1][1] < RANGE_LENGTH_MAX:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([codepoint, 1, index])
+    return ranges
+
+
+def check_glyph(codepoint, width, height, x_offset, y_offset, x_advance):
+    if width > 255 or height > 255 or x_advance > 255 or \
+            not -128 <= x_offset <= 127 or not -128 <= y_offset <= 127:
+        raise ValueError("glyph U+%04X does not fit the glyph metrics, reduce the size" % codepoint)
+
+
+def c_bytes(name, data):
+    lines = ["static const uint8_t %s[%d] =" % (name, max(len(data), 1)), "{"]
+    data = data or b"\0"
+    for i in range(0, len(data), 12):
+        lines.append("  " + ", ".join("0x%02X" % b for b in data[i:i + 12]) +
+                     ("," if i + 12 < len(data) else ""))
+    lines.append("};")
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("font", help="TrueType font file")
+    parser.add_argument("--size", type=float, required=True, help="em size in pixels")
+    parser.add_argument("--name", required=True,
+                        help="font name, the font is named GFX2DUFONT_<name>")
+    parser.add_argument("--ranges", type=parse_ranges, default=parse_ranges("0x20-0x7E"),
+                        help="codepoints and codepoint ranges, default 0x20-0x7E")
+    parser.add_argument("--bpp", type=int, choices=(1, 2, 4), default=1,
+                        help="bits per pixel, 2 or 4 for anti-aliased glyphs")
+    parser.add_argument("--text", action="append", default=[],
+                        help="UTF-8 text file whose characters are added, e.g. a translation")
+    parser.add_argument("--output", required=True,
+                        help="output path without extension, a .c and .h pair is written")
+    args = parser.parse_args()
+
+    try:
+        font = TrueTypeFont(args.font)
+        requested = set(args.ranges)
+        for path in args.text:
+            with open(path, encoding="utf-8") as f:
+                requested.update(ord(c) for c in f.read() if c not in "\r\n")
+    except (OSError, ValueError, struct.error) as error:
+        sys.exit("fontconvert: %s" % error)
+
+    codepoints = sorted(c for c in requested if c in font.cmap)
+    missing = len(requested) - len(codepoints)
+    if not codepoints:
+        sys.exit("fontconvert: the font provides none of the codepoints")
+
+    scale = args.size / font.units_per_em
+    y_advance = int(round((font.ascender - font.descender + font.line_gap) * scale))
+    symbol = "GFX2DUFONT_%s" % args.name
+    bitmap = bytearray()
+    binary_length = 0
+    glyph_lines = []
+    try:
+        for codepoint in codepoints:
+            coverage, left, top, x_advance = render_glyph(font, font.cmap[codepoint], scale)
+            binary = trim(coverage, left, top, 0.5)
+            if args.bpp == 1:
+                glyph, width, height, x_offset, y_offset = binary
+                data = pack_1bpp(glyph)
+            else:
+                glyph, width, height, x_offset, y_offset = \
+                    trim(coverage, left, top, 0.5 / ((1 << args.bpp) - 1))
+                data = encode_alpha(glyph, args.bpp)
+            binary_length += len(pack_1bpp(binary[0]))
+            check_glyph(codepoint, width, height, x_offset, y_offset, x_advance)
+            glyph_lines.append("  {%d, %d, %d, %d, %d, %d}, // U+%04X" % (
+                len(bitmap), width, height, x_advance, x_offset, y_offset, codepoint))
+            bitmap += data
+    except (ValueError, struct.error) as error:
+        sys.exit("fontconvert: %s" % error)
+    glyph_lines[-1] = glyph_lines[-1].replace("}, //", "}  //")
+    ranges = build_ranges(codepoints)
+
+    header = ["/" + "*" * 79, " *",
+              " *  %s font, %g px, %d bpp. Generated by tools/fontconvert.py - do not edit." % (args.name, args.size, args.bpp),
+              " *", " " + "*" * 78 + "/"]
+    source = ["#include \"JLib.h\"", ""] + header + ["", "#if JLIB_CONFIG_GFX2DUFONT", ""]
+    source += c_bytes("%s_BITMAP" % symbol, bitmap)
+    source += ["", "static const GFX2DUFONT_glyph_t %s_GLYPHS[%d] =" % (symbol, len(codepoints)), "{"]
+    source += glyph_lines + ["};", ""]
+    source += ["static const GFX2DUFONT_range_t %s_RANGES[%d] =" % (symbol, len(ranges)), "{"]
+    source += ["  {0x%04X, %d, %d}%s" % (r[0], r[1], r[2], "," if i + 1 < len(ranges) else "")
+               for i, r in enumerate(ranges)]
+    source += ["};", "",
+               "const GFX2DUFONT_font_t %s =" % symbol, "{",
+               "  %s_BITMAP," % symbol,
+               "  %s_GLYPHS," % symbol,
+               "  %s_RANGES," % symbol,
+               "  %d," % len(ranges),
+               "  %d," % y_advance,
+               "  %d" % (0 if args.bpp == 1 else args.bpp),
+               "};", "", "#endif // JLIB_CONFIG_GFX2DUFONT"]
+    with open(args.output + ".c", "w") as f:
+        f.write("\n".join(source) + "\n")
+
+    guard = "%s_J_H" % symbol
+    lines = header + ["", "#ifndef " + guard, "#define " + guard, "",
+                      "#include \"JLib.h\"", "",
+                      "// Support C++ builds.", "",
+                      "#ifdef __cplusplus", "extern \"C\" {", "#endif", "",
+                      "extern const GFX2DUFONT_font_t %s;" % symbol, "",
+                      "#ifdef __cplusplus", "}", "#endif", "#endif // " + guard]
+    with open(args.output + ".h", "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+    flash = len(bitmap) + GLYPH_SIZE * len(codepoints) + RANGE_SIZE * len(ranges) + FONT_SIZE
+    dense = len(bitmap) + DENSE_GLYPH_SIZE * (codepoints[-1] - codepoints[0] + 1) + FONT_SIZE
+    print("%s: %d glyphs in %d ranges, bitmap %d bytes, %d bytes of flash" % (
+        symbol, len(codepoints), len(ranges), len(bitmap), flash), file=sys.stderr)
+    print("as a GFX2DFONT from U+%04X to U+%04X: %d bytes%s" % (
+        codepoints[0], codepoints[-1], dense,
+        ", bitmap over 64 KB" if len(bitmap) > 0xFFFF else ""), file=sys.stderr)
+    if args.bpp != 1:
+        tables = flash - len(bitmap)
+        print("in 1 bpp: bitmap %d bytes, %d bytes of flash (%.2fx)" % (
+            binary_length, binary_length + tables, flash / float(binary_length + tables)), file=sys.stderr)
+    if missing:
+        print("%d codepoints not provided by the font" % missing, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
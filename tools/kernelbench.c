@@ -0,0 +1,628 @@
+/*******************************************************************************
+ *
+ *  Benchmark of the KERNEL replacements against the library versions they
+ *  replace: UTILITIES_memcpy and UTILITIES_crc16, the GFX2D canvas fill and
+ *  filled rectangle handlers, WS2812_parse_grb_array, and the UTIMER ticket
+ *  math. The RGB565 span kernels have no library version and are compared
+ *  with plain C loops. Each case first checks that both versions write the
+ *  same output, then reports the fastest of a number of runs:
+ *
+ *   kernelbench [--runs N]
+ *
+ *  On a Cortex-M4 or M7, the library versions are those of the M0 archive,
+ *  which is what these parts link, and the times are SysTick ticks. Build
+ *  and run on the QEMU MPS2 boards (mps2-an386 is a Cortex-M4, mps2-an500 a
+ *  Cortex-M7), with the output on the semihosting console:
+ *
+ *   arm-none-eabi-gcc -std=gnu11 -O2 -mcpu=cortex-m4 -mthumb -I. -Isim
+ *      tools/kernelbench.c src/Kernel.c JLib_arm_cortexm0.a
+ *      --specs=rdimon.specs -Wl,--section-start=.vectors=0 -Wl,-Ttext=0x400
+ *      -o kernelbench.elf
+ *   qemu-system-arm -M mps2-an386 -nographic -icount shift=5
+ *      -semihosting-config enable=on,target=native -kernel kernelbench.elf
+ *
+ *  QEMU does not model pipelines, wait states or caches. With -icount, each
+ *  instruction takes the same virtual time (32 ns with shift=5, 0.8 SysTick
+ *  ticks at the 25 MHz board clock), hence, the ratios are those of the
+ *  executed instruction counts, which the M0 archive inflates with byte
+ *  loops and 64-bit division calls. Cycle counts need the hardware.
+ *
+ *  On the host, the library versions are the stand-ins in sim/ (see
+ *  sim/JLibSim.h) and the times are nanoseconds. Only the checks and the
+ *  build are meaningful there, as the compiler vectorizes both versions:
+ *
+ *   cc -std=gnu11 -O2 -I. -Isim tools/kernelbench.c src/Kernel.c
+ *      sim/SimGfx2d.c sim/SimLibrary.c
+ *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "JLib.h"
+
+#if defined(__arm__) && !defined(__linux__)
+#define KERNELBENCH_TARGET                1
+#else
+#define KERNELBENCH_TARGET                0
+#endif
+
+#define KERNELBENCH_BUFFER_LENGTH         4096U
+#define KERNELBENCH_FRAME_WIDTH           320
+#define KERNELBENCH_FRAME_HEIGHT          240
+#define KERNELBENCH_FRAME_PIXELS          ((uint32_t)KERNELBENCH_FRAME_WIDTH * KERNELBENCH_FRAME_HEIGHT)
+#define KERNELBENCH_SPRITE_WIDTH          64U
+#define KERNELBENCH_SPRITE_HEIGHT         48U
+#define KERNELBENCH_COLOR_KEY             0xF81FU
+#define KERNELBENCH_BLEND_ALPHA           100U
+#define KERNELBENCH_LEDS                  60U
+#define KERNELBENCH_TICKETS               64U
+#define KERNELBENCH_TICKS_PER_MICROSECOND 48U
+#define KERNELBENCH_RUNS_DEFAULT          200U
+
+/*******************************************************************************
+ * Timing
+ ******************************************************************************/
+
+#if KERNELBENCH_TARGET
+
+#define KERNELBENCH_UNIT                  "ticks"
+
+#define KERNELBENCH_SYST_CSR              (*(volatile uint32_t*)0xE000E010U)
+#define KERNELBENCH_SYST_RVR              (*(volatile uint32_t*)0xE000E014U)
+#define KERNELBENCH_SYST_CVR              (*(volatile uint32_t*)0xE000E018U)
+#define KERNELBENCH_SYST_MASK             0x00FFFFFFU
+
+extern void _start(void);
+
+static uint32_t KERNELBENCH_stack[1024];
+
+static void KERNELBENCH_fault_handler(void)
+{
+  abort();
+}
+
+// The reset vector enters the semihosting C runtime. The other exceptions
+// are faults, as SysTick runs without its interrupt.
+
+__attribute__((section(".vectors"), used))
+static void (* const KERNELBENCH_vectors[16])(void) =
+{
+  (void (*)(void))&KERNELBENCH_stack[sizeof(KERNELBENCH_stack) / sizeof(KERNELBENCH_stack[0])],
+  _start,
+  KERNELBENCH_fault_handler,
+  KERNELBENCH_fault_handler,
+  KERNELBENCH_fault_handler,
+  KERNELBENCH_fault_handler,
+  KERNELBENCH_fault_handler,
+};
+
+static void KERNELBENCH_timer_initialize(void)
+{
+  KERNELBENCH_SYST_RVR = KERNELBENCH_SYST_MASK;
+  KERNELBENCH_SYST_CVR = 0;
+  KERNELBENCH_SYST_CSR = 0x5U;
+}
+
+static uint32_t KERNELBENCH_timer_now(void)
+{
+  return KERNELBENCH_SYST_CVR;
+}
+
+// SysTick counts down and wraps after 2^24 ticks, far longer than a call.
+
+static uint32_t KERNELBENCH_timer_elapsed(uint32_t start)
+{
+  return (start - KERNELBENCH_SYST_CVR) & KERNELBENCH_SYST_MASK;
+}
+
+#else
+
+#define KERNELBENCH_UNIT                  "ns"
+
+static void KERNELBENCH_timer_initialize(void)
+{
+}
+
+static uint32_t KERNELBENCH_timer_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
+
+static uint32_t KERNELBENCH_timer_elapsed(uint32_t start)
+{
+  return KERNELBENCH_timer_now() - start;
+}
+
+#endif
+
+/*******************************************************************************
+ * Data
+ ******************************************************************************/
+
+static struct
+{
+  uint32_t src[KERNELBENCH_BUFFER_LENGTH / 4U + 1U];
+  uint32_t dest[KERNELBENCH_BUFFER_LENGTH / 4U + 1U];
+  uint16_t frame[KERNELBENCH_FRAME_PIXELS];
+  uint16_t sprite[KERNELBENCH_SPRITE_WIDTH * KERNELBENCH_SPRITE_HEIGHT];
+  uint8_t grb[KERNELBENCH_LEDS * 3U];
+  uint8_t ws2812_buffer[KERNELBENCH_LEDS * 3U * 3U];
+  uint16_t crc;
+  uint32_t random;
+  uint64_t ticks;
+  uint64_t expirations_us[KERNELBENCH_TICKETS];
+  UTIMER_ticket_t tickets[KERNELBENCH_TICKETS];
+  uint64_t elapsed_us[KERNELBENCH_TICKETS];
+  GFX2D_instance_t gfx;
+  GFX2D_instance_t gfx_kernel;
+  WS2812_instance_t ws2812;
+  UTIMER_instance_t utimer;
+}
+KERNELBENCH_data;
+
+static uint8_t KERNELBENCH_check[KERNELBENCH_FRAME_PIXELS * 2U];
+
+static uint32_t KERNELBENCH_rgba_to_rgb565(uint32_t rgba)
+{
+  GFX2D_rgba_t color;
+
+  color.all = rgba;
+
+  return ((uint32_t)(color.r >> 3) << 11) | ((uint32_t)(color.g >> 2) << 5) | (color.b >> 3);
+}
+
+static uint64_t KERNELBENCH_get_hardware_counter(void)
+{
+  return KERNELBENCH_data.ticks;
+}
+
+static uint32_t KERNELBENCH_random(void)
+{
+  uint32_t state = KERNELBENCH_data.random;
+
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  KERNELBENCH_data.random = state;
+
+  return state;
+}
+
+static void KERNELBENCH_fill_random(void* buffer, uint32_t length)
+{
+  uint8_t* bytes = (uint8_t*)buffer;
+
+  while (length-- != 0)
+  {
+    *bytes++ = (uint8_t)KERNELBENCH_random();
+  }
+}
+
+// Sets the inputs and outputs of every case to the same values, so that the
+// outputs of both versions can be compared.
+
+static void KERNELBENCH_reset(uint64_t ticks_per_period)
+{
+  KERNELBENCH_data.random = 0x2545F491U;
+
+  KERNELBENCH_fill_random(KERNELBENCH_data.src, sizeof(KERNELBENCH_data.src));
+  KERNELBENCH_fill_random(KERNELBENCH_data.dest, sizeof(KERNELBENCH_data.dest));
+  KERNELBENCH_fill_random(KERNELBENCH_data.frame, sizeof(KERNELBENCH_data.frame));
+  KERNELBENCH_fill_random(KERNELBENCH_data.sprite, sizeof(KERNELBENCH_data.sprite));
+  KERNELBENCH_fill_random(KERNELBENCH_data.grb, sizeof(KERNELBENCH_data.grb));
+  KERNELBENCH_fill_random(KERNELBENCH_data.ws2812_buffer, sizeof(KERNELBENCH_data.ws2812_buffer));
+
+  // A quarter of the source pixels are transparent for the color keyed blit.
+
+  uint16_t* pixels = (uint16_t*)KERNELBENCH_data.src;
+
+  for (uint32_t i = 0; i < KERNELBENCH_BUFFER_LENGTH / 2U; i += 4U)
+  {
+    pixels[i + (KERNELBENCH_random() & 3U)] = KERNELBENCH_COLOR_KEY;
+  }
+
+  GFX2D_initialize(&KERNELBENCH_data.gfx,
+                   (uint8_t*)KERNELBENCH_data.frame,
+                   sizeof(KERNELBENCH_data.frame),
+                   KERNELBENCH_FRAME_WIDTH,
+                   KERNELBENCH_FRAME_HEIGHT,
+                   16,
+                   KERNELBENCH_rgba_to_rgb565);
+
+  GFX2D_set_canvas_dimensions(&KERNELBENCH_data.gfx, 0, 0, KERNELBENCH_FRAME_WIDTH, KERNELBENCH_FRAME_HEIGHT);
+
+  KERNELBENCH_data.gfx_kernel = KERNELBENCH_data.gfx;
+  KERNEL_gfx2d_bind(&KERNELBENCH_data.gfx_kernel);
+
+  KERNELBENCH_data.ws2812.src_buffer = KERNELBENCH_data.ws2812_buffer;
+  KERNELBENCH_data.ws2812.src_buffer_length = sizeof(KERNELBENCH_data.ws2812_buffer);
+  KERNELBENCH_data.ws2812.bit_code_0 = 0x4U;
+  KERNELBENCH_data.ws2812.bit_code_1 = 0x6U;
+
+  // Timeouts from tens of microseconds to a second, with a 48 MHz timer.
+
+  UTIMER_initialize(&KERNELBENCH_data.utimer,
+                    KERNELBENCH_TICKS_PER_MICROSECOND,
+                    ticks_per_period,
+                    KERNELBENCH_get_hardware_counter);
+
+  KERNELBENCH_data.utimer.period_counter = 1234;
+  KERNELBENCH_data.ticks = ticks_per_period / 3U;
+
+  for (uint32_t i = 0; i < KERNELBENCH_TICKETS; i++)
+  {
+    KERNELBENCH_data.expirations_us[i] = (KERNELBENCH_random() % 1000000U) >> (i % 16U);
+  }
+
+  memset(KERNELBENCH_data.tickets, 0, sizeof(KERNELBENCH_data.tickets));
+  memset(KERNELBENCH_data.elapsed_us, 0, sizeof(KERNELBENCH_data.elapsed_us));
+}
+
+/*******************************************************************************
+ * Cases
+ ******************************************************************************/
+
+typedef struct
+{
+  const char* name;
+  const char* baseline;
+  void (*baseline_run)(void);
+  void (*kernel_run)(void);
+  void* output;
+  uint32_t output_length;
+  uint64_t ticks_per_period;
+}
+KERNELBENCH_case_t;
+
+static void KERNELBENCH_memcpy_library(void)
+{
+  UTILITIES_memcpy(KERNELBENCH_data.dest, KERNELBENCH_data.src, KERNELBENCH_BUFFER_LENGTH);
+}
+
+static void KERNELBENCH_memcpy_kernel(void)
+{
+  KERNEL_memcpy(KERNELBENCH_data.dest, KERNELBENCH_data.src, KERNELBENCH_BUFFER_LENGTH);
+}
+
+static void KERNELBENCH_memcpy_unaligned_library(void)
+{
+  UTILITIES_memcpy(KERNELBENCH_data.dest, (uint8_t*)KERNELBENCH_data.src + 1, KERNELBENCH_BUFFER_LENGTH);
+}
+
+static void KERNELBENCH_memcpy_unaligned_kernel(void)
+{
+  KERNEL_memcpy(KERNELBENCH_data.dest, (uint8_t*)KERNELBENCH_data.src + 1, KERNELBENCH_BUFFER_LENGTH);
+}
+
+static void KERNELBENCH_crc16_library(void)
+{
+  KERNELBENCH_data.crc = UTILITIES_crc16(0, KERNELBENCH_data.src, KERNELBENCH_BUFFER_LENGTH);
+}
+
+static void KERNELBENCH_crc16_kernel(void)
+{
+  KERNELBENCH_data.crc = KERNEL_crc16(0, KERNELBENCH_data.src, KERNELBENCH_BUFFER_LENGTH);
+}
+
+static void KERNELBENCH_fill_canvas_library(void)
+{
+  GFX2D_fill_canvas(&KERNELBENCH_data.gfx, 0x3080F0FFU);
+}
+
+static void KERNELBENCH_fill_canvas_kernel(void)
+{
+  GFX2D_fill_canvas(&KERNELBENCH_data.gfx_kernel, 0x3080F0FFU);
+}
+
+static void KERNELBENCH_filled_rectangle_library(void)
+{
+  GFX2D_draw_filled_rectangle(&KERNELBENCH_data.gfx, 13, 7, 201, 150, 0xF0C020FFU);
+}
+
+static void KERNELBENCH_filled_rectangle_kernel(void)
+{
+  GFX2D_draw_filled_rectangle(&KERNELBENCH_data.gfx_kernel, 13, 7, 201, 150, 0xF0C020FFU);
+}
+
+// The span cases start on an odd pixel, so that both the head and tail of
+// the word loops are taken.
+
+static __attribute__((noinline)) void KERNELBENCH_fill16_loop(void)
+{
+  uint16_t* dest = (uint16_t*)KERNELBENCH_data.dest + 1;
+
+  for (uint32_t i = 0; i < KERNELBENCH_BUFFER_LENGTH / 2U - 1U; i++)
+  {
+    dest[i] = 0x07E0U;
+  }
+}
+
+static void KERNELBENCH_fill16_kernel(void)
+{
+  KERNEL_fill16((uint16_t*)KERNELBENCH_data.dest + 1, 0x07E0U, KERNELBENCH_BUFFER_LENGTH / 2U - 1U);
+}
+
+static __attribute__((noinline)) void KERNELBENCH_fill32_loop(void)
+{
+  for (uint32_t i = 0; i < KERNELBENCH_BUFFER_LENGTH / 4U; i++)
+  {
+    KERNELBENCH_data.dest[i] = 0x00FF8000U;
+  }
+}
+
+static void KERNELBENCH_fill32_kernel(void)
+{
+  KERNEL_fill32(KERNELBENCH_data.dest, 0x00FF8000U, KERNELBENCH_BUFFER_LENGTH / 4U);
+}
+
+static __attribute__((noinline)) void KERNELBENCH_copy_rect16_loop(void)
+{
+  uint16_t* dest = &KERNELBENCH_data.frame[31 * KERNELBENCH_FRAME_WIDTH + 17];
+
+  for (uint32_t y = 0; y < KERNELBENCH_SPRITE_HEIGHT; y++)
+  {
+    for (uint32_t x = 0; x < KERNELBENCH_SPRITE_WIDTH; x++)
+    {
+      dest[y * KERNELBENCH_FRAME_WIDTH + x] = KERNELBENCH_data.sprite[y * KERNELBENCH_SPRITE_WIDTH + x];
+    }
+  }
+}
+
+static void KERNELBENCH_copy_rect16_kernel(void)
+{
+  KERNEL_copy_rect16(&KERNELBENCH_data.frame[31 * KERNELBENCH_FRAME_WIDTH + 17],
+                     KERNELBENCH_FRAME_WIDTH,
+                     KERNELBENCH_data.sprite,
+                     KERNELBENCH_SPRITE_WIDTH,
+                     KERNELBENCH_SPRITE_WIDTH,
+                     KERNELBENCH_SPRITE_HEIGHT);
+}
+
+// Same rounding as KERNEL_blend_rgb565, one channel at a time.
+
+static __attribute__((noinline)) void KERNELBENCH_blend_rgb565_loop(void)
+{
+  uint16_t* dest = (uint16_t*)KERNELBENCH_data.dest + 1;
+  uint16_t* src = (uint16_t*)KERNELBENCH_data.src + 1;
+  uint32_t alpha = KERNELBENCH_BLEND_ALPHA + (KERNELBENCH_BLEND_ALPHA >> 7);
+
+  for (uint32_t i = 0; i < KERNELBENCH_BUFFER_LENGTH / 2U - 1U; i++)
+  {
+    uint32_t red = ((src[i] >> 11) & 0x1FU) * alpha + ((dest[i] >> 11) & 0x1FU) * (256U - alpha);
+    uint32_t green = ((src[i] >> 5) & 0x3FU) * alpha + ((dest[i] >> 5) & 0x3FU) * (256U - alpha);
+    uint32_t blue = (src[i] & 0x1FU) * alpha + (dest[i] & 0x1FU) * (256U - alpha);
+
+    dest[i] = (uint16_t)(((red >> 8) << 11) | ((green >> 8) << 5) | (blue >> 8));
+  }
+}
+
+static void KERNELBENCH_blend_rgb565_kernel(void)
+{
+  KERNEL_blend_rgb565((uint16_t*)KERNELBENCH_data.dest + 1,
+                      (uint16_t*)KERNELBENCH_data.src + 1,
+                      KERNELBENCH_BUFFER_LENGTH / 2U - 1U,
+                      KERNELBENCH_BLEND_ALPHA);
+}
+
+static __attribute__((noinline)) void KERNELBENCH_blit_keyed16_loop(void)
+{
+  uint16_t* dest = (uint16_t*)KERNELBENCH_data.dest + 1;
+  uint16_t* src = (uint16_t*)KERNELBENCH_data.src + 1;
+
+  for (uint32_t i = 0; i < KERNELBENCH_BUFFER_LENGTH / 2U - 1U; i++)
+  {
+    if (src[i] != KERNELBENCH_COLOR_KEY)
+    {
+      dest[i] = src[i];
+    }
+  }
+}
+
+static void KERNELBENCH_blit_keyed16_kernel(void)
+{
+  KERNEL_blit_keyed16((uint16_t*)KERNELBENCH_data.dest + 1,
+                      (uint16_t*)KERNELBENCH_data.src + 1,
+                      KERNELBENCH_BUFFER_LENGTH / 2U - 1U,
+                      KERNELBENCH_COLOR_KEY);
+}
+
+static void KERNELBENCH_ws2812_library(void)
+{
+  WS2812_parse_grb_array(&KERNELBENCH_data.ws2812, KERNELBENCH_data.grb, sizeof(KERNELBENCH_data.grb));
+}
+
+static void KERNELBENCH_ws2812_kernel(void)
+{
+  KERNEL_ws2812_parse_grb_array(&KERNELBENCH_data.ws2812, KERNELBENCH_data.grb, sizeof(KERNELBENCH_data.grb));
+}
+
+static void KERNELBENCH_ticket_create_library(void)
+{
+  for (uint32_t i = 0; i < KERNELBENCH_TICKETS; i++)
+  {
+    UTIMER_ticket_create(&KERNELBENCH_data.utimer, &KERNELBENCH_data.tickets[i], KERNELBENCH_data.expirations_us[i]);
+  }
+}
+
+static void KERNELBENCH_ticket_create_kernel(void)
+{
+  for (uint32_t i = 0; i < KERNELBENCH_TICKETS; i++)
+  {
+    KERNEL_utimer_ticket_create(&KERNELBENCH_data.utimer, &KERNELBENCH_data.tickets[i], KERNELBENCH_data.expirations_us[i]);
+  }
+}
+
+// The tickets are created by the library, then time passes by some periods.
+
+static void KERNELBENCH_elapsed_time_prepare(void)
+{
+  KERNELBENCH_ticket_create_library();
+
+  KERNELBENCH_data.utimer.period_counter += 3;
+  KERNELBENCH_data.ticks = KERNELBENCH_data.utimer.ticks_per_period / 7U;
+}
+
+static void KERNELBENCH_elapsed_time_library(void)
+{
+  for (uint32_t i = 0; i < KERNELBENCH_TICKETS; i++)
+  {
+    KERNELBENCH_data.elapsed_us[i] = UTIMER_ticket_elapsed_time(&KERNELBENCH_data.utimer, &KERNELBENCH_data.tickets[i]);
+  }
+}
+
+static void KERNELBENCH_elapsed_time_kernel(void)
+{
+  for (uint32_t i = 0; i < KERNELBENCH_TICKETS; i++)
+  {
+    KERNELBENCH_data.elapsed_us[i] = KERNEL_utimer_ticket_elapsed_time(&KERNELBENCH_data.utimer, &KERNELBENCH_data.tickets[i]);
+  }
+}
+
+// Timers usually count to a power of two, e.g. the 24-bit SysTick, or to a
+// round period, e.g. 1 ms.
+
+static const KERNELBENCH_case_t KERNELBENCH_CASES[] =
+{
+  {"memcpy 4 KB", "UTILITIES_memcpy", KERNELBENCH_memcpy_library, KERNELBENCH_memcpy_kernel,
+   KERNELBENCH_data.dest, sizeof(KERNELBENCH_data.dest), 1},
+  {"memcpy 4 KB, unaligned", "UTILITIES_memcpy", KERNELBENCH_memcpy_unaligned_library, KERNELBENCH_memcpy_unaligned_kernel,
+   KERNELBENCH_data.dest, sizeof(KERNELBENCH_data.dest), 1},
+  {"crc16 4 KB", "UTILITIES_crc16", KERNELBENCH_crc16_library, KERNELBENCH_crc16_kernel,
+   &KERNELBENCH_data.crc, sizeof(KERNELBENCH_data.crc), 1},
+  {"fill canvas 320x240x16", "GFX2D handler", KERNELBENCH_fill_canvas_library, KERNELBENCH_fill_canvas_kernel,
+   KERNELBENCH_data.frame, sizeof(KERNELBENCH_data.frame), 1},
+  {"filled rectangle 201x150", "GFX2D handler", KERNELBENCH_filled_rectangle_library, KERNELBENCH_filled_rectangle_kernel,
+   KERNELBENCH_data.frame, sizeof(KERNELBENCH_data.frame), 1},
+  {"fill16 2047 pixels", "C loop", KERNELBENCH_fill16_loop, KERNELBENCH_fill16_kernel,
+   KERNELBENCH_data.dest, sizeof(KERNELBENCH_data.dest), 1},
+  {"fill32 1024 pixels", "C loop", KERNELBENCH_fill32_loop, KERNELBENCH_fill32_kernel,
+   KERNELBENCH_data.dest, sizeof(KERNELBENCH_data.dest), 1},
+  {"copy_rect16 64x48", "C loop", KERNELBENCH_copy_rect16_loop, KERNELBENCH_copy_rect16_kernel,
+   KERNELBENCH_data.frame, sizeof(KERNELBENCH_data.frame), 1},
+  {"blend_rgb565 2047 pixels", "C loop", KERNELBENCH_blend_rgb565_loop, KERNELBENCH_blend_rgb565_kernel,
+   KERNELBENCH_data.dest, sizeof(KERNELBENCH_data.dest), 1},
+  {"blit_keyed16 2047 pixels", "C loop", KERNELBENCH_blit_keyed16_loop, KERNELBENCH_blit_keyed16_kernel,
+   KERNELBENCH_data.dest, sizeof(KERNELBENCH_data.dest), 1},
+  {"ws2812 60 LEDs", "WS2812_parse_grb_array", KERNELBENCH_ws2812_library, KERNELBENCH_ws2812_kernel,
+   KERNELBENCH_data.ws2812_buffer, sizeof(KERNELBENCH_data.ws2812_buffer), 1},
+  {"ticket_create x64, 2^24 period", "UTIMER_ticket_create", KERNELBENCH_ticket_create_library, KERNELBENCH_ticket_create_kernel,
+   KERNELBENCH_data.tickets, sizeof(KERNELBENCH_data.tickets), 1ULL << 24},
+  {"ticket_create x64, 1 ms period", "UTIMER_ticket_create", KERNELBENCH_ticket_create_library, KERNELBENCH_ticket_create_kernel,
+   KERNELBENCH_data.tickets, sizeof(KERNELBENCH_data.tickets), 1000ULL * KERNELBENCH_TICKS_PER_MICROSECOND},
+  {"elapsed_time x64, 2^24 period", "UTIMER_ticket_elapsed", KERNELBENCH_elapsed_time_library, KERNELBENCH_elapsed_time_kernel,
+   KERNELBENCH_data.elapsed_us, sizeof(KERNELBENCH_data.elapsed_us), 1ULL << 24},
+  {"elapsed_time x64, 1 ms period", "UTIMER_ticket_elapsed", KERNELBENCH_elapsed_time_library, KERNELBENCH_elapsed_time_kernel,
+   KERNELBENCH_data.elapsed_us, sizeof(KERNELBENCH_data.elapsed_us), 1000ULL * KERNELBENCH_TICKS_PER_MICROSECOND},
+};
+
+static void KERNELBENCH_prepare(const KERNELBENCH_case_t* bench_case)
+{
+  KERNELBENCH_reset(bench_case->ticks_per_period);
+
+  if (bench_case->baseline_run == KERNELBENCH_elapsed_time_library)
+  {
+    KERNELBENCH_elapsed_time_prepare();
+  }
+}
+
+// Both versions run on the same inputs and must leave the same output.
+
+static bool KERNELBENCH_check_case(const KERNELBENCH_case_t* bench_case)
+{
+  KERNELBENCH_prepare(bench_case);
+  bench_case->baseline_run();
+  memcpy(KERNELBENCH_check, bench_case->output, bench_case->output_length);
+
+  KERNELBENCH_prepare(bench_case);
+  bench_case->kernel_run();
+
+  return memcmp(KERNELBENCH_check, bench_case->output, bench_case->output_length) == 0;
+}
+
+static uint32_t KERNELBENCH_time(void (*run)(void), uint32_t runs)
+{
+  uint32_t best = UINT32_MAX;
+
+  for (uint32_t i = 0; i < runs; i++)
+  {
+    uint32_t start = KERNELBENCH_timer_now();
+
+    run();
+
+    uint32_t elapsed = KERNELBENCH_timer_elapsed(start);
+
+    if (elapsed < best)
+    {
+      best = elapsed;
+    }
+  }
+
+  return best;
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t runs = KERNELBENCH_RUNS_DEFAULT;
+  uint32_t failures = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    bool has_value = (i + 1 < argc);
+
+    if ((strcmp(argv[i], "--runs") == 0) && has_value)
+    {
+      runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [--runs N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (runs == 0)
+  {
+    fprintf(stderr, "kernelbench: runs must be at least 1\n");
+    return 2;
+  }
+
+  KERNELBENCH_timer_initialize();
+
+  printf("%-32s %-24s %12s %12s %8s\n", "case", "baseline", "baseline " KERNELBENCH_UNIT, "KERNEL " KERNELBENCH_UNIT, "speedup");
+
+  for (uint32_t i = 0; i < sizeof(KERNELBENCH_CASES) / sizeof(KERNELBENCH_CASES[0]); i++)
+  {
+    const KERNELBENCH_case_t* bench_case = &KERNELBENCH_CASES[i];
+
+    if (!KERNELBENCH_check_case(bench_case))
+    {
+      printf("%-32s %-24s output differs\n", bench_case->name, bench_case->baseline);
+      failures++;
+      continue;
+    }
+
+    KERNELBENCH_prepare(bench_case);
+    uint32_t baseline = KERNELBENCH_time(bench_case->baseline_run, runs);
+
+    KERNELBENCH_prepare(bench_case);
+    uint32_t kernel = KERNELBENCH_time(bench_case->kernel_run, runs);
+
+    printf("%-32s %-24s %12lu %12lu %7.2fx\n",
+           bench_case->name,
+           bench_case->baseline,
+           (unsigned long)baseline,
+           (unsigned long)kernel,
+           (kernel != 0) ? (double)baseline / kernel : 0.0);
+  }
+
+  return (failures == 0) ? 0 : 1;
+}
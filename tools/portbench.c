@@ -0,0 +1,359 @@
+/*******************************************************************************
+ *
+ *  Benchmark of the SHIFTPISO and SHIFTSIPO port-level shifters against the
+ *  per-pin HAL sequence of the bit-banged modules, on a simulated GPIO port,
+ *  reporting the bits per second of each:
+ *
+ *   portbench [--registers N] [--runs N]
+ *
+ *  The shift order of both shifters is first checked against 74HC595 and
+ *  74HC165 chain models. The timed runs write and read a plain port
+ *  register, through HAL functions which are not inlined, as they would be
+ *  on a target. Build with the library stand-ins in sim/ (see sim/JLibSim.h):
+ *
+ *   cc -std=gnu11 -O2 -I. -Isim tools/portbench.c src/ShiftPisoPort.c
+ *      src/ShiftSipoPort.c sim/SimLibrary.c
+ *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "JLib.h"
+
+#define PORTBENCH_REGISTERS_MAX           4096U
+#define PORTBENCH_RUN_SECONDS             0.2
+
+#define PORTBENCH_CLOCK                   (1UL << 3)
+#define PORTBENCH_LATCH                   (1UL << 4)
+#define PORTBENCH_SERIAL                  (1UL << 5)
+#define PORTBENCH_SERIAL_PIN              6U
+
+/*
+ * Simulated GPIO port. Writes go through the output register, and reads
+ * return it with the serial output of the input chain. While checking, the
+ * chain models are clocked on every write.
+ */
+
+static struct
+{
+  volatile uint32_t port;
+  bool modeled;
+  uint16_t register_count;
+  bool sipo_stages[PORTBENCH_REGISTERS_MAX];
+  bool sipo_outputs[PORTBENCH_REGISTERS_MAX];
+  bool piso_inputs[PORTBENCH_REGISTERS_MAX];
+  bool piso_stages[PORTBENCH_REGISTERS_MAX];
+}
+PORTBENCH_gpio;
+
+// 74HC595 chain, shifting towards the last stage on the rising shift clock
+// and copying to the outputs on the rising register clock (latch pin).
+// 74HC165 chain, loading the inputs while SH/LD (latch pin) is low and
+// shifting towards stage 0, the serial output, on the rising clock.
+
+static void PORTBENCH_model(uint32_t previous, uint32_t port)
+{
+  uint32_t rising = port & ~previous;
+  uint16_t count = PORTBENCH_gpio.register_count;
+
+  if ((rising & PORTBENCH_CLOCK) != 0)
+  {
+    memmove(&PORTBENCH_gpio.sipo_stages[1], &PORTBENCH_gpio.sipo_stages[0], (size_t)(count - 1U) * sizeof(bool));
+    PORTBENCH_gpio.sipo_stages[0] = (port & PORTBENCH_SERIAL) != 0;
+  }
+
+  if ((rising & PORTBENCH_LATCH) != 0)
+  {
+    memcpy(PORTBENCH_gpio.sipo_outputs, PORTBENCH_gpio.sipo_stages, count * sizeof(bool));
+  }
+
+  if ((port & PORTBENCH_LATCH) == 0)
+  {
+    memcpy(PORTBENCH_gpio.piso_stages, PORTBENCH_gpio.piso_inputs, count * sizeof(bool));
+  }
+  else if ((rising & PORTBENCH_CLOCK) != 0)
+  {
+    memmove(&PORTBENCH_gpio.piso_stages[0], &PORTBENCH_gpio.piso_stages[1], (size_t)(count - 1U) * sizeof(bool));
+    PORTBENCH_gpio.piso_stages[count - 1U] = false;
+  }
+}
+
+__attribute__((noinline)) static void PORTBENCH_port_write(uint32_t set_mask, uint32_t clear_mask)
+{
+  uint32_t previous = PORTBENCH_gpio.port;
+
+  PORTBENCH_gpio.port = (previous & ~clear_mask) | set_mask;
+
+  if (PORTBENCH_gpio.modeled)
+  {
+    PORTBENCH_model(previous, PORTBENCH_gpio.port);
+  }
+}
+
+__attribute__((noinline)) static uint32_t PORTBENCH_port_read(void)
+{
+  return PORTBENCH_gpio.port | ((uint32_t)PORTBENCH_gpio.piso_stages[0] << PORTBENCH_SERIAL_PIN);
+}
+
+// Per-pin HALs of the bit-banged modules, each a port write or read.
+
+__attribute__((noinline)) static void PORTBENCH_set_clock(bool value)
+{
+  PORTBENCH_port_write(value ? PORTBENCH_CLOCK : 0, value ? 0 : PORTBENCH_CLOCK);
+}
+
+__attribute__((noinline)) static void PORTBENCH_set_latch(bool value)
+{
+  PORTBENCH_port_write(value ? PORTBENCH_LATCH : 0, value ? 0 : PORTBENCH_LATCH);
+}
+
+__attribute__((noinline)) static void PORTBENCH_set_serial(bool value)
+{
+  PORTBENCH_port_write(value ? PORTBENCH_SERIAL : 0, value ? 0 : PORTBENCH_SERIAL);
+}
+
+__attribute__((noinline)) static bool PORTBENCH_get_serial(void)
+{
+  return (PORTBENCH_port_read() >> PORTBENCH_SERIAL_PIN) & 1U;
+}
+
+// The per-pin sequences of the bit-banged SHIFTSIPO and SHIFTPISO tasks, run
+// to completion without the task state machine.
+
+static void PORTBENCH_sipo_pins(uint8_t* buffer, uint16_t register_count)
+{
+  for (uint16_t i = 0; i < register_count; i++)
+  {
+    PORTBENCH_set_clock(false);
+    PORTBENCH_set_serial(((buffer[i >> 3] >> (i & 7U)) & 1U) != 0);
+    PORTBENCH_set_clock(true);
+  }
+
+  PORTBENCH_set_clock(false);
+  PORTBENCH_set_latch(true);
+  PORTBENCH_set_latch(false);
+}
+
+static void PORTBENCH_piso_pins(uint8_t* buffer, uint16_t register_count)
+{
+  // SH/LD is active low: latching drives the latch pin low.
+
+  PORTBENCH_set_clock(false);
+  PORTBENCH_set_latch(false);
+  PORTBENCH_set_clock(true);
+  PORTBENCH_set_latch(true);
+  PORTBENCH_set_clock(false);
+
+  UTILITIES_memclear(buffer, (uint32_t)((register_count + 7U) / 8U));
+
+  for (uint16_t i = 0; i < register_count; i++)
+  {
+    buffer[i >> 3] |= (uint8_t)(PORTBENCH_get_serial() << (i & 7U));
+    PORTBENCH_set_clock(true);
+    PORTBENCH_set_clock(false);
+  }
+}
+
+static SHIFTSIPO_port_t PORTBENCH_sipo_port;
+static SHIFTPISO_port_t PORTBENCH_piso_port;
+
+static void PORTBENCH_sipo_port_write(uint8_t* buffer, uint16_t register_count)
+{
+  SHIFTSIPO_port_write(&PORTBENCH_sipo_port, buffer, register_count);
+}
+
+static void PORTBENCH_piso_port_read(uint8_t* buffer, uint16_t register_count)
+{
+  SHIFTPISO_port_read(&PORTBENCH_piso_port, buffer, register_count);
+}
+
+typedef struct
+{
+  const char* name;
+  void (*run)(uint8_t*, uint16_t);
+  bool sipo;
+}
+PORTBENCH_shifter_t;
+
+static const PORTBENCH_shifter_t PORTBENCH_SHIFTERS[] =
+{
+  {"SIPO per-pin HAL", PORTBENCH_sipo_pins, true},
+  {"SIPO port shifter", PORTBENCH_sipo_port_write, true},
+  {"PISO per-pin HAL", PORTBENCH_piso_pins, false},
+  {"PISO port shifter", PORTBENCH_piso_port_read, false},
+};
+
+static double PORTBENCH_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// Checks that SIPO bit i of the buffer ends up in register i counted from
+// the end of the chain, and that PISO bit i holds the input of register i.
+
+static bool PORTBENCH_check(const PORTBENCH_shifter_t* shifter, uint16_t register_count)
+{
+  static uint8_t buffer[PORTBENCH_REGISTERS_MAX / 8U];
+  uint16_t length = (uint16_t)((register_count + 7U) / 8U);
+
+  // The register clock idles low, the SH/LD pin high.
+
+  memset(&PORTBENCH_gpio, 0, sizeof(PORTBENCH_gpio));
+  PORTBENCH_gpio.port = shifter->sipo ? 0 : PORTBENCH_LATCH;
+  PORTBENCH_gpio.modeled = true;
+  PORTBENCH_gpio.register_count = register_count;
+
+  for (uint16_t i = 0; i < length; i++)
+  {
+    buffer[i] = (uint8_t)(i * 37U + 0x5AU);
+  }
+
+  for (uint16_t i = 0; i < register_count; i++)
+  {
+    PORTBENCH_gpio.piso_inputs[i] = ((buffer[i >> 3] >> (i & 7U)) & 1U) != 0;
+  }
+
+  if (shifter->sipo)
+  {
+    shifter->run(buffer, register_count);
+
+    for (uint16_t i = 0; i < register_count; i++)
+    {
+      // The first bit shifted in ends up in the last stage.
+
+      if (PORTBENCH_gpio.sipo_outputs[register_count - 1U - i] != (((buffer[i >> 3] >> (i & 7U)) & 1U) != 0))
+      {
+        fprintf(stderr, "portbench: %s: register %u does not match\n", shifter->name, i);
+        return false;
+      }
+    }
+  }
+  else
+  {
+    memset(buffer, 0, length);
+    shifter->run(buffer, register_count);
+
+    for (uint16_t i = 0; i < register_count; i++)
+    {
+      if ((((buffer[i >> 3] >> (i & 7U)) & 1U) != 0) != PORTBENCH_gpio.piso_inputs[i])
+      {
+        fprintf(stderr, "portbench: %s: register %u does not match\n", shifter->name, i);
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// Best of several runs, in bits per second.
+
+static double PORTBENCH_measure(const PORTBENCH_shifter_t* shifter, uint16_t register_count, uint32_t runs)
+{
+  static uint8_t buffer[PORTBENCH_REGISTERS_MAX / 8U];
+  double best = 0;
+
+  memset(&PORTBENCH_gpio, 0, sizeof(PORTBENCH_gpio));
+  PORTBENCH_gpio.port = shifter->sipo ? 0 : PORTBENCH_LATCH;
+
+  for (uint16_t i = 0; i < sizeof(buffer); i++)
+  {
+    buffer[i] = (uint8_t)(i * 37U + 0x5AU);
+  }
+
+  for (uint32_t run = 0; run < runs; run++)
+  {
+    uint64_t transfers = 0;
+    double start = PORTBENCH_now();
+    double elapsed;
+
+    do
+    {
+      for (uint16_t i = 0; i < 64U; i++)
+      {
+        shifter->run(buffer, register_count);
+      }
+
+      transfers += 64U;
+      elapsed = PORTBENCH_now() - start;
+    }
+    while (elapsed < PORTBENCH_RUN_SECONDS);
+
+    best = UTILS_MAX(best, (double)transfers * register_count / elapsed);
+  }
+
+  return best;
+}
+
+int main(int argc, char** argv)
+{
+  uint16_t register_count = 256;
+  uint32_t runs = 5;
+
+  for (int i = 1; i < argc; i++)
+  {
+    bool has_value = (i + 1 < argc);
+
+    if ((strcmp(argv[i], "--registers") == 0) && has_value)
+    {
+      register_count = (uint16_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--runs") == 0) && has_value)
+    {
+      runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [--registers N] [--runs N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if ((register_count == 0) || (register_count > PORTBENCH_REGISTERS_MAX) || (runs == 0))
+  {
+    fprintf(stderr, "portbench: registers must be 1 to %u and runs at least 1\n", PORTBENCH_REGISTERS_MAX);
+    return 2;
+  }
+
+  SHIFTSIPO_port_initialize(&PORTBENCH_sipo_port,
+                            PORTBENCH_CLOCK,
+                            PORTBENCH_LATCH,
+                            PORTBENCH_SERIAL,
+                            PORTBENCH_port_write);
+
+  SHIFTPISO_port_initialize(&PORTBENCH_piso_port,
+                            PORTBENCH_CLOCK,
+                            PORTBENCH_LATCH,
+                            PORTBENCH_SERIAL_PIN,
+                            false,
+                            PORTBENCH_port_write,
+                            PORTBENCH_port_read);
+
+  for (size_t i = 0; i < sizeof(PORTBENCH_SHIFTERS) / sizeof(PORTBENCH_SHIFTERS[0]); i++)
+  {
+    if (!PORTBENCH_check(&PORTBENCH_SHIFTERS[i], register_count))
+    {
+      return 1;
+    }
+  }
+
+  printf("%u registers, best of %u runs\n", register_count, runs);
+
+  for (size_t i = 0; i < sizeof(PORTBENCH_SHIFTERS) / sizeof(PORTBENCH_SHIFTERS[0]); i++)
+  {
+    printf("  %-18s %8.1f Mbit/s\n",
+           PORTBENCH_SHIFTERS[i].name,
+           PORTBENCH_measure(&PORTBENCH_SHIFTERS[i], register_count, runs) * 1e-6);
+  }
+
+  return 0;
+}
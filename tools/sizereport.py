@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""
+Host tool reporting the flash and RAM used per module.
+
+  map      Reads a GNU ld map file (-Wl,-Map=app.map) and reports what each
+           object file or archive member contributes to the linked image.
+           This is the size of a product configuration, after --gc-sections.
+
+  objects  Runs size on object files and archives, e.g. a build of src/ with a
+           product JLIB_CONFIG_FILE, and reports each object before linking.
+
+Flash is code, read-only data and initialized data; RAM is initialized and
+zero-initialized data. --flash-limit and --ram-limit, e.g. 32K, make the tool
+fail when a total exceeds a part.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+FLASH_PREFIXES = (".text", ".rodata", ".ARM.extab", ".ARM.exidx", ".init", ".fini",
+                  ".ctors", ".dtors", ".preinit_array", ".init_array", ".fini_array",
+                  ".isr_vector", ".vectors", ".glue_7", ".vfp11_veneer", ".v4_bx",
+                  ".iplt", ".eh_frame", ".gcc_except_table", ".literal")
+DATA_PREFIXES = (".data", ".sdata", ".ramfunc", ".got")
+ZERO_PREFIXES = (".bss", ".sbss", ".noinit", "COMMON", ".tbss")
+
+INPUT_SECTION = re.compile(r"^ (\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+MEMBER = re.compile(r"^(.*)\((.+)\)$")
+
+
+def module_name(path):
+    """Names a module after its object file, e.g. JLib_arm_cortexm0.a(SerSpi.o)
+    or build/src/WebServer.c.o both give the module of the object."""
+    match = MEMBER.match(path)
+    if match:
+        path = match.group(2)
+    name = os.path.basename(path.strip())
+    for suffix in (".o", ".obj"):
+        if name.endswith(suffix):
+            name = name[:-len(suffix)]
+    for suffix in (".c", ".cpp", ".s", ".S"):
+        if name.endswith(suffix):
+            name = name[:-len(suffix)]
+    return name
+
+
+def classify(section):
+    """Returns (flash, ram) factors of an input section."""
+    if section.startswith(FLASH_PREFIXES):
+        return 1, 0
+    if section.startswith(DATA_PREFIXES):
+        return 1, 1
+    if section.startswith(ZERO_PREFIXES):
+        return 0, 1
+    return 0, 0
+
+
+def read_map(path):
+    """Yields (module, flash, ram) for each input section of a GNU ld map."""
+    with open(path) as f:
+        lines = f.read().splitlines()
+
+    try:
+        start = lines.index("Linker script and memory map") + 1
+    except ValueError:
+        raise ValueError("%s is not a GNU ld map file" % path)
+
+    section = None
+    for line in lines[start:]:
+        if line.startswith(" *") or not line.startswith(" "):
+            # Fill, linker script statements or an output section.
+            section = None
+            continue
+        match = INPUT_SECTION.match(line)
+        if match is None:
+            # Long input section names are followed by the address on the
+            # next line.
+            words = line.split()
+            section = words[0] if len(words) == 1 else None
+            continue
+        name = match.group(1) or section
+        section = None
+        if name is None:
+            continue
+        address, size, source = int(match.group(2), 16), int(match.group(3), 16), match.group(4)
+        if size == 0 or address == 0 or source.startswith("load address"):
+            continue
+        flash, ram = classify(name)
+        if flash or ram:
+            yield module_name(source), size * flash, size * ram
+
+
+def read_objects(paths, size_tool):
+    """Yields (module, flash, ram) for each object, using the Berkeley format
+    of size."""
+    try:
+        output = subprocess.run([size_tool, "-B"] + paths, check=True,
+                                stdout=subprocess.PIPE, universal_newlines=True).stdout
+    except (OSError, subprocess.CalledProcessError) as error:
+        raise ValueError("%s failed: %s" % (size_tool, error))
+
+    for line in output.splitlines()[1:]:
+        words = line.split(None, 5)
+        if len(words) < 6:
+            continue
+        text, data, bss = int(words[0]), int(words[1]), int(words[2])
+        source = words[5].split(" (ex ")[0]
+        yield module_name(source), text + data, data + bss
+
+
+def parse_size(text):
+    match = re.match(r"^(\d+)([kKmM]?)$", text)
+    if match is None:
+        raise argparse.ArgumentTypeError("expected a size such as 32768 or 32K, got %r" % text)
+    scale = {"": 1, "k": 1024, "m": 1024 * 1024}[match.group(2).lower()]
+    return int(match.group(1)) * scale
+
+
+def report(entries, flash_limit, ram_limit):
+    modules = {}
+    for module, flash, ram in entries:
+        totals = modules.setdefault(module, [0, 0])
+        totals[0] += flash
+        totals[1] += ram
+
+    width = max([len(module) for module in modules] + [len("Module")])
+    print("%-*s %10s %10s" % (width, "Module", "Flash", "RAM"))
+    for module, (flash, ram) in sorted(modules.items(), key=lambda item: (-item[1][0], -item[1][1])):
+        print("%-*s %10u %10u" % (width, module, flash, ram))
+
+    flash_total = sum(totals[0] for totals in modules.values())
+    ram_total = sum(totals[1] for totals in modules.values())
+    print("%-*s %10u %10u" % (width, "Total", flash_total, ram_total))
+
+    fits = True
+    if flash_limit is not None and flash_total > flash_limit:
+        print("flash exceeds %u bytes by %u" % (flash_limit, flash_total - flash_limit), file=sys.stderr)
+        fits = False
+    if ram_limit is not None and ram_total > ram_limit:
+        print("RAM exceeds %u bytes by %u" % (ram_limit, ram_total - ram_limit), file=sys.stderr)
+        fits = False
+    return fits
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command")
+    commands.required = True
+
+    from_map = commands.add_parser("map", help="report from a GNU ld map file")
+    from_map.add_argument("map_file")
+
+    from_objects = commands.add_parser("objects", help="report from object files and archives")
+    from_objects.add_argument("objects", nargs="+")
+    from_objects.add_argument("--size", default="arm-none-eabi-size",
+                              help="size tool, default arm-none-eabi-size")
+
+    for command in (from_map, from_objects):
+        command.add_argument("--flash-limit", type=parse_size)
+        command.add_argument("--ram-limit", type=parse_size)
+
+    args = parser.parse_args()
+
+    try:
+        if args.command == "map":
+            entries = list(read_map(args.map_file))
+        else:
+            entries = list(read_objects(args.objects, args.size))
+    except (OSError, ValueError) as error:
+        sys.exit("sizereport: %s" % error)
+
+    if not report(entries, args.flash_limit, args.ram_limit):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
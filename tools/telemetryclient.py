@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""
+Host client for the WEBTELEMETRY module.
+
+Connects to a telemetry route, prints the DESCRIBE message and the first
+update, then measures the update rate (counting gaps in the update sequence)
+and the latency from a WRITE to the first update carrying the written value:
+
+  telemetryclient.py [--host 127.0.0.1] [--port 8080] [--path /telemetry]
+                     [--seconds 2] [--writes 200]
+
+The latency is measured on the first writable integer entry. To run against
+the loopback server in tools/webload.c:
+
+  webload --serve --port 8080 --period 1000 &
+  telemetryclient.py --port 8080
+"""
+
+import argparse
+import base64
+import hashlib
+import os
+import socket
+import struct
+import sys
+import time
+
+WEBSOCKET_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+OPCODE_BINARY = 0x2
+OPCODE_CLOSE = 0x8
+OPCODE_PING = 0x9
+OPCODE_PONG = 0xA
+
+MESSAGE_DESCRIBE = 0
+MESSAGE_UPDATE = 1
+MESSAGE_WRITE = 2
+
+UPDATE_HEADER_FORMAT = "<BBHI"
+WRITE_FORMAT = "<BBHI"
+
+# TERVAR_var_type_t, as struct formats of the 4 byte wire value.
+VALUE_FORMATS = ("<I", "<i", "<I", "<i", "<I", "<i", "<f")
+TYPE_NAMES = ("uint8", "int8", "uint16", "int16", "uint32", "int32", "float")
+TYPE_RANGES = ((0, 0xFF), (-0x80, 0x7F), (0, 0xFFFF), (-0x8000, 0x7FFF),
+               (0, 0xFFFFFFFF), (-0x80000000, 0x7FFFFFFF))
+
+
+class Connection:
+    """WebSocket client connection, with the frames received so far."""
+
+    def __init__(self, host, port, path):
+        self.sock = socket.create_connection((host, port), timeout=5)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        key = base64.b64encode(os.urandom(16)).decode()
+        self.sock.sendall(("GET %s HTTP/1.1\r\n"
+                           "Host: %s:%u\r\n"
+                           "Upgrade: websocket\r\n"
+                           "Connection: Upgrade\r\n"
+                           "Sec-WebSocket-Key: %s\r\n"
+                           "Sec-WebSocket-Version: 13\r\n\r\n" % (path, host, port, key)).encode())
+
+        self.buffer = b""
+        while b"\r\n\r\n" not in self.buffer:
+            self.receive()
+        head, self.buffer = self.buffer.split(b"\r\n\r\n", 1)
+
+        accept = base64.b64encode(hashlib.sha1((key + WEBSOCKET_GUID).encode()).digest())
+        status = head.split(b"\r\n")[0]
+        if b" 101 " not in status + b" ":
+            raise ConnectionError("upgrade refused: %s" % status.decode(errors="replace"))
+        if accept not in head:
+            raise ConnectionError("invalid Sec-WebSocket-Accept")
+
+    def receive(self):
+        data = self.sock.recv(65536)
+        if not data:
+            raise ConnectionError("connection closed by the server")
+        self.buffer += data
+
+    def frame(self):
+        """Returns the next (opcode, payload). Server frames are unmasked."""
+        while True:
+            if len(self.buffer) >= 2:
+                opcode = self.buffer[0] & 0x0F
+                length = self.buffer[1] & 0x7F
+                header_length = 2
+                if length == 126:
+                    header_length = 4
+                    if len(self.buffer) >= header_length:
+                        length = struct.unpack_from(">H", self.buffer, 2)[0]
+                elif length == 127:
+                    header_length = 10
+                    if len(self.buffer) >= header_length:
+                        length = struct.unpack_from(">Q", self.buffer, 2)[0]
+                if len(self.buffer) >= header_length + length:
+                    payload = self.buffer[header_length:header_length + length]
+                    self.buffer = self.buffer[header_length + length:]
+                    return opcode, payload
+            self.receive()
+
+    def send(self, opcode, payload):
+        """Sends a masked frame, as required from clients."""
+        mask = os.urandom(4)
+        header = bytes([0x80 | opcode])
+        if len(payload) < 126:
+            header += bytes([0x80 | len(payload)])
+        else:
+            header += bytes([0x80 | 126]) + struct.pack(">H", len(payload))
+        masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+        self.sock.sendall(header + mask + masked)
+
+    def message(self):
+        """Returns the payload of the next binary frame, answering pings."""
+        while True:
+            opcode, payload = self.frame()
+            if opcode == OPCODE_BINARY:
+                return payload
+            if opcode == OPCODE_PING:
+                self.send(OPCODE_PONG, payload)
+            elif opcode == OPCODE_CLOSE:
+                raise ConnectionError("closed by the server")
+
+
+def parse_describe(payload):
+    """Returns [(description, type, read_only)] from a DESCRIBE message."""
+    if len(payload) < 2 or payload[0] != MESSAGE_DESCRIBE:
+        raise ValueError("expected a DESCRIBE message")
+    entries = []
+    offset = 2
+    for _ in range(payload[1]):
+        flags, length = payload[offset], payload[offset + 1]
+        description = payload[offset + 2:offset + 2 + length].decode(errors="replace")
+        entries.append((description, flags >> 4, bool(flags & 1)))
+        offset += 2 + length
+    return entries
+
+
+def parse_update(payload, entries):
+    """Returns (sequence, timestamp_us, values) from an UPDATE message."""
+    message, count, sequence, timestamp = struct.unpack_from(UPDATE_HEADER_FORMAT, payload)
+    header_length = struct.calcsize(UPDATE_HEADER_FORMAT)
+    if message != MESSAGE_UPDATE or count != len(entries) or len(payload) != header_length + 4 * count:
+        raise ValueError("malformed UPDATE message")
+    values = [struct.unpack_from(VALUE_FORMATS[entry[1]], payload, header_length + 4 * i)[0]
+              for i, entry in enumerate(entries)]
+    return sequence, timestamp, values
+
+
+def measure_rate(connection, entries, seconds):
+    """Returns (updates per second, sequence gaps, skipped updates)."""
+    count = 0
+    gaps = 0
+    skipped = 0
+    previous = None
+    start = time.perf_counter()
+    while time.perf_counter() - start < seconds:
+        sequence, _, _ = parse_update(connection.message(), entries)
+        if previous is not None and sequence != (previous + 1) & 0xFFFF:
+            gaps += 1
+            skipped += (sequence - previous - 1) & 0xFFFF
+        previous = sequence
+        count += 1
+    return count / (time.perf_counter() - start), gaps, skipped
+
+
+def measure_latency(connection, entries, index, writes):
+    """Returns the sorted write to update latencies, in microseconds."""
+    low, high = TYPE_RANGES[entries[index][1]]
+    latencies = []
+    for k in range(writes):
+        value = low + (k + 1) % (high - low + 1)
+        start = time.perf_counter()
+        connection.send(OPCODE_BINARY, struct.pack(WRITE_FORMAT, MESSAGE_WRITE, index, 0, value & 0xFFFFFFFF))
+        while parse_update(connection.message(), entries)[2][index] != value:
+            pass
+        latencies.append((time.perf_counter() - start) * 1e6)
+    return sorted(latencies)
+
+
+def percentile(values, fraction):
+    return values[min(len(values) - 1, int(len(values) * fraction))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--path", default="/telemetry")
+    parser.add_argument("--seconds", type=float, default=2.0, help="duration of the rate measurement")
+    parser.add_argument("--writes", type=int, default=200, help="number of writes for the latency measurement")
+    args = parser.parse_args()
+
+    try:
+        connection = Connection(args.host, args.port, args.path)
+        entries = parse_describe(connection.message())
+    except (OSError, ValueError) as error:
+        print("telemetryclient: %s" % error, file=sys.stderr)
+        return 1
+
+    print("%u entries:" % len(entries))
+    for index, (description, var_type, read_only) in enumerate(entries):
+        type_name = TYPE_NAMES[var_type] if var_type < len(TYPE_NAMES) else "type %u" % var_type
+        print("  %2u %-24s %-7s %s" % (index, description, type_name, "read-only" if read_only else "writable"))
+
+    try:
+        sequence, timestamp, values = parse_update(connection.message(), entries)
+        print("first update: sequence %u at %u us: %s" % (sequence, timestamp, values))
+
+        rate, gaps, skipped = measure_rate(connection, entries, args.seconds)
+        print("updates: %.0f/s, %u sequence gaps (%u updates skipped)" % (rate, gaps, skipped))
+
+        writable = [i for i, entry in enumerate(entries) if not entry[2] and entry[1] < len(TYPE_RANGES)]
+        if writable and args.writes > 0:
+            latencies = measure_latency(connection, entries, writable[0], args.writes)
+            print("write to update latency on %s: median %.0f us, p99 %.0f us, max %.0f us" %
+                  (entries[writable[0]][0], percentile(latencies, 0.5), percentile(latencies, 0.99), latencies[-1]))
+
+        connection.send(OPCODE_PING, b"telemetryclient")
+        while connection.frame() != (OPCODE_PONG, b"telemetryclient"):
+            pass
+
+        connection.send(OPCODE_CLOSE, struct.pack(">H", 1000))
+        while connection.frame()[0] != OPCODE_CLOSE:
+            pass
+    except (OSError, ValueError) as error:
+        print("telemetryclient: %s" % error, file=sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
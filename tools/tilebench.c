@@ -0,0 +1,339 @@
+/*******************************************************************************
+ *
+ *  Benchmark of the LINUX_tiles renderer. Renders an animated gauge dashboard
+ *  with 1, 2, 4, and 8 threads and reports the frames per second of each
+ *  resolution:
+ *
+ *   tilebench [--frames N] [--tile WxH] [--size WxH ...] [--fb /dev/fb0 |
+ *             --shm /name]
+ *
+ *  Without --fb or --shm, frames are rendered into memory at 800x480 and
+ *  1280x800, RGB565. Build with the library stand-ins in sim/ (see
+ *  sim/JLibSim.h). They draw with plain C loops, hence, the frame rates are
+ *  comparable between thread counts, not with the library archive:
+ *
+ *   cc -std=gnu11 -O2 -pthread -I. -Ilinux -Isim tools/tilebench.c
+ *      src/Gfx2dClip.c src/Gfx2dList.c src/Kernel.c linux/LinuxDisplay.c
+ *      linux/LinuxTiles.c sim/SimGfx2d.c sim/SimLibrary.c -lm -lrt
+ *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "JLibLinux.h"
+
+#define TILEBENCH_SIZES_MAX               8U
+#define TILEBENCH_GAUGES_X                4
+#define TILEBENCH_GAUGES_Y                2
+
+static const uint8_t TILEBENCH_THREADS[] = {1, 2, 4, 8};
+
+static uint8_t TILEBENCH_bytes_per_pixel;
+
+static uint32_t TILEBENCH_rgba_to_pixel(uint32_t rgba)
+{
+  GFX2D_rgba_t color;
+
+  color.all = rgba;
+
+  switch (TILEBENCH_bytes_per_pixel)
+  {
+    case 2:
+      return ((uint32_t)(color.r >> 3) << 11) | ((uint32_t)(color.g >> 2) << 5) | (color.b >> 3);
+
+    case 1:
+      return (color.r & 0xE0U) | ((color.g >> 3) & 0x1CU) | (color.b >> 6);
+
+    default:
+      return ((uint32_t)color.r << 16) | ((uint32_t)color.g << 8) | color.b;
+  }
+}
+
+static uint32_t TILEBENCH_rgb(uint8_t r, uint8_t g, uint8_t b)
+{
+  GFX2D_rgba_t color;
+
+  color.all = 0;
+  color.r = r;
+  color.g = g;
+  color.b = b;
+  color.a = 0xFF;
+
+  return color.all;
+}
+
+static double TILEBENCH_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// Records a dashboard of gauges, each with a panel, dial, ticks, needle and
+// value, the needles moving with the frame number.
+
+static void TILEBENCH_record(GFX2DLIST_instance_t* list, int16_t width, int16_t height, uint32_t frame)
+{
+  GFX2DFONT_font_t* font = (GFX2DFONT_font_t*)&GFX2DFONT_DEFAULT_FONT;
+  int16_t cell_width = (int16_t)(width / TILEBENCH_GAUGES_X);
+  int16_t cell_height = (int16_t)(height / TILEBENCH_GAUGES_Y);
+  int16_t radius = (int16_t)(UTILS_MIN(cell_width, cell_height) * 2 / 5);
+  char label[16];
+
+  GFX2DLIST_clear(list);
+  GFX2DLIST_fill_canvas(list, TILEBENCH_rgb(16, 20, 28));
+
+  for (int gy = 0; gy < TILEBENCH_GAUGES_Y; gy++)
+  {
+    for (int gx = 0; gx < TILEBENCH_GAUGES_X; gx++)
+    {
+      int16_t x = (int16_t)(gx * cell_width);
+      int16_t y = (int16_t)(gy * cell_height);
+      int16_t cx = (int16_t)(x + cell_width / 2);
+      int16_t cy = (int16_t)(y + cell_height / 2);
+      double value = 0.5 + 0.5 * sin((double)frame * 0.05 + gx + gy * TILEBENCH_GAUGES_X);
+      double angle = (0.75 + 1.5 * value) * M_PI;
+
+      GFX2DLIST_draw_filled_rounded_rectangle(list, (int16_t)(x + 4), (int16_t)(y + 4),
+                                              (int16_t)(cell_width - 8), (int16_t)(cell_height - 8),
+                                              12, TILEBENCH_rgb(36, 44, 60));
+      GFX2DLIST_draw_filled_circle(list, cx, cy, radius, TILEBENCH_rgb(24, 28, 36));
+      GFX2DLIST_draw_circle(list, cx, cy, radius, TILEBENCH_rgb(120, 140, 170));
+
+      for (int tick = 0; tick <= 10; tick++)
+      {
+        double tick_angle = (0.75 + 0.15 * tick) * M_PI;
+
+        GFX2DLIST_draw_line(list,
+                            (int16_t)(cx + cos(tick_angle) * radius * 0.85),
+                            (int16_t)(cy + sin(tick_angle) * radius * 0.85),
+                            (int16_t)(cx + cos(tick_angle) * radius),
+                            (int16_t)(cy + sin(tick_angle) * radius),
+                            TILEBENCH_rgb(200, 200, 210));
+      }
+
+      GFX2DLIST_draw_filled_triangle(list,
+                                     (int16_t)(cx + cos(angle) * radius * 0.9),
+                                     (int16_t)(cy + sin(angle) * radius * 0.9),
+                                     (int16_t)(cx + cos(angle + M_PI / 2) * 4),
+                                     (int16_t)(cy + sin(angle + M_PI / 2) * 4),
+                                     (int16_t)(cx - cos(angle + M_PI / 2) * 4),
+                                     (int16_t)(cy - sin(angle + M_PI / 2) * 4),
+                                     TILEBENCH_rgb(240, 80, 40));
+      GFX2DLIST_draw_filled_circle(list, cx, cy, 6, TILEBENCH_rgb(220, 220, 220));
+
+      snprintf(label, sizeof(label), "%3d%%", (int)(value * 100.0));
+      GFX2DLIST_draw_text(list, font, (int16_t)(cx - 24), (int16_t)(cy + radius / 2), 3, 3,
+                          TILEBENCH_rgb(230, 230, 240), label);
+    }
+  }
+}
+
+static bool TILEBENCH_parse_size(const char* text, int16_t* width, int16_t* height)
+{
+  int w;
+  int h;
+
+  if ((sscanf(text, "%dx%d", &w, &h) != 2) || (w < 1) || (h < 1) || (w > INT16_MAX) || (h > INT16_MAX))
+  {
+    fprintf(stderr, "tilebench: expected WxH, got %s\n", text);
+    return false;
+  }
+
+  *width = (int16_t)w;
+  *height = (int16_t)h;
+
+  return true;
+}
+
+static bool TILEBENCH_run(LINUX_display_t* display, uint32_t frames, int16_t tile_width, int16_t tile_height)
+{
+  static GFX2DLIST_command_t commands[512];
+  static char text[512];
+  GFX2DLIST_instance_t list;
+  LINUX_tiles_t* tiles = (LINUX_tiles_t*)malloc(sizeof(LINUX_tiles_t));
+  double single_fps = 0;
+
+  if (tiles == NULL)
+  {
+    return false;
+  }
+
+  TILEBENCH_bytes_per_pixel = display->bits_per_pixel / 8U;
+  GFX2DLIST_initialize(&list, commands, 512, text, sizeof(text));
+
+  printf("%dx%d, %u bpp, %dx%d tiles\n", display->width, display->height, display->bits_per_pixel,
+         tile_width, tile_height);
+
+  for (uint32_t i = 0; i < sizeof(TILEBENCH_THREADS); i++)
+  {
+    if (!LINUX_tiles_initialize(tiles, display, TILEBENCH_THREADS[i], tile_width, tile_height, TILEBENCH_rgba_to_pixel))
+    {
+      fprintf(stderr, "tilebench: could not start %u threads\n", TILEBENCH_THREADS[i]);
+      free(tiles);
+      return false;
+    }
+
+    double record_time = 0;
+    double start = TILEBENCH_now();
+
+    for (uint32_t frame = 0; frame < frames; frame++)
+    {
+      double record_start = TILEBENCH_now();
+
+      TILEBENCH_record(&list, display->width, display->height, frame);
+      record_time += TILEBENCH_now() - record_start;
+
+      LINUX_tiles_render(tiles, &list);
+      LINUX_display_present(display);
+    }
+
+    double fps = frames / (TILEBENCH_now() - start);
+
+    if (i == 0)
+    {
+      single_fps = fps;
+    }
+
+    printf("  %u threads: %8.1f fps  %5.2fx  (record %.3f ms/frame, %u commands)\n",
+           TILEBENCH_THREADS[i], fps, fps / single_fps, record_time * 1e3 / frames, list.command_count);
+
+    LINUX_tiles_deinitialize(tiles);
+  }
+
+  free(tiles);
+
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  int16_t widths[TILEBENCH_SIZES_MAX] = {800, 1280};
+  int16_t heights[TILEBENCH_SIZES_MAX] = {480, 800};
+  uint32_t size_count = 2;
+  bool sizes_given = false;
+  uint32_t frames = 200;
+  int16_t tile_width = 128;
+  int16_t tile_height = 64;
+  const char* fbdev = NULL;
+  const char* shm = NULL;
+
+  for (int i = 1; i < argc; i++)
+  {
+    bool has_value = (i + 1 < argc);
+
+    if ((strcmp(argv[i], "--frames") == 0) && has_value)
+    {
+      frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--tile") == 0) && has_value)
+    {
+      if (!TILEBENCH_parse_size(argv[++i], &tile_width, &tile_height))
+      {
+        return 2;
+      }
+    }
+    else if ((strcmp(argv[i], "--size") == 0) && has_value && (!sizes_given || (size_count < TILEBENCH_SIZES_MAX)))
+    {
+      size_count = sizes_given ? size_count : 0;
+      sizes_given = true;
+
+      if (!TILEBENCH_parse_size(argv[++i], &widths[size_count], &heights[size_count]))
+      {
+        return 2;
+      }
+
+      size_count++;
+    }
+    else if ((strcmp(argv[i], "--fb") == 0) && has_value)
+    {
+      fbdev = argv[++i];
+    }
+    else if ((strcmp(argv[i], "--shm") == 0) && has_value)
+    {
+      shm = argv[++i];
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [--frames N] [--tile WxH] [--size WxH ...] [--fb DEVICE | --shm NAME]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if ((frames == 0) || (size_count == 0))
+  {
+    return 2;
+  }
+
+  if (fbdev != NULL)
+  {
+    LINUX_display_t display;
+
+    if (!LINUX_display_open_fbdev(&display, fbdev))
+    {
+      perror(fbdev);
+      return 1;
+    }
+
+    bool ok = TILEBENCH_run(&display, frames, tile_width, tile_height);
+
+    LINUX_display_close(&display);
+
+    return ok ? 0 : 1;
+  }
+
+  for (uint32_t i = 0; i < size_count; i++)
+  {
+    LINUX_display_t display;
+
+    if (shm != NULL)
+    {
+      if (!LINUX_display_open_shm(&display, shm, widths[i], heights[i], 16))
+      {
+        perror(shm);
+        return 1;
+      }
+    }
+    else
+    {
+      memset(&display, 0, sizeof(display));
+      display.fd = -1;
+      display.width = widths[i];
+      display.height = heights[i];
+      display.bits_per_pixel = 16;
+      display.stride = (uint32_t)widths[i] * 2U;
+      display.pixels = (uint8_t*)calloc(heights[i], display.stride);
+
+      if (display.pixels == NULL)
+      {
+        return 1;
+      }
+    }
+
+    bool ok = TILEBENCH_run(&display, frames, tile_width, tile_height);
+
+    if (shm != NULL)
+    {
+      LINUX_display_close(&display);
+    }
+    else
+    {
+      free(display.pixels);
+    }
+
+    if (!ok)
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+"""
+Host tool for the TRACE module.
+
+Converts a dump written by TRACE_dump to the Chrome trace event JSON format,
+which can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+
+  trace2json.py trace.bin -o trace.json [--name 128=render ...]
+
+Records are unwrapped from the ring buffer, their 32 bit timestamps are
+extended and they are sorted by time. Each module gets its own track, per bus,
+DMA channel, or connection where applicable.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+DUMP_MAGIC = 0x4352544A
+DUMP_VERSION = 1
+HEADER_FORMAT = "<IHHIII"
+RECORD_FORMAT = "<IBBH"
+
+EVENT_BEGIN = 0
+EVENT_END = 1
+EVENT_INSTANT = 2
+EVENT_STATE = 3
+EVENT_COUNTER = 4
+
+ID_EXECUTOR_TASK = 1
+ID_EXECUTOR_SLEEP = 2
+ID_BUSMUTEX_HOLD = 3
+ID_BUSMUTEX_WAIT = 4
+ID_DMAENGINE_SEGMENT = 5
+ID_DMAENGINE_ERROR = 6
+ID_SHIFTSIPO_REFRESH_DMA_ISR = 7
+ID_SHIFTSIPO_REFRESH_TIMER_ISR = 8
+ID_SHIFTSIPO_REFRESH_LATCH = 9
+ID_WEBSERVER_CONNECTION = 10
+ID_USER = 0x80
+
+WEBSERVER_STATES = ("FREE", "RECEIVING", "SENDING")
+
+
+def read_dump(path):
+    """Returns (frequency_hz, records) with records in write order."""
+    with open(path, "rb") as f:
+        blob = f.read()
+    header_length = struct.calcsize(HEADER_FORMAT)
+    if len(blob) < header_length:
+        raise ValueError("%s is too short for a trace dump" % path)
+    magic, version, record_length, record_count, write_index, frequency_hz = \
+        struct.unpack_from(HEADER_FORMAT, blob)
+    if magic != DUMP_MAGIC:
+        raise ValueError("%s is not a trace dump" % path)
+    if version != DUMP_VERSION or record_length != struct.calcsize(RECORD_FORMAT):
+        raise ValueError("unsupported trace dump version %u" % version)
+    if len(blob) < header_length + record_count * record_length:
+        raise ValueError("%s is truncated" % path)
+
+    slots = [struct.unpack_from(RECORD_FORMAT, blob, header_length + i * record_length)
+             for i in range(record_count)]
+
+    if write_index <= record_count:
+        return frequency_hz, slots[:write_index]
+
+    start = write_index % record_count
+    return frequency_hz, slots[start:] + slots[:start]
+
+
+def extend_timestamps(records):
+    """Extends the 32 bit timestamps, assuming neighbouring records are less
+    than half of the counter period apart, and sorts the records by time."""
+    extended = []
+    previous = None
+    time = 0
+    for timestamp, event, trace_id, argument in records:
+        if previous is not None:
+            delta = (timestamp - previous) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            time += delta
+        previous = timestamp
+        extended.append((time, event, trace_id, argument))
+    extended.sort(key=lambda record: record[0])
+    return extended
+
+
+class Converter:
+    def __init__(self, frequency_hz, names):
+        self.frequency_hz = frequency_hz
+        self.names = names
+        self.tracks = {}
+        self.states = {}
+        self.events = []
+        self.origin = None
+
+    def track(self, name):
+        if name not in self.tracks:
+            tid = len(self.tracks) + 1
+            self.tracks[name] = tid
+            self.events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid,
+                                "args": {"name": name}})
+        return self.tracks[name]
+
+    def emit(self, phase, time, track, name, args=None):
+        event = {"name": name, "ph": phase, "pid": 1, "tid": self.track(track),
+                 "ts": (time - self.origin) * 1e6 / self.frequency_hz}
+        if phase == "i":
+            event["s"] = "t"
+        if args:
+            event["args"] = args
+        self.events.append(event)
+
+    def user_name(self, trace_id):
+        return self.names.get(trace_id, "user %u" % trace_id)
+
+    def describe(self, trace_id, argument):
+        """Returns (track, slice name) of a record."""
+        if trace_id == ID_EXECUTOR_TASK:
+            return "EXECUTOR", "task %u" % argument
+        if trace_id == ID_EXECUTOR_SLEEP:
+            return "EXECUTOR", "sleep"
+        if trace_id in (ID_BUSMUTEX_HOLD, ID_BUSMUTEX_WAIT):
+            track = "BUSMUTEX bus %u" % (argument & 0xFF)
+            owner = "owner %u" % (argument >> 8)
+            return track, owner if trace_id == ID_BUSMUTEX_HOLD else "wait " + owner
+        if trace_id in (ID_DMAENGINE_SEGMENT, ID_DMAENGINE_ERROR):
+            track = "DMAENGINE channel %04x" % argument
+            return track, "segment" if trace_id == ID_DMAENGINE_SEGMENT else "error"
+        if trace_id == ID_SHIFTSIPO_REFRESH_DMA_ISR:
+            return "SHIFTSIPO refresh", "dma isr slot %u" % argument
+        if trace_id == ID_SHIFTSIPO_REFRESH_TIMER_ISR:
+            return "SHIFTSIPO refresh", "timer isr slot %u" % argument
+        if trace_id == ID_SHIFTSIPO_REFRESH_LATCH:
+            return "SHIFTSIPO refresh", "latch slot %u" % argument
+        if trace_id == ID_WEBSERVER_CONNECTION:
+            return "WEBSERVER socket %u" % (argument >> 8), None
+        return self.user_name(trace_id), "%s %u" % (self.user_name(trace_id), argument)
+
+    def state(self, time, trace_id, argument):
+        key = (trace_id, argument >> 8)
+        if trace_id == ID_WEBSERVER_CONNECTION:
+            track = "WEBSERVER socket %u" % (argument >> 8)
+            value = argument & 0xFF
+            name = WEBSERVER_STATES[value] if value < len(WEBSERVER_STATES) else "state %u" % value
+            idle = (value == 0)
+        else:
+            track = "%s %u" % (self.user_name(trace_id), argument >> 8)
+            name = "state %u" % (argument & 0xFF)
+            idle = False
+        previous = self.states.pop(key, None)
+        if previous is not None:
+            self.emit("E", time, track, previous)
+        if not idle:
+            self.emit("B", time, track, name)
+            self.states[key] = name
+
+    def convert(self, records):
+        if records:
+            self.origin = records[0][0]
+        for time, event, trace_id, argument in records:
+            if event == EVENT_STATE:
+                self.state(time, trace_id, argument)
+                continue
+            if event == EVENT_COUNTER:
+                name = self.user_name(trace_id)
+                self.emit("C", time, name, name, {"value": argument})
+                continue
+            track, name = self.describe(trace_id, argument)
+            phase = {EVENT_BEGIN: "B", EVENT_END: "E", EVENT_INSTANT: "i"}.get(event)
+            if phase is None:
+                continue
+            self.emit(phase, time, track, name)
+        return {"traceEvents": self.events, "displayTimeUnit": "ns"}
+
+
+def parse_name(text):
+    trace_id, _, name = text.partition("=")
+    if not name:
+        raise argparse.ArgumentTypeError("expected ID=NAME, got %r" % text)
+    return int(trace_id, 0), name
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dump", help="dump written by TRACE_dump")
+    parser.add_argument("-o", "--output", help="output JSON file, default stdout")
+    parser.add_argument("--name", action="append", type=parse_name, default=[],
+                        help="name of an application trace ID, e.g. 128=render")
+    args = parser.parse_args()
+
+    try:
+        frequency_hz, records = read_dump(args.dump)
+    except (OSError, ValueError) as error:
+        sys.exit("trace2json: %s" % error)
+
+    if frequency_hz == 0:
+        sys.exit("trace2json: timestamp frequency is not set in the dump")
+
+    trace = Converter(frequency_hz, dict(args.name)).convert(extend_timestamps(records))
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+    print("%u records" % len(records), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,597 @@
+#!/usr/bin/env python3
+"""
+Host tool for the WEB module assets.
+
+  precompress  Extracts the Bootstrap assets from a JLib archive and emits a C
+               source file with gzip (and, when the brotli module is
+               installed, brotli) precompressed variants and their
+               WEB_asset_t metadata.
+
+  subset       Removes the Bootstrap CSS rules which cannot match any of the
+               given HTML pages, drops the JavaScript bundle if no page uses
+               it, minifies, and emits a C source and header pair with the
+               product specific precompressed WEB_asset_t objects.
+
+  romfs        Packs a directory into a ROMFS image with a perfect hash path
+               index, as a C source and header pair and/or a raw binary.
+"""
+
+import argparse
+import gzip
+import hashlib
+import mimetypes
+import os
+import re
+import struct
+import sys
+
+ASSETS = (
+    ("WEB_BOOTSTRAP_JS", "bootstrap.min.js", "text/javascript"),
+    ("WEB_BOOTSTRAP_CSS", "bootstrap.min.css", "text/css"),
+)
+
+WEB_OBJECT_NAMES = (b"Web.o", b"Web.c.o")
+
+
+def archive_members(path):
+    """Yields (name, data) for each member of a System V/GNU ar archive."""
+    with open(path, "rb") as f:
+        blob = f.read()
+    if not blob.startswith(b"!<arch>\n"):
+        raise ValueError("%s is not an ar archive" % path)
+    offset = 8
+    long_names = b""
+    while offset + 60 <= len(blob):
+        header = blob[offset:offset + 60]
+        name = header[0:16].rstrip()
+        size = int(header[48:58])
+        data = blob[offset + 60:offset + 60 + size]
+        offset += 60 + size + (size & 1)
+        if name == b"//":
+            long_names = data
+            continue
+        if name in (b"/", b"/SYM64/"):
+            continue
+        if name.startswith(b"/") and name[1:].isdigit():
+            start = int(name[1:])
+            name = long_names[start:long_names.index(b"/\n", start)]
+        yield name.rstrip(b"/"), data
+
+
+def elf_symbols(elf):
+    """Returns {name: bytes} for every defined data object of an ELF file."""
+    if elf[:4] != b"\x7fELF":
+        raise ValueError("not an ELF object")
+    is64 = elf[4] == 2
+    endian = "<" if elf[5] == 1 else ">"
+    if is64:
+        shoff, = struct.unpack_from(endian + "Q", elf, 0x28)
+        shentsize, shnum = struct.unpack_from(endian + "HH", elf, 0x3A)
+        section_format = endian + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(endian + "I", elf, 0x20)
+        shentsize, shnum = struct.unpack_from(endian + "HH", elf, 0x2E)
+        section_format = endian + "IIIIIIIIII"
+    sections = [struct.unpack_from(section_format, elf, shoff + i * shentsize)
+                for i in range(shnum)]
+    symbols = {}
+    for section in sections:
+        if section[1] != 2:  # SHT_SYMTAB
+            continue
+        strtab = sections[section[6]]
+        sym_offset, sym_size, sym_entsize = section[4], section[5], section[9]
+        for i in range(sym_size // sym_entsize):
+            base = sym_offset + i * sym_entsize
+            if is64:
+                name_index, info, _, shndx, value, size = struct.unpack_from(
+                    endian + "IBBHQQ", elf, base)
+            else:
+                name_index, value, size, info, _, shndx = struct.unpack_from(
+                    endian + "IIIBBH", elf, base)
+            if (info & 0xF) != 1 or shndx == 0 or shndx >= len(sections):
+                continue
+            name_start = strtab[4] + name_index
+            name = elf[name_start:elf.index(b"\0", name_start)].decode()
+            data_offset = sections[shndx][4] + value
+            symbols[name] = elf[data_offset:data_offset + size]
+    return symbols
+
+
+def extract_web_assets(archive):
+    """Returns {symbol: bytes} for the WEB assets of a JLib archive."""
+    for name, data in archive_members(archive):
+        if name in WEB_OBJECT_NAMES:
+            symbols = elf_symbols(data)
+            return {symbol: symbols[symbol].rstrip(b"\0")
+                    for symbol, _, _ in ASSETS}
+    raise ValueError("%s has no Web object" % archive)
+
+
+def etag(data):
+    return '"%s"' % hashlib.sha256(data).hexdigest()[:16]
+
+
+def c_array(name, data):
+    lines = ["const uint8_t %s[%d] =" % (name, len(data)), "{"]
+    for i in range(0, len(data), 12):
+        chunk = data[i:i + 12]
+        lines.append("  " + ", ".join("0x%02X" % b for b in chunk) +
+                     ("," if i + 12 < len(data) else ""))
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def c_asset(name, path, content_type, encoding, data_name, length, raw):
+    return "\n".join([
+        "const WEB_asset_t %s =" % name,
+        "{",
+        '  .path = "%s",' % path,
+        '  .content_type = "%s",' % content_type,
+        '  .content_encoding = %s,' % ('"%s"' % encoding if encoding else "NULL"),
+        '  .etag = "%s",' % etag(raw).replace('"', '\\"'),
+        "  .data = %s," % data_name,
+        "  .length = %dU," % length,
+        "  .uncompressed_length = %dU" % len(raw),
+        "};",
+    ])
+
+
+def compress_variants(raw):
+    variants = [("GZ", "gzip", gzip.compress(raw, compresslevel=9, mtime=0))]
+    try:
+        import brotli
+        variants.append(("BR", "br", brotli.compress(raw, quality=11)))
+    except ImportError:
+        pass
+    return variants
+
+
+def emit_c_source(output, symbols, generator, config=None):
+    """Writes precompressed assets, given as (symbol, path, type, raw) tuples,
+    compiled in only if the JLIB_CONFIG_<config> macro is set, if given."""
+    out = ["#include \"JLib.h\"", "",
+           "/" + "*" * 79, " *",
+           " *  Precompressed WEB assets. Generated by tools/webasset.py %s -" % generator,
+           " *  do not edit.",
+           " *", " " + "*" * 78 + "/"]
+    if config:
+        out += ["", "#if JLIB_CONFIG_%s" % config]
+    names = []
+    for symbol, path, content_type, raw in symbols:
+        for suffix, encoding, data in compress_variants(raw):
+            data_name = "%s_%s_DATA" % (symbol, suffix)
+            names.append((data_name, "%s_%s" % (symbol, suffix)))
+            out += ["", c_array(data_name, data), "",
+                    c_asset("%s_%s" % (symbol, suffix), path,
+                            content_type, encoding, data_name, len(data), raw)]
+            print("%s_%s: %d -> %d bytes (%.1f%%)" % (
+                symbol, suffix, len(raw), len(data), 100.0 * len(data) / len(raw)),
+                file=sys.stderr)
+    if config:
+        out += ["", "#endif // JLIB_CONFIG_%s" % config]
+    with open(output, "w") as f:
+        f.write("\n".join(out) + "\n")
+    return names
+
+
+def command_precompress(args):
+    assets = extract_web_assets(args.archive)
+    emit_c_source(args.output,
+                  [(symbol, "/" + path, content_type, assets[symbol])
+                   for symbol, path, content_type in ASSETS],
+                  "precompress", "WEB_BOOTSTRAP")
+
+
+# Classes which the Bootstrap JavaScript adds and removes at run time, hence,
+# never appear in the served markup.
+
+JS_RUNTIME_CLASSES = {
+    "active", "bs-popover-auto", "bs-tooltip-auto", "carousel-item-end",
+    "carousel-item-next", "carousel-item-prev", "carousel-item-start",
+    "collapse", "collapsed", "collapsing", "disabled", "fade", "hiding",
+    "modal-backdrop", "modal-open", "modal-static", "offcanvas-backdrop",
+    "popover", "popover-arrow", "popover-body", "popover-header", "show",
+    "showing", "tooltip", "tooltip-arrow", "tooltip-inner", "was-validated",
+}
+
+# Elements always present in a document.
+
+DOCUMENT_ELEMENTS = {"html", "body"}
+
+
+class PageUsage(object):
+    """Class names, ids, and element names used by a set of HTML pages."""
+
+    def __init__(self):
+        self.classes = set()
+        self.ids = set()
+        self.elements = set(DOCUMENT_ELEMENTS)
+        self.uses_javascript = False
+
+    def add_page(self, html):
+        for match in re.finditer(r"""\bclass\s*=\s*(?:"([^"]*)"|'([^']*)')""", html, re.I):
+            self.classes.update((match.group(1) or match.group(2) or "").split())
+        for match in re.finditer(r"""\bid\s*=\s*(?:"([^"]*)"|'([^']*)')""", html, re.I):
+            self.ids.add((match.group(1) or match.group(2) or "").strip())
+        self.elements.update(name.lower() for name in re.findall(r"<([a-zA-Z][a-zA-Z0-9-]*)", html))
+        if re.search(r"\bdata-bs-|\bbootstrap\.[A-Z]", html):
+            self.uses_javascript = True
+
+
+def css_split(text, separator):
+    """Splits text on separator outside of parentheses, brackets, and strings."""
+    parts, depth, quote, start = [], 0, None, 0
+    for i, c in enumerate(text):
+        if quote:
+            if c == quote and text[i - 1] != "\\":
+                quote = None
+        elif c in "\"'":
+            quote = c
+        elif c in "([":
+            depth += 1
+        elif c in ")]":
+            depth -= 1
+        elif c == separator and depth == 0:
+            parts.append(text[start:i])
+            start = i + 1
+    parts.append(text[start:])
+    return parts
+
+
+def css_blocks(css):
+    """
+    Yields (prelude, body) for each top level statement. The body is None for
+    statements without a block, e.g. @charset.
+    """
+    i, start, depth, quote, prelude = 0, 0, 0, None, None
+    while i < len(css):
+        c = css[i]
+        if quote:
+            if c == quote and css[i - 1] != "\\":
+                quote = None
+        elif c in "\"'":
+            quote = c
+        elif c == "{":
+            if depth == 0:
+                prelude = css[start:i]
+                start = i + 1
+            depth += 1
+        elif c == "}":
+            depth -= 1
+            if depth == 0:
+                yield prelude.strip(), css[start:i]
+                start = i + 1
+        elif c == ";" and depth == 0:
+            yield css[start:i].strip(), None
+            start = i + 1
+        i += 1
+
+
+def selector_is_used(selector, usage):
+    # Negated and attribute conditions never require anything to be present.
+    required = re.sub(r":not\((?:[^()]|\([^()]*\))*\)", "", selector)
+    required = re.sub(r"\[[^\]]*\]", "", required)
+    required = re.sub(r"::?[a-zA-Z-]+(\((?:[^()]|\([^()]*\))*\))?", "", required)
+
+    for name in re.findall(r"\.((?:\\.|[\w-])+)", required):
+        if re.sub(r"\\(.)", r"\1", name) not in usage.classes:
+            return False
+    for name in re.findall(r"#((?:\\.|[\w-])+)", required):
+        if name not in usage.ids:
+            return False
+    for name in re.findall(r"(?:^|[\s>+~])([a-zA-Z][a-zA-Z0-9-]*)", required):
+        if name.lower() not in usage.elements:
+            return False
+    return True
+
+
+def css_subset(css, usage):
+    """Returns (css, animations) with the rules which cannot match removed."""
+    out = []
+    for prelude, body in css_blocks(css):
+        if body is None:
+            out.append(prelude + ";")
+        elif prelude.startswith("@keyframes"):
+            out.append((prelude, body))
+        elif prelude.startswith("@"):
+            inner = css_subset(body, usage)
+            if inner:
+                out.append(prelude + "{" + inner + "}")
+        else:
+            selectors = [selector.strip() for selector in css_split(prelude, ",")
+                         if selector_is_used(selector.strip(), usage)]
+            if selectors:
+                out.append(",".join(selectors) + "{" + body + "}")
+
+    # Keyframes are kept only if an animation still refers to them.
+
+    text = "".join(item for item in out if isinstance(item, str))
+    result = []
+    for item in out:
+        if isinstance(item, tuple):
+            name = item[0].split()[-1]
+            if re.search(r"animation(?:-name)?:[^;}]*\b%s\b" % re.escape(name), text):
+                result.append(item[0] + "{" + item[1] + "}")
+        else:
+            result.append(item)
+    return "".join(result)
+
+
+def css_minify(css):
+    # Licence comments (/*! ... */) are retained.
+    css = re.sub(r"/\*(?!!).*?\*/", "", css, flags=re.S)
+    css = re.sub(r"\s+", " ", css)
+    css = re.sub(r"\s*([{};,>])\s*", r"\1", css)
+    css = css.replace(";}", "}")
+    return css.strip()
+
+
+def js_minify(js):
+    # The bundle is already minified; only the source map reference is dropped.
+    return re.sub(r"\n?//# sourceMappingURL=\S+\s*$", "", js)
+
+
+def command_subset(args):
+    assets = extract_web_assets(args.archive)
+    usage = PageUsage()
+    for page in args.pages:
+        with open(page, encoding="utf-8") as f:
+            usage.add_page(f.read())
+    usage.classes.update(args.keep or [])
+    if usage.uses_javascript:
+        usage.classes.update(JS_RUNTIME_CLASSES)
+
+    # Licence comments are set aside so they are not taken for selectors.
+
+    css = assets["WEB_BOOTSTRAP_CSS"].decode("utf-8")
+    licences = re.findall(r"/\*!.*?\*/", css, flags=re.S)
+    rules = css_subset(css_minify(re.sub(r"/\*!.*?\*/", "", css, flags=re.S)), usage)
+    charset = re.match(r"@charset[^;]*;", rules)
+    if charset:
+        rules = rules[charset.end():]
+    subset_css = ((charset.group(0) if charset else "") +
+                  "".join(licences) + css_minify(rules)).encode("utf-8")
+    symbols = [("WEB_%s_CSS" % args.name, "/bootstrap.min.css", "text/css", subset_css)]
+    print("CSS: %d -> %d bytes" % (len(css), len(subset_css)), file=sys.stderr)
+
+    if usage.uses_javascript:
+        js = js_minify(assets["WEB_BOOTSTRAP_JS"].decode("utf-8")).encode("utf-8")
+        symbols.append(("WEB_%s_JS" % args.name, "/bootstrap.min.js", "text/javascript", js))
+    else:
+        print("JS: not referenced, omitted", file=sys.stderr)
+
+    names = emit_c_source(args.output + ".c", symbols, "subset")
+
+    guard = "WEB_%s_J_H" % args.name
+    header = ["/" + "*" * 79, " *",
+              " *  %s WEB assets. Generated by tools/webasset.py subset - do not edit." % args.name,
+              " *", " " + "*" * 78 + "/", "",
+              "#ifndef " + guard, "#define " + guard, "",
+              "#include \"JLib.h\"", "",
+              "// Support C++ builds.", "",
+              "#ifdef __cplusplus", "extern \"C\" {", "#endif", ""]
+    for data_name, asset_name in names:
+        header += ["extern const uint8_t %s[];" % data_name,
+                   "extern const WEB_asset_t %s;" % asset_name]
+    header += ["", "#ifdef __cplusplus", "}", "#endif", "#endif // " + guard]
+    with open(args.output + ".h", "w") as f:
+        f.write("\n".join(header) + "\n")
+
+
+ROMFS_MAGIC = 0x464D4F52
+ROMFS_VERSION = 1
+ROMFS_OFFSET_NONE = 0xFFFFFFFF
+ROMFS_HEADER = struct.Struct("<IHHHHI")
+ROMFS_ENTRY = struct.Struct("<IIIIIIB3x")
+
+CONTENT_TYPES = {
+    ".html": "text/html", ".htm": "text/html", ".css": "text/css",
+    ".js": "text/javascript", ".mjs": "text/javascript", ".json": "application/json",
+    ".svg": "image/svg+xml", ".png": "image/png", ".jpg": "image/jpeg",
+    ".jpeg": "image/jpeg", ".gif": "image/gif", ".ico": "image/x-icon",
+    ".txt": "text/plain", ".woff2": "font/woff2", ".wasm": "application/wasm",
+}
+
+COMPRESSIBLE_TYPES = ("text/", "application/json", "image/svg+xml", "application/wasm")
+
+
+def romfs_hash(path, seed):
+    """Seeded FNV-1a, see ROMFS_hash."""
+    value = (0x811C9DC5 ^ seed) & 0xFFFFFFFF
+    for byte in path:
+        value ^= byte
+        value = (value * 0x01000193) & 0xFFFFFFFF
+    return value
+
+
+def romfs_perfect_hash(paths):
+    """
+    Returns (displacements, slots) such that path i is stored in entry
+    slots[i]. Buckets are placed largest first, each with the first seed
+    which maps all of its paths to free entries.
+    """
+    count = len(paths)
+    bucket_count = max(1, (count + 1) // 2)
+    while True:
+        buckets = [[] for _ in range(bucket_count)]
+        for index, path in enumerate(paths):
+            buckets[romfs_hash(path, 0) % bucket_count].append(index)
+        displacements = [0] * bucket_count
+        slots = [None] * count
+        taken = set()
+        for bucket in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+            members = buckets[bucket]
+            if not members:
+                continue
+            for seed in range(1, 0x10000):
+                candidate = [romfs_hash(paths[i], seed) % count for i in members]
+                if len(set(candidate)) == len(candidate) and not taken.intersection(candidate):
+                    break
+            else:
+                break
+            displacements[bucket] = seed
+            taken.update(candidate)
+            for i, slot in zip(members, candidate):
+                slots[i] = slot
+        else:
+            return displacements, slots
+        bucket_count += 1
+
+
+def romfs_files(root, compress):
+    """Yields (path, content type, data, uncompressed length, gzip) per file."""
+    for directory, _, names in sorted(os.walk(root)):
+        for name in sorted(names):
+            full_path = os.path.join(directory, name)
+            path = "/" + os.path.relpath(full_path, root).replace(os.sep, "/")
+            extension = os.path.splitext(name)[1].lower()
+            content_type = (CONTENT_TYPES.get(extension) or
+                            mimetypes.guess_type(name)[0] or "application/octet-stream")
+            with open(full_path, "rb") as f:
+                raw = f.read()
+            data, gzipped = raw, False
+            if compress and content_type.startswith(COMPRESSIBLE_TYPES):
+                packed = gzip.compress(raw, compresslevel=9, mtime=0)
+                if len(packed) < len(raw):
+                    data, gzipped = packed, True
+            yield path, content_type, data, raw, gzipped
+
+
+def romfs_build(root, compress):
+    """Returns the image bytes and a list of (path, stored, original) sizes."""
+    files = []
+    for path, content_type, data, raw, gzipped in romfs_files(root, compress):
+        files.append((path, content_type, data, raw, gzipped))
+        # Directory indexes are also served under the directory path.
+        if path.endswith("/index.html"):
+            files.append((path[:-len("index.html")], content_type, data, raw, gzipped))
+    if len(files) > 0xFFFF:
+        raise ValueError("too many files")
+
+    paths = [f[0].encode("utf-8") for f in files]
+    displacements, slots = romfs_perfect_hash(paths) if files else ([], [])
+    bucket_count = len(displacements)
+
+    entries_offset = ROMFS_HEADER.size + ((2 * bucket_count + 3) & ~3)
+    strings_offset = entries_offset + ROMFS_ENTRY.size * len(files)
+
+    strings, string_offsets = bytearray(), {}
+
+    def string(text):
+        if text not in string_offsets:
+            string_offsets[text] = strings_offset + len(strings)
+            strings.extend(text.encode("utf-8") + b"\0")
+        return string_offsets[text]
+
+    entries = [None] * len(files)
+    file_data = []
+    for (path, content_type, data, raw, gzipped), slot in zip(files, slots):
+        entries[slot] = [string(path), string(content_type), string(etag(raw)),
+                         data, len(data), len(raw), 1 if gzipped else 0]
+
+    data_offset = (strings_offset + len(strings) + 3) & ~3
+    data_offsets, data_blob = {}, bytearray()
+    for entry in entries:
+        data = entry[3]
+        key = hashlib.sha256(data).digest()
+        if key not in data_offsets:
+            data_offsets[key] = data_offset + len(data_blob)
+            data_blob.extend(data)
+            data_blob.extend(b"\0" * (-len(data_blob) % 4))
+        entry[3] = data_offsets[key]
+
+    image = bytearray()
+    image_length = data_offset + len(data_blob)
+    image += ROMFS_HEADER.pack(ROMFS_MAGIC, ROMFS_VERSION, len(files), bucket_count, 0, image_length)
+    image += struct.pack("<%dH" % bucket_count, *displacements)
+    image += b"\0" * (entries_offset - len(image))
+    for entry in entries:
+        image += ROMFS_ENTRY.pack(*entry)
+    image += strings
+    image += b"\0" * (data_offset - len(image))
+    image += data_blob
+    assert len(image) == image_length
+
+    sizes = [(f[0], len(f[2]), len(f[3])) for f in files]
+    return bytes(image), sizes
+
+
+def command_romfs(args):
+    image, sizes = romfs_build(args.directory, not args.no_gzip)
+    for path, stored, original in sizes:
+        print("%-40s %8d -> %8d" % (path, original, stored), file=sys.stderr)
+    print("image: %d bytes, %d entries" % (len(image), len(sizes)), file=sys.stderr)
+
+    if args.binary:
+        with open(args.binary, "wb") as f:
+            f.write(image)
+    if not args.output:
+        return
+
+    symbol = "ROMFS_%s" % args.name
+    words = struct.unpack("<%dI" % (len(image) // 4), image)
+    lines = ["#include \"JLib.h\"", "",
+             "/" + "*" * 79, " *",
+             " *  %s image. Generated by tools/webasset.py romfs - do not edit." % args.name,
+             " *", " " + "*" * 78 + "/", "",
+             "// Stored as words to guarantee the image alignment.", "",
+             "const uint32_t %s[%d] =" % (symbol, len(words)), "{"]
+    for i in range(0, len(words), 6):
+        lines.append("  " + ", ".join("0x%08X" % w for w in words[i:i + 6]) +
+                     ("," if i + 6 < len(words) else ""))
+    lines.append("};")
+    with open(args.output + ".c", "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+    guard = "%s_J_H" % symbol
+    header = ["/" + "*" * 79, " *",
+              " *  %s image. Generated by tools/webasset.py romfs - do not edit." % args.name,
+              " *", " " + "*" * 78 + "/", "",
+              "#ifndef " + guard, "#define " + guard, "",
+              "#include \"JLib.h\"", "",
+              "// Support C++ builds.", "",
+              "#ifdef __cplusplus", "extern \"C\" {", "#endif", "",
+              "extern const uint32_t %s[%d];" % (symbol, len(words)), "",
+              "#ifdef __cplusplus", "}", "#endif", "#endif // " + guard]
+    with open(args.output + ".h", "w") as f:
+        f.write("\n".join(header) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    precompress = commands.add_parser("precompress")
+    precompress.add_argument("--archive", default="JLib_arm_cortexm0.a")
+    precompress.add_argument("--output", default="src/WebCompressed.c")
+    precompress.set_defaults(handler=command_precompress)
+
+    subset = commands.add_parser("subset")
+    subset.add_argument("--archive", default="JLib_arm_cortexm0.a")
+    subset.add_argument("--name", required=True,
+                        help="product name, the assets are named WEB_<name>_CSS_GZ etc.")
+    subset.add_argument("--output", required=True,
+                        help="output path without extension, a .c and .h pair is written")
+    subset.add_argument("--keep", nargs="*",
+                        help="class names to keep although no page uses them")
+    subset.add_argument("pages", nargs="+", help="HTML pages served by the product")
+    subset.set_defaults(handler=command_subset)
+
+    romfs = commands.add_parser("romfs")
+    romfs.add_argument("--name", default="WEB",
+                       help="image name, the image is named ROMFS_<name>")
+    romfs.add_argument("--output",
+                       help="output path without extension, a .c and .h pair is written")
+    romfs.add_argument("--binary", help="raw image output path")
+    romfs.add_argument("--no-gzip", action="store_true",
+                       help="store all files uncompressed")
+    romfs.add_argument("directory")
+    romfs.set_defaults(handler=command_romfs)
+
+    args = parser.parse_args()
+    args.handler(args)
+
+
+if __name__ == "__main__":
+    main()
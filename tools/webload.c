@@ -0,0 +1,684 @@
+/*******************************************************************************
+ *
+ *  Conformance check and load generator for WEBSERVER on the Linux socket
+ *  HALs (see linux/JLibLinux.h). Serves the Bootstrap assets, a small JSON
+ *  API and a WEBTELEMETRY channel on a loopback port from a thread, checks
+ *  keep-alive, pipelining, and the 304, 405, 406, 413 and 431 responses, then
+ *  loads the server with keep-alive connections and reports the requests per
+ *  second:
+ *
+ *   webload [--connections N] [--requests N] [--pipeline N] [--port N]
+ *   webload --serve [--port N] [--period US]
+ *
+ *  With --serve, only the server runs, until interrupted, for browsers and
+ *  other clients such as tools/telemetryclient.py, which connects to
+ *  /telemetry. Telemetry updates are sent every --period microseconds
+ *  (default 1000, 0 for as fast as the socket takes them). Build with the
+ *  library stand-ins in sim/ (see sim/JLibSim.h):
+ *
+ *   cc -std=gnu11 -O2 -pthread -I. -Ilinux -Isim tools/webload.c
+ *      src/WebServer.c src/WebCompressed.c src/WebTelemetry.c linux/LinuxSocket.c
+ *      linux/LinuxTimer.c sim/SimLibrary.c
+ *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "JLibLinux.h"
+
+#define WEBLOAD_SERVER_CONNECTIONS        8U
+#define WEBLOAD_IDLE_TIMEOUT_US           5000000U
+#define WEBLOAD_CLIENT_BUFFER_LENGTH      16384U
+#define WEBLOAD_BODY_LENGTH_MAX           256U
+#define WEBLOAD_CONNECTIONS_MAX           64U
+#define WEBLOAD_PIPELINE_MAX              16U
+#define WEBLOAD_TELEMETRY_WAIT_US         100U
+
+/*******************************************************************************
+ * Server
+ ******************************************************************************/
+
+static struct
+{
+  WEBSERVER_instance_t webserver;
+  UTIMER_instance_t utimer;
+  WEBSERVER_connection_t connections[WEBLOAD_SERVER_CONNECTIONS];
+  WEBTELEMETRY_instance_t telemetry;
+  pthread_t thread;
+  volatile bool stop;
+  uint32_t counter;
+  int16_t setpoint;
+  uint8_t mode;
+}
+WEBLOAD_server;
+
+static TERVAR_entry_t WEBLOAD_TELEMETRY_ENTRIES[] =
+{
+  {&WEBLOAD_server.webserver.request_count, 0, "Requests", {.type = TERVAR_VAR_TYPE_UINT32, .read_only = 1}, NULL, NULL},
+  {&WEBLOAD_server.counter, 0, "Counter", {.type = TERVAR_VAR_TYPE_UINT32, .read_only = 1}, NULL, NULL},
+  {&WEBLOAD_server.setpoint, 0, "Setpoint", {.type = TERVAR_VAR_TYPE_INT16}, NULL, NULL},
+  {&WEBLOAD_server.mode, 0, "Mode", {.type = TERVAR_VAR_TYPE_UINT8}, NULL, NULL},
+};
+
+// Adds the length of POSTed bodies to a counter and reports it, along with
+// the query string.
+
+static uint16_t WEBLOAD_status_handler(uint32_t context,
+                                       const WEBSERVER_request_t* request,
+                                       WEBSERVER_response_t* response)
+{
+  (void)context;
+
+  if (request->method == WEBSERVER_METHOD_POST)
+  {
+    WEBLOAD_server.counter += request->body_length;
+  }
+
+  WEBSERVER_response_append(response, "{\"counter\":");
+  WEBSERVER_response_append_integer(response, (int32_t)WEBLOAD_server.counter);
+  WEBSERVER_response_append(response, ",\"query\":\"");
+  WEBSERVER_response_append(response, (request->query != NULL) ? request->query : "");
+  WEBSERVER_response_append(response, "\"}");
+
+  return 200;
+}
+
+static uint16_t WEBLOAD_telemetry_upgrade(uint32_t context,
+                                          int32_t socket,
+                                          const WEBSERVER_request_t* request)
+{
+  (void)context;
+
+  return WEBTELEMETRY_upgrade(&WEBLOAD_server.telemetry, socket, request);
+}
+
+static const WEBSERVER_route_t WEBLOAD_ROUTES[] =
+{
+  {NULL, WEBSERVER_METHOD_GET | WEBSERVER_METHOD_HEAD, &WEB_BOOTSTRAP_CSS_GZ, NULL, 0, NULL},
+  {NULL, WEBSERVER_METHOD_GET | WEBSERVER_METHOD_HEAD, &WEB_BOOTSTRAP_JS_GZ, NULL, 0, NULL},
+  {"/api/status", WEBSERVER_METHOD_GET | WEBSERVER_METHOD_HEAD | WEBSERVER_METHOD_POST, NULL, WEBLOAD_status_handler, 0, NULL},
+  {"/telemetry", WEBSERVER_METHOD_GET, NULL, NULL, 0, WEBLOAD_telemetry_upgrade},
+};
+
+static void* WEBLOAD_server_thread(void* argument)
+{
+  (void)argument;
+
+  while (!WEBLOAD_server.stop)
+  {
+    bool idle = WEBSERVER_service(&WEBLOAD_server.webserver);
+
+    idle = WEBTELEMETRY_service(&WEBLOAD_server.telemetry) && idle;
+
+    // Updates are due on the period, not on socket activity, so a connected
+    // client shortens the wait.
+
+    if (!idle)
+    {
+      continue;
+    }
+
+    if (!WEBTELEMETRY_is_connected(&WEBLOAD_server.telemetry))
+    {
+      LINUX_socket_wait(1000);
+    }
+    else if (WEBLOAD_server.telemetry.period_us != 0)
+    {
+      LINUX_socket_wait(WEBLOAD_TELEMETRY_WAIT_US);
+    }
+  }
+
+  return NULL;
+}
+
+static bool WEBLOAD_server_start(uint16_t port, uint32_t period_us)
+{
+  if (!LINUX_socket_listen(NULL, port))
+  {
+    perror("webload: listen");
+    return false;
+  }
+
+  LINUX_timer_initialize(&WEBLOAD_server.utimer);
+
+  WEBSERVER_initialize(&WEBLOAD_server.webserver,
+                       &WEBLOAD_server.utimer,
+                       WEBLOAD_server.connections,
+                       WEBLOAD_SERVER_CONNECTIONS,
+                       WEBLOAD_ROUTES,
+                       sizeof(WEBLOAD_ROUTES) / sizeof(WEBLOAD_ROUTES[0]),
+                       WEBLOAD_IDLE_TIMEOUT_US,
+                       LINUX_socket_accept,
+                       LINUX_socket_recv,
+                       LINUX_socket_send,
+                       LINUX_socket_close);
+
+  WEBTELEMETRY_initialize(&WEBLOAD_server.telemetry,
+                          &WEBLOAD_server.utimer,
+                          WEBLOAD_TELEMETRY_ENTRIES,
+                          sizeof(WEBLOAD_TELEMETRY_ENTRIES) / sizeof(WEBLOAD_TELEMETRY_ENTRIES[0]),
+                          period_us,
+                          LINUX_socket_recv,
+                          LINUX_socket_send,
+                          LINUX_socket_close);
+
+  WEBLOAD_server.stop = false;
+
+  return pthread_create(&WEBLOAD_server.thread, NULL, WEBLOAD_server_thread, NULL) == 0;
+}
+
+static void WEBLOAD_server_stop(void)
+{
+  WEBLOAD_server.stop = true;
+  pthread_join(WEBLOAD_server.thread, NULL);
+  LINUX_socket_shutdown();
+}
+
+/*******************************************************************************
+ * Client
+ ******************************************************************************/
+
+typedef struct
+{
+  int fd;
+  uint32_t length;
+  uint8_t buffer[WEBLOAD_CLIENT_BUFFER_LENGTH];
+}
+WEBLOAD_client_t;
+
+typedef struct
+{
+  uint16_t status;
+  bool close;
+  uint32_t content_length;
+  char etag[64];
+  char body[WEBLOAD_BODY_LENGTH_MAX + 1U];
+}
+WEBLOAD_response_t;
+
+static bool WEBLOAD_connect(WEBLOAD_client_t* client, uint16_t port)
+{
+  struct sockaddr_in address;
+  struct timeval timeout = {5, 0};
+  int enable = 1;
+
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  client->length = 0;
+  client->fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+  if ((client->fd < 0) || (connect(client->fd, (struct sockaddr*)&address, sizeof(address)) < 0))
+  {
+    perror("webload: connect");
+    return false;
+  }
+
+  setsockopt(client->fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+  setsockopt(client->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  return true;
+}
+
+static void WEBLOAD_disconnect(WEBLOAD_client_t* client)
+{
+  close(client->fd);
+  client->fd = -1;
+}
+
+static bool WEBLOAD_send(WEBLOAD_client_t* client, const char* data, size_t length)
+{
+  while (length != 0)
+  {
+    ssize_t sent = send(client->fd, data, length, MSG_NOSIGNAL);
+
+    if (sent <= 0)
+    {
+      return false;
+    }
+
+    data += sent;
+    length -= (size_t)sent;
+  }
+
+  return true;
+}
+
+static bool WEBLOAD_send_text(WEBLOAD_client_t* client, const char* text)
+{
+  return WEBLOAD_send(client, text, strlen(text));
+}
+
+static bool WEBLOAD_fill(WEBLOAD_client_t* client)
+{
+  ssize_t received = recv(client->fd, &client->buffer[client->length], sizeof(client->buffer) - client->length, 0);
+
+  if (received <= 0)
+  {
+    return false;
+  }
+
+  client->length += (uint32_t)received;
+  return true;
+}
+
+static void WEBLOAD_consume(WEBLOAD_client_t* client, uint32_t length)
+{
+  client->length -= length;
+  memmove(client->buffer, &client->buffer[length], client->length);
+}
+
+// True once the server has closed the connection, with nothing left unread.
+
+static bool WEBLOAD_is_closed(WEBLOAD_client_t* client)
+{
+  return (client->length == 0) && !WEBLOAD_fill(client);
+}
+
+// Reads the next response, keeping the start of the body. Responses to HEAD
+// requests, and 304 responses, have no body whatever their Content-Length.
+
+static bool WEBLOAD_read_response(WEBLOAD_client_t* client, bool head, WEBLOAD_response_t* response)
+{
+  uint8_t* end;
+
+  memset(response, 0, sizeof(WEBLOAD_response_t));
+
+  while ((end = memmem(client->buffer, client->length, "\r\n\r\n", 4)) == NULL)
+  {
+    if ((client->length == sizeof(client->buffer)) || !WEBLOAD_fill(client))
+    {
+      return false;
+    }
+  }
+
+  uint32_t header_length = (uint32_t)(end - client->buffer) + 4U;
+  char* line = (char*)client->buffer;
+
+  *end = '\0';
+
+  if (sscanf(line, "HTTP/1.1 %hu", &response->status) != 1)
+  {
+    return false;
+  }
+
+  while ((line = strstr(line, "\r\n")) != NULL)
+  {
+    line += 2;
+
+    if (strncasecmp(line, "Content-Length:", 15) == 0)
+    {
+      response->content_length = (uint32_t)strtoul(line + 15, NULL, 10);
+    }
+    else if (strncasecmp(line, "ETag:", 5) == 0)
+    {
+      sscanf(line + 5, " %63[^\r]", response->etag);
+    }
+    else if (strncasecmp(line, "Connection: close", 17) == 0)
+    {
+      response->close = true;
+    }
+  }
+
+  WEBLOAD_consume(client, header_length);
+
+  uint32_t remaining = (head || (response->status == 304)) ? 0 : response->content_length;
+  uint32_t kept = 0;
+
+  while (remaining != 0)
+  {
+    if ((client->length == 0) && !WEBLOAD_fill(client))
+    {
+      return false;
+    }
+
+    uint32_t length = (remaining < client->length) ? remaining : client->length;
+    uint32_t keep = (length < WEBLOAD_BODY_LENGTH_MAX - kept) ? length : WEBLOAD_BODY_LENGTH_MAX - kept;
+
+    memcpy(&response->body[kept], client->buffer, keep);
+    kept += keep;
+    WEBLOAD_consume(client, length);
+    remaining -= length;
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+ * Checks
+ ******************************************************************************/
+
+static uint32_t WEBLOAD_failures;
+
+static void WEBLOAD_expect(bool condition, const char* name)
+{
+  printf("  %-52s %s\n", name, condition ? "ok" : "FAILED");
+
+  if (!condition)
+  {
+    WEBLOAD_failures++;
+  }
+}
+
+static bool WEBLOAD_request(WEBLOAD_client_t* client,
+                            const char* request,
+                            bool head,
+                            WEBLOAD_response_t* response)
+{
+  return WEBLOAD_send_text(client, request) && WEBLOAD_read_response(client, head, response);
+}
+
+static void WEBLOAD_check_keep_alive(uint16_t port)
+{
+  WEBLOAD_client_t client;
+  WEBLOAD_response_t response;
+  bool ok = WEBLOAD_connect(&client, port);
+
+  for (int i = 0; ok && (i < 3); i++)
+  {
+    char request[128];
+    char query[32];
+
+    snprintf(request, sizeof(request), "GET /api/status?n=%d HTTP/1.1\r\nHost: webload\r\n\r\n", i);
+    snprintf(query, sizeof(query), "\"query\":\"n=%d\"", i);
+
+    ok = WEBLOAD_request(&client, request, false, &response) &&
+         (response.status == 200) && !response.close && (strstr(response.body, query) != NULL);
+  }
+
+  WEBLOAD_expect(ok, "keep-alive: 3 requests on one connection");
+
+  ok = ok &&
+       WEBLOAD_request(&client, "GET /api/status HTTP/1.1\r\nConnection: close\r\n\r\n", false, &response) &&
+       (response.status == 200) && response.close && WEBLOAD_is_closed(&client);
+
+  WEBLOAD_expect(ok, "keep-alive: closed after Connection: close");
+  WEBLOAD_disconnect(&client);
+}
+
+static void WEBLOAD_check_pipelining(uint16_t port, char* etag, size_t etag_length)
+{
+  static const char REQUESTS[] =
+    "GET /api/status?p=1 HTTP/1.1\r\n\r\n"
+    "HEAD /bootstrap.min.css HTTP/1.1\r\nAccept-Encoding: gzip, deflate\r\n\r\n"
+    "POST /api/status HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc"
+    "GET /bootstrap.min.js HTTP/1.1\r\nAccept-Encoding: gzip\r\n\r\n"
+    "GET /api/status?p=2 HTTP/1.1\r\n\r\n";
+
+  WEBLOAD_client_t client;
+  WEBLOAD_response_t response;
+  bool ok = WEBLOAD_connect(&client, port) && WEBLOAD_send_text(&client, REQUESTS);
+
+  ok = ok && WEBLOAD_read_response(&client, false, &response) &&
+       (response.status == 200) && (strstr(response.body, "\"query\":\"p=1\"") != NULL);
+
+  ok = ok && WEBLOAD_read_response(&client, true, &response) &&
+       (response.status == 200) && (response.content_length == WEB_BOOTSTRAP_CSS_GZ.length) &&
+       (strcmp(response.etag, WEB_BOOTSTRAP_CSS_GZ.etag) == 0);
+
+  snprintf(etag, etag_length, "%s", response.etag);
+
+  ok = ok && WEBLOAD_read_response(&client, false, &response) && (response.status == 200);
+
+  ok = ok && WEBLOAD_read_response(&client, false, &response) &&
+       (response.status == 200) && (response.content_length == WEB_BOOTSTRAP_JS_GZ.length) &&
+       (memcmp(response.body, WEB_BOOTSTRAP_JS_GZ.data, WEBLOAD_BODY_LENGTH_MAX) == 0);
+
+  ok = ok && WEBLOAD_read_response(&client, false, &response) &&
+       (response.status == 200) && (strstr(response.body, "\"query\":\"p=2\"") != NULL);
+
+  WEBLOAD_expect(ok, "pipelining: 5 requests in one segment, in order");
+  WEBLOAD_disconnect(&client);
+}
+
+static void WEBLOAD_check_statuses(uint16_t port, const char* etag)
+{
+  WEBLOAD_client_t client;
+  WEBLOAD_response_t response;
+  char request[256];
+  char* large;
+  bool ok;
+
+  // 304, 405 and 406 keep the connection open.
+
+  snprintf(request, sizeof(request),
+           "GET /bootstrap.min.css HTTP/1.1\r\nAccept-Encoding: gzip\r\nIf-None-Match: W/\"0\", %s\r\n\r\n", etag);
+
+  ok = WEBLOAD_connect(&client, port) && WEBLOAD_request(&client, request, false, &response) &&
+       (response.status == 304) && !response.close;
+
+  WEBLOAD_expect(ok, "304: If-None-Match with the asset ETag");
+
+  ok = ok && WEBLOAD_request(&client, "DELETE /api/status HTTP/1.1\r\n\r\n", false, &response) &&
+       (response.status == 405) && !response.close;
+
+  WEBLOAD_expect(ok, "405: method not allowed by the route");
+
+  ok = ok && WEBLOAD_request(&client, "GET /bootstrap.min.css HTTP/1.1\r\nAccept-Encoding: br\r\n\r\n", false, &response) &&
+       (response.status == 406) && !response.close;
+
+  WEBLOAD_expect(ok, "406: gzip asset without gzip in Accept-Encoding");
+
+  ok = ok && WEBLOAD_request(&client, "GET /api/status HTTP/1.1\r\n\r\n", false, &response) && (response.status == 200);
+
+  WEBLOAD_expect(ok, "keep-alive: 200 after 304, 405 and 406");
+  WEBLOAD_disconnect(&client);
+
+  // 413 and 431 close the connection, as the rest of the request is not read.
+
+  snprintf(request, sizeof(request), "POST /api/status HTTP/1.1\r\nContent-Length: %u\r\n\r\n",
+           WEBSERVER_REQUEST_BUFFER_LENGTH);
+
+  ok = WEBLOAD_connect(&client, port) && WEBLOAD_request(&client, request, false, &response) &&
+       (response.status == 413) && response.close && WEBLOAD_is_closed(&client);
+
+  WEBLOAD_expect(ok, "413: body larger than the request buffer");
+  WEBLOAD_disconnect(&client);
+
+  large = malloc(WEBSERVER_REQUEST_BUFFER_LENGTH + 64U);
+  snprintf(large, WEBSERVER_REQUEST_BUFFER_LENGTH + 64U, "GET /api/status HTTP/1.1\r\nX-Fill: %0*d\r\n\r\n",
+           (int)WEBSERVER_REQUEST_BUFFER_LENGTH, 0);
+
+  ok = WEBLOAD_connect(&client, port) && WEBLOAD_request(&client, large, false, &response) &&
+       (response.status == 431) && response.close && WEBLOAD_is_closed(&client);
+
+  WEBLOAD_expect(ok, "431: headers larger than the request buffer");
+  WEBLOAD_disconnect(&client);
+  free(large);
+}
+
+/*******************************************************************************
+ * Load
+ ******************************************************************************/
+
+typedef struct
+{
+  pthread_t thread;
+  uint16_t port;
+  const char* request;
+  size_t request_length;
+  uint32_t requests;
+  uint32_t pipeline;
+  uint64_t bytes;
+  bool ok;
+}
+WEBLOAD_worker_t;
+
+// Keeps up to pipeline requests in flight on one connection.
+
+static void* WEBLOAD_worker_thread(void* argument)
+{
+  WEBLOAD_worker_t* worker = (WEBLOAD_worker_t*)argument;
+  WEBLOAD_client_t* client = malloc(sizeof(WEBLOAD_client_t));
+  WEBLOAD_response_t response;
+  uint32_t sent = 0;
+  uint32_t received = 0;
+
+  worker->ok = (client != NULL) && WEBLOAD_connect(client, worker->port);
+
+  while (worker->ok && (received < worker->requests))
+  {
+    while ((sent < worker->requests) && (sent - received < worker->pipeline))
+    {
+      worker->ok = worker->ok && WEBLOAD_send(client, worker->request, worker->request_length);
+      sent++;
+    }
+
+    worker->ok = worker->ok && WEBLOAD_read_response(client, false, &response) && (response.status == 200);
+    worker->bytes += response.content_length;
+    received++;
+  }
+
+  if (client != NULL)
+  {
+    WEBLOAD_disconnect(client);
+    free(client);
+  }
+
+  return NULL;
+}
+
+static double WEBLOAD_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static bool WEBLOAD_load(uint16_t port, const char* path, uint32_t connections, uint32_t requests, uint32_t pipeline)
+{
+  static WEBLOAD_worker_t workers[WEBLOAD_CONNECTIONS_MAX];
+  char request[128];
+  uint64_t bytes = 0;
+  bool ok = true;
+
+  snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: webload\r\nAccept-Encoding: gzip\r\n\r\n", path);
+
+  double start = WEBLOAD_now();
+
+  for (uint32_t i = 0; i < connections; i++)
+  {
+    memset(&workers[i], 0, sizeof(WEBLOAD_worker_t));
+    workers[i].port = port;
+    workers[i].request = request;
+    workers[i].request_length = strlen(request);
+    workers[i].requests = requests;
+    workers[i].pipeline = pipeline;
+    pthread_create(&workers[i].thread, NULL, WEBLOAD_worker_thread, &workers[i]);
+  }
+
+  for (uint32_t i = 0; i < connections; i++)
+  {
+    pthread_join(workers[i].thread, NULL);
+    ok = ok && workers[i].ok;
+    bytes += workers[i].bytes;
+  }
+
+  double elapsed = WEBLOAD_now() - start;
+
+  printf("  %-20s %9.0f req/s %8.1f MB/s%s\n", path, (double)connections * requests / elapsed,
+         (double)bytes / elapsed * 1e-6, ok ? "" : "  (FAILED)");
+
+  return ok;
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t connections = 4;
+  uint32_t requests = 2000;
+  uint32_t pipeline = 1;
+  uint16_t port = 0;
+  uint32_t period_us = 1000;
+  bool serve = false;
+
+  for (int i = 1; i < argc; i++)
+  {
+    bool has_value = (i + 1 < argc);
+
+    if ((strcmp(argv[i], "--connections") == 0) && has_value)
+    {
+      connections = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--requests") == 0) && has_value)
+    {
+      requests = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--pipeline") == 0) && has_value)
+    {
+      pipeline = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--port") == 0) && has_value)
+    {
+      port = (uint16_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if ((strcmp(argv[i], "--period") == 0) && has_value)
+    {
+      period_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+    }
+    else if (strcmp(argv[i], "--serve") == 0)
+    {
+      serve = true;
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [--connections N] [--requests N] [--pipeline N] [--port N] [--serve] [--period US]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if ((connections == 0) || (connections > WEBLOAD_CONNECTIONS_MAX) ||
+      (pipeline == 0) || (pipeline > WEBLOAD_PIPELINE_MAX) || (requests == 0))
+  {
+    fprintf(stderr, "webload: connections must be 1 to %u, pipeline 1 to %u, and requests at least 1\n",
+            WEBLOAD_CONNECTIONS_MAX, WEBLOAD_PIPELINE_MAX);
+    return 2;
+  }
+
+  if (!WEBLOAD_server_start(port, period_us))
+  {
+    return 1;
+  }
+
+  port = LINUX_socket_port();
+
+  if (serve)
+  {
+    printf("serving on http://127.0.0.1:%u/\n", port);
+    pthread_join(WEBLOAD_server.thread, NULL);
+    return 0;
+  }
+
+  char etag[64] = "";
+
+  printf("checks on port %u\n", port);
+  WEBLOAD_check_keep_alive(port);
+  WEBLOAD_check_pipelining(port, etag, sizeof(etag));
+  WEBLOAD_check_statuses(port, etag);
+
+  printf("%u connections x %u requests, %u in flight per connection\n", connections, requests, pipeline);
+
+  bool ok = WEBLOAD_load(port, "/api/status", connections, requests, pipeline) &&
+            WEBLOAD_load(port, "/bootstrap.min.css", connections, requests, pipeline);
+
+  WEBLOAD_server_stop();
+
+  printf("%u requests served, %u errors\n", WEBLOAD_server.webserver.request_count, WEBLOAD_server.webserver.error_count);
+
+  return ((WEBLOAD_failures == 0) && ok) ? 0 : 1;
+}